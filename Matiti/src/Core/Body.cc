@@ -38,7 +38,7 @@
 #include <MaterialModels/Density.h>
 #include <MaterialModels/Material.h>
 
-//#include <random>
+#include <random>
 #include <string>
 #include <iostream>
 #include <fstream>
@@ -344,6 +344,9 @@ Body::createInitialFamily(const Domain& domain)
 void 
 Body::updateFamily(const Domain& domain)
 {
+  // Move the nodes that have changed cells in the cell-node map
+  d_family_computer.updateCellNodeMap(domain, d_nodes);
+
   // Loop through the nodes in the body
   for (auto iter = d_nodes.begin(); iter != d_nodes.end(); ++iter) {
     NodeP cur_node = *iter;
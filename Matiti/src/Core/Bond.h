@@ -22,97 +22,137 @@
  * IN THE SOFTWARE.
  */
 
-#ifndef MATITI_BOND_H
-#define MATITI_BOND_H
-
-#include <Pointers/NodeP.h>
-#include <Pointers/WoodSP.h>
-//#include <Containers/WoodSPArray.h>
-#include <Woods/Wood.h>
-#include <Containers/MaterialSPArray.h>
-#include <Pointers/MaterialUP.h>
-#include <Pointers/MaterialSP.h>
-#include <MaterialModels/Material.h>
-#include <Geometry/Vector3D.h>
-
-#include <iostream>
-
-namespace Matiti {
-
-  class Bond 
-  {
-  public:
-
-    friend std::ostream& operator<<(std::ostream& out, const Matiti::Bond& bond);
-
-  public: 
-
-    Bond();
-    Bond(const NodeP node1, const NodeP node2);
-    Bond(const NodeP node1, const NodeP node2, const Material* mat);
-    Bond(const NodeP node1, const NodeP node2, const Material* mat1, const Material* mat2);
-    virtual ~Bond();
-
-    /**
-     * Compute volume weighted bond force
-     */
-    void computeInternalForce();
-    void computeInternalForce(const MaterialSPArray& matList, const Vector3D& gridSize);
-
-    /**
-     * Compute volume weighted strain energy
-     */
-    double computeStrainEnergy() const;
-
-    /**
-     * Compute volume weighted micromodulus
-     */
-    double computeMicroModulus() const;
-
-    /**
-     * Compute the critical strain in the bond and flag if broken
-     */
-    bool checkAndFlagBrokenBond();
-    bool checkAndFlagBrokenBond(const MaterialSPArray& matList); 
-
-    /**
-     * Set methods
-     */
-    void first(const NodeP node) { d_node1 = node; }
-    void second(const NodeP node) { d_node2 = node; }
-//    void material(MaterialUP& mat) { d_mat = std::move(mat); }
-//    void material(const Material* mat) { d_mat->clone(mat); }
-    void internalForce(const Vector3D& force)  { d_force = force; }
-    void isBroken(bool broken) { d_broken = broken;}
-
-    /**
-     * Get methods
-     */
-    const NodeP first() const { return d_node1; }
-//    const NodeP second() const { return d_node2; }
-    const NodeP second() const { return d_node2; }
-//    const Material* material() const {return d_mat.get(); }
-    const MaterialSP materialS() const {return d_mat; }
-    const Vector3D& internalForce() const { return d_force; }
-    bool isBroken() const { return d_broken; }
-    
-    /**
-     * Check if two bonds are identical
-     *   True if the start and end points are the same 
-     */
-    bool operator==(const Bond& bond) const;
-
-  private:
-    NodeP d_node1;
-    NodeP d_node2;
-//    MaterialUP d_mat;
-    MaterialSP d_mat;
-//    WoodSP d_wood;
-    Vector3D d_force;
-    bool d_broken;
-
-  };  // end class
-
-} // end namespace
-
-#endif
+#ifndef MATITI_BOND_H
+#define MATITI_BOND_H
+
+#include <Pointers/NodeP.h>
+#include <Pointers/WoodSP.h>
+//#include <Containers/WoodSPArray.h>
+#include <Woods/Wood.h>
+#include <Containers/MaterialSPArray.h>
+#include <Pointers/MaterialUP.h>
+#include <Pointers/MaterialSP.h>
+#include <MaterialModels/Material.h>
+#include <Geometry/Vector3D.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace Matiti {
+
+  class Bond 
+  {
+  public:
+
+    friend std::ostream& operator<<(std::ostream& out, const Matiti::Bond& bond);
+
+  public: 
+
+    Bond();
+    Bond(const NodeP node1, const NodeP node2);
+    Bond(const NodeP node1, const NodeP node2, const Material* mat);
+    Bond(const NodeP node1, const NodeP node2, const Material* mat1, const Material* mat2);
+    virtual ~Bond();
+
+    /**
+     * Compute volume weighted bond force
+     */
+    void computeInternalForce();
+    void computeInternalForce(const MaterialSPArray& matList, const Vector3D& gridSize);
+
+    /**
+     * Compute volume weighted strain energy
+     */
+    double computeStrainEnergy() const;
+
+    /**
+     * Compute volume weighted micromodulus
+     */
+    double computeMicroModulus() const;
+
+    /**
+     * Compute the critical strain in the bond and flag if broken
+     */
+    bool checkAndFlagBrokenBond();
+    bool checkAndFlagBrokenBond(const MaterialSPArray& matList); 
+
+    /**
+     * Fraction of the volume of the family node that is counted in the bond
+     * force (also used by NodeBondArrays)
+     *   lensVolumeFraction: the lens of intersection of the horizon and the
+     *     ball around the family node, over the volume of the family node
+     *     (Source: http://mathworld.wolfram.com/Sphere-SphereIntersection.html)
+     *   horizonVolumeFactor: linear in the bond length over the half interval
+     *     of the family node at the edge of the horizon
+     */
+    static inline double lensVolumeFraction(double bondLength, double horizonSize,
+                                            double node2Radius, double node2Volume)
+    {
+      double bond_length_plus_radius = bondLength + node2Radius;
+      double bond_length_minus_radius = bondLength - node2Radius;
+      if (horizonSize < bond_length_minus_radius) return 0.0;
+      if (!(horizonSize < bond_length_plus_radius)) return 1.0;
+      double horizon_cap_height = (bond_length_plus_radius - horizonSize)*
+                                  (horizonSize - bond_length_minus_radius)/(2.0*bondLength);
+      double node2_cap_height = (horizonSize + bond_length_minus_radius)*
+                                (horizonSize - bond_length_minus_radius)/(2.0*bondLength);
+      double horizon_cap_volume = (M_PI/3.0)*horizon_cap_height*horizon_cap_height*
+                                  (3.0*horizonSize - horizon_cap_height);
+      double node2_cap_volume = (M_PI/3.0)*node2_cap_height*node2_cap_height*
+                                (3.0*node2Radius - node2_cap_height);
+      return (horizon_cap_volume + node2_cap_volume)/node2Volume;
+    }
+
+    static inline double horizonVolumeFactor(double bondLength, double horizonSize,
+                                             double famRadius)
+    {
+      if (!(famRadius > 0.0)) return 0.0;
+      if (bondLength <= horizonSize - famRadius) return 1.0;
+      if (bondLength <= horizonSize + famRadius) {
+        return (horizonSize + famRadius - bondLength)/(2.0*famRadius);
+      }
+      return 0.0;
+    }
+
+    /**
+     * Set methods
+     */
+    void first(const NodeP node) { d_node1 = node; }
+    void second(const NodeP node) { d_node2 = node; }
+//    void material(MaterialUP& mat) { d_mat = std::move(mat); }
+//    void material(const Material* mat) { d_mat->clone(mat); }
+    void internalForce(const Vector3D& force)  { d_force = force; }
+    void isBroken(bool broken) { d_broken = broken;}
+
+    /**
+     * Get methods
+     */
+    const NodeP first() const { return d_node1; }
+//    const NodeP second() const { return d_node2; }
+    const NodeP second() const { return d_node2; }
+//    const Material* material() const {return d_mat.get(); }
+    const MaterialSP materialS() const {return d_mat; }
+    const Vector3D& internalForce() const { return d_force; }
+    bool isBroken() const { return d_broken; }
+    
+    /**
+     * Check if two bonds are identical
+     *   True if the start and end points are the same 
+     */
+    bool operator==(const Bond& bond) const;
+
+  private:
+    NodeP d_node1;
+    NodeP d_node2;
+//    MaterialUP d_mat;
+    MaterialSP d_mat;
+//    WoodSP d_wood;
+    Vector3D d_force;
+    bool d_broken;
+
+  };  // end class
+
+} // end namespace
+
+#endif
@@ -47,7 +47,7 @@ namespace Matiti {
 	std::runtime_error("")
     {
       std::ostringstream s;
-      s << "Exception thrown: " << file << ", line: " << line << "\n" << msg;
+      s << "Exception thrown: " << file << ", line: " << line << "\n" << msg.str();
       static_cast<std::runtime_error&>(*this) = std::runtime_error(s.str());
     }
   };
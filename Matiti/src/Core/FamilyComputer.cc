@@ -25,9 +25,12 @@
 #include <Core/FamilyComputer.h> 
 #include <Core/Exception.h>
 
+#include <cstdlib>
+
 using namespace Matiti;
 
 FamilyComputer::FamilyComputer()
+  : d_num_cells({{0,0,0}}), d_num_moved(0)
 {
 }
 
@@ -35,45 +38,133 @@ FamilyComputer::~FamilyComputer()
 {
 }
 
-// Find which cells the points sit in and create a unordered map that maps nodes to cells
+int
+FamilyComputer::cellIndex(const IntArray3& cell) const
+{
+  if (cell[0] < 1 || cell[1] < 1 || cell[2] < 1 ||
+      cell[0] > d_num_cells[0] || cell[1] > d_num_cells[1] || cell[2] > d_num_cells[2]) {
+    return d_num_cells[0]*d_num_cells[1]*d_num_cells[2];
+  }
+  return (cell[0]-1) + d_num_cells[0]*((cell[1]-1) + d_num_cells[1]*(cell[2]-1));
+}
+
+// Find which cells the points sit in and create a flat map from cells to nodes
 void 
 FamilyComputer::createCellNodeMap(const Domain& domain,
                                   const NodePArray& nodeList)
 {
-  if (!d_map.empty()) {
-    d_map.clear();
-  }
+  d_nodes = nodeList;
+  d_num_cells = domain.numCells();
 
-  for (constNodePIterator iter = nodeList.begin(); iter != nodeList.end(); iter++) {
-    NodeP node = *iter;
+  std::vector<int> node_cells(d_nodes.size());
+  for (std::size_t ii = 0; ii < d_nodes.size(); ++ii) {
     IntArray3 cell({{0,0,0}});
-    domain.findCellIndex(node->position(), cell);
-    long64 cellID = ((long64)cell[0] << 16) | ((long64)cell[1] << 32) | ((long64)cell[2] << 48);
-    d_map.insert(CellNodePPair(cellID, node));
+    domain.findCellIndex(d_nodes[ii]->position(), cell);
+    node_cells[ii] = cellIndex(cell);
   }
+  buildCellNodeMap(node_cells);
+  d_num_moved = (int) d_nodes.size();
 }
 
 // Update the cell-node map.
-// **WARNING** Will have to be improved later to update only those cells for which particles have
-//             entered or left.
 void 
 FamilyComputer::updateCellNodeMap(const Domain& domain,
                                   const NodePArray& nodeList)
 {
-  if (!d_map.empty()) {
-    d_map.clear();
+  bool same_nodes = (nodeList.size() == d_nodes.size()) && (domain.numCells() == d_num_cells);
+  for (std::size_t ii = 0; same_nodes && ii < d_nodes.size(); ++ii) {
+    same_nodes = (nodeList[ii] == d_nodes[ii]);
+  }
+  if (!same_nodes) {
+    d_nodes = nodeList;
+    d_num_cells = domain.numCells();
   }
 
-  for (constNodePIterator iter = nodeList.begin(); iter != nodeList.end(); iter++) {
-    NodeP node = *iter;
-    const Point3D& position = node->position();
-    const Vector3D& displacement = node->displacement();
+  // Find the cells at the current positions of the nodes
+  std::vector<int> node_cells(d_nodes.size());
+  std::vector<int> moved_nodes;
+  long64 shift_cost = 0;
+  for (std::size_t ii = 0; ii < d_nodes.size(); ++ii) {
+    const Point3D& position = d_nodes[ii]->position();
+    const Vector3D& displacement = d_nodes[ii]->displacement();
     Point3D position_new = position+displacement;
     IntArray3 cell({{0,0,0}});
     domain.findCellIndex(position_new, cell);
-    long64 cellID = ((long64)cell[0] << 16) | ((long64)cell[1] << 32) | ((long64)cell[2] << 48);
-    d_map.insert(CellNodePPair(cellID, node));
+    node_cells[ii] = cellIndex(cell);
+    if (same_nodes && node_cells[ii] != d_node_cell[ii]) {
+      moved_nodes.push_back((int) ii);
+      shift_cost += std::abs(node_cells[ii] - d_node_cell[ii]);
+    }
   }
+
+  // Each moved node is swapped once per cell between its old and new cell.
+  // Rebuild instead if that costs more than a counting sort.
+  long64 rebuild_cost = (long64) d_nodes.size() + (long64) d_cell_start.size();
+  if (!same_nodes || shift_cost > rebuild_cost) {
+    buildCellNodeMap(node_cells);
+    d_num_moved = (int) (same_nodes ? moved_nodes.size() : d_nodes.size());
+    return;
+  }
+  for (auto iter = moved_nodes.begin(); iter != moved_nodes.end(); ++iter) {
+    moveNode(*iter, node_cells[*iter]);
+  }
+  d_num_moved = (int) moved_nodes.size();
+}
+
+void
+FamilyComputer::buildCellNodeMap(const std::vector<int>& nodeCells)
+{
+  int num_cells = d_num_cells[0]*d_num_cells[1]*d_num_cells[2] + 1;
+  int num_nodes = (int) nodeCells.size();
+
+  d_node_cell = nodeCells;
+  d_cell_start.assign(num_cells+1, 0);
+  for (int ii = 0; ii < num_nodes; ++ii) {
+    ++d_cell_start[nodeCells[ii]+1];
+  }
+  for (int cc = 0; cc < num_cells; ++cc) {
+    d_cell_start[cc+1] += d_cell_start[cc];
+  }
+
+  std::vector<int> next(d_cell_start.begin(), d_cell_start.end()-1);
+  d_cell_nodes.resize(num_nodes);
+  d_node_slot.resize(num_nodes);
+  for (int ii = 0; ii < num_nodes; ++ii) {
+    int slot = next[nodeCells[ii]]++;
+    d_cell_nodes[slot] = ii;
+    d_node_slot[ii] = slot;
+  }
+}
+
+void
+FamilyComputer::moveNode(int node, int newCell)
+{
+  int old_cell = d_node_cell[node];
+  if (old_cell < newCell) {
+    // Move to the end of each cell and then shrink the cell by one 
+    for (int cc = old_cell; cc < newCell; ++cc) {
+      swapSlots(d_node_slot[node], d_cell_start[cc+1]-1);
+      --d_cell_start[cc+1];
+    }
+  } else {
+    // Move to the start of each cell and then shrink the cell by one 
+    for (int cc = old_cell; cc > newCell; --cc) {
+      swapSlots(d_node_slot[node], d_cell_start[cc]);
+      ++d_cell_start[cc];
+    }
+  }
+  d_node_cell[node] = newCell;
+}
+
+void
+FamilyComputer::swapSlots(int slot1, int slot2)
+{
+  int node1 = d_cell_nodes[slot1];
+  int node2 = d_cell_nodes[slot2];
+  d_cell_nodes[slot1] = node2;
+  d_cell_nodes[slot2] = node1;
+  d_node_slot[node1] = slot2;
+  d_node_slot[node2] = slot1;
 }
 
 // print the map
@@ -82,21 +173,19 @@ FamilyComputer::printCellNodeMap() const
 {
   std::cout << "CELL-NODE map: " << std::endl;
   // Print out all the data
-  for (auto it = d_map.begin(); it != d_map.end(); ++it) {
-    int kk_up = (it->first >> 48);
-    int jj_up = (it->first >> 32) & 0xffff;
-    int ii_up = (it->first >> 16) & 0xffff;
-    std::cout << "    cell key = " << it->first  << " [" << ii_up << "," << jj_up << "," << kk_up <<"] "
-              << " node id = " << (it->second)->getID() << std::endl;
-  }
-
-  // Check the buckets
-  std::cout << "    Bucket_count = " << d_map.bucket_count() << std::endl;
-  std::cout << "    cell_node_map's buckets contain:\n";
-  for ( unsigned i = 0; i < d_map.bucket_count(); ++i) {
-    std::cout << "        bucket #" << i << " contains:";
-    for ( auto local_it = d_map.begin(i); local_it!= d_map.end(i); ++local_it ) {
-      std::cout << " " << local_it->first << ":" << (local_it->second)->getID();
+  int num_cells = (int) d_cell_start.size() - 1;
+  for (int cc = 0; cc < num_cells; ++cc) {
+    if (d_cell_start[cc] == d_cell_start[cc+1]) continue;
+    if (cc == num_cells-1) {
+      std::cout << "    outside domain :";
+    } else {
+      int ii = cc % d_num_cells[0] + 1;
+      int jj = (cc / d_num_cells[0]) % d_num_cells[1] + 1;
+      int kk = cc / (d_num_cells[0]*d_num_cells[1]) + 1;
+      std::cout << "    cell [" << ii << "," << jj << "," << kk << "] :";
+    }
+    for (int slot = d_cell_start[cc]; slot < d_cell_start[cc+1]; ++slot) {
+      std::cout << " " << d_nodes[d_cell_nodes[slot]]->getID();
     }
     std::cout << std::endl;
   }
@@ -107,11 +196,10 @@ void
 FamilyComputer::printCellNodeMap(const IntArray3& cell) const
 {
   std::cout << "CELL-NODE map: " << std::endl;
-  long64 cellID = ((long64)cell[0] << 16) | ((long64)cell[1] << 32) | ((long64)cell[2] << 48);
-  auto nodes = d_map.equal_range(cellID);
-  for (auto it = nodes.first; it != nodes.second; ++it) {
+  int cc = cellIndex(cell);
+  for (int slot = d_cell_start[cc]; slot < d_cell_start[cc+1]; ++slot) {
     std::cout << "    Cell (" << cell[0] << "," << cell[1] << "," << cell[2]
-              <<": key = " << it->first << " value = " << *(it->second) << std::endl;
+              <<": value = " << *(d_nodes[d_cell_nodes[slot]]) << std::endl;
   }
 }
 
@@ -162,10 +250,9 @@ FamilyComputer::getInitialFamily(NodeP node,
   for (int ii=iimin; ii <= iimax; ++ii) {
     for (int jj=jjmin; jj <= jjmax; ++jj) {
       for (int kk=kkmin; kk <= kkmax; ++kk) {
-        long64 cellID = ((long64)ii << 16) | ((long64)jj << 32) | ((long64)kk << 48);
-        auto nodes = d_map.equal_range(cellID);
-        for (auto it = nodes.first; it != nodes.second; ++it) {
-          NodeP near_node = it->second;
+        int cc = (ii-1) + d_num_cells[0]*((jj-1) + d_num_cells[1]*(kk-1));
+        for (int slot = d_cell_start[cc]; slot < d_cell_start[cc+1]; ++slot) {
+          const NodeP& near_node = d_nodes[d_cell_nodes[slot]];
           //std::cout << near_node->getID();
           if (node == near_node) {
             //std::cout << ", ";
@@ -179,7 +266,7 @@ FamilyComputer::getInitialFamily(NodeP node,
             family.push_back(near_node);
             //std::cout << "*, ";
           } 
-        } // it loop
+        } // slot loop
       } // kk loop
     } // jj loop
   } // ii loop
@@ -219,15 +306,14 @@ FamilyComputer::getCurrentFamily(NodeP node,
   for (int ii=iimin; ii <= iimax; ++ii) {
     for (int jj=jjmin; jj <= jjmax; ++jj) {
       for (int kk=kkmin; kk <= kkmax; ++kk) {
-        long64 cellID = ((long64)ii << 16) | ((long64)jj << 32) | ((long64)kk << 48);
-        auto nodes = d_map.equal_range(cellID);
-        for (auto it = nodes.first; it != nodes.second; ++it) {
-          NodeP near_node = it->second;
+        int cc = (ii-1) + d_num_cells[0]*((jj-1) + d_num_cells[1]*(kk-1));
+        for (int slot = d_cell_start[cc]; slot < d_cell_start[cc+1]; ++slot) {
+          const NodeP& near_node = d_nodes[d_cell_nodes[slot]];
           if (node == near_node) continue;
           if (node->distance(*near_node) < node->horizonSize()) {
             family.push_back(near_node);
           } 
-        } // it loop
+        } // slot loop
       } // kk loop
     } // jj loop
   } // ii loop
@@ -29,7 +29,9 @@
 #include <Core/Node.h>
 #include <Pointers/NodeP.h>
 #include <Containers/NodePArray.h>
-#include <Types/CellNodePMap.h>
+#include <Types/Types.h>
+
+#include <vector>
 
 //************************************** 
 /** 
@@ -45,6 +47,11 @@
   *
   * This class provides methods for computing the node-family structures
   * for a node.
+  *
+  * The cell-node map is a flat index: the node indices sorted by cell and the
+  * offset of the first node of each cell.  Nodes outside the domain are kept
+  * in an extra cell after the last domain cell.  When the map is updated only
+  * the nodes that have changed cells are moved.
   */
 
 namespace Matiti {
@@ -70,7 +77,9 @@ namespace Matiti {
                            const NodePArray& nodeList);
 
     /**
-     *  Clear existing map and create a new map
+     *  Update the map with the current nodal positions.  Only the nodes that
+     *  have moved to another cell are relocated; the map is rebuilt if that
+     *  would be cheaper or if the node list or domain has changed.
      *
      * @param domain Reference to the domain object
      * @param nodeList Reference to the vector of NodeP objects inside the domain
@@ -84,6 +93,11 @@ namespace Matiti {
     void printCellNodeMap() const;
     void printCellNodeMap(const IntArray3& cell) const;
 
+    /**
+     *  Number of nodes that changed cells in the last map update
+     */
+    int numMovedNodes() const { return d_num_moved; }
+
     /**
      *  Finds the family of a node: all the nodes inside the horizon of the node 
      *    The family is based on the initial nodal positions
@@ -108,8 +122,35 @@ namespace Matiti {
 
   private:
 
+    /**
+     *  Index of a domain cell in the flat map (the extra cell if outside)
+     */
+    int cellIndex(const IntArray3& cell) const;
+
+    /**
+     *  Rebuild the map with a counting sort of the nodes on cell index
+     */
+    void buildCellNodeMap(const std::vector<int>& nodeCells);
+
+    /**
+     *  Move a node to another cell by shifting it across the cells between
+     *  the old and new cells (one swap per cell crossed)
+     */
+    void moveNode(int node, int newCell);
+
+    /**
+     *  Swap the nodes at two positions of the sorted node array
+     */
+    void swapSlots(int slot1, int slot2);
+
     // Store the cell-node map
-    CellNodePMap d_map;
+    NodePArray d_nodes;
+    IntArray3 d_num_cells;
+    std::vector<int> d_cell_start;   // Position of the first node of each cell
+    std::vector<int> d_cell_nodes;   // Node indices sorted by cell
+    std::vector<int> d_node_cell;    // Cell of each node
+    std::vector<int> d_node_slot;    // Position of each node in d_cell_nodes
+    int d_num_moved;
 
     // prevent copying
     FamilyComputer(const FamilyComputer& family);
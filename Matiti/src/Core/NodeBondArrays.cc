@@ -0,0 +1,411 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2013-2014 Callaghan Innovation, New Zealand
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <Core/NodeBondArrays.h>
+#include <Core/Body.h>
+#include <Core/Node.h>
+#include <Core/Bond.h>
+#include <Core/Exception.h>
+#include <MaterialModels/Material.h>
+#include <MaterialModels/Density.h>
+#include <Woods/Wood.h>
+
+#include <algorithm>
+#include <exception>
+#include <unordered_map>
+#include <sstream>
+#define _USE_MATH_DEFINE
+#include <cmath>
+
+using namespace Matiti;
+
+NodeBondArrays::NodeBondArrays()
+{
+}
+
+NodeBondArrays::~NodeBondArrays()
+{
+}
+
+void
+NodeBondArrays::initialize(const BodySP body)
+{
+  d_nodes = body->nodes();
+  d_body_force = body->bodyForce();
+  d_grid_size = body->gridSize();
+
+  int num_nodes = (int) d_nodes.size();
+  d_pos.resize(num_nodes);
+  d_volume.resize(num_nodes);
+  d_radius.resize(num_nodes);
+  d_fam_radius.resize(num_nodes);
+  d_horizon.resize(num_nodes);
+  d_density.resize(num_nodes);
+  d_mat_density.resize(num_nodes);
+  d_initial_family_size.resize(num_nodes);
+  d_allow_failure.resize(num_nodes);
+  d_omit.resize(num_nodes);
+  d_disp.resize(num_nodes);
+  d_disp_new.resize(num_nodes);
+  d_vel.resize(num_nodes);
+  d_vel_new.resize(num_nodes);
+  d_int_force.resize(num_nodes);
+  d_ext_force.resize(num_nodes);
+  d_strain_energy.assign(num_nodes, 0.0);
+  d_sp_sum.assign(num_nodes, 0.0);
+  d_damage.resize(num_nodes);
+
+  std::unordered_map<const Node*, int> node_index;
+  node_index.reserve(num_nodes);
+  for (int ii = 0; ii < num_nodes; ++ii) {
+    const NodeP& node = d_nodes[ii];
+    node_index[node.get()] = ii;
+
+    d_pos[ii] = node->position();
+    d_volume[ii] = node->volume();
+    d_radius[ii] = node->radius();
+    const Array3& interval = node->getInterval();
+    d_fam_radius[ii] = 0.5*std::max(std::max(interval[0], interval[1]), interval[2]);
+    d_horizon[ii] = node->horizonSize();
+    d_density[ii] = node->densityNode();
+    d_mat_density[ii] = node->density();
+    d_initial_family_size[ii] = node->initialFamilySize();
+    d_allow_failure[ii] = node->failureAllowed();
+    d_damage[ii] = node->damageIndex();
+  }
+  copyKinematicsFromNodes();
+
+  // Flatten the bond lists
+  d_bond_start.assign(1, 0);
+  d_bond_family.clear();
+  d_bond_broken.clear();
+  d_bond_mat.clear();
+  d_bonds.clear();
+  for (int ii = 0; ii < num_nodes; ++ii) {
+    const BondPArray& bonds = d_nodes[ii]->getBonds();
+    for (auto bond_iter = bonds.begin(); bond_iter != bonds.end(); ++bond_iter) {
+      const BondP& bond = *bond_iter;
+      auto fam_iter = node_index.find(bond->second().get());
+      if (fam_iter == node_index.end()) {
+        std::ostringstream out;
+        out << "**ERROR** Bond " << *bond << " connects node " << d_nodes[ii]->getID()
+            << " to a node that is not in the same body.";
+        throw Exception(out.str(), __FILE__, __LINE__);
+      }
+      d_bond_family.push_back(fam_iter->second);
+      d_bond_broken.push_back(bond->isBroken());
+      d_bond_mat.push_back(bond->materialS().get());
+      d_bonds.push_back(bond);
+    }
+    d_bond_start.push_back((int) d_bond_family.size());
+  }
+}
+
+// Same computations as Bond::computeInternalForce (with the same Bond volume
+// factors) and Bond::checkAndFlagBrokenBond
+// but with the nodal quantities read from the arrays.  Each node only modifies
+// its own bonds and bond materials.
+void
+NodeBondArrays::computeInternalForce(const MaterialSPArray& matList, bool isWood,
+                                     bool checkBroken)
+{
+  DensitySP density;
+  WoodSP wood;
+  if (isWood) {
+    density = matList.front()->getDensity();
+    wood = matList.front()->getWood();
+  }
+
+  int num_nodes = numNodes();
+  std::exception_ptr error = nullptr;
+
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (int ii = 0; ii < num_nodes; ++ii) {
+    try {
+      Vector3D internal_force(0.0, 0.0, 0.0);
+      double strain_energy = 0.0;
+      double spsum = 0.0;
+
+      for (int bb = d_bond_start[ii]; bb < d_bond_start[ii+1]; ++bb) {
+        if (d_bond_broken[bb]) continue;
+        int jj = d_bond_family[bb];
+        if (d_omit[jj]) continue;  // skip this node
+
+        // Compute the bond internal force using the material model
+        Material* mat = d_bond_mat[bb];
+        Vector3D force(0.0, 0.0, 0.0);
+        double bond_length = (d_pos[jj] - d_pos[ii]).length();
+        double delta = d_horizon[ii];
+        double fam_volume = d_volume[jj];
+        if (isWood) {
+          mat->computeForce(d_pos[ii], d_pos[jj], d_disp[ii], d_disp[jj], delta,
+                            density, wood, d_grid_size, force);
+
+          fam_volume *= Bond::lensVolumeFraction(bond_length, delta, d_radius[jj], fam_volume);
+        } else {
+          mat->computeForce(d_pos[ii], d_pos[jj], d_disp[ii], d_disp[jj], delta, force);
+
+          fam_volume *= Bond::horizonVolumeFactor(bond_length, delta, d_fam_radius[jj]);
+        }
+        force *= fam_volume;
+
+        if (force.isnan()) {
+          std::ostringstream out;
+          out << "**ERROR**  Nan internal force" << force << " Bond = " << *d_bonds[bb]
+              << " family vol = " << fam_volume;
+          throw Exception(out.str(), __FILE__, __LINE__);
+        }
+
+        // Flag broken bonds.  The damage indices are those at the end of the
+        // previous step. Bonds broken in this step still carry their force.
+        if (checkBroken && d_allow_failure[ii] && d_allow_failure[jj]) {
+          double dmgij = std::max(d_damage[ii], d_damage[jj]);
+          double damage_fac = mat->computeDamageFactor(dmgij);
+          double critical_strain_cur = mat->computeCriticalStrain(delta);
+          if (isWood) {
+            bool earlywood_node_1 = mat->earlywoodPoint(d_pos[ii], density, wood);
+            bool earlywood_node_2 = mat->earlywoodPoint(d_pos[jj], density, wood);
+            critical_strain_cur = wood->computeCriticalStrain(d_bonds[bb]->first(),
+                                                              d_bonds[bb]->second(),
+                                                              earlywood_node_1,
+                                                              earlywood_node_2);
+          }
+          if (mat->strain() > critical_strain_cur*damage_fac) {
+            d_bond_broken[bb] = true;
+          }
+        }
+
+        // Sum up the force on node ii due to all the attached bonds.
+        internal_force += force;
+        strain_energy += mat->strainEnergy()*(0.5*d_volume[jj]);
+        spsum += mat->microModulus()*d_volume[jj]/d_density[ii];
+      }
+
+      d_int_force[ii] = internal_force;
+      d_strain_energy[ii] = strain_energy;
+      d_sp_sum[ii] = spsum;
+    } catch (...) {
+      #pragma omp critical (NodeBondArrays_error)
+      {
+        if (!error) error = std::current_exception();
+      }
+    }
+  }
+
+  if (error) std::rethrow_exception(error);
+}
+
+void
+NodeBondArrays::updateDamageIndex()
+{
+  int num_nodes = numNodes();
+
+  #pragma omp parallel for schedule(static)
+  for (int ii = 0; ii < num_nodes; ++ii) {
+    if (d_omit[ii] || !(d_initial_family_size[ii] > 0)) continue;
+    int num_bonds_cur = 0;
+    for (int bb = d_bond_start[ii]; bb < d_bond_start[ii+1]; ++bb) {
+      if (!d_bond_broken[bb]) ++num_bonds_cur;
+    }
+    d_damage[ii] = 1.0 - (double) num_bonds_cur/(double) d_initial_family_size[ii];
+  }
+
+  for (int ii = 0; ii < num_nodes; ++ii) {
+    if (!d_omit[ii] && !(d_initial_family_size[ii] > 0)) {
+      std::ostringstream out;
+      out << "**ERROR** Number of initial bonds is zero for node " << d_nodes[ii]->getID();
+      throw Exception(out.str(), __FILE__, __LINE__);
+    }
+  }
+}
+
+void
+NodeBondArrays::integrateFirstHalf(const MaterialSPArray& matList, bool isWood,
+                                   double delT, bool computeForce)
+{
+  if (computeForce) {
+    computeInternalForce(matList, isWood, false);
+  }
+
+  int num_nodes = numNodes();
+  bool nan_found = false;
+
+  #pragma omp parallel for schedule(static) reduction(||:nan_found)
+  for (int ii = 0; ii < num_nodes; ++ii) {
+    if (d_omit[ii]) {
+      d_vel_new[ii].reset();
+      d_disp_new[ii] = d_disp[ii];
+      continue;  // skip this node
+    }
+
+    // Compute acceleration (F_ext - F_int = m a)
+    Vector3D acceleration = (d_ext_force[ii] + d_int_force[ii] + d_body_force*d_density[ii])/
+                            d_density[ii];
+    nan_found = nan_found || acceleration.isnan() || d_vel[ii].isnan();
+
+    // 1. v(n+1/2) = v(n) + dt/2m * f(u(n))
+    d_vel_new[ii] = d_vel[ii] + acceleration*(0.5*delT);
+    d_vel[ii] = d_vel_new[ii];
+
+    // 2. u(n+1) = u(n) + dt * v(n+1/2)
+    d_disp_new[ii] = d_disp[ii] + d_vel[ii]*delT;
+  }
+
+  if (nan_found) {
+    std::ostringstream out;
+    out << "Acceleration/old velocity is nan in velocity Verlet stage 1.";
+    throw Exception(out.str(), __FILE__, __LINE__);
+  }
+}
+
+void
+NodeBondArrays::integrateSecondHalf(const MaterialSPArray& matList, bool isWood,
+                                    double delT)
+{
+  int num_nodes = numNodes();
+
+  #pragma omp parallel for schedule(static)
+  for (int ii = 0; ii < num_nodes; ++ii) {
+    d_disp[ii] = d_disp_new[ii];
+  }
+
+  // Compute updated internal force from updated nodal displacements
+  computeInternalForce(matList, isWood, true);
+
+  bool nan_found = false;
+
+  #pragma omp parallel for schedule(static) reduction(||:nan_found)
+  for (int ii = 0; ii < num_nodes; ++ii) {
+
+    // Compute acceleration (F_ext - F_int = m a)
+    Vector3D acceleration = (d_ext_force[ii] + d_int_force[ii] + d_body_force*d_density[ii])/
+                            d_density[ii];
+    nan_found = nan_found || acceleration.isnan() || d_vel[ii].isnan();
+
+    // 3. v(n+1) = v(n+1/2) + dt/2m * f(q(n+1))
+    d_vel_new[ii] = d_vel[ii] + acceleration*(0.5*delT);
+  }
+
+  if (nan_found) {
+    std::ostringstream out;
+    out << "Acceleration/old velocity is nan in velocity Verlet stage 2.";
+    throw Exception(out.str(), __FILE__, __LINE__);
+  }
+
+  // After all bonds have been checked update nodal damage indices
+  updateDamageIndex();
+}
+
+// Same as Node::computeStableTimestep over the unbroken bonds
+double
+NodeBondArrays::updateKinematics(const double& timeStepFactor)
+{
+  int num_nodes = numNodes();
+  double delT_min = 1.0e16;
+
+  #pragma omp parallel for schedule(static) reduction(min:delT_min)
+  for (int ii = 0; ii < num_nodes; ++ii) {
+    d_disp[ii] = d_disp_new[ii];
+    d_vel[ii] = d_vel_new[ii];
+
+    double denom = 0.0;
+    int num_bonds = 0;
+    for (int bb = d_bond_start[ii]; bb < d_bond_start[ii+1]; ++bb) {
+      if (d_bond_broken[bb]) continue;
+      denom += d_bond_mat[bb]->microModulus()*d_volume[d_bond_family[bb]];
+      ++num_bonds;
+    }
+    if (num_bonds == 0) continue;
+    double delT = timeStepFactor*d_horizon[ii]*std::sqrt(2.0*d_mat_density[ii]/denom);
+    delT_min = std::min(delT_min, delT);
+  }
+  return delT_min;
+}
+
+void
+NodeBondArrays::copyKinematicsToNodes() const
+{
+  int num_nodes = numNodes();
+
+  #pragma omp parallel for schedule(static)
+  for (int ii = 0; ii < num_nodes; ++ii) {
+    const NodeP& node = d_nodes[ii];
+    node->displacement(d_disp[ii]);
+    node->newDisplacement(d_disp_new[ii]);
+    node->velocity(d_vel[ii]);
+    node->newVelocity(d_vel_new[ii]);
+    node->internalForce(d_int_force[ii]);
+  }
+}
+
+void
+NodeBondArrays::copyKinematicsFromNodes()
+{
+  int num_nodes = numNodes();
+
+  #pragma omp parallel for schedule(static)
+  for (int ii = 0; ii < num_nodes; ++ii) {
+    const NodeP& node = d_nodes[ii];
+    d_omit[ii] = node->omit();
+    d_disp[ii] = node->displacement();
+    d_disp_new[ii] = node->newDisplacement();
+    d_vel[ii] = node->velocity();
+    d_vel_new[ii] = node->newVelocity();
+    d_int_force[ii] = node->internalForce();
+    d_ext_force[ii] = node->externalForce();
+  }
+}
+
+void
+NodeBondArrays::updateNodes()
+{
+  copyKinematicsToNodes();
+
+  int num_nodes = numNodes();
+
+  #pragma omp parallel for schedule(static)
+  for (int ii = 0; ii < num_nodes; ++ii) {
+    const NodeP& node = d_nodes[ii];
+    node->strainEnergy(d_strain_energy[ii]);
+    node->spSum(d_sp_sum[ii]);
+
+    // Flag the broken bonds and remove them from the bond list of the node
+    bool has_broken = false;
+    for (int bb = d_bond_start[ii]; bb < d_bond_start[ii+1]; ++bb) {
+      if (d_bond_broken[bb] && !d_bonds[bb]->isBroken()) {
+        d_bonds[bb]->isBroken(true);
+        has_broken = true;
+      }
+    }
+    if (has_broken) {
+      BondPArray& bonds = node->getBonds();
+      bonds.erase(std::remove_if(bonds.begin(), bonds.end(),
+                                 [](const BondP& bond) { return bond->isBroken(); }),
+                  bonds.end());
+    }
+
+    if (d_omit[ii]) continue;
+    node->updateDamageIndex();
+  }
+}
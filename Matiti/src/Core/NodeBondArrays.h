@@ -0,0 +1,168 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2013-2014 Callaghan Innovation, New Zealand
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MATITI_NODE_BOND_ARRAYS_H
+#define MATITI_NODE_BOND_ARRAYS_H
+
+#include <Pointers/BodySP.h>
+#include <Containers/NodePArray.h>
+#include <Containers/BondPArray.h>
+#include <Containers/MaterialSPArray.h>
+#include <Geometry/Point3D.h>
+#include <Geometry/Vector3D.h>
+
+#include <vector>
+
+//**************************************
+/**
+  * @file
+  * @section DESCRIPTION
+  *
+  * Structure-of-arrays copy of the nodes and bonds of a body used by the
+  * velocity-Verlet loop in Peridynamics::run.
+  *
+  * The nodal quantities are stored in contiguous arrays indexed by the position
+  * of the node in Body::nodes().  The bonds of all the nodes are stored in
+  * one array, with the bonds of node i in [bondStart(i), bondStart(i+1)).  Each
+  * bond is kept as the index of its family node, a broken flag and a pointer
+  * to the bond material (which stores the strain history).  Broken bonds are
+  * flagged, not erased, during the time stepping.
+  *
+  * The Node/Bond objects stay the input/output view of the body: the arrays
+  * are filled from them once, the boundary conditions are still applied to
+  * the nodes (copyKinematicsToNodes/copyKinematicsFromNodes), and
+  * updateNodes() copies everything back and erases the broken bonds before
+  * output is written.
+  *
+  * The bonds of a node are owned by that node only, so the loops over nodes
+  * are run in parallel with OpenMP.
+  */
+
+namespace Matiti {
+
+  class Material;
+
+  class NodeBondArrays {
+
+  public:
+
+    NodeBondArrays();
+    ~NodeBondArrays();
+
+    /**
+     * Copy the nodes and bonds of a body into the arrays
+     */
+    void initialize(const BodySP body);
+
+    /**
+     * Velocity-Verlet stage 1 (at the old displacements)
+     *   v(n+1/2) = v(n) + dt/2m * f(u(n))
+     *   u(n+1) = u(n) + dt * v(n+1/2)
+     * The internal force is recomputed only if computeForce is true, otherwise
+     * the force from the previous stage 2 is used.
+     */
+    void integrateFirstHalf(const MaterialSPArray& matList, bool isWood,
+                            double delT, bool computeForce);
+
+    /**
+     * Velocity-Verlet stage 2 (at the new displacements)
+     *   v(n+1) = v(n+1/2) + dt/2m * f(u(n+1))
+     * Bonds that exceed their critical strain are flagged as broken and the
+     * nodal damage indices are updated.
+     */
+    void integrateSecondHalf(const MaterialSPArray& matList, bool isWood,
+                             double delT);
+
+    /**
+     * Move the new displacements and velocities into the current ones and
+     * return the stable timestep of the body
+     */
+    double updateKinematics(const double& timeStepFactor);
+
+    /**
+     * Copy the displacements, velocities and internal forces to the nodes
+     * (and back) so that boundary conditions can be applied to them
+     */
+    void copyKinematicsToNodes() const;
+    void copyKinematicsFromNodes();
+
+    /**
+     * Copy all the nodal data to the nodes, erase the broken bonds from
+     * the node bond lists and update the damage indices of the nodes
+     */
+    void updateNodes();
+
+    int numNodes() const { return (int) d_nodes.size(); }
+    int numBonds() const { return (int) d_bond_family.size(); }
+
+  private:
+
+    /**
+     * Compute the internal force density of each node and, if checkBroken
+     * is true, flag the bonds that exceed the critical strain
+     */
+    void computeInternalForce(const MaterialSPArray& matList, bool isWood,
+                              bool checkBroken);
+
+    void updateDamageIndex();
+
+    NodePArray d_nodes;
+    Vector3D d_body_force;
+    Vector3D d_grid_size;
+
+    // Reference configuration
+    std::vector<Point3D> d_pos;
+    std::vector<double> d_volume;
+    std::vector<double> d_radius;
+    std::vector<double> d_fam_radius;    // Half the largest node interval
+    std::vector<double> d_horizon;
+    std::vector<double> d_density;       // Node density
+    std::vector<double> d_mat_density;   // Density of the node material
+    std::vector<int> d_initial_family_size;
+    std::vector<char> d_allow_failure;
+
+    // Kinematics and forces
+    std::vector<char> d_omit;
+    std::vector<Vector3D> d_disp;
+    std::vector<Vector3D> d_disp_new;
+    std::vector<Vector3D> d_vel;
+    std::vector<Vector3D> d_vel_new;
+    std::vector<Vector3D> d_int_force;
+    std::vector<Vector3D> d_ext_force;
+    std::vector<double> d_strain_energy;
+    std::vector<double> d_sp_sum;
+    std::vector<double> d_damage;
+
+    // Bonds
+    std::vector<int> d_bond_start;
+    std::vector<int> d_bond_family;
+    std::vector<char> d_bond_broken;
+    std::vector<Material*> d_bond_mat;
+    BondPArray d_bonds;
+
+  }; // end class NodeBondArrays
+
+} // end namespace
+
+#endif
@@ -30,6 +30,7 @@
 #include <Core/Body.h>
 #include <Core/Node.h>
 #include <Core/Bond.h>
+#include <Core/NodeBondArrays.h>
 #include <Core/Exception.h>
 
 #include <Pointers/MaterialUP.h>
@@ -310,16 +311,13 @@ Peridynamics::run()
   }
   */
 
-  //  myfile.open("checkMatiti.txt", ios::out);
-  fstream myfile;
-  myfile.open("checkMatiti.txt", ios::out);
-  if (myfile.is_open()) {
-    myfile.precision(20);
-  } else {
-    cout << "Unable to open the file";  
+  // Copy the nodes and bonds of each body into contiguous arrays for the
+  // time integration.  The nodes are updated from the arrays before output.
+  std::vector<NodeBondArrays> body_arrays(d_body_list.size());
+  for (std::size_t ii = 0; ii < d_body_list.size(); ++ii) {
+    body_arrays[ii].initialize(d_body_list[ii]);
   }
-
-  //int nodeNumber = 740;
+  bool is_wood = isMaterialWood();
     
   while (cur_time < d_time.maxTime() && cur_iter < d_time.maxIter()) {
    
@@ -327,316 +325,46 @@ Peridynamics::run()
 
     // Get the current delT
     double delT = d_time.delT();
-    // bool condition = ((cur_iter == 1) || (cur_iter == 5) || (cur_iter == 500 ));
-    // bool condition = ((cur_iter == 1) || (cur_iter%20 == 0));
-       
-    /* 
-      if (condition) {
-        myfile << "\n Iteration Number= " << cur_iter << "\n";
-      }
-    */
-   
-    // std::cout << std::endl << " Iteration Number " << cur_iter << std::endl << std::endl;
 
     // Do the computations separately for each body
-    for (auto body_iter = d_body_list.begin(); body_iter != d_body_list.end(); ++body_iter) {    
-
-      const NodePArray& node_list = (*body_iter)->nodes();
-      // Get acceleration due to body force
-      Vector3D body_force = (*body_iter)->bodyForce();
-      // Get the grid's size
-      Vector3D grid_size = (*body_iter)->gridSize();
-  
-      // std::cout << " STAGE ONE VV" << std::endl;
-      // Step 1:
-      // Update nodal velocity and nodal displacement
-      // 1. v(n+1/2) = v(n) + dt/2m * f(u(n))
-      // 2. u(n+1) = u(n) + dt * v(n+1/2)
-
-      // Compute internal force (Step 1)
-      //    and add body force to internal force
-      for (auto node_iter = node_list.begin(); node_iter != node_list.end(); ++node_iter) {
-
-        // Get the node
-        NodeP cur_node = *node_iter;
-        // Compute the internal force at the node
-        if (cur_iter == 1) { 
-          Vector3D internal_force_density(0.0, 0.0, 0.0);
-          computeInternalForceDensity(cur_node, internal_force_density, grid_size);
-          cur_node->internalForce(internal_force_density);
-        }
-      }
-
-      for (auto node_iter = node_list.begin(); node_iter != node_list.end(); ++node_iter) {
-
-        // Get the node
-        NodeP cur_node = *node_iter;
-        if (cur_node->omit()) {
-          // cur_node->velocity(Zero);
-          // cur_node->displacement(Zero);
-          // cur_node->newVelocity(Zero);
-          // cur_node->newDisplacement(Zero);
-          cur_node->newVelocity(Zero);
-          cur_node->newDisplacement(cur_node->displacement());
-          continue;  // skip this node
-        } else {
-
-          Vector3D internal_force_density = cur_node->internalForce();
-
-          // Compute body force density
-          Vector3D body_force_density = body_force*cur_node->densityNode();
-
-          // Get external force
-          Vector3D external_force_density = cur_node->externalForce();
-               
-          // Compute acceleration (F_ext - F_int = m a)
-          // **TODO** Make sure mass is conserved
-          Vector3D acceleration = (external_force_density + internal_force_density + body_force_density)/cur_node->densityNode();
-        
-          // int id = cur_node->getID();
-          // if (id == 1 || id == 2 || id == 104 || id == 105) {
-          //   std::cout << "Node = " << id << " F_ext = " << external_force_density << " F_int = " 
-          //             << internal_force_density << std::endl;
-          //   std::cout << " body_force=  " << body_force_density << " density = " << cur_node->densityNode() 
-          //             << " volume = " << cur_node->volume() 
-          //             << " area = " << cur_node->area() 
-          //             << " acceleration= " << acceleration << std::endl;
-          //   std::cout << *cur_node ;
-          // }
-        
-
-          // Integrate acceleration with velocity Verlet algorithm
-          // and Update nodal velocity
-          // 1. v(n+1/2) = v(n) + dt/2m * f(u(n))
-          Vector3D velocity_mid(0.0, 0.0, 0.0);
-          integrateNodalAcceleration(cur_node->velocity(), acceleration, 0.5*delT, velocity_mid);
-          cur_node->newVelocity(velocity_mid);
-          cur_node->velocity(cur_node->newVelocity());
-
-          // Integrate the mid step velocity
-          // and Update nodal displacement
-          // 2. u(n+1) = u(n) + dt * v(n+1/2)
-          Vector3D displacement_new(0.0, 0.0, 0.0);
-          integrateNodalVelocity(cur_node->displacement(), cur_node->velocity(), delT, displacement_new);
-          // cur_node->displacement(displacement_new);
-          cur_node->newDisplacement(displacement_new);
-
-          // std::cout << "horizon_size= " << cur_node->horizonSize() << std::endl;
-
-          // std::cout << "After Stage 1: Node = " << cur_node->getID() 
-          //           << " vel_old = " << cur_node->velocity() 
-          //           << " vel_new = " << cur_node->newVelocity() 
-          //           << " disp_old = " << cur_node->displacement() 
-          //           << " disp_new = " << cur_node->newDisplacement() 
-          //           << std::endl;
-
-        } //end of else
-
-      } //end of for (node)
+    // Step 1:
+    // Update nodal velocity and nodal displacement
+    // 1. v(n+1/2) = v(n) + dt/2m * f(u(n))
+    // 2. u(n+1) = u(n) + dt * v(n+1/2)
+    // The internal force is computed here only in the first iteration;
+    // afterwards the force from Step 2 of the previous iteration is used.
+    for (auto arrays_iter = body_arrays.begin(); arrays_iter != body_arrays.end(); ++arrays_iter) {
+      arrays_iter->integrateFirstHalf(d_mat_list, is_wood, delT, cur_iter == 1);
 
       // **TODO** Apply any external forces due to contact  
       // (*body_iter)->applyContactForces();
+    }
 
-    } // end of for (body)
-    
-    
-    // int fe = fetestexcept(FE_ALL_EXCEPT);
-    // std::cout << "Floating point exception somewhere in the code ?" << fe
-    //           << std::endl;
-    // std::cout << "   The following exceptions are set" << std::endl;
-    // if (fe & FE_DIVBYZERO) puts ("FE_DIVBYZERO");
-    // if (fe & FE_INEXACT)   puts ("FE_INEXACT");
-    // if (fe & FE_INVALID)   puts ("FE_INVALID");
-    // if (fe & FE_OVERFLOW)  puts ("FE_OVERFLOW");
-    // if (fe & FE_UNDERFLOW) puts ("FE_UNDERFLOW");
-
-    // std::cout << " STAGE 2 VV " << std::endl;
     // Stage 2 of Velocity Verlet
     //   Update nodal velocity
     //     3. v(n+1) = v(n+1/2) + dt/2m * f(q(n+1))
-       
-    for (auto body_iter = d_body_list.begin(); body_iter != d_body_list.end(); ++body_iter) {
-
-      // Get the nodes in the body
-      const NodePArray& node_list = (*body_iter)->nodes();
-
-      // Get body force per unit volume
-      Vector3D body_force = (*body_iter)->bodyForce();
-
-      // Get the grid's size
-      Vector3D grid_size = (*body_iter)->gridSize();
-      // std::cout << "grid size= " << "(" << grid_size.x() << ", " << grid_size.y() << ", " << grid_size.z() << ")" << std::endl;
-
-      // Compute internal force  (Step 2)
-      for (auto node_iter = node_list.begin(); node_iter != node_list.end(); ++node_iter) {
-
-        // Get the node
-        NodeP cur_node = *node_iter;
-        cur_node->displacement(cur_node->newDisplacement());
-      }
-
-      for (auto node_iter = node_list.begin(); node_iter != node_list.end(); ++node_iter) {
-
-        // Get the node
-        NodeP cur_node = *node_iter;
-
-        // std::cout << "Before stage 2 : Node = " << cur_node->getID() 
-        //           << " vel = " << cur_node->velocity() << " disp = " << cur_node->displacement() << std::endl;
-
-        // Compute updated internal force from updated nodal displacements
-        std::vector <int> posBrokenBond;
-        Vector3D internal_force_density1(0.0, 0.0, 0.0);
-        computeInternalForceDensity(cur_node, internal_force_density1, grid_size, cur_iter, posBrokenBond);
-        cur_node->internalForce(internal_force_density1);
-        
-        // Compute body force density
-        Vector3D body_force_density = body_force*cur_node->densityNode();
-
-        // Get external force
-        Vector3D external_force_density = cur_node->externalForce();
-
-        // Compute acceleration (F_ext - F_int = m a) 
-        Vector3D acceleration = (external_force_density + internal_force_density1 + body_force_density)/cur_node->densityNode();
-
-        // Integrate acceleration with velocity Verlet algorithm
-        // and Update nodal velocity
-        // 3. v(n+1) = v(n+1/2) + dt/2m * f(q(n+1))
-        Vector3D velocity_new(0.0, 0.0, 0.0);
-        integrateNodalAcceleration(cur_node->velocity(), acceleration, 0.5*delT, velocity_new);
-        cur_node->newVelocity(velocity_new);
-         
-        // bool condition = (cur_node->getID() == 1) && ((cur_iter == 1) || (cur_iter == 5) || (cur_iter == 500 ));    
-        // if ((cur_node->getID() == nodeNumber) && (condition)) {
-        //   myfile << "\nNode= " << cur_node->getID() << " , (" << cur_node->x() << ", " << cur_node->y()
-        //          << ", " << cur_node->z() << ") , volume= " << cur_node->volume()
-        //          << ", horizon_size= " << cur_node->horizonSize() << "\n";
-
-        //   myfile << "external_force= " << "  (" << cur_node->externalForce().x() << ", " << cur_node->externalForce().y()
-        //          << ", " << cur_node->externalForce().z() << ") \n";
-        //   myfile << "internal_force= " << "  (" << cur_node->internalForce().x() << ", " << cur_node->internalForce().y()
-        //          << ", " << cur_node->internalForce().z() << ") \n";
-        //   myfile << "displacement= " << "  (" << cur_node->displacement().x() << ", " << cur_node->displacement().y()
-        //          << ", " << cur_node->displacement().z() << ") \n";               
-        //   myfile << "velocity= " << "  (" << cur_node->newVelocity().x() << ", " << cur_node->newVelocity().y()
-        //          << ", " << cur_node->newVelocity().z() << ") \n";
-        // }  
-              
-        // if (cur_node->getID() == nodeNumber) {
-        //   std::cout << "Iteration: " << cur_iter << std::endl;
-        // }
-        // nodeNominates = ((cur_node->getID() == minNodeId) || (cur_node->getID() == maxNodeId));
-        // if (nodeNominates) {
-        //   myfile << "Iteration: " << cur_iter << std::endl;
-        //   std::cout << "Node " << cur_node->getID() << std::endl;
-        //   myfile << "Node " << cur_node->getID() << std::endl;
-        // }
-
-        BondPArray& bonds = cur_node->getBonds();
-        for (auto family_iter = bonds.begin(); family_iter != bonds.end(); family_iter++) {
-          BondP bond = *family_iter;
-          const NodeP node1 = bond->first();
-          const NodeP node2 = bond->second();
-          // const Material* mat = bond->material();
-          const MaterialSP mat = bond->materialS();
-          // if ((cur_node->getID() == nodeNumber) && (condition))
-          // if (cur_node->getID() == nodeNumber)
-          // if (nodeNominates) {
-          // }
-              
-          //const double dmgij = std::max(node1->damageIndex(), node2->damageIndex());
-          //double damage_fac = mat->computeDamageFactor(dmgij);
-          //const double horizon = node1->horizonSize();
-          //double critical_strain_cur = mat->computeCriticalStrain(horizon);
-          // double ecr2 = critical_strain_cur*damage_fac;
-          // double str = mat->strain();
-          //  myfile << "str= " << str << "\n";
-          // if ((cur_node->getID() == nodeNumber) && (condition)) {
-          //   if ((str > ecr2) && (node1->failureAllowed() == true) && (node2->failureAllowed() == true)) {
-          //      myfile << ",****Breaking bond between nodes " << node1->getID() << " and " << node2->getID() 
-          //             << ", critical strain = " << critical_strain_cur << "\n, ecr2 = "
-          //             << ecr2 << ", strain = " << str << std::endl;
-          //   }
-          // } 
-        }
-
-        // if ((cur_iter > 490) && (cur_node->getID() == 1513)) {
-        //   myfile << "Iteration= " << cur_iter << std::endl;
-        //   myfile << *cur_node << std::endl;
-        //   myfile << "posBrokenBond= ";
-        // }
-        int modifyPos = 0;                 
-        for (auto pos_iter = posBrokenBond.begin(); pos_iter != posBrokenBond.end(); pos_iter++) {
-          int position = *pos_iter;
-          // if (cur_node->getID() == nodeNumber)
-          // if (nodeNominates)
-          if ((cur_iter == 600 ) && (cur_node->getID() == 500)) {
-            std::cout << "posBrokenBond= " << position << ", ";
-          }
-          myfile << position << ", ";  
-          position-=modifyPos;
-          bonds.erase(bonds.begin()+position);
-          modifyPos++;
-        }
-        // std::cout << std::endl;
-        if ((cur_iter > 490) && (cur_node->getID() == 1513)) {
-          myfile << std::endl;               
-        }
-
-        if (cur_node->omit()) continue;  // skip this node
-        cur_node->updateDamageIndex();
-  
-        // if ((cur_node->getID() == nodeNumber) && (condition)) {
-        // }
-        if ((cur_iter > 490) && (cur_node->getID() == 1513)) {
-          myfile << "+++++Damage_index= " << cur_node->damageIndex() << "\n\n";
-        }
-               
-
-        // std::cout << "After stage 2 : Node = " << cur_node->getID() << " internal force= " << cur_node->internalForce() 
-        //           << " vel = " << cur_node->newVelocity() << " disp = " << cur_node->newDisplacement() << std::endl;
-      } // end of for (node)
+    //   and break the bonds that are stretched beyond the critical strain
+    for (std::size_t ii = 0; ii < d_body_list.size(); ++ii) {
+      body_arrays[ii].integrateSecondHalf(d_mat_list, is_wood, delT);
 
       // Apply displacement (and actually velocity too) boundary conditions
       // before the first stage of time integration
       //  Adds a reaction force to the external force in the direction opposite the
       //  internal force and with the same magnitude
-      (*body_iter)->applyDisplacementBC();
-
-      // Print body information
-      // std::cout << *(*body_iter);
-    } // end of for (body)
+      body_arrays[ii].copyKinematicsToNodes();
+      d_body_list[ii]->applyDisplacementBC();
+    }
  
     // Apply domain boundary conditions to the body
-    for (auto body_iter = d_body_list.begin(); body_iter != d_body_list.end(); ++body_iter) {
-      d_domain.applyVelocityBC(*body_iter);
+    for (std::size_t ii = 0; ii < d_body_list.size(); ++ii) {
+      d_domain.applyVelocityBC(d_body_list[ii]);
+      body_arrays[ii].copyKinematicsFromNodes();
     }
 
     // Update kinematic quantities and delT
-    //feclearexcept(FE_ALL_EXCEPT);
-    Vector3D finalTotalMomentum(0.0, 0.0, 0.0);
-    double kineticEnergy(0.0);
     double delT_new = delT;
-    for (auto body_iter = d_body_list.begin(); body_iter != d_body_list.end(); ++body_iter) {
-
-      // Loop through nodes in the body
-      const NodePArray& node_list = (*body_iter)->nodes();
-      for (auto node_iter = node_list.begin(); node_iter != node_list.end(); ++node_iter) {
-
-        // Get the node
-        NodeP cur_node = *node_iter;
-
-        // Update kinematic quantities
-        cur_node->displacement(cur_node->newDisplacement());
-        cur_node->velocity(cur_node->newVelocity());
-
-        // Compute momentum and KE
-        finalTotalMomentum +=cur_node->velocity()*(cur_node->volume()*cur_node->densityNode());
-        kineticEnergy +=cur_node->velocity().lengthSq()*1/2*cur_node->volume()
-        *cur_node->densityNode();
-
-        // Compute stable delT
-        delT_new = std::min(cur_node->computeStableTimestep(d_time.timeStepFactor()), delT_new);
-      }
+    for (auto arrays_iter = body_arrays.begin(); arrays_iter != body_arrays.end(); ++arrays_iter) {
+      delT_new = std::min(arrays_iter->updateKinematics(d_time.timeStepFactor()), delT_new);
     }
 
     // if (cur_iter > 1) {
@@ -700,12 +428,17 @@ Peridynamics::run()
      // Output nodal information every snapshots_frequency iteration   
      int output_freq = d_output.outputIteratonInterval();
      if (cur_iter%output_freq == 0) {
+       for (auto arrays_iter = body_arrays.begin(); arrays_iter != body_arrays.end(); ++arrays_iter) {
+         arrays_iter->updateNodes();
+       }
        d_output.write(d_time, d_domain, d_body_list);
        //std::cout << "Wrote out data at time " << d_time << std::endl;
      }
    }
 
-   myfile.close();
+   for (auto arrays_iter = body_arrays.begin(); arrays_iter != body_arrays.end(); ++arrays_iter) {
+     arrays_iter->updateNodes();
+   }
 }
  
   
@@ -66,6 +66,9 @@ namespace Matiti {
 
     void run();
 
+    const Domain& domain() const { return d_domain; }
+    const BodySPArray& bodies() const { return d_body_list; }
+
   protected:
 
     void applyInitialConditions();
@@ -0,0 +1,139 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2013-2014 Callaghan Innovation, New Zealand
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+// Time the refresh of the cell-node map and of the node families for the
+// bodies in one or more input files.  For each body the nodes are given
+// random displacements of increasing size (as a fraction of the cell size)
+// and the following are timed:
+//   rebuild : FamilyComputer::createCellNodeMap (full counting sort)
+//   update  : FamilyComputer::updateCellNodeMap (only nodes that changed cells)
+//   family  : Body::updateFamily (map update + family search for all nodes)
+//
+// Usage: test_family_refresh <filename> [<filename> ...]
+
+#include <Peridynamics.h>
+#include <InputOutput/ProblemSpecReader.h>
+#include <Core/Body.h>
+#include <Core/Node.h>
+#include <Core/FamilyComputer.h>
+#include <Core/Exception.h>
+
+#include <Core/ProblemSpec/ProblemSpec.h>
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <random>
+
+using namespace Matiti;
+
+void test_family_refresh(const std::string& filename);
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2) {
+    std::cout << "Usage: test_family_refresh <filename> [<filename> ...]" << std::endl;
+    exit(0);
+  }
+
+  std::cout << std::setw(40) << "input file" << std::setw(6) << "body"
+            << std::setw(10) << "nodes" << std::setw(8) << "disp" << std::setw(10) << "moved"
+            << std::setw(14) << "rebuild (us)" << std::setw(14) << "update (us)"
+            << std::setw(14) << "family (ms)" << std::endl;
+  for (int ii = 1; ii < argc; ++ii) {
+    try {
+      test_family_refresh(argv[ii]);
+    } catch (const std::exception& e) {
+      std::cout << e.what() << std::endl;
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+void test_family_refresh(const std::string& filename)
+{
+  Uintah::ProblemSpecP ps = ProblemSpecReader().readInputFile(filename);
+
+  if (!ps) {
+    throw Exception("Cannot read input file", __FILE__, __LINE__);
+  }
+  if (ps->getNodeName() != "Vaango") {
+    throw Exception("Input file is not a Vaango file specification.", __FILE__, __LINE__);
+  }
+
+  // Set up the bodies and their initial families
+  Peridynamics peri;
+  peri.problemSetup(ps);
+  const Domain& domain = peri.domain();
+  double cell_size = std::min(std::min(domain.cellSize()[0], domain.cellSize()[1]),
+                              domain.cellSize()[2]);
+
+  // Displacement amplitudes as fractions of the cell size
+  const double disp_fractions[] = {0.0, 0.01, 0.1, 0.5};
+
+  unsigned int seed = 1;
+  std::default_random_engine rand_gen(seed);
+
+  int body_id = 0;
+  const BodySPArray& bodies = peri.bodies();
+  for (auto body_iter = bodies.begin(); body_iter != bodies.end(); ++body_iter, ++body_id) {
+    const NodePArray& nodes = (*body_iter)->nodes();
+
+    FamilyComputer fc;
+    fc.createCellNodeMap(domain, nodes);
+
+    for (double fraction : disp_fractions) {
+
+      // Displace the nodes
+      std::uniform_real_distribution<double> disp_rand(-fraction*cell_size, fraction*cell_size);
+      for (auto node_iter = nodes.begin(); node_iter != nodes.end(); ++node_iter) {
+        (*node_iter)->displacement(Vector3D(disp_rand(rand_gen), disp_rand(rand_gen),
+                                            disp_rand(rand_gen)));
+      }
+
+      auto t1 = std::chrono::high_resolution_clock::now();
+      FamilyComputer fc_rebuild;
+      fc_rebuild.createCellNodeMap(domain, nodes);
+      auto t2 = std::chrono::high_resolution_clock::now();
+      fc.updateCellNodeMap(domain, nodes);
+      auto t3 = std::chrono::high_resolution_clock::now();
+      (*body_iter)->updateFamily(domain);
+      auto t4 = std::chrono::high_resolution_clock::now();
+
+      std::cout << std::setw(40) << filename << std::setw(6) << body_id
+                << std::setw(10) << nodes.size() << std::setw(8) << fraction
+                << std::setw(10) << fc.numMovedNodes()
+                << std::setw(14) << std::chrono::duration_cast<std::chrono::microseconds>(t2-t1).count()
+                << std::setw(14) << std::chrono::duration_cast<std::chrono::microseconds>(t3-t2).count()
+                << std::setw(14) << std::chrono::duration_cast<std::chrono::milliseconds>(t4-t3).count()
+                << std::endl;
+    }
+  }
+
+  ps = 0;  // give up memory held by ps
+}
@@ -0,0 +1,134 @@
+#ifndef CORE_GEOMETRY_CELL_BINS_H
+#define CORE_GEOMETRY_CELL_BINS_H
+
+#include <Core/Math/Vec.h>
+#include <Core/Types/realtypes.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace dem {
+
+/////////////////////////////////////
+// Linked-cell binning of a set of points for neighbor searches.
+// The points are sorted into cubic cells of edge at least minCellSize
+// covering their bounding box, stored as one index array with a start
+// offset per cell.  Two points closer than minCellSize are then in the
+// same or in adjacent cells.  Within a cell the point indices are in
+// increasing order.
+class CellBins
+{
+public:
+  CellBins()
+    : d_minCorner(0)
+    , d_cellSize(1)
+    , d_nx(0)
+    , d_ny(0)
+    , d_nz(0)
+  {
+  }
+
+  void build(const std::vector<Vec>& points, REAL minCellSize)
+  {
+    d_cellStart.assign(1, 0);
+    d_cellPoints.clear();
+    d_nx = d_ny = d_nz = 0;
+    if (points.empty()) {
+      return;
+    }
+
+    Vec minCorner = points[0];
+    Vec maxCorner = points[0];
+    for (const auto& pt : points) {
+      minCorner.set(std::min(minCorner.x(), pt.x()),
+                    std::min(minCorner.y(), pt.y()),
+                    std::min(minCorner.z(), pt.z()));
+      maxCorner.set(std::max(maxCorner.x(), pt.x()),
+                    std::max(maxCorner.y(), pt.y()),
+                    std::max(maxCorner.z(), pt.z()));
+    }
+    d_minCorner = minCorner;
+
+    // Sparse point sets get coarser cells so that the number of cells
+    // stays proportional to the number of points
+    Vec extent = maxCorner - minCorner;
+    d_cellSize = (minCellSize > 0) ? minCellSize : 1;
+    for (;;) {
+      d_nx = static_cast<std::size_t>(extent.x() / d_cellSize) + 1;
+      d_ny = static_cast<std::size_t>(extent.y() / d_cellSize) + 1;
+      d_nz = static_cast<std::size_t>(extent.z() / d_cellSize) + 1;
+      if (static_cast<double>(d_nx) * d_ny * d_nz <= 8.0 * points.size()) {
+        break;
+      }
+      d_cellSize *= 2;
+    }
+
+    // Counting sort of the points into the cells
+    std::size_t numCells = d_nx * d_ny * d_nz;
+    std::vector<std::size_t> pointCell(points.size());
+    d_cellStart.assign(numCells + 1, 0);
+    for (std::size_t i = 0; i < points.size(); ++i) {
+      long ix, iy, iz;
+      cellIndex(points[i], ix, iy, iz);
+      pointCell[i] = std::min<std::size_t>(ix, d_nx - 1) +
+                     d_nx * (std::min<std::size_t>(iy, d_ny - 1) +
+                             d_ny * std::min<std::size_t>(iz, d_nz - 1));
+      ++d_cellStart[pointCell[i] + 1];
+    }
+    for (std::size_t c = 0; c < numCells; ++c) {
+      d_cellStart[c + 1] += d_cellStart[c];
+    }
+    d_cellPoints.resize(points.size());
+    std::vector<std::size_t> next(d_cellStart.begin(), d_cellStart.end() - 1);
+    for (std::size_t i = 0; i < points.size(); ++i) {
+      d_cellPoints[next[pointCell[i]]++] = i;
+    }
+  }
+
+  // Calls func(j) for every binned point j in the cell containing pt and
+  // in the 26 cells around it.  pt may lie outside the binned region.
+  template <typename Func>
+  void forEachNeighbor(const Vec& pt, Func&& func) const
+  {
+    if (d_cellPoints.empty()) {
+      return;
+    }
+    long ix, iy, iz;
+    cellIndex(pt, ix, iy, iz);
+    long nx = d_nx, ny = d_ny, nz = d_nz;
+    for (long kz = std::max(iz - 1, 0L); kz <= std::min(iz + 1, nz - 1); ++kz) {
+      for (long ky = std::max(iy - 1, 0L); ky <= std::min(iy + 1, ny - 1);
+           ++ky) {
+        for (long kx = std::max(ix - 1, 0L); kx <= std::min(ix + 1, nx - 1);
+             ++kx) {
+          std::size_t cell = kx + d_nx * (ky + d_ny * kz);
+          for (std::size_t k = d_cellStart[cell]; k < d_cellStart[cell + 1];
+               ++k) {
+            func(d_cellPoints[k]);
+          }
+        }
+      }
+    }
+  }
+
+  REAL getCellSize() const { return d_cellSize; }
+
+private:
+  void cellIndex(const Vec& pt, long& ix, long& iy, long& iz) const
+  {
+    ix = static_cast<long>(std::floor((pt.x() - d_minCorner.x()) / d_cellSize));
+    iy = static_cast<long>(std::floor((pt.y() - d_minCorner.y()) / d_cellSize));
+    iz = static_cast<long>(std::floor((pt.z() - d_minCorner.z()) / d_cellSize));
+  }
+
+  Vec d_minCorner;
+  REAL d_cellSize;
+  std::size_t d_nx, d_ny, d_nz;
+  std::vector<std::size_t> d_cellStart;  // first point of each cell
+  std::vector<std::size_t> d_cellPoints; // point indices sorted by cell
+};
+
+} // end namespace dem
+
+#endif
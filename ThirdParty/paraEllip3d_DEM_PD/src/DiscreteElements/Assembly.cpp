@@ -31,6 +31,7 @@
 #include <Boundary/CylinderBoundary.h>
 #include <Boundary/PlaneBoundary.h>
 #include <Core/Const/const.h>
+#include <Core/Geometry/CellBins.h>
 #include <Core/Util/Utility.h>
 #include <DiscreteElements/Assembly.h>
 #include <InputOutput/OutputTecplot.h>
@@ -65,6 +66,7 @@ using periDynamics::PeriParticleP;
 using periDynamics::PeriParticlePArray;
 using periDynamics::PeriBondP;
 using periDynamics::PeriBondPArray;
+using periDynamics::PeriBondPairArray;
 using util::timediff;
 using util::timediffmsec;
 using util::timediffsec;
@@ -72,6 +74,87 @@ using util::combine;
 using Timer = std::chrono::steady_clock;
 using Seconds = std::chrono::seconds;
 
+// Offsets of the 26 neighboring blocks in the Cartesian process grid, in
+// the order of Assembly::getNeighborRanks: 6 surfaces, 12 edges, 8 vertices
+static const int neighborOffsets[26][3] = {
+  { -1, 0, 0 },   { 1, 0, 0 },   { 0, -1, 0 },  { 0, 1, 0 },   { 0, 0, -1 },
+  { 0, 0, 1 },    { -1, -1, 0 }, { -1, 1, 0 },  { -1, 0, -1 }, { -1, 0, 1 },
+  { 1, -1, 0 },   { 1, 1, 0 },   { 1, 0, -1 },  { 1, 0, 1 },   { 0, -1, -1 },
+  { 0, -1, 1 },   { 0, 1, -1 },  { 0, 1, 1 },   { -1, -1, -1 }, { -1, -1, 1 },
+  { -1, 1, -1 },  { -1, 1, 1 },  { 1, -1, -1 }, { 1, -1, 1 },  { 1, 1, -1 },
+  { 1, 1, 1 }
+};
+
+// Index of the neighbor in the direction opposite to neighbor k
+static int
+oppositeNeighbor(int k)
+{
+  for (int m = 0; m < 26; ++m) {
+    if (neighborOffsets[m][0] == -neighborOffsets[k][0] &&
+        neighborOffsets[m][1] == -neighborOffsets[k][1] &&
+        neighborOffsets[m][2] == -neighborOffsets[k][2]) {
+      return m;
+    }
+  }
+  return -1;
+}
+
+// Exchanges fixed-size records with the neighboring blocks as raw bytes:
+// sendBuf[k] goes to ranks[k] and recvBuf[k] receives what ranks[k] sent
+// to this process.  The record counts are exchanged first so that the
+// receive buffers can be sized; the buffers keep their capacity between
+// calls.  Each direction has its own tag, so a process may appear more
+// than once in ranks.
+template <typename Record>
+static void
+exchangeRecords(MPI_Comm comm, int tag, const std::array<int, 26>& ranks,
+                std::vector<std::vector<Record>>& sendBuf,
+                std::vector<std::vector<Record>>& recvBuf,
+                std::size_t& bytesSent, std::size_t& bytesRecv)
+{
+  recvBuf.resize(26);
+  std::array<int, 26> sendCount, recvCount;
+  std::vector<MPI_Request> reqs;
+  reqs.reserve(52);
+
+  for (int k = 0; k < 26; ++k) {
+    if (ranks[k] < 0)
+      continue;
+    sendCount[k] = static_cast<int>(sendBuf[k].size());
+    reqs.push_back(MPI_REQUEST_NULL);
+    MPI_Irecv(&recvCount[k], 1, MPI_INT, ranks[k],
+              tag + oppositeNeighbor(k), comm, &reqs.back());
+    reqs.push_back(MPI_REQUEST_NULL);
+    MPI_Isend(&sendCount[k], 1, MPI_INT, ranks[k], tag + k, comm,
+              &reqs.back());
+  }
+  MPI_Waitall(static_cast<int>(reqs.size()), reqs.data(),
+              MPI_STATUSES_IGNORE);
+
+  reqs.clear();
+  bytesSent = bytesRecv = 0;
+  for (int k = 0; k < 26; ++k) {
+    recvBuf[k].clear();
+    if (ranks[k] < 0)
+      continue;
+    recvBuf[k].resize(recvCount[k]);
+    if (recvCount[k] > 0) {
+      reqs.push_back(MPI_REQUEST_NULL);
+      MPI_Irecv(recvBuf[k].data(), recvCount[k] * sizeof(Record), MPI_BYTE,
+                ranks[k], tag + 26 + oppositeNeighbor(k), comm, &reqs.back());
+      bytesRecv += recvCount[k] * sizeof(Record);
+    }
+    if (sendCount[k] > 0) {
+      reqs.push_back(MPI_REQUEST_NULL);
+      MPI_Isend(sendBuf[k].data(), sendCount[k] * sizeof(Record), MPI_BYTE,
+                ranks[k], tag + 26 + k, comm, &reqs.back());
+      bytesSent += sendCount[k] * sizeof(Record);
+    }
+  }
+  MPI_Waitall(static_cast<int>(reqs.size()), reqs.data(),
+              MPI_STATUSES_IGNORE);
+}
+
 void
 Assembly::deposit(const std::string& boundaryFile,
                   const std::string& particleFile)
@@ -293,6 +376,17 @@ Assembly::scatterParticle()
   broadcast(boostWorld, grid, 0);
 }
 
+void
+Assembly::getNeighborRanks(std::array<int, 26>& ranks) const
+{
+  ranks = { { rankX1,     rankX2,     rankY1,     rankY2,     rankZ1,
+              rankZ2,     rankX1Y1,   rankX1Y2,   rankX1Z1,   rankX1Z2,
+              rankX2Y1,   rankX2Y2,   rankX2Z1,   rankX2Z2,   rankY1Z1,
+              rankY1Z2,   rankY2Z1,   rankY2Z2,   rankX1Y1Z1, rankX1Y1Z2,
+              rankX1Y2Z1, rankX1Y2Z2, rankX2Y1Z1, rankX2Y1Z2, rankX2Y2Z1,
+              rankX2Y2Z2 } };
+}
+
 void
 Assembly::commuParticle()
 {
@@ -469,393 +563,70 @@ Assembly::commuParticle()
   ++neighborCoords[2];
   MPI_Cart_rank(cartComm, neighborCoords.data(), &rankX2Y2Z2);
 
-  // if found, communicate with neighboring blocks
-  ParticlePArray particleX1, particleX2;
-  ParticlePArray particleY1, particleY2;
-  ParticlePArray particleZ1, particleZ2;
-  ParticlePArray particleX1Y1, particleX1Y2, particleX1Z1, particleX1Z2;
-  ParticlePArray particleX2Y1, particleX2Y2, particleX2Z1, particleX2Z2;
-  ParticlePArray particleY1Z1, particleY1Z2, particleY2Z1, particleY2Z2;
-  ParticlePArray particleX1Y1Z1, particleX1Y1Z2, particleX1Y2Z1, particleX1Y2Z2;
-  ParticlePArray particleX2Y1Z1, particleX2Y1Z2, particleX2Y2Z1, particleX2Y2Z2;
-  boost::mpi::request reqX1[2], reqX2[2];
-  boost::mpi::request reqY1[2], reqY2[2];
-  boost::mpi::request reqZ1[2], reqZ2[2];
-  boost::mpi::request reqX1Y1[2], reqX1Y2[2], reqX1Z1[2], reqX1Z2[2];
-  boost::mpi::request reqX2Y1[2], reqX2Y2[2], reqX2Z1[2], reqX2Z2[2];
-  boost::mpi::request reqY1Z1[2], reqY1Z2[2], reqY2Z1[2], reqY2Z2[2];
-  boost::mpi::request reqX1Y1Z1[2], reqX1Y1Z2[2], reqX1Y2Z1[2], reqX1Y2Z2[2];
-  boost::mpi::request reqX2Y1Z1[2], reqX2Y1Z2[2], reqX2Y2Z1[2], reqX2Y2Z2[2];
+  // if found, communicate with neighboring blocks: particles within
+  // cellSize of a face, edge or vertex are sent as fixed-size records
+  std::array<int, 26> ranks;
+  getNeighborRanks(ranks);
   v1 = container.getMinCorner(); // redefine v1, v2 in terms of process
   v2 = container.getMaxCorner();
-  /*
-  debugInf << "rank=" << mpiRank
-     << ' ' << v1.x() << ' ' << v1.y() << ' ' << v1.z()
-     << ' ' << v2.x() << ' ' << v2.y() << ' ' << v2.z()
-     << std::endl;
-  */
   REAL cellSize = gradation.getPtclMaxRadius() * 2;
-  // 6 surfaces
-  if (rankX1 >= 0) { // surface x1
-    Box containerX1(v1.x(), v1.y(), v1.z(), v1.x() + cellSize, v2.y(), v2.z());
-    findParticleInBox(containerX1, particleVec, particleX1);
-    reqX1[0] = boostWorld.isend(rankX1, mpiTag, particleX1);
-    reqX1[1] = boostWorld.irecv(rankX1, mpiTag, rParticleX1);
-  }
-  if (rankX2 >= 0) { // surface x2
-    Box containerX2(v2.x() - cellSize, v1.y(), v1.z(), v2.x(), v2.y(), v2.z());
-    findParticleInBox(containerX2, particleVec, particleX2);
-    reqX2[0] = boostWorld.isend(rankX2, mpiTag, particleX2);
-    reqX2[1] = boostWorld.irecv(rankX2, mpiTag, rParticleX2);
-  }
-  if (rankY1 >= 0) { // surface y1
-    Box containerY1(v1.x(), v1.y(), v1.z(), v2.x(), v1.y() + cellSize, v2.z());
-    findParticleInBox(containerY1, particleVec, particleY1);
-    reqY1[0] = boostWorld.isend(rankY1, mpiTag, particleY1);
-    reqY1[1] = boostWorld.irecv(rankY1, mpiTag, rParticleY1);
-  }
-  if (rankY2 >= 0) { // surface y2
-    Box containerY2(v1.x(), v2.y() - cellSize, v1.z(), v2.x(), v2.y(), v2.z());
-    findParticleInBox(containerY2, particleVec, particleY2);
-    reqY2[0] = boostWorld.isend(rankY2, mpiTag, particleY2);
-    reqY2[1] = boostWorld.irecv(rankY2, mpiTag, rParticleY2);
-  }
-  if (rankZ1 >= 0) { // surface z1
-    Box containerZ1(v1.x(), v1.y(), v1.z(), v2.x(), v2.y(), v1.z() + cellSize);
-    findParticleInBox(containerZ1, particleVec, particleZ1);
-    reqZ1[0] = boostWorld.isend(rankZ1, mpiTag, particleZ1);
-    reqZ1[1] = boostWorld.irecv(rankZ1, mpiTag, rParticleZ1);
-  }
-  if (rankZ2 >= 0) { // surface z2
-    Box containerZ2(v1.x(), v1.y(), v2.z() - cellSize, v2.x(), v2.y(), v2.z());
-    findParticleInBox(containerZ2, particleVec, particleZ2);
-    reqZ2[0] = boostWorld.isend(rankZ2, mpiTag, particleZ2);
-    reqZ2[1] = boostWorld.irecv(rankZ2, mpiTag, rParticleZ2);
-  }
-  // 12 edges
-  if (rankX1Y1 >= 0) { // edge x1y1
-    Box containerX1Y1(v1.x(), v1.y(), v1.z(), v1.x() + cellSize,
-                      v1.y() + cellSize, v2.z());
-    findParticleInBox(containerX1Y1, particleVec, particleX1Y1);
-    reqX1Y1[0] = boostWorld.isend(rankX1Y1, mpiTag, particleX1Y1);
-    reqX1Y1[1] = boostWorld.irecv(rankX1Y1, mpiTag, rParticleX1Y1);
-  }
-  if (rankX1Y2 >= 0) { // edge x1y2
-    Box containerX1Y2(v1.x(), v2.y() - cellSize, v1.z(), v1.x() + cellSize,
-                      v2.y(), v2.z());
-    findParticleInBox(containerX1Y2, particleVec, particleX1Y2);
-    reqX1Y2[0] = boostWorld.isend(rankX1Y2, mpiTag, particleX1Y2);
-    reqX1Y2[1] = boostWorld.irecv(rankX1Y2, mpiTag, rParticleX1Y2);
-  }
-  if (rankX1Z1 >= 0) { // edge x1z1
-    Box containerX1Z1(v1.x(), v1.y(), v1.z(), v1.x() + cellSize, v2.y(),
-                      v1.z() + cellSize);
-    findParticleInBox(containerX1Z1, particleVec, particleX1Z1);
-    reqX1Z1[0] = boostWorld.isend(rankX1Z1, mpiTag, particleX1Z1);
-    reqX1Z1[1] = boostWorld.irecv(rankX1Z1, mpiTag, rParticleX1Z1);
-  }
-  if (rankX1Z2 >= 0) { // edge x1z2
-    Box containerX1Z2(v1.x(), v1.y(), v2.z() - cellSize, v1.x() + cellSize,
-                      v2.y(), v2.z());
-    findParticleInBox(containerX1Z2, particleVec, particleX1Z2);
-    reqX1Z2[0] = boostWorld.isend(rankX1Z2, mpiTag, particleX1Z2);
-    reqX1Z2[1] = boostWorld.irecv(rankX1Z2, mpiTag, rParticleX1Z2);
-  }
-  if (rankX2Y1 >= 0) { // edge x2y1
-    Box containerX2Y1(v2.x() - cellSize, v1.y(), v1.z(), v2.x(),
-                      v1.y() + cellSize, v2.z());
-    findParticleInBox(containerX2Y1, particleVec, particleX2Y1);
-    reqX2Y1[0] = boostWorld.isend(rankX2Y1, mpiTag, particleX2Y1);
-    reqX2Y1[1] = boostWorld.irecv(rankX2Y1, mpiTag, rParticleX2Y1);
-  }
-  if (rankX2Y2 >= 0) { // edge x2y2
-    Box containerX2Y2(v2.x() - cellSize, v2.y() - cellSize, v1.z(), v2.x(),
-                      v2.y(), v2.z());
-    findParticleInBox(containerX2Y2, particleVec, particleX2Y2);
-    reqX2Y2[0] = boostWorld.isend(rankX2Y2, mpiTag, particleX2Y2);
-    reqX2Y2[1] = boostWorld.irecv(rankX2Y2, mpiTag, rParticleX2Y2);
-  }
-  if (rankX2Z1 >= 0) { // edge x2z1
-    Box containerX2Z1(v2.x() - cellSize, v1.y(), v1.z(), v2.x(), v2.y(),
-                      v1.z() + cellSize);
-    findParticleInBox(containerX2Z1, particleVec, particleX2Z1);
-    reqX2Z1[0] = boostWorld.isend(rankX2Z1, mpiTag, particleX2Z1);
-    reqX2Z1[1] = boostWorld.irecv(rankX2Z1, mpiTag, rParticleX2Z1);
-  }
-  if (rankX2Z2 >= 0) { // edge x2z2
-    Box containerX2Z2(v2.x() - cellSize, v1.y(), v2.z() - cellSize, v2.x(),
-                      v2.y(), v2.z());
-    findParticleInBox(containerX2Z2, particleVec, particleX2Z2);
-    reqX2Z2[0] = boostWorld.isend(rankX2Z2, mpiTag, particleX2Z2);
-    reqX2Z2[1] = boostWorld.irecv(rankX2Z2, mpiTag, rParticleX2Z2);
-  }
-  if (rankY1Z1 >= 0) { // edge y1z1
-    Box containerY1Z1(v1.x(), v1.y(), v1.z(), v2.x(), v1.y() + cellSize,
-                      v1.z() + cellSize);
-    findParticleInBox(containerY1Z1, particleVec, particleY1Z1);
-    reqY1Z1[0] = boostWorld.isend(rankY1Z1, mpiTag, particleY1Z1);
-    reqY1Z1[1] = boostWorld.irecv(rankY1Z1, mpiTag, rParticleY1Z1);
-  }
-  if (rankY1Z2 >= 0) { // edge y1z2
-    Box containerY1Z2(v1.x(), v1.y(), v2.z() - cellSize, v2.x(),
-                      v1.y() + cellSize, v2.z());
-    findParticleInBox(containerY1Z2, particleVec, particleY1Z2);
-    reqY1Z2[0] = boostWorld.isend(rankY1Z2, mpiTag, particleY1Z2);
-    reqY1Z2[1] = boostWorld.irecv(rankY1Z2, mpiTag, rParticleY1Z2);
-  }
-  if (rankY2Z1 >= 0) { // edge y2z1
-    Box containerY2Z1(v1.x(), v2.y() - cellSize, v1.z(), v2.x(), v2.y(),
-                      v1.z() + cellSize);
-    findParticleInBox(containerY2Z1, particleVec, particleY2Z1);
-    reqY2Z1[0] = boostWorld.isend(rankY2Z1, mpiTag, particleY2Z1);
-    reqY2Z1[1] = boostWorld.irecv(rankY2Z1, mpiTag, rParticleY2Z1);
-  }
-  if (rankY2Z2 >= 0) { // edge y2z2
-    Box containerY2Z2(v1.x(), v2.y() - cellSize, v2.z() - cellSize, v2.x(),
-                      v2.y(), v2.z());
-    findParticleInBox(containerY2Z2, particleVec, particleY2Z2);
-    reqY2Z2[0] = boostWorld.isend(rankY2Z2, mpiTag, particleY2Z2);
-    reqY2Z2[1] = boostWorld.irecv(rankY2Z2, mpiTag, rParticleY2Z2);
-  }
-  // 8 vertices
-  if (rankX1Y1Z1 >= 0) { // edge x1y1z1
-    Box containerX1Y1Z1(v1.x(), v1.y(), v1.z(), v1.x() + cellSize,
-                        v1.y() + cellSize, v1.z() + cellSize);
-    findParticleInBox(containerX1Y1Z1, particleVec, particleX1Y1Z1);
-    reqX1Y1Z1[0] = boostWorld.isend(rankX1Y1Z1, mpiTag, particleX1Y1Z1);
-    reqX1Y1Z1[1] = boostWorld.irecv(rankX1Y1Z1, mpiTag, rParticleX1Y1Z1);
-  }
-  if (rankX1Y1Z2 >= 0) { // edge x1y1z2
-    Box containerX1Y1Z2(v1.x(), v1.y(), v2.z() - cellSize, v1.x() + cellSize,
-                        v1.y() + cellSize, v2.z());
-    findParticleInBox(containerX1Y1Z2, particleVec, particleX1Y1Z2);
-    reqX1Y1Z2[0] = boostWorld.isend(rankX1Y1Z2, mpiTag, particleX1Y1Z2);
-    reqX1Y1Z2[1] = boostWorld.irecv(rankX1Y1Z2, mpiTag, rParticleX1Y1Z2);
-  }
-  if (rankX1Y2Z1 >= 0) { // edge x1y2z1
-    Box containerX1Y2Z1(v1.x(), v2.y() - cellSize, v1.z(), v1.x() + cellSize,
-                        v2.y(), v1.z() + cellSize);
-    findParticleInBox(containerX1Y2Z1, particleVec, particleX1Y2Z1);
-    reqX1Y2Z1[0] = boostWorld.isend(rankX1Y2Z1, mpiTag, particleX1Y2Z1);
-    reqX1Y2Z1[1] = boostWorld.irecv(rankX1Y2Z1, mpiTag, rParticleX1Y2Z1);
-  }
-  if (rankX1Y2Z2 >= 0) { // edge x1y2z2
-    Box containerX1Y2Z2(v1.x(), v2.y() - cellSize, v2.z() - cellSize,
-                        v1.x() + cellSize, v2.y() + cellSize, v2.z());
-    findParticleInBox(containerX1Y2Z2, particleVec, particleX1Y2Z2);
-    reqX1Y2Z2[0] = boostWorld.isend(rankX1Y2Z2, mpiTag, particleX1Y2Z2);
-    reqX1Y2Z2[1] = boostWorld.irecv(rankX1Y2Z2, mpiTag, rParticleX1Y2Z2);
-  }
-  if (rankX2Y1Z1 >= 0) { // edge x2y1z1
-    Box containerX2Y1Z1(v2.x() - cellSize, v1.y(), v1.z(), v2.x(),
-                        v1.y() + cellSize, v1.z() + cellSize);
-    findParticleInBox(containerX2Y1Z1, particleVec, particleX2Y1Z1);
-    reqX2Y1Z1[0] = boostWorld.isend(rankX2Y1Z1, mpiTag, particleX2Y1Z1);
-    reqX2Y1Z1[1] = boostWorld.irecv(rankX2Y1Z1, mpiTag, rParticleX2Y1Z1);
-  }
-  if (rankX2Y1Z2 >= 0) { // edge x2y1z2
-    Box containerX2Y1Z2(v2.x() - cellSize, v1.y(), v2.z() - cellSize, v2.x(),
-                        v1.y() + cellSize, v2.z());
-    findParticleInBox(containerX2Y1Z2, particleVec, particleX2Y1Z2);
-    reqX2Y1Z2[0] = boostWorld.isend(rankX2Y1Z2, mpiTag, particleX2Y1Z2);
-    reqX2Y1Z2[1] = boostWorld.irecv(rankX2Y1Z2, mpiTag, rParticleX2Y1Z2);
-  }
-  if (rankX2Y2Z1 >= 0) { // edge x2y2z1
-    Box containerX2Y2Z1(v2.x() - cellSize, v2.y() - cellSize, v1.z(), v2.x(),
-                        v2.y(), v1.z() + cellSize);
-    findParticleInBox(containerX2Y2Z1, particleVec, particleX2Y2Z1);
-    reqX2Y2Z1[0] = boostWorld.isend(rankX2Y2Z1, mpiTag, particleX2Y2Z1);
-    reqX2Y2Z1[1] = boostWorld.irecv(rankX2Y2Z1, mpiTag, rParticleX2Y2Z1);
-  }
-  if (rankX2Y2Z2 >= 0) { // edge x2y2z2
-    Box containerX2Y2Z2(v2.x() - cellSize, v2.y() - cellSize, v2.z() - cellSize,
-                        v2.x(), v2.y(), v2.z());
-    findParticleInBox(containerX2Y2Z2, particleVec, particleX2Y2Z2);
-    reqX2Y2Z2[0] = boostWorld.isend(rankX2Y2Z2, mpiTag, particleX2Y2Z2);
-    reqX2Y2Z2[1] = boostWorld.irecv(rankX2Y2Z2, mpiTag, rParticleX2Y2Z2);
+
+#ifdef TIME_PROFILE
+  Timer::time_point startComm = Timer::now();
+#endif
+
+  haloSendBuf.resize(26);
+  ParticlePArray foundParticle;
+  for (int k = 0; k < 26; ++k) {
+    haloSendBuf[k].clear();
+    if (ranks[k] < 0)
+      continue;
+    const int* dir = neighborOffsets[k];
+    REAL lo[3], hi[3];
+    for (int d = 0; d < 3; ++d) {
+      REAL c1 = (d == 0) ? v1.x() : ((d == 1) ? v1.y() : v1.z());
+      REAL c2 = (d == 0) ? v2.x() : ((d == 1) ? v2.y() : v2.z());
+      lo[d] = (dir[d] > 0) ? c2 - cellSize : c1;
+      hi[d] = (dir[d] < 0) ? c1 + cellSize : c2;
+    }
+    foundParticle.clear();
+    findParticleInBox(Box(lo[0], lo[1], lo[2], hi[0], hi[1], hi[2]),
+                      particleVec, foundParticle);
+    haloSendBuf[k].resize(foundParticle.size());
+    for (std::size_t i = 0; i < foundParticle.size(); ++i) {
+      foundParticle[i]->packHalo(haloSendBuf[k][i]);
+    }
   }
 
-  // 6 surfaces
-  if (rankX1 >= 0)
-    boost::mpi::wait_all(reqX1, reqX1 + 2);
-  if (rankX2 >= 0)
-    boost::mpi::wait_all(reqX2, reqX2 + 2);
-  if (rankY1 >= 0)
-    boost::mpi::wait_all(reqY1, reqY1 + 2);
-  if (rankY2 >= 0)
-    boost::mpi::wait_all(reqY2, reqY2 + 2);
-  if (rankZ1 >= 0)
-    boost::mpi::wait_all(reqZ1, reqZ1 + 2);
-  if (rankZ2 >= 0)
-    boost::mpi::wait_all(reqZ2, reqZ2 + 2);
-  // 12 edges
-  if (rankX1Y1 >= 0)
-    boost::mpi::wait_all(reqX1Y1, reqX1Y1 + 2);
-  if (rankX1Y2 >= 0)
-    boost::mpi::wait_all(reqX1Y2, reqX1Y2 + 2);
-  if (rankX1Z1 >= 0)
-    boost::mpi::wait_all(reqX1Z1, reqX1Z1 + 2);
-  if (rankX1Z2 >= 0)
-    boost::mpi::wait_all(reqX1Z2, reqX1Z2 + 2);
-  if (rankX2Y1 >= 0)
-    boost::mpi::wait_all(reqX2Y1, reqX2Y1 + 2);
-  if (rankX2Y2 >= 0)
-    boost::mpi::wait_all(reqX2Y2, reqX2Y2 + 2);
-  if (rankX2Z1 >= 0)
-    boost::mpi::wait_all(reqX2Z1, reqX2Z1 + 2);
-  if (rankX2Z2 >= 0)
-    boost::mpi::wait_all(reqX2Z2, reqX2Z2 + 2);
-  if (rankY1Z1 >= 0)
-    boost::mpi::wait_all(reqY1Z1, reqY1Z1 + 2);
-  if (rankY1Z2 >= 0)
-    boost::mpi::wait_all(reqY1Z2, reqY1Z2 + 2);
-  if (rankY2Z1 >= 0)
-    boost::mpi::wait_all(reqY2Z1, reqY2Z1 + 2);
-  if (rankY2Z2 >= 0)
-    boost::mpi::wait_all(reqY2Z2, reqY2Z2 + 2);
-  // 8 vertices
-  if (rankX1Y1Z1 >= 0)
-    boost::mpi::wait_all(reqX1Y1Z1, reqX1Y1Z1 + 2);
-  if (rankX1Y1Z2 >= 0)
-    boost::mpi::wait_all(reqX1Y1Z2, reqX1Y1Z2 + 2);
-  if (rankX1Y2Z1 >= 0)
-    boost::mpi::wait_all(reqX1Y2Z1, reqX1Y2Z1 + 2);
-  if (rankX1Y2Z2 >= 0)
-    boost::mpi::wait_all(reqX1Y2Z2, reqX1Y2Z2 + 2);
-  if (rankX2Y1Z1 >= 0)
-    boost::mpi::wait_all(reqX2Y1Z1, reqX2Y1Z1 + 2);
-  if (rankX2Y1Z2 >= 0)
-    boost::mpi::wait_all(reqX2Y1Z2, reqX2Y1Z2 + 2);
-  if (rankX2Y2Z1 >= 0)
-    boost::mpi::wait_all(reqX2Y2Z1, reqX2Y2Z1 + 2);
-  if (rankX2Y2Z2 >= 0)
-    boost::mpi::wait_all(reqX2Y2Z2, reqX2Y2Z2 + 2);
+  std::size_t bytesSent, bytesRecv;
+  exchangeRecords(mpiWorld, mpiTag, ranks, haloSendBuf, haloRecvBuf,
+                  bytesSent, bytesRecv);
 
   // merge: particles inside container (at front) + particles from neighoring
   // blocks (at end)
   recvParticleVec.clear();
-  // 6 surfaces
-  if (rankX1 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX1.begin(),
-                           rParticleX1.end());
-  if (rankX2 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX2.begin(),
-                           rParticleX2.end());
-  if (rankY1 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleY1.begin(),
-                           rParticleY1.end());
-  if (rankY2 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleY2.begin(),
-                           rParticleY2.end());
-  if (rankZ1 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleZ1.begin(),
-                           rParticleZ1.end());
-  if (rankZ2 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleZ2.begin(),
-                           rParticleZ2.end());
-  // 12 edges
-  if (rankX1Y1 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX1Y1.begin(),
-                           rParticleX1Y1.end());
-  if (rankX1Y2 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX1Y2.begin(),
-                           rParticleX1Y2.end());
-  if (rankX1Z1 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX1Z1.begin(),
-                           rParticleX1Z1.end());
-  if (rankX1Z2 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX1Z2.begin(),
-                           rParticleX1Z2.end());
-  if (rankX2Y1 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX2Y1.begin(),
-                           rParticleX2Y1.end());
-  if (rankX2Y2 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX2Y2.begin(),
-                           rParticleX2Y2.end());
-  if (rankX2Z1 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX2Z1.begin(),
-                           rParticleX2Z1.end());
-  if (rankX2Z2 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX2Z2.begin(),
-                           rParticleX2Z2.end());
-  if (rankY1Z1 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleY1Z1.begin(),
-                           rParticleY1Z1.end());
-  if (rankY1Z2 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleY1Z2.begin(),
-                           rParticleY1Z2.end());
-  if (rankY2Z1 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleY2Z1.begin(),
-                           rParticleY2Z1.end());
-  if (rankY2Z2 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleY2Z2.begin(),
-                           rParticleY2Z2.end());
-  // 8 vertices
-  if (rankX1Y1Z1 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX1Y1Z1.begin(),
-                           rParticleX1Y1Z1.end());
-  if (rankX1Y1Z2 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX1Y1Z2.begin(),
-                           rParticleX1Y1Z2.end());
-  if (rankX1Y2Z1 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX1Y2Z1.begin(),
-                           rParticleX1Y2Z1.end());
-  if (rankX1Y2Z2 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX1Y2Z2.begin(),
-                           rParticleX1Y2Z2.end());
-  if (rankX2Y1Z1 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX2Y1Z1.begin(),
-                           rParticleX2Y1Z1.end());
-  if (rankX2Y1Z2 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX2Y1Z2.begin(),
-                           rParticleX2Y1Z2.end());
-  if (rankX2Y2Z1 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX2Y2Z1.begin(),
-                           rParticleX2Y2Z1.end());
-  if (rankX2Y2Z2 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX2Y2Z2.begin(),
-                           rParticleX2Y2Z2.end());
+  for (int k = 0; k < 26; ++k) {
+    for (const auto& rec : haloRecvBuf[k]) {
+      ParticleP particle = std::make_shared<Particle>();
+      particle->unpackHalo(rec);
+      recvParticleVec.push_back(particle);
+    }
+  }
+
+#ifdef TIME_PROFILE
+  debugInf << std::setw(OWID) << "commuParticle:" << std::setw(OWID)
+           << "bytesSent=" << std::setw(OWID) << bytesSent << std::setw(OWID)
+           << "bytesRecv=" << std::setw(OWID) << bytesRecv << std::setw(OWID)
+           << "time=" << std::setw(OWID)
+           << std::chrono::duration<double>(Timer::now() - startComm).count()
+           << std::endl;
+#endif
 
   mergeParticleVec.clear();
   mergeParticleVec =
     particleVec; // duplicate pointers, pointing to the same memory
   mergeParticleVec.insert(mergeParticleVec.end(), recvParticleVec.begin(),
                           recvParticleVec.end());
-
-  /*
-    ParticlePArray testParticleVec;
-    testParticleVec.insert(testParticleVec.end(), rParticleX1.begin(),
-    rParticleX1.end());
-    testParticleVec.insert(testParticleVec.end(), rParticleX2.begin(),
-    rParticleX2.end());
-    testParticleVec.insert(testParticleVec.end(), rParticleY1.begin(),
-    rParticleY1.end());
-    testParticleVec.insert(testParticleVec.end(), rParticleY2.begin(),
-    rParticleY2.end());
-    testParticleVec.insert(testParticleVec.end(), rParticleZ1.begin(),
-    rParticleZ1.end());
-    testParticleVec.insert(testParticleVec.end(), rParticleZ2.begin(),
-    rParticleZ2.end());
-    debugInf << "iter=" << std::setw(4) << iteration << " rank=" << std::setw(4)
-    << mpiRank
-    << " ptclNum=" << std::setw(4) << particleVec.size()
-    << " surface="
-    << std::setw(4) << particleX1.size()  << std::setw(4) << particleX2.size()
-    << std::setw(4) << particleY1.size()  << std::setw(4) << particleY2.size()
-    << std::setw(4) << particleZ1.size()  << std::setw(4) << particleZ2.size()
-    << " recv="
-    << std::setw(4) << rParticleX1.size() << std::setw(4) << rParticleX2.size()
-    << std::setw(4) << rParticleY1.size() << std::setw(4) << rParticleY2.size()
-    << std::setw(4) << rParticleZ1.size() << std::setw(4) << rParticleZ2.size()
-    << " rNum="
-    << std::setw(4) << recvParticleVec.size() << ": ";
-
-    for (ParticlePArray::const_iterator it = testParticleVec.begin(); it !=
-    testParticleVec.end();++it)
-    debugInf << (*it)->getId() << ' ';
-    debugInf << std::endl;
-    testParticleVec.clear();
-  */
 }
 
 void
@@ -927,20 +698,100 @@ Assembly::findContact()
 { // various implementations
   int ompThreads = util::getParam<int>("ompThreads");
 
-  if (ompThreads == 1) { // non-openmp single-thread version, time complexity
-                         // bigO(n x n), n is the number of particles.
+  if (ompThreads == 1) { // non-openmp single-thread version; cell-binned
+                         // broad phase, time complexity bigO(n)
     int world_rank;
     MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
     std::cout << "\t FindContact: MPI Cart rank = " << mpiRank
               << " World rank = " << world_rank << "\n";
     findContactSingleThread();
-  } else if (ompThreads > 1) { // openmp implementation: various loop scheduling
-                               // - (static), (static,1), (dynamic), (dynamic,1)
+  } else if (ompThreads > 1) { // openmp implementation: per-thread buffers,
+                               // static scheduling
     findContactMultiThread(ompThreads);
 
   } // end of openmp implementation
 }
 
+// Broad phase of the particle contact search (linked cells).
+// The particles in mergeParticleVec are binned into cubic cells whose edge
+// is at least the largest particle diameter, so that two particles whose
+// bounding spheres overlap are in the same or in adjacent cells.  Returns,
+// in the same order as the all-pairs loop, the pairs (i, j), j > i, with i in
+// particleVec, whose bounding spheres overlap and whose types may interact.
+void
+Assembly::findContactCandidates(ContactCandidateArray& candidates,
+                                int ompThreads)
+{
+  candidates.clear();
+
+  std::size_t num1 = particleVec.size();      // particles inside container
+  std::size_t num2 = mergeParticleVec.size(); // particles inside container
+                                              // (at front) + particles from
+                                              // neighboring blocks (at end)
+  if (num1 == 0 || num2 < 2) {
+    return;
+  }
+
+  // Bin the particle centers with the largest particle diameter as the
+  // cell size
+  std::vector<Vec> pos(num2);
+  REAL maxRad = 0;
+  for (std::size_t j = 0; j < num2; ++j) {
+    pos[j] = mergeParticleVec[j]->currentPos();
+    maxRad = std::max(maxRad, mergeParticleVec[j]->getA());
+  }
+  CellBins bins;
+  bins.build(pos, 2 * maxRad);
+
+  // Candidate pairs per thread.  Static scheduling gives each thread a
+  // contiguous range of i, so appending the buffers in thread order keeps
+  // the order of the all-pairs loop.
+  std::vector<ContactCandidateArray> threadCandidates(ompThreads);
+#pragma omp parallel num_threads(ompThreads)
+  {
+    ContactCandidateArray& local = threadCandidates[omp_get_thread_num()];
+    std::vector<std::size_t> neighbors;
+
+#pragma omp for schedule(static)
+    for (long ii = 0; ii < static_cast<long>(num1); ++ii) {
+      std::size_t i = ii;
+      const Vec& u = pos[i];
+      auto particleType = mergeParticleVec[i]->getType();
+      auto particleRad = mergeParticleVec[i]->getA();
+
+      neighbors.clear();
+      bins.forEachNeighbor(u, [i, &neighbors](std::size_t j) {
+        if (j > i) {
+          neighbors.push_back(j);
+        }
+      });
+      std::sort(neighbors.begin(), neighbors.end());
+
+      for (auto j : neighbors) {
+        auto mergeParticleType = mergeParticleVec[j]->getType();
+        if ((vfabs(pos[j] - u) < particleRad + mergeParticleVec[j]->getA()) &&
+            // not both are fixed particles
+            (particleType != 1 || mergeParticleType != 1) &&
+            // not both are free boundary particles
+            (particleType != 5 || mergeParticleType != 5) &&
+            // not both are ghost particles
+            (particleType != 10 || mergeParticleType != 10)) {
+          local.push_back(std::make_pair(i, j));
+        }
+      }
+    }
+  }
+
+  std::size_t numCandidates = 0;
+  for (const auto& local : threadCandidates) {
+    numCandidates += local.size();
+  }
+  candidates.reserve(numCandidates);
+  for (const auto& local : threadCandidates) {
+    candidates.insert(candidates.end(), local.begin(), local.end());
+  }
+}
+
 void
 Assembly::findContactSingleThread()
 {
@@ -948,73 +799,39 @@ Assembly::findContactSingleThread()
   contactVec.clear();
 
 #ifdef TIME_PROFILE
-  Timer::time_point startOuter, endOuter;
-  Timer::time_point startInner, endInner, durationInner = 0;
+  Timer::time_point startOuter, startInner, endOuter;
   startOuter = Timer::now();
 #endif
 
-  auto num1 = particleVec.size();      // particles inside container
-  auto num2 = mergeParticleVec.size(); // particles inside container
-                                       // (at front) + particles from
-                                       // neighboring blocks (at end)
-  // NOT (num1 - 1), in parallel situation where one particle
-  // could contact received particles!
-  for (auto i = 0; i < num1; ++i) {
-
-    auto particle = particleVec[i];
-    Vec u = particle->currentPos();
-    auto particleType = particle->getType();
-    auto particleRad = particle->getA();
-
-    for (auto j = i + 1; j < num2; ++j) {
-
-      auto mergeParticle = mergeParticleVec[j];
-      Vec v = mergeParticle->currentPos();
-      auto mergeParticleType = mergeParticle->getType();
-      auto mergeParticleRad = mergeParticle->getA();
-
-      if ((particle->getId() == 2 && mergeParticle->getId() == 94) ||
-          (particle->getId() == 94 && mergeParticle->getId() == 2)) {
-        int world_rank;
-        MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
-        std::cout << " MPI_Rank = " << world_rank 
-                  << " : particle = (" << particle->getId()
-                  << ", " << particleType
-                  << "), mergeParticle = (" << mergeParticle->getId()
-                  << ", " << mergeParticleType << ")\n";
-      } 
-
-      if ((vfabs(v - u) < particleRad + mergeParticleRad) &&
-          // not both are fixed particles
-          (particleType != 1 || mergeParticleType != 1) &&
-          // not both are free boundary particles
-          (particleType != 5 || mergeParticleType != 5) &&
-          // not both are ghost particles
-          (particleType != 10 || mergeParticleType != 10)) {
-
-        Contact tmpContact(particle.get(), mergeParticle.get());
+  // Broad phase: bounding sphere overlaps, O(n)
+  ContactCandidateArray candidates;
+  findContactCandidates(candidates, 1);
 
 #ifdef TIME_PROFILE
-        startInner = Timer::now();
+  startInner = Timer::now();
 #endif
-        if (tmpContact.isOverlapped()) {
-          contactVec.push_back(tmpContact); // containers use value
-                                            // semantics, so a "copy" is
-                                            // pushed back.
-        }
-#ifdef TIME_PROFILE
-        endInner = Timer::now();
-        durationInner += (endInner - startInner);
-#endif
-      }
+
+  // Narrow phase: overlap of the ellipsoids
+  for (const auto& candidate : candidates) {
+    Contact tmpContact(mergeParticleVec[candidate.first].get(),
+                       mergeParticleVec[candidate.second].get());
+    if (tmpContact.isOverlapped()) {
+      contactVec.push_back(tmpContact); // containers use value
+                                        // semantics, so a "copy" is
+                                        // pushed back.
     }
   }
+
 #ifdef TIME_PROFILE
   endOuter = Timer::now();
   debugInf << std::setw(OWID) << "findContact=" << std::setw(OWID)
-           << std::chrono::duration_cast<Seconds>(endOuter - startOuter).count()
+           << std::chrono::duration<double>(endOuter - startOuter).count()
+           << std::setw(OWID) << "broadPhase=" << std::setw(OWID)
+           << std::chrono::duration<double>(startInner - startOuter).count()
            << std::setw(OWID) << "isOverlapped=" << std::setw(OWID)
-           << std::chrono::duration_cast<Seconds>(durationInner).count();
+           << std::chrono::duration<double>(endOuter - startInner).count()
+           << std::setw(OWID) << "candidates=" << std::setw(OWID)
+           << candidates.size();
 #endif
 }
 
@@ -1025,50 +842,55 @@ Assembly::findContactMultiThread(int ompThreads)
   contactVec.clear();
 
 #ifdef TIME_PROFILE
-  Timer::time_point startOuter, endOuter;
+  Timer::time_point startOuter, startInner, endOuter;
   startOuter = Timer::now();
 #endif
 
-  std::size_t i, j, particleType, mergeParticleType;
-  Vec u, v;
-  auto num1 = particleVec.size();      // particles inside container
-  auto num2 = mergeParticleVec.size(); // particles inside container
-                                       // (at front) + particles from
-                                       // neighboring blocks (at end)
-#pragma omp parallel for num_threads(ompThreads) private(                      \
-  i, j, u, v, particleType, mergeParticleType)                                 \
-    shared(num1, num2) schedule(dynamic)
-  for (i = 0; i < num1; ++i) {
-    u = particleVec[i]->currentPos();
-    particleType = particleVec[i]->getType();
-    for (j = i + 1; j < num2; ++j) {
-      Vec v = mergeParticleVec[j]->currentPos();
-      mergeParticleType = mergeParticleVec[j]->getType();
-      if ((vfabs(v - u) <
-           particleVec[i]->getA() + mergeParticleVec[j]->getA()) &&
-          // not both are fixed particles
-          (particleType != 1 || mergeParticleType != 1) &&
-          // not both are free boundary particles
-          (particleType != 5 || mergeParticleType != 5) &&
-          // not both are ghost particles
-          (particleType != 10 || mergeParticleType != 10)) {
-
-        Contact tmpContact(particleVec[i].get(), mergeParticleVec[j].get());
-
-        if (tmpContact.isOverlapped()) {
-#pragma omp critical
-          contactVec.push_back(tmpContact); // containers use value
-                                            // semantics, so a "copy" is
-                                            // pushed back.
-        }
+  // Broad phase: bounding sphere overlaps, O(n)
+  ContactCandidateArray candidates;
+  findContactCandidates(candidates, ompThreads);
+
+#ifdef TIME_PROFILE
+  startInner = Timer::now();
+#endif
+
+  // Narrow phase: overlap of the ellipsoids.  Each thread keeps its own
+  // contacts; the buffers are appended in thread order afterwards.
+  std::vector<ContactArray> threadContacts(ompThreads);
+  long numCandidates = candidates.size();
+#pragma omp parallel num_threads(ompThreads)
+  {
+    ContactArray& local = threadContacts[omp_get_thread_num()];
+
+#pragma omp for schedule(static)
+    for (long ii = 0; ii < numCandidates; ++ii) {
+      Contact tmpContact(mergeParticleVec[candidates[ii].first].get(),
+                         mergeParticleVec[candidates[ii].second].get());
+      if (tmpContact.isOverlapped()) {
+        local.push_back(tmpContact);
       }
     }
   }
+
+  std::size_t numContacts = 0;
+  for (const auto& local : threadContacts) {
+    numContacts += local.size();
+  }
+  contactVec.reserve(numContacts);
+  for (const auto& local : threadContacts) {
+    contactVec.insert(contactVec.end(), local.begin(), local.end());
+  }
+
 #ifdef TIME_PROFILE
   endOuter = Timer::now();
-  debugInf
-    << std::setw(OWID) << "findContact=" << std::setw(OWID)
-    << std::chrono::duration_cast<Seconds>(endOuter - startOuter).count();
+  debugInf << std::setw(OWID) << "findContact=" << std::setw(OWID)
+           << std::chrono::duration<double>(endOuter - startOuter).count()
+           << std::setw(OWID) << "broadPhase=" << std::setw(OWID)
+           << std::chrono::duration<double>(startInner - startOuter).count()
+           << std::setw(OWID) << "isOverlapped=" << std::setw(OWID)
+           << std::chrono::duration<double>(endOuter - startInner).count()
+           << std::setw(OWID) << "candidates=" << std::setw(OWID)
+           << candidates.size();
 #endif
 }
 
@@ -2142,33 +1964,12 @@ Assembly::commuPeriParticle()
                   v1.y() + vspan.y() / mpiProcY * (mpiCoords[1] + 1),
                   v1.z() + vspan.z() / mpiProcZ * (mpiCoords[2] + 1));
 
-  // if found, communicate with neighboring blocks
-  PeriParticlePArray periParticleX1, periParticleX2;
-  PeriParticlePArray periParticleY1, periParticleY2;
-  PeriParticlePArray periParticleZ1, periParticleZ2;
-  PeriParticlePArray periParticleX1Y1, periParticleX1Y2, periParticleX1Z1,
-    periParticleX1Z2;
-  PeriParticlePArray periParticleX2Y1, periParticleX2Y2, periParticleX2Z1,
-    periParticleX2Z2;
-  PeriParticlePArray periParticleY1Z1, periParticleY1Z2, periParticleY2Z1,
-    periParticleY2Z2;
-  PeriParticlePArray periParticleX1Y1Z1, periParticleX1Y1Z2, periParticleX1Y2Z1,
-    periParticleX1Y2Z2;
-  PeriParticlePArray periParticleX2Y1Z1, periParticleX2Y1Z2, periParticleX2Y2Z1,
-    periParticleX2Y2Z2;
-  boost::mpi::request reqX1[2], reqX2[2];
-  boost::mpi::request reqY1[2], reqY2[2];
-  boost::mpi::request reqZ1[2], reqZ2[2];
-  boost::mpi::request reqX1Y1[2], reqX1Y2[2], reqX1Z1[2], reqX1Z2[2];
-  boost::mpi::request reqX2Y1[2], reqX2Y2[2], reqX2Z1[2], reqX2Z2[2];
-  boost::mpi::request reqY1Z1[2], reqY1Z2[2], reqY2Z1[2], reqY2Z2[2];
-  boost::mpi::request reqX1Y1Z1[2], reqX1Y1Z2[2], reqX1Y2Z1[2], reqX1Y2Z2[2];
-  boost::mpi::request reqX2Y1Z1[2], reqX2Y1Z2[2], reqX2Y2Z1[2], reqX2Y2Z2[2];
+  // if found, communicate with neighboring blocks: peri-points within
+  // cellSize of a face, edge or vertex are sent as fixed-size records
+  std::array<int, 26> ranks;
+  getNeighborRanks(ranks);
   v1 = container.getMinCorner(); // redefine v1, v2 in terms of process
   v2 = container.getMaxCorner();
-  // debugInf << "rank=" << mpiRank << ' ' << v1.x() << ' ' << v1.y() << '
-  // ' << v1.z() << ' '  << v2.x() << ' ' << v2.y() << ' ' << v2.z()
-  // << std::endl;
   REAL cellSize = std::max(4 * maxHorizonSize,
                            gradation.getPtclMaxRadius() +
                              3 * point_interval); // constructNeighbor() is
@@ -2181,346 +1982,70 @@ Assembly::commuPeriParticle()
   // we need to transfer 2*cellSize peri-points, the peri-points in the outer
   // cell are used to calculate the deformationGradient, sigma and Kinv
   // of the peri-points in inner cell
-  // 6 surfaces
-  if (rankX1 >= 0) { // surface x1
-    Box containerX1(v1.x(), v1.y(), v1.z(), v1.x() + cellSize, v2.y(), v2.z());
-    findPeriParticleInBox(containerX1, periParticleVec, periParticleX1);
-    reqX1[0] = boostWorld.isend(rankX1, mpiTag, periParticleX1);
-    reqX1[1] = boostWorld.irecv(rankX1, mpiTag, rperiParticleX1);
-  }
-  if (rankX2 >= 0) { // surface x2
-    Box containerX2(v2.x() - cellSize, v1.y(), v1.z(), v2.x(), v2.y(), v2.z());
-    findPeriParticleInBox(containerX2, periParticleVec, periParticleX2);
-    reqX2[0] = boostWorld.isend(rankX2, mpiTag, periParticleX2);
-    reqX2[1] = boostWorld.irecv(rankX2, mpiTag, rperiParticleX2);
-  }
-  if (rankY1 >= 0) { // surface y1
-    Box containerY1(v1.x(), v1.y(), v1.z(), v2.x(), v1.y() + cellSize, v2.z());
-    findPeriParticleInBox(containerY1, periParticleVec, periParticleY1);
-    reqY1[0] = boostWorld.isend(rankY1, mpiTag, periParticleY1);
-    reqY1[1] = boostWorld.irecv(rankY1, mpiTag, rperiParticleY1);
-  }
-  if (rankY2 >= 0) { // surface y2
-    Box containerY2(v1.x(), v2.y() - cellSize, v1.z(), v2.x(), v2.y(), v2.z());
-    findPeriParticleInBox(containerY2, periParticleVec, periParticleY2);
-    reqY2[0] = boostWorld.isend(rankY2, mpiTag, periParticleY2);
-    reqY2[1] = boostWorld.irecv(rankY2, mpiTag, rperiParticleY2);
-  }
-  if (rankZ1 >= 0) { // surface z1
-    Box containerZ1(v1.x(), v1.y(), v1.z(), v2.x(), v2.y(), v1.z() + cellSize);
-    findPeriParticleInBox(containerZ1, periParticleVec, periParticleZ1);
-    reqZ1[0] = boostWorld.isend(rankZ1, mpiTag, periParticleZ1);
-    reqZ1[1] = boostWorld.irecv(rankZ1, mpiTag, rperiParticleZ1);
-  }
-  if (rankZ2 >= 0) { // surface z2
-    Box containerZ2(v1.x(), v1.y(), v2.z() - cellSize, v2.x(), v2.y(), v2.z());
-    findPeriParticleInBox(containerZ2, periParticleVec, periParticleZ2);
-    reqZ2[0] = boostWorld.isend(rankZ2, mpiTag, periParticleZ2);
-    reqZ2[1] = boostWorld.irecv(rankZ2, mpiTag, rperiParticleZ2);
-  }
-  // 12 edges
-  if (rankX1Y1 >= 0) { // edge x1y1
-    Box containerX1Y1(v1.x(), v1.y(), v1.z(), v1.x() + cellSize,
-                      v1.y() + cellSize, v2.z());
-    findPeriParticleInBox(containerX1Y1, periParticleVec, periParticleX1Y1);
-    reqX1Y1[0] = boostWorld.isend(rankX1Y1, mpiTag, periParticleX1Y1);
-    reqX1Y1[1] = boostWorld.irecv(rankX1Y1, mpiTag, rperiParticleX1Y1);
-  }
-  if (rankX1Y2 >= 0) { // edge x1y2
-    Box containerX1Y2(v1.x(), v2.y() - cellSize, v1.z(), v1.x() + cellSize,
-                      v2.y(), v2.z());
-    findPeriParticleInBox(containerX1Y2, periParticleVec, periParticleX1Y2);
-    reqX1Y2[0] = boostWorld.isend(rankX1Y2, mpiTag, periParticleX1Y2);
-    reqX1Y2[1] = boostWorld.irecv(rankX1Y2, mpiTag, rperiParticleX1Y2);
-  }
-  if (rankX1Z1 >= 0) { // edge x1z1
-    Box containerX1Z1(v1.x(), v1.y(), v1.z(), v1.x() + cellSize, v2.y(),
-                      v1.z() + cellSize);
-    findPeriParticleInBox(containerX1Z1, periParticleVec, periParticleX1Z1);
-    reqX1Z1[0] = boostWorld.isend(rankX1Z1, mpiTag, periParticleX1Z1);
-    reqX1Z1[1] = boostWorld.irecv(rankX1Z1, mpiTag, rperiParticleX1Z1);
-  }
-  if (rankX1Z2 >= 0) { // edge x1z2
-    Box containerX1Z2(v1.x(), v1.y(), v2.z() - cellSize, v1.x() + cellSize,
-                      v2.y(), v2.z());
-    findPeriParticleInBox(containerX1Z2, periParticleVec, periParticleX1Z2);
-    reqX1Z2[0] = boostWorld.isend(rankX1Z2, mpiTag, periParticleX1Z2);
-    reqX1Z2[1] = boostWorld.irecv(rankX1Z2, mpiTag, rperiParticleX1Z2);
-  }
-  if (rankX2Y1 >= 0) { // edge x2y1
-    Box containerX2Y1(v2.x() - cellSize, v1.y(), v1.z(), v2.x(),
-                      v1.y() + cellSize, v2.z());
-    findPeriParticleInBox(containerX2Y1, periParticleVec, periParticleX2Y1);
-    reqX2Y1[0] = boostWorld.isend(rankX2Y1, mpiTag, periParticleX2Y1);
-    reqX2Y1[1] = boostWorld.irecv(rankX2Y1, mpiTag, rperiParticleX2Y1);
-  }
-  if (rankX2Y2 >= 0) { // edge x2y2
-    Box containerX2Y2(v2.x() - cellSize, v2.y() - cellSize, v1.z(), v2.x(),
-                      v2.y(), v2.z());
-    findPeriParticleInBox(containerX2Y2, periParticleVec, periParticleX2Y2);
-    reqX2Y2[0] = boostWorld.isend(rankX2Y2, mpiTag, periParticleX2Y2);
-    reqX2Y2[1] = boostWorld.irecv(rankX2Y2, mpiTag, rperiParticleX2Y2);
-  }
-  if (rankX2Z1 >= 0) { // edge x2z1
-    Box containerX2Z1(v2.x() - cellSize, v1.y(), v1.z(), v2.x(), v2.y(),
-                      v1.z() + cellSize);
-    findPeriParticleInBox(containerX2Z1, periParticleVec, periParticleX2Z1);
-    reqX2Z1[0] = boostWorld.isend(rankX2Z1, mpiTag, periParticleX2Z1);
-    reqX2Z1[1] = boostWorld.irecv(rankX2Z1, mpiTag, rperiParticleX2Z1);
-  }
-  if (rankX2Z2 >= 0) { // edge x2z2
-    Box containerX2Z2(v2.x() - cellSize, v1.y(), v2.z() - cellSize, v2.x(),
-                      v2.y(), v2.z());
-    findPeriParticleInBox(containerX2Z2, periParticleVec, periParticleX2Z2);
-    reqX2Z2[0] = boostWorld.isend(rankX2Z2, mpiTag, periParticleX2Z2);
-    reqX2Z2[1] = boostWorld.irecv(rankX2Z2, mpiTag, rperiParticleX2Z2);
-  }
-  if (rankY1Z1 >= 0) { // edge y1z1
-    Box containerY1Z1(v1.x(), v1.y(), v1.z(), v2.x(), v1.y() + cellSize,
-                      v1.z() + cellSize);
-    findPeriParticleInBox(containerY1Z1, periParticleVec, periParticleY1Z1);
-    reqY1Z1[0] = boostWorld.isend(rankY1Z1, mpiTag, periParticleY1Z1);
-    reqY1Z1[1] = boostWorld.irecv(rankY1Z1, mpiTag, rperiParticleY1Z1);
-  }
-  if (rankY1Z2 >= 0) { // edge y1z2
-    Box containerY1Z2(v1.x(), v1.y(), v2.z() - cellSize, v2.x(),
-                      v1.y() + cellSize, v2.z());
-    findPeriParticleInBox(containerY1Z2, periParticleVec, periParticleY1Z2);
-    reqY1Z2[0] = boostWorld.isend(rankY1Z2, mpiTag, periParticleY1Z2);
-    reqY1Z2[1] = boostWorld.irecv(rankY1Z2, mpiTag, rperiParticleY1Z2);
-  }
-  if (rankY2Z1 >= 0) { // edge y2z1
-    Box containerY2Z1(v1.x(), v2.y() - cellSize, v1.z(), v2.x(), v2.y(),
-                      v1.z() + cellSize);
-    findPeriParticleInBox(containerY2Z1, periParticleVec, periParticleY2Z1);
-    reqY2Z1[0] = boostWorld.isend(rankY2Z1, mpiTag, periParticleY2Z1);
-    reqY2Z1[1] = boostWorld.irecv(rankY2Z1, mpiTag, rperiParticleY2Z1);
-  }
-  if (rankY2Z2 >= 0) { // edge y2z2
-    Box containerY2Z2(v1.x(), v2.y() - cellSize, v2.z() - cellSize, v2.x(),
-                      v2.y(), v2.z());
-    findPeriParticleInBox(containerY2Z2, periParticleVec, periParticleY2Z2);
-    reqY2Z2[0] = boostWorld.isend(rankY2Z2, mpiTag, periParticleY2Z2);
-    reqY2Z2[1] = boostWorld.irecv(rankY2Z2, mpiTag, rperiParticleY2Z2);
-  }
-  // 8 vertices
-  if (rankX1Y1Z1 >= 0) { // edge x1y1z1
-    Box containerX1Y1Z1(v1.x(), v1.y(), v1.z(), v1.x() + cellSize,
-                        v1.y() + cellSize, v1.z() + cellSize);
-    findPeriParticleInBox(containerX1Y1Z1, periParticleVec, periParticleX1Y1Z1);
-    reqX1Y1Z1[0] = boostWorld.isend(rankX1Y1Z1, mpiTag, periParticleX1Y1Z1);
-    reqX1Y1Z1[1] = boostWorld.irecv(rankX1Y1Z1, mpiTag, rperiParticleX1Y1Z1);
-  }
-  if (rankX1Y1Z2 >= 0) { // edge x1y1z2
-    Box containerX1Y1Z2(v1.x(), v1.y(), v2.z() - cellSize, v1.x() + cellSize,
-                        v1.y() + cellSize, v2.z());
-    findPeriParticleInBox(containerX1Y1Z2, periParticleVec, periParticleX1Y1Z2);
-    reqX1Y1Z2[0] = boostWorld.isend(rankX1Y1Z2, mpiTag, periParticleX1Y1Z2);
-    reqX1Y1Z2[1] = boostWorld.irecv(rankX1Y1Z2, mpiTag, rperiParticleX1Y1Z2);
-  }
-  if (rankX1Y2Z1 >= 0) { // edge x1y2z1
-    Box containerX1Y2Z1(v1.x(), v2.y() - cellSize, v1.z(), v1.x() + cellSize,
-                        v2.y(), v1.z() + cellSize);
-    findPeriParticleInBox(containerX1Y2Z1, periParticleVec, periParticleX1Y2Z1);
-    reqX1Y2Z1[0] = boostWorld.isend(rankX1Y2Z1, mpiTag, periParticleX1Y2Z1);
-    reqX1Y2Z1[1] = boostWorld.irecv(rankX1Y2Z1, mpiTag, rperiParticleX1Y2Z1);
-  }
-  if (rankX1Y2Z2 >= 0) { // edge x1y2z2
-    Box containerX1Y2Z2(v1.x(), v2.y() - cellSize, v2.z() - cellSize,
-                        v1.x() + cellSize, v2.y() + cellSize, v2.z());
-    findPeriParticleInBox(containerX1Y2Z2, periParticleVec, periParticleX1Y2Z2);
-    reqX1Y2Z2[0] = boostWorld.isend(rankX1Y2Z2, mpiTag, periParticleX1Y2Z2);
-    reqX1Y2Z2[1] = boostWorld.irecv(rankX1Y2Z2, mpiTag, rperiParticleX1Y2Z2);
-  }
-  if (rankX2Y1Z1 >= 0) { // edge x2y1z1
-    Box containerX2Y1Z1(v2.x() - cellSize, v1.y(), v1.z(), v2.x(),
-                        v1.y() + cellSize, v1.z() + cellSize);
-    findPeriParticleInBox(containerX2Y1Z1, periParticleVec, periParticleX2Y1Z1);
-    reqX2Y1Z1[0] = boostWorld.isend(rankX2Y1Z1, mpiTag, periParticleX2Y1Z1);
-    reqX2Y1Z1[1] = boostWorld.irecv(rankX2Y1Z1, mpiTag, rperiParticleX2Y1Z1);
-  }
-  if (rankX2Y1Z2 >= 0) { // edge x2y1z2
-    Box containerX2Y1Z2(v2.x() - cellSize, v1.y(), v2.z() - cellSize, v2.x(),
-                        v1.y() + cellSize, v2.z());
-    findPeriParticleInBox(containerX2Y1Z2, periParticleVec, periParticleX2Y1Z2);
-    reqX2Y1Z2[0] = boostWorld.isend(rankX2Y1Z2, mpiTag, periParticleX2Y1Z2);
-    reqX2Y1Z2[1] = boostWorld.irecv(rankX2Y1Z2, mpiTag, rperiParticleX2Y1Z2);
-  }
-  if (rankX2Y2Z1 >= 0) { // edge x2y2z1
-    Box containerX2Y2Z1(v2.x() - cellSize, v2.y() - cellSize, v1.z(), v2.x(),
-                        v2.y(), v1.z() + cellSize);
-    findPeriParticleInBox(containerX2Y2Z1, periParticleVec, periParticleX2Y2Z1);
-    reqX2Y2Z1[0] = boostWorld.isend(rankX2Y2Z1, mpiTag, periParticleX2Y2Z1);
-    reqX2Y2Z1[1] = boostWorld.irecv(rankX2Y2Z1, mpiTag, rperiParticleX2Y2Z1);
-  }
-  if (rankX2Y2Z2 >= 0) { // edge x2y2z2
-    Box containerX2Y2Z2(v2.x() - cellSize, v2.y() - cellSize, v2.z() - cellSize,
-                        v2.x(), v2.y(), v2.z());
-    findPeriParticleInBox(containerX2Y2Z2, periParticleVec, periParticleX2Y2Z2);
-    reqX2Y2Z2[0] = boostWorld.isend(rankX2Y2Z2, mpiTag, periParticleX2Y2Z2);
-    reqX2Y2Z2[1] = boostWorld.irecv(rankX2Y2Z2, mpiTag, rperiParticleX2Y2Z2);
+
+#ifdef TIME_PROFILE
+  Timer::time_point startComm = Timer::now();
+#endif
+
+  periHaloSendBuf.resize(26);
+  periBondedSendBuf.resize(26);
+  PeriParticlePArray foundPeriParticle;
+  for (int k = 0; k < 26; ++k) {
+    periHaloSendBuf[k].clear();
+    periBondedSendBuf[k].clear();
+    if (ranks[k] < 0)
+      continue;
+    const int* dir = neighborOffsets[k];
+    REAL lo[3], hi[3];
+    for (int d = 0; d < 3; ++d) {
+      REAL c1 = (d == 0) ? v1.x() : ((d == 1) ? v1.y() : v1.z());
+      REAL c2 = (d == 0) ? v2.x() : ((d == 1) ? v2.y() : v2.z());
+      lo[d] = (dir[d] > 0) ? c2 - cellSize : c1;
+      hi[d] = (dir[d] < 0) ? c1 + cellSize : c2;
+    }
+    foundPeriParticle.clear();
+    findPeriParticleInBox(Box(lo[0], lo[1], lo[2], hi[0], hi[1], hi[2]),
+                          periParticleVec, foundPeriParticle);
+    periHaloSendBuf[k].resize(foundPeriParticle.size());
+    for (std::size_t i = 0; i < foundPeriParticle.size(); ++i) {
+      foundPeriParticle[i]->packHalo(periHaloSendBuf[k][i],
+                                     periBondedSendBuf[k]);
+    }
   }
 
-  // 6 surfaces
-  if (rankX1 >= 0)
-    boost::mpi::wait_all(reqX1, reqX1 + 2);
-  if (rankX2 >= 0)
-    boost::mpi::wait_all(reqX2, reqX2 + 2);
-  if (rankY1 >= 0)
-    boost::mpi::wait_all(reqY1, reqY1 + 2);
-  if (rankY2 >= 0)
-    boost::mpi::wait_all(reqY2, reqY2 + 2);
-  if (rankZ1 >= 0)
-    boost::mpi::wait_all(reqZ1, reqZ1 + 2);
-  if (rankZ2 >= 0)
-    boost::mpi::wait_all(reqZ2, reqZ2 + 2);
-  // 12 edges
-  if (rankX1Y1 >= 0)
-    boost::mpi::wait_all(reqX1Y1, reqX1Y1 + 2);
-  if (rankX1Y2 >= 0)
-    boost::mpi::wait_all(reqX1Y2, reqX1Y2 + 2);
-  if (rankX1Z1 >= 0)
-    boost::mpi::wait_all(reqX1Z1, reqX1Z1 + 2);
-  if (rankX1Z2 >= 0)
-    boost::mpi::wait_all(reqX1Z2, reqX1Z2 + 2);
-  if (rankX2Y1 >= 0)
-    boost::mpi::wait_all(reqX2Y1, reqX2Y1 + 2);
-  if (rankX2Y2 >= 0)
-    boost::mpi::wait_all(reqX2Y2, reqX2Y2 + 2);
-  if (rankX2Z1 >= 0)
-    boost::mpi::wait_all(reqX2Z1, reqX2Z1 + 2);
-  if (rankX2Z2 >= 0)
-    boost::mpi::wait_all(reqX2Z2, reqX2Z2 + 2);
-  if (rankY1Z1 >= 0)
-    boost::mpi::wait_all(reqY1Z1, reqY1Z1 + 2);
-  if (rankY1Z2 >= 0)
-    boost::mpi::wait_all(reqY1Z2, reqY1Z2 + 2);
-  if (rankY2Z1 >= 0)
-    boost::mpi::wait_all(reqY2Z1, reqY2Z1 + 2);
-  if (rankY2Z2 >= 0)
-    boost::mpi::wait_all(reqY2Z2, reqY2Z2 + 2);
-  // 8 vertices
-  if (rankX1Y1Z1 >= 0)
-    boost::mpi::wait_all(reqX1Y1Z1, reqX1Y1Z1 + 2);
-  if (rankX1Y1Z2 >= 0)
-    boost::mpi::wait_all(reqX1Y1Z2, reqX1Y1Z2 + 2);
-  if (rankX1Y2Z1 >= 0)
-    boost::mpi::wait_all(reqX1Y2Z1, reqX1Y2Z1 + 2);
-  if (rankX1Y2Z2 >= 0)
-    boost::mpi::wait_all(reqX1Y2Z2, reqX1Y2Z2 + 2);
-  if (rankX2Y1Z1 >= 0)
-    boost::mpi::wait_all(reqX2Y1Z1, reqX2Y1Z1 + 2);
-  if (rankX2Y1Z2 >= 0)
-    boost::mpi::wait_all(reqX2Y1Z2, reqX2Y1Z2 + 2);
-  if (rankX2Y2Z1 >= 0)
-    boost::mpi::wait_all(reqX2Y2Z1, reqX2Y2Z1 + 2);
-  if (rankX2Y2Z2 >= 0)
-    boost::mpi::wait_all(reqX2Y2Z2, reqX2Y2Z2 + 2);
+  // the bonded DEM IDs go in a second exchange on the same tags; MPI keeps
+  // the order of messages between a pair of processes on one tag, so they
+  // cannot be matched with the records
+  std::size_t bytesSent, bytesRecv, idBytesSent, idBytesRecv;
+  exchangeRecords(mpiWorld, mpiTag, ranks, periHaloSendBuf, periHaloRecvBuf,
+                  bytesSent, bytesRecv);
+  exchangeRecords(mpiWorld, mpiTag, ranks, periBondedSendBuf,
+                  periBondedRecvBuf, idBytesSent, idBytesRecv);
+  bytesSent += idBytesSent;
+  bytesRecv += idBytesRecv;
 
   // merge: periParticles inside container (at front) + periParticles from
   // neighoring blocks (at end)
   recvPeriParticleVec.clear();
-  // 6 surfaces
-  if (rankX1 >= 0)
-    recvPeriParticleVec.insert(recvPeriParticleVec.end(),
-                               rperiParticleX1.begin(), rperiParticleX1.end());
-  if (rankX2 >= 0)
-    recvPeriParticleVec.insert(recvPeriParticleVec.end(),
-                               rperiParticleX2.begin(), rperiParticleX2.end());
-  if (rankY1 >= 0)
-    recvPeriParticleVec.insert(recvPeriParticleVec.end(),
-                               rperiParticleY1.begin(), rperiParticleY1.end());
-  if (rankY2 >= 0)
-    recvPeriParticleVec.insert(recvPeriParticleVec.end(),
-                               rperiParticleY2.begin(), rperiParticleY2.end());
-  if (rankZ1 >= 0)
-    recvPeriParticleVec.insert(recvPeriParticleVec.end(),
-                               rperiParticleZ1.begin(), rperiParticleZ1.end());
-  if (rankZ2 >= 0)
-    recvPeriParticleVec.insert(recvPeriParticleVec.end(),
-                               rperiParticleZ2.begin(), rperiParticleZ2.end());
-  // 12 edges
-  if (rankX1Y1 >= 0)
-    recvPeriParticleVec.insert(recvPeriParticleVec.end(),
-                               rperiParticleX1Y1.begin(),
-                               rperiParticleX1Y1.end());
-  if (rankX1Y2 >= 0)
-    recvPeriParticleVec.insert(recvPeriParticleVec.end(),
-                               rperiParticleX1Y2.begin(),
-                               rperiParticleX1Y2.end());
-  if (rankX1Z1 >= 0)
-    recvPeriParticleVec.insert(recvPeriParticleVec.end(),
-                               rperiParticleX1Z1.begin(),
-                               rperiParticleX1Z1.end());
-  if (rankX1Z2 >= 0)
-    recvPeriParticleVec.insert(recvPeriParticleVec.end(),
-                               rperiParticleX1Z2.begin(),
-                               rperiParticleX1Z2.end());
-  if (rankX2Y1 >= 0)
-    recvPeriParticleVec.insert(recvPeriParticleVec.end(),
-                               rperiParticleX2Y1.begin(),
-                               rperiParticleX2Y1.end());
-  if (rankX2Y2 >= 0)
-    recvPeriParticleVec.insert(recvPeriParticleVec.end(),
-                               rperiParticleX2Y2.begin(),
-                               rperiParticleX2Y2.end());
-  if (rankX2Z1 >= 0)
-    recvPeriParticleVec.insert(recvPeriParticleVec.end(),
-                               rperiParticleX2Z1.begin(),
-                               rperiParticleX2Z1.end());
-  if (rankX2Z2 >= 0)
-    recvPeriParticleVec.insert(recvPeriParticleVec.end(),
-                               rperiParticleX2Z2.begin(),
-                               rperiParticleX2Z2.end());
-  if (rankY1Z1 >= 0)
-    recvPeriParticleVec.insert(recvPeriParticleVec.end(),
-                               rperiParticleY1Z1.begin(),
-                               rperiParticleY1Z1.end());
-  if (rankY1Z2 >= 0)
-    recvPeriParticleVec.insert(recvPeriParticleVec.end(),
-                               rperiParticleY1Z2.begin(),
-                               rperiParticleY1Z2.end());
-  if (rankY2Z1 >= 0)
-    recvPeriParticleVec.insert(recvPeriParticleVec.end(),
-                               rperiParticleY2Z1.begin(),
-                               rperiParticleY2Z1.end());
-  if (rankY2Z2 >= 0)
-    recvPeriParticleVec.insert(recvPeriParticleVec.end(),
-                               rperiParticleY2Z2.begin(),
-                               rperiParticleY2Z2.end());
-  // 8 vertices
-  if (rankX1Y1Z1 >= 0)
-    recvPeriParticleVec.insert(recvPeriParticleVec.end(),
-                               rperiParticleX1Y1Z1.begin(),
-                               rperiParticleX1Y1Z1.end());
-  if (rankX1Y1Z2 >= 0)
-    recvPeriParticleVec.insert(recvPeriParticleVec.end(),
-                               rperiParticleX1Y1Z2.begin(),
-                               rperiParticleX1Y1Z2.end());
-  if (rankX1Y2Z1 >= 0)
-    recvPeriParticleVec.insert(recvPeriParticleVec.end(),
-                               rperiParticleX1Y2Z1.begin(),
-                               rperiParticleX1Y2Z1.end());
-  if (rankX1Y2Z2 >= 0)
-    recvPeriParticleVec.insert(recvPeriParticleVec.end(),
-                               rperiParticleX1Y2Z2.begin(),
-                               rperiParticleX1Y2Z2.end());
-  if (rankX2Y1Z1 >= 0)
-    recvPeriParticleVec.insert(recvPeriParticleVec.end(),
-                               rperiParticleX2Y1Z1.begin(),
-                               rperiParticleX2Y1Z1.end());
-  if (rankX2Y1Z2 >= 0)
-    recvPeriParticleVec.insert(recvPeriParticleVec.end(),
-                               rperiParticleX2Y1Z2.begin(),
-                               rperiParticleX2Y1Z2.end());
-  if (rankX2Y2Z1 >= 0)
-    recvPeriParticleVec.insert(recvPeriParticleVec.end(),
-                               rperiParticleX2Y2Z1.begin(),
-                               rperiParticleX2Y2Z1.end());
-  if (rankX2Y2Z2 >= 0)
-    recvPeriParticleVec.insert(recvPeriParticleVec.end(),
-                               rperiParticleX2Y2Z2.begin(),
-                               rperiParticleX2Y2Z2.end());
+  for (int k = 0; k < 26; ++k) {
+    const int* bondedDEMIds = periBondedRecvBuf[k].data();
+    for (const auto& rec : periHaloRecvBuf[k]) {
+      PeriParticleP periParticle =
+        std::make_shared<periDynamics::PeriParticle>();
+      periParticle->unpackHalo(rec, bondedDEMIds);
+      bondedDEMIds += rec.numBondedDEM;
+      recvPeriParticleVec.push_back(periParticle);
+    }
+  }
+
+#ifdef TIME_PROFILE
+  debugInf << std::setw(OWID) << "commuPeriParticle:" << std::setw(OWID)
+           << "bytesSent=" << std::setw(OWID) << bytesSent << std::setw(OWID)
+           << "bytesRecv=" << std::setw(OWID) << bytesRecv << std::setw(OWID)
+           << "time=" << std::setw(OWID)
+           << std::chrono::duration<double>(Timer::now() - startComm).count()
+           << std::endl;
+#endif
 
   mergePeriParticleVec.clear();
   mergePeriParticleVec =
@@ -2528,41 +2053,6 @@ Assembly::commuPeriParticle()
   mergePeriParticleVec.insert(mergePeriParticleVec.end(),
                               recvPeriParticleVec.begin(),
                               recvPeriParticleVec.end());
-
-  /*
-    ParticlePArray testParticleVec;
-    testParticleVec.insert(testParticleVec.end(), rParticleX1.begin(),
-    rParticleX1.end());
-    testParticleVec.insert(testParticleVec.end(), rParticleX2.begin(),
-    rParticleX2.end());
-    testParticleVec.insert(testParticleVec.end(), rParticleY1.begin(),
-    rParticleY1.end());
-    testParticleVec.insert(testParticleVec.end(), rParticleY2.begin(),
-    rParticleY2.end());
-    testParticleVec.insert(testParticleVec.end(), rParticleZ1.begin(),
-    rParticleZ1.end());
-    testParticleVec.insert(testParticleVec.end(), rParticleZ2.begin(),
-    rParticleZ2.end());
-    debugInf << "iter=" << std::setw(4) << iteration << " rank=" << std::setw(4)
-    << mpiRank
-    << " ptclNum=" << std::setw(4) << particleVec.size()
-    << " surface="
-    << std::setw(4) << particleX1.size()  << std::setw(4) << particleX2.size()
-    << std::setw(4) << particleY1.size()  << std::setw(4) << particleY2.size()
-    << std::setw(4) << particleZ1.size()  << std::setw(4) << particleZ2.size()
-    << " recv="
-    << std::setw(4) << rParticleX1.size() << std::setw(4) << rParticleX2.size()
-    << std::setw(4) << rParticleY1.size() << std::setw(4) << rParticleY2.size()
-    << std::setw(4) << rParticleZ1.size() << std::setw(4) << rParticleZ2.size()
-    << " rNum="
-    << std::setw(4) << recvParticleVec.size() << ": ";
-
-    for (ParticlePArray::const_iterator it = testParticleVec.begin(); it !=
-    testParticleVec.end();++it)
-    debugInf << (*it)->getId() << ' ';
-    debugInf << std::endl;
-    testParticleVec.clear();
-  */
 }
 
 void
@@ -2575,35 +2065,6 @@ Assembly::releaseRecvParticle()
     delete (*it);
   */
   recvParticleVec.clear();
-  // 6 surfaces
-  rParticleX1.clear();
-  rParticleX2.clear();
-  rParticleY1.clear();
-  rParticleY2.clear();
-  rParticleZ1.clear();
-  rParticleZ2.clear();
-  // 12 edges
-  rParticleX1Y1.clear();
-  rParticleX1Y2.clear();
-  rParticleX1Z1.clear();
-  rParticleX1Z2.clear();
-  rParticleX2Y1.clear();
-  rParticleX2Y2.clear();
-  rParticleX2Z1.clear();
-  rParticleX2Z2.clear();
-  rParticleY1Z1.clear();
-  rParticleY1Z2.clear();
-  rParticleY2Z1.clear();
-  rParticleY2Z2.clear();
-  // 8 vertices
-  rParticleX1Y1Z1.clear();
-  rParticleX1Y1Z2.clear();
-  rParticleX1Y2Z1.clear();
-  rParticleX1Y2Z2.clear();
-  rParticleX2Y1Z1.clear();
-  rParticleX2Y1Z2.clear();
-  rParticleX2Y2Z1.clear();
-  rParticleX2Y2Z2.clear();
 }
 
 void
@@ -2622,451 +2083,141 @@ Assembly::releaseRecvPeriParticle()
 
   // release memory of received particles
   // for (auto it = recvPeriParticleVec.begin(); it !=
-  // recvPeriParticleVec.end(); ++it){
-  //  delete (*it);
-  //}
-  recvPeriParticleVec.clear();
-  PeriParticlePArray().swap(recvPeriParticleVec); // actual memory release
-  // 6 surfaces
-  rperiParticleX1.clear();
-  rperiParticleX2.clear();
-  rperiParticleY1.clear();
-  rperiParticleY2.clear();
-  rperiParticleZ1.clear();
-  rperiParticleZ2.clear();
-  // 12 edges
-  rperiParticleX1Y1.clear();
-  rperiParticleX1Y2.clear();
-  rperiParticleX1Z1.clear();
-  rperiParticleX1Z2.clear();
-  rperiParticleX2Y1.clear();
-  rperiParticleX2Y2.clear();
-  rperiParticleX2Z1.clear();
-  rperiParticleX2Z2.clear();
-  rperiParticleY1Z1.clear();
-  rperiParticleY1Z2.clear();
-  rperiParticleY2Z1.clear();
-  rperiParticleY2Z2.clear();
-  // 8 vertices
-  rperiParticleX1Y1Z1.clear();
-  rperiParticleX1Y1Z2.clear();
-  rperiParticleX1Y2Z1.clear();
-  rperiParticleX1Y2Z2.clear();
-  rperiParticleX2Y1Z1.clear();
-  rperiParticleX2Y1Z2.clear();
-  rperiParticleX2Y2Z1.clear();
-  rperiParticleX2Y2Z2.clear();
-}
-
-void
-Assembly::releasePeriBondVec()
-{
-  // for(auto pt=periBondVec.begin(); pt!=periBondVec.end(); pt++){
-  //  delete (*pt);
-  //}
-  periBondVec.clear();
-  PeriBondPArray().swap(periBondVec); // actual memory release
-}
-
-void
-Assembly::updatePeriGrid()
-{
-  PeriParticlePArray::const_iterator pit = periParticleVec.begin();
-  REAL pMaxX = (*pit)->currentPosition().x();
-  REAL pMinX = (*pit)->currentPosition().x();
-  REAL pMaxY = (*pit)->currentPosition().y();
-  REAL pMinY = (*pit)->currentPosition().y();
-  REAL pMaxZ = (*pit)->currentPosition().z();
-  REAL pMinZ = (*pit)->currentPosition().z();
-
-  REAL tmpx, tmpy, tmpz;
-  dem::Vec tmp_xyz;
-  for (pit = periParticleVec.begin(); pit != periParticleVec.end(); pit++) {
-    tmp_xyz = (*pit)->currentPosition();
-    tmpx = tmp_xyz.x();
-    tmpy = tmp_xyz.y();
-    tmpz = tmp_xyz.z();
-    if (pMaxX < tmpx)
-      pMaxX = tmpx;
-    if (pMinX > tmpx)
-      pMinX = tmpx;
-    if (pMaxY < tmpy)
-      pMaxY = tmpy;
-    if (pMinY > tmpy)
-      pMinY = tmpy;
-    if (pMaxZ < tmpz)
-      pMaxZ = tmpz;
-    if (pMinZ > tmpz)
-      pMinZ = tmpz;
-  }
-  REAL maxX = 0;
-  REAL maxY = 0;
-  REAL maxZ = 0;
-  REAL minX = 0;
-  REAL minY = 0;
-  REAL minZ = 0;
-  MPI_Allreduce(&pMaxX, &maxX, 1, MPI_DOUBLE, MPI_MAX, mpiWorld);
-  MPI_Allreduce(&pMinX, &minX, 1, MPI_DOUBLE, MPI_MIN, mpiWorld);
-  MPI_Allreduce(&pMaxY, &maxY, 1, MPI_DOUBLE, MPI_MAX, mpiWorld);
-  MPI_Allreduce(&pMinY, &minY, 1, MPI_DOUBLE, MPI_MIN, mpiWorld);
-  MPI_Allreduce(&pMaxZ, &maxZ, 1, MPI_DOUBLE, MPI_MAX, mpiWorld);
-  MPI_Allreduce(&pMinZ, &minZ, 1, MPI_DOUBLE, MPI_MIN, mpiWorld);
-
-  // no need to broadcast grid as it is updated in each process
-  setGrid(Box(minX - point_interval * 0.2, minY - point_interval * 0.2,
-              minZ - point_interval * 0.2, maxX + point_interval * 0.2,
-              maxY + point_interval * 0.2, maxZ + point_interval * 0.2));
-}
-
-void
-Assembly::migrateParticle()
-{
-  Vec vspan = grid.getMaxCorner() - grid.getMinCorner();
-  REAL segX = vspan.x() / mpiProcX;
-  REAL segY = vspan.y() / mpiProcY;
-  REAL segZ = vspan.z() / mpiProcZ;
-  Vec v1 = container.getMinCorner(); // v1, v2 in terms of process
-  Vec v2 = container.getMaxCorner();
-
-  // if a neighbor exists, transfer particles crossing the boundary in between.
-  ParticlePArray particleX1, particleX2;
-  ParticlePArray particleY1, particleY2;
-  ParticlePArray particleZ1, particleZ2;
-  ParticlePArray particleX1Y1, particleX1Y2, particleX1Z1, particleX1Z2;
-  ParticlePArray particleX2Y1, particleX2Y2, particleX2Z1, particleX2Z2;
-  ParticlePArray particleY1Z1, particleY1Z2, particleY2Z1, particleY2Z2;
-  ParticlePArray particleX1Y1Z1, particleX1Y1Z2, particleX1Y2Z1, particleX1Y2Z2;
-  ParticlePArray particleX2Y1Z1, particleX2Y1Z2, particleX2Y2Z1, particleX2Y2Z2;
-  boost::mpi::request reqX1[2], reqX2[2];
-  boost::mpi::request reqY1[2], reqY2[2];
-  boost::mpi::request reqZ1[2], reqZ2[2];
-  boost::mpi::request reqX1Y1[2], reqX1Y2[2], reqX1Z1[2], reqX1Z2[2];
-  boost::mpi::request reqX2Y1[2], reqX2Y2[2], reqX2Z1[2], reqX2Z2[2];
-  boost::mpi::request reqY1Z1[2], reqY1Z2[2], reqY2Z1[2], reqY2Z2[2];
-  boost::mpi::request reqX1Y1Z1[2], reqX1Y1Z2[2], reqX1Y2Z1[2], reqX1Y2Z2[2];
-  boost::mpi::request reqX2Y1Z1[2], reqX2Y1Z2[2], reqX2Y2Z1[2], reqX2Y2Z2[2];
-
-  // 6 surfaces
-  if (rankX1 >= 0) { // surface x1
-    Box containerX1(v1.x() - segX, v1.y(), v1.z(), v1.x(), v2.y(), v2.z());
-    findParticleInBox(containerX1, particleVec, particleX1);
-    reqX1[0] = boostWorld.isend(rankX1, mpiTag, particleX1);
-    reqX1[1] = boostWorld.irecv(rankX1, mpiTag, rParticleX1);
-  }
-  if (rankX2 >= 0) { // surface x2
-    Box containerX2(v2.x(), v1.y(), v1.z(), v2.x() + segX, v2.y(), v2.z());
-    findParticleInBox(containerX2, particleVec, particleX2);
-    reqX2[0] = boostWorld.isend(rankX2, mpiTag, particleX2);
-    reqX2[1] = boostWorld.irecv(rankX2, mpiTag, rParticleX2);
-  }
-  if (rankY1 >= 0) { // surface y1
-    Box containerY1(v1.x(), v1.y() - segY, v1.z(), v2.x(), v1.y(), v2.z());
-    findParticleInBox(containerY1, particleVec, particleY1);
-    reqY1[0] = boostWorld.isend(rankY1, mpiTag, particleY1);
-    reqY1[1] = boostWorld.irecv(rankY1, mpiTag, rParticleY1);
-  }
-  if (rankY2 >= 0) { // surface y2
-    Box containerY2(v1.x(), v2.y(), v1.z(), v2.x(), v2.y() + segY, v2.z());
-    findParticleInBox(containerY2, particleVec, particleY2);
-    reqY2[0] = boostWorld.isend(rankY2, mpiTag, particleY2);
-    reqY2[1] = boostWorld.irecv(rankY2, mpiTag, rParticleY2);
-  }
-  if (rankZ1 >= 0) { // surface z1
-    Box containerZ1(v1.x(), v1.y(), v1.z() - segZ, v2.x(), v2.y(), v1.z());
-    findParticleInBox(containerZ1, particleVec, particleZ1);
-    reqZ1[0] = boostWorld.isend(rankZ1, mpiTag, particleZ1);
-    reqZ1[1] = boostWorld.irecv(rankZ1, mpiTag, rParticleZ1);
-  }
-  if (rankZ2 >= 0) { // surface z2
-    Box containerZ2(v1.x(), v1.y(), v2.z(), v2.x(), v2.y(), v2.z() + segZ);
-    findParticleInBox(containerZ2, particleVec, particleZ2);
-    reqZ2[0] = boostWorld.isend(rankZ2, mpiTag, particleZ2);
-    reqZ2[1] = boostWorld.irecv(rankZ2, mpiTag, rParticleZ2);
-  }
-  // 12 edges
-  if (rankX1Y1 >= 0) { // edge x1y1
-    Box containerX1Y1(v1.x() - segX, v1.y() - segY, v1.z(), v1.x(), v1.y(),
-                      v2.z());
-    findParticleInBox(containerX1Y1, particleVec, particleX1Y1);
-    reqX1Y1[0] = boostWorld.isend(rankX1Y1, mpiTag, particleX1Y1);
-    reqX1Y1[1] = boostWorld.irecv(rankX1Y1, mpiTag, rParticleX1Y1);
-  }
-  if (rankX1Y2 >= 0) { // edge x1y2
-    Box containerX1Y2(v1.x() - segX, v2.y(), v1.z(), v1.x(), v2.y() + segY,
-                      v2.z());
-    findParticleInBox(containerX1Y2, particleVec, particleX1Y2);
-    reqX1Y2[0] = boostWorld.isend(rankX1Y2, mpiTag, particleX1Y2);
-    reqX1Y2[1] = boostWorld.irecv(rankX1Y2, mpiTag, rParticleX1Y2);
-  }
-  if (rankX1Z1 >= 0) { // edge x1z1
-    Box containerX1Z1(v1.x() - segX, v1.y(), v1.z() - segZ, v1.x(), v2.y(),
-                      v1.z());
-    findParticleInBox(containerX1Z1, particleVec, particleX1Z1);
-    reqX1Z1[0] = boostWorld.isend(rankX1Z1, mpiTag, particleX1Z1);
-    reqX1Z1[1] = boostWorld.irecv(rankX1Z1, mpiTag, rParticleX1Z1);
-  }
-  if (rankX1Z2 >= 0) { // edge x1z2
-    Box containerX1Z2(v1.x() - segX, v1.y(), v2.z(), v1.x(), v2.y(),
-                      v2.z() + segZ);
-    findParticleInBox(containerX1Z2, particleVec, particleX1Z2);
-    reqX1Z2[0] = boostWorld.isend(rankX1Z2, mpiTag, particleX1Z2);
-    reqX1Z2[1] = boostWorld.irecv(rankX1Z2, mpiTag, rParticleX1Z2);
-  }
-  if (rankX2Y1 >= 0) { // edge x2y1
-    Box containerX2Y1(v2.x(), v1.y() - segY, v1.z(), v2.x() + segX, v1.y(),
-                      v2.z());
-    findParticleInBox(containerX2Y1, particleVec, particleX2Y1);
-    reqX2Y1[0] = boostWorld.isend(rankX2Y1, mpiTag, particleX2Y1);
-    reqX2Y1[1] = boostWorld.irecv(rankX2Y1, mpiTag, rParticleX2Y1);
-  }
-  if (rankX2Y2 >= 0) { // edge x2y2
-    Box containerX2Y2(v2.x(), v2.y(), v1.z(), v2.x() + segX, v2.y() + segY,
-                      v2.z());
-    findParticleInBox(containerX2Y2, particleVec, particleX2Y2);
-    reqX2Y2[0] = boostWorld.isend(rankX2Y2, mpiTag, particleX2Y2);
-    reqX2Y2[1] = boostWorld.irecv(rankX2Y2, mpiTag, rParticleX2Y2);
-  }
-  if (rankX2Z1 >= 0) { // edge x2z1
-    Box containerX2Z1(v2.x(), v1.y(), v1.z() - segZ, v2.x() + segX, v2.y(),
-                      v1.z());
-    findParticleInBox(containerX2Z1, particleVec, particleX2Z1);
-    reqX2Z1[0] = boostWorld.isend(rankX2Z1, mpiTag, particleX2Z1);
-    reqX2Z1[1] = boostWorld.irecv(rankX2Z1, mpiTag, rParticleX2Z1);
-  }
-  if (rankX2Z2 >= 0) { // edge x2z2
-    Box containerX2Z2(v2.x(), v1.y(), v2.z(), v2.x() + segX, v2.y(),
-                      v2.z() + segZ);
-    findParticleInBox(containerX2Z2, particleVec, particleX2Z2);
-    reqX2Z2[0] = boostWorld.isend(rankX2Z2, mpiTag, particleX2Z2);
-    reqX2Z2[1] = boostWorld.irecv(rankX2Z2, mpiTag, rParticleX2Z2);
-  }
-  if (rankY1Z1 >= 0) { // edge y1z1
-    Box containerY1Z1(v1.x(), v1.y() - segY, v1.z() - segZ, v2.x(), v1.y(),
-                      v1.z());
-    findParticleInBox(containerY1Z1, particleVec, particleY1Z1);
-    reqY1Z1[0] = boostWorld.isend(rankY1Z1, mpiTag, particleY1Z1);
-    reqY1Z1[1] = boostWorld.irecv(rankY1Z1, mpiTag, rParticleY1Z1);
-  }
-  if (rankY1Z2 >= 0) { // edge y1z2
-    Box containerY1Z2(v1.x(), v1.y() - segY, v2.z(), v2.x(), v1.y(),
-                      v2.z() + segZ);
-    findParticleInBox(containerY1Z2, particleVec, particleY1Z2);
-    reqY1Z2[0] = boostWorld.isend(rankY1Z2, mpiTag, particleY1Z2);
-    reqY1Z2[1] = boostWorld.irecv(rankY1Z2, mpiTag, rParticleY1Z2);
-  }
-  if (rankY2Z1 >= 0) { // edge y2z1
-    Box containerY2Z1(v1.x(), v2.y(), v1.z() - segZ, v2.x(), v2.y() + segY,
-                      v1.z());
-    findParticleInBox(containerY2Z1, particleVec, particleY2Z1);
-    reqY2Z1[0] = boostWorld.isend(rankY2Z1, mpiTag, particleY2Z1);
-    reqY2Z1[1] = boostWorld.irecv(rankY2Z1, mpiTag, rParticleY2Z1);
-  }
-  if (rankY2Z2 >= 0) { // edge y2z2
-    Box containerY2Z2(v1.x(), v2.y(), v2.z(), v2.x(), v2.y() + segY,
-                      v2.z() + segZ);
-    findParticleInBox(containerY2Z2, particleVec, particleY2Z2);
-    reqY2Z2[0] = boostWorld.isend(rankY2Z2, mpiTag, particleY2Z2);
-    reqY2Z2[1] = boostWorld.irecv(rankY2Z2, mpiTag, rParticleY2Z2);
-  }
-  // 8 vertices
-  if (rankX1Y1Z1 >= 0) { // edge x1y1z1
-    Box containerX1Y1Z1(v1.x() - segX, v1.y() - segY, v1.z() - segZ, v1.x(),
-                        v1.y(), v1.z());
-    findParticleInBox(containerX1Y1Z1, particleVec, particleX1Y1Z1);
-    reqX1Y1Z1[0] = boostWorld.isend(rankX1Y1Z1, mpiTag, particleX1Y1Z1);
-    reqX1Y1Z1[1] = boostWorld.irecv(rankX1Y1Z1, mpiTag, rParticleX1Y1Z1);
-  }
-  if (rankX1Y1Z2 >= 0) { // edge x1y1z2
-    Box containerX1Y1Z2(v1.x() - segX, v1.y() - segY, v2.z(), v1.x(), v1.y(),
-                        v2.z() + segZ);
-    findParticleInBox(containerX1Y1Z2, particleVec, particleX1Y1Z2);
-    reqX1Y1Z2[0] = boostWorld.isend(rankX1Y1Z2, mpiTag, particleX1Y1Z2);
-    reqX1Y1Z2[1] = boostWorld.irecv(rankX1Y1Z2, mpiTag, rParticleX1Y1Z2);
-  }
-  if (rankX1Y2Z1 >= 0) { // edge x1y2z1
-    Box containerX1Y2Z1(v1.x() - segX, v2.y(), v1.z() - segZ, v1.x(),
-                        v2.y() + segY, v1.z());
-    findParticleInBox(containerX1Y2Z1, particleVec, particleX1Y2Z1);
-    reqX1Y2Z1[0] = boostWorld.isend(rankX1Y2Z1, mpiTag, particleX1Y2Z1);
-    reqX1Y2Z1[1] = boostWorld.irecv(rankX1Y2Z1, mpiTag, rParticleX1Y2Z1);
-  }
-  if (rankX1Y2Z2 >= 0) { // edge x1y2z2
-    Box containerX1Y2Z2(v1.x() - segX, v2.y(), v2.z(), v1.x(), v2.y() + segY,
-                        v2.z() + segZ);
-    findParticleInBox(containerX1Y2Z2, particleVec, particleX1Y2Z2);
-    reqX1Y2Z2[0] = boostWorld.isend(rankX1Y2Z2, mpiTag, particleX1Y2Z2);
-    reqX1Y2Z2[1] = boostWorld.irecv(rankX1Y2Z2, mpiTag, rParticleX1Y2Z2);
-  }
-  if (rankX2Y1Z1 >= 0) { // edge x2y1z1
-    Box containerX2Y1Z1(v2.x(), v1.y() - segY, v1.z() - segZ, v2.x() + segX,
-                        v1.y(), v1.z());
-    findParticleInBox(containerX2Y1Z1, particleVec, particleX2Y1Z1);
-    reqX2Y1Z1[0] = boostWorld.isend(rankX2Y1Z1, mpiTag, particleX2Y1Z1);
-    reqX2Y1Z1[1] = boostWorld.irecv(rankX2Y1Z1, mpiTag, rParticleX2Y1Z1);
-  }
-  if (rankX2Y1Z2 >= 0) { // edge x2y1z2
-    Box containerX2Y1Z2(v2.x(), v1.y() - segY, v2.z(), v2.x() + segX, v1.y(),
-                        v2.z() + segZ);
-    findParticleInBox(containerX2Y1Z2, particleVec, particleX2Y1Z2);
-    reqX2Y1Z2[0] = boostWorld.isend(rankX2Y1Z2, mpiTag, particleX2Y1Z2);
-    reqX2Y1Z2[1] = boostWorld.irecv(rankX2Y1Z2, mpiTag, rParticleX2Y1Z2);
-  }
-  if (rankX2Y2Z1 >= 0) { // edge x2y2z1
-    Box containerX2Y2Z1(v2.x(), v2.y(), v1.z() - segZ, v2.x() + segX,
-                        v2.y() + segY, v1.z());
-    findParticleInBox(containerX2Y2Z1, particleVec, particleX2Y2Z1);
-    reqX2Y2Z1[0] = boostWorld.isend(rankX2Y2Z1, mpiTag, particleX2Y2Z1);
-    reqX2Y2Z1[1] = boostWorld.irecv(rankX2Y2Z1, mpiTag, rParticleX2Y2Z1);
+  // recvPeriParticleVec.end(); ++it){
+  //  delete (*it);
+  //}
+  recvPeriParticleVec.clear();
+  PeriParticlePArray().swap(recvPeriParticleVec); // actual memory release
+}
+
+void
+Assembly::releasePeriBondVec()
+{
+  // for(auto pt=periBondVec.begin(); pt!=periBondVec.end(); pt++){
+  //  delete (*pt);
+  //}
+  periBondVec.clear();
+  PeriBondPArray().swap(periBondVec); // actual memory release
+}
+
+void
+Assembly::updatePeriGrid()
+{
+  PeriParticlePArray::const_iterator pit = periParticleVec.begin();
+  REAL pMaxX = (*pit)->currentPosition().x();
+  REAL pMinX = (*pit)->currentPosition().x();
+  REAL pMaxY = (*pit)->currentPosition().y();
+  REAL pMinY = (*pit)->currentPosition().y();
+  REAL pMaxZ = (*pit)->currentPosition().z();
+  REAL pMinZ = (*pit)->currentPosition().z();
+
+  REAL tmpx, tmpy, tmpz;
+  dem::Vec tmp_xyz;
+  for (pit = periParticleVec.begin(); pit != periParticleVec.end(); pit++) {
+    tmp_xyz = (*pit)->currentPosition();
+    tmpx = tmp_xyz.x();
+    tmpy = tmp_xyz.y();
+    tmpz = tmp_xyz.z();
+    if (pMaxX < tmpx)
+      pMaxX = tmpx;
+    if (pMinX > tmpx)
+      pMinX = tmpx;
+    if (pMaxY < tmpy)
+      pMaxY = tmpy;
+    if (pMinY > tmpy)
+      pMinY = tmpy;
+    if (pMaxZ < tmpz)
+      pMaxZ = tmpz;
+    if (pMinZ > tmpz)
+      pMinZ = tmpz;
   }
-  if (rankX2Y2Z2 >= 0) { // edge x2y2z2
-    Box containerX2Y2Z2(v2.x(), v2.y(), v2.z(), v2.x() + segX, v2.y() + segY,
-                        v2.z() + segZ);
-    findParticleInBox(containerX2Y2Z2, particleVec, particleX2Y2Z2);
-    reqX2Y2Z2[0] = boostWorld.isend(rankX2Y2Z2, mpiTag, particleX2Y2Z2);
-    reqX2Y2Z2[1] = boostWorld.irecv(rankX2Y2Z2, mpiTag, rParticleX2Y2Z2);
+  REAL maxX = 0;
+  REAL maxY = 0;
+  REAL maxZ = 0;
+  REAL minX = 0;
+  REAL minY = 0;
+  REAL minZ = 0;
+  MPI_Allreduce(&pMaxX, &maxX, 1, MPI_DOUBLE, MPI_MAX, mpiWorld);
+  MPI_Allreduce(&pMinX, &minX, 1, MPI_DOUBLE, MPI_MIN, mpiWorld);
+  MPI_Allreduce(&pMaxY, &maxY, 1, MPI_DOUBLE, MPI_MAX, mpiWorld);
+  MPI_Allreduce(&pMinY, &minY, 1, MPI_DOUBLE, MPI_MIN, mpiWorld);
+  MPI_Allreduce(&pMaxZ, &maxZ, 1, MPI_DOUBLE, MPI_MAX, mpiWorld);
+  MPI_Allreduce(&pMinZ, &minZ, 1, MPI_DOUBLE, MPI_MIN, mpiWorld);
+
+  // no need to broadcast grid as it is updated in each process
+  setGrid(Box(minX - point_interval * 0.2, minY - point_interval * 0.2,
+              minZ - point_interval * 0.2, maxX + point_interval * 0.2,
+              maxY + point_interval * 0.2, maxZ + point_interval * 0.2));
+}
+
+void
+Assembly::migrateParticle()
+{
+  Vec vspan = grid.getMaxCorner() - grid.getMinCorner();
+  REAL segX = vspan.x() / mpiProcX;
+  REAL segY = vspan.y() / mpiProcY;
+  REAL segZ = vspan.z() / mpiProcZ;
+  Vec v1 = container.getMinCorner(); // v1, v2 in terms of process
+  Vec v2 = container.getMaxCorner();
+
+  // if a neighbor exists, transfer particles crossing the boundary in
+  // between as fixed-size records
+  std::array<int, 26> ranks;
+  getNeighborRanks(ranks);
+  const REAL seg[3] = { segX, segY, segZ };
+
+#ifdef TIME_PROFILE
+  Timer::time_point startComm = Timer::now();
+#endif
+
+  migrateSendBuf.resize(26);
+  ParticlePArray foundParticle;
+  for (int k = 0; k < 26; ++k) {
+    migrateSendBuf[k].clear();
+    if (ranks[k] < 0)
+      continue;
+    const int* dir = neighborOffsets[k];
+    REAL lo[3], hi[3];
+    for (int d = 0; d < 3; ++d) {
+      REAL c1 = (d == 0) ? v1.x() : ((d == 1) ? v1.y() : v1.z());
+      REAL c2 = (d == 0) ? v2.x() : ((d == 1) ? v2.y() : v2.z());
+      lo[d] = (dir[d] < 0) ? c1 - seg[d] : ((dir[d] > 0) ? c2 : c1);
+      hi[d] = (dir[d] < 0) ? c1 : ((dir[d] > 0) ? c2 + seg[d] : c2);
+    }
+    foundParticle.clear();
+    findParticleInBox(Box(lo[0], lo[1], lo[2], hi[0], hi[1], hi[2]),
+                      particleVec, foundParticle);
+    migrateSendBuf[k].resize(foundParticle.size());
+    for (std::size_t i = 0; i < foundParticle.size(); ++i) {
+      foundParticle[i]->packState(migrateSendBuf[k][i]);
+    }
   }
-  // 6 surfaces
-  if (rankX1 >= 0)
-    boost::mpi::wait_all(reqX1, reqX1 + 2);
-  if (rankX2 >= 0)
-    boost::mpi::wait_all(reqX2, reqX2 + 2);
-  if (rankY1 >= 0)
-    boost::mpi::wait_all(reqY1, reqY1 + 2);
-  if (rankY2 >= 0)
-    boost::mpi::wait_all(reqY2, reqY2 + 2);
-  if (rankZ1 >= 0)
-    boost::mpi::wait_all(reqZ1, reqZ1 + 2);
-  if (rankZ2 >= 0)
-    boost::mpi::wait_all(reqZ2, reqZ2 + 2);
-  // 12 edges
-  if (rankX1Y1 >= 0)
-    boost::mpi::wait_all(reqX1Y1, reqX1Y1 + 2);
-  if (rankX1Y2 >= 0)
-    boost::mpi::wait_all(reqX1Y2, reqX1Y2 + 2);
-  if (rankX1Z1 >= 0)
-    boost::mpi::wait_all(reqX1Z1, reqX1Z1 + 2);
-  if (rankX1Z2 >= 0)
-    boost::mpi::wait_all(reqX1Z2, reqX1Z2 + 2);
-  if (rankX2Y1 >= 0)
-    boost::mpi::wait_all(reqX2Y1, reqX2Y1 + 2);
-  if (rankX2Y2 >= 0)
-    boost::mpi::wait_all(reqX2Y2, reqX2Y2 + 2);
-  if (rankX2Z1 >= 0)
-    boost::mpi::wait_all(reqX2Z1, reqX2Z1 + 2);
-  if (rankX2Z2 >= 0)
-    boost::mpi::wait_all(reqX2Z2, reqX2Z2 + 2);
-  if (rankY1Z1 >= 0)
-    boost::mpi::wait_all(reqY1Z1, reqY1Z1 + 2);
-  if (rankY1Z2 >= 0)
-    boost::mpi::wait_all(reqY1Z2, reqY1Z2 + 2);
-  if (rankY2Z1 >= 0)
-    boost::mpi::wait_all(reqY2Z1, reqY2Z1 + 2);
-  if (rankY2Z2 >= 0)
-    boost::mpi::wait_all(reqY2Z2, reqY2Z2 + 2);
-  // 8 vertices
-  if (rankX1Y1Z1 >= 0)
-    boost::mpi::wait_all(reqX1Y1Z1, reqX1Y1Z1 + 2);
-  if (rankX1Y1Z2 >= 0)
-    boost::mpi::wait_all(reqX1Y1Z2, reqX1Y1Z2 + 2);
-  if (rankX1Y2Z1 >= 0)
-    boost::mpi::wait_all(reqX1Y2Z1, reqX1Y2Z1 + 2);
-  if (rankX1Y2Z2 >= 0)
-    boost::mpi::wait_all(reqX1Y2Z2, reqX1Y2Z2 + 2);
-  if (rankX2Y1Z1 >= 0)
-    boost::mpi::wait_all(reqX2Y1Z1, reqX2Y1Z1 + 2);
-  if (rankX2Y1Z2 >= 0)
-    boost::mpi::wait_all(reqX2Y1Z2, reqX2Y1Z2 + 2);
-  if (rankX2Y2Z1 >= 0)
-    boost::mpi::wait_all(reqX2Y2Z1, reqX2Y2Z1 + 2);
-  if (rankX2Y2Z2 >= 0)
-    boost::mpi::wait_all(reqX2Y2Z2, reqX2Y2Z2 + 2);
+
+  std::size_t bytesSent, bytesRecv;
+  exchangeRecords(mpiWorld, mpiTag, ranks, migrateSendBuf, migrateRecvBuf,
+                  bytesSent, bytesRecv);
 
   // delete outgoing particles
   removeParticleOutBox();
 
   // add incoming particles
   recvParticleVec.clear(); // new use of recvParticleVec
-  // 6 surfaces
-  if (rankX1 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX1.begin(),
-                           rParticleX1.end());
-  if (rankX2 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX2.begin(),
-                           rParticleX2.end());
-  if (rankY1 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleY1.begin(),
-                           rParticleY1.end());
-  if (rankY2 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleY2.begin(),
-                           rParticleY2.end());
-  if (rankZ1 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleZ1.begin(),
-                           rParticleZ1.end());
-  if (rankZ2 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleZ2.begin(),
-                           rParticleZ2.end());
-  // 12 edges
-  if (rankX1Y1 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX1Y1.begin(),
-                           rParticleX1Y1.end());
-  if (rankX1Y2 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX1Y2.begin(),
-                           rParticleX1Y2.end());
-  if (rankX1Z1 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX1Z1.begin(),
-                           rParticleX1Z1.end());
-  if (rankX1Z2 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX1Z2.begin(),
-                           rParticleX1Z2.end());
-  if (rankX2Y1 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX2Y1.begin(),
-                           rParticleX2Y1.end());
-  if (rankX2Y2 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX2Y2.begin(),
-                           rParticleX2Y2.end());
-  if (rankX2Z1 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX2Z1.begin(),
-                           rParticleX2Z1.end());
-  if (rankX2Z2 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX2Z2.begin(),
-                           rParticleX2Z2.end());
-  if (rankY1Z1 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleY1Z1.begin(),
-                           rParticleY1Z1.end());
-  if (rankY1Z2 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleY1Z2.begin(),
-                           rParticleY1Z2.end());
-  if (rankY2Z1 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleY2Z1.begin(),
-                           rParticleY2Z1.end());
-  if (rankY2Z2 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleY2Z2.begin(),
-                           rParticleY2Z2.end());
-  // 8 vertices
-  if (rankX1Y1Z1 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX1Y1Z1.begin(),
-                           rParticleX1Y1Z1.end());
-  if (rankX1Y1Z2 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX1Y1Z2.begin(),
-                           rParticleX1Y1Z2.end());
-  if (rankX1Y2Z1 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX1Y2Z1.begin(),
-                           rParticleX1Y2Z1.end());
-  if (rankX1Y2Z2 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX1Y2Z2.begin(),
-                           rParticleX1Y2Z2.end());
-  if (rankX2Y1Z1 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX2Y1Z1.begin(),
-                           rParticleX2Y1Z1.end());
-  if (rankX2Y1Z2 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX2Y1Z2.begin(),
-                           rParticleX2Y1Z2.end());
-  if (rankX2Y2Z1 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX2Y2Z1.begin(),
-                           rParticleX2Y2Z1.end());
-  if (rankX2Y2Z2 >= 0)
-    recvParticleVec.insert(recvParticleVec.end(), rParticleX2Y2Z2.begin(),
-                           rParticleX2Y2Z2.end());
+  for (int k = 0; k < 26; ++k) {
+    for (const auto& rec : migrateRecvBuf[k]) {
+      ParticleP particle = std::make_shared<Particle>();
+      particle->unpackState(rec);
+      recvParticleVec.push_back(particle);
+    }
+  }
+
+#ifdef TIME_PROFILE
+  debugInf << std::setw(OWID) << "migrateParticle:" << std::setw(OWID)
+           << "bytesSent=" << std::setw(OWID) << bytesSent << std::setw(OWID)
+           << "bytesRecv=" << std::setw(OWID) << bytesRecv << std::setw(OWID)
+           << "time=" << std::setw(OWID)
+           << std::chrono::duration<double>(Timer::now() - startComm).count()
+           << std::endl;
+#endif
 
   particleVec.insert(particleVec.end(), recvParticleVec.begin(),
                      recvParticleVec.end());
@@ -3089,36 +2240,6 @@ Assembly::migrateParticle()
 
   // do not release memory of received particles because they are part of and
   // managed by particleVec
-  // 6 surfaces
-  rParticleX1.clear();
-  rParticleX2.clear();
-  rParticleY1.clear();
-  rParticleY2.clear();
-  rParticleZ1.clear();
-  rParticleZ2.clear();
-  // 12 edges
-  rParticleX1Y1.clear();
-  rParticleX1Y2.clear();
-  rParticleX1Z1.clear();
-  rParticleX1Z2.clear();
-  rParticleX2Y1.clear();
-  rParticleX2Y2.clear();
-  rParticleX2Z1.clear();
-  rParticleX2Z2.clear();
-  rParticleY1Z1.clear();
-  rParticleY1Z2.clear();
-  rParticleY2Z1.clear();
-  rParticleY2Z2.clear();
-  // 8 vertices
-  rParticleX1Y1Z1.clear();
-  rParticleX1Y1Z2.clear();
-  rParticleX1Y2Z1.clear();
-  rParticleX1Y2Z2.clear();
-  rParticleX2Y1Z1.clear();
-  rParticleX2Y1Z2.clear();
-  rParticleX2Y2Z1.clear();
-  rParticleX2Y2Z2.clear();
-
   recvParticleVec.clear();
 }
 
@@ -3519,37 +2640,37 @@ Assembly::migratePeriParticle()
     }
   */
 
-  // do not release memory of received particles because they are part of and
-  // managed by particleVec
+  // do not release memory of received peri-points because they are part of
+  // and managed by periParticleVec
   // 6 surfaces
-  rParticleX1.clear();
-  rParticleX2.clear();
-  rParticleY1.clear();
-  rParticleY2.clear();
-  rParticleZ1.clear();
-  rParticleZ2.clear();
+  rperiParticleX1.clear();
+  rperiParticleX2.clear();
+  rperiParticleY1.clear();
+  rperiParticleY2.clear();
+  rperiParticleZ1.clear();
+  rperiParticleZ2.clear();
   // 12 edges
-  rParticleX1Y1.clear();
-  rParticleX1Y2.clear();
-  rParticleX1Z1.clear();
-  rParticleX1Z2.clear();
-  rParticleX2Y1.clear();
-  rParticleX2Y2.clear();
-  rParticleX2Z1.clear();
-  rParticleX2Z2.clear();
-  rParticleY1Z1.clear();
-  rParticleY1Z2.clear();
-  rParticleY2Z1.clear();
-  rParticleY2Z2.clear();
+  rperiParticleX1Y1.clear();
+  rperiParticleX1Y2.clear();
+  rperiParticleX1Z1.clear();
+  rperiParticleX1Z2.clear();
+  rperiParticleX2Y1.clear();
+  rperiParticleX2Y2.clear();
+  rperiParticleX2Z1.clear();
+  rperiParticleX2Z2.clear();
+  rperiParticleY1Z1.clear();
+  rperiParticleY1Z2.clear();
+  rperiParticleY2Z1.clear();
+  rperiParticleY2Z2.clear();
   // 8 vertices
-  rParticleX1Y1Z1.clear();
-  rParticleX1Y1Z2.clear();
-  rParticleX1Y2Z1.clear();
-  rParticleX1Y2Z2.clear();
-  rParticleX2Y1Z1.clear();
-  rParticleX2Y1Z2.clear();
-  rParticleX2Y2Z1.clear();
-  rParticleX2Y2Z2.clear();
+  rperiParticleX1Y1Z1.clear();
+  rperiParticleX1Y1Z2.clear();
+  rperiParticleX1Y2Z1.clear();
+  rperiParticleX1Y2Z2.clear();
+  rperiParticleX2Y1Z1.clear();
+  rperiParticleX2Y1Z2.clear();
+  rperiParticleX2Y2Z1.clear();
+  rperiParticleX2Y2Z2.clear();
 
   recvPeriParticleVec.clear();
 }
@@ -4768,6 +3889,126 @@ Assembly::runSecondHalfStep()
   }
 } // end runSecondHalfStep()
 
+// Finds the pairs of peri-points (i, j), i in ptsI and j in ptsJ, that
+// are close enough to be bonded, i.e., whose initial distance is at most
+// twice the average of their horizon sizes.  ptsJ is binned on a cell grid
+// sized by the largest horizon; if sameSet is true ptsI and ptsJ are the
+// same array and only pairs with j > i are returned.  The pairs are
+// returned in the order of the all-pairs loop over i and j.
+void
+Assembly::findPeriBondPairs(const PeriParticlePArray& ptsI,
+                            const PeriParticlePArray& ptsJ, bool sameSet,
+                            PeriBondPairArray& pairs, int ompThreads)
+{
+  pairs.clear();
+  if (ptsI.empty() || ptsJ.empty()) {
+    return;
+  }
+
+  REAL maxHorizon = 0;
+  for (const auto& pt : ptsI) {
+    maxHorizon = std::max(maxHorizon, pt->getHorizonSize());
+  }
+  std::vector<Vec> coordJ(ptsJ.size());
+  for (std::size_t j = 0; j < ptsJ.size(); ++j) {
+    coordJ[j] = ptsJ[j]->getInitPosition();
+    maxHorizon = std::max(maxHorizon, ptsJ[j]->getHorizonSize());
+  }
+  CellBins bins;
+  bins.build(coordJ, 2 * maxHorizon);
+
+  // Each thread fills its own buffer over a contiguous range of i; the
+  // buffers are appended in thread order
+  std::vector<PeriBondPairArray> threadPairs(ompThreads);
+#pragma omp parallel num_threads(ompThreads)
+  {
+    PeriBondPairArray& local = threadPairs[omp_get_thread_num()];
+    std::vector<std::size_t> neighbors;
+
+#pragma omp for schedule(static)
+    for (long ii = 0; ii < static_cast<long>(ptsI.size()); ++ii) {
+      std::size_t i = ii;
+      Vec coord0_i = ptsI[i]->getInitPosition();
+      REAL horizonSize_i = ptsI[i]->getHorizonSize();
+
+      neighbors.clear();
+      bins.forEachNeighbor(coord0_i, [i, sameSet, &neighbors](std::size_t j) {
+        if (!sameSet || j > i) {
+          neighbors.push_back(j);
+        }
+      });
+      std::sort(neighbors.begin(), neighbors.end());
+
+      for (auto j : neighbors) {
+        REAL tmp_length = vfabs(coord0_i - coordJ[j]);
+        REAL horizonSize_ij = (horizonSize_i + ptsJ[j]->getHorizonSize()) * 0.5;
+        if (tmp_length / horizonSize_ij <= 2.0) {
+          local.push_back(std::make_pair(i, j));
+        }
+      }
+    }
+  }
+
+  std::size_t numPairs = 0;
+  for (const auto& local : threadPairs) {
+    numPairs += local.size();
+  }
+  pairs.reserve(numPairs);
+  for (const auto& local : threadPairs) {
+    pairs.insert(pairs.end(), local.begin(), local.end());
+  }
+}
+
+// Creates the peri-bonds for the pairs found by findPeriBondPairs, sets
+// their weights and adds them to both peri-points and to bondVec.  The
+// bonds of one call are stored contiguously in a single shared block; the
+// PeriBondP handles alias into that block.
+void
+Assembly::createPeriBonds(const PeriParticlePArray& ptsI,
+                          const PeriParticlePArray& ptsJ,
+                          const PeriBondPairArray& pairs,
+                          PeriBondPArray& bondVec)
+{
+  if (pairs.empty()) {
+    return;
+  }
+
+  auto bondBlock = std::make_shared<std::vector<periDynamics::PeriBond>>();
+  bondBlock->reserve(pairs.size());
+  for (const auto& pair : pairs) {
+    const PeriParticleP& pt_i = ptsI[pair.first];
+    const PeriParticleP& pt_j = ptsJ[pair.second];
+    REAL tmp_length = vfabs(pt_i->getInitPosition() - pt_j->getInitPosition());
+    REAL horizonSize_ij =
+      (pt_i->getHorizonSize() + pt_j->getHorizonSize()) *
+      0.5; // This will lead to the fact that horizion is not a sphere!!!
+    REAL ratio = tmp_length / horizonSize_ij;
+
+    bondBlock->emplace_back(tmp_length, pt_i, pt_j);
+
+    REAL factor =
+      3.0 / (2.0 * Pi * horizonSize_ij * horizonSize_ij *
+             horizonSize_ij); // for the factor of 3d window function
+
+    // weighting function (influence function)
+    if (ratio < 1.0) {
+      bondBlock->back().setWeight(
+        factor * (2.0 / 3.0 - ratio * ratio + 0.5 * ratio * ratio * ratio));
+    } else {
+      bondBlock->back().setWeight(factor * (2.0 - ratio) * (2.0 - ratio) *
+                                  (2.0 - ratio) / 6.0);
+    }
+  }
+
+  bondVec.reserve(bondVec.size() + pairs.size());
+  for (std::size_t k = 0; k < pairs.size(); ++k) {
+    PeriBondP bond_pt(bondBlock, &(*bondBlock)[k]);
+    ptsI[pairs[k].first]->pushBackBondVec(bond_pt);
+    ptsJ[pairs[k].second]->pushBackBondVec(bond_pt);
+    bondVec.push_back(bond_pt);
+  }
+}
+
 void
 Assembly::constructNeighbor()
 { // this function should be called after
@@ -4782,52 +4023,11 @@ Assembly::constructNeighbor()
     i_nt->clearPeriBonds(); // bondVec should be empty at this time
   }
   periBondVec.clear();
-  std::size_t num = periParticleVec.size();
-  int ompThreads = util::getParam<int>("ompThreads");
-  std::size_t i_nt, j_nt;
-#pragma omp parallel for num_threads(ompThreads) private(i_nt, j_nt) shared(   \
-  num) schedule(dynamic)
-  for (i_nt = 0; i_nt < num - 1; i_nt++) {
-    Vec coord0_i = periParticleVec[i_nt]->getInitPosition();
-    REAL horizonSize_i = periParticleVec[i_nt]->getHorizonSize();
-    for (j_nt = i_nt + 1; j_nt < num; j_nt++) {
-      Vec coord0_j = periParticleVec[j_nt]->getInitPosition();
-      REAL tmp_length = vfabs(coord0_i - coord0_j);
-
-      REAL horizonSize_j = periParticleVec[j_nt]->getHorizonSize();
-      REAL horizonSize_ij =
-        (horizonSize_i + horizonSize_j) *
-        0.5; // This will lead to the fact that horizion is not a sphere!!!
-
-      REAL ratio = tmp_length / horizonSize_ij;
-
-      // establish the neighbor list
-      if (ratio <= 2.0) {
-        // create bond
-        PeriBondP bond_pt = std::make_shared<periDynamics::PeriBond>(
-          tmp_length, periParticleVec[i_nt], periParticleVec[j_nt]);
-#pragma omp critical
-        {
-          periParticleVec[i_nt]->pushBackBondVec(bond_pt);
-          periParticleVec[j_nt]->pushBackBondVec(bond_pt);
-          periBondVec.push_back(bond_pt);
-        }
-        REAL factor =
-          3.0 / (2.0 * Pi * horizonSize_ij * horizonSize_ij *
-                 horizonSize_ij); // for the factor of 3d window function
-
-        // weighting function (influence function)
-        if (ratio < 1.0) {
-          bond_pt->setWeight(
-            factor * (2.0 / 3.0 - ratio * ratio + 0.5 * ratio * ratio * ratio));
-        } else {
-          bond_pt->setWeight(factor * (2.0 - ratio) * (2.0 - ratio) *
-                             (2.0 - ratio) / 6.0);
-        }
-      } // if(ratio<2.0)
 
-    } // end j_nt
-  }   // end i_nt
+  int ompThreads = util::getParam<int>("ompThreads");
+  PeriBondPairArray pairs;
+  findPeriBondPairs(periParticleVec, periParticleVec, true, pairs, ompThreads);
+  createPeriBonds(periParticleVec, periParticleVec, pairs, periBondVec);
 
 } // end constNeighbor()
 
@@ -4846,53 +4046,18 @@ Assembly::findRecvPeriBonds()
     (*i_nt)->clearPeriBonds(); // bondVec should be empty at this time
   }
   recvPeriBondVec.clear();
-  for (auto i_nt = recvPeriParticleVec.begin();
-       i_nt < recvPeriParticleVec.end(); i_nt++) {
-    Vec coord0_i = (*i_nt)->getInitPosition();
-    REAL horizonSize_i = (*i_nt)->getHorizonSize();
-    for (auto j_nt = periParticleVec.begin(); j_nt < periParticleVec.end();
-         j_nt++) {
-      Vec coord0_j = (*j_nt)->getInitPosition();
-      REAL tmp_length = vfabs(coord0_i - coord0_j);
-
-      REAL horizonSize_j = (*j_nt)->getHorizonSize();
-      REAL horizonSize_ij =
-        (horizonSize_i + horizonSize_j) *
-        0.5; // This will lead to the fact that horizion is not a sphere!!!
-
-      REAL ratio = tmp_length / horizonSize_ij;
-
-      // establish the neighbor list
-      if (ratio <= 2.0) {
-        // create bond
-        PeriBondP bond_pt =
-          std::make_shared<periDynamics::PeriBond>(tmp_length, *i_nt, *j_nt);
-        (*j_nt)->pushBackBondVec(bond_pt);
-        (*i_nt)->pushBackBondVec(bond_pt); // i_nt is in recvPeriParticleVec,
-                                           // this is to calculate the
-                                           // deformationGradient, sigma and
-                                           // Kinv
-        // for the peri-points in inner cell of recvPeriParticleVec, refer to
-        // commuPeriParticle()
-        //            bond_pt->setIsRecv();    // bond_pt->isRecv=true;
-        recvPeriBondVec.push_back(bond_pt);
-
-        REAL factor =
-          3.0 / (2.0 * Pi * horizonSize_ij * horizonSize_ij *
-                 horizonSize_ij); // for the factor of 3d window function
-
-        // weighting function (influence function)
-        if (ratio < 1.0) {
-          bond_pt->setWeight(
-            factor * (2.0 / 3.0 - ratio * ratio + 0.5 * ratio * ratio * ratio));
-        } else {
-          bond_pt->setWeight(factor * (2.0 - ratio) * (2.0 - ratio) *
-                             (2.0 - ratio) / 6.0);
-        }
-      } // if(ratio<2.0)
 
-    } // end j_nt
-  }   // end i_nt
+  int ompThreads = util::getParam<int>("ompThreads");
+  PeriBondPairArray pairs;
+
+  // peri-bonds between recvPeriParticleVec and periParticleVec; the
+  // received peri-point also keeps the bond, this is to calculate the
+  // deformationGradient, sigma and Kinv for the peri-points in inner cell
+  // of recvPeriParticleVec, refer to commuPeriParticle()
+  findPeriBondPairs(recvPeriParticleVec, periParticleVec, false, pairs,
+                    ompThreads);
+  createPeriBonds(recvPeriParticleVec, periParticleVec, pairs,
+                  recvPeriBondVec);
 
   // since the calculation of PeriParticle.calcAcceleration() needs to know the
   // deformationGradient, sigma, and Kinv of the peri-points in peri-bonds
@@ -4901,51 +4066,10 @@ Assembly::findRecvPeriBonds()
   // Kinv
   // of the inner peri-points needs to be calculated exactly, thus the
   // peri-bonds between the recvPeriParticles should also be constructed
-  for (auto i_nt = recvPeriParticleVec.begin();
-       i_nt < recvPeriParticleVec.end() - 1; i_nt++) {
-    Vec coord0_i = (*i_nt)->getInitPosition();
-    REAL horizonSize_i = (*i_nt)->getHorizonSize();
-    for (auto j_nt = i_nt + 1; j_nt < recvPeriParticleVec.end(); j_nt++) {
-      Vec coord0_j = (*j_nt)->getInitPosition();    // need to use "<" since if
-                                                    // recvPeriParticleVec is
-                                                    // empty, then j_nt
-      REAL tmp_length = vfabs(coord0_i - coord0_j); // will exceed the limit of
-                                                    // recvPeriParticleVec,
-                                                    // then segmentational
-                                                    // fault
-
-      REAL horizonSize_j = (*j_nt)->getHorizonSize();
-      REAL horizonSize_ij =
-        (horizonSize_i + horizonSize_j) *
-        0.5; // This will lead to the fact that horizion is not a sphere!!!
-
-      REAL ratio = tmp_length / horizonSize_ij;
-      // establish the neighbor list
-      if (ratio <= 2.0) {
-        // create bond
-        PeriBondP bond_pt =
-          std::make_shared<periDynamics::PeriBond>(tmp_length, *i_nt, *j_nt);
-        (*i_nt)->pushBackBondVec(bond_pt);
-        (*j_nt)->pushBackBondVec(bond_pt);
-        //            bond_pt->setIsRecv();    // bond_pt->isRecv=true;
-        recvPeriBondVec.push_back(bond_pt);
-
-        REAL factor =
-          3.0 / (2.0 * Pi * horizonSize_ij * horizonSize_ij *
-                 horizonSize_ij); // for the factor of 3d window function
-
-        // weighting function (influence function)
-        if (ratio < 1.0) {
-          bond_pt->setWeight(
-            factor * (2.0 / 3.0 - ratio * ratio + 0.5 * ratio * ratio * ratio));
-        } else {
-          bond_pt->setWeight(factor * (2.0 - ratio) * (2.0 - ratio) *
-                             (2.0 - ratio) / 6.0);
-        }
-      } // if(ratio<2.0)
-
-    } // end j_nt
-  }   // end i_nt
+  findPeriBondPairs(recvPeriParticleVec, recvPeriParticleVec, true, pairs,
+                    ompThreads);
+  createPeriBonds(recvPeriParticleVec, recvPeriParticleVec, pairs,
+                  recvPeriBondVec);
 
 } // end findRecvPeriBonds()
 
@@ -17,6 +17,7 @@
 #include <boost/serialization/shared_ptr.hpp>
 #include <boost/serialization/unique_ptr.hpp>
 #include <boost/serialization/vector.hpp>
+#include <array>
 #include <cstddef>
 #include <fstream>
 #include <map>
@@ -120,19 +121,15 @@ private:
   int rankY1Z1, rankY1Z2, rankY2Z1, rankY2Z2;
   int rankX1Y1Z1, rankX1Y1Z2, rankX1Y2Z1, rankX1Y2Z2;
   int rankX2Y1Z1, rankX2Y1Z2, rankX2Y2Z1, rankX2Y2Z2;
-  ParticlePArray rParticleX1, rParticleX2; // r stands for received
-  ParticlePArray rParticleY1, rParticleY2;
-  ParticlePArray rParticleZ1, rParticleZ2;
-  ParticlePArray rParticleX1Y1, rParticleX1Y2, rParticleX1Z1, rParticleX1Z2;
-  ParticlePArray rParticleX2Y1, rParticleX2Y2, rParticleX2Z1, rParticleX2Z2;
-  ParticlePArray rParticleY1Z1, rParticleY1Z2, rParticleY2Z1, rParticleY2Z2;
-  ParticlePArray rParticleX1Y1Z1, rParticleX1Y1Z2, rParticleX1Y2Z1,
-    rParticleX1Y2Z2;
-  ParticlePArray rParticleX2Y1Z1, rParticleX2Y1Z2, rParticleX2Y2Z1,
-    rParticleX2Y2Z2;
   ParticlePArray recvParticleVec;  // received particles per process
   ParticlePArray mergeParticleVec; // merged particles per process
 
+  // send/recv buffers of commuParticle and migrateParticle, one per
+  // neighboring block, reused between steps
+  std::vector<std::vector<Particle::HaloRecord>> haloSendBuf, haloRecvBuf;
+  std::vector<std::vector<Particle::StateRecord>> migrateSendBuf,
+    migrateRecvBuf;
+
   // stream
   std::ofstream progressInf;
   std::ofstream balancedInf;
@@ -232,6 +229,13 @@ private:
     recvPeriParticleVec; // received particles per process
   periDynamics::PeriParticlePArray mergePeriParticleVec;
 
+  // send/recv buffers of commuPeriParticle, one per neighboring block,
+  // reused between steps; the bonded DEM IDs of the points in
+  // periHaloSendBuf[k] follow each other in periBondedSendBuf[k]
+  std::vector<std::vector<periDynamics::PeriParticle::HaloRecord>>
+    periHaloSendBuf, periHaloRecvBuf;
+  std::vector<std::vector<int>> periBondedSendBuf, periBondedRecvBuf;
+
   periDynamics::PeriParticlePArray
     bottomBoundaryVec; // particles that are in the bottom boundary
   periDynamics::PeriParticlePArray
@@ -338,6 +342,7 @@ public:
   void scatterParticle();
   void scatterDEMPeriParticle();
   void commuParticle();
+  void getNeighborRanks(std::array<int, 26>& ranks) const;
   void commuPeriParticle();
   bool isBdryProcess();
   void releaseRecvParticle();
@@ -386,6 +391,8 @@ public:
   void findContact(); // detect and resolve contact between particles
   void findContactSingleThread();
   void findContactMultiThread(int numThreads);
+  void findContactCandidates(ContactCandidateArray& candidates,
+                             int numThreads); // broad phase of findContact
   void findBdryContact();      // find particles on boundaries
   void findParticleOnCavity(); // find particle on cavity boundaries
 
@@ -709,6 +716,15 @@ public:
                             // neighborlists
   void findRecvPeriBonds(); // find peri-bonds between periParticleVec and
                             // recvPeriParticleVec
+  void findPeriBondPairs(const periDynamics::PeriParticlePArray& ptsI,
+                         const periDynamics::PeriParticlePArray& ptsJ,
+                         bool sameSet,
+                         periDynamics::PeriBondPairArray& pairs,
+                         int numThreads); // cell grid search for peri-bonds
+  void createPeriBonds(const periDynamics::PeriParticlePArray& ptsI,
+                       const periDynamics::PeriParticlePArray& ptsJ,
+                       const periDynamics::PeriBondPairArray& pairs,
+                       periDynamics::PeriBondPArray& bondVec);
   void findPeriDEMBonds();  // find sand-peri bonds in each cpu, i.e.
                             // periParticleVec and ParticleVec
   void clearPeriDEMBonds();
@@ -4,6 +4,7 @@
 //#include <DiscreteElements/Particle.h>
 //#include <Peridynamics/PeriParticle.h>
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace periDynamics {
@@ -17,6 +18,7 @@ using PeriParticlePArray = std::vector<PeriParticleP>;
 
 using PeriBondP = std::shared_ptr<PeriBond>;
 using PeriBondPArray = std::vector<PeriBondP>;
+using PeriBondPairArray = std::vector<std::pair<std::size_t, std::size_t>>;
 }
 
 namespace dem {
@@ -35,6 +37,7 @@ using ParticlePArray = std::vector<ParticleP>;
 using MembraneParticlePArray = std::vector<std::vector<ParticlePArray>>;
 
 using ContactArray = std::vector<Contact>;
+using ContactCandidateArray = std::vector<std::pair<std::size_t, std::size_t>>;
 using ContactTangentArray = std::vector<ContactTgt>;
 
 using SpringUP = std::unique_ptr<Spring>;
@@ -3,6 +3,7 @@
 #include <Core/Math/root6.h>
 #include <Core/Util/Utility.h>
 #include <DiscreteElements/Particle.h>
+#include <algorithm>
 #include <iostream>
 
 //#define MOMENT
@@ -55,6 +56,94 @@ Particle::Particle()
     i = 0;
 }
 
+void
+Particle::packHalo(HaloRecord& rec) const
+{
+  rec.id = d_id;
+  rec.type = d_type;
+  rec.contactNum = d_contactNum;
+  rec.inContact = d_inContact;
+  rec.a = d_a;
+  rec.b = d_b;
+  rec.c = d_c;
+  rec.young = d_young;
+  rec.poisson = d_poisson;
+  rec.density = d_density;
+  rec.mass = d_mass;
+  rec.volume = d_volume;
+  rec.currPos = d_currPos;
+  rec.prevPos = d_prevPos;
+  rec.currDirecA = d_currDirecA;
+  rec.currDirecB = d_currDirecB;
+  rec.currDirecC = d_currDirecC;
+  rec.currVeloc = d_currVeloc;
+  rec.currOmga = d_currOmga;
+  rec.force = d_force;
+  rec.moment = d_moment;
+  rec.momentJ = d_momentJ;
+  std::copy(d_coef, d_coef + 10, rec.coef);
+}
+
+void
+Particle::unpackHalo(const HaloRecord& rec)
+{
+  d_id = rec.id;
+  d_type = rec.type;
+  d_contactNum = rec.contactNum;
+  d_inContact = rec.inContact;
+  d_a = rec.a;
+  d_b = rec.b;
+  d_c = rec.c;
+  d_young = rec.young;
+  d_poisson = rec.poisson;
+  d_density = rec.density;
+  d_mass = rec.mass;
+  d_volume = rec.volume;
+  d_currPos = rec.currPos;
+  d_prevPos = rec.prevPos;
+  d_currDirecA = rec.currDirecA;
+  d_currDirecB = rec.currDirecB;
+  d_currDirecC = rec.currDirecC;
+  d_currVeloc = rec.currVeloc;
+  d_currOmga = rec.currOmga;
+  d_force = rec.force;
+  d_moment = rec.moment;
+  d_momentJ = rec.momentJ;
+  std::copy(rec.coef, rec.coef + 10, d_coef);
+}
+
+void
+Particle::packState(StateRecord& rec) const
+{
+  packHalo(rec.halo);
+  rec.prevDirecA = d_prevDirecA;
+  rec.prevDirecB = d_prevDirecB;
+  rec.prevDirecC = d_prevDirecC;
+  rec.prevVeloc = d_prevVeloc;
+  rec.prevOmga = d_prevOmga;
+  rec.prevForce = d_prevForce;
+  rec.prevMoment = d_prevMoment;
+  rec.constForce = d_constForce;
+  rec.constMoment = d_constMoment;
+  rec.kinetEnergy = d_kinetEnergy;
+}
+
+void
+Particle::unpackState(const StateRecord& rec)
+{
+  unpackHalo(rec.halo);
+  d_prevDirecA = rec.prevDirecA;
+  d_prevDirecB = rec.prevDirecB;
+  d_prevDirecC = rec.prevDirecC;
+  d_prevVeloc = rec.prevVeloc;
+  d_prevOmga = rec.prevOmga;
+  d_prevForce = rec.prevForce;
+  d_prevMoment = rec.prevMoment;
+  d_constForce = rec.constForce;
+  d_constMoment = rec.constMoment;
+  d_kinetEnergy = rec.kinetEnergy;
+}
+
 void
 Particle::init()
 {
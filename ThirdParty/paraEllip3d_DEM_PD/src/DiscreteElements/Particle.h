@@ -13,12 +13,48 @@
 #include <boost/serialization/vector.hpp>
 #include <cstddef>
 #include <map>
+#include <type_traits>
 #include <vector>
 
 namespace dem {
 
 class Particle
 {
+public:
+  // Fixed-size copies of the particle state, exchanged between processes as
+  // raw bytes instead of through Boost.Serialization.
+  // HaloRecord holds what is needed to compute contacts with a received
+  // copy of a particle (Assembly::commuParticle).  StateRecord holds the
+  // complete state of a migrating particle (Assembly::migrateParticle)
+  // except the per-contact force/moment maps and the fluid grid, which are
+  // rebuilt every step.
+  struct HaloRecord
+  {
+    std::size_t id;
+    std::size_t type;
+    std::size_t contactNum;
+    int inContact;
+    REAL a, b, c;
+    REAL young, poisson;
+    REAL density, mass, volume;
+    Vec currPos, prevPos;
+    Vec currDirecA, currDirecB, currDirecC;
+    Vec currVeloc, currOmga;
+    Vec force, moment;
+    Vec momentJ;
+    REAL coef[10];
+  };
+
+  struct StateRecord
+  {
+    HaloRecord halo;
+    Vec prevDirecA, prevDirecB, prevDirecC;
+    Vec prevVeloc, prevOmga;
+    Vec prevForce, prevMoment;
+    Vec constForce, constMoment;
+    REAL kinetEnergy;
+  };
+
 
 private:
   // types of individual particle:
@@ -201,6 +237,11 @@ public:
                        REAL volFrac);
   std::vector<std::vector<REAL>>& getFluidGrid() { return d_fluidGrid; }
 
+  void packHalo(HaloRecord& rec) const;
+  void unpackHalo(const HaloRecord& rec);
+  void packState(StateRecord& rec) const;
+  void unpackState(const StateRecord& rec);
+
 private:
   void init();
 
@@ -248,6 +289,10 @@ private:
   }
 };
 
+static_assert(std::is_trivially_copyable<Particle::HaloRecord>::value &&
+                std::is_trivially_copyable<Particle::StateRecord>::value,
+              "particle records are sent as raw bytes");
+
 } // namespace dem ends
 
 #endif
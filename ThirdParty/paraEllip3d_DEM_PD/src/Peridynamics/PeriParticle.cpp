@@ -235,6 +235,54 @@ PeriParticle::releaseBondVec()
   bondVec.clear();
 } // releaseBondVec
 
+void
+PeriParticle::packHalo(HaloRecord& rec, std::vector<int>& bondedDEMIds) const
+{
+  rec.isAlive = isAlive;
+  rec.numBondedDEM = static_cast<int>(BondedDEMParticleID.size());
+  rec.initPosition = initPosition;
+  rec.particleVolume = particleVolume;
+  rec.displacement = displacement;
+  rec.prevDisp = prevDisp;
+  rec.velocity = velocity;
+  rec.velocityHalf = velocityHalf;
+  rec.acceleration = acceleration;
+  rec.isv11 = isv11;
+  rec.horizonSize = horizonSize;
+  const REAL sig[9] = { sigma11, sigma12, sigma13, sigma21, sigma22,
+                        sigma23, sigma31, sigma32, sigma33 };
+  const REAL kinv[9] = { Kinv11, Kinv12, Kinv13, Kinv21, Kinv22,
+                         Kinv23, Kinv31, Kinv32, Kinv33 };
+  std::copy(sig, sig + 9, rec.sigma);
+  std::copy(kinv, kinv + 9, rec.Kinv);
+  bondedDEMIds.insert(bondedDEMIds.end(), BondedDEMParticleID.begin(),
+                      BondedDEMParticleID.end());
+}
+
+void
+PeriParticle::unpackHalo(const HaloRecord& rec, const int* bondedDEMIds)
+{
+  isAlive = rec.isAlive != 0;
+  initPosition = rec.initPosition;
+  particleVolume = rec.particleVolume;
+  displacement = rec.displacement;
+  prevDisp = rec.prevDisp;
+  velocity = rec.velocity;
+  velocityHalf = rec.velocityHalf;
+  acceleration = rec.acceleration;
+  isv11 = rec.isv11;
+  horizonSize = rec.horizonSize;
+  REAL* sig[9] = { &sigma11, &sigma12, &sigma13, &sigma21, &sigma22,
+                   &sigma23, &sigma31, &sigma32, &sigma33 };
+  REAL* kinv[9] = { &Kinv11, &Kinv12, &Kinv13, &Kinv21, &Kinv22,
+                    &Kinv23, &Kinv31, &Kinv32, &Kinv33 };
+  for (int i = 0; i < 9; ++i) {
+    *sig[i] = rec.sigma[i];
+    *kinv[i] = rec.Kinv[i];
+  }
+  BondedDEMParticleID.assign(bondedDEMIds, bondedDEMIds + rec.numBondedDEM);
+}
+
 void
 PeriParticle::constructMatrixMember()
 {
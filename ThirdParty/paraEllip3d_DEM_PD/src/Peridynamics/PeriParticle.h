@@ -2,6 +2,7 @@
 #pragma once
 #include <algorithm>
 #include <iostream>
+#include <type_traits>
 #include <vector>
 
 #include <Core/Math/Matrix.h>
@@ -25,6 +26,27 @@ class PeriParticle
 {
 
 public:
+  // Fixed-size copy of the state of a peri-point that a neighboring
+  // process needs (Assembly::commuPeriParticle), exchanged as raw bytes
+  // instead of through Boost.Serialization.  The IDs of the bonded DEM
+  // particles do not fit a fixed-size record; they are exchanged in a
+  // separate int buffer and numBondedDEM says how many belong to the
+  // point.
+  struct HaloRecord
+  {
+    int isAlive;
+    int numBondedDEM;
+    dem::Vec initPosition;
+    REAL particleVolume;
+    dem::Vec displacement, prevDisp;
+    dem::Vec velocity, velocityHalf;
+    dem::Vec acceleration;
+    REAL isv11;
+    REAL horizonSize;
+    REAL sigma[9];
+    REAL Kinv[9];
+  };
+
   // Default Constructor
   PeriParticle();
   PeriParticle(REAL x, REAL y, REAL z);
@@ -148,6 +170,11 @@ public:
                       id) != BondedDEMParticleID.end());
   }
 
+  // packHalo appends the bonded DEM IDs to bondedDEMIds; unpackHalo reads
+  // rec.numBondedDEM of them starting at bondedDEMIds
+  void packHalo(HaloRecord& rec, std::vector<int>& bondedDEMIds) const;
+  void unpackHalo(const HaloRecord& rec, const int* bondedDEMIds);
+
 private:
   bool isAlive; // if the peri-particle is alive
 
@@ -255,6 +282,9 @@ private:
 
 }; // end particle
 
+static_assert(std::is_trivially_copyable<PeriParticle::HaloRecord>::value,
+              "PeriParticle records are sent as raw bytes");
+
 } // end periDynamics
 
 #endif
@@ -52,11 +52,15 @@
 #include <Core/Util/FileUtils.h>
 #include <Core/Util/DebugStream.h>
 #include <Core/Exceptions/ErrnoException.h>
+#include <Core/Exceptions/Exception.h>
 #include <Core/Exceptions/InternalError.h>
 #include <Core/Util/FancyAssert.h>
 #include <Core/Util/Endian.h>
+#include <Core/Thread/Thread.h>
 #include <Core/Thread/Time.h>
 
+#include   <algorithm>
+#include   <climits>
 #include   <iomanip>
 #include   <cerrno>
 #include   <fstream>
@@ -103,7 +107,9 @@ bool DataArchiver::d_wereSavesAndCheckpointsInitialized = false;
 DataArchiver::DataArchiver(const ProcessorGroup* myworld, int udaSuffix)
   : UintahParallelComponent(myworld),
     d_udaSuffix(udaSuffix),
-    d_outputLock("DataArchiver output lock")
+    d_outputLock("DataArchiver output lock"),
+    d_queueLock("DataArchiver output queue lock"),
+    d_queueSignal("DataArchiver output queue signal")
 {
   d_isOutputTimestep = false;
   d_isCheckpointTimestep = false;
@@ -121,10 +127,44 @@ DataArchiver::DataArchiver(const ProcessorGroup* myworld, int udaSuffix)
   d_numLevelsInOutput = 0;
 
   d_writeMeta = false;
+
+  d_asyncOutput = false;
+  d_asyncBufferBytes = 0;
+  d_queuedBytes = 0;
+  d_writerBusy = false;
+  d_writerQuit = false;
+  d_writerThread = 0;
+  d_asyncWriteTime = 0;
+  d_asyncSnapshotTime = 0;
+  d_asyncStallTime = 0;
+  d_asyncBytes = 0;
+  d_asyncFiles = 0;
+
+  d_outputAggregators = 0;
+  d_aggregateComm = MPI_COMM_NULL;
 }
 
 DataArchiver::~DataArchiver()
 {
+  if (d_writerThread) {
+    // The writer writes what is still queued before it quits
+    d_queueLock.lock();
+    d_writerQuit = true;
+    d_queueSignal.conditionBroadcast();
+    d_queueLock.unlock();
+
+    d_writerThread->setCleanupFunction( NULL );
+    d_writerThread->join();
+  }
+
+  // Only after the writer is done with it
+  if (d_aggregateComm != MPI_COMM_NULL) {
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+    if (!finalized) {
+      MPI_Comm_free(&d_aggregateComm);
+    }
+  }
 }
 //______________________________________________________________________
 //
@@ -145,6 +185,37 @@ DataArchiver::problemSetup( const ProblemSpecP    & params,
 
   d_outputDoubleAsFloat = p->findBlock("outputDoubleAsFloat") != 0;
 
+  // write the output of groups of ranks to one file per group
+  d_outputAggregators = 0;
+  p->get("outputAggregators", d_outputAggregators);
+  if (d_outputAggregators < 0) {
+    throw ProblemSetupException("<outputAggregators> must not be negative", __FILE__, __LINE__);
+  }
+  if (d_outputAggregators > 0 && d_aggregateComm == MPI_COMM_NULL) {
+    MPI_Comm_dup(d_myworld->getComm(), &d_aggregateComm);
+  }
+
+  // write the output files from a separate thread
+  ProblemSpecP async = p->findBlock("asyncOutput");
+  d_asyncOutput = async != 0;
+  if (d_asyncOutput && d_outputAggregators > 0) {
+    throw ProblemSetupException("<asyncOutput> cannot be used with <outputAggregators>", __FILE__, __LINE__);
+  }
+  if (d_asyncOutput) {
+    double bufferMB = 1024;
+    async->getAttribute("bufferMB", bufferMB);
+    if (bufferMB <= 0) {
+      throw ProblemSetupException("<asyncOutput bufferMB> must be positive", __FILE__, __LINE__);
+    }
+    d_asyncBufferBytes = (unsigned long) (bufferMB*1048576.0);
+
+    if (d_writerThread == 0) {
+      ostringstream name;
+      name << "DataArchiver Output Writer " << d_myworld->myrank();
+      d_writerThread = scinew Thread(scinew OutputWriter(this), name.str().c_str());
+    }
+  }
+
   // set to false if restartSetup is called - we can't do it there
   // as the first timestep doesn't have any tasks
   d_outputInitTimestep = p->findBlock("outputInitTimestep") != 0;
@@ -1406,6 +1477,11 @@ DataArchiver::writeto_xml_files(double delt, const GridP& grid)
   LoadBalancer* lb = dynamic_cast<LoadBalancer*>(getPort("load balancer")); 
   int dir_timestep = getTimestepTopLevel();  
 
+  // the output tasks have run, write the output of the groups
+  if (d_outputAggregators > 0) {
+    writeAggregatedOutput();
+  }
+
   // start dumping files to disk
   vector<Dir*> baseDirs;
   if (d_isOutputTimestep) {
@@ -1583,9 +1659,19 @@ DataArchiver::writeto_xml_files(double delt, const GridP& grid)
 
         procOnLevel[l].resize(d_myworld->size());
 
+        // the output of a patch is in the file of its aggregator
+        vector<int> aggregator;
+        bool aggregated = d_outputAggregators > 0 && baseDirs[i] == &d_dir;
+        if (aggregated) {
+          getOutputAggregators(level.get_rep(), aggregator);
+        }
+
         for(iter=level->patchesBegin(); iter != level->patchesEnd(); iter++){
           const Patch* patch=*iter;
           int proc = lb->getOutputProc(patch);
+          if (aggregated) {
+            proc = aggregator[proc];
+          }
           procOnLevel[l][proc] = 1;
 
           Box box = patch->getExtraBox();
@@ -1961,215 +2047,619 @@ DataArchiver::outputVariables(const ProcessorGroup * /*world*/,
     dataFilename = tdir.getName() + "/" + dataFilebase;
   }
 
+  //__________________________________
+  // the variables of the file
+  OutputFile file;
+  file.xmlFilename  = xmlFilename;
+  file.dataFilename = dataFilename;
+  file.dataFilebase = dataFilebase;
+  file.isCheckpoint = (type != OUTPUT);
+  file.outputDoubleAsFloat = d_outputDoubleAsFloat && type != CHECKPOINT;
+  file.bytes = 0;
+
+  // loop over variables
+  vector<SaveItem>::iterator saveIter;
+  for(saveIter = saveLabels.begin(); saveIter!= saveLabels.end(); saveIter++) {
+    const VarLabel* var = saveIter->label_;
+    // check to see if we need to save on this level
+    // check is done by absolute level, or relative to end of levels (-1 finest, -2 second finest,...)
+    // find the materials to output on that level
+    map<int, MaterialSetP>::iterator iter = saveIter->matlSet_.end();
+    const MaterialSubset* var_matls = 0;
+
+    if (level) {
+      iter = saveIter->matlSet_.find(level->getIndex());
+      if (iter == saveIter->matlSet_.end())
+        iter = saveIter->matlSet_.find(level->getIndex() - level->getGrid()->numLevels());
+      if (iter == saveIter->matlSet_.end())
+        iter = saveIter->matlSet_.find(ALL_LEVELS);
+      if (iter != saveIter->matlSet_.end()) {
+        var_matls = iter->second.get_rep()->getUnion();
+      }
+    }
+    else { // checkpoint reductions
+      map<int, MaterialSetP>::iterator liter;
+      for (liter = saveIter->matlSet_.begin(); liter != saveIter->matlSet_.end(); liter++) {
+        var_matls = saveIter->getMaterialSet(liter->first)->getUnion();
+        break;
+      }
+    }
+    if (var_matls == 0)
+      continue;
+
+
+    dbg << ", variable: " << var->getName() << ", materials: ";
+    for(int m=0;m<var_matls->size();m++){
+      if(m != 0)
+        dbg << ", ";
+      dbg << var_matls->get(m);
+    }
+    dbg << std::endl;
+
+    // loop through patches and materials
+    for(int p=0;p<(type==CHECKPOINT_REDUCTION?1:patches->size());p++){
+      OutputItem item;
+      item.label = var;
+      item.var = 0;
+
+      if (type == CHECKPOINT_REDUCTION) {
+        // to consolidate into this function, force patch = 0
+        item.patch = 0;
+        item.patchID = -1;
+      }
+      else {
+        item.patch = patches->get(p);
+        item.patchID = item.patch->getID();
+      }
+
+      for(int m=0;m<var_matls->size();m++){
+        item.matlIndex = var_matls->get(m);
+        file.items.push_back(item);
+      }
+    }
+  }
+
+  //__________________________________
+  // The aggregator of the group writes the variables
+  if (d_outputAggregators > 0 && type == OUTPUT) {
+    aggregateOutputFile(file, level, new_dw);
+    return;
+  }
+
+  //__________________________________
+  // The writer thread writes a copy of the variables
+  if (d_asyncOutput && type == OUTPUT) {
+    file.grid = level->getGrid();
+    queueOutputFile(file, new_dw);
+    return;
+  }
+
   // Not only lock to prevent multiple threads from writing over the same
   // file, but also lock because xerces (DOM..) has thread-safety issues.
+  d_outputLock.lock(); 
+  writeOutputFile(file, new_dw);
+  d_outputLock.unlock(); 
+  //d_sharedState->outputTime += Time::currentSeconds()-start;
 
-  int uda_vis_dump = 1;
-  int uda_checkpoint_dump = 0;
-  if (type == CHECKPOINT) {
-    uda_checkpoint_dump = 1;
-  }
 
-  if (uda_checkpoint_dump == 1 || uda_vis_dump == 1)
-  {
-    d_outputLock.lock(); 
-    { // make sure doc's constructor is called after the lock.
-      ProblemSpecP doc; 
+} // end output()
 
-      // file-opening flags
+//______________________________________________________________________
+//
+static int
+openDataFile(const string& dataFilename)
+{
+  // file-opening flags
 #ifdef _WIN32
-      int flags = O_WRONLY|O_CREAT|O_BINARY|O_TRUNC;
+  int flags = O_WRONLY|O_CREAT|O_BINARY|O_TRUNC;
 #else
-      int flags = O_WRONLY|O_CREAT|O_TRUNC;
+  int flags = O_WRONLY|O_CREAT|O_TRUNC;
 #endif
 
-#if 0
-      // DON'T reload a timestep.xml - it will probably mean there was a timestep restart that had written data
-      // and we will want to overwrite it
-      ifstream test(xmlFilename.c_str());
-      if(test){
-        doc = loadDocument(xmlFilename);
-      } else
-#endif
-        doc = ProblemSpec::createDocument("Uintah_Output");
+  // Open the data file
+  //
+  // Note: At least one time on a BGQ machine (Vulcan@LLNL), with 160K patches, a single checkpoint
+  // file failed to open, and it 'crashed' the simulation.  As the other processes on the node 
+  // successfully opened their file, it is possible that a second open call would have succeeded.
+  // (The original error no was 71.)  Therefore I am using a while loop and counting the 'tries'.
 
-      // Find the end of the file
-      ASSERT(doc != 0);
-      ProblemSpecP n = doc->findBlock("Variable");
-    
-      long cur=0;
-      while(n != 0){
-        ProblemSpecP endNode = n->findBlock("end");
-        ASSERT(endNode != 0);
-        long end = atol(endNode->getNodeValue().c_str());
-      
-        if(end > cur)
-          cur=end;
-        n = n->findNextBlock("Variable");
-      }
+  int tries = 1;
+  const char* filename = dataFilename.c_str();
+  int         fd       = open( filename, flags, 0666 );
 
-      // Open the data file
-      //
-      // Note: At least one time on a BGQ machine (Vulcan@LLNL), with 160K patches, a single checkpoint
-      // file failed to open, and it 'crashed' the simulation.  As the other processes on the node 
-      // successfully opened their file, it is possible that a second open call would have succeeded.
-      // (The original error no was 71.)  Therefore I am using a while loop and counting the 'tries'.
+  while ( fd == -1 ) {
 
-      int tries = 1;
-      const char* filename = dataFilename.c_str();
-      int         fd       = open( filename, flags, 0666 );
+    if( tries >= 50 ) {
+      ostringstream msg;
+      msg << "DataArchiver::output(): Failed to open file '" << dataFilename << "' (after 50 tries).";
+      cerr << msg.str() << "\n";
+      throw ErrnoException( msg.str(), errno, __FILE__, __LINE__ );
+    }
 
-      while ( fd == -1 ) {
+    fd = open( filename, flags, 0666 );
+    tries++;
+  }
 
-        if( tries >= 50 ) {
-          ostringstream msg;
-          msg << "DataArchiver::output(): Failed to open file '" << dataFilename << "' (after 50 tries).";
-          cerr << msg.str() << "\n";
-          throw ErrnoException( msg.str(), errno, __FILE__, __LINE__ );
-        }
+  if( tries > 1 ) {
+    proc0cout << "WARNING: There was a glitch in trying to open the checkpoint file: " 
+              << dataFilename << ". It took " << tries << " tries to successfully open it.";
+  }
+  return fd;
+}
 
-        fd = open( filename, flags, 0666 );
-        tries++;
-      }
+//______________________________________________________________________
+//
+void
+DataArchiver::writeOutputFile(OutputFile& file, DataWarehouse* dw)
+{
+  // DON'T reload a timestep.xml - it will probably mean there was a timestep restart that had written data
+  // and we will want to overwrite it
+  ProblemSpecP doc = ProblemSpec::createDocument("Uintah_Output");
+  ASSERT(doc != 0);
 
-      if( tries > 1 ) {
-        proc0cout << "WARNING: There was a glitch in trying to open the checkpoint file: " 
-                  << dataFilename << ". It took " << tries << " tries to successfully open it.";
-      }
+  long cur=0;
 
-      // loop over variables
-      vector<SaveItem>::iterator saveIter;
-      for(saveIter = saveLabels.begin(); saveIter!= saveLabels.end(); saveIter++) {
-        const VarLabel* var = saveIter->label_;
-        // check to see if we need to save on this level
-        // check is done by absolute level, or relative to end of levels (-1 finest, -2 second finest,...)
-        // find the materials to output on that level
-        map<int, MaterialSetP>::iterator iter = saveIter->matlSet_.end();
-        const MaterialSubset* var_matls = 0;
-
-        if (level) {
-          iter = saveIter->matlSet_.find(level->getIndex());
-          if (iter == saveIter->matlSet_.end())
-            iter = saveIter->matlSet_.find(level->getIndex() - level->getGrid()->numLevels());
-          if (iter == saveIter->matlSet_.end())
-            iter = saveIter->matlSet_.find(ALL_LEVELS);
-          if (iter != saveIter->matlSet_.end()) {
-            var_matls = iter->second.get_rep()->getUnion();
-          }
-        }
-        else { // checkpoint reductions
-          map<int, MaterialSetP>::iterator liter;
-          for (liter = saveIter->matlSet_.begin(); liter != saveIter->matlSet_.end(); liter++) {
-            var_matls = saveIter->getMaterialSet(liter->first)->getUnion();
-            break;
-          }
-        }
-        if (var_matls == 0)
-          continue;
-    
+  const char* filename = file.dataFilename.c_str();
+  int         fd       = openDataFile(file.dataFilename);
 
-        dbg << ", variable: " << var->getName() << ", materials: ";
-        for(int m=0;m<var_matls->size();m++){
-          if(m != 0)
-            dbg << ", ";
-          dbg << var_matls->get(m);
-        }
-        dbg << std::endl;
+  for (vector<OutputItem>::iterator item = file.items.begin(); item != file.items.end(); item++) {
+    const VarLabel* var = item->label;
 
-        // loop through patches and materials
-        for(int p=0;p<(type==CHECKPOINT_REDUCTION?1:patches->size());p++){
-          const Patch* patch;
-          int patchID;
+    // add info for this variable to the current xml file
+    // Variables may not exist when we get here due to something whacky with weird AMR stuff...
+    ProblemSpecP pdElem = doc->appendChild("Variable");
 
-          if (type == CHECKPOINT_REDUCTION) {
-            // to consolidate into this function, force patch = 0
-            patch = 0;
-            patchID = -1;
-          }
-          else {
-            patch = patches->get(p);
-            patchID = patch->getID();
-          }
-        
-          // Write info for this variable to current index file
-          for(int m=0;m<var_matls->size();m++){
-          
-            // add info for this variable to the current xml file
-            int matlIndex = var_matls->get(m);
+    pdElem->appendElement("variable", var->getName());
+    pdElem->appendElement("index", item->matlIndex);
+    pdElem->appendElement("patch", item->patchID);
+    pdElem->setAttribute("type",TranslateVariableType( var->typeDescription()->getName().c_str(), file.isCheckpoint ) );
 
-            // Variables may not exist when we get here due to something whacky with weird AMR stuff...
-            ProblemSpecP pdElem = doc->appendChild("Variable");
-          
-            pdElem->appendElement("variable", var->getName());
-            pdElem->appendElement("index", matlIndex);
-            pdElem->appendElement("patch", patchID);
-            pdElem->setAttribute("type",TranslateVariableType( var->typeDescription()->getName().c_str(), type != OUTPUT ) );
+    if (var->getBoundaryLayer() != IntVector(0,0,0)) {
+      pdElem->appendElement("boundaryLayer", var->getBoundaryLayer());
+    }
 
-            if (var->getBoundaryLayer() != IntVector(0,0,0)) {
-              pdElem->appendElement("boundaryLayer", var->getBoundaryLayer());
-            }
+    // Pad appropriately
+    if(cur%PADSIZE != 0){
+      long pad = PADSIZE-cur%PADSIZE;
+      char* zero = scinew char[pad];
+      memset(zero, 0, pad);
+      int err = (int)write(fd, zero, pad);
+      if (err != pad) {
+        cerr << "Error writing to file: " << filename << ", errno=" << errno << '\n';
+        SCI_THROW(ErrnoException("DataArchiver::output (write call)", errno, __FILE__, __LINE__));
+      }
+      cur+=pad;
+      delete[] zero;
+    }
+    ASSERTEQ(cur%PADSIZE, 0);
+    pdElem->appendElement("start", cur);
 
-#if 0          
-            off_t ls = lseek(fd, cur, SEEK_SET);
+    // output data to data file
+    OutputContext oc(fd, filename, cur, pdElem, file.outputDoubleAsFloat);
+    if (item->var) {
+      item->var->emit(oc, item->low, item->high, var->getCompressionMode());
+    }
+    else {
+      dw->emit(oc, var, item->matlIndex, item->patch);
+    }
+    pdElem->appendElement("end", oc.cur);
+    pdElem->appendElement("filename", file.dataFilebase.c_str());
 
-            if(ls == -1) {
-              cerr << "lseek error - file: " << filename << ", errno=" << errno << '\n';
-              throw ErrnoException("DataArchiver::output (lseek call)", errno, __FILE__, __LINE__);
-            }
-#endif
-            // Pad appropriately
-            if(cur%PADSIZE != 0){
-              long pad = PADSIZE-cur%PADSIZE;
-              char* zero = scinew char[pad];
-              memset(zero, 0, pad);
-              int err = (int)write(fd, zero, pad);
-              if (err != pad) {
-                cerr << "Error writing to file: " << filename << ", errno=" << errno << '\n';
-                SCI_THROW(ErrnoException("DataArchiver::output (write call)", errno, __FILE__, __LINE__));
-              }
-              cur+=pad;
-              delete[] zero;
-            }
-            ASSERTEQ(cur%PADSIZE, 0);
-            pdElem->appendElement("start", cur);
-          
-            // output data to data file
-            OutputContext oc(fd, filename, cur, pdElem, d_outputDoubleAsFloat && type != CHECKPOINT);
-            new_dw->emit(oc, var, matlIndex, patch);
-            pdElem->appendElement("end", oc.cur);
-            pdElem->appendElement("filename", dataFilebase.c_str());
-          
 #if SCI_ASSERTION_LEVEL >= 1
-            struct stat st;
-            int s = fstat(fd, &st);
+    struct stat st;
+    int s = fstat(fd, &st);
 
-            if(s == -1) {
-              cerr << "fstat error - file: " << filename << ", errno=" << errno << '\n';
-              throw ErrnoException("DataArchiver::output (stat call)", errno, __FILE__, __LINE__);
-            }
-            ASSERTEQ(oc.cur, st.st_size);
+    if(s == -1) {
+      cerr << "fstat error - file: " << filename << ", errno=" << errno << '\n';
+      throw ErrnoException("DataArchiver::output (stat call)", errno, __FILE__, __LINE__);
+    }
+    ASSERTEQ(oc.cur, st.st_size);
 #endif
-          
-            cur=oc.cur;
-          }
-        }
+
+    cur=oc.cur;
+  }
+  // close files and handles 
+  int s = close(fd);
+  if(s == -1) {
+    cerr << "Error closing file: " << filename << ", errno=" << errno << '\n';
+    throw ErrnoException("DataArchiver::output (close call)", errno, __FILE__, __LINE__);
+  }
+
+  doc->output(file.xmlFilename.c_str());
+  //doc->releaseDocument();
+}
+
+//______________________________________________________________________
+//
+void
+DataArchiver::queueOutputFile(const OutputFile& file, DataWarehouse* dw)
+{
+  // Wait while the copies in flight are over the bound
+  double start = Time::currentSeconds();
+  d_queueLock.lock();
+  while (d_queuedBytes >= d_asyncBufferBytes && d_writerError.empty()) {
+    d_queueSignal.wait(d_queueLock);
+  }
+  d_queueLock.unlock();
+  checkOutputWriter();
+  double stall = Time::currentSeconds() - start;
+
+  OutputFile* queued = scinew OutputFile(file);
+  for (vector<OutputItem>::iterator item = queued->items.begin(); item != queued->items.end(); item++) {
+    item->var = dw->snapshot(item->label, item->matlIndex, item->patch, item->low, item->high);
+    queued->bytes += item->var->getDataSize();
+  }
+  double snapshot = Time::currentSeconds() - start - stall;
+
+  d_queueLock.lock();
+  d_outputQueue.push_back(queued);
+  d_queuedBytes      += queued->bytes;
+  d_asyncStallTime    += stall;
+  d_asyncSnapshotTime += snapshot;
+  d_queueSignal.conditionBroadcast();
+  d_queueLock.unlock();
+
+  dbg << "  queued " << queued->dataFilename << ": " << queued->bytes << " bytes, copied in "
+      << snapshot << " s after waiting " << stall << " s\n";
+}
+
+//______________________________________________________________________
+//
+void
+DataArchiver::writeQueuedOutput()
+{
+  d_queueLock.lock();
+  while (true) {
+    while (d_outputQueue.empty() && !d_writerQuit) {
+      d_queueSignal.wait(d_queueLock);
+    }
+    if (d_outputQueue.empty()) {
+      break;
+    }
+    OutputFile* file = d_outputQueue.front();
+    d_outputQueue.pop_front();
+    d_writerBusy = true;
+    d_queueLock.unlock();
+
+    double start = Time::currentSeconds();
+    string error;
+    d_outputLock.lock();
+    try {
+      writeOutputFile(*file, 0);
+    } catch (Exception& e) {
+      error = e.message();
+    } catch (...) {
+      error = "unknown exception";
+    }
+    d_outputLock.unlock();
+    double writeTime = Time::currentSeconds() - start;
+
+    for (vector<OutputItem>::iterator item = file->items.begin(); item != file->items.end(); item++) {
+      delete item->var;
+    }
+
+    d_queueLock.lock();
+    d_writerBusy = false;
+    d_queuedBytes  -= file->bytes;
+    d_asyncWriteTime += writeTime;
+    d_asyncBytes     += file->bytes;
+    d_asyncFiles++;
+    if (!error.empty() && d_writerError.empty()) {
+      d_writerError = file->dataFilename + ": " + error;
+    }
+    d_queueSignal.conditionBroadcast();
+
+    dbg << "  wrote " << file->dataFilename << " in " << writeTime << " s\n";
+    delete file;
+  }
+  d_queueLock.unlock();
+}
+
+//______________________________________________________________________
+//
+void
+DataArchiver::checkOutputWriter()
+{
+  d_queueLock.lock();
+  string error = d_writerError;
+  d_queueLock.unlock();
+
+  if (!error.empty()) {
+    throw InternalError("DataArchiver output writer failed: " + error, __FILE__, __LINE__);
+  }
+}
+
+//______________________________________________________________________
+//
+void
+DataArchiver::flushOutput()
+{
+  if (d_writerThread == 0) {
+    return;
+  }
+
+  double start = Time::currentSeconds();
+  d_queueLock.lock();
+  while (!d_outputQueue.empty() || d_writerBusy) {
+    d_queueSignal.wait(d_queueLock);
+  }
+  d_asyncStallTime += Time::currentSeconds() - start;
+
+  // Writing that the computation did not wait for was overlapped with it
+  double overlap = std::max(d_asyncWriteTime - d_asyncStallTime, 0.0);
+  proc0cout << "Asynchronous output (rank 0): " << d_asyncFiles << " files, "
+            << d_asyncBytes/1048576.0 << " MB written in " << d_asyncWriteTime << " s, "
+            << overlap << " s of it overlapped with the computation ("
+            << (d_asyncWriteTime > 0 ? 100.0*overlap/d_asyncWriteTime : 100.0) << "%); "
+            << d_asyncSnapshotTime << " s copying, " << d_asyncStallTime << " s waiting\n";
+  d_queueLock.unlock();
+
+  checkOutputWriter();
+}
+
+//______________________________________________________________________
+// The index records of <outputAggregators>
+static void
+packLong(string& buffer, long value)
+{
+  buffer.append(reinterpret_cast<const char*>(&value), sizeof(long));
+}
+
+static void
+packString(string& buffer, const string& value)
+{
+  packLong(buffer, value.size());
+  buffer.append(value);
+}
+
+static long
+unpackLong(const char*& p)
+{
+  long value;
+  memcpy(&value, p, sizeof(long));
+  p += sizeof(long);
+  return value;
+}
+
+static string
+unpackString(const char*& p)
+{
+  long size = unpackLong(p);
+  string value(p, size);
+  p += size;
+  return value;
+}
+
+static void
+writeDataBuffer(int fd, const char* filename, const char* buffer, long size)
+{
+  while (size > 0) {
+    ssize_t s = write(fd, buffer, size);
+    if (s <= 0) {
+      cerr << "Error writing to file: " << filename << ", errno=" << errno << '\n';
+      SCI_THROW(ErrnoException("DataArchiver::writeAggregatedOutput (write call)", errno, __FILE__, __LINE__));
+    }
+    buffer += s;
+    size -= s;
+  }
+}
+
+//______________________________________________________________________
+//
+void
+DataArchiver::getOutputAggregators(const Level* level, vector<int>& aggregator)
+{
+  LoadBalancer* lb = dynamic_cast<LoadBalancer*>(getPort("load balancer"));
+  int numProcs = d_myworld->size();
+
+  aggregator.assign(numProcs, -1);
+  for (Level::const_patchIterator iter = level->patchesBegin(); iter != level->patchesEnd(); iter++) {
+    aggregator[lb->getOutputProc(*iter)] = 0;
+  }
+
+  // the first rank of a group that writes output on the level aggregates
+  int groupSize = (numProcs + d_outputAggregators - 1)/d_outputAggregators;
+  for (int group = 0; group < numProcs; group += groupSize) {
+    int first = -1;
+    for (int proc = group; proc < std::min(group + groupSize, numProcs); proc++) {
+      if (aggregator[proc] == -1) {
+        continue;
       }
-      // close files and handles 
-      int s = close(fd);
-      if(s == -1) {
-        cerr << "Error closing file: " << filename << ", errno=" << errno << '\n';
-        throw ErrnoException("DataArchiver::output (close call)", errno, __FILE__, __LINE__);
+      if (first == -1) {
+        first = proc;
       }
-    
-      doc->output(xmlFilename.c_str());
-      //doc->releaseDocument();
+      aggregator[proc] = first;
     }
-    d_outputLock.unlock(); 
   }
-  //d_sharedState->outputTime += Time::currentSeconds()-start;
+}
 
+//______________________________________________________________________
+//
+void
+DataArchiver::serializeOutputFile(OutputFile& file, DataWarehouse* dw,
+                                  string& data, string& index)
+{
+  // holds the elements emit() adds (numParticles, compression)
+  ProblemSpecP doc = ProblemSpec::createDocument("Uintah_Output");
 
-} // end output()
+  for (vector<OutputItem>::iterator item = file.items.begin(); item != file.items.end(); item++) {
+    const VarLabel* var = item->label;
+
+    // Pad appropriately, the aggregator keeps the alignment
+    if (data.size()%PADSIZE != 0) {
+      data.append(PADSIZE - data.size()%PADSIZE, '\0');
+    }
+    long start = data.size();
+
+    ProblemSpecP pdElem = doc->appendChild("Variable");
+    OutputContext oc(&data, file.dataFilename.c_str(), start, pdElem, file.outputDoubleAsFloat);
+    dw->emit(oc, var, item->matlIndex, item->patch);
+
+    int numParticles = -1;
+    string compression;
+    pdElem->get("numParticles", numParticles);
+    pdElem->get("compression", compression);
+
+    IntVector boundaryLayer = var->getBoundaryLayer();
+    packString(index, var->getName());
+    packLong(index, item->matlIndex);
+    packLong(index, item->patchID);
+    packString(index, TranslateVariableType( var->typeDescription()->getName().c_str(), file.isCheckpoint ));
+    for (int i = 0; i < 3; i++) {
+      packLong(index, boundaryLayer[i]);
+    }
+    packLong(index, start);
+    packLong(index, oc.cur);
+    packLong(index, numParticles);
+    packString(index, compression);
+  }
+}
+
+//______________________________________________________________________
+//
+void
+DataArchiver::aggregateOutputFile(OutputFile& file, const Level* level, DataWarehouse* dw)
+{
+  AggregatedOutput* output = scinew AggregatedOutput;
+  output->xmlFilename  = file.xmlFilename;
+  output->dataFilename = file.dataFilename;
+  output->dataFilebase = file.dataFilebase;
+  output->tag = level->getIndex();
+  serializeOutputFile(file, dw, output->data, output->index);
+  output->sizes[0] = output->index.size();
+  output->sizes[1] = output->data.size();
+
+  vector<int> aggregator;
+  getOutputAggregators(level, aggregator);
+  int myrank = d_myworld->myrank();
+  output->aggregator = aggregator[myrank];
+
+  if (output->aggregator == myrank) {
+    for (int proc = myrank + 1; proc < d_myworld->size(); proc++) {
+      if (aggregator[proc] == myrank) {
+        output->members.push_back(proc);
+      }
+    }
+  }
+  else {
+    if (output->sizes[0] > INT_MAX || output->sizes[1] > INT_MAX) {
+      throw InternalError("DataArchiver::aggregateOutputFile: the output of a rank on a level is over 2 GB, "
+                          "use more <outputAggregators>", __FILE__, __LINE__);
+    }
+    // the aggregator receives after the output tasks, don't wait here
+    int dest = output->aggregator;
+    MPI_Isend(output->sizes, 2, MPI_LONG, dest, output->tag, d_aggregateComm, &output->requests[0]);
+    MPI_Isend(const_cast<char*>(output->index.data()), (int) output->sizes[0], MPI_CHAR,
+              dest, output->tag, d_aggregateComm, &output->requests[1]);
+    MPI_Isend(const_cast<char*>(output->data.data()), (int) output->sizes[1], MPI_CHAR,
+              dest, output->tag, d_aggregateComm, &output->requests[2]);
+  }
+
+  dbg << "  aggregating " << file.dataFilename << " at rank " << output->aggregator
+      << ": " << output->sizes[1] << " bytes\n";
+
+  d_outputLock.lock();
+  d_aggregatedOutput.push_back(output);
+  d_outputLock.unlock();
+}
+
+//______________________________________________________________________
+//
+void
+DataArchiver::writeAggregatedOutput()
+{
+  d_outputLock.lock();
+  vector<AggregatedOutput*> outputs;
+  outputs.swap(d_aggregatedOutput);
+  d_outputLock.unlock();
+
+  int myrank = d_myworld->myrank();
+  for (vector<AggregatedOutput*>::iterator iter = outputs.begin(); iter != outputs.end(); iter++) {
+    AggregatedOutput* output = *iter;
+
+    if (output->aggregator != myrank) {
+      MPI_Waitall(3, output->requests, MPI_STATUSES_IGNORE);
+      delete output;
+      continue;
+    }
+
+    ProblemSpecP doc = ProblemSpec::createDocument("Uintah_Output");
+    const char* filename = output->dataFilename.c_str();
+    int         fd       = openDataFile(output->dataFilename);
+    long        cur      = 0;
+
+    // the variables of this rank, then those of the others in rank order
+    for (int m = -1; m < (int) output->members.size(); m++) {
+      string index, data;
+      if (m == -1) {
+        index.swap(output->index);
+        data.swap(output->data);
+      }
+      else {
+        int source = output->members[m];
+        long sizes[2];
+        MPI_Recv(sizes, 2, MPI_LONG, source, output->tag, d_aggregateComm, MPI_STATUS_IGNORE);
+        index.resize(sizes[0]);
+        data.resize(sizes[1]);
+        MPI_Recv(&index[0], (int) sizes[0], MPI_CHAR, source, output->tag, d_aggregateComm, MPI_STATUS_IGNORE);
+        MPI_Recv(&data[0], (int) sizes[1], MPI_CHAR, source, output->tag, d_aggregateComm, MPI_STATUS_IGNORE);
+      }
+
+      // the offsets of a rank are relative to the padded start of its data
+      if (cur%PADSIZE != 0) {
+        string zero(PADSIZE - cur%PADSIZE, '\0');
+        writeDataBuffer(fd, filename, zero.data(), zero.size());
+        cur += zero.size();
+      }
+      long base = cur;
+      writeDataBuffer(fd, filename, data.data(), data.size());
+      cur += data.size();
+
+      const char* p    = index.data();
+      const char* last = p + index.size();
+      while (p < last) {
+        ProblemSpecP pdElem = doc->appendChild("Variable");
+        pdElem->appendElement("variable", unpackString(p));
+        pdElem->appendElement("index", (int) unpackLong(p));
+        pdElem->appendElement("patch", (int) unpackLong(p));
+        pdElem->setAttribute("type", unpackString(p));
+
+        IntVector boundaryLayer;
+        for (int i = 0; i < 3; i++) {
+          boundaryLayer[i] = (int) unpackLong(p);
+        }
+        if (boundaryLayer != IntVector(0,0,0)) {
+          pdElem->appendElement("boundaryLayer", boundaryLayer);
+        }
+
+        long start = unpackLong(p);
+        long end = unpackLong(p);
+        int numParticles = (int) unpackLong(p);
+        string compression = unpackString(p);
+        pdElem->appendElement("start", base + start);
+        if (numParticles != -1) {
+          pdElem->appendElement("numParticles", numParticles);
+        }
+        if (compression != "") {
+          pdElem->appendElement("compression", compression);
+        }
+        pdElem->appendElement("end", base + end);
+        pdElem->appendElement("filename", output->dataFilebase.c_str());
+      }
+    }
+
+    int s = close(fd);
+    if(s == -1) {
+      cerr << "Error closing file: " << filename << ", errno=" << errno << '\n';
+      throw ErrnoException("DataArchiver::writeAggregatedOutput (close call)", errno, __FILE__, __LINE__);
+    }
+    doc->output(output->xmlFilename.c_str());
+
+    dbg << "  wrote " << output->dataFilename << " for " << output->members.size() + 1
+        << " ranks: " << cur << " bytes\n";
+    delete output;
+  }
+}
 
 void
 DataArchiver::makeVersionedDir()
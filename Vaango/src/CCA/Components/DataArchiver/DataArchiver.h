@@ -35,10 +35,20 @@
 #include <Core/Util/Assert.h>
 #include <Core/OS/Dir.h>
 #include <Core/Containers/ConsecutiveRangeSet.h>
+#include <Core/Geometry/IntVector.h>
+#include <Core/Thread/ConditionVariable.h>
 #include <Core/Thread/Mutex.h>
+#include <Core/Thread/Runnable.h>
+
+#include <sci_defs/mpi_defs.h>
+
+#include <deque>
 
 namespace Uintah {
   class DataWarehouse;
+  class Level;
+  class Thread;
+  class Variable;
   using Uintah::ConsecutiveRangeSet;
   using Uintah::Mutex;
 
@@ -202,6 +212,12 @@ namespace Uintah {
     double getOutputInterval() const {     return d_outputInterval; }
     double getCheckpointInterval() const { return d_checkpointInterval; }
 
+    //! Wait for the output still being written (<asyncOutput>)
+    virtual void flushOutput();
+
+    //! The loop of the output writer thread
+    void writeQueuedOutput();
+
   public:
 
     //! problemSetup parses the ups file into a list of these
@@ -230,6 +246,76 @@ namespace Uintah {
     };
 
   private:
+    //! One variable of a p<rank>.data file.  var is a snapshot
+    //! (<asyncOutput>) or NULL if the variable is emitted from the
+    //! DataWarehouse.
+    struct OutputItem {
+      const VarLabel* label;
+      int matlIndex;
+      const Patch* patch;
+      int patchID;
+      Variable* var;
+      IntVector low;
+      IntVector high;
+    };
+
+    //! The contents of one p<rank>.xml/p<rank>.data pair
+    struct OutputFile {
+      std::string xmlFilename;
+      std::string dataFilename;
+      std::string dataFilebase;
+      bool isCheckpoint;
+      bool outputDoubleAsFloat;
+      std::vector<OutputItem> items;
+      GridP grid;                      // keeps the patches of the items
+      unsigned long bytes;             // snapshot size
+    };
+
+    //! Writes the xml and data files, the caller holds d_outputLock.
+    //! Items without a snapshot are emitted from dw.
+    void writeOutputFile(OutputFile& file, DataWarehouse* dw);
+
+    //! Hands snapshots of the variables of file to the output writer
+    //! thread, waiting while the snapshots in flight exceed d_asyncBufferBytes
+    void queueOutputFile(const OutputFile& file, DataWarehouse* dw);
+
+    //! Throws the error of the output writer thread, if any
+    void checkOutputWriter();
+
+    //! The emitted variables of a rank on a level (<outputAggregators>).
+    //! On the other ranks of a group they are being sent to the
+    //! aggregator, on the aggregator they wait for those of the others.
+    struct AggregatedOutput {
+      std::string xmlFilename;
+      std::string dataFilename;
+      std::string dataFilebase;
+      int tag;                         // the level index
+      int aggregator;
+      std::vector<int> members;        // the other ranks of the file (aggregator)
+      long sizes[2];                   // of index and data
+      std::string index;
+      std::string data;
+      MPI_Request requests[3];         // the sends (other ranks)
+    };
+
+    //! Emits the variables of file and sends them to the aggregator of
+    //! this rank on level, or keeps them if this rank is the aggregator
+    void aggregateOutputFile(OutputFile& file, const Level* level, DataWarehouse* dw);
+
+    //! Writes the files of this rank's groups and completes the sends of
+    //! aggregateOutputFile.  Called after the output tasks have run, so
+    //! waiting for the other ranks cannot stall the task graph.
+    void writeAggregatedOutput();
+
+    //! Emits the variables of file into data and appends a record per
+    //! variable to index.  The offsets are relative to the start of data.
+    void serializeOutputFile(OutputFile& file, DataWarehouse* dw,
+                             std::string& data, std::string& index);
+
+    //! The rank that writes the output of each rank on level, -1 for
+    //! the ranks without output patches on it
+    void getOutputAggregators(const Level* level, std::vector<int>& aggregator);
+
     //! returns a ProblemSpecP reading the xml file xmlName.
     //! You will need to that you need to call ProblemSpec::releaseDocument
     ProblemSpecP loadDocument(std::string xmlName);     
@@ -462,11 +548,66 @@ namespace Uintah {
 #endif
     Mutex d_outputLock;
 
+    //-----------------------------------------------------------
+    // <asyncOutput bufferMB="..."/>
+    //
+    // The output (not checkpoint) tasks copy the variables and
+    // return; a writer thread writes the files while the next
+    // timesteps run.  At most bufferMB of copies are in flight.
+    //-----------------------------------------------------------
+
+    bool                       d_asyncOutput;
+    unsigned long              d_asyncBufferBytes;
+    std::deque<OutputFile*>    d_outputQueue;
+    unsigned long              d_queuedBytes;     // snapshots queued or being written
+    bool                       d_writerBusy;
+    bool                       d_writerQuit;
+    std::string                d_writerError;
+    Mutex                      d_queueLock;
+    ConditionVariable          d_queueSignal;     // file queued, written, or quit
+    Thread*                    d_writerThread;
+
+    // Overlap statistics: time spent writing by the writer thread, and
+    // time the computation spent copying and waiting for buffer space
+    double                     d_asyncWriteTime;
+    double                     d_asyncSnapshotTime;
+    double                     d_asyncStallTime;
+    unsigned long              d_asyncBytes;
+    int                        d_asyncFiles;
+
+    //-----------------------------------------------------------
+    // <outputAggregators>M</outputAggregators>
+    //
+    // The ranks are split into M groups of consecutive ranks.  On
+    // each level one rank of a group (the lowest one with output
+    // patches there) receives the emitted variables of the others
+    // and writes them with its own to p<rank>.xml/p<rank>.data, so
+    // a level of an output timestep has at most M files.  0 is off.
+    //-----------------------------------------------------------
+
+    int                        d_outputAggregators;
+    MPI_Comm                   d_aggregateComm;
+    std::vector<AggregatedOutput*> d_aggregatedOutput;  // guarded by d_outputLock
+
     DataArchiver(const DataArchiver&);
     DataArchiver& operator=(const DataArchiver&);
       
   };
 
+  //! Runs DataArchiver::writeQueuedOutput (<asyncOutput>)
+  class OutputWriter : public Runnable {
+
+  public:
+
+    OutputWriter(DataArchiver* archiver) : d_archiver(archiver) {}
+
+    void run() { d_archiver->writeQueuedOutput(); }
+
+  private:
+
+    DataArchiver* d_archiver;
+  };
+
 } // End namespace Uintah
 
 #endif
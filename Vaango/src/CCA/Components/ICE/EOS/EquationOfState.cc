@@ -58,3 +58,28 @@ EquationOfState::EquationOfState()
 EquationOfState::~EquationOfState()
 {
 }
+
+void EquationOfState::computeRhoMicroBatch(int n, const double* press,
+                                           const double* gamma,
+                                           const double* cv,
+                                           const double* Temp,
+                                           const double* rho_guess,
+                                           double* rhoM)
+{
+  for (int i = 0; i < n; i++) {
+    rhoM[i] = computeRhoMicro(press[i], gamma[i], cv[i], Temp[i], rho_guess[i]);
+  }
+}
+
+void EquationOfState::computePressEOSBatch(int n, const double* rhoM,
+                                           const double* gamma,
+                                           const double* cv,
+                                           const double* Temp,
+                                           double* press, double* dp_drho,
+                                           double* dp_de)
+{
+  for (int i = 0; i < n; i++) {
+    computePressEOS(rhoM[i], gamma[i], cv[i], Temp[i],
+                    press[i], dp_drho[i], dp_de[i]);
+  }
+}
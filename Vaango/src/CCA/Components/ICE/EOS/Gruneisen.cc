@@ -84,6 +84,16 @@ double Gruneisen::computeRhoMicro(double P, double,
   double rhoM = rho0*((1./A)*((P-P0) - B*(T-T0)) + 1.);
   return rhoM;
 }
+
+void Gruneisen::computeRhoMicroBatch(int n, const double* press,
+                                     const double*, const double*,
+                                     const double* Temp, const double*,
+                                     double* rhoM)
+{
+  for (int i = 0; i < n; i++) {
+    rhoM[i] = rho0*((1./A)*((press[i]-P0) - B*(Temp[i]-T0)) + 1.);
+  }
+}
 //__________________________________
 // Return (1/v)*(dv/dT)  (constant pressure thermal expansivity)
 double Gruneisen::getAlpha(double T, double, double P, double)
@@ -130,6 +140,19 @@ void Gruneisen::computePressEOS(double rhoM, double,
   dp_de   = B/cv;
 }
 
+void Gruneisen::computePressEOSBatch(int n, const double* rhoM,
+                                     const double*, const double* cv,
+                                     const double* Temp,
+                                     double* press, double* dp_drho,
+                                     double* dp_de)
+{
+  for (int i = 0; i < n; i++) {
+    press[i]   = P0 + A*(rhoM[i]/rho0-1.) + B*(Temp[i]-T0);
+    dp_drho[i] = A/rho0;
+    dp_de[i]   = B/cv[i];
+  }
+}
+
 //______________________________________________________________________
 // Update temperature boundary conditions due to hydrostatic pressure gradient
 // call this after set Dirchlet and Neuman BC
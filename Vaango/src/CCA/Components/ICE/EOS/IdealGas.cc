@@ -77,6 +77,16 @@ double IdealGas::computeRhoMicro(double press, double gamma,
   return  press/((gamma - 1.0)*cv*Temp);
 }
 
+void IdealGas::computeRhoMicroBatch(int n, const double* press,
+                                    const double* gamma, const double* cv,
+                                    const double* Temp, const double*,
+                                    double* rhoM)
+{
+  for (int i = 0; i < n; i++) {
+    rhoM[i] = press[i]/((gamma[i] - 1.0)*cv[i]*Temp[i]);
+  }
+}
+
 //__________________________________
 void IdealGas::computeTempCC(const Patch* patch,
                              const string& comp_domain,
@@ -116,6 +126,20 @@ void IdealGas::computePressEOS(double rhoM, double gamma,
   dp_drho = (gamma - 1.0)*cv*Temp;
   dp_de   = (gamma - 1.0)*rhoM;
 }
+
+void IdealGas::computePressEOSBatch(int n, const double* rhoM,
+                                    const double* gamma, const double* cv,
+                                    const double* Temp,
+                                    double* press, double* dp_drho,
+                                    double* dp_de)
+{
+  for (int i = 0; i < n; i++) {
+    double gm1 = gamma[i] - 1.0;
+    dp_drho[i] = gm1*cv[i]*Temp[i];
+    press[i]   = rhoM[i]*dp_drho[i];
+    dp_de[i]   = gm1*rhoM[i];
+  }
+}
 //__________________________________
 // Return (1/v)*(dv/dT)  (constant pressure thermal expansivity)
 double IdealGas::getAlpha(double Temp, double , double , double )
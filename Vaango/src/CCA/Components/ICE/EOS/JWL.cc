@@ -258,6 +258,24 @@ void JWL::computePressEOS(double rhoM, double,
   dp_de   = om*rhoM;
 }
 
+void JWL::computePressEOSBatch(int n, const double* rhoM,
+                               const double*, const double* cv,
+                               const double* Temp,
+                               double* press, double* dp_drho,
+                               double* dp_de)
+{
+  for (int i = 0; i < n; i++) {
+    double V  = rho0/rhoM[i];
+    double P1 = A*exp(-R1*V);
+    double P2 = B*exp(-R2*V);
+    double P3 = om*cv[i]*Temp[i]*rhoM[i];
+
+    press[i]   = P1 + P2 + P3;
+    dp_drho[i] = (R1*rho0*P1 + R2*rho0*P2)/(rhoM[i]*rhoM[i]) + om*cv[i]*Temp[i];
+    dp_de[i]   = om*rhoM[i];
+  }
+}
+
 
 //______________________________________________________________________
 // Update temperature boundary conditions due to hydrostatic pressure gradient
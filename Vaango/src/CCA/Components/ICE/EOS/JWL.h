@@ -99,6 +99,12 @@ WARNING
                                      double& press, double& dp_drho,
                                      double& dp_de);
 
+        virtual void computePressEOSBatch(int n, const double* rhoM,
+                                          const double* gamma, const double* cv,
+                                          const double* Temp,
+                                          double* press, double* dp_drho,
+                                          double* dp_de);
+
         virtual void computeTempCC(const Patch* patch,
                                    const string& comp_domain,
                                    const CCVariable<double>& press, 
@@ -146,6 +146,55 @@ double JWLC::computeRhoMicro(double press, double,
   return rhoM;
   
 }
+
+void JWLC::computeRhoMicroBatch(int n, const double* press,
+                                const double* gamma, const double* cv,
+                                const double* Temp, const double* rho_guess,
+                                double* rhoM)
+{
+  // Newton's method in lockstep over the cells (the cells that have
+  // converged do not move).  The cells that have not converged in 100
+  // iterations are done again by computeRhoMicro, which reports failures.
+  const double epsilon = 1.e-15;
+  const double relfac = .9;
+  const double one_plus_omega = 1.+om;
+
+  for (int i = 0; i < n; i++) {
+    rhoM[i] = min(rho_guess[i],rho0);
+  }
+
+  bool converged = false;
+  for (int count = 0; count < 100 && !converged; count++) {
+    converged = true;
+    for (int i = 0; i < n; i++) {
+      double rho = rhoM[i];
+      double inv_rho_rat = rho0/rho;
+      double A_e_to_the_R1_rho0_over_rhoM = A*exp(-R1*inv_rho_rat);
+      double B_e_to_the_R2_rho0_over_rhoM = B*exp(-R2*inv_rho_rat);
+      double C_rho_rat_tothe_one_plus_omega = C*pow(rho/rho0,one_plus_omega);
+
+      double f = (A_e_to_the_R1_rho0_over_rhoM +
+                  B_e_to_the_R2_rho0_over_rhoM +
+                  C_rho_rat_tothe_one_plus_omega) - press[i];
+
+      double rho0_rhoMsqrd = rho0/(rho*rho);
+      double df_drho = R1*rho0_rhoMsqrd*A_e_to_the_R1_rho0_over_rhoM
+                     + R2*rho0_rhoMsqrd*B_e_to_the_R2_rho0_over_rhoM
+                     + (one_plus_omega/rho)*C_rho_rat_tothe_one_plus_omega;
+
+      double delta = -relfac*(f/df_drho);
+      bool done = !(fabs(delta/rho) > epsilon);
+      rhoM[i] = done ? rho : fabs(rho + delta);
+      converged = converged && done;
+    }
+  }
+
+  if (!converged) {
+    for (int i = 0; i < n; i++) {
+      rhoM[i] = computeRhoMicro(press[i], gamma[i], cv[i], Temp[i], rho_guess[i]);
+    }
+  }
+}
 //__________________________________
 // Return (1/v)*(dv/dT)  (constant pressure thermal expansivity)
 double JWLC::getAlpha(double, double , double , double )
@@ -214,6 +263,30 @@ void JWLC::computePressEOS(double rhoM, double, double, double,
   dp_de   = 0.0;
 }
 
+void JWLC::computePressEOSBatch(int n, const double* rhoM,
+                                const double*, const double*, const double*,
+                                double* press, double* dp_drho,
+                                double* dp_de)
+{
+  double one_plus_omega = 1.+om;
+  for (int i = 0; i < n; i++) {
+    double inv_rho_rat = rho0/rhoM[i];
+    double A_e_to_the_R1_rho0_over_rhoM = A*exp(-R1*inv_rho_rat);
+    double B_e_to_the_R2_rho0_over_rhoM = B*exp(-R2*inv_rho_rat);
+    double C_rho_rat_tothe_one_plus_omega = C*pow(rhoM[i]/rho0,one_plus_omega);
+
+    press[i] = A_e_to_the_R1_rho0_over_rhoM +
+               B_e_to_the_R2_rho0_over_rhoM + C_rho_rat_tothe_one_plus_omega;
+
+    double rho0_rhoMsqrd = rho0/(rhoM[i]*rhoM[i]);
+    dp_drho[i] = R1*rho0_rhoMsqrd*A_e_to_the_R1_rho0_over_rhoM
+               + R2*rho0_rhoMsqrd*B_e_to_the_R2_rho0_over_rhoM
+               + (one_plus_omega/rhoM[i])*C_rho_rat_tothe_one_plus_omega;
+
+    dp_de[i] = 0.0;
+  }
+}
+
 //______________________________________________________________________
 // Update temperature boundary conditions due to hydrostatic pressure gradient
 // call this after set Dirchlet and Neuman BC
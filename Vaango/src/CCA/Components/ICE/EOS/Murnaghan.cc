@@ -28,6 +28,7 @@
 #include <Core/Grid/Variables/CellIterator.h>
 #include <Core/ProblemSpec/ProblemSpec.h>
 #include <Core/Exceptions/InternalError.h>
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 
@@ -74,6 +75,20 @@ double Murnaghan::computeRhoMicro(double press, double,
   return rhoM;
 }
 
+void Murnaghan::computeRhoMicroBatch(int num_cells, const double* press,
+                                     const double*, const double*,
+                                     const double*, const double*,
+                                     double* rhoM)
+{
+  // Both branches are evaluated (each clamped to its own range) so that
+  // the loop has no branches
+  for (int i = 0; i < num_cells; i++) {
+    double above = rho0*pow((n*K*(std::max(press[i],P0)-P0)+1.),1./n);
+    double below = rho0*pow((std::min(press[i],P0)/P0),K*P0);
+    rhoM[i] = press[i] >= P0 ? above : below;
+  }
+}
+
 //__________________________________
 // Return (1/v)*(dv/dT)  (constant pressure thermal expansivity)
 double Murnaghan::getAlpha(double, double, double, double)
@@ -130,6 +145,23 @@ void Murnaghan::computePressEOS(double rhoM, double, double, double,
   dp_de   = 0.0;
 }
 
+void Murnaghan::computePressEOSBatch(int num_cells, const double* rhoM,
+                                     const double*, const double*,
+                                     const double*,
+                                     double* press, double* dp_drho,
+                                     double* dp_de)
+{
+  for (int i = 0; i < num_cells; i++) {
+    double rho_rat = rhoM[i]/rho0;
+    bool compressed = rho_rat >= 1.;
+    double expo = compressed ? n : 1./(K*P0);
+    double pow_rat = pow(rho_rat,expo);
+    press[i]   = compressed ? P0 + (1./(n*K))*(pow_rat-1.) : P0*pow_rat;
+    dp_drho[i] = (1./(K*rho0))*pow_rat/rho_rat;
+    dp_de[i]   = 0.0;
+  }
+}
+
 //______________________________________________________________________
 // Update temperature boundary conditions due to hydrostatic pressure gradient
 // call this after set Dirchlet and Neuman BC
@@ -79,6 +79,18 @@ WARNING
                                      double& press, double& dp_drho,
                                      double& dp_de);
 
+        virtual void computeRhoMicroBatch(int num_cells, const double* press,
+                                          const double* gamma, const double* cv,
+                                          const double* Temp,
+                                          const double* rho_guess,
+                                          double* rhoM);
+
+        virtual void computePressEOSBatch(int num_cells, const double* rhoM,
+                                          const double* gamma, const double* cv,
+                                          const double* Temp,
+                                          double* press, double* dp_drho,
+                                          double* dp_de);
+
         virtual void computeTempCC(const Patch* patch,
                                    const string& comp_domain,
                                    const CCVariable<double>& press, 
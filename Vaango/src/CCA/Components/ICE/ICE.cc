@@ -62,6 +62,7 @@
 #include <Core/Parallel/ProcessorGroup.h>
 
 #include <Core/Math/FastMatrix.h>
+#include <Core/Math/FixedFastMatrix.h>
 #include <Core/Containers/StaticArray.h>
 #include <Core/Math/Expon.h>
 #include <Core/Util/DebugStream.h>
@@ -124,6 +125,8 @@ ICE::ICE(const ProcessorGroup* myworld, const bool doAMR) :
   d_with_mpm                = false;
   d_with_rigid_mpm          = false;
   d_clampSpecificVolume     = false;
+  d_batchEquilibration      = false;
+  d_fusedAdvection          = false;
 
   d_exchCoeff = scinew ExchangeCoefficients();
 
@@ -294,6 +297,8 @@ void ICE::problemSetup(const ProblemSpecP& prob_spec,
 
   cfd_ice_ps->get("max_iteration_equilibration",d_max_iter_equilibration);
   cfd_ice_ps->get("ClampSpecificVolume",d_clampSpecificVolume);
+  cfd_ice_ps->get("batch_equilibration",d_batchEquilibration);
+  cfd_ice_ps->get("fused_advection",d_fusedAdvection);
 
   d_advector = AdvectionFactory::create(cfd_ice_ps, d_useCompatibleFluxes,
                                         d_OrderOfAdvection);
@@ -1782,8 +1787,14 @@ void ICE::scheduleAdvectAndAdvanceInTime(SchedulerP& sched,
   cout_doing << d_myworld->myrank() << " ICE::scheduleAdvectAndAdvanceInTime" 
              << "\t\t\t\tL-"<< levelIndex << endl;
 
-  Task* task = scinew Task("ICE::advectAndAdvanceInTime",
-                           this, &ICE::advectAndAdvanceInTime);
+  Task* task;
+  if(d_fusedAdvection){
+    task = scinew Task("ICE::advectAndConvertToPrimitive",
+                       this, &ICE::advectAndConvertToPrimitive);
+  } else {
+    task = scinew Task("ICE::advectAndAdvanceInTime",
+                       this, &ICE::advectAndAdvanceInTime);
+  }
   task->requires(Task::OldDW, lb->delTLabel,getLevel(patch_set));
   Ghost::GhostType  gac  = Ghost::AroundCells;
   task->requires(Task::NewDW, lb->uvel_FCMELabel,      gac,2);
@@ -1802,6 +1813,26 @@ void ICE::scheduleAdvectAndAdvanceInTime(SchedulerP& sched,
   task->computes(lb->mom_advLabel);
   task->computes(lb->eng_advLabel);
   task->computes(lb->sp_vol_advLabel);     
+
+  //__________________________________
+  // The conserved to primitive conversion after advection 
+  // (scheduleConservedtoPrimitive_Vars) is part of this task
+  if(d_fusedAdvection){
+    Ghost::GhostType  gn  = Ghost::None;
+    task->requires(Task::NewDW, lb->specific_heatLabel, gn, 0);
+    task->requires(Task::NewDW, lb->speedSound_CCLabel, gn, 0);
+    task->requires(Task::NewDW, lb->vol_frac_CCLabel,   gn, 0);
+    task->requires(Task::NewDW, lb->gammaLabel,         gn, 0);
+
+    computesRequires_CustomBCs(task, "Advection", lb, ice_matlsub, 
+                               d_customBC_var_basket);
+
+    task->modifies(lb->rho_CCLabel);
+    task->modifies(lb->sp_vol_CCLabel);
+    task->computes(lb->temp_CCLabel);
+    task->computes(lb->vel_CCLabel);
+    task->computes(lb->machLabel);
+  }
   //__________________________________
   // Model Variables.
   if(d_modelSetup && d_modelSetup->tvars.size() > 0){
@@ -1812,6 +1843,9 @@ void ICE::scheduleAdvectAndAdvanceInTime(SchedulerP& sched,
       TransportedVariable* tvar = *iter;
       task->requires(Task::NewDW, tvar->var_Lagrangian, tvar->matls, gac, 2);
       task->computes(tvar->var_adv,   tvar->matls);
+      if(d_fusedAdvection){
+        task->computes(tvar->var,     tvar->matls);
+      }
     }
   }
   sched->setRestartable(true);
@@ -1840,6 +1874,10 @@ void ICE::scheduleConservedtoPrimitive_Vars(SchedulerP& sched,
   if(levelIndex + 1 == numLevels && where ==  "finalizeTimestep")
     return;
 
+  // the fused advection task has already done it
+  if(d_fusedAdvection && where == "afterAdvection")
+    return;
+
   // from another taskgraph
   bool fat = false;
   if (where == "finalizeTimestep")
@@ -2626,7 +2664,18 @@ void ICE::computeEquilibrationPressure(const ProcessorGroup*,
     //______________________________________________________________________
     // Done with preliminary calcs, now loop over every cell
     int count, test_max_iter = 0;
-    for (CellIterator iter=patch->getExtraCellIterator();!iter.done();iter++) {
+
+    // Block-wise solve with the batched EOS calls; the per-cell loop below
+    // is the reference and keeps the per-iteration history for DBG_EqPress
+    bool batched = d_batchEquilibration && !ds_EqPress.active();
+    if (batched) {
+      test_max_iter = computeEquilibrationPressureBatch(patch, L_indx,
+                                   convergence_crit, new_dw, Temp, rho_CC, cv,
+                                   gamma, rho_micro, vol_frac, speedSound_new,
+                                   press_new, n_iters_equil_press);
+    }
+
+    for (CellIterator iter=patch->getExtraCellIterator();!batched && !iter.done();iter++) {
       IntVector c = *iter;   
       double delPress = 0.;
       bool converged  = false;
@@ -2878,6 +2927,250 @@ void ICE::computeEquilibrationPressure(const ProcessorGroup*,
   }  // patch loop
 }
 
+/* _____________________________________________________________________ 
+   Function~  ICE::computeEquilibrationPressureBatch--
+   Purpose~   The Newton iteration of computeEquilibrationPressure, done
+   on blocks of cells with the batched EOS calls (<batch_equilibration>).
+
+   The cells of a block iterate together.  After each iteration the cells
+   that have converged are retired and the others are compacted to the
+   front of the work arrays, so the loops over the cells stay dense and
+   vectorize.  The per cell loop in computeEquilibrationPressure is the
+   reference; the two agree to roundoff.  Returns the max. iterations in
+   any cell.
+   _____________________________________________________________________*/
+int ICE::computeEquilibrationPressureBatch(const Patch* patch,
+                                   int L_indx,
+                                   double convergence_crit,
+                                   DataWarehouse* new_dw,
+                                   StaticArray<constCCVariable<double> >& Temp,
+                                   StaticArray<constCCVariable<double> >& rho_CC,
+                                   StaticArray<constCCVariable<double> >& cv,
+                                   StaticArray<constCCVariable<double> >& gamma,
+                                   StaticArray<CCVariable<double> >& rho_micro,
+                                   StaticArray<CCVariable<double> >& vol_frac,
+                                   StaticArray<CCVariable<double> >& speedSound_new,
+                                   CCVariable<double>& press_new,
+                                   CCVariable<int>& n_iters_equil_press)
+{
+  const int BLOCK = 64;
+  int numMatls = d_sharedState->getNumICEMatls();
+  int numValues = numMatls*BLOCK;
+
+  vector<EquationOfState*> eos(numMatls);
+  for (int m = 0; m < numMatls; m++) {
+    eos[m] = d_sharedState->getICEMaterial(m)->getEOS();
+  }
+
+  // The per material arrays are indexed [m*BLOCK + i].  The block arrays
+  // hold the cells in iterator order, the work arrays the cells still
+  // iterating (slot[i] is the block index of work cell i).
+  vector<IntVector> cells(BLOCK);
+  vector<int>    count_blk(BLOCK);
+  vector<double> press_blk(BLOCK), sum_blk(BLOCK);
+  vector<double> rhoM_blk(numValues), volFrac_blk(numValues);
+  vector<double> T_blk(numValues), cv_blk(numValues), gamma_blk(numValues);
+
+  vector<int>    slot(BLOCK);
+  vector<double> press(BLOCK), sum(BLOCK), A(BLOCK), B(BLOCK), C(BLOCK);
+  vector<double> rhoM(numValues), volFrac(numValues), rho(numValues);
+  vector<double> T(numValues), cvs(numValues), gammas(numValues);
+  vector<double> rhoM_new(BLOCK);
+  vector<double> press_eos(numValues), dp_drho(numValues), dp_de(numValues);
+
+  int test_max_iter = 0;
+  CellIterator iter = patch->getExtraCellIterator();
+  while (!iter.done()) {
+
+    //__________________________________
+    // gather the next block
+    int n = 0;
+    for (; n < BLOCK && !iter.done(); iter++, n++) {
+      IntVector c = *iter;
+      cells[n]     = c;
+      slot[n]      = n;
+      press[n]     = press_new[c];
+      press_blk[n] = press_new[c];
+      count_blk[n] = 0;
+      sum_blk[n]   = 0.0;
+      for (int m = 0; m < numMatls; m++) {
+        int k = m*BLOCK + n;
+        rhoM[k]    = rho_micro[m][c];
+        volFrac[k] = vol_frac[m][c];
+        rho[k]     = rho_CC[m][c];
+        T[k]       = Temp[m][c];
+        cvs[k]     = cv[m][c];
+        gammas[k]  = gamma[m][c];
+
+        rhoM_blk[k]    = rhoM[k];
+        volFrac_blk[k] = volFrac[k];
+        T_blk[k]       = T[k];
+        cv_blk[k]      = cvs[k];
+        gamma_blk[k]   = gammas[k];
+        sum_blk[n]    += volFrac[k];
+      }
+    }
+    int numCells = n;
+
+    int count = 0;
+    while (n > 0 && count < d_max_iter_equilibration) {
+      count++;
+
+      //__________________________________
+      // evaluate press_eos
+      for (int m = 0; m < numMatls; m++) {
+        int k = m*BLOCK;
+        eos[m]->computePressEOSBatch(n, &rhoM[k], &gammas[k], &cvs[k], &T[k],
+                                     &press_eos[k], &dp_drho[k], &dp_de[k]);
+      }
+
+      //__________________________________
+      // - compute delPress
+      // - update press_CC
+      for (int i = 0; i < n; i++) {
+        A[i] = 0.0;
+        B[i] = 0.0;
+        C[i] = 0.0;
+      }
+      for (int m = 0; m < numMatls; m++) {
+        const double* vf   = &volFrac[m*BLOCK];
+        const double* p    = &press_eos[m*BLOCK];
+        const double* dpdr = &dp_drho[m*BLOCK];
+        const double* r    = &rho[m*BLOCK];
+        for (int i = 0; i < n; i++) {
+          double Q     = press[i] - p[i];
+          double div_y = (vf[i]*vf[i])/(dpdr[i]*r[i] + d_SMALL_NUM);
+          A[i] += vf[i];
+          B[i] += Q*div_y;
+          C[i] += div_y;
+        }
+      }
+      double vol_frac_not_close_packed = 1.0;
+      for (int i = 0; i < n; i++) {
+        press[i] += (A[i] - vol_frac_not_close_packed - B[i])/C[i];
+        sum[i] = 0.0;
+      }
+
+      //__________________________________
+      // backout rho_micro_CC at this new pressure
+      // and update the volume fractions
+      for (int m = 0; m < numMatls; m++) {
+        int k = m*BLOCK;
+        eos[m]->computeRhoMicroBatch(n, &press[0], &gammas[k], &cvs[k], &T[k],
+                                     &rhoM[k], &rhoM_new[0]);
+        for (int i = 0; i < n; i++) {
+          rhoM[k+i]    = rhoM_new[i];
+          volFrac[k+i] = rho[k+i]/rhoM_new[i];
+          sum[i]      += volFrac[k+i];
+        }
+      }
+
+      //__________________________________
+      // - Test for convergence, retire the converged cells
+      //   and compact the others
+      int left = 0;
+      for (int i = 0; i < n; i++) {
+        if (fabs(sum[i] - 1.0) < convergence_crit ||
+            count == d_max_iter_equilibration) {
+          int s = slot[i];
+          press_blk[s] = press[i];
+          sum_blk[s]   = sum[i];
+          count_blk[s] = count;
+          for (int m = 0; m < numMatls; m++) {
+            rhoM_blk[m*BLOCK + s]    = rhoM[m*BLOCK + i];
+            volFrac_blk[m*BLOCK + s] = volFrac[m*BLOCK + i];
+          }
+          continue;
+        }
+        if (left != i) {
+          slot[left]  = slot[i];
+          press[left] = press[i];
+          for (int m = 0; m < numMatls; m++) {
+            int to = m*BLOCK + left, from = m*BLOCK + i;
+            rhoM[to]    = rhoM[from];
+            volFrac[to] = volFrac[from];
+            rho[to]     = rho[from];
+            T[to]       = T[from];
+            cvs[to]     = cvs[from];
+            gammas[to]  = gammas[from];
+          }
+        }
+        left++;
+      }
+      n = left;
+    }
+
+    //__________________________________
+    // Find the speed of sound based on the solution
+    // and scatter the block
+    for (int m = 0; m < numMatls; m++) {
+      int k = m*BLOCK;
+      eos[m]->computePressEOSBatch(numCells, &rhoM_blk[k], &gamma_blk[k],
+                                   &cv_blk[k], &T_blk[k], &press_eos[k],
+                                   &dp_drho[k], &dp_de[k]);
+      for (int i = 0; i < numCells; i++) {
+        IntVector c = cells[i];
+        double rhoM_c = rhoM_blk[k+i];
+        double tmp = dp_drho[k+i] + dp_de[k+i]*press_eos[k+i]/(rhoM_c*rhoM_c);
+        rho_micro[m][c]      = rhoM_c;
+        vol_frac[m][c]       = volFrac_blk[k+i];
+        speedSound_new[m][c] = sqrt(tmp);
+      }
+    }
+    for (int i = 0; i < numCells; i++) {
+      press_new[cells[i]] = press_blk[i];
+      test_max_iter = std::max(test_max_iter, count_blk[i]);
+      if (switchDebug_equil_press) {
+        n_iters_equil_press[cells[i]] = count_blk[i];
+      }
+    }
+
+    //__________________________________
+    //      BULLET PROOFING
+    // ignore BP if a timestep restart has already been requested
+    bool tsr = new_dw->timestepRestarted();
+    if (tsr) {
+      continue;
+    }
+    for (int i = 0; i < numCells; i++) {
+      string message;
+      if (count_blk[i] == d_max_iter_equilibration) {
+        message += "Max. iterations reached ";
+      }
+      if (fabs(sum_blk[i] - 1.0) > convergence_crit) {
+        message += " sum (volumeFractions) != 1 ";
+      }
+      if (press_blk[i] < 0.0) {
+        message += " Computed pressure is < 0 ";
+      }
+      for (int m = 0; m < numMatls; m++) {
+        if (rhoM_blk[m*BLOCK + i] < 0.0 || volFrac_blk[m*BLOCK + i] < 0.0) {
+          message += " rho_micro < 0 || vol_frac < 0";
+        }
+      }
+      if (!message.empty()) {  // throw an exception of there's a problem
+        IntVector c = cells[i];
+        ostringstream warn;
+        warn << "\nICE::ComputeEquilibrationPressure: Cell "<< c << ", L-"<<L_indx <<"\n"
+             << message
+             <<"\nThis usually means that something much deeper has gone wrong with the simulation. "
+             <<"\nCompute equilibration pressure task is rarely the problem. "
+             << "For more debugging information set the environmental variable:  \n"
+             << "   SCI_DEBUG DBG_EqPress:+\n\n";
+
+        warn << "INPUTS: \n";
+        for (int m = 0; m < numMatls; m++){
+          warn<< "\n matl: " << m << "\n"
+              << "   rho_CC:     " << rho_CC[m][c] << "\n"
+              << "   Temperature:   "<< Temp[m][c] << "\n";
+        }
+        throw InvalidValue(warn.str(), __FILE__, __LINE__);
+      }
+    }
+  }
+  return test_max_iter;
+}
+
 /* _____________________________________________________________________ 
    Function~  ICE::computeEquilPressure_1_matl--
    Purpose~   Simple EOS evaluation
@@ -3447,9 +3740,47 @@ void ICE::add_vel_FC_exchange( CellIterator iter,
                                T& vel_FCME)        
 
 {
+  // The solver for the number of materials is picked once here; the cell
+  // loop is compiled for each size
+  switch (numMatls) {
+#define ICE_VEL_FC_EXCHANGE(N)                                          \
+  case N: {                                                             \
+    FixedFastMatrix<N> a;                                               \
+    add_vel_FC_exchange_cells(a, iter, adj_offset, K, delT, vol_frac_CC, \
+                              sp_vol_CC, vel_FC, sp_vol_FC, vel_FCME);  \
+    break;                                                              \
+  }
+  ICE_VEL_FC_EXCHANGE(2)
+  ICE_VEL_FC_EXCHANGE(3)
+  ICE_VEL_FC_EXCHANGE(4)
+  ICE_VEL_FC_EXCHANGE(5)
+  ICE_VEL_FC_EXCHANGE(6)
+  ICE_VEL_FC_EXCHANGE(7)
+  ICE_VEL_FC_EXCHANGE(8)
+#undef ICE_VEL_FC_EXCHANGE
+  default: {
+    FastMatrix a(numMatls, numMatls);
+    add_vel_FC_exchange_cells(a, iter, adj_offset, K, delT, vol_frac_CC,
+                              sp_vol_CC, vel_FC, sp_vol_FC, vel_FCME);
+  }
+  }
+}
+
+template<class M, class V, class T> 
+void ICE::add_vel_FC_exchange_cells( M& a,
+                                     CellIterator iter,
+                                     IntVector adj_offset,
+                                     FastMatrix& K,
+                                     double delT,
+                                     StaticArray<constCCVariable<double> >& vol_frac_CC,
+                                     StaticArray<constCCVariable<double> >& sp_vol_CC,
+                                     V& vel_FC,
+                                     T& sp_vol_FC,
+                                     T& vel_FCME)        
+{
+  const int numMatls = a.numRows();
   double b[MAX_MATLS], b_sp_vol[MAX_MATLS];
   double vel[MAX_MATLS], tmp[MAX_MATLS];
-  FastMatrix a(numMatls, numMatls);
 
   for(;!iter.done(); iter++){
     IntVector c = *iter;
@@ -4834,6 +5165,101 @@ void ICE::computeLagrangian_Transported_Vars(const ProcessorGroup*,
   }  // patch loop
 }
 
+/* _____________________________________________________________________
+   Function~  ICE::addExchangeToMomentumAndEnergy_cells--
+   Purpose~   The cell loop of addExchangeToMomentumAndEnergy, for the
+   matrix type (FixedFastMatrix<N> or FastMatrix) of the number of
+   materials
+   _____________________________________________________________________*/
+template<class M>
+void ICE::addExchangeToMomentumAndEnergy_cells(M& beta,
+                                      M& a,
+                                      const Patch* patch,
+                                      double delT,
+                                      FastMatrix& K,
+                                      FastMatrix& H,
+                                      StaticArray<constCCVariable<double> >& vol_frac_CC,
+                                      StaticArray<constCCVariable<double> >& sp_vol_CC,
+                                      StaticArray<constCCVariable<double> >& mass_L,
+                                      StaticArray<CCVariable<double> >& cv,
+                                      StaticArray<CCVariable<Vector> >& vel_CC,
+                                      StaticArray<CCVariable<double> >& Temp_CC)
+{
+  const int numALLMatls = a.numRows();
+  double b[MAX_MATLS];
+  Vector bb[MAX_MATLS];
+  double tmp;
+
+  for(CellIterator iter = patch->getCellIterator(); !iter.done();iter++){
+    IntVector c = *iter;
+    //---------- M O M E N T U M   E X C H A N G E
+    //   Form BETA matrix (a), off diagonal terms
+    //   beta and (a) matrix are common to all momentum exchanges
+    for(int m = 0; m < numALLMatls; m++)  {
+      tmp = delT*sp_vol_CC[m][c];
+      for(int n = 0; n < numALLMatls; n++) {
+        beta(m,n) = vol_frac_CC[n][c]  * K(n,m) * tmp;
+        a(m,n) = -beta(m,n);
+      }
+    }
+    //   Form matrix (a) diagonal terms
+    for(int m = 0; m < numALLMatls; m++) {
+      a(m,m) = 1.0;
+      for(int n = 0; n < numALLMatls; n++) {
+        a(m,m) +=  beta(m,n);
+      }
+    }
+
+    for(int m = 0; m < numALLMatls; m++) {
+      Vector sum(0,0,0);
+      const Vector& vel_m = vel_CC[m][c];
+      for(int n = 0; n < numALLMatls; n++) {
+        sum += beta(m,n) *(vel_CC[n][c] - vel_m);
+      }
+      bb[m] = sum;
+    }
+
+    a.destructiveSolve(bb);
+
+    for(int m = 0; m < numALLMatls; m++) {
+      vel_CC[m][c] += bb[m];
+    }
+
+    //---------- E N E R G Y   E X C H A N G E   
+    if(d_exchCoeff->d_heatExchCoeffModel != "constant"){
+      getVariableExchangeCoefficients( K, H, c, mass_L);
+    }
+    for(int m = 0; m < numALLMatls; m++) {
+      tmp = delT*sp_vol_CC[m][c] / cv[m][c];
+      for(int n = 0; n < numALLMatls; n++)  {
+        beta(m,n) = vol_frac_CC[n][c] * H(n,m)*tmp;
+        a(m,n) = -beta(m,n);
+      }
+    }  
+
+    //   Form matrix (a) diagonal terms
+    for(int m = 0; m < numALLMatls; m++) {
+      a(m,m) = 1.;
+      for(int n = 0; n < numALLMatls; n++)   {
+        a(m,m) +=  beta(m,n);
+      }
+    }
+    // -  F O R M   R H S   (b)
+    for(int m = 0; m < numALLMatls; m++)  {
+      b[m] = 0.0;
+
+      for(int n = 0; n < numALLMatls; n++) {
+        b[m] += beta(m,n) * (Temp_CC[n][c] - Temp_CC[m][c]);
+      }
+    }
+    //     S O L V E, Add exchange contribution to orig value
+    a.destructiveSolve(b);
+    for(int m = 0; m < numALLMatls; m++) {
+      Temp_CC[m][c] = Temp_CC[m][c] + b[m];
+    }
+  }  //end CellIterator loop
+}
+
 /*_____________________________________________________________________
   Function~  ICE::addExchangeToMomentumAndEnergy--
   This task adds the  exchange contribution to the 
@@ -4903,16 +5329,10 @@ void ICE::addExchangeToMomentumAndEnergy(const ProcessorGroup*,
     StaticArray<constCCVariable<double> > mass_L(numALLMatls);
     StaticArray<constCCVariable<double> > old_temp(numALLMatls);
 
-    double b[MAX_MATLS];
-    Vector bb[MAX_MATLS];
-    vector<double> sp_vol(numALLMatls);
-
-    double tmp;
-    FastMatrix beta(numALLMatls, numALLMatls),acopy(numALLMatls, numALLMatls);
+    FastMatrix beta(numALLMatls, numALLMatls);
     FastMatrix K(numALLMatls, numALLMatls), H(numALLMatls, numALLMatls);
     FastMatrix a(numALLMatls, numALLMatls);
     beta.zero();
-    acopy.zero();
     K.zero();
     H.zero();
     a.zero();
@@ -4980,74 +5400,30 @@ void ICE::addExchangeToMomentumAndEnergy(const ProcessorGroup*,
       }
     }
 
-    for(CellIterator iter = patch->getCellIterator(); !iter.done();iter++){
-      IntVector c = *iter;
-      //---------- M O M E N T U M   E X C H A N G E
-      //   Form BETA matrix (a), off diagonal terms
-      //   beta and (a) matrix are common to all momentum exchanges
-      for(int m = 0; m < numALLMatls; m++)  {
-        tmp = delT*sp_vol_CC[m][c];
-        for(int n = 0; n < numALLMatls; n++) {
-          beta(m,n) = vol_frac_CC[n][c]  * K(n,m) * tmp;
-          a(m,n) = -beta(m,n);
-        }
-      }
-      //   Form matrix (a) diagonal terms
-      for(int m = 0; m < numALLMatls; m++) {
-        a(m,m) = 1.0;
-        for(int n = 0; n < numALLMatls; n++) {
-          a(m,m) +=  beta(m,n);
-        }
-      }
-
-      for(int m = 0; m < numALLMatls; m++) {
-        Vector sum(0,0,0);
-        const Vector& vel_m = vel_CC[m][c];
-        for(int n = 0; n < numALLMatls; n++) {
-          sum += beta(m,n) *(vel_CC[n][c] - vel_m);
-        }
-        bb[m] = sum;
-      }
-
-      a.destructiveSolve(bb);
-
-      for(int m = 0; m < numALLMatls; m++) {
-        vel_CC[m][c] += bb[m];
-      }
-
-      //---------- E N E R G Y   E X C H A N G E   
-      if(d_exchCoeff->d_heatExchCoeffModel != "constant"){
-        getVariableExchangeCoefficients( K, H, c, mass_L);
-      }
-      for(int m = 0; m < numALLMatls; m++) {
-        tmp = delT*sp_vol_CC[m][c] / cv[m][c];
-        for(int n = 0; n < numALLMatls; n++)  {
-          beta(m,n) = vol_frac_CC[n][c] * H(n,m)*tmp;
-          a(m,n) = -beta(m,n);
-        }
-      }  
-
-      //   Form matrix (a) diagonal terms
-      for(int m = 0; m < numALLMatls; m++) {
-        a(m,m) = 1.;
-        for(int n = 0; n < numALLMatls; n++)   {
-          a(m,m) +=  beta(m,n);
-        }
-      }
-      // -  F O R M   R H S   (b)
-      for(int m = 0; m < numALLMatls; m++)  {
-        b[m] = 0.0;
-
-        for(int n = 0; n < numALLMatls; n++) {
-          b[m] += beta(m,n) * (Temp_CC[n][c] - Temp_CC[m][c]);
-        }
-      }
-      //     S O L V E, Add exchange contribution to orig value
-      a.destructiveSolve(b);
-      for(int m = 0; m < numALLMatls; m++) {
-        Temp_CC[m][c] = Temp_CC[m][c] + b[m];
-      }
-    }  //end CellIterator loop
+    // The solver for the number of materials is picked once per patch;
+    // the cell loop is compiled for each size
+    switch (numALLMatls) {
+#define ICE_EXCHANGE_CC(N)                                              \
+    case N: {                                                           \
+      FixedFastMatrix<N> beta, a;                                       \
+      addExchangeToMomentumAndEnergy_cells(beta, a, patch, delT, K, H,  \
+                          vol_frac_CC, sp_vol_CC, mass_L, cv, vel_CC,   \
+                          Temp_CC);                                     \
+      break;                                                            \
+    }
+    ICE_EXCHANGE_CC(2)
+    ICE_EXCHANGE_CC(3)
+    ICE_EXCHANGE_CC(4)
+    ICE_EXCHANGE_CC(5)
+    ICE_EXCHANGE_CC(6)
+    ICE_EXCHANGE_CC(7)
+    ICE_EXCHANGE_CC(8)
+#undef ICE_EXCHANGE_CC
+    default:
+      addExchangeToMomentumAndEnergy_cells(beta, a, patch, delT, K, H,
+                          vol_frac_CC, sp_vol_CC, mass_L, cv, vel_CC,
+                          Temp_CC);
+    }
 
     if(d_exchCoeff->convective()){
       //  Loop over matls
@@ -5489,6 +5865,280 @@ void ICE::advectAndAdvanceInTime(const ProcessorGroup* /*pg*/,
     delete advector;
   }  // patch loop
 }
+/* _____________________________________________________________________ 
+   Function~  ICE::advectAndConvertToPrimitive--
+   Purpose~
+   advectAndAdvanceInTime and conservedtoPrimitive_Vars in one task
+   (<fused_advection>).  The advected increments of mass, momentum,
+   internal energy and sp_vol are kept in temporaries and a single sweep
+   over the rows of cells computes the time n+1 conserved quantities and,
+   from the values still in registers, the primitive quantities.  The
+   conserved quantities are not read back from the DataWarehouse.
+   _____________________________________________________________________  */
+void ICE::advectAndConvertToPrimitive(const ProcessorGroup* /*pg*/,
+                                      const PatchSubset* patches,
+                                      const MaterialSubset* /*matls*/,
+                                      DataWarehouse* old_dw,
+                                      DataWarehouse* new_dw)
+{
+  const Level* level = getLevel(patches);
+  int L_indx = level->getIndex();
+
+  // the advection calculations care about the position of the old dw subcycle
+  double AMR_subCycleProgressVar = getSubCycleProgress(old_dw);
+
+  for(int p=0;p<patches->size();p++){
+    const Patch* patch = patches->get(p);
+
+    cout_doing << d_myworld->myrank() << " Doing Advect and Convert to Primitive on patch " 
+               << patch->getID() << "\t\t ICE \tL-" <<L_indx
+               << " progressVar " << AMR_subCycleProgressVar << endl;
+
+    delt_vartype delT;
+    old_dw->get(delT, d_sharedState->get_delt_label(),level);
+
+    bool newGrid = d_sharedState->isRegridTimestep();
+    Advector* advector = d_advector->clone(new_dw,patch,newGrid );
+
+    Vector dx = patch->dCell();
+    double invvol = 1.0/(dx.x()*dx.y()*dx.z());
+
+    CCVariable<double>  mass_advected, int_eng_advected, sp_vol_advected;
+    CCVariable<Vector>  mom_advected;
+    CCVariable<double>  q_advected, cv_new;
+    new_dw->allocateTemporary(mass_advected,    patch);
+    new_dw->allocateTemporary(mom_advected,     patch);
+    new_dw->allocateTemporary(int_eng_advected, patch);
+    new_dw->allocateTemporary(sp_vol_advected,  patch);
+    new_dw->allocateTemporary(q_advected,       patch);
+    new_dw->allocateTemporary(cv_new,           patch);
+    mass_advected.initialize(0.0);
+    mom_advected.initialize(Vector(0.0,0.0,0.0));
+    int_eng_advected.initialize(0.0);
+    sp_vol_advected.initialize(0.0);
+    q_advected.initialize(0.0);
+
+    int numMatls = d_sharedState->getNumICEMatls();
+
+    for (int m = 0; m < numMatls; m++ ) {
+      Material* matl = d_sharedState->getICEMaterial( m );
+      int indx = matl->getDWIndex(); 
+
+      CCVariable<double> mass_adv, int_eng_adv, sp_vol_adv;
+      CCVariable<Vector> mom_adv;
+      CCVariable<double> rho_CC, temp_CC, sp_vol_CC, mach;
+      CCVariable<Vector> vel_CC;
+      constCCVariable<double> int_eng_L_ME, mass_L,sp_vol_L;
+      constCCVariable<double> speedSound, cv, gamma, vol_frac;
+      constCCVariable<Vector> mom_L_ME;
+      constSFCXVariable<double > uvel_FC;
+      constSFCYVariable<double > vvel_FC;
+      constSFCZVariable<double > wvel_FC;
+
+      Ghost::GhostType  gac = Ghost::AroundCells;
+      Ghost::GhostType  gn  = Ghost::None;
+      new_dw->get(uvel_FC,     lb->uvel_FCMELabel,        indx,patch,gac,2);  
+      new_dw->get(vvel_FC,     lb->vvel_FCMELabel,        indx,patch,gac,2);  
+      new_dw->get(wvel_FC,     lb->wvel_FCMELabel,        indx,patch,gac,2);  
+
+      new_dw->get(mass_L,      lb->mass_L_CCLabel,        indx,patch,gac,2);
+      new_dw->get(mom_L_ME,    lb->mom_L_ME_CCLabel,      indx,patch,gac,2);
+      new_dw->get(sp_vol_L,    lb->sp_vol_L_CCLabel,      indx,patch,gac,2);
+      new_dw->get(int_eng_L_ME,lb->eng_L_ME_CCLabel,      indx,patch,gac,2);
+
+      new_dw->get(gamma,       lb->gammaLabel,            indx,patch,gn,0);
+      new_dw->get(speedSound,  lb->speedSound_CCLabel,    indx,patch,gn,0);
+      new_dw->get(vol_frac,    lb->vol_frac_CCLabel,      indx,patch,gn,0);
+      new_dw->get(cv,          lb->specific_heatLabel,    indx,patch,gn,0);
+
+      new_dw->allocateAndPut(mass_adv,    lb->mass_advLabel,   indx,patch);          
+      new_dw->allocateAndPut(mom_adv,     lb->mom_advLabel,    indx,patch);
+      new_dw->allocateAndPut(int_eng_adv, lb->eng_advLabel,    indx,patch); 
+      new_dw->allocateAndPut(sp_vol_adv,  lb->sp_vol_advLabel, indx,patch); 
+
+      new_dw->getModifiable(sp_vol_CC, lb->sp_vol_CCLabel,indx,patch);
+      new_dw->getModifiable(rho_CC,    lb->rho_CCLabel,   indx,patch);
+
+      new_dw->allocateAndPut(temp_CC,lb->temp_CCLabel,  indx,patch);          
+      new_dw->allocateAndPut(vel_CC, lb->vel_CCLabel,   indx,patch);
+      new_dw->allocateAndPut(mach,   lb->machLabel,     indx,patch);  
+
+      mass_adv.initialize(0.0);
+      mom_adv.initialize(Vector(0.0,0.0,0.0));
+      int_eng_adv.initialize(0.0);
+      sp_vol_adv.initialize(0.0);
+      rho_CC.initialize(-d_EVIL_NUM);
+      temp_CC.initialize(-d_EVIL_NUM);
+      vel_CC.initialize(Vector(0.0,0.0,0.0)); 
+
+      //__________________________________
+      // common variables that get passed into the advection operators
+      advectVarBasket* varBasket = scinew advectVarBasket();
+      varBasket->new_dw = new_dw;
+      varBasket->old_dw = old_dw;
+      varBasket->indx = indx;
+      varBasket->patch = patch;
+      varBasket->level = level;
+      varBasket->lb  = lb;
+      varBasket->doRefluxing = d_doRefluxing;
+      varBasket->useCompatibleFluxes = d_useCompatibleFluxes;
+      varBasket->AMR_subCycleProgressVar = AMR_subCycleProgressVar;
+
+      //__________________________________
+      //   Advection preprocessing
+      bool bulletProof_test=true;
+      advector->inFluxOutFluxVolume(uvel_FC,vvel_FC,wvel_FC,delT,patch,indx,
+                                    bulletProof_test, new_dw); 
+      //__________________________________
+      // mass, momentum, internal energy, sp_vol[m] * mass
+      advector->advectMass(mass_L, mass_advected,  varBasket);
+
+      varBasket->is_Q_massSpecific = true;
+      varBasket->desc = "mom";
+      advector->advectQ(mom_L_ME,     mass_L, mom_advected,     varBasket);
+
+      varBasket->desc = "int_eng";
+      advector->advectQ(int_eng_L_ME, mass_L, int_eng_advected, varBasket);
+
+      varBasket->desc = "sp_vol";
+      advector->advectQ(sp_vol_L,     mass_L, sp_vol_advected,  varBasket); 
+
+      //__________________________________
+      // Advect model variables, before the specific heat
+      // which a model may compute from them
+      if(d_models.size() > 0 && d_modelSetup->tvars.size() > 0){
+        vector<TransportedVariable*>::iterator t_iter;
+        for( t_iter  = d_modelSetup->tvars.begin();
+             t_iter != d_modelSetup->tvars.end(); t_iter++){
+          TransportedVariable* tvar = *t_iter;
+
+          if(tvar->matls->contains(indx)){
+            string Labelname = tvar->var->getName();
+            CCVariable<double> q_adv, q_CC;
+            constCCVariable<double> q_L_CC;
+            new_dw->allocateAndPut(q_adv, tvar->var_adv,     indx, patch);
+            new_dw->allocateAndPut(q_CC,  tvar->var,         indx, patch);
+            new_dw->get(q_L_CC,   tvar->var_Lagrangian, indx, patch, gac, 2); 
+            q_adv.initialize(d_EVIL_NUM);
+            q_CC.initialize(0.0);
+
+            varBasket->desc = Labelname;
+            varBasket->is_Q_massSpecific = true;
+            advector->advectQ(q_L_CC,mass_L,q_advected, varBasket);  
+
+            for(CellIterator iter = patch->getCellIterator(); !iter.done();  iter++){
+              IntVector c = *iter;
+              double q = q_L_CC[c] + q_advected[c];
+              q_adv[c] = q;
+              q_CC[c]  = q/(mass_L[c] + mass_advected[c]);
+            }
+
+            //  Set Boundary Conditions
+            setBC(q_CC, Labelname,  patch, d_sharedState, indx, new_dw);  
+
+            //---- P R I N T   D A T A ------   
+            if (switchDebug_advance_advect ) {
+              ostringstream desc;
+              desc <<"BOT_advectAndConvertToPrimitive_Mat_" <<indx<<"_patch_"
+                   <<patch->getID();
+              string Lag_labelName = tvar->var_Lagrangian->getName();
+              printData(indx, patch,1, desc.str(), Lag_labelName, q_L_CC);
+              printData(indx, patch,1, desc.str(), Labelname,     q_CC);
+            }    
+          }
+        }
+      } 
+
+      //__________________________________
+      // A model *can* compute the specific heat
+      cv_new.copyData(cv);
+
+      if(d_models.size() != 0){
+        for(vector<ModelInterface*>::iterator iter = d_models.begin();
+            iter != d_models.end(); iter++){ 
+          ModelInterface* model = *iter;
+          if(model->computesThermoTransportProps() ) {
+            model->computeSpecificHeat(cv_new, patch, new_dw, indx);
+          }
+        }
+      }
+
+      //__________________________________
+      // Time n+1 conserved quantities and the primitive
+      // quantities backed out of them, one row of cells at a time
+      IntVector l = patch->getCellLowIndex();
+      IntVector h = patch->getCellHighIndex();
+      int nx = h.x() - l.x();
+
+      for(int z = l.z(); z < h.z(); z++){
+        for(int y = l.y(); y < h.y(); y++){
+          IntVector row(l.x(), y, z);
+          const double* mass_L_row  = &mass_L[row];
+          const Vector* mom_L_row   = &mom_L_ME[row];
+          const double* eng_L_row   = &int_eng_L_ME[row];
+          const double* spv_L_row   = &sp_vol_L[row];
+          const double* dmass_row   = &mass_advected[row];
+          const Vector* dmom_row    = &mom_advected[row];
+          const double* deng_row    = &int_eng_advected[row];
+          const double* dspv_row    = &sp_vol_advected[row];
+          const double* cv_row      = &cv_new[row];
+          double* mass_adv_row      = &mass_adv[row];
+          Vector* mom_adv_row       = &mom_adv[row];
+          double* eng_adv_row       = &int_eng_adv[row];
+          double* spv_adv_row       = &sp_vol_adv[row];
+          double* rho_row           = &rho_CC[row];
+          Vector* vel_row           = &vel_CC[row];
+          double* spv_row           = &sp_vol_CC[row];
+          double* temp_row          = &temp_CC[row];
+
+          for(int i = 0; i < nx; i++){
+            double mass    = mass_L_row[i] + dmass_row[i];
+            Vector mom     = mom_L_row[i]  + dmom_row[i];
+            double int_eng = eng_L_row[i]  + deng_row[i];
+            double sp_vol  = spv_L_row[i]  + dspv_row[i];
+
+            mass_adv_row[i] = mass;
+            mom_adv_row[i]  = mom;
+            eng_adv_row[i]  = int_eng;
+            spv_adv_row[i]  = sp_vol;
+
+            double inv_mass = 1.0/mass;
+            rho_row[i]  = mass * invvol;
+            vel_row[i]  = mom    * inv_mass;
+            spv_row[i]  = sp_vol * inv_mass;
+            temp_row[i] = int_eng/ (mass*cv_row[i]);
+          }
+        }
+      }
+
+      delete varBasket;
+
+      //__________________________________
+      // set the boundary conditions, compute Auxilary quantities
+      primitiveVarsBCs(old_dw, new_dw, patch, indx, rho_CC, temp_CC,
+                       sp_vol_CC, vel_CC, mach, gamma, cv, speedSound,
+                       vol_frac);
+
+      //---- P R I N T   D A T A ------   
+      if (switchDebug_advance_advect || switchDebug_conserved_primitive) {
+        ostringstream desc;
+        desc <<"BOT_advectAndConvertToPrimitive_Mat_" <<indx<<"_patch_"<<patch->getID();
+        printData(   indx, patch,1, desc.str(), "mass_adv",    mass_adv);
+        printVector( indx, patch,1, desc.str(), "mom_adv", 0,  mom_adv); 
+        printData(   indx, patch,1, desc.str(), "sp_vol_adv",  sp_vol_adv);
+        printData(   indx, patch,1, desc.str(), "int_eng_adv", int_eng_adv);
+        printData(   indx, patch,1, desc.str(), "rho_CC",      rho_CC);
+        printData(   indx, patch,1, desc.str(), "temp_CC",     temp_CC);
+        printData(   indx, patch,1, desc.str(), "sp_vol_CC",   sp_vol_CC);
+        printVector( indx, patch,1, desc.str(), "vel_CC", 0,   vel_CC);
+      }
+      //____ B U L L E T   P R O O F I N G----
+      checkPrimitiveVars(new_dw, "advectAndConvertToPrimitive", L_indx, indx,
+                         rho_CC, temp_CC, sp_vol_CC);
+    }  // ice_matls loop
+    delete advector;
+  }  // patch loop
+}
 /* _____________________________________________________________________ 
    Function~  ICE::conservedtoPrimitive_Vars
    Purpose~ This task computes the primitive variables (rho,T,vel,sp_vol,...)
@@ -5521,7 +6171,7 @@ void ICE::conservedtoPrimitive_Vars(const ProcessorGroup* /*pg*/,
       CCVariable<double> rho_CC, temp_CC, sp_vol_CC,mach;
       CCVariable<Vector> vel_CC;
       constCCVariable<double> int_eng_adv, mass_adv,sp_vol_adv,speedSound, cv;
-      constCCVariable<double> gamma, placeHolder, vol_frac;
+      constCCVariable<double> gamma, vol_frac;
       constCCVariable<Vector> mom_adv;
 
       new_dw->get(gamma,       lb->gammaLabel,         indx,patch,gn,0);
@@ -5617,28 +6267,10 @@ void ICE::conservedtoPrimitive_Vars(const ProcessorGroup* /*pg*/,
       }
 
       //__________________________________
-      // set the boundary conditions
-      preprocess_CustomBCs("Advection",old_dw, new_dw, lb,  patch, indx,
-                           d_customBC_var_basket);
-
-      setBC(rho_CC, "Density",  placeHolder, placeHolder,
-            patch,d_sharedState, indx, new_dw, d_customBC_var_basket);
-      setBC(vel_CC, "Velocity", 
-            patch,d_sharedState, indx, new_dw, d_customBC_var_basket);       
-      setBC(temp_CC,"Temperature",gamma, cv,
-            patch,d_sharedState, indx, new_dw, d_customBC_var_basket);
-
-      setSpecificVolBC(sp_vol_CC, "SpecificVol", false,rho_CC,vol_frac,
-                       patch,d_sharedState, indx);     
-      delete_CustomBCs(d_customBC_var_basket);
-
-      //__________________________________
-      // Compute Auxilary quantities
-      for(CellIterator iter = patch->getExtraCellIterator();
-          !iter.done(); iter++){
-        IntVector c = *iter;
-        mach[c]  = vel_CC[c].length()/speedSound[c];
-      }
+      // set the boundary conditions, compute Auxilary quantities
+      primitiveVarsBCs(old_dw, new_dw, patch, indx, rho_CC, temp_CC,
+                       sp_vol_CC, vel_CC, mach, gamma, cv, speedSound,
+                       vol_frac);
       //---- P R I N T   D A T A ------   
       if (switchDebug_conserved_primitive ) {
         ostringstream desc;
@@ -5653,27 +6285,85 @@ void ICE::conservedtoPrimitive_Vars(const ProcessorGroup* /*pg*/,
         printVector( indx, patch,1, desc.str(), "vel_CC", 0,   vel_CC);
       }
       //____ B U L L E T   P R O O F I N G----
-      // ignore BP if timestep restart has already been requested
-      IntVector neg_cell;
-      bool tsr = new_dw->timestepRestarted();
-
-      ostringstream base, warn;
-      base <<"ERROR ICE:(L-"<<L_indx<<"):conservedtoPrimitive_Vars, mat "<< indx <<" cell ";
-      if (!areAllValuesPositive(rho_CC, neg_cell) && !tsr) {
-        warn << base.str() << neg_cell << " negative rho_CC\n ";
-        throw InvalidValue(warn.str(), __FILE__, __LINE__);
-      }
-      if (!areAllValuesPositive(temp_CC, neg_cell) && !tsr) {
-        warn << base.str() << neg_cell << " negative temp_CC\n ";
-        throw InvalidValue(warn.str(), __FILE__, __LINE__);
-      }
-      if (!areAllValuesPositive(sp_vol_CC, neg_cell) && !tsr) {
-        warn << base.str() << neg_cell << " negative sp_vol_CC\n ";        
-        throw InvalidValue(warn.str(), __FILE__, __LINE__);
-      } 
+      checkPrimitiveVars(new_dw, "conservedtoPrimitive_Vars", L_indx, indx,
+                         rho_CC, temp_CC, sp_vol_CC);
     }  // ice_matls loop
   }  // patch loop
 }
+/* _____________________________________________________________________ 
+   Function~  ICE::primitiveVarsBCs
+   Purpose~ Set the boundary conditions of the primitive variables at
+   time n+1 and compute the mach number
+   _____________________________________________________________________  */
+void ICE::primitiveVarsBCs(DataWarehouse* old_dw,
+                           DataWarehouse* new_dw,
+                           const Patch* patch,
+                           const int indx,
+                           CCVariable<double>& rho_CC,
+                           CCVariable<double>& temp_CC,
+                           CCVariable<double>& sp_vol_CC,
+                           CCVariable<Vector>& vel_CC,
+                           CCVariable<double>& mach,
+                           constCCVariable<double>& gamma,
+                           constCCVariable<double>& cv,
+                           constCCVariable<double>& speedSound,
+                           constCCVariable<double>& vol_frac)
+{
+  constCCVariable<double> placeHolder;
+
+  preprocess_CustomBCs("Advection",old_dw, new_dw, lb,  patch, indx,
+                       d_customBC_var_basket);
+
+  setBC(rho_CC, "Density",  placeHolder, placeHolder,
+        patch,d_sharedState, indx, new_dw, d_customBC_var_basket);
+  setBC(vel_CC, "Velocity", 
+        patch,d_sharedState, indx, new_dw, d_customBC_var_basket);       
+  setBC(temp_CC,"Temperature",gamma, cv,
+        patch,d_sharedState, indx, new_dw, d_customBC_var_basket);
+
+  setSpecificVolBC(sp_vol_CC, "SpecificVol", false,rho_CC,vol_frac,
+                   patch,d_sharedState, indx);     
+  delete_CustomBCs(d_customBC_var_basket);
+
+  //__________________________________
+  // Compute Auxilary quantities
+  for(CellIterator iter = patch->getExtraCellIterator();
+      !iter.done(); iter++){
+    IntVector c = *iter;
+    mach[c]  = vel_CC[c].length()/speedSound[c];
+  }
+}
+/* _____________________________________________________________________ 
+   Function~  ICE::checkPrimitiveVars
+   Purpose~ Throw if rho, temp or sp_vol at time n+1 are not positive
+   _____________________________________________________________________  */
+void ICE::checkPrimitiveVars(DataWarehouse* new_dw,
+                             const string& taskName,
+                             const int L_indx,
+                             const int indx,
+                             CCVariable<double>& rho_CC,
+                             CCVariable<double>& temp_CC,
+                             CCVariable<double>& sp_vol_CC)
+{
+  // ignore BP if timestep restart has already been requested
+  IntVector neg_cell;
+  bool tsr = new_dw->timestepRestarted();
+
+  ostringstream base, warn;
+  base <<"ERROR ICE:(L-"<<L_indx<<"):"<<taskName<<", mat "<< indx <<" cell ";
+  if (!areAllValuesPositive(rho_CC, neg_cell) && !tsr) {
+    warn << base.str() << neg_cell << " negative rho_CC\n ";
+    throw InvalidValue(warn.str(), __FILE__, __LINE__);
+  }
+  if (!areAllValuesPositive(temp_CC, neg_cell) && !tsr) {
+    warn << base.str() << neg_cell << " negative temp_CC\n ";
+    throw InvalidValue(warn.str(), __FILE__, __LINE__);
+  }
+  if (!areAllValuesPositive(sp_vol_CC, neg_cell) && !tsr) {
+    warn << base.str() << neg_cell << " negative sp_vol_CC\n ";        
+    throw InvalidValue(warn.str(), __FILE__, __LINE__);
+  } 
+}
 /*_______________________________________________________________________
   Function:  TestConservation--
   Purpose:   Test for conservation of mass, momentum, energy.   
@@ -394,6 +394,20 @@ namespace Uintah {
                                       const MaterialSubset* matls,
                                       DataWarehouse*, 
                                       DataWarehouse*);
+
+    int computeEquilibrationPressureBatch(const Patch* patch,
+                                   int L_indx,
+                                   double convergence_crit,
+                                   DataWarehouse* new_dw,
+                                   StaticArray<constCCVariable<double> >& Temp,
+                                   StaticArray<constCCVariable<double> >& rho_CC,
+                                   StaticArray<constCCVariable<double> >& cv,
+                                   StaticArray<constCCVariable<double> >& gamma,
+                                   StaticArray<CCVariable<double> >& rho_micro,
+                                   StaticArray<CCVariable<double> >& vol_frac,
+                                   StaticArray<CCVariable<double> >& speedSound_new,
+                                   CCVariable<double>& press_new,
+                                   CCVariable<int>& n_iters_equil_press);
                                         
     void computeEquilPressure_1_matl(const ProcessorGroup*,  
                                      const PatchSubset* patches,
@@ -456,6 +470,18 @@ namespace Uintah {
                               V & vel_FC,
                               T & sp_vol_FC,
                               T & vel_FCME);
+
+    template<class M, class V, class T>
+    void add_vel_FC_exchange_cells( M & a,
+                                    CellIterator it,
+                                    IntVector adj_offset,
+                                    FastMatrix & K,
+                                    double delT,
+                                    StaticArray<constCCVariable<double> >& vol_frac_CC,
+                                    StaticArray<constCCVariable<double> >& sp_vol_CC,
+                                    V & vel_FC,
+                                    T & sp_vol_FC,
+                                    T & vel_FCME);
                                     
 
     void addExchangeContributionToFCVel(const ProcessorGroup*, 
@@ -520,6 +546,20 @@ namespace Uintah {
                                         DataWarehouse*,
                                         DataWarehouse*); 
 
+    template<class M>
+    void addExchangeToMomentumAndEnergy_cells(M & beta,
+                                      M & a,
+                                      const Patch* patch,
+                                      double delT,
+                                      FastMatrix & K,
+                                      FastMatrix & H,
+                                      StaticArray<constCCVariable<double> >& vol_frac_CC,
+                                      StaticArray<constCCVariable<double> >& sp_vol_CC,
+                                      StaticArray<constCCVariable<double> >& mass_L,
+                                      StaticArray<CCVariable<double> >& cv,
+                                      StaticArray<CCVariable<Vector> >& vel_CC,
+                                      StaticArray<CCVariable<double> >& Temp_CC);
+
     template< class V, class T>
     void update_q_CC(const std::string& desc,
                      CCVariable<T>& q_CC,
@@ -547,6 +587,34 @@ namespace Uintah {
                                    DataWarehouse* old_dw,
                                    DataWarehouse* new_dw);
 
+    void advectAndConvertToPrimitive(const ProcessorGroup*,
+                                     const PatchSubset* patches,
+                                     const MaterialSubset*,
+                                     DataWarehouse* old_dw,
+                                     DataWarehouse* new_dw);
+
+    void primitiveVarsBCs(DataWarehouse* old_dw,
+                          DataWarehouse* new_dw,
+                          const Patch* patch,
+                          const int indx,
+                          CCVariable<double>& rho_CC,
+                          CCVariable<double>& temp_CC,
+                          CCVariable<double>& sp_vol_CC,
+                          CCVariable<Vector>& vel_CC,
+                          CCVariable<double>& mach,
+                          constCCVariable<double>& gamma,
+                          constCCVariable<double>& cv,
+                          constCCVariable<double>& speedSound,
+                          constCCVariable<double>& vol_frac);
+
+    void checkPrimitiveVars(DataWarehouse* new_dw,
+                            const string& taskName,
+                            const int L_indx,
+                            const int indx,
+                            CCVariable<double>& rho_CC,
+                            CCVariable<double>& temp_CC,
+                            CCVariable<double>& sp_vol_CC);
+
                                   
 //__________________________________
 //   RF TASKS    
@@ -866,6 +934,8 @@ namespace Uintah {
     bool d_with_rigid_mpm;
       
     int d_max_iter_equilibration;
+    bool d_batchEquilibration;    // block-wise equilibration pressure solve
+    bool d_fusedAdvection;        // advection and conserved->primitive in one task
     int d_max_iter_implicit;
     int d_iters_before_timestep_restart;
     double d_outer_iter_tolerance;
@@ -45,8 +45,11 @@
 #include <Core/Util/FancyAssert.h>
 #include <Core/Util/DebugStream.h>
 
+#include <cstring>
 #include <iostream> // debug only
+#include <map>
 #include <stack>
+#include <string>
 #include <vector>
 
 using namespace Uintah;
@@ -62,6 +65,41 @@ static DebugStream lbout( "LBOut", false );
 
 double lbtimes[5] = {0,0,0,0,0};
 
+namespace {
+
+  // Splits the patches in curve order into pieces whose costs are in
+  // proportion to the weights: the next piece starts at the first patch
+  // whose midpoint lies past the end of the current piece's share
+  void splitCurve( const vector<int>    & order,
+                   const vector<double> & costs,
+                   const vector<double> & weights,
+                         vector<int>    & pieces )
+  {
+    double total_cost = 0, total_weight = 0;
+    for (size_t i = 0; i < order.size(); i++) {
+      total_cost += costs[order[i]];
+    }
+    for (size_t w = 0; w < weights.size(); w++) {
+      total_weight += weights[w];
+    }
+
+    pieces.resize(order.size());
+    int piece = 0;
+    double cost = 0;
+    double end = total_cost*weights[0]/total_weight;
+    for (size_t i = 0; i < order.size(); i++) {
+      double patch_cost = costs[order[i]];
+      while (piece < (int) weights.size() - 1 && cost + 0.5*patch_cost > end) {
+        piece++;
+        end += total_cost*weights[piece]/total_weight;
+      }
+      pieces[i] = piece;
+      cost += patch_cost;
+    }
+  }
+
+}
+
 DynamicLoadBalancer::DynamicLoadBalancer( const ProcessorGroup * myworld ) :
   LoadBalancerCommon(myworld), d_costForecaster(0)
 {
@@ -1028,6 +1066,9 @@ DynamicLoadBalancer::possiblyDynamicallyReallocate( const GridP & grid, int stat
         case random_lb :
           dynamicAllocate = assignPatchesRandom(grid, force);
           break;
+        case hierarchical_lb :
+          dynamicAllocate = assignPatchesHierarchical(grid, force);
+          break;
       }
     }
     else  //regridder has called dynamic load balancer so we must dynamically Allocate
@@ -1084,6 +1125,10 @@ DynamicLoadBalancer::possiblyDynamicallyReallocate( const GridP & grid, int stat
   
   // this must be called here (it creates the new per-proc patch sets) even if DLB does nothing.  Don't move or return earlier.
   LoadBalancerCommon::possiblyDynamicallyReallocate(grid, flag);
+
+  if (d_dynamicAlgorithm == hierarchical_lb && flag == LoadBalancer::regrid) {
+    assignThreadGroups(grid);
+  }
   
   d_sharedState->loadbalancerTime += Time::currentSeconds() - start;
   return changed;
@@ -1091,9 +1136,33 @@ DynamicLoadBalancer::possiblyDynamicallyReallocate( const GridP & grid, int stat
 //______________________________________________________________________
 //
 void
+DynamicLoadBalancer::addContribution( DetailedTask * task, double cost )
+{
+  d_costForecaster->addContribution(task, cost);
+}
+//______________________________________________________________________
+//
+void
+DynamicLoadBalancer::addThreadContribution( int thread, double cost )
+{
+  // called by the scheduler under its load balancer lock
+  if (d_dynamicAlgorithm == hierarchical_lb) {
+    if (thread >= (int) d_threadTaskTimes.size()) {
+      d_threadTaskTimes.resize(thread + 1, 0);
+    }
+    d_threadTaskTimes[thread] += cost;
+  }
+}
+//______________________________________________________________________
+//
+void
 DynamicLoadBalancer::finalizeContributions( const GridP & grid )
 {
   d_costForecaster->finalizeContributions(grid);
+
+  if (d_dynamicAlgorithm == hierarchical_lb) {
+    reportImbalance();
+  }
 }
 
 //______________________________________________________________________
@@ -1175,10 +1244,14 @@ DynamicLoadBalancer::problemSetup( ProblemSpecP & pspec, GridP & grid,  Simulati
     d_dynamicAlgorithm = patch_factor_lb;
     d_collectParticles = true;
   }
+  else if (dynamicAlgo == "hierarchical") {
+    d_dynamicAlgorithm = hierarchical_lb;
+    findNodes();
+  }
   else {
     if (d_myworld->myrank() == 0) {
       cout << "Invalid Load Balancer Algorithm: " << dynamicAlgo
-        << "\nPlease select 'cyclic', 'random', 'patchFactor' (default), or 'patchFactorParticles'\n"
+        << "\nPlease select 'cyclic', 'random', 'patchFactor' (default), 'patchFactorParticles' or 'hierarchical'\n"
         << "\nUsing 'patchFactor' load balancer\n";
     }
     d_dynamicAlgorithm = patch_factor_lb;
@@ -1211,3 +1284,211 @@ DynamicLoadBalancer::problemSetup( ProblemSpecP & pspec, GridP & grid,  Simulati
     d_costForecaster->setMinPatchSize(mps);
   }
 }
+//______________________________________________________________________
+//
+void
+DynamicLoadBalancer::findNodes()
+{
+  int num_procs = d_myworld->size();
+  d_procNode.assign(num_procs, 0);
+  d_nodeProcs.clear();
+
+  if (!Uintah::Parallel::usingMPI()) {
+    d_nodeProcs.push_back(vector<int>(1, 0));
+    return;
+  }
+
+  char name[MPI_MAX_PROCESSOR_NAME];
+  memset(name, 0, MPI_MAX_PROCESSOR_NAME);
+  int length;
+  MPI_Get_processor_name(name, &length);
+
+  vector<char> names(num_procs*MPI_MAX_PROCESSOR_NAME);
+  MPI_Allgather(name, MPI_MAX_PROCESSOR_NAME, MPI_CHAR, &names[0], MPI_MAX_PROCESSOR_NAME, MPI_CHAR, d_myworld->getComm());
+
+  // nodes are numbered in the order of their first processor
+  map<string, int> nodes;
+  for (int p = 0; p < num_procs; p++) {
+    string node(&names[p*MPI_MAX_PROCESSOR_NAME], strnlen(&names[p*MPI_MAX_PROCESSOR_NAME], MPI_MAX_PROCESSOR_NAME));
+    map<string, int>::iterator iter = nodes.find(node);
+    if (iter == nodes.end()) {
+      iter = nodes.insert(make_pair(node, (int) d_nodeProcs.size())).first;
+      d_nodeProcs.push_back(vector<int>());
+    }
+    d_procNode[p] = iter->second;
+    d_nodeProcs[iter->second].push_back(p);
+  }
+
+  if (d_myworld->myrank() == 0) {
+    cout << "Hierarchical load balancing over " << d_nodeProcs.size() << " nodes" << endl;
+  }
+}
+//______________________________________________________________________
+//
+bool
+DynamicLoadBalancer::assignPatchesHierarchical( const GridP & grid, bool force )
+{
+  doing << d_myworld->myrank() << "   APH\n";
+  vector<vector<double> > patch_costs;
+  getCosts(grid.get_rep(), patch_costs);
+
+  int num_nodes = d_nodeProcs.size();
+  vector<double> node_weights(num_nodes);
+  for (int n = 0; n < num_nodes; n++) {
+    node_weights[n] = d_nodeProcs[n].size();
+  }
+
+  d_lastOrders.resize(grid->numLevels());
+  int level_offset = 0;
+  for (int l = 0; l < grid->numLevels(); l++) {
+    const LevelP& level = grid->getLevel(l);
+    int num_patches = level->numPatches();
+
+    vector<int>& order = d_lastOrders[l];
+    order.resize(num_patches);
+    if (d_doSpaceCurve) {
+      useSFC(level, &order[0]);
+    }
+    else {
+      for (int p = 0; p < num_patches; p++) {
+        order[p] = p;
+      }
+    }
+
+    // split the curve over the nodes
+    vector<int> nodes;
+    splitCurve(order, patch_costs[l], node_weights, nodes);
+    vector<vector<int> > node_orders(num_nodes);
+    for (int p = 0; p < num_patches; p++) {
+      node_orders[nodes[p]].push_back(order[p]);
+    }
+
+    // and the piece of each node over its processors
+    for (int n = 0; n < num_nodes; n++) {
+      vector<double> proc_weights(d_nodeProcs[n].size(), 1.0);
+      vector<int> procs;
+      splitCurve(node_orders[n], patch_costs[l], proc_weights, procs);
+      for (size_t p = 0; p < node_orders[n].size(); p++) {
+        d_tempAssignment[level_offset + node_orders[n][p]] = d_nodeProcs[n][procs[p]];
+      }
+    }
+    level_offset += num_patches;
+  }
+  d_lastCosts = patch_costs;
+
+  bool doLoadBalancing = force || thresholdExceeded(patch_costs);
+  return doLoadBalancing;
+}
+//______________________________________________________________________
+//
+void
+DynamicLoadBalancer::assignThreadGroups( const GridP & grid )
+{
+  d_threadGroups.clear();
+
+  // the worker threads of the threaded schedulers
+  int num_groups = Uintah::Parallel::getNumThreads() - 1;
+  if (num_groups < 2) {
+    return;
+  }
+
+  int me = d_myworld->myrank();
+  vector<double> weights(num_groups, 1.0);
+  int level_offset = 0;
+  for (int l = 0; l < grid->numLevels(); l++) {
+    const LevelP& level = grid->getLevel(l);
+    int num_patches = level->numPatches();
+
+    // the order and costs of the last assignment, unless the regridder
+    // has made the assignment
+    bool have_order = l < (int) d_lastOrders.size() && (int) d_lastOrders[l].size() == num_patches;
+    bool have_costs = l < (int) d_lastCosts.size()  && (int) d_lastCosts[l].size()  == num_patches;
+
+    vector<double> costs(num_patches);
+    vector<int> my_order;
+    for (int i = 0; i < num_patches; i++) {
+      costs[i] = have_costs ? d_lastCosts[l][i] : level->getPatch(i)->getNumCells();
+      int index = have_order ? d_lastOrders[l][i] : i;
+      if (d_processorAssignment[level_offset + index] == me) {
+        my_order.push_back(index);
+      }
+    }
+
+    vector<int> groups;
+    splitCurve(my_order, costs, weights, groups);
+    for (size_t i = 0; i < my_order.size(); i++) {
+      d_threadGroups[level->getPatch(my_order[i])->getID()] = groups[i];
+    }
+    level_offset += num_patches;
+  }
+}
+//______________________________________________________________________
+//
+int
+DynamicLoadBalancer::getPatchThreadGroup( const Patch * patch )
+{
+  map<int, int>::const_iterator iter = d_threadGroups.find(patch->getRealPatch()->getID());
+  if (iter == d_threadGroups.end()) {
+    return -1;
+  }
+  return iter->second;
+}
+//______________________________________________________________________
+//
+void
+DynamicLoadBalancer::reportImbalance()
+{
+  int num_procs = d_myworld->size();
+
+  // the worker threads run the tasks, or the main thread if there are none
+  int num_threads = max(Uintah::Parallel::getNumThreads() - 1, 1);
+  double proc_time = 0, max_thread_time = 0;
+  for (size_t t = 0; t < d_threadTaskTimes.size(); t++) {
+    proc_time += d_threadTaskTimes[t];
+    max_thread_time = max(max_thread_time, d_threadTaskTimes[t]);
+  }
+  d_threadTaskTimes.assign(d_threadTaskTimes.size(), 0);
+
+  double local[2] = { proc_time, 0 };
+  if (proc_time > 0) {
+    local[1] = max_thread_time/(proc_time/num_threads) - 1;
+  }
+
+  vector<double> all(2*num_procs);
+  if (num_procs > 1) {
+    MPI_Gather(local, 2, MPI_DOUBLE, &all[0], 2, MPI_DOUBLE, 0, d_myworld->getComm());
+  }
+  else {
+    all[0] = local[0];
+    all[1] = local[1];
+  }
+
+  if (d_myworld->myrank() != 0) {
+    return;
+  }
+
+  // imbalance is max/mean - 1, of the time per processor for the nodes
+  int num_nodes = d_nodeProcs.size();
+  vector<double> node_times(num_nodes, 0);
+  double total_time = 0, max_proc_time = 0, max_thread_imb = 0, mean_thread_imb = 0;
+  for (int p = 0; p < num_procs; p++) {
+    node_times[d_procNode[p]] += all[2*p];
+    total_time += all[2*p];
+    max_proc_time = max(max_proc_time, all[2*p]);
+    max_thread_imb = max(max_thread_imb, all[2*p + 1]);
+    mean_thread_imb += all[2*p + 1]/num_procs;
+  }
+  if (total_time == 0) {
+    return;
+  }
+
+  double max_node_time = 0;
+  for (int n = 0; n < num_nodes; n++) {
+    max_node_time = max(max_node_time, node_times[n]/d_nodeProcs[n].size());
+  }
+  double mean_time = total_time/num_procs;
+
+  cout << "Load imbalance: nodes " << max_node_time/mean_time - 1
+       << ", processors " << max_proc_time/mean_time - 1
+       << ", threads " << mean_thread_imb << " (max " << max_thread_imb << ")" << endl;
+}
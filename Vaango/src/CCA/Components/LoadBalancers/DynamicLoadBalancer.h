@@ -35,8 +35,10 @@
 
 #include <sci_defs/uintah_defs.h>
 
+#include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 namespace Uintah {
    /**************************************
@@ -94,7 +96,10 @@ namespace Uintah {
 
     // Cost profiling functions
     // Update the contribution for this patch.
-    virtual void addContribution( DetailedTask * task ,double cost ) { d_costForecaster->addContribution(task,cost); }
+    virtual void addContribution( DetailedTask * task ,double cost );
+
+    // Task time of a worker thread, for the thread imbalance (hierarchical algorithm)
+    virtual void addThreadContribution( int thread, double cost );
 
     // Finalize the contributions (updates the weight, should be called once per timestep):
     virtual void finalizeContributions( const GridP & currentGrid );
@@ -104,6 +109,9 @@ namespace Uintah {
 
     // Resets the profiler counters to zero
     virtual void resetCostForecaster() { d_costForecaster->reset(); }
+
+    // The worker thread group of a patch of this processor (hierarchical algorithm)
+    virtual int getPatchThreadGroup( const Patch * patch );
     
     // Helper for assignPatchesFactor.  Collects each patch's particles
     void collectParticles(const Grid* grid, std::vector<std::vector<int> >& num_particles);
@@ -124,7 +132,7 @@ namespace Uintah {
 
     std::vector<IntVector> d_minPatchSize;
     CostForecasterBase *d_costForecaster;
-    enum { static_lb, cyclic_lb, random_lb, patch_factor_lb };
+    enum { static_lb, cyclic_lb, random_lb, patch_factor_lb, hierarchical_lb };
 
     DynamicLoadBalancer(const DynamicLoadBalancer&);
     DynamicLoadBalancer& operator=(const DynamicLoadBalancer&);
@@ -136,6 +144,20 @@ namespace Uintah {
     bool assignPatchesRandom(const GridP& grid, bool force);
     bool assignPatchesCyclic(const GridP& grid, bool force);
 
+    /// The hierarchical algorithm splits the space filling curve of each level
+    /// into one piece per node (in proportion to its processors), then the
+    /// piece of a node into one piece per processor.  The patches of this
+    /// processor are split the same way into one group per worker thread.
+    bool assignPatchesHierarchical(const GridP& grid, bool force);
+    void assignThreadGroups(const GridP& grid);
+
+    /// Finds the processors that share a node (by processor name)
+    void findNodes();
+
+    /// Reports the node, processor and thread imbalance of the task times
+    /// of the last timestep
+    void reportImbalance();
+
     bool thresholdExceeded(const std::vector<std::vector<double> >& patch_costs);
 
     //Assign costs to a list of patches
@@ -159,6 +181,14 @@ namespace Uintah {
     int  d_dynamicAlgorithm;
     bool d_collectParticles;
 
+    // hierarchical algorithm
+    std::vector<int>                  d_procNode;        // node of each processor
+    std::vector<std::vector<int> >    d_nodeProcs;       // processors of each node
+    std::map<int, int>                d_threadGroups;    // patch ID -> worker thread
+    std::vector<std::vector<int> >    d_lastOrders;      // curve order of the last assignment
+    std::vector<std::vector<double> > d_lastCosts;       // costs of the last assignment
+    std::vector<double>               d_threadTaskTimes; // task time of each thread this timestep
+
   };
 } // End namespace Uintah
 
@@ -60,7 +60,7 @@ static DebugStream times( "LBTimes", false );
 static DebugStream lbout( "LBOut", false );
 
 ParticleLoadBalancer::ParticleLoadBalancer( const ProcessorGroup * myworld ) :
-  LoadBalancerCommon(myworld)
+  LoadBalancerCommon(myworld), d_taskTimesLock("ParticleLoadBalancer task times lock")
 {
   d_lbInterval = 0.0;
   d_lastLbTime = 0.0;
@@ -71,6 +71,13 @@ ParticleLoadBalancer::ParticleLoadBalancer( const ProcessorGroup * myworld ) :
 
   d_assignmentBasePatch = -1;
   d_oldAssignmentBasePatch = -1;
+
+  d_measuredCosts = false;
+  d_imbalanceThreshold = 0.0;
+  d_measuredTimesteps = 0;
+  d_meanParticleUnitCost = 0.0;
+  d_cellUnitCost = 0.0;
+  d_haveUnitCosts = false;
 }
 
 ParticleLoadBalancer::~ParticleLoadBalancer()
@@ -526,6 +533,19 @@ bool ParticleLoadBalancer::loadBalanceGrid(const GridP& grid, bool force)
 
   }
 
+  if(d_measuredCosts && d_measuredPatchCosts.size() == d_processorAssignment.size())
+  {
+    vector<double> predicted;
+    for(int l=0;l<grid->numLevels();l++)
+      for(size_t p=0;p<cellCosts[l].size();p++)
+        predicted.push_back(cellCosts[l][p]+particleCosts[l][p]);
+
+    proc0cout << "ParticleLoadBalancer: imbalance of the current assignment: measured "
+              << imbalance(d_measuredPatchCosts, d_processorAssignment)
+              << " predicted " << imbalance(predicted, d_processorAssignment)
+              << ", of the new assignment: predicted " << imbalance(predicted, d_tempAssignment) << endl;
+  }
+
   if(stats.active() && d_myworld->myrank()==0)
   {
     double cellImb, partImb;
@@ -648,6 +668,13 @@ double ParticleLoadBalancer::computePercentImprovement(const vector<vector<doubl
 bool ParticleLoadBalancer::thresholdExceeded(const vector<vector<double> >& cellCosts, const vector<vector<double> > & partCosts)
 {
 
+  // keep the current assignment while its measured imbalance is small
+  if(d_measuredCosts && d_measuredPatchCosts.size() == d_processorAssignment.size() &&
+     imbalance(d_measuredPatchCosts, d_processorAssignment) < d_imbalanceThreshold)
+  {
+    return false;
+  }
+
   double cellMax=0, cellAvg=0, partMax=0, partAvg=0;
   double cellImp=computePercentImprovement(cellCosts,cellAvg,cellMax);
   double partImp=computePercentImprovement(partCosts,partAvg,partMax);
@@ -718,6 +745,43 @@ void ParticleLoadBalancer::getCosts(const Grid* grid, vector<vector<double> >&pa
   DataWarehouse* olddw = d_scheduler->get_dw(0);
   bool on_regrid = olddw != 0 && grid != olddw->getGrid();
 
+  d_measuredPatchCosts.clear();
+  if(d_measuredCosts)
+  {
+    if(on_regrid)
+    {
+      //the measurements are for the patches of the old grid
+      d_taskTimes.clear();
+      d_measuredTimesteps=0;
+    }
+    else
+    {
+      vector<vector<vector<int> > > matl_particles;
+      collectParticlesPerMatl(grid, matl_particles);
+      fitMeasuredCosts(grid, matl_particles);
+
+      if(d_haveUnitCosts)
+      {
+        int numMatls = d_particleUnitCosts.size();
+        for (int l = 0; l < grid->numLevels(); l++)
+        {
+          LevelP level=grid->getLevel(l);
+          cell_costs.push_back(vector<double>());
+          particle_costs.push_back(vector<double>());
+          for (int p = 0; p < level->numPatches(); p++)
+          {
+            double particle_cost=0;
+            for (int m = 0; m < numMatls; m++)
+              particle_cost+=matl_particles[l][p][m]*d_particleUnitCosts[m];
+            cell_costs[l].push_back(level->getPatch(p)->getNumCells()*d_cellUnitCost);
+            particle_costs[l].push_back(particle_cost);
+          }
+        }
+        return;
+      }
+    }
+  }
+
   //collect the number of particles on each processor into num_particles
   if(on_regrid)
   {
@@ -745,8 +809,17 @@ void ParticleLoadBalancer::getCosts(const Grid* grid, vector<vector<double> >&pa
     particle_costs.push_back(vector<double>());
     for (int p = 0; p < grid->getLevel(l)->numPatches(); p++) 
     {
-      cell_costs[l].push_back(level->getPatch(p)->getNumCells()*d_cellCost);
-      particle_costs[l].push_back(num_particles[l][p]*d_particleCost);
+      if(d_measuredCosts && d_haveUnitCosts)
+      {
+        //the particles are not counted by material during a regrid
+        cell_costs[l].push_back(level->getPatch(p)->getNumCells()*d_cellUnitCost);
+        particle_costs[l].push_back(num_particles[l][p]*d_meanParticleUnitCost);
+      }
+      else
+      {
+        cell_costs[l].push_back(level->getPatch(p)->getNumCells()*d_cellCost);
+        particle_costs[l].push_back(num_particles[l][p]*d_particleCost);
+      }
     }
 #if 0
     if(d_myworld->myrank()==0)
@@ -885,6 +958,19 @@ ParticleLoadBalancer::problemSetup(ProblemSpecP& pspec, GridP& grid,  Simulation
    
   }
 
+  if (p != 0) {
+    string costAlgorithm = "Model";
+    p->get("costAlgorithm", costAlgorithm);
+    if (costAlgorithm == "Measured") {
+      d_measuredCosts = true;
+    }
+    else if (costAlgorithm != "Model") {
+      throw ProblemSetupException("ParticleLoadBalancer: costAlgorithm must be Model or Measured, not " + costAlgorithm,
+                                  __FILE__, __LINE__);
+    }
+    p->getWithDefault("imbalanceThreshold", d_imbalanceThreshold, 0.0);
+  }
+
   d_lbTimestepInterval = timestepInterval;
   d_doSpaceCurve = spaceCurve;
   d_lbThreshold = threshold;
@@ -897,3 +983,212 @@ ParticleLoadBalancer::problemSetup(ProblemSpecP& pspec, GridP& grid,  Simulation
   d_sfc.SetMergeParameters(3000,500,2,.15);  //Should do this by profiling
 }
 
+
+void
+ParticleLoadBalancer::addContribution(DetailedTask* task, double cost)
+{
+  // every scheduler calls this from MPIScheduler::runTask (or
+  // UnifiedScheduler::runTask), including the workers of ThreadedMPIScheduler
+  if (!d_measuredCosts) {
+    return;
+  }
+  const PatchSubset* patches = task->getPatches();
+  if (patches == 0 || patches->size() == 0) {
+    return;
+  }
+
+  // split the time evenly over the patches and materials of the task
+  const MaterialSubset* matls = task->getMaterials();
+  int numMatls = (matls == 0 || matls->size() == 0) ? 1 : matls->size();
+  double share = cost/(patches->size()*numMatls);
+  d_taskTimesLock.lock();
+  for (int p = 0; p < patches->size(); p++) {
+    int index = patches->get(p)->getRealPatch()->getGridIndex();
+    if (matls == 0 || matls->size() == 0) {
+      d_taskTimes[make_pair(index, -1)] += share;
+    }
+    else {
+      for (int m = 0; m < matls->size(); m++) {
+        d_taskTimes[make_pair(index, matls->get(m))] += share;
+      }
+    }
+  }
+  d_taskTimesLock.unlock();
+}
+
+void
+ParticleLoadBalancer::finalizeContributions(const GridP& /*currentGrid*/)
+{
+  if (d_measuredCosts) {
+    d_measuredTimesteps++;
+  }
+}
+
+void
+ParticleLoadBalancer::initializeWeights(const Grid* /*oldgrid*/, const Grid* /*newgrid*/)
+{
+  // the grid indices of the measured patches are no longer valid, the unit
+  // costs still are
+  d_taskTimes.clear();
+  d_measuredTimesteps = 0;
+}
+
+void
+ParticleLoadBalancer::resetCostForecaster()
+{
+  d_taskTimes.clear();
+  d_measuredTimesteps = 0;
+  d_haveUnitCosts = false;
+}
+
+void
+ParticleLoadBalancer::collectParticlesPerMatl(const Grid* grid, vector<vector<vector<int> > >& particles)
+{
+  int numMatls = d_sharedState->getNumMatls();
+  int num_patches = 0;
+  particles.resize(grid->numLevels());
+  for (int l = 0; l < grid->numLevels(); l++) {
+    int level_patches = grid->getLevel(l)->numPatches();
+    particles[l].assign(level_patches, vector<int>(numMatls, 0));
+    num_patches += level_patches;
+  }
+
+  DataWarehouse* dw = d_scheduler->get_dw(0);
+  if (d_processorAssignment.size() == 0 || dw == 0)
+    return;
+
+  // each patch is counted by its owner, the sum gives everyone all counts
+  vector<int> local(num_patches*numMatls, 0);
+  int myrank = d_myworld->myrank();
+  for (int l = 0; l < grid->numLevels(); l++) {
+    const LevelP& level = grid->getLevel(l);
+    for (Level::const_patchIterator iter = level->patchesBegin(); iter != level->patchesEnd(); iter++) {
+      const Patch* patch = *iter;
+      int id = patch->getGridIndex();
+      if (d_processorAssignment[id] != myrank)
+        continue;
+      for (int m = 0; m < numMatls; m++) {
+        if (dw->haveParticleSubset(m, patch))
+          local[id*numMatls + m] = dw->getParticleSubset(m, patch)->numParticles();
+      }
+    }
+  }
+
+  vector<int> all(local.size(), 0);
+  if (d_myworld->size() > 1) {
+    MPI_Allreduce(&local[0], &all[0], local.size(), MPI_INT, MPI_SUM, d_myworld->getComm());
+  }
+  else {
+    all.swap(local);
+  }
+
+  for (int l = 0, i = 0; l < grid->numLevels(); l++) {
+    for (int p = 0; p < grid->getLevel(l)->numPatches(); p++, i++) {
+      for (int m = 0; m < numMatls; m++) {
+        particles[l][p][m] = all[i*numMatls + m];
+      }
+    }
+  }
+}
+
+bool
+ParticleLoadBalancer::fitMeasuredCosts(const Grid* grid, vector<vector<vector<int> > >& matlParticles)
+{
+  // every processor has finalized the same number of timesteps
+  if (d_measuredTimesteps == 0) {
+    return false;
+  }
+
+  int numMatls = d_sharedState->getNumMatls();
+  int columns = numMatls + 1;  // the last one for tasks without materials
+  int num_patches = 0;
+  for (int l = 0; l < grid->numLevels(); l++)
+    num_patches += grid->getLevel(l)->numPatches();
+
+  // task time per timestep by patch and material
+  vector<double> local(num_patches*columns, 0);
+  for (map<pair<int, int>, double>::const_iterator iter = d_taskTimes.begin(); iter != d_taskTimes.end(); iter++) {
+    int index = iter->first.first;
+    int matl = iter->first.second;
+    if (index < 0 || index >= num_patches)
+      continue;
+    int column = (matl >= 0 && matl < numMatls) ? matl : numMatls;
+    local[index*columns + column] += iter->second/d_measuredTimesteps;
+  }
+  d_taskTimes.clear();
+  d_measuredTimesteps = 0;
+
+  vector<double> all(local.size(), 0);
+  if (d_myworld->size() > 1) {
+    MPI_Allreduce(&local[0], &all[0], local.size(), MPI_DOUBLE, MPI_SUM, d_myworld->getComm());
+  }
+  else {
+    all.swap(local);
+  }
+
+  // the materials without particles are part of the cell cost
+  vector<double> matlTimes(numMatls, 0), matlCounts(numMatls, 0);
+  double cellTime = 0, numCells = 0, totalTime = 0;
+  d_measuredPatchCosts.assign(num_patches, 0);
+  for (int l = 0, i = 0; l < grid->numLevels(); l++) {
+    const LevelP& level = grid->getLevel(l);
+    for (int p = 0; p < level->numPatches(); p++, i++) {
+      numCells += level->getPatch(p)->getNumCells();
+      for (int c = 0; c < columns; c++)
+        d_measuredPatchCosts[i] += all[i*columns + c];
+      cellTime += all[i*columns + numMatls];
+      for (int m = 0; m < numMatls; m++) {
+        matlTimes[m] += all[i*columns + m];
+        matlCounts[m] += matlParticles[l][p][m];
+      }
+      totalTime += d_measuredPatchCosts[i];
+    }
+  }
+  if (totalTime == 0) {
+    d_measuredPatchCosts.clear();
+    return false;
+  }
+
+  double particleTime = 0, numParticles = 0;
+  d_particleUnitCosts.assign(numMatls, 0);
+  for (int m = 0; m < numMatls; m++) {
+    if (matlCounts[m] > 0) {
+      d_particleUnitCosts[m] = matlTimes[m]/matlCounts[m];
+      particleTime += matlTimes[m];
+      numParticles += matlCounts[m];
+    }
+    else {
+      cellTime += matlTimes[m];
+    }
+  }
+  d_meanParticleUnitCost = numParticles > 0 ? particleTime/numParticles : 0;
+  d_cellUnitCost = numCells > 0 ? cellTime/numCells : 0;
+  d_haveUnitCosts = true;
+
+  if (stats.active() && d_myworld->myrank() == 0) {
+    stats << "ParticleLoadBalancer unit costs: cell " << d_cellUnitCost << " particle";
+    for (int m = 0; m < numMatls; m++)
+      stats << " " << d_particleUnitCosts[m];
+    stats << endl;
+  }
+  return true;
+}
+
+double
+ParticleLoadBalancer::imbalance(const vector<double>& patchCosts, const vector<int>& assignment)
+{
+  vector<double> procCosts(d_myworld->size(), 0);
+  for (size_t i = 0; i < patchCosts.size() && i < assignment.size(); i++)
+    procCosts[assignment[i]] += patchCosts[i];
+
+  double max = 0, avg = 0;
+  for (size_t p = 0; p < procCosts.size(); p++) {
+    if (procCosts[p] > max)
+      max = procCosts[p];
+    avg += procCosts[p];
+  }
+  avg /= procCosts.size();
+  if (avg == 0)
+    return 0;
+  return (max - avg)/avg;
+}
@@ -30,10 +30,13 @@
 #include <Core/Grid/Grid.h>
 #include <Core/Parallel/UintahParallelComponent.h>
 #include <Core/ProblemSpec/ProblemSpecP.h>
+#include <Core/Thread/Mutex.h>
 #include <sci_defs/uintah_defs.h>
 
+#include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 namespace Uintah {
    /**************************************
@@ -58,7 +61,17 @@ namespace Uintah {
        ParticleLoadBalancer
       
      DESCRIPTION
-       Long description...
+       Assigns the patches of each level along the space filling curve,
+       balancing the particle work and the cell work separately.
+
+       With <costAlgorithm>Measured</costAlgorithm> the costs are fitted
+       to the measured task execution times: the time of each task is split
+       over its patches and materials, and at every load balance check the
+       times since the last check give a cost per particle for each
+       material that has particles and a cost per cell for the rest.  A
+       patch full of particles with an expensive constitutive model thus
+       weighs more than one with a cheap model.  Until the first
+       measurements the fixed <particleCost> and <cellCost> are used.
       
      WARNING
       
@@ -89,6 +102,12 @@ namespace Uintah {
     //! Asks the load balancer if it is dynamic.
     virtual bool isDynamic() { return true; }
 
+    // Measured costs (<costAlgorithm>Measured)
+    virtual void addContribution(DetailedTask* task, double cost);
+    virtual void finalizeContributions(const GridP& currentGrid);
+    virtual void initializeWeights(const Grid* oldgrid, const Grid* newgrid);
+    virtual void resetCostForecaster();
+
     //Collects each patch's particles
     void collectParticles(const Grid* grid, std::vector<std::vector<int> >& num_particles);
     
@@ -134,6 +153,16 @@ namespace Uintah {
     //given the two cost arrays determine if the new load balance is better than the previous
     bool thresholdExceeded(const std::vector<std::vector<double> >& cellCosts, const std::vector<std::vector<double> >& particleCosts);
 
+    //fits the particle and cell unit costs to the measured task times and
+    //sets d_measuredPatchCosts, returns false if there are no measurements
+    bool fitMeasuredCosts(const Grid* grid, std::vector<std::vector<std::vector<int> > >& matlParticles);
+
+    //number of particles of each material on each patch
+    void collectParticlesPerMatl(const Grid* grid, std::vector<std::vector<std::vector<int> > >& particles);
+
+    //load imbalance (max - avg)/avg of the given costs (by grid index) for an assignment
+    double imbalance(const std::vector<double>& patchCosts, const std::vector<int>& assignment);
+
     int d_lbTimestepInterval;
     int d_lastLbTimestep;
     
@@ -145,6 +174,25 @@ namespace Uintah {
     // and d_cellCost is 1 then a particle has twice as much weight as a cell.
     double d_particleCost,d_cellCost; 
 
+    bool d_measuredCosts;        //< fit the costs to the task times
+    double d_imbalanceThreshold; //< measured imbalance below which the load balance is kept
+
+    // Task times (seconds) of my patches by (grid index, material) since the
+    // last fit, material -1 for tasks without materials.  The worker threads
+    // of the threaded schedulers and the subschedulers (which have their own
+    // load balancer locks) add to it at the same time, hence the lock.
+    std::map<std::pair<int, int>, double> d_taskTimes;
+    Mutex d_taskTimesLock;
+    int d_measuredTimesteps;
+
+    // The fitted costs (seconds per timestep) of a particle of each material
+    // and of a cell, and the measured cost of each patch by grid index
+    std::vector<double> d_particleUnitCosts;
+    double d_meanParticleUnitCost;
+    double d_cellUnitCost;
+    bool d_haveUnitCosts;
+    std::vector<double> d_measuredPatchCosts;
+
   };
 
 } // End namespace Uintah
@@ -51,6 +51,7 @@
 #include <Core/Grid/AMR.h>
 #include <Core/Grid/Grid.h>
 #include <Core/Grid/Level.h>
+#include <Core/Grid/ParticleInterpolationCache.h>
 #include <Core/Grid/Patch.h>
 #include <Core/Grid/SimulationState.h>
 #include <Core/Grid/Task.h>
@@ -1750,8 +1751,7 @@ void AMRMPM::interpolateParticlesToGrid(const ProcessorGroup*,
 
     int numMatls = d_sharedState->getNumMPMMatls();
     ParticleInterpolator* interpolator = flags->d_interpolator->clone(patch);
-    vector<IntVector> ni(interpolator->size());
-    vector<double> S(interpolator->size());
+    ParticleInterpolationCache block;
 
 #ifdef CBDI_FLUXBCS
     LinearInterpolator* LPI;
@@ -1844,13 +1844,16 @@ void AMRMPM::interpolateParticlesToGrid(const ProcessorGroup*,
       Vector pmom;
       int n8or27=flags->d_8or27;
 
+      int ip = 0;
       for (ParticleSubset::iterator iter  = pset->begin();
-           iter != pset->end(); iter++){
+           iter != pset->end(); iter++, ip++){
         particleIndex idx = *iter;
 
         // Get the node indices that surround the cell
-        interpolator->findCellAndWeights(px[idx],ni,S,psize[idx],
-                                         pDefGrad[idx]);
+        int row = block.fillBlock(interpolator, pset, ip, px, psize, pDefGrad,
+                                  false);
+        const IntVector* ni = block.nodes(row);
+        const double*    S  = block.weights(row);
 
         pmom = pvelocity[idx]*pmass[idx];
 
@@ -2581,18 +2584,20 @@ void AMRMPM::computeInternalForce(const ProcessorGroup*,
       Matrix3 stressvol;
       Matrix3 stresspress;
       int n8or27 = flags->d_8or27;
-      vector<IntVector> ni(interpolator->size());
-      vector<double> S(interpolator->size());
-      vector<Vector> d_S(interpolator->size());
+      ParticleInterpolationCache block;
     
 
+      int ip = 0;
       for (ParticleSubset::iterator iter  = pset->begin();
-           iter != pset->end();  iter++){
+           iter != pset->end();  iter++, ip++){
         particleIndex idx = *iter;
   
         // Get the node indices that surround the cell
-        interpolator->findCellAndWeightsAndShapeDerivatives(px[idx], ni, S, d_S,
-                                                            psize[idx],pDefGrad[idx]);
+        int row = block.fillBlock(interpolator, pset, ip, px, psize, pDefGrad,
+                                  true);
+        const IntVector* ni  = block.nodes(row);
+        const double*    S   = block.weights(row);
+        const Vector*    d_S = block.gradients(row);
 
         stresspress = pstress[idx] + Id*(/*p_pressure*/-p_q[idx]);
 
@@ -3175,9 +3180,7 @@ void AMRMPM::interpolateToParticlesAndUpdate(const ProcessorGroup*,
               "Doing AMRMPM::interpolateToParticlesAndUpdate");
 
     ParticleInterpolator* interpolator = flags->d_interpolator->clone(patch);
-    vector<IntVector> ni(interpolator->size());
-    vector<double> S(interpolator->size());
-    vector<Vector> d_S(interpolator->size());
+    ParticleInterpolationCache block;
     //Vector dx = patch->dCell();
 
     // Performs the interpolation from the cell vertices of the grid
@@ -3282,12 +3285,15 @@ void AMRMPM::interpolateToParticlesAndUpdate(const ProcessorGroup*,
       }
 
       // Loop over particles
+      int ip = 0;
       for(ParticleSubset::iterator iter = pset->begin();
-          iter != pset->end(); iter++){
+          iter != pset->end(); iter++, ip++){
         particleIndex idx = *iter;
 
         // Get the node indices that surround the cell
-        interpolator->findCellAndWeights(px[idx],ni,S,psize[idx],pFOld[idx]);
+        int row = block.fillBlock(interpolator, pset, ip, px, psize, pFOld, false);
+        const IntVector* ni = block.nodes(row);
+        const double*    S  = block.weights(row);
 
         Vector vel(0.0,0.0,0.0);
         Vector acc(0.0,0.0,0.0);
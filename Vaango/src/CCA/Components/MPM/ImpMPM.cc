@@ -52,6 +52,7 @@
 #include <Core/Grid/AMR.h>
 #include <Core/Grid/Variables/PerPatch.h>
 #include <Core/Grid/Level.h>
+#include <Core/Grid/ParticleInterpolationCache.h>
 #include <Core/Grid/Variables/CCVariable.h>
 #include <Core/Grid/Variables/NCVariable.h>
 #include <Core/Grid/Variables/ParticleVariable.h>
@@ -2135,8 +2136,7 @@ void ImpMPM::interpolateParticlesToGrid(const ProcessorGroup*,
 
     ParticleInterpolator* interpolator = flags->d_interpolator->clone(patch);
     int i_size = interpolator->size();
-    vector<IntVector> ni(i_size);
-    vector<double> S(i_size);
+    ParticleInterpolationCache block;
 
  
     NCVariable<double> gmassglobal,gvolumeglobal;
@@ -2260,12 +2260,16 @@ void ImpMPM::interpolateParticlesToGrid(const ProcessorGroup*,
 
       double Cp=mpm_matl->getSpecificHeat();
 
+      int ip = 0;
       for(ParticleSubset::iterator iter = pset->begin();
-          iter != pset->end(); iter++){
+          iter != pset->end(); iter++, ip++){
         particleIndex idx = *iter;
 
         // Get the node indices that surround the cell
-        interpolator->findCellAndWeights(px[idx], ni, S, psize[idx],pDeformationMeasure[idx]);
+        int row = block.fillBlock(interpolator, pset, ip, px, psize,
+                                  pDeformationMeasure, false);
+        const IntVector* ni = block.nodes(row);
+        const double*    S  = block.weights(row);
 
         pmassacc    = pacceleration[idx]*pmass[idx];
         pmom        = pvelocity[idx]*pmass[idx];
@@ -2363,6 +2367,7 @@ void ImpMPM::interpolateParticlesToGrid(const ProcessorGroup*,
 
 
         
+        vector<double> S(interpolator->size());
         for (ParticleSubset::iterator iter = pset->begin(); iter < pset->end();
              iter++) {
           vector<IntVector> ni_cell(interpolator->size());
@@ -3007,8 +3012,7 @@ void ImpMPM::computeInternalForce(const ProcessorGroup*,
     printTask(patches, patch,cout_doing,"Doing ImpMPM::computeInternalForce");
     
     ParticleInterpolator* interpolator = flags->d_interpolator->clone(patch);
-    vector<IntVector> ni(interpolator->size());
-    vector<Vector> d_S(interpolator->size());
+    ParticleInterpolationCache block;
 
 
     Vector dx = patch->dCell();
@@ -3055,13 +3059,16 @@ void ImpMPM::computeInternalForce(const ProcessorGroup*,
 
         Matrix3 stressvol;
 
+        int ip = 0;
         for(ParticleSubset::iterator iter = pset->begin();
-            iter != pset->end(); iter++){
+            iter != pset->end(); iter++, ip++){
           particleIndex idx = *iter;
 
           // Get the node indices that surround the cell
-          interpolator->findCellAndShapeDerivatives(px[idx],ni,d_S,psize[idx],
-                                                    pDeformationMeasure[idx]);
+          int row = block.fillBlock(interpolator, pset, ip, px, psize,
+                                    pDeformationMeasure, true);
+          const IntVector* ni  = block.nodes(row);
+          const Vector*    d_S = block.gradients(row);
 
           stressvol  = pstress[idx]*pvol[idx];
 
@@ -3526,9 +3533,7 @@ void ImpMPM::interpolateToParticlesAndUpdate(const ProcessorGroup*,
     Ghost::GhostType  gac = Ghost::AroundCells;
 
     ParticleInterpolator* interpolator = flags->d_interpolator->clone(patch);
-    vector<IntVector> ni(interpolator->size());
-    vector<double> S(interpolator->size());
-    vector<Vector> d_S(interpolator->size());
+    ParticleInterpolationCache block;
  
     // Performs the interpolation from the cell vertices of the grid
     // acceleration and displacement to the particles to update their
@@ -3616,13 +3621,16 @@ void ImpMPM::interpolateToParticlesAndUpdate(const ProcessorGroup*,
       old_dw->get(delT, d_sharedState->get_delt_label(), getLevel(patches) );
       double Cp=mpm_matl->getSpecificHeat();
 
+      int ip = 0;
       for(ParticleSubset::iterator iter = pset->begin();
-          iter != pset->end(); iter++){
+          iter != pset->end(); iter++, ip++){
         particleIndex idx = *iter;
 
         // Get the node indices that surround the cell
-        interpolator->findCellAndWeightsAndShapeDerivatives(px[idx],ni,S,d_S,
-                                           psize[idx],pDeformationMeasure[idx]);
+        int row = block.fillBlock(interpolator, pset, ip, px, psize,
+                                  pDeformationMeasure, false);
+        const IntVector* ni  = block.nodes(row);
+        const double*    S   = block.weights(row);
 
         disp = Vector(0.0,0.0,0.0);
         acc = Vector(0.0,0.0,0.0);
@@ -3711,9 +3719,7 @@ void ImpMPM::interpolateStressToGrid(const ProcessorGroup*,
     printTask(patches, patch,cout_doing,"Doing ImpMPM::interpolateStressToGrid");
 
     ParticleInterpolator* interpolator = flags->d_interpolator->clone(patch);
-    vector<IntVector> ni(interpolator->size());
-    vector<double> S(interpolator->size());
-    vector<Vector> d_S(interpolator->size());
+    ParticleInterpolationCache block;
 
  
     // This task is done for visualization only
@@ -3771,13 +3777,17 @@ void ImpMPM::interpolateStressToGrid(const ProcessorGroup*,
 
        Matrix3 stressvol;
 
+       int ip = 0;
        for(ParticleSubset::iterator iter = pset->begin();
-          iter != pset->end(); iter++){
+          iter != pset->end(); iter++, ip++){
         particleIndex idx = *iter;
 
         // Get the node indices that surround the cell
-        interpolator->findCellAndWeightsAndShapeDerivatives(
-                                                   px[idx],ni,S,d_S,psize[idx],pDeformationMeasure[idx]);
+        int row = block.fillBlock(interpolator, pset, ip, px, psize,
+                                  pDeformationMeasure, true);
+        const IntVector* ni  = block.nodes(row);
+        const double*    S   = block.weights(row);
+        const Vector*    d_S = block.gradients(row);
 
         stressvol  = pstress[idx]*pvol[idx];
 
@@ -53,6 +53,7 @@ MPMFlags::MPMFlags(const ProcessorGroup* myworld)
   d_integrator_type = "explicit";
   d_integrator = Explicit;
   d_axisymmetric = false;
+  d_cacheInterpolationWeights = false;
 
   d_artificial_viscosity = false;
   d_artificial_viscosity_heating = false;
@@ -208,6 +209,7 @@ MPMFlags::readMPMFlags(ProblemSpecP& ps, Output* dataArchive)
   mpm_flag_ps->get("interpolator", d_interpolator_type);
   mpm_flag_ps->getWithDefault("cpdi_lcrit", d_cpdi_lcrit, 1.e10);
   mpm_flag_ps->get("axisymmetric", d_axisymmetric);
+  mpm_flag_ps->get("cache_interpolation_weights", d_cacheInterpolationWeights);
   mpm_flag_ps->get("withColor",  d_with_color);
   mpm_flag_ps->get("artificial_damping_coeff", d_artificialDampCoeff);
   mpm_flag_ps->get("artificial_viscosity",     d_artificial_viscosity);
@@ -454,6 +456,7 @@ MPMFlags::readMPMFlags(ProblemSpecP& ps, Output* dataArchive)
     dbg << "---------------------------------------------------------\n";
     dbg << " Time Integration            = " << d_integrator_type << endl;
     dbg << " Interpolation type          = " << d_interpolator_type << endl;
+    dbg << " Cache interpolation weights = " << d_cacheInterpolationWeights << endl;
     dbg << " With Color                  = " << d_with_color << endl;
     dbg << " Artificial Damping Coeff    = " << d_artificialDampCoeff << endl;
     dbg << " Artificial Viscosity On     = " << d_artificial_viscosity<< endl;
@@ -483,6 +486,7 @@ MPMFlags::outputProblemSpec(ProblemSpecP& ps)
 
   ps->appendElement("interpolator", d_interpolator_type);
   ps->appendElement("cpdi_lcrit", d_cpdi_lcrit);
+  ps->appendElement("cache_interpolation_weights", d_cacheInterpolationWeights);
   ps->appendElement("AMR", d_AMR);
   ps->appendElement("axisymmetric", d_axisymmetric);
   ps->appendElement("withColor",  d_with_color);
@@ -60,6 +60,8 @@ namespace Uintah {
     double      d_cpdi_lcrit;        // for cpdi interpolator maximum fractional 
                                      // cell size for a particle
     bool        d_axisymmetric;  // Use axisymmetric?
+    bool        d_cacheInterpolationWeights; // Compute shape functions once
+                                             // per patch per timestep
     std::string d_integrator_type; // Explicit or implicit time integration
     IntegratorType d_integrator;
 
@@ -51,6 +51,8 @@
 #include <Core/Grid/AMR.h>
 #include <Core/Grid/Grid.h>
 #include <Core/Grid/Level.h>
+#include <Core/Grid/LinearInterpolator.h>
+#include <Core/Grid/ParticleInterpolationCache.h>
 #include <Core/Grid/Patch.h>
 #include <Core/Grid/SimulationState.h>
 #include <Core/Grid/Task.h>
@@ -72,6 +74,7 @@
 #include <Core/Math/CubicPolyRoots.h>
 #include <Core/Util/DebugStream.h>
 #include <Core/Thread/Mutex.h>
+#include <Core/Thread/Time.h>
 
 #include <iostream>
 #include <fstream>
@@ -98,11 +101,35 @@ static DebugStream cout_convert("MPMConv", false);
 static DebugStream cout_heat("MPMHeat", false);
 static DebugStream amr_doing("AMRMPM", false);
 static DebugStream cout_damage("Damage", false);
+static DebugStream cout_interp("MPMInterpTiming", false);
 
 // From ThreadPool.cc:  Used for syncing cerr'ing so it is easier to read.
 extern Mutex cerrLock;
 
 
+//______________________________________________________________________
+//  Cohesive zones are interpolated with a fixed size and no deformation.
+//  Spread those over the subset so that the weights can be computed in
+//  blocks through ParticleInterpolationCache::fillBlock.
+static void getCohesiveZoneSize(DataWarehouse* new_dw, ParticleSubset* pset,
+                                constParticleVariable<Matrix3>& czsize,
+                                constParticleVariable<Matrix3>& czdefgrad)
+{
+  Matrix3 size(0.1,0.,0.,0.,0.1,0.,0.,0.,0.1);
+  Matrix3 defgrad;
+  defgrad.Identity();
+
+  ParticleVariable<Matrix3> czsize_create, czdefgrad_create;
+  new_dw->allocateTemporary(czsize_create,    pset);
+  new_dw->allocateTemporary(czdefgrad_create, pset);
+  for (auto iter = pset->begin(); iter != pset->end(); iter++) {
+    czsize_create[*iter]    = size;
+    czdefgrad_create[*iter] = defgrad;
+  }
+  czsize    = czsize_create;     // reference created data
+  czdefgrad = czdefgrad_create;  // reference created data
+}
+
 static Vector face_norm(Patch::FaceType f)
 {
   switch(f) { 
@@ -1271,6 +1298,9 @@ SerialMPM::scheduleTimeAdvance(const LevelP & level,
   scheduleComputeParticleBodyForce(       sched, patches, matls);
 
   scheduleApplyExternalLoads(             sched, patches, matls);
+  if(flags->d_cacheInterpolationWeights){
+    scheduleComputeInterpolationWeights(  sched, patches, matls);
+  }
   scheduleInterpolateParticlesToGrid(     sched, patches, matls);
 
   scheduleExMomInterpolated(              sched, patches, matls);
@@ -1843,6 +1873,130 @@ SerialMPM::applyExternalLoads(const ProcessorGroup* ,
   }  // patch loop
 }
 
+/*!----------------------------------------------------------------------
+ * scheduleComputeInterpolationWeights
+ *   in(P.X, P.SIZE, P.DEFGRAD)
+ *   operation(evaluate the shape functions and their gradients for
+ *             every particle in the ghosted particle subset)
+ *   out(P.INTERPOLATIONCACHE)
+ *-----------------------------------------------------------------------*/
+void 
+SerialMPM::scheduleComputeInterpolationWeights(SchedulerP& sched,
+                                               const PatchSet* patches,
+                                               const MaterialSet* matls)
+{
+  if (!flags->doMPMOnLevel(getLevel(patches)->getIndex(), 
+                           getLevel(patches)->getGrid()->numLevels()))
+    return;
+    
+  printSchedule(patches,cout_doing,"MPM::scheduleComputeInterpolationWeights");
+
+  // The cache is local to this timestep: don't copy it to a new grid
+  // after regridding and don't checkpoint it.
+  sched->overrideVariableBehavior("p.interpolationCache", 
+                                  false, false, false, true, true); 
+  
+  Task* t = scinew Task("MPM::computeInterpolationWeights",
+                        this,&SerialMPM::computeInterpolationWeights);
+  Ghost::GhostType  gan = Ghost::AroundNodes;
+  t->requires(Task::OldDW, lb->pXLabel,       gan,NGP);
+  t->requires(Task::OldDW, lb->pSizeLabel,    gan,NGP);
+  t->requires(Task::OldDW, lb->pDefGradLabel, gan,NGP);
+
+  t->computes(lb->pInterpolationCacheLabel);
+  
+  sched->addTask(t, patches, matls);
+}
+
+/*!----------------------------------------------------------------------
+ * computeInterpolationWeights
+ *-----------------------------------------------------------------------*/
+void 
+SerialMPM::computeInterpolationWeights(const ProcessorGroup*,
+                                       const PatchSubset* patches,
+                                       const MaterialSubset* ,
+                                       DataWarehouse* old_dw,
+                                       DataWarehouse* new_dw)
+{
+  for(int p=0;p<patches->size();p++){
+    const Patch* patch = patches->get(p);
+
+    printTask(patches,patch,cout_doing,"Doing computeInterpolationWeights");
+
+    int numMatls = d_sharedState->getNumMPMMatls();
+    ParticleInterpolator* interpolator = flags->d_interpolator->clone(patch); 
+
+    Ghost::GhostType  gan = Ghost::AroundNodes;
+    for(int m = 0; m < numMatls; m++){
+      MPMMaterial* mpm_matl = d_sharedState->getMPMMaterial( m );
+      int dwi = mpm_matl->getDWIndex();
+
+      constParticleVariable<Point>   px;
+      constParticleVariable<Matrix3> psize;
+      constParticleVariable<Matrix3> pFOld;
+
+      ParticleSubset* pset = old_dw->getParticleSubset(dwi, patch,
+                                                       gan, NGP, lb->pXLabel);
+
+      old_dw->get(px,    lb->pXLabel,       pset);
+      old_dw->get(psize, lb->pSizeLabel,    pset);
+      old_dw->get(pFOld, lb->pDefGradLabel, pset);
+
+      double start = Time::currentSeconds();
+
+      // Uses the fixed-size batch kernels for the common interpolators and
+      // the virtual per-particle interface for the rest
+      ParticleInterpolationCache* cache = scinew ParticleInterpolationCache();
+      bool batched = cache->fill(interpolator, pset->begin(), pset->end(),
+                                 px, psize, pFOld, true);
+      cache->computeTime = Time::currentSeconds() - start;
+
+      if (cout_interp.active()) {
+        cerrLock.lock();
+        cout_interp << "patch " << patch->getID() << " matl " << dwi
+                    << ": cached weights for " << cache->numParticles
+                    << " particles in " << cache->computeTime << " s"
+                    << (batched ? " (batch)" : "") << endl;
+        cerrLock.unlock();
+      }
+
+      PerPatch<ParticleInterpolationCacheP> cacheVar;
+      cacheVar.get() = cache;
+      new_dw->put(cacheVar, lb->pInterpolationCacheLabel, dwi, patch);
+    }  // End loop over materials
+
+    delete interpolator;
+  }  // End loop over patches
+}
+
+/*!----------------------------------------------------------------------
+ * getInterpolationCache
+ *   Returns the cached weights for this patch and material or null
+ *   if caching is turned off.  The cache must have been computed from
+ *   a particle subset identical to pset.
+ *-----------------------------------------------------------------------*/
+const ParticleInterpolationCache*
+SerialMPM::getInterpolationCache(DataWarehouse* new_dw,
+                                 const Patch* patch,
+                                 int dwi,
+                                 ParticleSubset* pset)
+{
+  if (!flags->d_cacheInterpolationWeights) {
+    return 0;
+  }
+
+  PerPatch<ParticleInterpolationCacheP> cacheVar;
+  new_dw->get(cacheVar, lb->pInterpolationCacheLabel, dwi, patch);
+  const ParticleInterpolationCache* cache = cacheVar.get().get_rep();
+  if (!cache || cache->numParticles != static_cast<int>(pset->numParticles())) {
+    ostringstream msg;
+    msg << "MPM: interpolation cache for patch " << patch->getID()
+        << " matl " << dwi << " does not match the particle subset";
+    throw InternalError(msg.str(), __FILE__, __LINE__);
+  }
+  return cache;
+}
+
 /*!----------------------------------------------------------------------
  * scheduleInterpolateParticlesToGrid
  * interpolateParticlesToGrid
@@ -1874,6 +2028,9 @@ SerialMPM::scheduleInterpolateParticlesToGrid(SchedulerP& sched,
   t->requires(Task::OldDW, lb->pTemperatureLabel,      gan,NGP);
   t->requires(Task::OldDW, lb->pSizeLabel,             gan,NGP);
   t->requires(Task::OldDW, lb->pDefGradLabel,gan,NGP);
+  if (flags->d_cacheInterpolationWeights) {
+    t->requires(Task::NewDW, lb->pInterpolationCacheLabel, Ghost::None);
+  }
   if (flags->d_useCBDI) {
     t->requires(Task::NewDW,  lb->pExternalForceCorner1Label,gan,NGP);
     t->requires(Task::NewDW,  lb->pExternalForceCorner2Label,gan,NGP);
@@ -1925,10 +2082,9 @@ SerialMPM::interpolateParticlesToGrid(const ProcessorGroup*,
 
     int numMatls = d_sharedState->getNumMPMMatls();
     ParticleInterpolator* interpolator = flags->d_interpolator->clone(patch); 
-    ParticleInterpolator* linear_interpolator=scinew LinearInterpolator(patch);
+    LinearInterpolator* linear_interpolator=scinew LinearInterpolator(patch);
 
-    vector<IntVector> ni(interpolator->size());
-    vector<double> S(interpolator->size());
+    ParticleInterpolationCache block;
     string interp_type = flags->d_interpolator_type;
 
     NCVariable<double> gmassglobal,gtempglobal,gvolumeglobal;
@@ -1984,6 +2140,9 @@ SerialMPM::interpolateParticlesToGrid(const ProcessorGroup*,
                     lb->pExternalForceCorner4Label, pset);
         old_dw->get(pLoadCurveID, lb->pLoadCurveIDLabel, pset);
       }
+      const ParticleInterpolationCache* cache =
+        getInterpolationCache(new_dw, patch, dwi, pset);
+
       // Create arrays for the grid data
       NCVariable<double> gmass;
       NCVariable<double> gvolume;
@@ -2031,10 +2190,20 @@ SerialMPM::interpolateParticlesToGrid(const ProcessorGroup*,
       int n8or27=flags->d_8or27;
       double pSp_vol = 1./mpm_matl->getInitialDensity();
 
+      double start = Time::currentSeconds();
+
       //loop over all particles in the patch:
-      for (auto iter = pset->begin(); iter != pset->end(); iter++) {
+      int ip = 0;
+      for (auto iter = pset->begin(); iter != pset->end(); iter++, ip++) {
         particleIndex idx = *iter;
-        interpolator->findCellAndWeights(px[idx], ni, S, psize[idx], pFOld[idx]);
+        const ParticleInterpolationCache* weights = cache;
+        int row = ip;
+        if (!cache) {
+          weights = &block;
+          row = block.fillBlock(interpolator, pset, ip, px, psize, pFOld, false);
+        }
+        const IntVector* pni = weights->nodes(row);
+        const double*    pS  = weights->weights(row);
         pmom = pVelocity[idx]*pmass[idx];
         total_mom += pmom;
 
@@ -2043,30 +2212,25 @@ SerialMPM::interpolateParticlesToGrid(const ProcessorGroup*,
         IntVector node;
         for(int k = 0; k < n8or27; k++) { // Iterates through the nodes which 
                                           // receive information from the current particle
-          node = ni[k];
+          node = pni[k];
           if(patch->containsNode(node)) {
-            gmass[node]          += pmass[idx]                     * S[k];
-            gvelocity[node]      += pmom                           * S[k];
-            gvolume[node]        += pvolume[idx]                   * S[k];
+            gmass[node]          += pmass[idx]                     * pS[k];
+            gvelocity[node]      += pmom                           * pS[k];
+            gvolume[node]        += pvolume[idx]                   * pS[k];
             if (!flags->d_useCBDI) {
-              gexternalforce[node] += pexternalforce[idx]          * S[k];
+              gexternalforce[node] += pexternalforce[idx]          * pS[k];
             }
-            gBodyForce[node]     += pBodyForceAcc[idx] * pmass[idx] * S[k];
-            gTemperature[node]   += pTemperature[idx]  * pmass[idx] * S[k];
-            gSp_vol[node]        += pSp_vol            * pmass[idx] * S[k];
+            gBodyForce[node]     += pBodyForceAcc[idx] * pmass[idx] * pS[k];
+            gTemperature[node]   += pTemperature[idx]  * pmass[idx] * pS[k];
+            gSp_vol[node]        += pSp_vol            * pmass[idx] * pS[k];
             //gnumnearparticles[node] += 1.0;
             //gexternalheatrate[node] += pexternalheatrate[idx]      * S[k];
           }
         }
         if (flags->d_useCBDI && pLoadCurveID[idx]>0) {
-          vector<IntVector> niCorner1(linear_interpolator->size());
-          vector<IntVector> niCorner2(linear_interpolator->size());
-          vector<IntVector> niCorner3(linear_interpolator->size());
-          vector<IntVector> niCorner4(linear_interpolator->size());
-          vector<double> SCorner1(linear_interpolator->size());
-          vector<double> SCorner2(linear_interpolator->size()); 
-          vector<double> SCorner3(linear_interpolator->size()); 
-          vector<double> SCorner4(linear_interpolator->size());
+          const int NC = LinearInterpolator::NUM_NODES;
+          IntVector niCorner1[NC], niCorner2[NC], niCorner3[NC], niCorner4[NC];
+          double SCorner1[NC], SCorner2[NC], SCorner3[NC], SCorner4[NC];
           linear_interpolator->findCellAndWeights(pExternalForceCorner1[idx],
                                                   niCorner1,SCorner1,psize[idx],pFOld[idx]);
           linear_interpolator->findCellAndWeights(pExternalForceCorner2[idx],
@@ -2075,7 +2239,7 @@ SerialMPM::interpolateParticlesToGrid(const ProcessorGroup*,
                                                   niCorner3,SCorner3,psize[idx],pFOld[idx]);
           linear_interpolator->findCellAndWeights(pExternalForceCorner4[idx],
                                                   niCorner4,SCorner4,psize[idx],pFOld[idx]);
-          for(int k = 0; k < 8; k++) { // Iterates through the nodes which receive information from the current particle
+          for(int k = 0; k < NC; k++) { // Iterates through the nodes which receive information from the current particle
             node = niCorner1[k];
             if(patch->containsNode(node)) {
               gexternalforce[node] += pexternalforce[idx] * SCorner1[k];
@@ -2095,6 +2259,16 @@ SerialMPM::interpolateParticlesToGrid(const ProcessorGroup*,
           }
         }
       } // End of particle loop
+
+      if (cout_interp.active()) {
+        cerrLock.lock();
+        cout_interp << "patch " << patch->getID() << " matl " << dwi
+                    << ": interpolateParticlesToGrid particle loop "
+                    << Time::currentSeconds() - start << " s"
+                    << (cache ? " (cached weights)" : "") << endl;
+        cerrLock.unlock();
+      }
+
       for (auto iter=patch->getExtraNodeIterator(); !iter.done();iter++) {
         IntVector c = *iter; 
         gmassglobal[c]    += gmass[c];
@@ -2223,8 +2397,7 @@ SerialMPM::updateCohesiveZones(const ProcessorGroup*,
               "Doing updateCohesiveZones");
 
     ParticleInterpolator* interpolator = flags->d_interpolator->clone(patch);
-    vector<IntVector> ni(interpolator->size());
-    vector<double> S(interpolator->size());
+    ParticleInterpolationCache block;
 
     delt_vartype delT;
     old_dw->get(delT, d_sharedState->get_delt_label(), getLevel(patches) );
@@ -2325,19 +2498,20 @@ SerialMPM::updateCohesiveZones(const ProcessorGroup*,
       // based on the example problem in that paper
       double r=0.;
 
+      constParticleVariable<Matrix3> czsize, czdefgrad;
+      getCohesiveZoneSize(new_dw, pset, czsize, czdefgrad);
+
       // Loop over particles
+      int ip = 0;
       for(ParticleSubset::iterator iter = pset->begin();
-          iter != pset->end(); iter++){
+          iter != pset->end(); iter++, ip++){
         particleIndex idx = *iter;
 
-        //        double length = sqrt(czlength[idx]);
-        //        Vector size(length,length,length);
-        Matrix3 size(0.1,0.,0.,0.,0.1,0.,0.,0.,0.1);
-        Matrix3 defgrad;
-        defgrad.Identity();
-
         // Get the node indices that surround the cell
-        interpolator->findCellAndWeights(czx[idx],ni,S,size,defgrad);
+        int row = block.fillBlock(interpolator, pset, ip, czx, czsize,
+                                  czdefgrad, false);
+        const IntVector* ni = block.nodes(row);
+        const double*    S  = block.weights(row);
 
         Vector velTop(0.0,0.0,0.0);
         Vector velBot(0.0,0.0,0.0);
@@ -2518,8 +2692,7 @@ SerialMPM::addCohesiveZoneForces(const ProcessorGroup*,
     printTask(patches,patch,cout_doing,"Doing addCohesiveZoneForces");
 
     ParticleInterpolator* interpolator = flags->d_interpolator->clone(patch);
-    vector<IntVector> ni(interpolator->size());
-    vector<double> S(interpolator->size());
+    ParticleInterpolationCache block;
 
     int numMPMMatls=d_sharedState->getNumMPMMatls();
     StaticArray<NCVariable<Vector> > gext_force(numMPMMatls);
@@ -2552,18 +2725,20 @@ SerialMPM::addCohesiveZoneForces(const ProcessorGroup*,
       new_dw->get(czTopMat,     lb->czTopMatLabel_preReloc,           pset);
       new_dw->get(czBotMat,     lb->czBotMatLabel_preReloc,           pset);
 
+      constParticleVariable<Matrix3> czsize, czdefgrad;
+      getCohesiveZoneSize(new_dw, pset, czsize, czdefgrad);
+
       // Loop over particles
+      int ip = 0;
       for(ParticleSubset::iterator iter = pset->begin();
-          iter != pset->end(); iter++){
+          iter != pset->end(); iter++, ip++){
         particleIndex idx = *iter;
 
-        //        double length = sqrt(czlength[idx]);
-        Matrix3 size(0.1,0.,0.,0.,0.1,0.,0.,0.,0.1);
-        Matrix3 defgrad;
-        defgrad.Identity();
-
         // Get the node indices that surround the cell
-        interpolator->findCellAndWeights(czx[idx],ni,S,size,defgrad);
+        int row = block.fillBlock(interpolator, pset, ip, czx, czsize,
+                                  czdefgrad, false);
+        const IntVector* ni = block.nodes(row);
+        const double*    S  = block.weights(row);
 
         int TopMat = czTopMat[idx];
         int BotMat = czBotMat[idx];
@@ -2727,6 +2902,9 @@ SerialMPM::scheduleComputeInternalForce(SchedulerP& sched,
   t->requires(Task::OldDW,lb->pXLabel,                    gan,NGP);
   t->requires(Task::OldDW,lb->pSizeLabel,                 gan,NGP);
   t->requires(Task::OldDW, lb->pDefGradLabel,  gan,NGP);
+  if (flags->d_cacheInterpolationWeights) {
+    t->requires(Task::NewDW, lb->pInterpolationCacheLabel, gnone);
+  }
 
   if(flags->d_with_ice){
     t->requires(Task::NewDW, lb->pPressureLabel,          gan,NGP);
@@ -2785,9 +2963,7 @@ SerialMPM::computeInternalForce(const ProcessorGroup*,
     Id.Identity();
 
     ParticleInterpolator* interpolator = flags->d_interpolator->clone(patch); 
-    vector<IntVector> ni(interpolator->size());
-    vector<double> S(interpolator->size());
-    vector<Vector> d_S(interpolator->size());
+    ParticleInterpolationCache block;
     string interp_type = flags->d_interpolator_type;
 
     int numMPMMatls = d_sharedState->getNumMPMMatls();
@@ -2827,6 +3003,9 @@ SerialMPM::computeInternalForce(const ProcessorGroup*,
 
       new_dw->get(gvolume, lb->gVolumeLabel, dwi, patch, Ghost::None, 0);
 
+      const ParticleInterpolationCache* cache =
+        getInterpolationCache(new_dw, patch, dwi, pset);
+
       new_dw->allocateAndPut(gstress,      lb->gStressForSavingLabel,dwi,patch);
       new_dw->allocateAndPut(internalforce,lb->gInternalForceLabel,  dwi,patch);
 
@@ -2860,26 +3039,36 @@ SerialMPM::computeInternalForce(const ProcessorGroup*,
       Matrix3 stresspress;
       int n8or27 = flags->d_8or27;
 
+      double start = Time::currentSeconds();
+
       // for the non axisymmetric case:
       if(!flags->d_axisymmetric){
+        int ip = 0;
         for (ParticleSubset::iterator iter = pset->begin();
              iter != pset->end(); 
-             iter++){
+             iter++, ip++){
           particleIndex idx = *iter;
   
           // Get the node indices that surround the cell
-          interpolator->findCellAndWeightsAndShapeDerivatives(px[idx],ni,S,d_S,
-                                                              psize[idx],pFOld[idx]);
+          const ParticleInterpolationCache* weights = cache;
+          int row = ip;
+          if (!cache) {
+            weights = &block;
+            row = block.fillBlock(interpolator, pset, ip, px, psize, pFOld, true);
+          }
+          const IntVector* pni = weights->nodes(row);
+          const double*    pS  = weights->weights(row);
+          const Vector*    pdS = weights->gradients(row);
           stressvol  = pstress[idx]*pvol[idx];
           stresspress = pstress[idx] + Id*(p_pressure[idx] - p_q[idx]);
           //cerr << " idx = " << idx << " pstress = " << pstress[idx] << endl;
 
           for (int k = 0; k < n8or27; k++){
-            if(patch->containsNode(ni[k])){
-              Vector div(d_S[k].x()*oodx[0],d_S[k].y()*oodx[1],
-                         d_S[k].z()*oodx[2]);
-              internalforce[ni[k]] -= (div * stresspress)  * pvol[idx];
-              gstress[ni[k]]       += stressvol * S[k];
+            if(patch->containsNode(pni[k])){
+              Vector div(pdS[k].x()*oodx[0],pdS[k].y()*oodx[1],
+                         pdS[k].z()*oodx[2]);
+              internalforce[pni[k]] -= (div * stresspress)  * pvol[idx];
+              gstress[pni[k]]       += stressvol * pS[k];
             }
           }
         }
@@ -2887,13 +3076,21 @@ SerialMPM::computeInternalForce(const ProcessorGroup*,
 
       // for the axisymmetric case
       if(flags->d_axisymmetric){
+        int ip = 0;
         for (ParticleSubset::iterator iter = pset->begin();
              iter != pset->end();
-             iter++){
+             iter++, ip++){
           particleIndex idx = *iter;
 
-          interpolator->findCellAndWeightsAndShapeDerivatives(px[idx],ni,S,d_S,
-                                                              psize[idx],pFOld[idx]);
+          const ParticleInterpolationCache* weights = cache;
+          int row = ip;
+          if (!cache) {
+            weights = &block;
+            row = block.fillBlock(interpolator, pset, ip, px, psize, pFOld, true);
+          }
+          const IntVector* pni = weights->nodes(row);
+          const double*    pS  = weights->weights(row);
+          const Vector*    pdS = weights->gradients(row);
 
           stressvol   = pstress[idx]*pvol[idx];
           stresspress = pstress[idx] + Id*(p_pressure[idx] - p_q[idx]);
@@ -2901,19 +3098,28 @@ SerialMPM::computeInternalForce(const ProcessorGroup*,
           // r is the x direction, z (axial) is the y direction
           double IFr=0.,IFz=0.;
           for (int k = 0; k < n8or27; k++){
-            if(patch->containsNode(ni[k])){
-              IFr = d_S[k].x()*oodx[0]*stresspress(0,0) +
-                d_S[k].y()*oodx[1]*stresspress(0,1) +
-                d_S[k].z()*stresspress(2,2);
-              IFz = d_S[k].x()*oodx[0]*stresspress(0,1)
-                + d_S[k].y()*oodx[1]*stresspress(1,1);
-              internalforce[ni[k]] -=  Vector(IFr,IFz,0.0) * pvol[idx];
-              gstress[ni[k]]       += stressvol * S[k];
+            if(patch->containsNode(pni[k])){
+              IFr = pdS[k].x()*oodx[0]*stresspress(0,0) +
+                pdS[k].y()*oodx[1]*stresspress(0,1) +
+                pdS[k].z()*stresspress(2,2);
+              IFz = pdS[k].x()*oodx[0]*stresspress(0,1)
+                + pdS[k].y()*oodx[1]*stresspress(1,1);
+              internalforce[pni[k]] -=  Vector(IFr,IFz,0.0) * pvol[idx];
+              gstress[pni[k]]       += stressvol * pS[k];
             }
           }
         }
       }
 
+      if (cout_interp.active()) {
+        cerrLock.lock();
+        cout_interp << "patch " << patch->getID() << " matl " << dwi
+                    << ": computeInternalForce particle loop "
+                    << Time::currentSeconds() - start << " s"
+                    << (cache ? " (cached weights)" : "") << endl;
+        cerrLock.unlock();
+      }
+
       for(NodeIterator iter =patch->getNodeIterator();!iter.done();iter++){
         IntVector c = *iter;
         gstressglobal[c] += gstress[c];
@@ -4530,8 +4736,7 @@ SerialMPM::interpolateToParticlesAndUpdate(const ProcessorGroup*,
               "Doing interpolateToParticlesAndUpdate");
 
     ParticleInterpolator* interpolator = flags->d_interpolator->clone(patch);
-    vector<IntVector> ni(interpolator->size());
-    vector<double> S(interpolator->size());
+    ParticleInterpolationCache block;
 
     // Performs the interpolation from the cell vertices of the grid
     // acceleration and velocity to the particles to update their
@@ -4657,12 +4862,14 @@ SerialMPM::interpolateToParticlesAndUpdate(const ProcessorGroup*,
       }
 
       // Loop over particles
-      for(auto iter = pset->begin(); iter != pset->end(); iter++){
+      int ip = 0;
+      for(auto iter = pset->begin(); iter != pset->end(); iter++, ip++){
         particleIndex idx = *iter;
 
         // Get the node indices that surround the cell
-
-        interpolator->findCellAndWeights(px[idx],ni,S,psize[idx],pFNew[idx]);
+        int row = block.fillBlock(interpolator, pset, ip, px, psize, pFNew, false);
+        const IntVector* ni = block.nodes(row);
+        const double*    S  = block.weights(row);
 
         Vector vel(0.0,0.0,0.0);
         Vector acc(0.0,0.0,0.0);
@@ -4925,8 +5132,7 @@ SerialMPM::interpolateToParticlesAndUpdateMom1(const ProcessorGroup*,
               "Doing interpolateToParticlesAndUpdateMom1");
 
     ParticleInterpolator* interpolator = flags->d_interpolator->clone(patch);
-    vector<IntVector> ni(interpolator->size());
-    vector<double> S(interpolator->size());
+    ParticleInterpolationCache block;
 
     // Performs the interpolation from the cell vertices of the grid
     // acceleration and velocity to the particles to update their
@@ -4983,12 +5189,15 @@ SerialMPM::interpolateToParticlesAndUpdateMom1(const ProcessorGroup*,
       new_dw->get(gacceleration,   lb->gAccelerationLabel,   dwi,patch,gac,NGP);  
       
       // Loop over particles
+      int ip = 0;
       for(ParticleSubset::iterator iter = pset->begin();
-          iter != pset->end(); iter++){
+          iter != pset->end(); iter++, ip++){
         particleIndex idx = *iter;
 
         // Get the node indices that surround the cell
-        interpolator->findCellAndWeights(px[idx],ni,S,psize[idx],pFOld[idx]);
+        int row = block.fillBlock(interpolator, pset, ip, px, psize, pFOld, false);
+        const IntVector* ni = block.nodes(row);
+        const double*    S  = block.weights(row);
 
         Vector vel(0.0,0.0,0.0);
         Vector acc(0.0,0.0,0.0);
@@ -5093,8 +5302,7 @@ SerialMPM::interpolateParticleVelToGridMom(const ProcessorGroup*,
 
     int numMatls = d_sharedState->getNumMPMMatls();
     ParticleInterpolator* interpolator = flags->d_interpolator->clone(patch);
-    vector<IntVector> ni(interpolator->size());
-    vector<double> S(interpolator->size());
+    ParticleInterpolationCache block;
 
     Ghost::GhostType  gan = Ghost::AroundNodes;
     Ghost::GhostType  gnone = Ghost::None;
@@ -5126,13 +5334,16 @@ SerialMPM::interpolateParticleVelToGridMom(const ProcessorGroup*,
       gvelocity_star.initialize(Vector(0,0,0));
 
       int n8or27=flags->d_8or27;
+      int ip = 0;
       for (ParticleSubset::iterator iter = pset->begin();
            iter != pset->end();
-           iter++){
+           iter++, ip++){
         particleIndex idx = *iter;
 
         // Get the node indices that surround the cell
-        interpolator->findCellAndWeights(px[idx],ni,S,psize[idx],pFOld[idx]);
+        int row = block.fillBlock(interpolator, pset, ip, px, psize, pFOld, false);
+        const IntVector* ni = block.nodes(row);
+        const double*    S  = block.weights(row);
 
         Vector pmom = pVelocity[idx]*pmass[idx];
 
@@ -5253,8 +5464,7 @@ SerialMPM::interpolateToParticlesAndUpdateMom2(const ProcessorGroup*,
               "Doing interpolateToParticlesAndUpdateMom2");
 
     ParticleInterpolator* interpolator = flags->d_interpolator->clone(patch);
-    vector<IntVector> ni(interpolator->size());
-    vector<double> S(interpolator->size());
+    ParticleInterpolationCache block;
 
     // Performs the interpolation from the cell vertices of the grid
     // acceleration and velocity to the particles to update their
@@ -5357,12 +5567,15 @@ SerialMPM::interpolateToParticlesAndUpdateMom2(const ProcessorGroup*,
       }
 
       // Loop over particles
+      int ip = 0;
       for(ParticleSubset::iterator iter = pset->begin();
-          iter != pset->end(); iter++){
+          iter != pset->end(); iter++, ip++){
         particleIndex idx = *iter;
 
         // Get the node indices that surround the cell
-        interpolator->findCellAndWeights(px[idx],ni,S,psize[idx],pFNew[idx]);
+        int row = block.fillBlock(interpolator, pset, ip, px, psize, pFNew, false);
+        const IntVector* ni = block.nodes(row);
+        const double*    S  = block.weights(row);
 
         Vector vel(0.0,0.0,0.0);
         Vector acc(0.0,0.0,0.0);
@@ -49,6 +49,7 @@
 #include <CCA/Components/OnTheFlyAnalysis/AnalysisModule.h>
 #include <CCA/Components/MPM/GradientComputer/DeformationGradientComputer.h>
 #include <Core/Grid/Variables/ParticleVariable.h>
+#include <Core/Grid/ParticleInterpolationCache.h>
 
 
 
@@ -278,6 +279,22 @@ WARNING
                                        DataWarehouse* old_dw,
                                        DataWarehouse* new_dw);
 
+    //////////
+    // Evaluate the shape functions and their gradients once per patch
+    // and store them in a PerPatch cache for the tasks that follow
+    virtual void computeInterpolationWeights(const ProcessorGroup*,
+                                             const PatchSubset* patches,
+                                             const MaterialSubset* matls,
+                                             DataWarehouse* old_dw,
+                                             DataWarehouse* new_dw);
+
+    //////////
+    // Get the PerPatch weight cache (null if caching is off)
+    const ParticleInterpolationCache* getInterpolationCache(DataWarehouse* new_dw,
+                                                            const Patch* patch,
+                                                            int dwi,
+                                                            ParticleSubset* pset);
+
     //////////
     // Insert Documentation Here:
     virtual void interpolateParticlesToGrid(const ProcessorGroup*,
@@ -481,6 +498,9 @@ WARNING
                               DataWarehouse*,
                               DataWarehouse* new_dw);
 
+    virtual void scheduleComputeInterpolationWeights(SchedulerP&, const PatchSet*,
+                                                     const MaterialSet*);
+
     virtual void scheduleInterpolateParticlesToGrid(SchedulerP&, const PatchSet*,
                                                     const MaterialSet*);
 
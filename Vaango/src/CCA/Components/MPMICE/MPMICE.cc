@@ -428,6 +428,9 @@ MPMICE::scheduleTimeAdvance(const LevelP& inlevel, SchedulerP& sched)
 
   d_mpm->scheduleComputeParticleBodyForce(    sched, mpm_patches, mpm_matls);
   d_mpm->scheduleApplyExternalLoads(          sched, mpm_patches, mpm_matls);
+  if(d_mpm->flags->d_cacheInterpolationWeights){
+    d_mpm->scheduleComputeInterpolationWeights(sched, mpm_patches, mpm_matls);
+  }
   d_mpm->scheduleInterpolateParticlesToGrid(  sched, mpm_patches, mpm_matls);
   d_mpm->scheduleComputeHeatExchange(         sched, mpm_patches, mpm_matls);
 
@@ -2087,7 +2090,20 @@ void MPMICE::computeEquilibrationPressure(const ProcessorGroup*,
     // Done with preliminary calcs, now loop over every cell
     int count, test_max_iter = 0;
 
-    for (CellIterator iter = patch->getExtraCellIterator();!iter.done();iter++){
+    // Block-wise solve with the batched ICE EOS calls (<batch_equilibration>);
+    // the per cell loop below is the reference and keeps the per-iteration
+    // history for DBG_EqPress
+    bool batched = d_ice->d_batchEquilibration &&
+                   !d_useSimpleEquilibrationPressure && !ds_EqPress.active();
+    if (batched) {
+      test_max_iter = computeEquilibrationPressureBatch(patch, ice_matl,
+                                   mpm_matl, Temp, rho_micro, vol_frac,
+                                   rho_CC_new, speedSound, press, press_new,
+                                   delPress_tmp, press_ref, cv, gamma,
+                                   convergence_crit, numALLMatls);
+    }
+
+    for (CellIterator iter = patch->getExtraCellIterator();!batched && !iter.done();iter++){
       const IntVector& c = *iter;  
       double delPress = 0.;
       bool converged  = false;
@@ -2653,6 +2669,277 @@ void MPMICE::computeEquilibrationPressure(const ProcessorGroup*,
   }  //patches
 }
 
+/* _____________________________________________________________________ 
+   Function~  MPMICE::computeEquilibrationPressureBatch--
+   Purpose~   The Newton iteration of computeEquilibrationPressure (old
+   algorithm), done on blocks of cells like
+   ICE::computeEquilibrationPressureBatch.  The ICE materials use the
+   batched EOS calls; the MPM materials call their constitutive model cell
+   by cell inside the block.  Cells that reach the max. iterations fall
+   back to binaryPressureSearch as in the per cell loop.  Returns the
+   max. iterations in any cell.
+   _____________________________________________________________________*/
+int MPMICE::computeEquilibrationPressureBatch(const Patch* patch,
+                            StaticArray<ICEMaterial*>& ice_matl,
+                            StaticArray<MPMMaterial*>& mpm_matl,
+                            StaticArray<constCCVariable<double> >& Temp,
+                            StaticArray<CCVariable<double> >& rho_micro,
+                            StaticArray<CCVariable<double> >& vol_frac,
+                            StaticArray<CCVariable<double> >& rho_CC_new,
+                            StaticArray<CCVariable<double> >& speedSound,
+                            constCCVariable<double>& press,
+                            CCVariable<double>& press_new,
+                            CCVariable<double>& delPress_tmp,
+                            double press_ref,
+                            StaticArray<constCCVariable<double> >& cv,
+                            StaticArray<constCCVariable<double> >& gamma,
+                            double convergence_crit,
+                            int numALLMatls)
+{
+  const int BLOCK = 64;
+  int numValues = numALLMatls*BLOCK;
+  int max_iter  = d_ice->d_max_iter_equilibration;
+  double c_2;
+
+  // The per material arrays are indexed [m*BLOCK + i].  The block arrays
+  // hold the cells in iterator order, the work arrays the cells still
+  // iterating (slot[i] is the block index of work cell i).
+  vector<IntVector> cells(BLOCK);
+  vector<int>    count_blk(BLOCK);
+  vector<double> press_blk(BLOCK), sum_blk(BLOCK), delPress_blk(BLOCK);
+  vector<double> rhoM_blk(numValues), volFrac_blk(numValues);
+  vector<double> T_blk(numValues), cv_blk(numValues), gamma_blk(numValues);
+
+  vector<int>    slot(BLOCK);
+  vector<double> press_w(BLOCK), sum(BLOCK), delPress(BLOCK);
+  vector<double> A(BLOCK), B(BLOCK), C(BLOCK);
+  vector<double> rhoM(numValues), volFrac(numValues), rho(numValues);
+  vector<double> T(numValues), cvs(numValues), gammas(numValues);
+  vector<double> rhoM_new(BLOCK);
+  vector<double> press_eos(numValues), dp_drho(numValues), dp_de(numValues);
+
+  // scratch for binaryPressureSearch
+  StaticArray<double> press_eos_c(numALLMatls);
+  StaticArray<double> dp_drho_c(numALLMatls), dp_de_c(numALLMatls);
+
+  int test_max_iter = 0;
+  CellIterator iter = patch->getExtraCellIterator();
+  while (!iter.done()) {
+
+    //__________________________________
+    // gather the next block
+    int n = 0;
+    for (; n < BLOCK && !iter.done(); iter++, n++) {
+      IntVector c = *iter;
+      cells[n]        = c;
+      slot[n]         = n;
+      press_w[n]      = press_new[c];
+      press_blk[n]    = press_new[c];
+      delPress_blk[n] = 0.0;
+      count_blk[n]    = 0;
+      sum_blk[n]      = 0.0;
+      for (int m = 0; m < numALLMatls; m++) {
+        int k = m*BLOCK + n;
+        rhoM[k]    = rho_micro[m][c];
+        volFrac[k] = vol_frac[m][c];
+        rho[k]     = rho_CC_new[m][c];
+        T[k]       = Temp[m][c];
+        cvs[k]     = ice_matl[m] ? cv[m][c]    : 0.0;
+        gammas[k]  = ice_matl[m] ? gamma[m][c] : 0.0;
+
+        rhoM_blk[k]    = rhoM[k];
+        volFrac_blk[k] = volFrac[k];
+        T_blk[k]       = T[k];
+        cv_blk[k]      = cvs[k];
+        gamma_blk[k]   = gammas[k];
+      }
+    }
+    int numCells = n;
+
+    int count = 0;
+    while (n > 0 && count < max_iter) {
+      count++;
+
+      //__________________________________
+      // evaluate press_eos
+      for (int m = 0; m < numALLMatls; m++) {
+        int k = m*BLOCK;
+        if (ice_matl[m]) {
+          ice_matl[m]->getEOS()->computePressEOSBatch(n, &rhoM[k], &gammas[k],
+                                                      &cvs[k], &T[k],
+                                                      &press_eos[k],
+                                                      &dp_drho[k], &dp_de[k]);
+        } else if (mpm_matl[m]) {
+          ConstitutiveModel* cm = mpm_matl[m]->getConstitutiveModel();
+          for (int i = 0; i < n; i++) {
+            cm->computePressEOSCM(rhoM[k+i], press_eos[k+i], press_ref,
+                                  dp_drho[k+i], c_2, mpm_matl[m], T[k+i]);
+          }
+        }
+      }
+
+      //__________________________________
+      // - compute delPress
+      // - update press_CC
+      for (int i = 0; i < n; i++) {
+        A[i] = 0.0;
+        B[i] = 0.0;
+        C[i] = 0.0;
+      }
+      for (int m = 0; m < numALLMatls; m++) {
+        const double* vf   = &volFrac[m*BLOCK];
+        const double* p    = &press_eos[m*BLOCK];
+        const double* dpdr = &dp_drho[m*BLOCK];
+        const double* r    = &rho[m*BLOCK];
+        for (int i = 0; i < n; i++) {
+          double Q     = press_w[i] - p[i];
+          double inv_y = (vf[i]*vf[i])/(dpdr[i]*r[i] + d_SMALL_NUM);
+          A[i] += vf[i];
+          B[i] += Q*inv_y;
+          C[i] += inv_y;
+        }
+      }
+      double vol_frac_not_close_packed = 1.0;
+      for (int i = 0; i < n; i++) {
+        delPress[i] = (A[i] - vol_frac_not_close_packed - B[i])/C[i];
+        press_w[i] += delPress[i];
+        if (press_w[i] < convergence_crit) {
+          press_w[i] = fabs(delPress[i]);
+        }
+        sum[i] = 0.0;
+      }
+
+      //__________________________________
+      // backout rho_micro_CC at this new pressure
+      // and update the volume fractions
+      for (int m = 0; m < numALLMatls; m++) {
+        int k = m*BLOCK;
+        if (ice_matl[m]) {
+          ice_matl[m]->getEOS()->computeRhoMicroBatch(n, &press_w[0],
+                                                      &gammas[k], &cvs[k],
+                                                      &T[k], &rhoM[k],
+                                                      &rhoM_new[0]);
+        } else if (mpm_matl[m]) {
+          ConstitutiveModel* cm = mpm_matl[m]->getConstitutiveModel();
+          for (int i = 0; i < n; i++) {
+            rhoM_new[i] = cm->computeRhoMicroCM(press_w[i], press_ref,
+                                                mpm_matl[m], T[k+i], rhoM[k+i]);
+          }
+        }
+        for (int i = 0; i < n; i++) {
+          rhoM[k+i]    = rhoM_new[i];
+          volFrac[k+i] = rho[k+i]/rhoM_new[i];
+          sum[i]      += volFrac[k+i];
+        }
+      }
+
+      //__________________________________
+      // - Test for convergence, retire the converged cells
+      //   and compact the others
+      int left = 0;
+      for (int i = 0; i < n; i++) {
+        if (fabs(sum[i] - vol_frac_not_close_packed) < convergence_crit ||
+            count == max_iter) {
+          int s = slot[i];
+          press_blk[s]    = press_w[i];
+          sum_blk[s]      = sum[i];
+          delPress_blk[s] = delPress[i];
+          count_blk[s]    = count;
+          for (int m = 0; m < numALLMatls; m++) {
+            rhoM_blk[m*BLOCK + s]    = rhoM[m*BLOCK + i];
+            volFrac_blk[m*BLOCK + s] = volFrac[m*BLOCK + i];
+          }
+          continue;
+        }
+        if (left != i) {
+          slot[left]    = slot[i];
+          press_w[left] = press_w[i];
+          for (int m = 0; m < numALLMatls; m++) {
+            int to = m*BLOCK + left, from = m*BLOCK + i;
+            rhoM[to]    = rhoM[from];
+            volFrac[to] = volFrac[from];
+            rho[to]     = rho[from];
+            T[to]       = T[from];
+            cvs[to]     = cvs[from];
+            gammas[to]  = gammas[from];
+          }
+        }
+        left++;
+      }
+      n = left;
+    }
+
+    //__________________________________
+    // Find the speed of sound based on the solution
+    // and scatter the block
+    for (int m = 0; m < numALLMatls; m++) {
+      int k = m*BLOCK;
+      if (ice_matl[m]) {
+        ice_matl[m]->getEOS()->computePressEOSBatch(numCells, &rhoM_blk[k],
+                                                    &gamma_blk[k], &cv_blk[k],
+                                                    &T_blk[k], &press_eos[k],
+                                                    &dp_drho[k], &dp_de[k]);
+      }
+      for (int i = 0; i < numCells; i++) {
+        IntVector c = cells[i];
+        double rhoM_c = rhoM_blk[k+i];
+        if (ice_matl[m]) {
+          c_2 = dp_drho[k+i] + dp_de[k+i]*press_eos[k+i]/(rhoM_c*rhoM_c);
+        } else {
+          dp_de[k+i] = 0.0;
+          mpm_matl[m]->getConstitutiveModel()->
+            computePressEOSCM(rhoM_c, press_eos[k+i], press_ref,
+                              dp_drho[k+i], c_2, mpm_matl[m], T_blk[k+i]);
+        }
+        rho_micro[m][c]  = rhoM_c;
+        vol_frac[m][c]   = volFrac_blk[k+i];
+        speedSound[m][c] = sqrt(c_2);         // Isentropic speed of sound
+
+        //____ BB : B U L L E T   P R O O F I N G----
+        // catch inf and nan speed sound values of converged cells
+        bool converged = fabs(sum_blk[i] - 1.0) < convergence_crit;
+        if (converged && (std::isnan(speedSound[m][c]) || c_2 == 0.0)) {
+          ostringstream warn;
+          warn<<"ERROR MPMICE::computeEquilPressure, "
+              << (ice_matl[m] ? "ICE" : "MPM") << " mat= "<< m << " cell= "
+              << c << " sound speed is imaginary.\n";
+          warn << "speedSound = " << speedSound[m][c] << " c_2 = " << c_2
+               << " press_eos = " << press_eos[k+i]
+               << " dp_drho = " << dp_drho[k+i]
+               << " dp_de = " << dp_de[k+i]
+               << " rho_micro = " << rhoM_c << " Temp = " << Temp[m][c] << endl;
+          throw ProblemSetupException(warn.str(), __FILE__, __LINE__ );
+        }
+      }
+    }
+
+    for (int i = 0; i < numCells; i++) {
+      IntVector c = cells[i];
+      press_new[c]    = press_blk[i];
+      delPress_tmp[c] = delPress_blk[i];
+
+      //__________________________________
+      // If the pressure solution has stalled out
+      //  then try a binary search
+      int    count_c = count_blk[i];
+      double sum_c   = sum_blk[i];
+      if (count_c >= max_iter) {
+        binaryPressureSearch( Temp, rho_micro, vol_frac, rho_CC_new,
+                              speedSound, dp_drho_c, dp_de_c,
+                              press_eos_c, press, press_new, press_ref,
+                              cv, gamma, convergence_crit,
+                              numALLMatls, count_c, sum_c, c);
+      }
+      test_max_iter = std::max(test_max_iter, count_c);
+
+      for (int m = 0; m < numALLMatls; m++) {
+        ASSERT(( vol_frac[m][c] > 0.0 ) ||( vol_frac[m][c] < 1.0));
+      }
+    }
+  }
+  return test_max_iter;
+}
+
 /* --------------------------------------------------------------------- 
    Function~  MPMICE::binaryPressureSearch-- 
    Purpose:   When the technique for find the equilibration pressure
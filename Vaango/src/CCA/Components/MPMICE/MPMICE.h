@@ -296,6 +296,23 @@ public:
                             int & count,
                             double & sum,
                             IntVector c );                   
+
+  int computeEquilibrationPressureBatch(const Patch* patch,
+                            StaticArray<ICEMaterial*>& ice_matl,
+                            StaticArray<MPMMaterial*>& mpm_matl,
+                            StaticArray<constCCVariable<double> >& Temp,
+                            StaticArray<CCVariable<double> >& rho_micro,
+                            StaticArray<CCVariable<double> >& vol_frac,
+                            StaticArray<CCVariable<double> >& rho_CC_new,
+                            StaticArray<CCVariable<double> >& speedSound,
+                            constCCVariable<double>& press,
+                            CCVariable<double>& press_new,
+                            CCVariable<double>& delPress_tmp,
+                            double press_ref,
+                            StaticArray<constCCVariable<double> >& cv,
+                            StaticArray<constCCVariable<double> >& gamma,
+                            double convergence_crit,
+                            int numALLMatls);
 //__________________________________
 //    R A T E   F O R M                   
   void computeRateFormPressure(const ProcessorGroup*,
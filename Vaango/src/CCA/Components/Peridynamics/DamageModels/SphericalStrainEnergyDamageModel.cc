@@ -32,6 +32,7 @@
 #include <Core/Grid/Variables/VarLabel.h>
 #include <Core/Grid/Variables/VarTypes.h>
 #include <Core/Grid/Variables/ParticleVariable.h>
+#include <Core/Grid/Variables/ParticleFamilyVariable.h>
 #include <Core/Exceptions/ProblemSetupException.h>
 
 #include <cmath>
@@ -50,9 +51,8 @@ using Uintah::ParticleSubset;
 using Uintah::ParticleVariable;
 using Uintah::constParticleVariable;
 using Uintah::Matrix3;
-using Uintah::NeighborList;
-using Uintah::NeighborConnectivity;
-using Uintah::NeighborBondEnergy;
+using Uintah::ParticleFamilyVariable;
+using Uintah::constParticleFamilyVariable;
 using Uintah::Ghost;
 using Uintah::particleIndex;
 using Uintah::long64;
@@ -143,12 +143,11 @@ SphericalStrainEnergyDamageModel::addComputesAndRequires(Task* task,
   
   // List the variables needed for this task to execute
   task->requires(Task::OldDW, d_label->pDisplacementLabel,       matlset, gac, numGhostCells);
-  task->requires(Task::OldDW, d_label->pParticleIDLabel,         matlset, gac, numGhostCells);
   task->requires(Task::OldDW, d_label->pHorizonLabel,            matlset, gac, numGhostCells);
-  task->requires(Task::OldDW, d_label->pNeighborListLabel,       matlset, gac, numGhostCells);
-  task->requires(Task::OldDW, d_label->pNeighborConnLabel,       matlset, gac, numGhostCells);
-  task->requires(Task::OldDW, d_label->pNeighborCountLabel,      matlset, gac, numGhostCells);
-  task->requires(Task::OldDW, d_label->pNeighborBondEnergyLabel, matlset, gac, numGhostCells);
+  task->requires(Task::OldDW, d_label->pNeighborCountLabel,      matlset, Ghost::None);
+  task->requires(Task::NewDW, d_label->pNeighborIndexLabel,      matlset, Ghost::None);
+  task->requires(Task::OldDW, d_label->pNeighborBondEnergyLabel, matlset, Ghost::None);
+  task->requires(Task::OldDW, d_label->pNeighborRevConnLabel,    matlset, Ghost::None);
   task->requires(Task::NewDW, d_label->pPositionLabel_preReloc,       matlset, gac, numGhostCells);
   task->requires(Task::NewDW, d_label->pDisplacementLabel_preReloc,   matlset, gac, numGhostCells);
   task->requires(Task::NewDW, d_label->pPK1StressLabel_preReloc,      matlset, gac, numGhostCells);
@@ -157,6 +156,7 @@ SphericalStrainEnergyDamageModel::addComputesAndRequires(Task* task,
   // List the variables computed by this task
   task->computes(d_label->pNeighborBondEnergyLabel_preReloc, matlset);
   task->computes(d_label->pNeighborConnLabel_preReloc,       matlset);
+  task->computes(d_label->pNeighborRevConnLabel_preReloc,    matlset);
   task->computes(d_label->pDamageLabel_preReloc,             matlset);
 }
 
@@ -186,10 +186,6 @@ SphericalStrainEnergyDamageModel::computeDamageTensor(const PatchSubset* patches
                                                           d_flags->d_numCellsInHorizon,
                                                           d_label->pPositionLabel);
 
-    // Create a map that takes particle IDs to the array index in the larger particle subset
-    Uintah::ParticleIDMap familyIdMap;
-    old_dw->createParticleIDMap(familySet, d_label->pParticleIDLabel, familyIdMap);
-
     // Get the particle data needed for damage computation
     constParticleVariable<Point> pPosition_new, pPosition_new_family;
     new_dw->get(pPosition_new,        d_label->pPositionLabel_preReloc, pset);
@@ -211,27 +207,36 @@ SphericalStrainEnergyDamageModel::computeDamageTensor(const PatchSubset* patches
     new_dw->get(pShapeInv_new,        d_label->pShapeTensorInvLabel_preReloc, pset);
     new_dw->get(pShapeInv_new_family, d_label->pShapeTensorInvLabel_preReloc, familySet);
 
-    constParticleVariable<double> pHorizon;
-    old_dw->get(pHorizon, d_label->pHorizonLabel, pset);
+    constParticleVariable<double> pHorizon, pHorizon_family;
+    old_dw->get(pHorizon,        d_label->pHorizonLabel, pset);
+    old_dw->get(pHorizon_family, d_label->pHorizonLabel, familySet);
 
     constParticleVariable<int> pNeighborCount;
     old_dw->get(pNeighborCount, d_label->pNeighborCountLabel, pset);
 
-    constParticleVariable<NeighborList> pNeighborList;
-    old_dw->get(pNeighborList, d_label->pNeighborListLabel, pset);
-
-    constParticleVariable<NeighborConnectivity> pNeighborConn;
-    old_dw->get(pNeighborConn, d_label->pNeighborConnLabel, pset);
+    // The family members resolved into indices in familySet (-1 for broken bonds)
+    constParticleFamilyVariable<int> pNeighborIndex;
+    new_dw->get(pNeighborIndex, d_label->pNeighborIndexLabel, pset);
 
-    constParticleVariable<NeighborBondEnergy> pNeighborBondEnergy;
+    constParticleFamilyVariable<double> pNeighborBondEnergy;
     old_dw->get(pNeighborBondEnergy, d_label->pNeighborBondEnergyLabel, pset);
 
-    // Initialize variables that will be updated in this task
-    ParticleVariable<NeighborConnectivity> pNeighborConn_new;
+    constParticleFamilyVariable<int> pNeighborRevConn;
+    old_dw->get(pNeighborRevConn, d_label->pNeighborRevConnLabel, pset);
+
+    // Initialize variables that will be updated in this task (broken bonds
+    // stay broken)
+    ParticleFamilyVariable<int> pNeighborConn_new;
     new_dw->allocateAndPut(pNeighborConn_new, d_label->pNeighborConnLabel_preReloc, pset);
+    pNeighborConn_new.copyStructure(pNeighborIndex.getOffsets(), 0);
 
-    ParticleVariable<NeighborBondEnergy> pNeighborBondEnergy_new;
+    ParticleFamilyVariable<double> pNeighborBondEnergy_new;
     new_dw->allocateAndPut(pNeighborBondEnergy_new, d_label->pNeighborBondEnergyLabel_preReloc, pset);
+    pNeighborBondEnergy_new.copyStructure(pNeighborIndex.getOffsets(), 0.0);
+
+    ParticleFamilyVariable<int> pNeighborRevConn_new;
+    new_dw->allocateAndPut(pNeighborRevConn_new, d_label->pNeighborRevConnLabel_preReloc, pset);
+    pNeighborRevConn_new.copyStructure(pNeighborIndex.getOffsets(), 0);
 
     ParticleVariable<Matrix3> pDamage_new;;
     new_dw->allocateAndPut(pDamage_new, d_label->pDamageLabel_preReloc, pset);
@@ -260,21 +265,20 @@ SphericalStrainEnergyDamageModel::computeDamageTensor(const PatchSubset* patches
       double critical_bond_energy = 4*d_GIc/(M_PI*hh*hh*hh*hh);
 
       // Get the neighbor data
-      NeighborList family = pNeighborList[idx];
-      NeighborConnectivity connected = pNeighborConn[idx];
-      NeighborBondEnergy bondEnergy_old = pNeighborBondEnergy[idx];
+      const int* familyIdx = pNeighborIndex.family(idx);
+      const double* bondEnergy_old = pNeighborBondEnergy.family(idx);
+      int* connected_new = pNeighborConn_new.family(idx);
+      const int* revConnected_old = pNeighborRevConn.family(idx);
+      int* revConnected_new = pNeighborRevConn_new.family(idx);
+      double* bondEnergy_new = pNeighborBondEnergy_new.family(idx);
 
       // Loop through the neighbor list
       int neighborCount = pNeighborCount[idx];
       for (int ii = 0; ii < neighborCount; ii++) {
        
         // If the bond exists
-        if (connected[ii]) {
-
-          // Find the idx of the neighbor
-          ParticleID familyID = family[ii];
-          particleIndex family_idx;
-          old_dw->getParticleIndex(familyIdMap, familyID, family_idx);
+        particleIndex family_idx = familyIdx[ii];
+        if (family_idx >= 0) {
 
           // Find the position and displacement of the neighbor
           Point family_pos = pPosition_new_family[family_idx];
@@ -307,22 +311,36 @@ SphericalStrainEnergyDamageModel::computeDamageTensor(const PatchSubset* patches
 
           // Update the bond energy
           double bond_energy_new = bondEnergy_old[ii] + energy_inc;
-          (pNeighborBondEnergy_new[idx])[ii] = bond_energy_new;
+          bondEnergy_new[ii] = bond_energy_new;
 
           // Compare the bond energy with the critical energy and break bonds
           if (bond_energy_new > critical_bond_energy) {
-            (pNeighborConn_new[idx])[ii] = false;    // broken
+            connected_new[ii] = false;    // broken
           } else {
-            (pNeighborConn_new[idx])[ii] = true;   // connected
+            connected_new[ii] = true;   // connected
           }
 
+          // The family particle's bond to this particle accumulates exactly
+          // the same energy (the force difference and the displacement
+          // increment both change sign) but breaks at the critical energy
+          // for the family particle's horizon
+          double family_hh = pHorizon_family[family_idx];
+          double family_critical_bond_energy = 4*d_GIc/(M_PI*family_hh*family_hh*family_hh*family_hh);
+          revConnected_new[ii] = revConnected_old[ii] && !(bond_energy_new > family_critical_bond_energy);
+
+        } else {
+
+          // Keep the energy of the broken bond
+          bondEnergy_new[ii] = bondEnergy_old[ii];
+          revConnected_new[ii] = revConnected_old[ii];
+
         } // Endif bond connected/broken
       }  // End neighbor particle loop
 
       // Now count the unbroken bonds
       int intact_bond_count = 0;
       for (int ii = 0; ii < neighborCount; ii++) {
-        if ((pNeighborConn_new[idx])[ii]) {
+        if (connected_new[ii]) {
           intact_bond_count++;
         }
       }
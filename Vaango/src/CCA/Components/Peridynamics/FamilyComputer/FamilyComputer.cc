@@ -30,11 +30,14 @@
 
 #include <Core/Grid/Variables/VarLabel.h>
 
-#include <Core/Grid/Variables/NeighborList.h>
-#include <Core/Grid/Variables/NeighborConnectivity.h>
+#include <Core/Grid/Variables/ParticleFamilyVariable.h>
+#include <Core/Grid/Variables/ParticleIDMap.h>
+
+#include <Core/Exceptions/InternalError.h>
 
 #include <Core/Util/DebugStream.h>
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 
@@ -50,10 +53,7 @@ using Uintah::Ghost;
 using Uintah::ParticleVariable;
 using Uintah::constParticleVariable;
 using Uintah::long64;
-using Uintah::NeighborList;
-using Uintah::NeighborConnectivity;
-using Uintah::NeighborBondEnergy;
-using Uintah::NeighborBondInternalForce;
+using Uintah::ParticleFamilyVariable;
 using Uintah::Point;
 using Uintah::IntVector;
 using Uintah::Vector;
@@ -100,11 +100,86 @@ FamilyComputer::addInitialComputesAndRequires(Task* task,
   // The quantities that are computed in this task
   task->computes(d_label->pNeighborListLabel, matlset);
   task->computes(d_label->pNeighborConnLabel, matlset);
+  task->computes(d_label->pNeighborRevConnLabel, matlset);
   task->computes(d_label->pNeighborCountLabel, matlset);
   task->computes(d_label->pNeighborBondEnergyLabel, matlset);
   task->computes(d_label->pNeighborBondForceLabel, matlset);
 }
 
+/*! Computes and requires for resolving the families into indices */
+void 
+FamilyComputer::addComputesAndRequires(Task* task,
+                                       const PeridynamicsMaterial* matl,
+                                       const PatchSet* patches) const
+{
+  cout_doing << "\t Scheduling task variables in family index resolver: Peridynamics: " 
+             << __FILE__ << ":" << __LINE__ << std::endl;
+
+  // Identify this material
+  const MaterialSubset* matlset = matl->thisMaterial();
+
+  // The quantities that are required by this task
+  Ghost::GhostType  gac = Ghost::AroundCells;
+  task->requires(Task::OldDW, d_label->pParticleIDLabel,    matlset, gac, d_flags->d_numCellsInHorizon);
+  task->requires(Task::OldDW, d_label->pNeighborListLabel,  matlset, Ghost::None);
+  task->requires(Task::OldDW, d_label->pNeighborConnLabel,  matlset, Ghost::None);
+  task->requires(Task::OldDW, d_label->pNeighborCountLabel, matlset, Ghost::None);
+
+  // The quantities that are computed in this task
+  task->computes(d_label->pNeighborIndexLabel, matlset);
+}
+
+void
+FamilyComputer::resolveFamilyIndices(const PeridynamicsMaterial* matl,
+                                     const Patch* patch,
+                                     DataWarehouse* old_dw,
+                                     DataWarehouse* new_dw)
+{
+  cout_doing << "\t Resolving family indices: Peridynamics: " << __FILE__ << ":" << __LINE__ << std::endl;
+
+  // Get the material index in the Datawarehouse
+  int matlIndex = matl->getDWIndex();
+
+  // Get the particle subset for this material in this patch
+  ParticleSubset* pset = old_dw->getParticleSubset(matlIndex, patch);
+
+  // Get the particle subset for the neighbor particles of the same material in this patch + ghost regions.
+  // The consumers of the indices use the same subset.
+  ParticleSubset* familySet = old_dw->getParticleSubset(matlIndex, patch, Ghost::AroundCells,
+                                                        d_flags->d_numCellsInHorizon,
+                                                        d_label->pPositionLabel);
+
+  // Create a map that takes particle IDs to the array index in the larger particle subset
+  Uintah::ParticleIDMap familyIdMap;
+  old_dw->createParticleIDMap(familySet, d_label->pParticleIDLabel, familyIdMap);
+
+  constParticleVariable<int> pNeighborCount;
+  old_dw->get(pNeighborCount, d_label->pNeighborCountLabel, pset);
+
+  Uintah::constParticleFamilyVariable<long64> pNeighborList;
+  old_dw->get(pNeighborList, d_label->pNeighborListLabel, pset);
+
+  Uintah::constParticleFamilyVariable<int> pNeighborConn;
+  old_dw->get(pNeighborConn, d_label->pNeighborConnLabel, pset);
+
+  ParticleFamilyVariable<int> pNeighborIndex;
+  new_dw->allocateAndPut(pNeighborIndex, d_label->pNeighborIndexLabel, pset);
+  pNeighborIndex.copyStructure(pNeighborList.getOffsets(), -1);
+
+  for (ParticleSubset::iterator iter = pset->begin(); iter != pset->end(); iter++) {
+    Uintah::particleIndex idx = *iter;
+    const long64* family = pNeighborList.family(idx);
+    const int* connected = pNeighborConn.family(idx);
+    int* familyIdx = pNeighborIndex.family(idx);
+    for (int ii = 0; ii < pNeighborCount[idx]; ii++) {
+      if (connected[ii] && !familyIdMap.find(family[ii], familyIdx[ii])) {
+        throw Uintah::InternalError("Could not find the family particle ID in the ID->index map.",
+                                    __FILE__, __LINE__);
+      }
+    }
+  }
+}
+
 void
 FamilyComputer::createNeighborList(PeridynamicsMaterial* matl,
                                    const Patch* patch,
@@ -131,26 +206,32 @@ FamilyComputer::createNeighborList(PeridynamicsMaterial* matl,
   constParticleVariable<long64> pParticleID;
   new_dw->get(pParticleID, d_label->pParticleIDLabel, pset);
 
-  // Create allocation for the family of each particle
-  ParticleVariable<NeighborList> pNeighborList;
-  ParticleVariable<NeighborConnectivity> pNeighborConn;
+  // Create allocation for the family of each particle.  The families are
+  // stored in compressed rows, so the sizes are found first and the
+  // family variables are filled after the particle loop.
+  ParticleFamilyVariable<long64> pNeighborList;
+  ParticleFamilyVariable<int> pNeighborConn;
+  ParticleFamilyVariable<int> pNeighborRevConn;
   ParticleVariable<int> pNeighborCount;
-  ParticleVariable<NeighborBondEnergy> pNeighborBondEnergy;
-  ParticleVariable<NeighborBondInternalForce> pNeighborBondForce;
+  ParticleFamilyVariable<double> pNeighborBondEnergy;
+  ParticleFamilyVariable<Vector> pNeighborBondForce;
   new_dw->allocateAndPut(pNeighborList, d_label->pNeighborListLabel, pset);
   new_dw->allocateAndPut(pNeighborConn, d_label->pNeighborConnLabel, pset);
+  new_dw->allocateAndPut(pNeighborRevConn, d_label->pNeighborRevConnLabel, pset);
   new_dw->allocateAndPut(pNeighborCount, d_label->pNeighborCountLabel, pset);
   new_dw->allocateAndPut(pNeighborBondEnergy, d_label->pNeighborBondEnergyLabel, pset);
   new_dw->allocateAndPut(pNeighborBondForce, d_label->pNeighborBondForceLabel, pset);
 
-  // Create a map that takes particle IDs to the array index in the particle subset
-  Uintah::ParticleIDMap idMap;
-  new_dw->createParticleIDMap(pset, d_label->pParticleIDLabel, idMap);
+  std::vector<std::vector<Uintah::ParticleID> > families(pset->numParticles());
+  std::vector<std::vector<int> > reverseBonds(pset->numParticles());
+  std::vector<int> familySizes(pset->numParticles(), 0);
 
+  // The family is stored as particle IDs; the bond loops resolve them to
+  // particle indices with a ParticleIDMap.  Only print the IDs here.
   if (cout_dbg.active()) {
     cout_dbg << "\t" << "ParticleID <-> Particle index Map for patch " << patch << std::endl;
-    for (auto iter = idMap.begin(); iter != idMap.end(); iter++) {
-      cout_dbg << "\t\t" << " ID = " << iter->first << " index = " << iter->second << std::endl;
+    for (auto iter = pset->begin(); iter != pset->end(); iter++) {
+      cout_dbg << "\t\t" << " ID = " << pParticleID[*iter] << " index = " << *iter << std::endl;
     }
   }
 
@@ -179,17 +260,17 @@ FamilyComputer::createNeighborList(PeridynamicsMaterial* matl,
     cout_doing << "\t Got family particle set " << pFamilySet << " " 
                << __FILE__ << ":" << __LINE__ << std::endl;
 
-    // Get the positions and particle IDs of the particles from the new data warehouse
+    // Get the positions, horizons and particle IDs of the particles from the new data warehouse
     constParticleVariable<Point> pFamilyPos;
+    constParticleVariable<double> pFamilyHorizon;
     constParticleVariable<long64> pFamilyPID;
     new_dw->get(pFamilyPos, d_label->pPositionLabel, pFamilySet);
+    new_dw->get(pFamilyHorizon, d_label->pHorizonLabel, pFamilySet);
     new_dw->get(pFamilyPID, d_label->pParticleIDLabel, pFamilySet);
 
     // Create a family particle vector
-    std::vector<Uintah::ParticleID> family;
-    std::vector<bool> connected;
-    std::vector<double> energy;
-    std::vector<Uintah::Vector> force;
+    std::vector<Uintah::ParticleID>& family = families[idx];
+    std::vector<int>& reverse = reverseBonds[idx];
 
     // Loop through the (potential) family particle set
     ParticleSubset::iterator pFamilyIter = pFamilySet->begin();
@@ -203,57 +284,48 @@ FamilyComputer::createNeighborList(PeridynamicsMaterial* matl,
         double horizon = pHorizon[idx];
         if (!(bondVector.length2() > horizon*horizon)) {
           family.push_back(pFamilyPID[pFamilyIdx]);
-          connected.push_back(true);
-          energy.push_back(0.0);
-          force.push_back(Vector(0.0, 0.0, 0.0));
+
+          // Does the family particle have the reverse bond (the same test
+          // with its own horizon)?
+          Vector reverseVector = pPosition[idx] - pFamilyPos[pFamilyIdx];
+          double familyHorizon = pFamilyHorizon[pFamilyIdx];
+          reverse.push_back(!(reverseVector.length2() > familyHorizon*familyHorizon));
         }
       }
       cout_doing << "\t\t Family particle  " << pFamilyIdx <<  " " 
                  <<__FILE__ << ":" << __LINE__ << std::endl;
     }
 
-    // Fill the neighbor information
-    NeighborList neighbors;
-    NeighborConnectivity intact;
-    NeighborBondEnergy bondEnergy;
-    NeighborBondInternalForce bondForce;
-
-    int ii = 0;
-    for (auto iter = family.begin(); iter != family.end(); iter++) {
-      neighbors[ii] = family[ii];
-      intact[ii] = connected[ii];
-      bondEnergy[ii] = energy[ii];
-      bondForce[ii] = force[ii];
-      ii++;
-    }
-
-    pNeighborList[idx] = neighbors;
-    pNeighborConn[idx] = intact;
-    pNeighborBondEnergy[idx] = bondEnergy;
-    pNeighborBondForce[idx] = bondForce;
+    familySizes[idx] = (int) family.size();
     pNeighborCount[idx] = (int) family.size();
 
-    cout_doing << "\t\t Completed neighbor fill for particle " << idx << " "
-               << __FILE__ << ":" << __LINE__ << std::endl;
-
     if (cout_dbg.active()) {
       cout_dbg << "\t\t\t  Neighbor count for particle  " << idx << " = " << pNeighborCount[idx]
                << std::endl;
-      cout_dbg << "\t\t\t  Neighbor list for particle  " << idx << " = " << pNeighborList[idx]
-               << std::endl;
-      cout_dbg << "\t\t\t  Neighbor conn for particle  " << idx << " = " << pNeighborConn[idx]
-               << std::endl;
-      cout_dbg << "\t\t\t  Neighbor bond energy for particle  " << idx << " = " << pNeighborBondEnergy[idx]
-               << std::endl;
-      cout_dbg << "\t\t\t  Neighbor bond force for particle  " << idx << " = " << pNeighborBondForce[idx]
-               << std::endl;
     }
 
-    // Check whether get particle index works
-    // particleIndex idx_test;
-    // new_dw->getParticleIndex(idMap, pParticleID[idx], idx_test);
-
   } // end loop over particles
+
+  // Fill the neighbor information: all bonds are intact with zero energy and
+  // force at the start
+  pNeighborList.setFamilySizes(familySizes, 0);
+  pNeighborConn.setFamilySizes(familySizes, 1);
+  pNeighborRevConn.setFamilySizes(familySizes, 0);
+  pNeighborBondEnergy.setFamilySizes(familySizes, 0.0);
+  pNeighborBondForce.setFamilySizes(familySizes, Vector(0.0, 0.0, 0.0));
+  for (iter = pset->begin(); iter != pset->end(); iter++) {
+    particleIndex idx = *iter;
+    const std::vector<Uintah::ParticleID>& family = families[idx];
+    std::copy(family.begin(), family.end(), pNeighborList.family(idx));
+    std::copy(reverseBonds[idx].begin(), reverseBonds[idx].end(), pNeighborRevConn.family(idx));
+    if (cout_dbg.active()) {
+      cout_dbg << "\t\t\t  Neighbor list for particle  " << idx << " = ";
+      for (int ii = 0; ii < (int) family.size(); ii++) {
+        cout_dbg << pNeighborList(idx, ii) << " ";
+      }
+      cout_dbg << std::endl;
+    }
+  }
 }
 
 // Compute the min max cells which intersect the horizon ball
@@ -54,6 +54,20 @@ namespace Vaango {
                             const Uintah::Patch* patch,
                             Uintah::DataWarehouse* new_dw);
 
+    /*! Computes and requires for resolving the families into indices */
+    void addComputesAndRequires(Uintah::Task* task,
+                                const PeridynamicsMaterial* matl,
+                                const Uintah::PatchSet* patches) const;
+
+    /*! Resolve the family IDs of the intact bonds into indices in the
+        ghosted family subset of the old data warehouse.  Broken bonds get
+        -1.  This is done once per timestep, after relocation, so that the
+        bond loops only do indexed gathers. */
+    void resolveFamilyIndices(const PeridynamicsMaterial* matl,
+                              const Uintah::Patch* patch,
+                              Uintah::DataWarehouse* old_dw,
+                              Uintah::DataWarehouse* new_dw);
+
   protected:
 
     void findCellsInHorizon(const Uintah::Patch* patch,
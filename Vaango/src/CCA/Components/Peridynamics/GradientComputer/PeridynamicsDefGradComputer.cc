@@ -30,8 +30,7 @@
 #include <Core/Grid/Task.h>
 #include <Core/Grid/Patch.h>
 #include <Core/Grid/Variables/VarLabel.h>
-#include <Core/Grid/Variables/NeighborList.h>
-#include <Core/Grid/Variables/NeighborConnectivity.h>
+#include <Core/Grid/Variables/ParticleFamilyVariable.h>
 #include <Core/Grid/Variables/VarTypes.h>
 #include <Core/Grid/Variables/NCVariable.h>
 #include <Core/Grid/Variables/ParticleVariable.h>
@@ -49,6 +48,7 @@ using Uintah::DataWarehouse;
 using Uintah::ParticleSubset;
 using Uintah::ParticleVariable;
 using Uintah::constParticleVariable;
+using Uintah::constParticleFamilyVariable;
 using Uintah::Matrix3;
 using Uintah::Ghost;
 using Uintah::particleIndex;
@@ -135,10 +135,8 @@ PeridynamicsDefGradComputer::addComputesAndRequires(Task* task,
   task->requires(Task::OldDW, d_labels->pPositionLabel,      matlset, gac, numGhostCells);
   task->requires(Task::OldDW, d_labels->pDisplacementLabel,  matlset, gac, numGhostCells);
   task->requires(Task::OldDW, d_labels->pVolumeLabel,        matlset, gac, numGhostCells);
-  task->requires(Task::OldDW, d_labels->pParticleIDLabel,    matlset, gac, numGhostCells);
-  task->requires(Task::OldDW, d_labels->pNeighborListLabel,  matlset, gnone);
-  task->requires(Task::OldDW, d_labels->pNeighborConnLabel,  matlset, gnone);
   task->requires(Task::OldDW, d_labels->pNeighborCountLabel, matlset, gnone);
+  task->requires(Task::NewDW, d_labels->pNeighborIndexLabel, matlset, gnone);
 
   // Computes 
   task->computes(d_labels->pDefGradLabel_preReloc,        matlset);
@@ -169,10 +167,6 @@ PeridynamicsDefGradComputer::computeDeformationGradient(const Patch* patch,
                                                         d_flags->d_numCellsInHorizon,
                                                         d_labels->pPositionLabel);
 
-  // Create a map that takes particle IDs to the array index in the larger particle subset
-  Uintah::ParticleIDMap familyIdMap;
-  old_dw->createParticleIDMap(familySet, d_labels->pParticleIDLabel, familyIdMap);
-
   // TODO: Create factory for influence functions.  For now set to 1.
   const double pInfluence = 1.0;
 
@@ -188,14 +182,12 @@ PeridynamicsDefGradComputer::computeDeformationGradient(const Patch* patch,
   constParticleVariable<double> pVol_family;
   old_dw->get(pVol_family,  d_labels->pVolumeLabel, familySet);
 
-  constParticleVariable<Uintah::NeighborList> pFamily;
-  old_dw->get(pFamily,      d_labels->pNeighborListLabel,   pset);
-
   constParticleVariable<int> pFamilyCount;
   old_dw->get(pFamilyCount, d_labels->pNeighborCountLabel,  pset);
 
-  constParticleVariable<Uintah::NeighborConnectivity> pFamilyConnected;
-  old_dw->get(pFamilyConnected, d_labels->pNeighborConnLabel,  pset);
+  // The family members resolved into indices in familySet (-1 for broken bonds)
+  constParticleFamilyVariable<int> pFamilyIndex;
+  new_dw->get(pFamilyIndex, d_labels->pNeighborIndexLabel, pset);
 
   // Allocate particle data for computed variables
   ParticleVariable<Matrix3> pDefGrad_new;
@@ -222,12 +214,8 @@ PeridynamicsDefGradComputer::computeDeformationGradient(const Patch* patch,
     for (int ii=0; ii < pFamilyCount[idx]; ii++) {
 
       // If the bond exists
-      if (pFamilyConnected[idx][ii]) {
-
-        // Get Particle Index from Neighbor List
-        long64 pID_family = pFamily[idx][ii];
-        particleIndex family_idx;
-        old_dw->getParticleIndex(familyIdMap, pID_family, family_idx);
+      particleIndex family_idx = pFamilyIndex(idx, ii);
+      if (family_idx >= 0) {
 
         if (dbg.active()) {
           dbg << "\t\t\t Family particle index = " << family_idx 
@@ -33,9 +33,9 @@
 
 #include <Core/Grid/Variables/CellIterator.h>
 #include <Core/Grid/Variables/VarLabel.h>
-#include <Core/Grid/Variables/NeighborList.h>
-#include <Core/Grid/Variables/NeighborConnectivity.h>
+#include <Core/Grid/Variables/ParticleFamilyVariable.h>
 
+#include <Core/Thread/Time.h>
 #include <Core/Util/DebugStream.h>
 
 #include <fstream>
@@ -55,9 +55,8 @@ using Uintah::ParticleVariable;
 using Uintah::constParticleVariable;
 using Uintah::long64;
 using Uintah::Matrix3;
-using Uintah::NeighborList;
-using Uintah::NeighborConnectivity;
-using Uintah::NeighborBondInternalForce;
+using Uintah::ParticleFamilyVariable;
+using Uintah::constParticleFamilyVariable;
 using Uintah::Point;
 using Uintah::IntVector;
 using Uintah::Vector;
@@ -65,11 +64,13 @@ using Uintah::Vector;
 //__________________________________
 //  To turn on debug flags
 //  csh/tcsh : setenv SCI_DEBUG "PDIntForceDoing:+,PDIntForceDebug:+".....
+//  The bond loop timings are reported with "PDIntForceTiming:+"
 //  bash     : export SCI_DEBUG="PDIntForceDoing:+,PDIntForceDebug:+" )
 //  default is OFF
 using Uintah::DebugStream;
 static DebugStream cout_doing("PDIntForceDoing", false);
 static DebugStream cout_dbg("PDIntForceDebug", false);
+static DebugStream cout_time("PDIntForceTiming", false);
 
 
 BondInternalForceComputer::BondInternalForceComputer(PeridynamicsFlags* flags,
@@ -100,15 +101,14 @@ BondInternalForceComputer::addComputesAndRequires(Task* task,
   const MaterialSubset* matlset = matl->thisMaterial();
   
   // List the variables needed for this task to execute
-  task->requires(Task::OldDW, d_label->pParticleIDLabel,         matlset, gac, numGhostCells);
   task->requires(Task::OldDW, d_label->pPositionLabel,           matlset, gac, numGhostCells);
   task->requires(Task::OldDW, d_label->pDisplacementLabel,       matlset, gac, numGhostCells);
   task->requires(Task::NewDW, d_label->pPK1StressLabel_preReloc,      matlset, gac, numGhostCells);
   task->requires(Task::NewDW, d_label->pShapeTensorInvLabel_preReloc, matlset, gac, numGhostCells);
 
-  task->requires(Task::OldDW, d_label->pNeighborListLabel,       matlset, gac, numGhostCells);
-  task->requires(Task::OldDW, d_label->pNeighborConnLabel,       matlset, gac, numGhostCells);
-  task->requires(Task::OldDW, d_label->pNeighborCountLabel,      matlset, gac, numGhostCells);
+  // The family is only needed for the particles in the patch
+  task->requires(Task::OldDW, d_label->pNeighborCountLabel,      matlset, Ghost::None);
+  task->requires(Task::NewDW, d_label->pNeighborIndexLabel,      matlset, Ghost::None);
 
   // List the variables computed by this task
   task->computes(d_label->pNeighborBondForceLabel_preReloc, matlset);
@@ -144,10 +144,6 @@ BondInternalForceComputer::computeInternalForce(const PatchSubset* patches,
                                                           d_flags->d_numCellsInHorizon,
                                                           d_label->pPositionLabel);
 
-    // Create a map that takes particle IDs to the array index in the larger particle subset
-    Uintah::ParticleIDMap familyIdMap;
-    old_dw->createParticleIDMap(familySet, d_label->pParticleIDLabel, familyIdMap);
-
     // Get the particle data needed for damage computation
     constParticleVariable<Point> pPosition, pPosition_family;
     old_dw->get(pPosition,        d_label->pPositionLabel, pset);
@@ -166,15 +162,17 @@ BondInternalForceComputer::computeInternalForce(const PatchSubset* patches,
     constParticleVariable<int> pNeighborCount;
     old_dw->get(pNeighborCount, d_label->pNeighborCountLabel, pset);
 
-    constParticleVariable<NeighborList> pNeighborList;
-    old_dw->get(pNeighborList, d_label->pNeighborListLabel, pset);
-
-    constParticleVariable<NeighborConnectivity> pNeighborConn;
-    old_dw->get(pNeighborConn, d_label->pNeighborConnLabel, pset);
+    // The family members resolved into indices in familySet (-1 for broken bonds)
+    constParticleFamilyVariable<int> pNeighborIndex;
+    new_dw->get(pNeighborIndex, d_label->pNeighborIndexLabel, pset);
 
-    // Initialize variables that will be updated in this task
-    ParticleVariable<NeighborBondInternalForce> pNeighborBondForce_new;
+    // Initialize variables that will be updated in this task.  The bond
+    // forces have the same family structure as the neighbor list.
+    ParticleFamilyVariable<Vector> pNeighborBondForce_new;
     new_dw->allocateAndPut(pNeighborBondForce_new, d_label->pNeighborBondForceLabel_preReloc, pset);
+    pNeighborBondForce_new.copyStructure(pNeighborIndex.getOffsets(), Vector(0.0, 0.0, 0.0));
+
+    double loopStart = Uintah::Time::currentSeconds();
 
     // Loop through particles
     for (ParticleSubset::iterator iter = pset->begin(); iter != pset->end(); iter++) {
@@ -201,21 +199,16 @@ BondInternalForceComputer::computeInternalForce(const PatchSubset* patches,
         std::cout << " \t influence function " << pInfluence << std::endl;  
       }
 
-      // Get the neighbor data
-      NeighborList family = pNeighborList[idx];
-      NeighborConnectivity connected = pNeighborConn[idx];
+      // Get the resolved family indices
+      const int* familyIdx = pNeighborIndex.family(idx);
 
       // Loop through the neighbor list
       int neighborCount = pNeighborCount[idx];
       for (int ii = 0; ii < neighborCount; ii++) {
        
         // If the bond exists
-        if (connected[ii]) {
-
-          // Find the idx of the neighbor
-	  Uintah::ParticleID familyID = family[ii];
-          particleIndex family_idx;
-          old_dw->getParticleIndex(familyIdMap, familyID, family_idx);
+        particleIndex family_idx = familyIdx[ii];
+        if (family_idx >= 0) {
 
           // Find the reference position of the neighbor
           Point family_pos = pPosition_family[family_idx];
@@ -227,7 +220,7 @@ BondInternalForceComputer::computeInternalForce(const PatchSubset* patches,
 
           // Update the bond force
           Vector bond_force_new = cur_force_state*xi;
-          (pNeighborBondForce_new[idx])[ii] = bond_force_new;
+          pNeighborBondForce_new(idx, ii) = bond_force_new;
 
           cout_dbg << " Bond Internal Force: " << std::endl
           	   << "\t Particle = " << idx << " x = " << pPosition[idx] 
@@ -239,6 +232,12 @@ BondInternalForceComputer::computeInternalForce(const PatchSubset* patches,
       }  // End neighbor particle loop
 
     }  // End particle loop
+
+    if (cout_time.active()) {
+      double loopEnd = Uintah::Time::currentSeconds();
+      cout_time << "\t Patch " << patch->getID() << " bonds = " << pNeighborIndex.getOffsets().back()
+                << " bond loop = " << loopEnd - loopStart << " s" << std::endl;
+    }
   }  // End patch loop
 }
 
@@ -33,8 +33,7 @@
 
 #include <Core/Grid/Variables/CellIterator.h>
 #include <Core/Grid/Variables/VarLabel.h>
-#include <Core/Grid/Variables/NeighborList.h>
-#include <Core/Grid/Variables/NeighborConnectivity.h>
+#include <Core/Grid/Variables/ParticleFamilyVariable.h>
 
 #include <Core/Util/DebugStream.h>
 
@@ -53,11 +52,8 @@ using Uintah::MaterialSubset;
 using Uintah::Ghost;
 using Uintah::ParticleVariable;
 using Uintah::constParticleVariable;
-using Uintah::long64;
 using Uintah::Matrix3;
-using Uintah::NeighborList;
-using Uintah::NeighborConnectivity;
-using Uintah::NeighborBondInternalForce;
+using Uintah::constParticleFamilyVariable;
 using Uintah::Point;
 using Uintah::IntVector;
 using Uintah::Vector;
@@ -100,13 +96,18 @@ ParticleInternalForceComputer::addComputesAndRequires(Task* task,
   const MaterialSubset* matlset = matl->thisMaterial();
   
   // List the variables needed for this task to execute
-  task->requires(Task::OldDW, d_label->pParticleIDLabel,         matlset, gac, numGhostCells);
   task->requires(Task::OldDW, d_label->pVolumeLabel,             matlset, gac, numGhostCells);
-
-  task->requires(Task::OldDW, d_label->pNeighborListLabel,               matlset, gac, numGhostCells);
-  task->requires(Task::OldDW, d_label->pNeighborConnLabel,               matlset, gac, numGhostCells);
-  task->requires(Task::OldDW, d_label->pNeighborCountLabel,              matlset, gac, numGhostCells);
-  task->requires(Task::NewDW, d_label->pNeighborBondForceLabel_preReloc, matlset, gac, numGhostCells);
+  task->requires(Task::OldDW, d_label->pPositionLabel,           matlset, gac, numGhostCells);
+  task->requires(Task::OldDW, d_label->pDisplacementLabel,       matlset, gac, numGhostCells);
+  task->requires(Task::NewDW, d_label->pPK1StressLabel_preReloc,      matlset, gac, numGhostCells);
+  task->requires(Task::NewDW, d_label->pShapeTensorInvLabel_preReloc, matlset, gac, numGhostCells);
+
+  // The family variables are not exchanged as ghosts, so the bond forces of
+  // the family particles are recomputed from the quantities above
+  task->requires(Task::OldDW, d_label->pNeighborCountLabel,              matlset, Ghost::None);
+  task->requires(Task::OldDW, d_label->pNeighborRevConnLabel,            matlset, Ghost::None);
+  task->requires(Task::NewDW, d_label->pNeighborIndexLabel,              matlset, Ghost::None);
+  task->requires(Task::NewDW, d_label->pNeighborBondForceLabel_preReloc, matlset, Ghost::None);
 
   // List the variables computed by this task
   task->computes(d_label->pInternalForceLabel_preReloc, matlset);
@@ -122,6 +123,9 @@ ParticleInternalForceComputer::computeInternalForce(const PatchSubset* patches,
   cout_doing << "\t Computing particle internal force: Peridynamics: " 
              << __FILE__ << ":" << __LINE__ << std::endl;
 
+  // Assume influence function is always 1 (**TODO** Compute it using a factory.)
+  double pInfluence = 1.0;
+
   // Loop through patches
   for (int pp = 0; pp < patches->size(); pp++) {
 
@@ -139,31 +143,37 @@ ParticleInternalForceComputer::computeInternalForce(const PatchSubset* patches,
                                                           d_flags->d_numCellsInHorizon,
                                                           d_label->pPositionLabel);
 
-    // Create a map that takes particle IDs to the array index in the larger particle subset
-    Uintah::ParticleIDMap familyIdMap;
-    old_dw->createParticleIDMap(familySet, d_label->pParticleIDLabel, familyIdMap);
-
     // Get the particle data needed for damage computation
-    constParticleVariable<long64> pParticleID;
-    old_dw->get(pParticleID, d_label->pParticleIDLabel, pset);
-
     constParticleVariable<double> pVolume_family;
     old_dw->get(pVolume_family, d_label->pVolumeLabel, familySet);
 
-    constParticleVariable<int> pNeighborCount, pNeighborCount_family;
+    constParticleVariable<Point> pPosition, pPosition_family;
+    old_dw->get(pPosition,        d_label->pPositionLabel, pset);
+    old_dw->get(pPosition_family, d_label->pPositionLabel, familySet);
+
+    constParticleVariable<Vector> pDisp, pDisp_family;
+    old_dw->get(pDisp,        d_label->pDisplacementLabel, pset);
+    old_dw->get(pDisp_family, d_label->pDisplacementLabel, familySet);
+
+    constParticleVariable<Matrix3> pPK1Stress_new_family;
+    new_dw->get(pPK1Stress_new_family, d_label->pPK1StressLabel_preReloc, familySet);
+
+    constParticleVariable<Matrix3> pShapeInv_new_family;
+    new_dw->get(pShapeInv_new_family, d_label->pShapeTensorInvLabel_preReloc, familySet);
+
+    constParticleVariable<int> pNeighborCount;
     old_dw->get(pNeighborCount, d_label->pNeighborCountLabel, pset);
-    old_dw->get(pNeighborCount_family, d_label->pNeighborCountLabel, familySet);
 
-    constParticleVariable<NeighborList> pNeighborList, pNeighborList_family;
-    old_dw->get(pNeighborList, d_label->pNeighborListLabel, pset);
-    old_dw->get(pNeighborList_family, d_label->pNeighborListLabel, familySet);
+    // Whether each family particle still has its bond to this particle
+    constParticleFamilyVariable<int> pNeighborRevConn;
+    old_dw->get(pNeighborRevConn, d_label->pNeighborRevConnLabel, pset);
 
-    constParticleVariable<NeighborConnectivity> pNeighborConn;
-    old_dw->get(pNeighborConn, d_label->pNeighborConnLabel, pset);
+    // The family members resolved into indices in familySet (-1 for broken bonds)
+    constParticleFamilyVariable<int> pNeighborIndex;
+    new_dw->get(pNeighborIndex, d_label->pNeighborIndexLabel, pset);
 
-    constParticleVariable<NeighborBondInternalForce> pNeighborBondForce_new, pNeighborBondForce_new_family;
+    constParticleFamilyVariable<Vector> pNeighborBondForce_new;
     new_dw->get(pNeighborBondForce_new, d_label->pNeighborBondForceLabel_preReloc, pset);
-    new_dw->get(pNeighborBondForce_new_family, d_label->pNeighborBondForceLabel_preReloc, familySet);
 
     // Initialize variables that will be updated in this task
     ParticleVariable<Vector> pInternalForce_new;
@@ -178,50 +188,46 @@ ParticleInternalForceComputer::computeInternalForce(const PatchSubset* patches,
       // Initialize the internal force
       Vector internal_force(0.0);
 
+      // Find the reference position of the current particle
+      Point cur_ref_pos = pPosition[idx] - pDisp[idx];
+
       // Get the neighbor data
-      NeighborList family = pNeighborList[idx];
-      NeighborConnectivity connected = pNeighborConn[idx];
+      const int* familyIdx = pNeighborIndex.family(idx);
+      const int* revConnected = pNeighborRevConn.family(idx);
+      const Vector* bondForce = pNeighborBondForce_new.family(idx);
 
       // Loop through the neighbor list
       int neighborCount = pNeighborCount[idx];
       for (int ii = 0; ii < neighborCount; ii++) {
        
         // If the bond exists
-        if (connected[ii]) {
-
-          // Find the idx of the neighbor
-	  Uintah::ParticleID familyID = family[ii];
-          particleIndex family_idx;
-          old_dw->getParticleIndex(familyIdMap, familyID, family_idx);
+        particleIndex family_idx = familyIdx[ii];
+        if (family_idx >= 0) {
 
           // Get the volume of the neighbor
           double volume = pVolume_family[family_idx];
 
           // Get the bond internal force
-          Vector bond_int_force = (pNeighborBondForce_new[idx])[ii];
+          Vector bond_int_force = bondForce[ii];
 
           // Add force*vol to internal force 
           internal_force += (bond_int_force*volume);
 
-          // Now loop through the neighbor's family and find the bond to
-          // this particle
-          int neighborFamilyCount = pNeighborCount_family[family_idx];
-          for (int jj = 0; jj < neighborFamilyCount; jj++) {
-
-            // If the current particle is in the list
-            if ((pNeighborList_family[family_idx])[jj] == pParticleID[idx]) {
-
-              // Get the bond internal force
-              Vector reverse_bond_int_force = (pNeighborBondForce_new_family[family_idx])[jj];
-
-              // Subtract force*vol from internal force 
-              internal_force -= (reverse_bond_int_force*volume);
-             
-              // Break out of the jj loop
-              break;
-            }
-
-          } // end loop through neighbor's family
+          // The neighbor's bond to this particle may have broken even if
+          // this one has not
+          if (revConnected[ii]) {
+
+            // Compute the neighbor's bond force the same way the bond
+            // internal force computer does
+            Point family_ref_pos = pPosition_family[family_idx] - pDisp_family[family_idx];
+            Vector xi = cur_ref_pos - family_ref_pos;
+            Matrix3 family_force_state = 
+              (pPK1Stress_new_family[family_idx]*pShapeInv_new_family[family_idx])*pInfluence;
+            Vector family_bond_force = family_force_state*xi;
+
+            // Subtract force*vol from internal force 
+            internal_force -= (family_bond_force*volume);
+          }
 
         } // Endif bond connected/broken
       }  // End neighbor particle loop
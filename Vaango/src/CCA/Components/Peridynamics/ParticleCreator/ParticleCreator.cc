@@ -565,6 +565,9 @@ void ParticleCreator::registerPermanentParticleState(PeridynamicsMaterial* matl)
   particle_state.push_back(d_varLabel->pNeighborConnLabel);
   particle_state_preReloc.push_back(d_varLabel->pNeighborConnLabel_preReloc);
   
+  particle_state.push_back(d_varLabel->pNeighborRevConnLabel);
+  particle_state_preReloc.push_back(d_varLabel->pNeighborRevConnLabel_preReloc);
+  
   particle_state.push_back(d_varLabel->pNeighborCountLabel);
   particle_state_preReloc.push_back(d_varLabel->pNeighborCountLabel_preReloc);
   
@@ -53,6 +53,7 @@
 #include <Core/Grid/Variables/NCVariable.h>
 #include <Core/Grid/Variables/NodeIterator.h>
 #include <Core/Grid/Variables/ParticleVariable.h>
+#include <Core/Grid/Variables/ParticleFamilyVariable.h>
 #include <Core/Grid/Variables/PerPatch.h>
 #include <Core/Grid/Variables/SoleVariable.h>
 #include <Core/Grid/Variables/VarTypes.h>
@@ -95,7 +96,8 @@ using Uintah::constNCVariable;
 using Uintah::NodeIterator;
 using Uintah::long64;
 using Uintah::Matrix3;
-using Uintah::NeighborList;
+using Uintah::ParticleFamilyVariable;
+using Uintah::constParticleFamilyVariable;
 using Uintah::Point;
 using Uintah::Vector;
 using Uintah::IntVector;
@@ -765,6 +767,10 @@ Peridynamics::scheduleTimeAdvance(const LevelP & level,
   // Apply any loads that may have been generated due to contact
   scheduleContactMomentumExchangeAfterInterpolate(sched, patches, matls);
 
+  // Resolve the family IDs into indices in the ghosted particle subsets,
+  // which are used by all the bond loops of this timestep
+  scheduleResolveFamilyIndices(sched, patches, matls);
+
   // Compute the peridynamics deformation gradient
   // ** NOTE ** the accuracy of the gradient depends on the density of particles
   //            used to represent a volume of material
@@ -1185,6 +1191,60 @@ Peridynamics::scheduleContactMomentumExchangeAfterInterpolate(SchedulerP& sched,
   d_contactModel->addComputesAndRequiresInterpolated(sched, patches, matls);
 }
 
+/*------------------------------------------------------------------------------------------------
+ *  Method:  scheduleResolveFamilyIndices
+ *  Purpose: This task resolves the family particle IDs into indices in the ghosted
+ *           particle subset.  The families only change at relocation, so this is
+ *           done once per timestep for all the bond loops.
+ * ------------------------------------------------------------------------------------------------
+ */
+void 
+Peridynamics::scheduleResolveFamilyIndices(SchedulerP& sched,
+                                           const PatchSet* patches,
+                                           const MaterialSet* matls)
+{
+  cout_doing << "Doing schedule resolve family indices: Peridynamics " 
+             << ":Processor : " << UintahParallelComponent::d_myworld->myrank() << ":"
+             << __FILE__ << ":" << __LINE__ << std::endl;
+
+  Task* t = scinew Task("Peridynamics::resolveFamilyIndices",
+                        this, &Peridynamics::resolveFamilyIndices);
+
+  int numBodies = d_sharedState->getNumPeridynamicsMatls();
+  for (int body = 0; body < numBodies; body++) {
+    PeridynamicsMaterial* matl = d_sharedState->getPeridynamicsMaterial(body);
+    d_familyComputer->addComputesAndRequires(t, matl, patches);
+  }
+
+  sched->addTask(t, patches, matls);
+}
+
+/*------------------------------------------------------------------------------------------------
+ *  Method:  resolveFamilyIndices
+ *  Purpose: Resolve the family particle IDs into indices in the ghosted particle subset
+ * ------------------------------------------------------------------------------------------------
+ */
+void 
+Peridynamics::resolveFamilyIndices(const ProcessorGroup*,
+                                   const PatchSubset* patches,
+                                   const MaterialSubset* ,
+                                   DataWarehouse* old_dw,
+                                   DataWarehouse* new_dw)
+{
+  cout_doing << "Doing resolve family indices: Peridynamics " 
+             << ":Processor : " << UintahParallelComponent::d_myworld->myrank() << ":"
+             << __FILE__ << ":" << __LINE__ << std::endl;
+
+  for (int p = 0; p < patches->size(); p++) {
+    const Patch* patch = patches->get(p);
+    int numBodies = d_sharedState->getNumPeridynamicsMatls();
+    for (int body = 0; body < numBodies; body++) {
+      PeridynamicsMaterial* matl = d_sharedState->getPeridynamicsMaterial(body);
+      d_familyComputer->resolveFamilyIndices(matl, patch, old_dw, new_dw);
+    } // end matl loop
+  } // end patch loop
+}
+
 /*------------------------------------------------------------------------------------------------
  *  Method:  scheduleComputeDeformationGradient
  *  Purpose: This task sets up the quantities requires for the deformation gradient 
@@ -2329,7 +2389,7 @@ Peridynamics::finalizeParticleState(const ProcessorGroup*,
       old_dw->get(pNeighborCount, d_labels->pNeighborCountLabel, pset);
       cout_dbg << "Got particle neighbor count." << std::endl;
 
-      constParticleVariable<NeighborList> pNeighborList;
+      constParticleFamilyVariable<long64> pNeighborList;
       old_dw->get(pNeighborList, d_labels->pNeighborListLabel, pset);
       cout_dbg << "Got particle neighbor list." << std::endl;
 
@@ -2357,7 +2417,7 @@ Peridynamics::finalizeParticleState(const ProcessorGroup*,
       ParticleVariable<int> pNeighborCount_new;
       new_dw->allocateAndPut(pNeighborCount_new, d_labels->pNeighborCountLabel_preReloc, pset);
 
-      ParticleVariable<NeighborList> pNeighborList_new;
+      ParticleFamilyVariable<long64> pNeighborList_new;
       new_dw->allocateAndPut(pNeighborList_new, d_labels->pNeighborListLabel_preReloc, pset);
 
       // Copy old data to new arrays
@@ -168,6 +168,16 @@ namespace Vaango {
                                                          const Uintah::PatchSet* patches,
                                                          const Uintah::MaterialSet* matls);
 
+    /*! Resolve the families into particle indices once per timestep */
+    void scheduleResolveFamilyIndices(Uintah::SchedulerP& sched, 
+                                      const Uintah::PatchSet* patches,
+                                      const Uintah::MaterialSet* matls);
+    void resolveFamilyIndices(const Uintah::ProcessorGroup*,
+                              const Uintah::PatchSubset* patches,
+                              const Uintah::MaterialSubset* matls,
+                              Uintah::DataWarehouse* old_dw,
+                              Uintah::DataWarehouse* new_dw);
+
     /*! Computation of deformation gradient */
     void scheduleComputeDeformationGradient(Uintah::SchedulerP& sched, 
                                             const Uintah::PatchSet* patches,
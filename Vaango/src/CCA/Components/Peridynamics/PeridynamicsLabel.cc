@@ -25,6 +25,7 @@
 #include <CCA/Components/Peridynamics/PeridynamicsLabel.h>
 #include <Core/Math/Matrix3.h>
 #include <Core/Grid/Variables/ParticleVariable.h>
+#include <Core/Grid/Variables/ParticleFamilyVariable.h>
 #include <Core/Grid/Variables/CCVariable.h>
 #include <Core/Grid/Variables/NCVariable.h>
 #include <Core/Grid/Variables/VarLabel.h>
@@ -153,15 +154,19 @@ PeridynamicsLabel::PeridynamicsLabel()
   pPK1StressLabel = Uintah::VarLabel::create("p.PK1stress",
 			Uintah::ParticleVariable<Uintah::Matrix3>::getTypeDescription() );
   pNeighborListLabel = Uintah::VarLabel::create("p.neighborlist",
-			Uintah::ParticleVariable<Uintah::NeighborList>::getTypeDescription() );
+			Uintah::ParticleFamilyVariable<Uintah::long64>::getTypeDescription() );
   pNeighborConnLabel = Uintah::VarLabel::create("p.neighborconn",
-	                Uintah::ParticleVariable<Uintah::NeighborConnectivity>::getTypeDescription() );
+	                Uintah::ParticleFamilyVariable<int>::getTypeDescription() );
+  pNeighborRevConnLabel = Uintah::VarLabel::create("p.neighborrevconn",
+	                Uintah::ParticleFamilyVariable<int>::getTypeDescription() );
   pNeighborCountLabel =  Uintah::VarLabel::create("p.neighborcount",
 			Uintah::ParticleVariable<int>::getTypeDescription() );
   pNeighborBondEnergyLabel =  Uintah::VarLabel::create("p.bondEnergy",
-			Uintah::ParticleVariable<Uintah::NeighborBondEnergy>::getTypeDescription() );
+			Uintah::ParticleFamilyVariable<double>::getTypeDescription() );
   pNeighborBondForceLabel =  Uintah::VarLabel::create("p.bondForce",
-			Uintah::ParticleVariable<Uintah::NeighborBondInternalForce>::getTypeDescription() );
+			Uintah::ParticleFamilyVariable<Uintah::Vector>::getTypeDescription() );
+  pNeighborIndexLabel =  Uintah::VarLabel::create("p.neighborindex",
+			Uintah::ParticleFamilyVariable<int>::getTypeDescription() );
 
   pPositionStarLabel = Uintah::VarLabel::create( "p.positionstar",
 			Uintah::ParticleVariable<Uintah::Point>::getTypeDescription() );
@@ -185,15 +190,17 @@ PeridynamicsLabel::PeridynamicsLabel()
   pPK1StressLabel_preReloc = Uintah::VarLabel::create("p.PK1stress+",
 			Uintah::ParticleVariable<Uintah::Matrix3>::getTypeDescription() );
   pNeighborListLabel_preReloc = Uintah::VarLabel::create("p.neighborlist+",
-			Uintah::ParticleVariable<Uintah::NeighborList>::getTypeDescription() );
+			Uintah::ParticleFamilyVariable<Uintah::long64>::getTypeDescription() );
   pNeighborConnLabel_preReloc = Uintah::VarLabel::create("p.neighborconn+",
-	                Uintah::ParticleVariable<Uintah::NeighborConnectivity>::getTypeDescription() );
+	                Uintah::ParticleFamilyVariable<int>::getTypeDescription() );
+  pNeighborRevConnLabel_preReloc = Uintah::VarLabel::create("p.neighborrevconn+",
+	                Uintah::ParticleFamilyVariable<int>::getTypeDescription() );
   pNeighborCountLabel_preReloc =  Uintah::VarLabel::create("p.neighborcount+",
 			Uintah::ParticleVariable<int>::getTypeDescription() );
   pNeighborBondEnergyLabel_preReloc =  Uintah::VarLabel::create("p.bondEnergy+",
-			Uintah::ParticleVariable<Uintah::NeighborBondEnergy>::getTypeDescription() );
+			Uintah::ParticleFamilyVariable<double>::getTypeDescription() );
   pNeighborBondForceLabel_preReloc =  Uintah::VarLabel::create("p.bondForce+",
-			Uintah::ParticleVariable<Uintah::NeighborBondInternalForce>::getTypeDescription() );
+			Uintah::ParticleFamilyVariable<Uintah::Vector>::getTypeDescription() );
 
 
 } 
@@ -255,8 +262,10 @@ PeridynamicsLabel::~PeridynamicsLabel()
   Uintah::VarLabel::destroy(pPK1StressLabel);
   Uintah::VarLabel::destroy(pNeighborListLabel);
   Uintah::VarLabel::destroy(pNeighborConnLabel);
+  Uintah::VarLabel::destroy(pNeighborRevConnLabel);
   Uintah::VarLabel::destroy(pNeighborCountLabel);
   Uintah::VarLabel::destroy(pNeighborBondEnergyLabel);
+  Uintah::VarLabel::destroy(pNeighborIndexLabel);
 
   Uintah::VarLabel::destroy(pPositionStarLabel);
   Uintah::VarLabel::destroy(pDisplacementStarLabel);
@@ -268,6 +277,7 @@ PeridynamicsLabel::~PeridynamicsLabel()
   Uintah::VarLabel::destroy(pPK1StressLabel_preReloc);
   Uintah::VarLabel::destroy(pNeighborListLabel_preReloc);
   Uintah::VarLabel::destroy(pNeighborConnLabel_preReloc);
+  Uintah::VarLabel::destroy(pNeighborRevConnLabel_preReloc);
   Uintah::VarLabel::destroy(pNeighborCountLabel_preReloc);
   Uintah::VarLabel::destroy(pNeighborBondEnergyLabel_preReloc);
   //--------------------------------------
@@ -123,12 +123,15 @@ namespace Vaango
       const Uintah::VarLabel* pNeighborListLabel_preReloc;  
       const Uintah::VarLabel* pNeighborConnLabel;           // Store the neighbor connectivity for each particle
       const Uintah::VarLabel* pNeighborConnLabel_preReloc; 
+      const Uintah::VarLabel* pNeighborRevConnLabel;        // Store the connectivity of the family's bonds to each particle
+      const Uintah::VarLabel* pNeighborRevConnLabel_preReloc; 
       const Uintah::VarLabel* pNeighborCountLabel;          // Store the neighbor count for each particle
       const Uintah::VarLabel* pNeighborCountLabel_preReloc; 
       const Uintah::VarLabel* pNeighborBondEnergyLabel;     // Store the neighbor strain energy for each particle
       const Uintah::VarLabel* pNeighborBondEnergyLabel_preReloc; 
       const Uintah::VarLabel* pNeighborBondForceLabel;     // Store the neighbor internal force for each particle
       const Uintah::VarLabel* pNeighborBondForceLabel_preReloc; 
+      const Uintah::VarLabel* pNeighborIndexLabel;         // Family members resolved to indices in the ghosted subset
 
     };
 
@@ -0,0 +1,188 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2015-     Parresia Research Limited, New Zealand
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef VAANGO_CCA_COMPONENTS_SCHEDULERS_DEPENDENCYCACHE_H
+#define VAANGO_CCA_COMPONENTS_SCHEDULERS_DEPENDENCYCACHE_H
+
+#include <Core/Geometry/IntVector.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Uintah {
+
+  /**
+   *  @class  DependencyCache
+   *  @brief  The detailed dependencies created by the last compile of a task graph
+   *
+   *  The grid, the tasks and the detailed tasks are all recreated before a
+   *  recompile, so everything is stored by position (task index in the sorted
+   *  task list, patch level and extra cell box) instead of by pointer.
+   *
+   *  When the task graph has the same tasks as in the last compile,
+   *  TaskGraph::createDetailedDependencies replays the stored dependencies of a
+   *  detailed task instead of searching for them again, unless a patch within
+   *  the ghost cell reach of the task's patches has been added, removed,
+   *  reassigned or moved in or out of the neighborhood.  After a regrid that
+   *  usually leaves the coarse levels (and the fine patches a regridder
+   *  kept with their IDs) to be replayed.  Every replayed dependency is
+   *  checked against this compile's tasks and patches first, and with
+   *  <Scheduler><checkIncrementalRecompile> also against the dependencies a
+   *  full compile creates.
+   *
+   *  Only the creation of the detailed dependencies is incremental: the
+   *  detailed tasks, message tags, local tasks and scrub counts are still
+   *  computed from scratch on every compile.
+   *
+   *  SchedulerCommon keeps one DependencyCache per task graph
+   *  (<Scheduler><incrementalRecompile>).
+   */
+  struct DependencyCache {
+
+    // A patch, identified by its level and extra cell box
+    struct PatchKey {
+      PatchKey() : level(-1) {}
+      PatchKey(int level, const IntVector& low, const IntVector& high)
+        : level(level), low(low), high(high) {}
+
+      bool operator<(const PatchKey& other) const
+      {
+        if (level != other.level) {
+          return level < other.level;
+        }
+        for (int i = 0; i < 3; i++) {
+          if (low[i] != other.low[i]) {
+            return low[i] < other.low[i];
+          }
+        }
+        for (int i = 0; i < 3; i++) {
+          if (high[i] != other.high[i]) {
+            return high[i] < other.high[i];
+          }
+        }
+        return false;
+      }
+
+      bool operator==(const PatchKey& other) const
+      {
+        return level == other.level && low == other.low && high == other.high;
+      }
+
+      int       level;
+      IntVector low;
+      IntVector high;
+    };
+
+    // What the dependencies on a patch depend on besides its position
+    struct PatchState {
+      bool operator==(const PatchState& other) const
+      {
+        return owner == other.owner && oldOwner == other.oldOwner && inNeighborhood == other.inNeighborhood;
+      }
+
+      int  owner;
+      int  oldOwner;
+      bool inNeighborhood;
+    };
+
+    // A detailed task: index of its task in the sorted task list, level
+    // index and ID of the first patch of its patch subset and index of its
+    // material subset.  The patch subset indices are not used as they change
+    // with the load balance.  A task without patches has level and patch -1,
+    // the send old data task of a processor is (-1, -1, proc, -1).
+    struct TaskKey {
+      TaskKey() : task(-1), level(-1), patch(-1), matls(-1) {}
+      TaskKey(int task, int level, int patch, int matls)
+        : task(task), level(level), patch(patch), matls(matls) {}
+
+      bool operator<(const TaskKey& other) const
+      {
+        if (task != other.task) {
+          return task < other.task;
+        }
+        if (level != other.level) {
+          return level < other.level;
+        }
+        if (patch != other.patch) {
+          return patch < other.patch;
+        }
+        return matls < other.matls;
+      }
+
+      bool operator==(const TaskKey& other) const
+      {
+        return task == other.task && level == other.level && patch == other.patch && matls == other.matls;
+      }
+
+      int task;
+      int level;
+      int patch;
+      int matls;
+    };
+
+    // The arguments of a DetailedTasks::possiblyCreateDependency call
+    struct Dependency {
+      TaskKey   from;
+      int       comp;       // index in the computes and modifies of the creator (-1 for none)
+      PatchKey  fromPatch;
+      int       req;        // index in the requires of the requiring task
+      PatchKey  toPatch;
+      int       matl;
+      IntVector low;
+      IntVector high;
+      int       cond;       // DetailedDep::CommCondition
+
+      bool operator==(const Dependency& other) const
+      {
+        return from == other.from && comp == other.comp && fromPatch == other.fromPatch && req == other.req &&
+               toPatch == other.toPatch && matl == other.matl && low == other.low && high == other.high &&
+               cond == other.cond;
+      }
+    };
+
+    struct TaskRecord {
+      std::vector<PatchKey>   patches;   // patches of the detailed task
+      std::vector<Dependency> deps;
+    };
+
+    DependencyCache() : valid(false) {}
+
+    void clear()
+    {
+      valid = false;
+      taskSignatures.clear();
+      patchStates.clear();
+      tasks.clear();
+    }
+
+    bool                            valid;
+    std::vector<std::string>        taskSignatures;  // one per task in the sorted task list
+    std::map<PatchKey, PatchState>  patchStates;
+    std::map<TaskKey, TaskRecord>   tasks;
+  };
+
+} // End namespace Uintah
+
+#endif // VAANGO_CCA_COMPONENTS_SCHEDULERS_DEPENDENCYCACHE_H
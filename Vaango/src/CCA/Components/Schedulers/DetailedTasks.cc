@@ -35,6 +35,7 @@
 #include <Core/Grid/Grid.h>
 #include <Core/Grid/Variables/PSPatchMatlGhostRange.h>
 #include <Core/Thread/Mutex.h>
+#include <Core/Thread/Thread.h>
 #include <Core/Containers/ConsecutiveRangeSet.h>
 #include <Core/Util/DebugStream.h>
 #include <Core/Util/FancyAssert.h>
@@ -80,6 +81,7 @@ DetailedTasks::DetailedTasks(SchedulerCommon* sc,
   first(first),
   taskgraph_(taskgraph),
   mustConsiderInternalDependencies_(mustConsiderInternalDependencies),
+  numReadyQueues_(0),
   currentDependencyGeneration_(1),
   extraCommunication_(0),
   readyQueueLock_("DetailedTasks Ready Queue"),
@@ -1079,11 +1081,19 @@ void DetailedTask::checkExternalDepCount()
       cerrLock.unlock();
     }
 
-    if (externallyReady_ == false) {
-      taskGroup->mpiCompletedTasks_.push(this);
+    bool push = (externallyReady_ == false);
+    if (push) {
+      if (taskGroup->numReadyQueues_ == 0) {
+        taskGroup->mpiCompletedTasks_.push(this);
+      }
       externallyReady_ = true;
     }
     taskGroup->mpiCompletedQueueLock_.writeUnlock();
+
+    // The lock only guards externallyReady_ when the ready queues are per-thread
+    if (push && taskGroup->numReadyQueues_ > 0) {
+      taskGroup->mpiCompletedTaskQueues_.push(this, Thread::self()->myid());
+    }
   }
 }
 
@@ -1302,6 +1312,10 @@ void DetailedTasks::internalDependenciesSatisfied(DetailedTask* task)
     mixedDebug << "Begin internalDependenciesSatisfied\n";
     cerrLock.unlock();
   }
+  if (numReadyQueues_ > 0) {
+    readyTaskQueues_.push(task, Thread::self()->myid());
+    return;
+  }
   readyQueueLock_.writeLock();
   {
 
@@ -1319,6 +1333,9 @@ void DetailedTasks::internalDependenciesSatisfied(DetailedTask* task)
 DetailedTask*
 DetailedTasks::getNextInternalReadyTask()
 {
+  if (numReadyQueues_ > 0) {
+    return readyTaskQueues_.pop(Thread::self()->myid());
+  }
   DetailedTask* nextTask = NULL;
   readyQueueLock_.writeLock();
   {
@@ -1333,6 +1350,9 @@ DetailedTasks::getNextInternalReadyTask()
 
 int DetailedTasks::numInternalReadyTasks()
 {
+  if (numReadyQueues_ > 0) {
+    return readyTaskQueues_.size();
+  }
   int size = 0;
   readyQueueLock_.readLock();
   {
@@ -1345,6 +1365,9 @@ int DetailedTasks::numInternalReadyTasks()
 DetailedTask*
 DetailedTasks::getNextExternalReadyTask()
 {
+  if (numReadyQueues_ > 0) {
+    return mpiCompletedTaskQueues_.pop(Thread::self()->myid());
+  }
   DetailedTask* nextTask = NULL;
   mpiCompletedQueueLock_.writeLock();
   {
@@ -1359,6 +1382,9 @@ DetailedTasks::getNextExternalReadyTask()
 
 int DetailedTasks::numExternalReadyTasks()
 {
+  if (numReadyQueues_ > 0) {
+    return mpiCompletedTaskQueues_.size();
+  }
   int size = 0;
   mpiCompletedQueueLock_.readLock();
   {
@@ -1432,9 +1458,36 @@ void DetailedTasks::addCompletionPendingDeviceTask(DetailedTask* dtask)
 
 #endif  // HAVE_CUDA
 
+void DetailedTasks::setNumReadyQueues(int numQueues)
+{
+  numReadyQueues_ = numQueues;
+}
+
+long long DetailedTasks::numStolenTasks(int queue) const
+{
+  if (numReadyQueues_ == 0) {
+    return 0;
+  }
+  return readyTaskQueues_.numSteals(queue) + mpiCompletedTaskQueues_.numSteals(queue);
+}
+
 void DetailedTasks::initTimestep()
 {
-  readyTasks_ = initiallyReadyTasks_;
+  // Also resets the steal counts of the threads
+  readyTaskQueues_.resize(numReadyQueues_);
+  mpiCompletedTaskQueues_.resize(numReadyQueues_);
+  if (numReadyQueues_ > 0) {
+    // Deal the initially ready tasks out to the threads in order, so that
+    // the high priority ones are started first on every thread
+    TaskQueue initiallyReady(initiallyReadyTasks_);
+    for (int i = 0; !initiallyReady.empty(); i++) {
+      readyTaskQueues_.push(initiallyReady.front(), i);
+      initiallyReady.pop();
+    }
+  }
+  else {
+    readyTasks_ = initiallyReadyTasks_;
+  }
   incrementDependencyGeneration();
   initializeBatches();
 }
@@ -39,6 +39,7 @@
 #include <Core/Thread/Mutex.h>
 #include <Core/Thread/CrowdMonitor.h>
 #include <Core/Thread/ConditionVariable.h>
+#include <Core/Thread/AtomicCounter.h>
 #include <list>
 #include <queue>
 #include <vector>
@@ -362,6 +363,127 @@ namespace Uintah {
     bool operator()(DetailedTask*& ltask, DetailedTask*& rtask);
   };
 
+  // Per-thread ready queues with work stealing.
+  //
+  // A task is pushed on the queue of the thread that made it ready, and a
+  // thread pops from its own queue before it steals from the others
+  // (starting with the next queue).  Every queue has its own lock, so
+  // threads only contend when they steal.  Queue is either a std::queue or a
+  // std::priority_queue of DetailedTask*: task priorities are kept within a
+  // queue, and only approximately across the queues.
+  template <class Queue>
+  class WorkStealingTaskQueues {
+  public:
+    WorkStealingTaskQueues() : size_("WorkStealingTaskQueues size", 0) {}
+
+    ~WorkStealingTaskQueues() { resize(0); }
+
+    // Replace the queues by numQueues empty ones and reset the steal counts
+    void resize(int numQueues)
+    {
+      for (unsigned int i = 0; i < queues_.size(); i++) {
+        delete queues_[i];
+      }
+      queues_.clear();
+      for (int i = 0; i < numQueues; i++) {
+        queues_.push_back(new ThreadQueue());
+      }
+      size_.set(0);
+    }
+
+    int numQueues() const { return (int)queues_.size(); }
+
+    // Total number of queued tasks (a snapshot, other threads may be
+    // pushing or popping concurrently)
+    int size() const { return (int)(long long)size_; }
+
+    void push(DetailedTask* task, int queue)
+    {
+      ThreadQueue* tq = queues_[queue % queues_.size()];
+      tq->lock.lock();
+      tq->tasks.push(task);
+      tq->lock.unlock();
+      size_++;
+    }
+
+    // Next task of the given queue, otherwise the next task of the first
+    // non-empty queue after it.  Returns NULL if all the queues are empty.
+    DetailedTask* pop(int queue)
+    {
+      if (size() == 0) {
+        return NULL;
+      }
+      int nq = (int)queues_.size();
+      int me = queue % nq;
+      DetailedTask* task = popFrom(queues_[me], true);
+
+      // A locked victim is busy with its own work: try the next one first,
+      // then wait for the locked ones if there are still queued tasks
+      for (int pass = 0; pass < 2 && task == NULL; pass++) {
+        for (int k = 1; k < nq && task == NULL; k++) {
+          task = popFrom(queues_[(me + k) % nq], pass == 1);
+        }
+        if (task != NULL) {
+          queues_[me]->lock.lock();
+          queues_[me]->steals++;
+          queues_[me]->lock.unlock();
+        }
+        if (size() == 0) {
+          break;
+        }
+      }
+      return task;
+    }
+
+    // Number of tasks the thread owning the given queue has stolen
+    long long numSteals(int queue) const
+    {
+      ThreadQueue* tq = queues_[queue % queues_.size()];
+      tq->lock.lock();
+      long long steals = tq->steals;
+      tq->lock.unlock();
+      return steals;
+    }
+
+  private:
+
+    struct ThreadQueue {
+      ThreadQueue() : lock("WorkStealingTaskQueues queue lock"), steals(0) {}
+      Mutex lock;
+      Queue tasks;
+      long long steals;
+    };
+
+    static DetailedTask* next(std::queue<DetailedTask*>& tasks) { return tasks.front(); }
+
+    template <class Container, class Compare>
+    static DetailedTask* next(std::priority_queue<DetailedTask*, Container, Compare>& tasks) { return tasks.top(); }
+
+    DetailedTask* popFrom(ThreadQueue* tq, bool wait)
+    {
+      if (wait) {
+        tq->lock.lock();
+      }
+      else if (!tq->lock.tryLock()) {
+        return NULL;
+      }
+      DetailedTask* task = NULL;
+      if (!tq->tasks.empty()) {
+        task = next(tq->tasks);
+        tq->tasks.pop();
+        size_--;
+      }
+      tq->lock.unlock();
+      return task;
+    }
+
+    std::vector<ThreadQueue*> queues_;
+    AtomicCounter size_;
+
+    WorkStealingTaskQueues(const WorkStealingTaskQueues&);
+    WorkStealingTaskQueues& operator=(const WorkStealingTaskQueues&);
+  };
+
   class DetailedTasks {
   public:
     DetailedTasks(SchedulerCommon* sc,
@@ -412,6 +534,8 @@ namespace Uintah {
 
     void emitEdges(ProblemSpecP edgesElement, int rank);
 
+    // With per-thread ready queues, starts with the queue of the calling
+    // thread (see setNumReadyQueues)
     DetailedTask* getNextInternalReadyTask();
 
     int numInternalReadyTasks();
@@ -448,6 +572,19 @@ namespace Uintah {
 
     QueueAlg getTaskPriorityAlg() { return taskPriorityAlg_; }
 
+    // Use numQueues per-thread ready queues with work stealing instead of the
+    // shared ready queues (numQueues = 0).  Pushes and pops both use the queue
+    // of the calling thread's Uintah thread id (Thread::myid(), modulo
+    // numQueues), so a task made ready by a thread is found first by that
+    // thread.  Takes effect at the next initTimestep().
+    void setNumReadyQueues(int numQueues);
+
+    int numReadyQueues() const { return numReadyQueues_; }
+
+    // Number of ready tasks taken from other queues by the threads that use
+    // the given queue, since the last initTimestep()
+    long long numStolenTasks(int queue) const;
+
 #ifdef HAVE_CUDA
     void addInitiallyReadyDeviceTask(DetailedTask* dtask);
     void addCompletionPendingDeviceTask(DetailedTask* dtask);
@@ -532,6 +669,12 @@ namespace Uintah {
     TaskQueue   initiallyReadyTasks_;
     TaskPQueue  mpiCompletedTasks_;
 
+    // Per-thread versions of readyTasks_ and mpiCompletedTasks_, used
+    // instead of them when numReadyQueues_ > 0
+    int numReadyQueues_;
+    WorkStealingTaskQueues<TaskQueue>   readyTaskQueues_;
+    WorkStealingTaskQueues<TaskPQueue>  mpiCompletedTaskQueues_;
+
     // This "generation" number is to keep track of which InternalDependency
     // links have been satisfied in the current timestep and avoids the
     // need to traverse all InternalDependency links to reset values.
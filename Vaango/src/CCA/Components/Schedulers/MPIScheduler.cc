@@ -33,7 +33,10 @@
 #include <CCA/Ports/LoadBalancer.h>
 #include <CCA/Ports/Output.h>
 
+#include <Core/Disclosure/TypeDescription.h>
+#include <Core/Parallel/Parallel.h>
 #include <Core/Parallel/ProcessorGroup.h>
+#include <Core/ProblemSpec/ProblemSpec.h>
 #include <Core/Grid/Variables/ParticleSubset.h>
 #include <Core/Grid/Variables/ComputeSet.h>
 #include <Core/Malloc/Allocator.h>
@@ -88,6 +91,7 @@ MPIScheduler::MPIScheduler( const ProcessorGroup * myworld,
   oport_(oport),
   numMessages_(0),
   messageVolume_(0),
+  usePersistentRequests_(false),
   recvLock("MPI receive lock"),
   sendLock("MPI send lock"),
   dlbLock("loadbalancer lock"),
@@ -114,12 +118,26 @@ void
 MPIScheduler::problemSetup(const ProblemSpecP& prob_spec,
                            SimulationStateP& state)
 {
+  ProblemSpecP params = prob_spec->findBlock("Scheduler");
+  if (params) {
+    params->get("persistentMPIRequests", usePersistentRequests_);
+  }
+#ifdef USE_PACKING
+  if (usePersistentRequests_) {
+    proc0cout << "   Using persistent MPI requests for dependency batches\n";
+  }
+#else
+  usePersistentRequests_ = false;
+#endif
+
   log.problemSetup(prob_spec);
   SchedulerCommon::problemSetup(prob_spec, state);
 }
 
 MPIScheduler::~MPIScheduler()
 {
+  freePersistentRequests();
+
   if (timeout.active()) {
     timingStats.close();
     if (d_myworld->myrank() == 0) {
@@ -136,6 +154,7 @@ MPIScheduler::createSubScheduler()
   UintahParallelPort* lbp = getPort("load balancer");
   newsched->attachPort("load balancer", lbp);
   newsched->d_sharedState=d_sharedState;
+  newsched->usePersistentRequests_ = usePersistentRequests_;
   return newsched;
 }
 
@@ -276,6 +295,8 @@ MPIScheduler::runTask( DetailedTask* task,
       if (!d_sharedState->isCopyDataTimestep() && task->getTask()->getType() != Task::Output) {
         //add contribution for patchlist
         getLoadBalancer()->addContribution(task, total_task_time);
+        // the threaded scheduler passes the index of its worker thread
+        getLoadBalancer()->addThreadContribution(thread_id, total_task_time);
       }
     }
   }
@@ -341,6 +362,7 @@ MPIScheduler::postMPISends( DetailedTask* task,
 
   int numSend = 0;
   int volSend = 0;
+  std::vector<MPI_Request> persistentStarts;
 
   // Send data to dependendents
   for(DependencyBatch* batch = task->getComputes();
@@ -358,6 +380,7 @@ MPIScheduler::postMPISends( DetailedTask* task,
 
     std::ostringstream ostr;
     ostr.clear();
+    bool hasParticles = false;
     for(DetailedDep* req = batch->head; req != 0; req = req->next){
 
       ostr << *req << ' '; // for CommRecMPI::add()
@@ -421,6 +444,9 @@ MPIScheduler::postMPISends( DetailedTask* task,
       MPIScheduler* top = this;
       while(top->parentScheduler_) top = top->parentScheduler_;
 
+      if (req->req->var->typeDescription()->getType() == TypeDescription::ParticleVariable) {
+        hasParticles = true;
+      }
       dw->sendMPI(batch, posLabel, mpibuff, posDW, req, lb);
     }
 
@@ -431,8 +457,16 @@ MPIScheduler::postMPISends( DetailedTask* task,
       void* buf;
       int count;
       MPI_Datatype datatype;
+      PersistentRequest* persistent = 0;
      
 #ifdef USE_PACKING
+      if (usePersistentRequests_ && !hasParticles) {
+        persistent = getPersistentRequest(persistentSends_, batch, to,
+                                          mpibuff.packedSize(d_myworld->getComm()));
+        if (persistent->buffer) {
+          mpibuff.setPackedBuffer(persistent->buffer);
+        }
+      }
       mpibuff.get_type(buf, count, datatype, d_myworld->getComm());
       mpibuff.pack(d_myworld->getComm(), count);
 #else
@@ -459,9 +493,26 @@ MPIScheduler::postMPISends( DetailedTask* task,
       volSend += count * typeSize;
 
       MPI_Request requestid;
-      MPI_Isend(buf, count, datatype, to, batch->messageTag,
-                d_myworld->getComm(), &requestid);
+      bool isPersistent = (persistent && persistent->buffer);
+      if (isPersistent) {
+        // the packed count can differ from the packed size, so it is checked as well
+        if (persistent->request != MPI_REQUEST_NULL && persistent->count != count) {
+          MPI_Request_free(&persistent->request);
+        }
+        if (persistent->request == MPI_REQUEST_NULL) {
+          MPI_Send_init(buf, count, datatype, to, batch->messageTag,
+                        d_myworld->getComm(), &persistent->request);
+          persistent->count = count;
+        }
+        persistentStarts.push_back(persistent->request);
+        requestid = persistent->request;
+      } else {
+        MPI_Isend(buf, count, datatype, to, batch->messageTag,
+                  d_myworld->getComm(), &requestid);
+      }
       int bytes = count;
+      log.logBatchPost(true, batch->messageTag, to, bytes, isPersistent,
+                       Time::currentSeconds() - start);
 
       sendLock.writeLock();
       sends_[thread_id].add( requestid, bytes, mpibuff.takeSendlist(), ostr.str(), batch->messageTag );
@@ -472,6 +523,8 @@ MPIScheduler::postMPISends( DetailedTask* task,
     }
   } // end for (DependencyBatch * batch = task->getComputes() )
 
+  startPersistentRequests(persistentStarts, true);
+
   double dsend = Time::currentSeconds()-sendstart;
   mpi_info_.totalsend += dsend;
 
@@ -529,6 +582,7 @@ MPIScheduler::postMPIRecvs( DetailedTask* task,
   //std::vector<DependencyBatch*>::iterator sorted_iter = sorted_reqs.begin();
 
   // Receive any of the foreign requires
+  std::vector<MPI_Request> persistentStarts;
   recvLock.writeLock();
   {
     for(auto sorted_iter = sorted_reqs.begin(); sorted_iter != sorted_reqs.end(); sorted_iter++) {
@@ -574,6 +628,7 @@ MPIScheduler::postMPIRecvs( DetailedTask* task,
 
       std::ostringstream ostr;
       ostr.clear();
+      bool hasParticles = false;
       // Create the MPI type
       for(DetailedDep* req = batch->head; req != 0; req = req->next){
 
@@ -636,6 +691,9 @@ MPIScheduler::postMPIRecvs( DetailedTask* task,
         MPIScheduler* top = this;
         while(top->parentScheduler_) top = top->parentScheduler_;
 
+        if (req->req->var->typeDescription()->getType() == TypeDescription::ParticleVariable) {
+          hasParticles = true;
+        }
         dw->recvMPI(batch, mpibuff, posDW, req, lb);
 
         if (!req->isNonDataDependency()) {
@@ -652,8 +710,18 @@ MPIScheduler::postMPIRecvs( DetailedTask* task,
         void* buf;
         int count;
         MPI_Datatype datatype;
+        int from = batch->fromTask->getAssignedResourceIndex();
+        ASSERTRANGE(from, 0, d_myworld->size());
+        PersistentRequest* persistent = 0;
 
 #ifdef USE_PACKING
+        if (usePersistentRequests_ && !hasParticles) {
+          persistent = getPersistentRequest(persistentRecvs_, batch, from,
+                                            mpibuff.packedSize(d_myworld->getComm()));
+          if (persistent->buffer) {
+            mpibuff.setPackedBuffer(persistent->buffer);
+          }
+        }
         mpibuff.get_type(buf, count, datatype, d_myworld->getComm());
 #else
         mpibuff.get_type(buf, count, datatype);
@@ -663,8 +731,6 @@ MPIScheduler::postMPIRecvs( DetailedTask* task,
         //we need this empty message to enforce modify after read dependencies 
         //if(count>0)
         //{
-        int from = batch->fromTask->getAssignedResourceIndex();
-        ASSERTRANGE(from, 0, d_myworld->size());
         MPI_Request requestid;
 
         if (mpidbg.active()) {
@@ -674,9 +740,22 @@ MPIScheduler::postMPIRecvs( DetailedTask* task,
           cerrLock.unlock();
         }
 
-        MPI_Irecv(buf, count, datatype, from, batch->messageTag,
-                  d_myworld->getComm(), &requestid);
+        bool isPersistent = (persistent && persistent->buffer);
+        if (isPersistent) {
+          if (persistent->request == MPI_REQUEST_NULL) {
+            MPI_Recv_init(buf, count, datatype, from, batch->messageTag,
+                          d_myworld->getComm(), &persistent->request);
+            persistent->count = count;
+          }
+          persistentStarts.push_back(persistent->request);
+          requestid = persistent->request;
+        } else {
+          MPI_Irecv(buf, count, datatype, from, batch->messageTag,
+                    d_myworld->getComm(), &requestid);
+        }
         int bytes = count;
+        log.logBatchPost(false, batch->messageTag, from, bytes, isPersistent,
+                         Time::currentSeconds() - start);
         recvs_.add(requestid, bytes,
                    scinew ReceiveHandler(p_mpibuff, pBatchRecvHandler),
                    ostr.str(), batch->messageTag);
@@ -701,6 +780,8 @@ MPIScheduler::postMPIRecvs( DetailedTask* task,
 #endif        
       }
     } // end for
+
+    startPersistentRequests(persistentStarts, false);
   }
   recvLock.writeUnlock();
 
@@ -709,6 +790,78 @@ MPIScheduler::postMPIRecvs( DetailedTask* task,
 
 } // end postMPIRecvs()
 
+MPIScheduler::PersistentRequest*
+MPIScheduler::getPersistentRequest( PersistentRequestMap & requests,
+                                    DependencyBatch      * batch,
+                                    int                    peer,
+                                    int                    size )
+{
+  PersistentRequest& persistent = requests[std::make_pair(batch, size)];
+
+  // A batch of a new task graph can have the address of a deleted one
+  if (persistent.peer != peer || persistent.tag != batch->messageTag) {
+    freePersistentRequest(persistent);
+    persistent.peer = peer;
+    persistent.tag = batch->messageTag;
+  }
+
+  persistent.numPosts++;
+  if (persistent.numPosts > 1 && !persistent.buffer) {
+    persistent.buffer = scinew PackedBuffer(size);
+    persistent.buffer->addReference();
+  }
+  return &persistent;
+}
+
+void
+MPIScheduler::startPersistentRequests( std::vector<MPI_Request> & requests,
+                                       bool                       send )
+{
+  if (requests.empty()) {
+    return;
+  }
+  double start = Time::currentSeconds();
+  MPI_Startall((int)requests.size(), &requests[0]);
+  double time = Time::currentSeconds() - start;
+  log.logStartall(send, (int)requests.size(), time);
+  if (send) {
+    mpi_info_.totalsendmpi += time;
+  } else {
+    mpi_info_.totalrecvmpi += time;
+  }
+}
+
+void
+MPIScheduler::freePersistentRequest( PersistentRequest & persistent )
+{
+  // The requests are inactive here: all sends and receives of a timestep
+  // are completed in execute()
+  if (persistent.request != MPI_REQUEST_NULL) {
+    MPI_Request_free(&persistent.request);
+    persistent.request = MPI_REQUEST_NULL;
+  }
+  if (persistent.buffer && persistent.buffer->removeReference()) {
+    delete persistent.buffer;
+  }
+  persistent.buffer = 0;
+  persistent.count = 0;
+  persistent.numPosts = 0;
+}
+
+void
+MPIScheduler::freePersistentRequests()
+{
+  PersistentRequestMap::iterator iter;
+  for (iter = persistentSends_.begin(); iter != persistentSends_.end(); iter++) {
+    freePersistentRequest(iter->second);
+  }
+  for (iter = persistentRecvs_.begin(); iter != persistentRecvs_.end(); iter++) {
+    freePersistentRequest(iter->second);
+  }
+  persistentSends_.clear();
+  persistentRecvs_.clear();
+}
+
 void
 MPIScheduler::processMPIRecvs(int how_much)
 {
@@ -998,6 +1151,14 @@ MPIScheduler::outputTimingStats(const char* label)
   emitTime("NumPatches", myPatches->size());
   emitTime("NumCells", numCells);
   emitTime("NumParticles", numParticles);
+
+  // contended DataWarehouse locks since the last output (the wait time is
+  // part of the task time, so it is not summed either)
+  unsigned long long lockWaits;
+  double lockWaitTime;
+  DWLock::getContention(lockWaits, lockWaitTime);
+  emitTime("NumDWLockWaits", lockWaits);
+  emitTime("NumDWLockWaitTime", lockWaitTime);
   std::vector<double> d_totaltimes(d_times.size());
   std::vector<double> d_maxtimes(d_times.size());
   std::vector<double> d_avgtimes(d_times.size());
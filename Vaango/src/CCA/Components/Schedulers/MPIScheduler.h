@@ -113,6 +113,8 @@ DESCRIPTION
     void compile() {
       numMessages_=0;
       messageVolume_=0;
+      log.finishBatchTimings();
+      freePersistentRequests();
       SchedulerCommon::compile();
     }
 
@@ -180,6 +182,39 @@ DESCRIPTION
     unsigned int numMessages_;
     double messageVolume_;
 
+    // A persistent MPI request and packed buffer for the message of a
+    // DependencyBatch.  Only batches of grid variables are persistent: their
+    // shape is fixed until the task graph is recompiled, while particle
+    // messages change size every timestep.  The conditional dependencies
+    // (first/subsequent iteration, output timesteps) still give a grid batch a
+    // few packed sizes, so the requests are keyed on the batch and the packed
+    // size.  A request is created the second time its key is posted and is
+    // started with MPI_Startall after that.
+    struct PersistentRequest {
+      PersistentRequest()
+        : request(MPI_REQUEST_NULL), buffer(0), peer(-1), tag(-1), count(0), numPosts(0) {}
+      MPI_Request   request;
+      PackedBuffer* buffer;
+      int           peer;
+      int           tag;
+      int           count;     // count the request was created with
+      int           numPosts;  // posts with this packed size
+    };
+    typedef std::map<std::pair<DependencyBatch*, int>, PersistentRequest> PersistentRequestMap;
+
+    bool usePersistentRequests_;
+    PersistentRequestMap persistentSends_;
+    PersistentRequestMap persistentRecvs_;
+
+    // Returns the persistent request of the batch for the given packed size,
+    // with a buffer if the batch has been posted with that size before
+    PersistentRequest* getPersistentRequest(PersistentRequestMap& requests, DependencyBatch* batch,
+                                            int peer, int size);
+    // Starts the given persistent requests with one MPI_Startall
+    void startPersistentRequests(std::vector<MPI_Request>& requests, bool send);
+    void freePersistentRequest(PersistentRequest& persistent);
+    void freePersistentRequests();
+
     //-------------------------------------------------------------------------
     // The following locks are for multi-threaded schedulers that derive from MPIScheduler
     //   This eliminates miles of unnecessarily redundant code in threaded schedulers
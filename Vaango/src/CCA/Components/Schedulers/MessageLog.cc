@@ -43,12 +43,15 @@ using namespace std;
 extern Uintah::Mutex       cerrLock;
 
 MessageLog::MessageLog( const ProcessorGroup * myworld, const Output * oport ) :
-  d_enabled(false), d_myworld(myworld), d_oport(oport)
+  d_enabled(false), d_myworld(myworld), d_oport(oport),
+  d_numPosts(0), d_numPersistentPosts(0), d_numStarts(0),
+  d_postTime(0), d_persistentPostTime(0), d_startTime(0)
 {
 }
 
 MessageLog::~MessageLog()
 {
+   finishBatchTimings();
 }
 
 void MessageLog::problemSetup(const ProblemSpecP& prob_spec)
@@ -116,10 +119,84 @@ void MessageLog::logRecv(const DetailedReq* /*dep*/, int /*bytes*/,
 }
 #endif
 
+void MessageLog::logBatchPost(bool send, int messageTag, int peer, int bytes,
+                              bool persistent, double postTime)
+{
+   if(!d_enabled)
+      return;
+   int me = d_myworld->myrank();
+   cerrLock.lock();
+   out << (send ? "send" : "recv") << "\t";
+   out << setprecision(8) << Time::currentSeconds() << "\t";
+   out << bytes << "\t-\t-\t";
+   out << (send ? me : peer) << "\t" << (send ? peer : me) << "\t";
+   out << "batch " << messageTag << "\t";
+   out << (persistent ? "persistent" : "new") << " post " << postTime << '\n';
+   d_numPosts++;
+   d_postTime += postTime;
+   BatchTiming& timing = d_batchTimings[make_pair(messageTag, send)];
+   timing.numPosts++;
+   timing.bytes = bytes;
+   if(persistent){
+      d_numPersistentPosts++;
+      d_persistentPostTime += postTime;
+      timing.numPersistentPosts++;
+      timing.persistentPostTime += postTime;
+   } else {
+      timing.postTime += postTime;
+   }
+   cerrLock.unlock();
+}
+
+void MessageLog::logStartall(bool send, int numRequests, double startTime)
+{
+   if(!d_enabled)
+      return;
+   cerrLock.lock();
+   out << (send ? "send" : "recv") << "\t";
+   out << setprecision(8) << Time::currentSeconds() << "\t";
+   out << "startall " << numRequests << " requests " << startTime << '\n';
+   d_numStarts += numRequests;
+   d_startTime += startTime;
+   cerrLock.unlock();
+}
+
 void MessageLog::finishTimestep()
 {
    if(!d_enabled)
       return;
+   if(d_numPosts > 0){
+      out << "timestep\t" << setprecision(8) << Time::currentSeconds() << "\t"
+          << d_numPosts << " posts (" << d_numPersistentPosts << " persistent) in "
+          << d_postTime << " s, persistent posts " << d_persistentPostTime << " s, "
+          << d_numStarts << " started in " << d_startTime << " s\n";
+   }
+   d_numPosts = 0;
+   d_numPersistentPosts = 0;
+   d_numStarts = 0;
+   d_postTime = 0;
+   d_persistentPostTime = 0;
+   d_startTime = 0;
+   out.flush();
+}
+
+void MessageLog::finishBatchTimings()
+{
+   if(!d_enabled || d_batchTimings.empty())
+      return;
+   // average posting time of each batch, with and without a persistent request
+   out << "batch\tdirection\tsize\tposts\tpersistent\tnew post\tpersistent post\n";
+   map<pair<int, bool>, BatchTiming>::iterator iter;
+   for(iter = d_batchTimings.begin(); iter != d_batchTimings.end(); iter++){
+      const BatchTiming& timing = iter->second;
+      int numNew = timing.numPosts - timing.numPersistentPosts;
+      out << iter->first.first << "\t" << (iter->first.second ? "send" : "recv") << "\t"
+          << timing.bytes << "\t" << timing.numPosts << "\t" << timing.numPersistentPosts << "\t"
+          << setprecision(4) << (numNew > 0 ? timing.postTime / numNew : 0) << "\t"
+          << (timing.numPersistentPosts > 0 ? timing.persistentPostTime / timing.numPersistentPosts : 0)
+          << '\n';
+   }
+   d_batchTimings.clear();
    out.flush();
 }
 
@@ -28,6 +28,7 @@
 #include <Core/ProblemSpec/ProblemSpecP.h>
 #include <Core/Grid/Task.h>
 #include <fstream>
+#include <map>
 
 namespace Uintah {
   class ProcessorGroup;
@@ -75,8 +76,20 @@ namespace Uintah {
       void logRecv(const DetailedReq* dep, int bytes,
                    const char* msg = 0);
 #endif
+      // Log the time spent posting the message of a DependencyBatch
+      // (packing and MPI_Isend/MPI_Irecv, or the setup of a persistent request)
+      void logBatchPost(bool send, int messageTag, int peer, int bytes,
+                        bool persistent, double postTime);
+
+      // Log the MPI_Startall of the persistent requests posted by a task
+      void logStartall(bool send, int numRequests, double startTime);
+
       void finishTimestep();
 
+      // Write the posting times of each batch since the last call and
+      // start over (the message tags change when the graph is recompiled)
+      void finishBatchTimings();
+
    private:
 
       bool                   d_enabled;
@@ -84,6 +97,25 @@ namespace Uintah {
       const Output         * d_oport;
 
       std::ofstream          out;
+
+      // posting statistics of the current timestep
+      int                    d_numPosts;
+      int                    d_numPersistentPosts;
+      int                    d_numStarts;
+      double                 d_postTime;
+      double                 d_persistentPostTime;
+      double                 d_startTime;
+
+      // posting statistics of each batch, by message tag and direction
+      struct BatchTiming {
+        BatchTiming() : numPosts(0), numPersistentPosts(0), bytes(0), postTime(0), persistentPostTime(0) {}
+        int                  numPosts;
+        int                  numPersistentPosts;
+        int                  bytes;
+        double               postTime;
+        double               persistentPostTime;
+      };
+      std::map<std::pair<int, bool>, BatchTiming> d_batchTimings;
       
       MessageLog(const MessageLog&);
       MessageLog& operator=(const MessageLog&);
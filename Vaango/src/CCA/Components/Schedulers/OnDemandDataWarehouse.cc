@@ -89,6 +89,7 @@ static DebugStream gpudbg( "GPUDataWarehouse", false );
 static DebugStream warn( "OnDemandDataWarehouse_warn", true );
 static DebugStream particles("DWParticles", false);
 static DebugStream particles2("DWParticles2", false);
+static DebugStream ghostcopies("DWGhostCopies", false);
 
 extern DebugStream mpidbg;
 
@@ -106,6 +107,10 @@ struct ParticleSend : public RefCounted {
 #define DAV_DEBUG 0
 
 bool OnDemandDataWarehouse::d_combineMemory=true;
+bool OnDemandDataWarehouse::d_persistentGhostCells=false;
+
+std::atomic<unsigned long long> DWLock::s_waits(0);
+std::atomic<unsigned long long> DWLock::s_waitNanoseconds(0);
 
 OnDemandDataWarehouse::OnDemandDataWarehouse(const ProcessorGroup* myworld,
                                              Scheduler* scheduler,
@@ -113,10 +118,9 @@ OnDemandDataWarehouse::OnDemandDataWarehouse(const ProcessorGroup* myworld,
                                              const GridP& grid,
                                              bool isInitializationDW/*=false*/)
   : DataWarehouse(myworld, scheduler, generation),
+    d_ghostBytesCopied(0),
+    d_ghostViews(0),
     d_lock("DataWarehouse lock"),
-    d_lvlock("DataWarehouse level lock"),
-    d_plock("DataWarehouse particle subset lock"),
-    d_pslock("DataWarehouse particle state lock"),
     d_finalized( false ),
     d_grid(grid),
     d_isInitializationDW(isInitializationDW),
@@ -154,6 +158,12 @@ OnDemandDataWarehouse::OnDemandDataWarehouse(const ProcessorGroup* myworld,
 //
 OnDemandDataWarehouse::~OnDemandDataWarehouse()
 {
+  if (ghostcopies.active()) {
+    coutLock.lock();
+    ghostcopies << d_myworld->myrank() << " DW " << getID() << ": " << d_ghostBytesCopied
+                << " bytes copied into ghost cells, " << d_ghostViews << " ghost cell views\n";
+    coutLock.unlock();
+  }
   clear();
 }
 
@@ -162,26 +172,38 @@ OnDemandDataWarehouse::~OnDemandDataWarehouse()
 void 
 OnDemandDataWarehouse::clear()
 {
-  d_plock.writeLock();
-  for (auto iter = d_psetDB.begin(); iter != d_psetDB.end(); iter++) {
-    if(iter->second->removeReference())
+  for (int s = 0; s < ShardedDatabase<psetDBType>::NUM_SHARDS; s++) {
+    ShardedDatabase<psetDBType>::Shard& psets = d_psetDB.shard(s);
+    psets.lock.writeLock();
+    for (auto iter = psets.map.begin(); iter != psets.map.end(); iter++) {
+      if(iter->second->removeReference())
+        delete iter->second;
+    }
+    psets.map.clear();
+    psets.lock.writeUnlock();
+
+    ShardedDatabase<psetDBType>::Shard& delsets = d_delsetDB.shard(s);
+    delsets.lock.writeLock();
+    for (auto iter = delsets.map.begin(); iter != delsets.map.end(); iter++) {
+      if(iter->second->removeReference())
+        delete iter->second;
+    }
+    delsets.map.clear();
+    delsets.lock.writeUnlock();
+
+    ShardedDatabase<psetAddDBType>::Shard& addsets = d_addsetDB.shard(s);
+    addsets.lock.writeLock();
+    for (auto iter = addsets.map.begin(); iter != addsets.map.end(); iter++) {
+      ParticleLabelVariableMap::const_iterator pvar_itr;
+      for (pvar_itr = iter->second->begin(); pvar_itr != iter->second->end();
+           pvar_itr++)
+        delete pvar_itr->second;
       delete iter->second;
+    }
+    addsets.map.clear();
+    addsets.lock.writeUnlock();
   }
 
-  for (auto iter = d_delsetDB.begin(); iter != d_delsetDB.end(); iter++) {
-    if(iter->second->removeReference())
-      delete iter->second;
-  }
-
-  for (auto iter = d_addsetDB.begin(); iter != d_addsetDB.end(); iter++) {
-    ParticleLabelVariableMap::const_iterator pvar_itr;
-    for (pvar_itr = iter->second->begin(); pvar_itr != iter->second->end();
-         pvar_itr++)
-      delete pvar_itr->second;
-    delete iter->second;
-  }
-  d_plock.writeUnlock();
-
   d_lock.writeLock();
   for (dataLocationDBtype::const_iterator iter = d_dataLocation.begin();
        iter != d_dataLocation.end(); iter++) {
@@ -191,6 +213,8 @@ OnDemandDataWarehouse::clear()
   }
   d_lock.writeUnlock();
 
+  clearHaloViews();
+
   d_varDB.clear();
   d_levelDB.clear();
 
@@ -229,6 +253,9 @@ OnDemandDataWarehouse::unfinalize()
   // this is for processes that need to make small modifications to the DW
   // after it has been finalized.
   d_finalized=false;
+
+  // the stored ghost cell windows may not match the modified variables
+  clearHaloViews();
 }
 
 //__________________________________
@@ -352,6 +379,12 @@ OnDemandDataWarehouse::exists(const VarLabel* label,
 bool
 OnDemandDataWarehouse::exists(const VarLabel* label) const
 {
+  // the database of a finalized DW is no longer modified (scrubs are
+  // atomic), so it can be read without the lock
+  if (d_finalized) {
+    return d_levelDB.exists(label, -1, 0);
+  }
+
   d_lock.readLock();
   
   // level-independent reduction vars can be stored with a null level
@@ -1018,8 +1051,11 @@ OnDemandDataWarehouse::printParticleSubsets()
   cout << "-- Particle Subsets: \n\n";
   psetDBType::iterator iter;
   cout << d_myworld->myrank() << " Availabel psets on DW " << d_generation << ":\n";
-  for (iter = d_psetDB.begin(); iter != d_psetDB.end(); iter++) {
-    cout << d_myworld->myrank() << " " <<*(iter->second) << endl;
+  for (int s = 0; s < ShardedDatabase<psetDBType>::NUM_SHARDS; s++) {
+    psetDBType& psets = d_psetDB.shard(s).map;
+    for (iter = psets.begin(); iter != psets.end(); iter++) {
+      cout << d_myworld->myrank() << " " <<*(iter->second) << endl;
+    }
   }
   cout << "----------------------------------------------\n";
 }
@@ -1027,7 +1063,7 @@ OnDemandDataWarehouse::printParticleSubsets()
 //______________________________________________________________________
 //
 void 
-OnDemandDataWarehouse::insertPSetRecord(psetDBType &subsetDB,
+OnDemandDataWarehouse::insertPSetRecord(ShardedDatabase<psetDBType> &subsetDB,
                                         const Patch* patch,
                                         IntVector low, 
                                         IntVector high,
@@ -1051,16 +1087,17 @@ OnDemandDataWarehouse::insertPSetRecord(psetDBType &subsetDB,
   }
 #endif
 
-  d_plock.writeLock();
+  ShardedDatabase<psetDBType>::Shard& psets = subsetDB.shard(patch);
+  psets.lock.writeLock();
   psetDBType::key_type key(patch->getRealPatch(), matlIndex, getID());
-  subsetDB.insert(pair<psetDBType::key_type,ParticleSubset*>(key,psubset));
+  psets.map.insert(pair<psetDBType::key_type,ParticleSubset*>(key,psubset));
   psubset->addReference();
-  d_plock.writeUnlock();
+  psets.lock.writeUnlock();
 }
 
 //______________________________________________________________________
 ParticleSubset* 
-OnDemandDataWarehouse::queryPSetDB(psetDBType &subsetDB, 
+OnDemandDataWarehouse::queryPSetDB(ShardedDatabase<psetDBType> &subsetDB, 
                                    const Patch* patch,                      
                                    int matlIndex,                           
                                    IntVector low,                           
@@ -1075,8 +1112,9 @@ OnDemandDataWarehouse::queryPSetDB(psetDBType &subsetDB,
   int best_volume = INT_MAX;
   int target_volume = Region::getVolume(low,high);
 
-  d_plock.readLock();
-  pair<psetDBType::const_iterator, psetDBType::const_iterator> ret = subsetDB.equal_range(key);
+  ShardedDatabase<psetDBType>::Shard& psets = subsetDB.shard(patch);
+  psets.lock.readLock();
+  pair<psetDBType::const_iterator, psetDBType::const_iterator> ret = psets.map.equal_range(key);
   
   //search multimap for best subset
   //cout << "Patch = " << patch << " matlIndex = " << matlIndex
@@ -1119,7 +1157,7 @@ OnDemandDataWarehouse::queryPSetDB(psetDBType &subsetDB,
   }
   //std::cout << "2: exact = " << exact << " best_volume = " << best_volume
   //          << " target volume = " << target_volume << std::endl;
-  d_plock.readUnlock();
+  psets.lock.readUnlock();
 
   if(exact && best_volume!=target_volume) {
     return 0;
@@ -1146,10 +1184,10 @@ OnDemandDataWarehouse::queryPSetDB(psetDBType &subsetDB,
   }
 
   //save subset for future queries
-  d_plock.writeLock();
-  subsetDB.insert(pair<psetDBType::key_type,ParticleSubset*>(key,newsubset));
+  psets.lock.writeLock();
+  psets.map.insert(pair<psetDBType::key_type,ParticleSubset*>(key,newsubset));
   newsubset->addReference();
-  d_plock.writeUnlock();
+  psets.lock.writeUnlock();
 
   return newsubset;
 }
@@ -1417,9 +1455,10 @@ OnDemandDataWarehouse::createParticleIDMap(ParticleSubset* pset,
   get(pParticleID, partIDLabel, pset);
 
   // Loop through particle subset
+  partIDMap.reserve(pset->numParticles());
   for (ParticleSubset::iterator iter = pset->begin(); iter != pset->end(); ++iter) {
     particleIndex idx = *iter;
-    partIDMap.insert(std::pair<long64, int>(pParticleID[idx], idx));
+    partIDMap.insert(pParticleID[idx], idx);
   }
 }
 
@@ -1435,12 +1474,10 @@ OnDemandDataWarehouse::getParticleIndex(const ParticleIDMap& partIDMap,
                         __FILE__, __LINE__);
   }
 
-  auto mapPair = partIDMap.find(pParticleID);
-  if (mapPair == partIDMap.end()) {
+  if (!partIDMap.find(pParticleID, pParticleIndex)) {
     throw InternalError("Could not find the input particle ID in the ID->index map..", 
                         __FILE__, __LINE__);
   }
-  pParticleIndex = mapPair->second;
 }
 
 //______________________________________________________________________
@@ -1465,16 +1502,18 @@ OnDemandDataWarehouse::getDeleteSubset(int matlIndex,
 ParticleLabelVariableMap* 
 OnDemandDataWarehouse::getNewParticleState(int matlIndex, const Patch* patch)
 {
-  d_pslock.readLock();
   const Patch* realPatch = (patch != 0) ? patch->getRealPatch() : 0;
+  ShardedDatabase<psetAddDBType>::Shard& addsets = d_addsetDB.shard(realPatch);
+  addsets.lock.readLock();
   psetAddDBType::key_type key(matlIndex, realPatch);
-  psetAddDBType::iterator iter = d_addsetDB.find(key);
-  if(iter == d_addsetDB.end()){
-    d_pslock.readUnlock();
+  psetAddDBType::iterator iter = addsets.map.find(key);
+  if(iter == addsets.map.end()){
+    addsets.lock.readUnlock();
     return 0;
   }
-  d_pslock.readUnlock();
-  return iter->second;
+  ParticleLabelVariableMap* state = iter->second;
+  addsets.lock.readUnlock();
+  return state;
 }
 
 
@@ -2542,11 +2581,60 @@ OnDemandDataWarehouse::emit(OutputContext& oc,
                             const VarLabel* label,
                             int matlIndex, 
                             const Patch* patch)
+{
+  IntVector l, h;
+  Variable* var = getEmitVariable(label, matlIndex, patch, l, h);
+  var->emit(oc, l, h, label->getCompressionMode());
+}
+//______________________________________________________________________
+//
+Variable*
+OnDemandDataWarehouse::snapshot(const VarLabel* label,
+                                int matlIndex,
+                                const Patch* patch,
+                                IntVector& low,
+                                IntVector& high)
+{
+  Variable* var = getEmitVariable(label, matlIndex, patch, low, high);
+
+  // Deep copies: variables transferred to the next DataWarehouse share
+  // their data with this one and may be modified there
+  if (GridVariableBase* v = dynamic_cast<GridVariableBase*>(var)) {
+    GridVariableBase* copy = v->cloneType();
+    copy->allocate(v);
+    copy->copyData(v);
+    return copy;
+  }
+  if (ParticleVariableBase* v = dynamic_cast<ParticleVariableBase*>(var)) {
+    ParticleVariableBase* copy = v->cloneType();
+    copy->allocate(v->getParticleSubset());
+    copy->copyData(v);
+    return copy;
+  }
+  if (ReductionVariableBase* v = dynamic_cast<ReductionVariableBase*>(var)) {
+    return v->clone();
+  }
+  if (SoleVariableBase* v = dynamic_cast<SoleVariableBase*>(var)) {
+    return v->clone();
+  }
+  if (PerPatchBase* v = dynamic_cast<PerPatchBase*>(var)) {
+    return v->clone();
+  }
+  SCI_THROW(InternalError("snapshot: unknown variable type for " + label->getName(),
+                          __FILE__, __LINE__));
+}
+//______________________________________________________________________
+//
+Variable*
+OnDemandDataWarehouse::getEmitVariable(const VarLabel* label,
+                                       int matlIndex,
+                                       const Patch* patch,
+                                       IntVector& l,
+                                       IntVector& h)
 {
   checkGetAccess(label, matlIndex, patch);
 
   Variable* var = NULL;
-  IntVector l, h;
   if(patch) {
     // Save with the boundary layer, otherwise restarting from the DataArchive won't work.
     patch->computeVariableExtents( label->typeDescription()->getType(),
@@ -2597,7 +2685,7 @@ OnDemandDataWarehouse::emit(OutputContext& oc,
   if (var == NULL) {
     SCI_THROW(UnknownVariable(label->getName(), getID(), patch, matlIndex, "on emit", __FILE__, __LINE__));
   }
-  var->emit(oc, l, h, label->getCompressionMode());
+  return var;
 }
 //______________________________________________________________________
 //
@@ -2626,27 +2714,28 @@ OnDemandDataWarehouse::deleteParticles(ParticleSubset* delset)
   Patch* patch = (Patch*) delset->getPatch();
   const Patch* realPatch = (patch != 0) ? patch->getRealPatch() : 0;
 
-  d_pslock.writeLock();
+  ShardedDatabase<psetDBType>::Shard& delsets = d_delsetDB.shard(realPatch);
+  delsets.lock.writeLock();
   psetDBType::key_type key(realPatch, matlIndex, getID());
-  psetDBType::iterator iter = d_delsetDB.find(key);
+  psetDBType::iterator iter = delsets.map.find(key);
   ParticleSubset* currentDelset;
-  if(iter != d_delsetDB.end()) { //update existing delset
+  if(iter != delsets.map.end()) { //update existing delset
     //    SCI_THROW(InternalError("deleteParticles called twice for patch", __FILE__, __LINE__));
     // Concatenate the delsets into the delset that already exists in the DB.
     currentDelset = iter->second;
     for (ParticleSubset::iterator d=delset->begin(); d != delset->end(); d++)
       currentDelset->addParticle(*d);
    
-    d_delsetDB.erase(key);
-    d_delsetDB.insert(pair<psetDBType::key_type,ParticleSubset*>(key,currentDelset));
+    delsets.map.erase(key);
+    delsets.map.insert(pair<psetDBType::key_type,ParticleSubset*>(key,currentDelset));
 
     delete delset;
 
   } else {
-    d_delsetDB.insert(pair<psetDBType::key_type,ParticleSubset*>(key,delset));
+    delsets.map.insert(pair<psetDBType::key_type,ParticleSubset*>(key,delset));
     delset->addReference();
   }
-  d_pslock.writeUnlock();
+  delsets.lock.writeUnlock();
 }
 //______________________________________________________________________
 //
@@ -2655,17 +2744,18 @@ OnDemandDataWarehouse::addParticles(const Patch* patch,
                                     int matlIndex,
                                     ParticleLabelVariableMap* addedState)
 {
-  d_pslock.writeLock();
+  ShardedDatabase<psetAddDBType>::Shard& addsets = d_addsetDB.shard(patch);
+  addsets.lock.writeLock();
   psetAddDBType::key_type key(matlIndex, patch);
-  psetAddDBType::iterator iter = d_addsetDB.find(key);
-  if(iter  != d_addsetDB.end()) 
+  psetAddDBType::iterator iter = addsets.map.find(key);
+  if(iter  != addsets.map.end()) 
     // SCI_THROW(InternalError("addParticles called twice for patch", __FILE__, __LINE__));
     cerr << "addParticles called twice for patch" << endl;
   
   else
-    d_addsetDB[key]=addedState;
+    addsets.map[key]=addedState;
   
-  d_pslock.writeUnlock();
+  addsets.lock.writeUnlock();
 }
 //______________________________________________________________________
 //
@@ -2690,6 +2780,9 @@ OnDemandDataWarehouse::decrementScrubCount(const VarLabel* var,
     //cout << d_myworld->myrank() << " DW " << getID() << " caught exception.\n";
     //throw e;
     //}
+    if (count == 0 && d_persistentGhostCells) {
+      scrubHaloView(var, matlIndex, patch);
+    }
     break;
   case TypeDescription::ParticleVariable:
     count = d_varDB.decrementScrubCount(var, matlIndex, patch);
@@ -2755,6 +2848,9 @@ OnDemandDataWarehouse::scrub(const VarLabel* var,
   case TypeDescription::PerPatch:
   case TypeDescription::ParticleVariable:
     d_varDB.scrub(var, matlIndex, patch);
+    if (d_persistentGhostCells) {
+      scrubHaloView(var, matlIndex, patch);
+    }
     break;
   case TypeDescription::SoleVariable:
     SCI_THROW(InternalError("scrub called for sole variable: "+var->getName(), __FILE__, __LINE__));
@@ -2786,6 +2882,21 @@ OnDemandDataWarehouse::getGridVar(GridVariableBase& var,
   Patch::VariableBasis basis = Patch::translateTypeToBasis(label->typeDescription()->getType(), false);
   ASSERTEQ(basis,Patch::translateTypeToBasis(var.virtualGetTypeDescription()->getType(), true));  
 
+  // The variables of a finalized DW don't change, so a ghost cell window
+  // filled for an earlier request can be shared
+  bool persistentHalo = d_persistentGhostCells && d_finalized && gtype != Ghost::None &&
+                        numGhostCells > 0 && !patch->isVirtual();
+  if (persistentHalo) {
+    IntVector lowIndex, highIndex;
+    patch->computeVariableExtents(basis, label->getBoundaryLayer(),
+                                  gtype, numGhostCells,
+                                  lowIndex, highIndex);
+    if (getHaloView(var, label, matlIndex, patch, lowIndex, highIndex)) {
+      d_ghostViews++;
+      return;
+    }
+  }
+
   if(!d_varDB.exists(label, matlIndex, patch)) {
     //print();
     cout << d_myworld->myrank() << " unable to find variable '" << label->getName() << " on patch: " << patch->getID() << " matl: " << matlIndex << endl;
@@ -2920,11 +3031,20 @@ OnDemandDataWarehouse::getGridVar(GridVariableBase& var,
                << " source var range: "  << srcvar->getLow() << " " << srcvar->getHigh() << endl;
           throw e;
         }
-        delete srcvar;
         dn = high-low;
         total+=dn.x()*dn.y()*dn.z();
+        if (srcvar->getBasePointer() != var.getBasePointer()) {
+          IntVector size = var.getHigh() - var.getLow();
+          d_ghostBytesCopied += (unsigned long long)dn.x()*dn.y()*dn.z()*
+                                (var.getDataSize()/(size.x()*size.y()*size.z()));
+        }
+        delete srcvar;
       } //end if neigbor
     } //end for neigbours 
+
+    if (persistentHalo) {
+      putHaloView(var, label, matlIndex, patch);
+    }
     
     //dn = highIndex - lowIndex;
     //long wanted = dn.x()*dn.y()*dn.z();
@@ -2933,6 +3053,93 @@ OnDemandDataWarehouse::getGridVar(GridVariableBase& var,
 }
 //______________________________________________________________________
 //
+bool
+OnDemandDataWarehouse::getHaloView(GridVariableBase& var,
+                                   const VarLabel* label,
+                                   int matlIndex,
+                                   const Patch* patch,
+                                   const IntVector& lowIndex,
+                                   const IntVector& highIndex)
+{
+  bool found = false;
+  ShardedDatabase<haloDBType>::Shard& halos = d_haloDB.shard(patch);
+  halos.lock.readLock();
+  haloDBType::const_iterator iter = halos.map.find(VarLabelMatl<Patch>(label, matlIndex, patch));
+  if (iter != halos.map.end()) {
+    GridVariableBase* halo = iter->second;
+    if (Min(halo->getLow(), lowIndex) == halo->getLow() && Max(halo->getHigh(), highIndex) == halo->getHigh()) {
+      var.copyPointer(*halo);
+      found = true;
+    }
+  }
+  halos.lock.readUnlock();
+
+  if (found) {
+    USE_IF_ASSERTS_ON(bool no_realloc =) var.rewindow(lowIndex, highIndex);
+    ASSERT(no_realloc);
+  }
+  return found;
+}
+//______________________________________________________________________
+//
+void
+OnDemandDataWarehouse::putHaloView(GridVariableBase& var,
+                                   const VarLabel* label,
+                                   int matlIndex,
+                                   const Patch* patch)
+{
+  VarLabelMatl<Patch> key(label, matlIndex, patch);
+  ShardedDatabase<haloDBType>::Shard& halos = d_haloDB.shard(patch);
+  halos.lock.writeLock();
+  haloDBType::iterator iter = halos.map.find(key);
+  if (iter == halos.map.end()) {
+    halos.map[key] = var.clone();
+  }
+  else {
+    // keep the larger window (another thread may have stored one meanwhile)
+    const GridVariableBase* halo = iter->second;
+    IntVector size = halo->getHigh() - halo->getLow();
+    IntVector newSize = var.getHigh() - var.getLow();
+    if (newSize.x()*newSize.y()*newSize.z() > size.x()*size.y()*size.z()) {
+      delete iter->second;
+      iter->second = var.clone();
+    }
+  }
+  halos.lock.writeUnlock();
+}
+//______________________________________________________________________
+//
+void
+OnDemandDataWarehouse::scrubHaloView(const VarLabel* label,
+                                     int matlIndex,
+                                     const Patch* patch)
+{
+  ShardedDatabase<haloDBType>::Shard& halos = d_haloDB.shard(patch);
+  halos.lock.writeLock();
+  haloDBType::iterator iter = halos.map.find(VarLabelMatl<Patch>(label, matlIndex, patch));
+  if (iter != halos.map.end()) {
+    delete iter->second;
+    halos.map.erase(iter);
+  }
+  halos.lock.writeUnlock();
+}
+//______________________________________________________________________
+//
+void
+OnDemandDataWarehouse::clearHaloViews()
+{
+  for (int s = 0; s < ShardedDatabase<haloDBType>::NUM_SHARDS; s++) {
+    ShardedDatabase<haloDBType>::Shard& halos = d_haloDB.shard(s);
+    halos.lock.writeLock();
+    for (haloDBType::iterator iter = halos.map.begin(); iter != halos.map.end(); iter++) {
+      delete iter->second;
+    }
+    halos.map.clear();
+    halos.lock.writeUnlock();
+  }
+}
+//______________________________________________________________________
+//
 void OnDemandDataWarehouse::transferFrom(DataWarehouse* from,
                                          const VarLabel* var,
                                          const PatchSubset* patches,
@@ -3020,14 +3227,17 @@ void OnDemandDataWarehouse::logMemoryUse(ostream& out,
   d_varDB.logMemoryUse(out, total, tag, dwid);
 
   // Log the psets.
-  for(psetDBType::iterator iter = d_psetDB.begin(); iter != d_psetDB.end(); iter++){
-    ParticleSubset* pset = iter->second;
-    ostringstream elems;
-    elems << pset->numParticles();
-    logMemory(out, total, tag, "particles", "ParticleSubset", pset->getPatch(),
-              pset->getMatlIndex(), elems.str(),
-              pset->numParticles()*sizeof(particleIndex),
-              pset->getPointer(), dwid);
+  for (int s = 0; s < ShardedDatabase<psetDBType>::NUM_SHARDS; s++) {
+    psetDBType& psets = d_psetDB.shard(s).map;
+    for(psetDBType::iterator iter = psets.begin(); iter != psets.end(); iter++){
+      ParticleSubset* pset = iter->second;
+      ostringstream elems;
+      elems << pset->numParticles();
+      logMemory(out, total, tag, "particles", "ParticleSubset", pset->getPatch(),
+                pset->getMatlIndex(), elems.str(),
+                pset->numParticles()*sizeof(particleIndex),
+                pset->getPointer(), dwid);
+    }
   }
 }
 //______________________________________________________________________
@@ -32,11 +32,13 @@
 #include <CCA/Ports/DataWarehouse.h>
 #include <CCA/Components/Schedulers/OnDemandDataWarehouseP.h>
 #include <CCA/Components/Schedulers/DWDatabase.h>
+#include <CCA/Components/Schedulers/ShardedDatabase.h>
 #include <CCA/Components/Schedulers/SendState.h>
 #include <Core/Grid/Variables/VarLabelMatl.h>
 #include <Core/Grid/Variables/PSPatchMatlGhost.h>
 #include <Core/Grid/Grid.h>
 
+#include <atomic>
 #include <map>
 #include <iosfwd>
 #include <vector>
@@ -245,7 +247,6 @@ Center for the Simulation of Accidental Fires and Explosions (C-SAFE)
 
     // Create a map between the long64 particleIDs and the particle indices in a 
     // ParticleSubset
-    typedef std::map<long64, int> ParticleIDMap;
     void createParticleIDMap(ParticleSubset* pset,
                              const VarLabel* partIDLabel,
                              ParticleIDMap& partIDMap);
@@ -417,6 +418,12 @@ Center for the Simulation of Accidental Fires and Explosions (C-SAFE)
                       int matlIndex, 
                       const Patch* patch);
 
+    virtual Variable* snapshot(const VarLabel* label,
+                               int matlIndex,
+                               const Patch* patch,
+                               IntVector& low,
+                               IntVector& high);
+
     void exchangeParticleQuantities(DetailedTasks* dts, 
                                     LoadBalancer* lb, 
                                     const VarLabel* pos_var, 
@@ -486,6 +493,11 @@ Center for the Simulation of Accidental Fires and Explosions (C-SAFE)
 
     static bool d_combineMemory;
 
+    // Keep the ghost cell windows filled by getGridVar in a finalized DW, so
+    // that later requests for the same or fewer ghost cells get a view of
+    // them instead of copying the neighbor patches again
+    static bool d_persistentGhostCells;
+
     friend class SchedulerCommon;
     friend class UnifiedScheduler;
 
@@ -550,8 +562,35 @@ Center for the Simulation of Accidental Fires and Explosions (C-SAFE)
                     Ghost::GhostType gtype, 
                     int numGhostCells);
 
+    // Persistent ghost cell windows (d_persistentGhostCells).  getHaloView
+    // returns false if no stored window covers [lowIndex, highIndex).
+    bool getHaloView(GridVariableBase& var,
+                     const VarLabel* label,
+                     int matlIndex,
+                     const Patch* patch,
+                     const IntVector& lowIndex,
+                     const IntVector& highIndex);
+
+    void putHaloView(GridVariableBase& var,
+                     const VarLabel* label,
+                     int matlIndex,
+                     const Patch* patch);
+
+    void scrubHaloView(const VarLabel* label,
+                       int matlIndex,
+                       const Patch* patch);
+
+    void clearHaloViews();
+
     inline Task::WhichDW getWhichDW( RunningTaskInfo *info);
 
+    // The variable emit() and snapshot() write and its extents
+    Variable* getEmitVariable(const VarLabel* label,
+                              int matlIndex,
+                              const Patch* patch,
+                              IntVector& low,
+                              IntVector& high);
+
     // These will throw an exception if access is not allowed for the
     // curent task.
     inline void checkGetAccess(const VarLabel* label, 
@@ -609,7 +648,7 @@ Center for the Simulation of Accidental Fires and Explosions (C-SAFE)
     typedef std::map<std::pair<int, const Patch*>, ParticleLabelVariableMap* > psetAddDBType;
     typedef std::map<std::pair<int, const Patch*>, int> particleQuantityType;
    
-    ParticleSubset* queryPSetDB(psetDBType &db, 
+    ParticleSubset* queryPSetDB(ShardedDatabase<psetDBType> &db, 
                                 const Patch* patch, 
                                 int matlIndex, 
                                 IntVector low, 
@@ -617,7 +656,7 @@ Center for the Simulation of Accidental Fires and Explosions (C-SAFE)
                                 const VarLabel* pos_var, 
                                 bool exact=false);
 
-    void insertPSetRecord(psetDBType &subsetDB,
+    void insertPSetRecord(ShardedDatabase<psetDBType> &subsetDB,
                           const Patch* patch, 
                           IntVector low, 
                           IntVector high, 
@@ -626,12 +665,22 @@ Center for the Simulation of Accidental Fires and Explosions (C-SAFE)
 
     DWDatabase<Patch>  d_varDB;
     DWDatabase<Level>  d_levelDB;
+
+    // Grid variables with filled ghost cells, by (label, matl, patch)
+    typedef std::map<VarLabelMatl<Patch>, GridVariableBase*> haloDBType;
+    ShardedDatabase<haloDBType> d_haloDB;
+
+    // Bytes copied into ghost cell windows by getGridVar, and the number of
+    // requests served from d_haloDB
+    std::atomic<unsigned long long> d_ghostBytesCopied;
+    std::atomic<unsigned long long> d_ghostViews;
     KeyDatabase<Patch> d_varkeyDB;
     KeyDatabase<Level> d_levelkeyDB;
 
-    psetDBType                        d_psetDB;
-    psetDBType                        d_delsetDB;
-    psetAddDBType d_addsetDB;
+    // Particle subsets, delete sets and added particles, by patch
+    ShardedDatabase<psetDBType>       d_psetDB;
+    ShardedDatabase<psetDBType>       d_delsetDB;
+    ShardedDatabase<psetAddDBType>    d_addsetDB;
     particleQuantityType d_foreignParticleQuantities;
 
     // Keep track of when this DW sent some (and which) particle information to another processor
@@ -650,10 +699,7 @@ Center for the Simulation of Accidental Fires and Explosions (C-SAFE)
 
     //////////
     // Insert Documentation Here:
-    mutable CrowdMonitor    d_lock;
-    mutable CrowdMonitor    d_lvlock;
-    mutable CrowdMonitor    d_plock;
-    mutable CrowdMonitor    d_pslock;
+    mutable DWLock          d_lock;
     bool                    d_finalized;
     GridP                   d_grid;
 
@@ -54,6 +54,8 @@ Relocate::Relocate()
 {
   reloc_old_posLabel = reloc_new_posLabel = 0;
   reloc_matls = 0;
+  d_sortInterval = 0;
+  d_sortOrder = RowMajorCellOrder;
 }
 
 Relocate::~Relocate()
@@ -788,6 +790,110 @@ void Relocate::finalizeCommunication()
   recvbuffers.clear();
   sendbuffers.clear();
 }
+//______________________________________________________________________
+//
+void
+Relocate::setParticleSortOrder(int sortInterval, ParticleSortOrder order)
+{
+  d_sortInterval = sortInterval;
+  d_sortOrder = order;
+}
+
+//______________________________________________________________________
+//
+bool
+Relocate::sortThisRelocation(const DataWarehouse* new_dw) const
+{
+  return d_sortInterval > 0 && new_dw->getID() % d_sortInterval == 0;
+}
+
+//______________________________________________________________________
+// Interleave the bits of the cell index (21 bits per direction)
+static long64 mortonCode(const IntVector& c)
+{
+  long64 code = 0;
+  for (int b = 0; b < 21; b++) {
+    for (int d = 0; d < 3; d++) {
+      code |= (long64)((c[d] >> b) & 1) << (3*b + d);
+    }
+  }
+  return code;
+}
+
+//______________________________________________________________________
+//
+ParticleSubset*
+Relocate::sortedParticleOrder(ParticleVariableBase* pos,
+                              const Patch* patch,
+                              int matl) const
+{
+  ParticleVariable<Point>* px = dynamic_cast<ParticleVariable<Point>*>(pos);
+  ASSERT(px != 0);
+
+  ParticleSubset* pset = pos->getParticleSubset();
+  const Level* level = patch->getLevel();
+  IntVector low  = patch->getExtraCellLowIndex();
+  IntVector size = patch->getExtraCellHighIndex() - low;
+
+  // (cell key, particle) pairs, in the current order
+  vector<pair<long64, particleIndex> > keys;
+  keys.reserve(pset->numParticles());
+  bool inOrder = true;
+  for (ParticleSubset::iterator iter = pset->begin(); iter != pset->end(); iter++) {
+    IntVector c = level->getCellIndex((*px)[*iter]) - low;
+    c = Max(IntVector(0,0,0), Min(size - IntVector(1,1,1), c));
+
+    long64 key;
+    if (d_sortOrder == MortonCellOrder) {
+      key = mortonCode(c);
+    } else {
+      key = ((long64)c.z()*size.y() + c.y())*size.x() + c.x();
+    }
+    if (!keys.empty() && key < keys.back().first) {
+      inOrder = false;
+    }
+    keys.push_back(make_pair(key, *iter));
+  }
+
+  if (inOrder) {
+    return 0;
+  }
+
+  // particles of the same cell keep their order
+  sort(keys.begin(), keys.end());
+
+  ParticleSubset* order = scinew ParticleSubset(0, matl, patch);
+  order->resize(keys.size());
+  for (int p = 0; p < (int)keys.size(); p++) {
+    order->set(p, keys[p].second);
+  }
+  return order;
+}
+
+//______________________________________________________________________
+//
+void
+Relocate::putSortedParticleVariable(DataWarehouse* new_dw,
+                                    ParticleVariableBase* var,
+                                    const VarLabel* label,
+                                    ParticleSubset* order,
+                                    const Patch* patch) const
+{
+  if (order == 0) {
+    new_dw->put(*var, label);
+    return;
+  }
+
+  vector<ParticleSubset*> subsets(1, order);
+  vector<ParticleVariableBase*> srcs(1, var);
+  vector<const Patch*> srcPatches(1, patch);
+
+  ParticleVariableBase* sorted = var->clone();
+  sorted->gather(var->getParticleSubset(), subsets, srcs, srcPatches);
+  new_dw->put(*sorted, label);
+  delete sorted;
+}
+
 //______________________________________________________________________
 //
 const Patch* findFinePatch(const Point& pos, const Patch* guess, Level* fineLevel)
@@ -917,6 +1023,7 @@ Relocate::relocateParticlesModifies(const ProcessorGroup* pg,
                                     const Level* coarsestLevelwithParticles)
 {
   int total_reloc[3] = {0,0,0};
+  bool sortParticles = sortThisRelocation(new_dw);
   if (patches->size() != 0)
   {
     printTask(patches, patches->get(0),coutdbg,"Relocate::relocateParticles");
@@ -1143,13 +1250,15 @@ Relocate::relocateParticlesModifies(const ProcessorGroup* pg,
           
           // particle position
           ParticleVariableBase* posvar = new_dw->getParticleVariable(reloc_old_posLabel, orig_pset);
-          new_dw->put(*posvar, reloc_new_posLabel);
+          ParticleSubset* order = sortParticles ? sortedParticleOrder(posvar, toPatch, matl) : 0;
+          putSortedParticleVariable(new_dw, posvar, reloc_new_posLabel, order, toPatch);
           
           // all other variables
           for(int v=0;v<numVars;v++){
             ParticleVariableBase* var = new_dw->getParticleVariable(reloc_old_labels[m][v], orig_pset);
-            new_dw->put(*var, reloc_new_labels[m][v]);
+            putSortedParticleVariable(new_dw, var, reloc_new_labels[m][v], order, toPatch);
           }
+          delete order;
         } else {
         
           //__________________________________
@@ -1279,14 +1388,17 @@ Relocate::relocateParticlesModifies(const ProcessorGroup* pg,
 #endif
           
           // Put the data back in the data warehouse
-          new_dw->put(*newpos, reloc_new_posLabel);
+          // (reordered by cell on sort steps)
+          ParticleSubset* order = sortParticles ? sortedParticleOrder(newpos, toPatch, matl) : 0;
+          putSortedParticleVariable(new_dw, newpos, reloc_new_posLabel, order, toPatch);
           
           delete newpos;
           
           for(int v=0;v<numVars;v++){
-            new_dw->put(*vars[v], reloc_new_labels[m][v]);
+            putSortedParticleVariable(new_dw, vars[v], reloc_new_labels[m][v], order, toPatch);
             delete vars[v];
           }
+          delete order;
         }  // particles have moved
         if(keep_pset->removeReference()){
           delete keep_pset;
@@ -1361,6 +1473,7 @@ Relocate::relocateParticles(const ProcessorGroup* pg,
                             const Level* coarsestLevelwithParticles)
 {
   int total_reloc[3] = {0,0,0};
+  bool sortParticles = sortThisRelocation(new_dw);
   if (patches->size() != 0) {
     printTask(patches, patches->get(0),coutdbg,"Relocate::relocateParticles");
     int me = pg->myrank();
@@ -1600,14 +1713,16 @@ Relocate::relocateParticles(const ProcessorGroup* pg,
           // particle position
           ParticleVariableBase* posvar =
             new_dw->getParticleVariable(reloc_old_posLabel, orig_pset);
-          new_dw->put(*posvar, reloc_new_posLabel);
+          ParticleSubset* order = sortParticles ? sortedParticleOrder(posvar, toPatch, matl) : 0;
+          putSortedParticleVariable(new_dw, posvar, reloc_new_posLabel, order, toPatch);
           
           // all other variables
           for(int v=0;v<numVars;v++){
             ParticleVariableBase* var =
               new_dw->getParticleVariable(reloc_old_labels[m][v], orig_pset);
-            new_dw->put(*var, reloc_new_labels[m][v]);
+            putSortedParticleVariable(new_dw, var, reloc_new_labels[m][v], order, toPatch);
           }
+          delete order;
         } else {
 
           // Particles have moved
@@ -1766,14 +1881,17 @@ Relocate::relocateParticles(const ProcessorGroup* pg,
 #endif
   
           // Put the data back in the data warehouse
-          new_dw->put(*newpos, reloc_new_posLabel);
+          // (reordered by cell on sort steps)
+          ParticleSubset* order = sortParticles ? sortedParticleOrder(newpos, toPatch, matl) : 0;
+          putSortedParticleVariable(new_dw, newpos, reloc_new_posLabel, order, toPatch);
 
           delete newpos;
           
           for(int v=0;v<numVars;v++){
-            new_dw->put(*vars[v], reloc_new_labels[m][v]);
+            putSortedParticleVariable(new_dw, vars[v], reloc_new_labels[m][v], order, toPatch);
             delete vars[v];
           }
+          delete order;
           
         }  // particles have moved 
         if(keep_pset->removeReference()){
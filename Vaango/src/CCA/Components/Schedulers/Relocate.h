@@ -37,6 +37,8 @@
 namespace Uintah {
   class DataWarehouse;
   class LoadBalancer;
+  class ParticleSubset;
+  class ParticleVariableBase;
   class ProcessorGroup;
   class Scheduler;
   class VarLabel;
@@ -101,6 +103,18 @@ WARNING
     
     const MaterialSet* getMaterialSet() const { return reloc_matls;}
 
+    enum ParticleSortOrder {
+      RowMajorCellOrder,    // cell index, x fastest
+      MortonCellOrder       // Morton (Z-order) code of the cell index
+    };
+
+    //////////
+    // Reorder the particles of each patch by cell every sortInterval
+    // timesteps (0 = never), so that the particle loops of the
+    // interpolation tasks walk the grid in order.  All the relocated
+    // variables are permuted the same way.
+    void setParticleSortOrder(int sortInterval, ParticleSortOrder order);
+
   private:
 
     // varlabels created for the modifies version of relocation
@@ -135,6 +149,26 @@ WARNING
                                 Patch::selectType& AllNeighborPatches);
    
     void finalizeCommunication();
+
+    //////////
+    // Returns the particles of pos's subset ordered by cell of the patch,
+    // or 0 if they are already in that order.  The caller deletes it.
+    ParticleSubset* sortedParticleOrder(ParticleVariableBase* pos,
+                                        const Patch* patch,
+                                        int matl) const;
+
+    // Puts var, permuted by order (if not 0), into the new dw
+    void putSortedParticleVariable(DataWarehouse* new_dw,
+                                   ParticleVariableBase* var,
+                                   const VarLabel* label,
+                                   ParticleSubset* order,
+                                   const Patch* patch) const;
+
+    // Is this a relocation where the particles are reordered?  Decided by
+    // the generation of the new DW, so that every relocation task of a
+    // timestep, on every rank and thread, makes the same choice.
+    bool sortThisRelocation(const DataWarehouse* new_dw) const;
+
     const VarLabel* reloc_old_posLabel;
     std::vector<std::vector<const VarLabel*> > reloc_old_labels;
     const VarLabel* reloc_new_posLabel;
@@ -146,6 +180,9 @@ WARNING
     std::vector<char*> sendbuffers;
     std::vector<MPI_Request> sendrequests;
 
+    int d_sortInterval;
+    ParticleSortOrder d_sortOrder;
+
 
   };
 } // End namespace Uintah
@@ -32,8 +32,10 @@
 #include <CCA/Components/Schedulers/OnDemandDataWarehouse.h>
 #include <CCA/Components/Schedulers/OnDemandDataWarehouseP.h>
 #include <CCA/Components/Schedulers/DetailedTasks.h>
+#include <CCA/Components/Schedulers/MemoryLog.h>
 #include <Core/Grid/Task.h>
 #include <Core/Grid/Patch.h>
+#include <Core/Grid/Variables/Array3DataPool.h>
 #include <Core/Grid/Variables/CellIterator.h>
 #include <Core/Grid/Variables/CCVariable.h>
 #include <Core/Grid/Variables/NCVariable.h>
@@ -54,6 +56,7 @@
 #include <Core/Util/FancyAssert.h>
 #include <Core/Thread/Time.h>
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <iomanip>
@@ -76,6 +79,7 @@ extern Uintah::Mutex       cerrLock;
 extern DebugStream mixedDebug;
 
 static DebugStream dbg("SchedulerCommon", false);
+static DebugStream compiletimes("CompileTimes", false);
 
 // for calculating memory usage when sci-malloc is disabled.
 char * SchedulerCommon::d_start_addr = NULL;
@@ -90,6 +94,8 @@ SchedulerCommon::SchedulerCommon(const ProcessorGroup* myworld, const Output* op
 
   d_emit_taskgraph = false;
   d_useSmallMessages = true;
+  d_incrementalRecompile = false;
+  d_checkIncrementalRecompile = false;
   d_memlogfile = 0;
   d_restartable = false;
   for(int i=0;i<Task::TotalDWs;i++)
@@ -286,6 +292,49 @@ SchedulerCommon::problemSetup(const ProblemSpecP& prob_spec,
     params->getWithDefault("small_messages", d_useSmallMessages, true);
     if (d_useSmallMessages)
       proc0cout << "   Using theoretical scheduler\n";
+
+    params->get("incrementalRecompile", d_incrementalRecompile);
+    params->get("checkIncrementalRecompile", d_checkIncrementalRecompile);
+    if (d_incrementalRecompile) {
+      proc0cout << "   Reusing task graph dependencies of unchanged patches when recompiling"
+                << (d_checkIncrementalRecompile ? " (checked against a full compile)\n" : "\n");
+    }
+
+    params->get("persistentGhostCells", OnDemandDataWarehouse::d_persistentGhostCells);
+    if (OnDemandDataWarehouse::d_persistentGhostCells)
+      proc0cout << "   Keeping ghost cell windows of finalized DataWarehouses\n";
+
+    // Recycle grid variable memory between the old and new DataWarehouses
+    bool usePool = false;
+    params->get("gridVariablePool", usePool);
+    if (usePool) {
+      double maxCachedMB = 0.0;
+      params->get("gridVariablePoolMaxMB", maxCachedMB);
+      Array3DataPool::setMaxCachedBytes((size_t)(maxCachedMB*1024*1024));
+      Array3DataPool::setEnabled(true);
+      proc0cout << "   Using grid variable memory pool\n";
+    }
+
+    // Reorder the particles of each patch by cell during relocation
+    int sortInterval = 0;
+    params->get("particleSortInterval", sortInterval);
+    if (sortInterval > 0) {
+      std::string sortOrder = "rowmajor";
+      params->get("particleSortOrder", sortOrder);
+      Relocate::ParticleSortOrder order;
+      if (sortOrder == "rowmajor") {
+        order = Relocate::RowMajorCellOrder;
+      } else if (sortOrder == "morton") {
+        order = Relocate::MortonCellOrder;
+      } else {
+        throw ProblemSetupException("Unknown particleSortOrder " + sortOrder +
+                                    " (rowmajor or morton)", __FILE__, __LINE__);
+      }
+      d_reloc1.setParticleSortOrder(sortInterval, order);
+      d_reloc2.setParticleSortOrder(sortInterval, order);
+      proc0cout << "   Sorting particles by cell (" << sortOrder << ") every "
+                << sortInterval << " timesteps\n";
+    }
     ProblemSpecP track = params->findBlock("VarTracker");
     if (track) {
       track->require("start_time", d_trackingStartTime);
@@ -1012,6 +1061,16 @@ SchedulerCommon::logMemoryUse()
       dts->logMemoryUse(*d_memlogfile, total, "Taskgraph");
     }
   }
+
+  if (Array3DataPool::isEnabled()) {
+    Array3DataPool::Stats pool = Array3DataPool::getStats();
+    ostringstream elems;
+    elems << pool.numCached;
+    logMemory(*d_memlogfile, total, "Array3DataPool", "cached", "Array3Data block", 0, -1, elems.str(),
+              pool.cachedBytes, 0);
+    *d_memlogfile << "Array3DataPool: hits " << pool.hits << ", misses " << pool.misses
+                  << ", footprint " << pool.totalBytes << ", peak footprint " << pool.peakBytes << '\n';
+  }
   *d_memlogfile << "Total: " << total << '\n';
   d_memlogfile->flush();
 }
@@ -1044,9 +1103,20 @@ void SchedulerCommon::compile()
     oldGrid = const_cast<Grid*>(get_dw(0)->getGrid());
   }
 
+  // compile stage times summed over the task graphs
+  const int numStages = 12;
+  double stageTimes[numStages] = { 0 };
+  int numCached = 0;
+  int numRebuilt = 0;
+  double start = Time::currentSeconds();
+
   if(d_numTasks > 0){
 
     dbg << d_myworld->myrank() << " SchedulerCommon starting compile\n";
+
+    if (d_incrementalRecompile && d_dependencyCaches.size() < d_graphs.size()) {
+      d_dependencyCaches.resize(d_graphs.size());
+    }
     
     // pass the first to the rest, so we can share the scrubcountTable
     DetailedTasks* first = 0;
@@ -1057,13 +1127,30 @@ void SchedulerCommon::compile()
       }
 
       DetailedTasks* dts = 
-        d_graphs[i]->createDetailedTasks(useInternalDeps(), first, grid, oldGrid);
+        d_graphs[i]->createDetailedTasks(useInternalDeps(), first, grid, oldGrid,
+                                         d_incrementalRecompile ? &d_dependencyCaches[i] : 0,
+                                         d_checkIncrementalRecompile);
 
       if (!first) {
         first = dts;
       }
+
+      const TaskGraph::CompileTimes& times = d_graphs[i]->getCompileTimes();
+      stageTimes[0] += times.sort;
+      stageTimes[1] += times.neighborhood;
+      stageTimes[2] += times.detailedTasks;
+      stageTimes[3] += times.assignResources;
+      stageTimes[4] += times.gridDiff;
+      stageTimes[5] += times.dependencies;
+      stageTimes[6] += times.messageTags;
+      stageTimes[7] += times.localTasks;
+      stageTimes[8] += times.scrubCounts;
+      numCached += times.cachedTasks;
+      numRebuilt += times.rebuiltTasks;
     }
+    double checksumStart = Time::currentSeconds();
     verifyChecksum();
+    stageTimes[9] = Time::currentSeconds() - checksumStart;
     dbg << d_myworld->myrank() << " SchedulerCommon finished compile\n";
   } else {
     // NOTE: this was added with scheduleRestartInititalize() support (for empty TGs)
@@ -1112,6 +1199,37 @@ void SchedulerCommon::compile()
     }
   }
   m_locallyComputedPatchVarMap->makeGroups();
+
+  if (compiletimes.active()) {
+    stageTimes[11] = Time::currentSeconds() - start;
+    stageTimes[10] = stageTimes[11];
+    for (int s = 0; s < 10; s++) {
+      stageTimes[10] -= stageTimes[s];
+    }
+
+    double maxTimes[numStages];
+    int counts[2] = { numCached, numRebuilt };
+    int totalCounts[2] = { numCached, numRebuilt };
+    if (d_myworld->size() > 1) {
+      MPI_Reduce(stageTimes, maxTimes, numStages, MPI_DOUBLE, MPI_MAX, 0, d_myworld->getComm());
+      MPI_Reduce(counts, totalCounts, 2, MPI_INT, MPI_SUM, 0, d_myworld->getComm());
+    }
+    else {
+      std::copy(stageTimes, stageTimes + numStages, maxTimes);
+    }
+
+    if (d_myworld->myrank() == 0) {
+      const char* stageNames[numStages] = { "sort", "neighborhood", "detailed tasks", "assign resources", "grid diff",
+                                            "dependencies", "message tags", "local tasks/DW keys", "scrub counts",
+                                            "checksum", "other", "total" };
+      compiletimes << "Compile times (max over ranks, " << d_graphs.size() << " task graphs):\n";
+      for (int s = 0; s < numStages; s++) {
+        compiletimes << "  " << std::setw(20) << std::left << stageNames[s] << std::right << " " << maxTimes[s] << " s\n";
+      }
+      compiletimes << "  detailed tasks with cached dependencies: " << totalCounts[0] << ", rebuilt: " << totalCounts[1]
+                   << std::endl;
+    }
+  }
 }
 
 bool SchedulerCommon::isOldDW(int idx) const
@@ -1449,6 +1567,9 @@ SchedulerCommon::scheduleAndDoDataCopy(const GridP& grid, SimulationInterface* s
 
   newDataWarehouse->refinalize();
 
+  // the cached blocks have the extents of the old grid
+  Array3DataPool::trim();
+
   d_sharedState->regriddingCopyDataTime += Time::currentSeconds() - start;
   d_sharedState->taskExecTime = executeTime;
   d_sharedState->taskGlobalCommTime = globalCommTime;
@@ -32,6 +32,7 @@
 #include <Core/Grid/Variables/ComputeSet.h>
 #include <CCA/Ports/Scheduler.h>
 #include <CCA/Components/Schedulers/Relocate.h>
+#include <CCA/Components/Schedulers/DependencyCache.h>
 #include <CCA/Components/Schedulers/OnDemandDataWarehouseP.h>
 #include <Core/Grid/SimulationState.h>
 #include <Core/Grid/SimulationStateP.h>
@@ -363,6 +364,13 @@ WARNING
     // or a larger one (more communication time)
     bool d_useSmallMessages;
 
+    // reuse the detailed dependencies of the last compile where the grid
+    // has not changed (one cache per task graph), and optionally check them
+    // against the ones of a full compile
+    bool d_incrementalRecompile;
+    bool d_checkIncrementalRecompile;
+    std::vector<DependencyCache> d_dependencyCaches;
+
     //! These are to store which vars we have to copy to the new grid
     //! in a copy data task.  Set in scheduleDataCopy and used in
     //! copyDataToNewGrid.
@@ -0,0 +1,136 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2015-     Parresia Research Limited, New Zealand
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef VAANGO_CCA_COMPONENTS_SCHEDULERS_SHARDEDDATABASE_H
+#define VAANGO_CCA_COMPONENTS_SCHEDULERS_SHARDEDDATABASE_H
+
+#include <Core/Grid/Patch.h>
+#include <Core/Thread/CrowdMonitor.h>
+#include <Core/Thread/Time.h>
+
+#include <atomic>
+
+namespace Uintah {
+
+  /**
+   *  @class  DWLock
+   *  @brief  CrowdMonitor that counts the acquisitions that had to wait
+   *
+   *  Uncontended acquisitions only cost a trylock.  The number of waits and
+   *  the time spent waiting are summed over all the DWLocks of a process and
+   *  reported with the scheduler timing output (MPIScheduler::outputTimingStats).
+   */
+  class DWLock {
+
+  public:
+
+    DWLock(const char* name) : d_lock(name) {}
+
+    void readLock()
+    {
+      if (!d_lock.readTrylock()) {
+        double start = Time::currentSeconds();
+        d_lock.readLock();
+        countWait(start);
+      }
+    }
+
+    void readUnlock() { d_lock.readUnlock(); }
+
+    void writeLock()
+    {
+      if (!d_lock.writeTrylock()) {
+        double start = Time::currentSeconds();
+        d_lock.writeLock();
+        countWait(start);
+      }
+    }
+
+    void writeUnlock() { d_lock.writeUnlock(); }
+
+    // Number of waits and seconds waited since the last call
+    static void getContention(unsigned long long& waits, double& waitTime)
+    {
+      waits = s_waits.exchange(0);
+      waitTime = s_waitNanoseconds.exchange(0)*1.0e-9;
+    }
+
+  private:
+
+    static void countWait(double start)
+    {
+      s_waits++;
+      s_waitNanoseconds += (unsigned long long) ((Time::currentSeconds() - start)*1.0e9);
+    }
+
+    CrowdMonitor d_lock;
+
+    static std::atomic<unsigned long long> s_waits;
+    static std::atomic<unsigned long long> s_waitNanoseconds;
+
+    DWLock(const DWLock&);
+    DWLock& operator=(const DWLock&);
+  };
+
+  /**
+   *  @class  ShardedDatabase
+   *  @brief  A map keyed by patch, split into shards with their own locks
+   *
+   *  All the entries of a (real) patch are in the same shard, so threads
+   *  working on different patches rarely share a lock.  The caller locks
+   *  the shard of a patch around its accesses to the shard's map.
+   */
+  template<class MapType>
+  class ShardedDatabase {
+
+  public:
+
+    enum { NUM_SHARDS = 64 };
+
+    struct Shard {
+      Shard() : lock("DataWarehouse shard lock") {}
+
+      MapType map;
+      DWLock  lock;
+    };
+
+    Shard& shard(const Patch* patch)
+    {
+      if (patch == 0) {
+        return d_shards[0];
+      }
+      return d_shards[((unsigned int) patch->getRealPatch()->getID()) % NUM_SHARDS];
+    }
+
+    Shard& shard(int i) { return d_shards[i]; }
+    const Shard& shard(int i) const { return d_shards[i]; }
+
+  private:
+
+    Shard d_shards[NUM_SHARDS];
+  };
+
+} // End namespace Uintah
+
+#endif // VAANGO_CCA_COMPONENTS_SCHEDULERS_SHARDEDDATABASE_H
@@ -39,6 +39,7 @@
 #include <Core/Malloc/Allocator.h>
 #include <Core/Parallel/ProcessorGroup.h>
 #include <Core/Parallel/Parallel.h>
+#include <Core/Thread/Time.h>
 #include <Core/Util/DebugStream.h>
 #include <Core/Util/FancyAssert.h>
 #include <Core/Util/ProgressiveWarning.h>
@@ -68,7 +69,9 @@ static DebugStream compdbg(     "FindComp",          false);
 //______________________________________________________________________
 //
 TaskGraph::TaskGraph( SchedulerCommon*  sc, const ProcessorGroup*   pg, Scheduler::tgType type )
-    : sc(sc), d_myworld(pg), type_(type), dts_(0), currentIteration(0), d_numtaskphases(0)
+    : sc(sc), d_myworld(pg), type_(type), dts_(0), currentIteration(0), d_numtaskphases(0),
+      d_cache(0), d_reuseDependencies(false), d_record(0), d_recordIsValid(false),
+      d_checkCache(false), d_dryRun(false)
 {
   lb = dynamic_cast<LoadBalancer*>(sc->getPort("load balancer"));
 }
@@ -677,14 +680,49 @@ TaskGraph::addTask(       Task*        task,
 
 //______________________________________________________________________
 //
+namespace {
+
+  // Seconds since stageStart, which is moved to now
+  double stageTime( double& stageStart )
+  {
+    double now = Time::currentSeconds();
+    double time = now - stageStart;
+    stageStart = now;
+    return time;
+  }
+
+  // Key of a detailed task of the sorted task with the given index
+  DependencyCache::TaskKey taskKey( int task, const PatchSubset* patches, int matls )
+  {
+    if (!patches || patches->empty()) {
+      return DependencyCache::TaskKey(task, -1, -1, matls);
+    }
+    const Patch* patch = patches->get(0);
+    return DependencyCache::TaskKey(task, patch->getLevel()->getIndex(), patch->getID(), matls);
+  }
+
+}
 
 void
-TaskGraph::createDetailedTask(       Task*           task,
-                               const PatchSubset*    patches,
-                               const MaterialSubset* matls )
+TaskGraph::createDetailedTask(       Task*                     task,
+                               const PatchSubset*              patches,
+                               const MaterialSubset*           matls,
+                               const DependencyCache::TaskKey& key )
 {
   DetailedTask* dt = scinew DetailedTask(task, patches, matls, dts_);
 
+  if (d_cache) {
+    // a key shared by two detailed tasks (patch subsets with the same first
+    // patch) can't be cached
+    d_taskKeys[dt] = key;
+    if (d_tasksByKey.count(key) > 0) {
+      d_tasksByKey[key] = 0;
+    }
+    else {
+      d_tasksByKey[key] = dt;
+    }
+  }
+
   if (task->getType() == Task::Reduction) {
     Task::Dependency* req = task->getModifies();
     // reduction tasks should have exactly 1 require, and it should be a modify
@@ -699,11 +737,16 @@ TaskGraph::createDetailedTask(       Task*           task,
 //
 
 DetailedTasks*
-TaskGraph::createDetailedTasks(       bool           useInternalDeps,
-                                      DetailedTasks* first,
-                                const GridP&         grid,
-                                const GridP&         oldGrid )
+TaskGraph::createDetailedTasks(       bool             useInternalDeps,
+                                      DetailedTasks*   first,
+                                const GridP&           grid,
+                                const GridP&           oldGrid,
+                                      DependencyCache* cache /* = 0 */,
+                                      bool             checkCache /* = false */ )
 {
+  d_compileTimes = CompileTimes();
+  double stageStart = Time::currentSeconds();
+
   vector<Task*> sorted_tasks;
 
   // TODO plz leave this commented line alone, APH 01/07/15
@@ -711,12 +754,31 @@ TaskGraph::createDetailedTasks(       bool           useInternalDeps,
   nullSort(sorted_tasks);
 
   d_reductionTasks.clear();
+  d_compileTimes.sort = stageTime(stageStart);
 
   ASSERT(grid != 0);
   lb->createNeighborhood(grid, oldGrid);
+  d_compileTimes.neighborhood = stageTime(stageStart);
+
+  // the cache is refilled by this compile
+  d_cache = cache;
+  d_checkCache = checkCache;
+  if (d_cache) {
+    d_lastCompile.clear();
+    std::swap(d_lastCompile, *d_cache);
+  }
 
   const set<int> neighborhood_procs=lb->getNeighborhoodProcessors();
   dts_ = scinew DetailedTasks(sc, d_myworld, first, this, neighborhood_procs, useInternalDeps );
+
+  if (d_cache) {
+    for (set<int>::const_iterator p = neighborhood_procs.begin(); p != neighborhood_procs.end(); p++) {
+      DependencyCache::TaskKey key(-1, -1, *p, -1);
+      DetailedTask* sendOld = dts_->getOldDWSendTask(*p);
+      d_taskKeys[sendOld] = key;
+      d_tasksByKey[key] = sendOld;
+    }
+  }
   
   for (int i = 0; i < (int)sorted_tasks.size(); i++) {
 
@@ -731,7 +793,7 @@ TaskGraph::createDetailedTasks(       bool           useInternalDeps,
           const PatchSubset* pss = ps->getSubset(*p);
           for (int m = 0; m < ms->size(); m++) {
             const MaterialSubset* mss = ms->getSubset(m);
-            createDetailedTask(task, pss, mss);
+            createDetailedTask(task, pss, mss, taskKey(i, pss, m));
           }
         }
       }
@@ -746,7 +808,7 @@ TaskGraph::createDetailedTasks(       bool           useInternalDeps,
         if (pss->size() > 0) {
           for (int m = 0; m < ms->size(); m++) {
             const MaterialSubset* mss = ms->getSubset(m);
-            createDetailedTask(task, pss, mss);
+            createDetailedTask(task, pss, mss, taskKey(i, pss, m));
           }
         }
 
@@ -758,14 +820,14 @@ TaskGraph::createDetailedTasks(       bool           useInternalDeps,
           if (lb->inNeighborhood(pss) && pss->size() > 0) {
             for (int m = 0; m < ms->size(); m++) {
               const MaterialSubset* mss = ms->getSubset(m);
-              createDetailedTask(task, pss, mss);
+              createDetailedTask(task, pss, mss, taskKey(i, pss, m));
             }
           }
         }
       }
     }
     else if (!ps && !ms) {
-      createDetailedTask(task, 0, 0);
+      createDetailedTask(task, 0, 0, taskKey(i, 0, -1));
     }
     else if (!ps) {
       SCI_THROW(InternalError("Task has MaterialSet, but no PatchSet", __FILE__, __LINE__));
@@ -779,11 +841,19 @@ TaskGraph::createDetailedTasks(       bool           useInternalDeps,
 // this can happen if a processor has no patches (which may happen at the beginning of some AMR runs)
 //  if(dts_->numTasks() == 0)
 //    cerr << "WARNING: Compiling scheduler with no tasks\n";
+  d_compileTimes.detailedTasks = stageTime(stageStart);
 
   lb->assignResources(*dts_);
+  d_compileTimes.assignResources = stageTime(stageStart);
 
   // use this, even on a single processor, if for nothing else than to get scrub counts
   bool doDetailed = Parallel::usingMPI() || useInternalDeps || grid->numLevels() > 1;
+
+  if (d_cache) {
+    d_reuseDependencies = diffGrid(grid, sorted_tasks, doDetailed);
+    d_compileTimes.gridDiff = stageTime(stageStart);
+  }
+
   if (doDetailed) {
     createDetailedDependencies();
     if (dts_->getExtraCommunication() > 0 && d_myworld->myrank() == 0) {
@@ -791,18 +861,34 @@ TaskGraph::createDetailedTasks(       bool           useInternalDeps,
            << dts_->getExtraCommunication() << " cells\n";
     }
   }
+  d_compileTimes.dependencies = stageTime(stageStart);
+
+  if (d_cache) {
+    d_cache->valid = doDetailed;
+    d_lastCompile.clear();
+    d_changedPatches.clear();
+    d_changedKeys.clear();
+    d_patchesByKey.clear();
+    d_taskKeys.clear();
+    d_tasksByKey.clear();
+    d_reuseDependencies = false;
+    d_cache = 0;
+  }
 
   if (d_myworld->size() > 1) {
     dts_->assignMessageTags(d_myworld->myrank());
   }
+  d_compileTimes.messageTags = stageTime(stageStart);
 
   dts_->computeLocalTasks(d_myworld->myrank());
   dts_->makeDWKeyDatabase();
+  d_compileTimes.localTasks = stageTime(stageStart);
 
   if (!doDetailed) {
     // the createDetailedDependencies will take care of scrub counts, otherwise do it here.
     dts_->createScrubCounts();
   }
+  d_compileTimes.scrubCounts = stageTime(stageStart);
 
   return dts_;
 } // end TaskGraph::createDetailedTasks
@@ -1093,17 +1179,45 @@ TaskGraph::createDetailedDependencies()
   for (int i = 0; i < dts_->numTasks(); i++) {
     DetailedTask* task = dts_->getTask(i);
 
-    if (detaileddbg.active() && (task->task->getRequires() != 0)) {
-      detaileddbg << d_myworld->myrank() << " Looking at requires of detailed task: " << *task << "\n";
+    // Open a record of the dependencies of the task for the next compile
+    DependencyCache::TaskRecord* record = 0;
+    if (d_cache && dependenciesCanBeCached(task) && d_tasksByKey[d_taskKeys[task]] == task) {
+      record = &d_cache->tasks[d_taskKeys[task]];
+      for (int p = 0; p < task->patches->size(); p++) {
+        const Patch* patch = task->patches->get(p);
+        record->patches.push_back(DependencyCache::PatchKey(patch->getLevel()->getIndex(), patch->getExtraCellLowIndex(),
+                                                            patch->getExtraCellHighIndex()));
+      }
+      d_record = &record->deps;
+      d_recordIsValid = true;
     }
 
-    createDetailedDependencies(task, task->task->getRequires(), ct, false);
+    if (record && d_reuseDependencies && replayDependencies(task)) {
+      d_compileTimes.cachedTasks++;
+      if (d_checkCache) {
+        checkReplayedDependencies(task, ct, record->deps);
+      }
+    }
+    else {
+      d_compileTimes.rebuiltTasks++;
+
+      if (detaileddbg.active() && (task->task->getRequires() != 0)) {
+        detaileddbg << d_myworld->myrank() << " Looking at requires of detailed task: " << *task << "\n";
+      }
+
+      createDetailedDependencies(task, task->task->getRequires(), ct, false);
 
-    if (detaileddbg.active() && (task->task->getModifies() != 0)) {
-      detaileddbg << d_myworld->myrank() << " Looking at modifies of detailed task: " << *task << "\n";
+      if (detaileddbg.active() && (task->task->getModifies() != 0)) {
+        detaileddbg << d_myworld->myrank() << " Looking at modifies of detailed task: " << *task << "\n";
+      }
+
+      createDetailedDependencies(task, task->task->getModifies(), ct, true);
     }
 
-    createDetailedDependencies(task, task->task->getModifies(), ct, true);
+    if (record && !d_recordIsValid) {
+      d_cache->tasks.erase(d_taskKeys[task]);
+    }
+    d_record = 0;
   }
 
   if (detaileddbg.active()) {
@@ -1518,7 +1632,7 @@ TaskGraph::createDetailedDependencies( DetailedTask*     task,
                         }
                       }
                     }
-                    dts_->possiblyCreateDependency(prevReqTask, 0, 0, task, req, 0, matl, from_l, from_h, DetailedDep::Always);
+                    createDependency(prevReqTask, 0, 0, task, req, 0, matl, from_l, from_h, DetailedDep::Always);
                   }
                 }
               }
@@ -1530,13 +1644,13 @@ TaskGraph::createDetailedDependencies( DetailedTask*     task,
                 if (subsequentProc != proc) {
                   cond = DetailedDep::FirstIteration;  // change outer cond from always to first-only
                   DetailedTask* subsequentCreator = dts_->getOldDWSendTask(subsequentProc);
-                  dts_->possiblyCreateDependency(subsequentCreator, comp, fromNeighbor, task, req, fromNeighbor, matl, from_l,
-                                                 from_h, DetailedDep::SubsequentIterations);
+                  createDependency(subsequentCreator, comp, fromNeighbor, task, req, fromNeighbor, matl, from_l,
+                                   from_h, DetailedDep::SubsequentIterations);
                   detaileddbg << d_myworld->myrank() << "   Adding condition reqs for " << *req->var << " task : " << *creator
                               << "  to " << *task << "\n";
                 }
               }
-              dts_->possiblyCreateDependency(creator, comp, fromNeighbor, task, req, fromNeighbor, matl, from_l, from_h, cond);
+              createDependency(creator, comp, fromNeighbor, task, req, fromNeighbor, matl, from_l, from_h, cond);
             }
           }
         }
@@ -1615,6 +1729,368 @@ TaskGraph::createDetailedDependencies( DetailedTask*     task,
   }
 }
 
+//______________________________________________________________________
+//
+namespace {
+
+  DependencyCache::PatchKey patchKey( const Patch* patch )
+  {
+    if (!patch) {
+      return DependencyCache::PatchKey();
+    }
+    return DependencyCache::PatchKey(patch->getLevel()->getIndex(), patch->getExtraCellLowIndex(),
+                                     patch->getExtraCellHighIndex());
+  }
+
+  // Index of dep in the computes and modifies (or the requires) of its task
+  int dependencyIndex( const Task::Dependency* dep )
+  {
+    if (!dep) {
+      return -1;
+    }
+    int index = 0;
+    if (dep->deptype == Task::Requires) {
+      for (const Task::Dependency* d = dep->task->getRequires(); d != 0; d = d->next, index++) {
+        if (d == dep) {
+          return index;
+        }
+      }
+      return -1;
+    }
+    for (const Task::Dependency* d = dep->task->getComputes(); d != 0; d = d->next, index++) {
+      if (d == dep) {
+        return index;
+      }
+    }
+    for (const Task::Dependency* d = dep->task->getModifies(); d != 0; d = d->next, index++) {
+      if (d == dep) {
+        return index;
+      }
+    }
+    return -1;
+  }
+
+  Task::Dependency* dependencyAt( Task::Dependency* head, int& index )
+  {
+    for (; head != 0 && index > 0; head = head->next, index--) {
+    }
+    return index == 0 ? head : 0;
+  }
+
+  // Everything the dependencies of a task depend on besides the grid
+  std::string taskSignature( SchedulerCommon* sc, Task* task )
+  {
+    ostringstream sig;
+    sig << task->getName() << ' ' << task->getType();
+    if (task->getMaterialSet()) {
+      sig << " matls " << *task->getMaterialSet();
+    }
+    const Task::Dependency* deps[3] = { task->getComputes(), task->getModifies(), task->getRequires() };
+    for (int d = 0; d < 3; d++) {
+      for (const Task::Dependency* dep = deps[d]; dep != 0; dep = dep->next) {
+        int dw = dep->mapDataWarehouse();
+        sig << " | " << dep->deptype << ' ' << dep->var->getName() << ' ' << dw << ' ' << dep->gtype << ' '
+            << dep->numGhostCells << ' ' << dep->patches_dom << ' ' << dep->matls_dom << ' ' << dep->lookInOldTG;
+        if (dw >= 0) {
+          sig << ' ' << sc->isOldDW(dw) << sc->isNewDW(dw);
+        }
+        if (dep->matls) {
+          sig << ' ' << *dep->matls;
+        }
+      }
+    }
+    return sig.str();
+  }
+
+}
+
+void
+TaskGraph::createDependency(       DetailedTask*              from,
+                                   Task::Dependency*          comp,
+                             const Patch*                     fromPatch,
+                                   DetailedTask*              to,
+                                   Task::Dependency*          req,
+                             const Patch*                     toPatch,
+                                   int                        matl,
+                             const IntVector&                 low,
+                             const IntVector&                 high,
+                                   DetailedDep::CommCondition cond )
+{
+  if (d_record && d_recordIsValid) {
+    std::map<const DetailedTask*, DependencyCache::TaskKey>::const_iterator iter = d_taskKeys.find(from);
+    if (iter == d_taskKeys.end() || d_tasksByKey[iter->second] != from) {
+      d_recordIsValid = false;
+    }
+    else {
+      DependencyCache::Dependency dep;
+      dep.from = iter->second;
+      dep.comp = dependencyIndex(comp);
+      dep.fromPatch = patchKey(fromPatch);
+      dep.req = dependencyIndex(req);
+      dep.toPatch = patchKey(toPatch);
+      dep.matl = matl;
+      dep.low = low;
+      dep.high = high;
+      dep.cond = cond;
+      d_record->push_back(dep);
+    }
+  }
+
+  if (!d_dryRun) {
+    dts_->possiblyCreateDependency(from, comp, fromPatch, to, req, toPatch, matl, low, high, cond);
+  }
+}
+
+//______________________________________________________________________
+//
+bool
+TaskGraph::dependenciesCanBeCached( const DetailedTask* task ) const
+{
+  const Task* t = task->task;
+  if (t->getType() != Task::Normal || t->getModifies() != 0 || !task->patches || !task->matls) {
+    return false;
+  }
+  for (const Task::Dependency* req = t->getRequires(); req != 0; req = req->next) {
+    if (req->patches_dom != Task::ThisLevel || req->patches != 0 || req->lookInOldTG) {
+      return false;
+    }
+    switch (req->var->typeDescription()->getType()) {
+      case TypeDescription::CCVariable :
+      case TypeDescription::NCVariable :
+      case TypeDescription::SFCXVariable :
+      case TypeDescription::SFCYVariable :
+      case TypeDescription::SFCZVariable :
+      case TypeDescription::ParticleVariable :
+      case TypeDescription::PerPatch :
+        break;
+      default :
+        return false;
+    }
+  }
+  return true;
+}
+
+//______________________________________________________________________
+//
+bool
+TaskGraph::diffGrid( const GridP&              grid,
+                     const vector<Task*>&      sortedTasks,
+                           bool                doDetailed )
+{
+  // The ghost cell reach of the cacheable requires
+  int reach = 0;
+  for (unsigned t = 0; t < sortedTasks.size(); t++) {
+    d_cache->taskSignatures.push_back(taskSignature(sc, sortedTasks[t]));
+    for (const Task::Dependency* req = sortedTasks[t]->getRequires(); req != 0; req = req->next) {
+      IntVector bl = req->var->getBoundaryLayer();
+      reach = Max(reach, req->numGhostCells + Max(Max(bl.x(), bl.y()), bl.z()));
+    }
+  }
+
+  for (int l = 0; l < grid->numLevels(); l++) {
+    const LevelP& level = grid->getLevel(l);
+    for (Level::const_patchIterator iter = level->patchesBegin(); iter != level->patchesEnd(); iter++) {
+      const Patch* patch = *iter;
+      DependencyCache::PatchKey key = patchKey(patch);
+      DependencyCache::PatchState& state = d_cache->patchStates[key];
+      state.owner = lb->getPatchwiseProcessorAssignment(patch);
+      state.oldOwner = lb->getOldProcessorAssignment(patch);
+      state.inNeighborhood = lb->inNeighborhood(patch);
+      d_patchesByKey[key] = patch;
+    }
+  }
+
+  if (!d_lastCompile.valid || !doDetailed || d_lastCompile.taskSignatures != d_cache->taskSignatures) {
+    return false;
+  }
+
+  // Patches that are new, gone or changed, walking both (sorted) maps together
+  vector<DependencyCache::PatchKey> changed;
+  std::map<DependencyCache::PatchKey, DependencyCache::PatchState>::const_iterator newIter = d_cache->patchStates.begin();
+  std::map<DependencyCache::PatchKey, DependencyCache::PatchState>::const_iterator oldIter = d_lastCompile.patchStates.begin();
+  while (newIter != d_cache->patchStates.end() || oldIter != d_lastCompile.patchStates.end()) {
+    if (oldIter == d_lastCompile.patchStates.end() ||
+        (newIter != d_cache->patchStates.end() && newIter->first < oldIter->first)) {
+      changed.push_back(newIter->first);
+      newIter++;
+    }
+    else if (newIter == d_cache->patchStates.end() || oldIter->first < newIter->first) {
+      changed.push_back(oldIter->first);
+      oldIter++;
+    }
+    else {
+      if (!(newIter->second == oldIter->second)) {
+        changed.push_back(newIter->first);
+      }
+      newIter++;
+      oldIter++;
+    }
+  }
+
+  // The dependencies of a task can only change if a changed patch is within
+  // the reach of its patches (the periodic copies are selected as virtual patches)
+  for (unsigned c = 0; c < changed.size(); c++) {
+    d_changedKeys.insert(changed[c]);
+    if (changed[c].level >= grid->numLevels()) {
+      continue;
+    }
+    const LevelP& level = grid->getLevel(changed[c].level);
+    IntVector extra = level->getExtraCells();
+    IntVector range(reach + 1, reach + 1, reach + 1);
+    range += extra;
+    Patch::selectType neighbors;
+    level->selectPatches(changed[c].low - range, changed[c].high + range, neighbors, true, false);
+    for (int n = 0; n < neighbors.size(); n++) {
+      d_changedPatches.insert(neighbors[n]->getRealPatch());
+    }
+  }
+
+  if (detaileddbg.active()) {
+    detaileddbg << d_myworld->myrank() << " Incremental compile: " << changed.size() << " changed patches, "
+                << d_changedPatches.size() << " patches within reach\n";
+  }
+  return true;
+}
+
+//______________________________________________________________________
+//
+bool
+TaskGraph::replayDependencies( DetailedTask* task )
+{
+  std::map<DependencyCache::TaskKey, DependencyCache::TaskRecord>::const_iterator iter =
+      d_lastCompile.tasks.find(d_taskKeys[task]);
+  if (iter == d_lastCompile.tasks.end()) {
+    return false;
+  }
+  const DependencyCache::TaskRecord& last = iter->second;
+
+  // same patches, none of them near a change
+  if (last.patches.size() != (unsigned)task->patches->size()) {
+    return false;
+  }
+  for (int p = 0; p < task->patches->size(); p++) {
+    const Patch* patch = task->patches->get(p);
+    if (!(last.patches[p] == patchKey(patch)) || d_changedPatches.count(patch) > 0) {
+      return false;
+    }
+  }
+
+  // Map everything to this compile before creating anything
+  struct Replay {
+    DetailedTask*     from;
+    Task::Dependency* comp;
+    const Patch*      fromPatch;
+    Task::Dependency* req;
+    const Patch*      toPatch;
+  };
+  vector<Replay> replays(last.deps.size());
+  for (unsigned d = 0; d < last.deps.size(); d++) {
+    const DependencyCache::Dependency& dep = last.deps[d];
+    Replay& replay = replays[d];
+
+    std::map<DependencyCache::TaskKey, DetailedTask*>::const_iterator from = d_tasksByKey.find(dep.from);
+    if (from == d_tasksByKey.end() || !from->second) {
+      return false;
+    }
+    replay.from = from->second;
+
+    replay.comp = 0;
+    if (dep.comp >= 0) {
+      int index = dep.comp;
+      replay.comp = dependencyAt(replay.from->task->getComputes(), index);
+      if (!replay.comp) {
+        replay.comp = dependencyAt(replay.from->task->getModifies(), index);
+      }
+      if (!replay.comp) {
+        return false;
+      }
+    }
+
+    int index = dep.req;
+    replay.req = dependencyAt(task->task->getRequires(), index);
+    if (!replay.req) {
+      return false;
+    }
+
+    replay.fromPatch = 0;
+    replay.toPatch = 0;
+    std::map<DependencyCache::PatchKey, const Patch*>::const_iterator patch;
+    if (dep.fromPatch.level >= 0) {
+      if (d_changedKeys.count(dep.fromPatch) > 0 || (patch = d_patchesByKey.find(dep.fromPatch)) == d_patchesByKey.end()) {
+        return false;
+      }
+      replay.fromPatch = patch->second;
+    }
+    if (dep.toPatch.level >= 0) {
+      if (d_changedKeys.count(dep.toPatch) > 0 || (patch = d_patchesByKey.find(dep.toPatch)) == d_patchesByKey.end()) {
+        return false;
+      }
+      replay.toPatch = patch->second;
+    }
+
+    // Check the edge against this compile: the creator must still compute
+    // the patch and material on the owner of the patch, and the region must
+    // still lie in the patch
+    if (replay.fromPatch) {
+      if (replay.from->patches) {
+        if (!replay.from->patches->contains(replay.fromPatch) ||
+            replay.from->getAssignedResourceIndex() != lb->getPatchwiseProcessorAssignment(replay.fromPatch)) {
+          return false;
+        }
+      }
+      TypeDescription::Type type = replay.req->var->typeDescription()->getType();
+      Patch::VariableBasis basis = Patch::translateTypeToBasis(type, false);
+      IntVector boundaryLayer = replay.req->var->getBoundaryLayer();
+      if (type != TypeDescription::PerPatch &&
+          (dep.low != Max(dep.low, replay.fromPatch->getExtraLowIndex(basis, boundaryLayer)) ||
+           dep.high != Min(dep.high, replay.fromPatch->getExtraHighIndex(basis, boundaryLayer)))) {
+        return false;
+      }
+    }
+    if (replay.comp && replay.from->matls && !replay.from->matls->contains(dep.matl)) {
+      return false;
+    }
+  }
+
+  for (unsigned d = 0; d < last.deps.size(); d++) {
+    const DependencyCache::Dependency& dep = last.deps[d];
+    const Replay& replay = replays[d];
+    createDependency(replay.from, replay.comp, replay.fromPatch, task, replay.req, replay.toPatch, dep.matl, dep.low,
+                     dep.high, (DetailedDep::CommCondition)dep.cond);
+  }
+  return true;
+}
+
+//______________________________________________________________________
+//
+void
+TaskGraph::checkReplayedDependencies(       DetailedTask*                             task,
+                                            CompTable&                                ct,
+                                      const vector<DependencyCache::Dependency>&      replayed )
+{
+  // Create the dependencies again, only recording them
+  vector<DependencyCache::Dependency> created;
+  vector<DependencyCache::Dependency>* record = d_record;
+  bool recordIsValid = d_recordIsValid;
+  d_record = &created;
+  d_recordIsValid = true;
+  d_dryRun = true;
+  createDetailedDependencies(task, task->task->getRequires(), ct, false);
+  bool createdIsValid = d_recordIsValid;
+  d_dryRun = false;
+  d_record = record;
+  d_recordIsValid = recordIsValid;
+
+  // the search can visit the neighbors in another order
+  if (!createdIsValid || created.size() != replayed.size() ||
+      !std::is_permutation(created.begin(), created.end(), replayed.begin())) {
+    ostringstream msg;
+    msg << "Incremental recompile: the " << replayed.size() << " replayed dependencies of " << *task
+        << " differ from the " << created.size() << " created by a full compile";
+    SCI_THROW(InternalError(msg.str(), __FILE__, __LINE__));
+  }
+}
+
 //______________________________________________________________________
 //
 int
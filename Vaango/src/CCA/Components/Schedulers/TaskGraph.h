@@ -28,11 +28,14 @@
  
 #include <Core/Grid/Task.h>
 #include <CCA/Ports/Scheduler.h>
+#include <CCA/Components/Schedulers/DependencyCache.h>
+#include <CCA/Components/Schedulers/DetailedTasks.h>
 #include <Core/Grid/Grid.h>
 
 #include <vector>
 #include <list>
 #include <map>
+#include <set>
 
 namespace Uintah {
 
@@ -74,6 +77,11 @@ CLASS
    Then at the and:
      DetailedTasks::computeLocalTasks
 
+   With a DependencyCache, createDetailedDependencies replays the dependencies
+   of the detailed tasks whose neighborhood has not changed since the last
+   compile (see DependencyCache.h) instead of creating them again.  The other
+   stages are not incremental.
+
 GENERAL INFORMATION
 
    TaskGraph.h
@@ -117,6 +125,26 @@ class TaskGraph {
 
   public:
 
+    /// Time spent in the stages of createDetailedTasks (seconds)
+    struct CompileTimes {
+      CompileTimes()
+        : sort(0), neighborhood(0), detailedTasks(0), assignResources(0), gridDiff(0),
+          dependencies(0), messageTags(0), localTasks(0), scrubCounts(0),
+          cachedTasks(0), rebuiltTasks(0) {}
+
+      double sort;
+      double neighborhood;
+      double detailedTasks;
+      double assignResources;
+      double gridDiff;          // comparing the grid with the one of the last compile
+      double dependencies;
+      double messageTags;
+      double localTasks;        // local tasks and DW key database
+      double scrubCounts;
+      int    cachedTasks;       // detailed tasks whose dependencies were replayed
+      int    rebuiltTasks;      // detailed tasks whose dependencies were created
+    };
+
     TaskGraph(       SchedulerCommon*  sc,
                const ProcessorGroup*   pg,
                      Scheduler::tgType type );
@@ -144,10 +172,21 @@ class TaskGraph {
     /// DetailedTask for each PatchSubset and MaterialSubset in a Task,
     /// where a Task may have many PatchSubsets and MaterialSubsets.).
     /// Sorts using topologicalSort.
-    DetailedTasks* createDetailedTasks(       bool           useInternalDeps,
-                                              DetailedTasks* first,
-                                        const GridP&         grid,
-                                        const GridP&         oldGrid ) ;
+    /// If cache is given, the dependencies stored in it by the last compile
+    /// are reused where the grid has not changed, and it is then filled with
+    /// the dependencies of this compile.  With checkCache, the reused
+    /// dependencies are compared with the ones created from scratch.
+    DetailedTasks* createDetailedTasks(       bool             useInternalDeps,
+                                              DetailedTasks*   first,
+                                        const GridP&           grid,
+                                        const GridP&           oldGrid,
+                                              DependencyCache* cache = 0,
+                                              bool             checkCache = false );
+
+    const CompileTimes& getCompileTimes() const
+    {
+      return d_compileTimes;
+    }
 
     inline DetailedTasks* getDetailedTasks()
     {
@@ -257,10 +296,46 @@ class TaskGraph {
                                      bool              modifies );
 
     /// Makes a DetailedTask from task with given PatchSubset and
-    /// MaterialSubset.
-    void createDetailedTask(       Task*           task,
-                             const PatchSubset*    patches,
-                             const MaterialSubset* matls );
+    /// MaterialSubset.  key identifies it in the DependencyCache.
+    void createDetailedTask(       Task*                           task,
+                             const PatchSubset*                    patches,
+                             const MaterialSubset*                 matls,
+                             const DependencyCache::TaskKey&       key );
+
+    /// Calls DetailedTasks::possiblyCreateDependency (unless d_dryRun is set)
+    /// and records the dependency for the DependencyCache if a record is open.
+    void createDependency(       DetailedTask*              from,
+                                 Task::Dependency*          comp,
+                           const Patch*                     fromPatch,
+                                 DetailedTask*              to,
+                                 Task::Dependency*          req,
+                           const Patch*                     toPatch,
+                                 int                        matl,
+                           const IntVector&                 low,
+                           const IntVector&                 high,
+                                 DetailedDep::CommCondition cond );
+
+    /// Incremental recompile: compares the patches of the grid with the ones
+    /// of the last compile and collects the patches within reach of a change.
+    /// Returns false if the dependencies of the last compile can't be used.
+    bool diffGrid( const GridP&               grid,
+                   const std::vector<Task*>&  sortedTasks,
+                         bool                 doDetailed );
+
+    /// Whether the dependencies of the task can be stored in the cache: only
+    /// the dependencies of normal tasks that just require patch variables of
+    /// their own level are local enough.
+    bool dependenciesCanBeCached( const DetailedTask* task ) const;
+
+    /// Creates the dependencies of the task stored by the last compile.
+    /// Returns false (and creates nothing) if they can't be used.
+    bool replayDependencies( DetailedTask* task );
+
+    /// Throws if the dependencies replayed for the task differ from the
+    /// ones a full compile creates (checkCache).
+    void checkReplayedDependencies(       DetailedTask*                                task,
+                                          CompTable&                                   ct,
+                                    const std::vector<DependencyCache::Dependency>&    replayed );
 
     /// find the processor that a variable (req) is on given patch and
     /// material.
@@ -307,6 +382,22 @@ class TaskGraph {
     typedef std::map<const VarLabel*, DetailedTask*, VarLabel::Compare> DetailedReductionTasksMap;
 
     DetailedReductionTasksMap d_reductionTasks;
+
+    CompileTimes d_compileTimes;
+
+    // Incremental recompile (only used during createDetailedTasks)
+    DependencyCache*                                         d_cache;        // filled by this compile
+    DependencyCache                                          d_lastCompile;  // stored by the last compile
+    bool                                                     d_reuseDependencies;
+    std::set<const Patch*>                                   d_changedPatches;  // within reach of a change
+    std::set<DependencyCache::PatchKey>                      d_changedKeys;     // added, removed or changed
+    std::map<DependencyCache::PatchKey, const Patch*>        d_patchesByKey;
+    std::map<const DetailedTask*, DependencyCache::TaskKey>  d_taskKeys;
+    std::map<DependencyCache::TaskKey, DetailedTask*>        d_tasksByKey;   // 0 if the key is not unique
+    std::vector<DependencyCache::Dependency>*                d_record;
+    bool                                                     d_recordIsValid;
+    bool                                                     d_checkCache;
+    bool                                                     d_dryRun;
 };
 
 }  // End namespace Uintah
@@ -57,7 +57,8 @@ ThreadedMPIScheduler::ThreadedMPIScheduler( const ProcessorGroup*       myworld,
                                                   ThreadedMPIScheduler* parentScheduler)
   : MPIScheduler(myworld, oport, parentScheduler),
     d_nextsignal("next condition"),
-    d_nextmutex("next mutex")
+    d_nextmutex("next mutex"),
+    useShardedReadyQueues_(false)
 {
   if (threadedmpi_timeout.active()) {
     char filename[64];
@@ -148,9 +149,18 @@ ThreadedMPIScheduler::problemSetup( const ProblemSpecP&     prob_spec,
     else if (taskQueueAlg == "PatchOrderRandom") {
       taskQueueAlg_ = PatchOrderRandom;
     }
+
+    std::string taskQueueMode = "Shared";
+    params->get("taskReadyQueueMode", taskQueueMode);
+    // Only the main thread runs tasks here, so "WorkStealing" just shards the
+    // ready queues between the threads that push to them.
+    useShardedReadyQueues_ = (taskQueueMode == "WorkStealing");
   }
 
   proc0cout << "   Using \"" << taskQueueAlg << "\" task queue priority algorithm" << std::endl;
+  if (useShardedReadyQueues_) {
+    proc0cout << "   Using per-thread (sharded) task ready queues, dispatched by the main thread" << std::endl;
+  }
 
   numThreads_ = Uintah::Parallel::getNumThreads() - 1;
   if ((numThreads_ < 1) && Uintah::Parallel::usingMPI()) {
@@ -204,6 +214,7 @@ ThreadedMPIScheduler::createSubScheduler()
   UintahParallelPort* lbp = getPort("load balancer");
   subsched->attachPort("load balancer", lbp);
   subsched->d_sharedState = d_sharedState;
+  subsched->useShardedReadyQueues_ = useShardedReadyQueues_;
   subsched->numThreads_ = Uintah::Parallel::getNumThreads() - 1;
 
   if (subsched->numThreads_ > 0) {
@@ -274,6 +285,10 @@ ThreadedMPIScheduler::execute( int tgnum     /* = 0 */,
 
   int ntasks = dts->numLocalTasks();
   dts->initializeScrubs(d_dws, d_dwmap);
+  // Tasks made ready by a TaskWorker go to the queue of its thread id, so the
+  // workers don't contend on one lock.  Only this thread pops them, starting
+  // with the queue of its own thread id.
+  dts->setNumReadyQueues(useShardedReadyQueues_ ? numThreads_ + 1 : 0);
   dts->initTimestep();
 
   for (int i = 0; i < ntasks; i++) {
@@ -369,6 +384,9 @@ ThreadedMPIScheduler::execute( int tgnum     /* = 0 */,
     // if we have an internally-ready task, initiate its recvs
     else if (dts->numInternalReadyTasks() > 0) {
       DetailedTask* task = dts->getNextInternalReadyTask();
+      if (task == NULL) {  // taken by another thread after the count
+        continue;
+      }
       // save the reduction task and once per proc task for later execution
       if ((task->getTask()->getType() == Task::Reduction) || (task->getTask()->usesMPI())) {
         phaseSyncTask[task->getTask()->d_phase] = task;
@@ -456,6 +474,9 @@ ThreadedMPIScheduler::execute( int tgnum     /* = 0 */,
       }
 
       DetailedTask* task = dts->getNextExternalReadyTask();
+      if (task == NULL) {
+        continue;
+      }
       if (taskdbg.active()) {
         cerrLock.lock();
         taskdbg << "Rank-" << me << " Task external ready: " << *task << "  (" << dts->numExternalReadyTasks() << "/"
@@ -582,9 +603,18 @@ void ThreadedMPIScheduler::assignTask( DetailedTask* task,
   if (getAvailableThreadNum() == 0) {
     d_nextsignal.wait(d_nextmutex);
   }
-  // find an idle thread and assign task
+  // prefer the thread the load balancer keeps this patch on (so its data
+  // stays in that thread's cache), otherwise find an idle thread
   int targetThread = -1;
-  for (int i = 0; i < numThreads_; i++) {
+  const PatchSubset* patches = task->getPatches();
+  if (patches != 0 && patches->size() > 0) {
+    int group = getLoadBalancer()->getPatchThreadGroup(patches->get(0));
+    if (group >= 0 && group < numThreads_ && t_worker[group]->d_task == NULL) {
+      targetThread = group;
+      t_worker[group]->d_numtasks++;
+    }
+  }
+  for (int i = 0; i < numThreads_ && targetThread < 0; i++) {
     if (t_worker[i]->d_task == NULL) {
       targetThread = i;
       t_worker[i]->d_numtasks++;
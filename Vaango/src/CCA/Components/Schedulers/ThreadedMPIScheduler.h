@@ -104,6 +104,7 @@ class ThreadedMPIScheduler : public MPIScheduler {
     TaskWorker*       t_worker[MAX_THREADS];   // workers
     Thread*           t_thread[MAX_THREADS];   // actual threads
     QueueAlg          taskQueueAlg_;
+    bool              useShardedReadyQueues_;  // per-thread ready queues (taskReadyQueueMode)
     int               numThreads_;
 };
 
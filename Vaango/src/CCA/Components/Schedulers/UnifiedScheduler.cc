@@ -73,6 +73,7 @@ static DebugStream unified_timeout(         "Unified_TimingsOut",      false);
 static DebugStream unified_queuelength(     "Unified_QueueLength",     false);
 static DebugStream unified_threaddbg(       "Unified_ThreadDBG",       false);
 static DebugStream unified_compactaffinity( "Unified_CompactAffinity", true);
+static DebugStream unified_workstealing(    "Unified_WorkStealing",    false);
 
 #ifdef HAVE_CUDA
   static DebugStream gpu_stats(        "GPUStats",     false);
@@ -88,7 +89,8 @@ UnifiedScheduler::UnifiedScheduler( const ProcessorGroup*   myworld,
   : MPIScheduler(myworld, oport, parentScheduler),
     d_nextsignal("next condition"),
     d_nextmutex("next mutex"),
-    schedulerLock("scheduler lock")
+    schedulerLock("scheduler lock"),
+    useWorkStealing_(false)
 #ifdef HAVE_CUDA
   ,
   idleStreamsLock_("CUDA streams lock"),
@@ -206,9 +208,16 @@ UnifiedScheduler::problemSetup( const ProblemSpecP&     prob_spec,
     else if (taskQueueAlg == "PatchOrderRandom") {
       taskQueueAlg_ = PatchOrderRandom;
     }
+
+    std::string taskQueueMode = "Shared";
+    params->get("taskReadyQueueMode", taskQueueMode);
+    useWorkStealing_ = (taskQueueMode == "WorkStealing");
   }
 
   proc0cout << "   Using \"" << taskQueueAlg << "\" task queue priority algorithm" << std::endl;
+  if (useWorkStealing_) {
+    proc0cout << "   Using per-thread task ready queues with work stealing" << std::endl;
+  }
 
   numThreads_ = Uintah::Parallel::getNumThreads() - 1;
   if (numThreads_ < 1 && (Uintah::Parallel::usingMPI() || Uintah::Parallel::usingDevice())) {
@@ -281,6 +290,7 @@ UnifiedScheduler::createSubScheduler()
   subsched->attachPort("load balancer", lbp);
   subsched->d_sharedState = d_sharedState;
   subsched->numThreads_ = Uintah::Parallel::getNumThreads() - 1;
+  subsched->useWorkStealing_ = useWorkStealing_;
 
   if (subsched->numThreads_ > 0) {
 
@@ -366,6 +376,7 @@ UnifiedScheduler::runTask( DetailedTask*         task,
       if (!d_sharedState->isCopyDataTimestep() && task->getTask()->getType() != Task::Output) {
         // add contribution of task execution time to load balancer
         getLoadBalancer()->addContribution(task, total_task_time);
+        getLoadBalancer()->addThreadContribution(thread_id, total_task_time);
       }
     }
   }
@@ -444,6 +455,8 @@ UnifiedScheduler::execute( int tgnum     /* = 0 */,
   }
 
   dts->initializeScrubs(d_dws, d_dwmap);
+  // one ready queue per task execution thread (workers and main thread)
+  dts->setNumReadyQueues(useWorkStealing_ ? numThreads_ + 1 : 0);
   dts->initTimestep();
 
   ntasks = dts->numLocalTasks();
@@ -521,6 +534,8 @@ UnifiedScheduler::execute( int tgnum     /* = 0 */,
     coutLock.unlock();
   }
 
+  threadIdleTime_.assign(numThreads_ + 1, 0.0);
+
   // signal worker threads to begin executing tasks
   for (int i = 0; i < numThreads_; i++) {
     t_worker[i]->resetWaittime(Time::currentSeconds());  // reset wait time counter
@@ -531,8 +546,8 @@ UnifiedScheduler::execute( int tgnum     /* = 0 */,
     t_worker[i]->d_runmutex.unlock();
   }
 
-  // main thread also executes tasks
-  runTasks(Thread::self()->myid());
+  // main thread also executes tasks, the workers are threads 1..numThreads_
+  runTasks(0);
 
   // wait for all tasks to finish
   d_nextmutex.lock();
@@ -585,6 +600,20 @@ UnifiedScheduler::execute( int tgnum     /* = 0 */,
     }
   }
 
+  // The ready queues are indexed by Uintah thread id, like the workers
+  // (1..numThreads_) and the main thread of the top-level scheduler (0).
+  // The main thread of a subscheduler is a worker of its parent, so its
+  // stolen tasks are counted on the queue of that worker.
+  if (unified_workstealing.active() && useWorkStealing_) {
+    coutLock.lock();
+    for (int i = 0; i <= numThreads_; i++) {
+      unified_workstealing << "Rank-" << d_myworld->myrank() << " thread " << i
+                           << ": stolen tasks " << dts->numStolenTasks(i)
+                           << ", idle time " << threadIdleTime_[i] << " s\n";
+    }
+    coutLock.unlock();
+  }
+
   if (d_restartable && tgnum == (int)d_graphs.size() - 1) {
     // Copy the restart flag to all processors
     int myrestart = d_dws[d_dws.size() - 1]->timestepRestarted();
@@ -639,7 +668,51 @@ UnifiedScheduler::runTasks( int thread_id )
     //    Check if anything this thread can do concurrently.
     //    If so, then update the various scheduler counters.
     // ----------------------------------------------------------------------------------
+
+    // With per-thread ready queues, first take a task whose MPI receives are done
+    // from this thread's queue (or steal one) without holding the scheduler lock.
+    // The lock is then only held to update the counters below.
+    if (useWorkStealing_) {
+      readyTask = dts->getNextExternalReadyTask();
+      havework = (readyTask != NULL);
+    }
+    bool   searching = !havework;
+    double idleStart = searching ? Time::currentSeconds() : 0.0;
+
     schedulerLock.lock();
+    if (havework) {
+#ifdef HAVE_CUDA
+      if (readyTask->getTask()->usesDevice()) {
+        readyTask->assignDevice(currentDevice_);
+        currentDevice_++;
+        currentDevice_ %= numDevices_;
+        gpuInitReady = true;
+      }
+      else {
+#endif
+      numTasksDone++;
+      if (taskorder.active()) {
+        if (d_myworld->myrank() == d_myworld->size() / 2) {
+          coutLock.lock();
+          taskorder << myRankThread() << " Running task static order: " << readyTask->getStaticOrder()
+                    << ", scheduled order: " << numTasksDone << std::endl;
+          coutLock.unlock();
+        }
+      }
+      phaseTasksDone[readyTask->getTask()->d_phase]++;
+      while (phaseTasks[currphase] == phaseTasksDone[currphase] && currphase + 1 < numPhases) {
+        currphase++;
+        if (taskdbg.active()) {
+          coutLock.lock();
+          taskdbg << myRankThread() << " switched to task phase " << currphase << ", total phase " << currphase << " tasks = "
+                  << phaseTasks[currphase] << std::endl;
+          coutLock.unlock();
+        }
+      }
+#ifdef HAVE_CUDA
+      }
+#endif
+    }
     while (!havework) {
       /*
        * (1.1)
@@ -841,6 +914,11 @@ UnifiedScheduler::runTasks( int thread_id )
 
     schedulerLock.unlock();
 
+    // time spent waiting for the scheduler lock and searching for work
+    if (searching && thread_id < (int)threadIdleTime_.size()) {
+      threadIdleTime_[thread_id] += Time::currentSeconds() - idleStart;
+    }
+
     // ----------------------------------------------------------------------------------
     // Part 2
     //    Concurrent Part:
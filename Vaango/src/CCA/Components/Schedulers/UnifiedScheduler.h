@@ -122,6 +122,8 @@ class UnifiedScheduler : public MPIScheduler  {
     DetailedTasks*             dts;
 
     QueueAlg taskQueueAlg_;
+    bool     useWorkStealing_;                // per-thread ready queues (taskReadyQueueMode)
+    std::vector<double> threadIdleTime_;      // per thread, written only by that thread
     int      currentIteration;
     int      numTasksDone;
     int      ntasks;
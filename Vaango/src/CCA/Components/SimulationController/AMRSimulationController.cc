@@ -478,6 +478,11 @@ AMRSimulationController::run()
 
   } // end while ( time )
 
+  // wait for the output files that are still being written
+  if (d_output) {
+    d_output->flushOutput();
+  }
+
   // If VisIt has been included into the build, stop here so the
   // user can have once last chance see their data via VisIt.
 #ifdef HAVE_VISIT
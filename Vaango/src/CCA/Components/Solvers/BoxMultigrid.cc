@@ -0,0 +1,272 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2015-     Parresia Research Limited, New Zealand
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <CCA/Components/Solvers/BoxMultigrid.h>
+
+#include <algorithm>
+
+using namespace Uintah;
+
+namespace {
+
+  // The hierarchy stops at a grid of at most this many cells, which is
+  // solved with COARSE_SWEEPS red-black sweeps
+  const int MIN_COARSE_CELLS = 64;
+  const int COARSE_SWEEPS = 8;
+
+  // Flops and bytes of one cell of a smoothing sweep or residual
+  const long64 CELL_FLOPS = 14;
+
+}
+
+BoxMultigrid::BoxMultigrid(int maxLevels, int numSmooth)
+  : d_maxLevels(std::max(maxLevels, 1)),
+    d_numSmooth(std::max(numSmooth, 1)),
+    d_flops(0)
+{
+}
+
+void
+BoxMultigrid::setup(const std::vector<Stencil7>& A, const IntVector& size)
+{
+  d_grids.resize(1);
+
+  // The finest grid: A without the couplings that leave the box
+  Grid& fine = d_grids[0];
+  fine.size = size;
+  int nx = size.x(), ny = size.y(), nz = size.z();
+  fine.A = A;
+  for (int k = 0; k < nz; k++) {
+    for (int j = 0; j < ny; j++) {
+      for (int i = 0; i < nx; i++) {
+        Stencil7& a = fine.A[(k*ny + j)*nx + i];
+        if (i == 0)    a.w = 0;
+        if (i == nx-1) a.e = 0;
+        if (j == 0)    a.s = 0;
+        if (j == ny-1) a.n = 0;
+        if (k == 0)    a.b = 0;
+        if (k == nz-1) a.t = 0;
+      }
+    }
+  }
+  fine.x.resize(fine.numCells());
+  fine.b.resize(fine.numCells());
+  fine.r.resize(fine.numCells());
+  d_sum.resize(fine.numCells());
+
+  while ((int) d_grids.size() < d_maxLevels) {
+    const Grid& last = d_grids.back();
+    if (last.numCells() <= MIN_COARSE_CELLS || last.size == IntVector(1,1,1)) {
+      break;
+    }
+    Grid coarse;
+    coarsen(last, coarse);
+    d_grids.push_back(coarse);
+  }
+}
+
+void
+BoxMultigrid::coarsen(const Grid& fine, Grid& coarse) const
+{
+  int f[3], nf[3], nc[3];
+  for (int d = 0; d < 3; d++) {
+    nf[d] = fine.size[d];
+    f[d] = nf[d] > 1 ? 2 : 1;
+    nc[d] = (nf[d] + f[d] - 1)/f[d];
+  }
+  coarse.size = IntVector(nc[0], nc[1], nc[2]);
+
+  Stencil7 zero;
+  zero.initialize(0);
+  coarse.A.assign(coarse.numCells(), zero);
+  coarse.x.resize(coarse.numCells());
+  coarse.b.resize(coarse.numCells());
+  coarse.r.resize(coarse.numCells());
+
+  // Galerkin product with piecewise constant interpolation: the couplings
+  // inside a coarse cell add to its diagonal, the others to the coupling
+  // with the neighboring coarse cell
+  int c[3];
+  for (c[2] = 0; c[2] < nf[2]; c[2]++) {
+    for (c[1] = 0; c[1] < nf[1]; c[1]++) {
+      for (c[0] = 0; c[0] < nf[0]; c[0]++) {
+        const Stencil7& a = fine.A[(c[2]*nf[1] + c[1])*nf[0] + c[0]];
+        Stencil7& ac = coarse.A[((c[2]/f[2])*nc[1] + c[1]/f[1])*nc[0] + c[0]/f[0]];
+        ac.p += a.p;
+        for (int d = 0; d < 3; d++) {
+          for (int side = 0; side < 2; side++) {
+            int neighbor = c[d] + (side ? 1 : -1);
+            if (neighbor < 0 || neighbor >= nf[d]) {
+              continue;
+            }
+            if (neighbor/f[d] == c[d]/f[d]) {
+              ac.p += a[2*d + side];
+            } else {
+              ac[2*d + side] += a[2*d + side];
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+void
+BoxMultigrid::smooth(Grid& grid, int color)
+{
+  int nx = grid.size.x(), ny = grid.size.y(), nz = grid.size.z();
+  int sy = nx, sz = nx*ny;
+  const Stencil7* A = &grid.A[0];
+  double* x = &grid.x[0];
+  const double* b = &grid.b[0];
+  for (int k = 0; k < nz; k++) {
+    for (int j = 0; j < ny; j++) {
+      for (int i = (color + j + k) & 1; i < nx; i += 2) {
+        int c = k*sz + j*sy + i;
+        const Stencil7& a = A[c];
+        if (a.p == 0) {
+          continue;
+        }
+        double sum = b[c];
+        if (i > 0)    sum -= a.w*x[c-1];
+        if (i < nx-1) sum -= a.e*x[c+1];
+        if (j > 0)    sum -= a.s*x[c-sy];
+        if (j < ny-1) sum -= a.n*x[c+sy];
+        if (k > 0)    sum -= a.b*x[c-sz];
+        if (k < nz-1) sum -= a.t*x[c+sz];
+        x[c] = sum/a.p;
+      }
+    }
+  }
+  d_flops += CELL_FLOPS*grid.numCells()/2;
+}
+
+void
+BoxMultigrid::residual(Grid& grid)
+{
+  int nx = grid.size.x(), ny = grid.size.y(), nz = grid.size.z();
+  int sy = nx, sz = nx*ny;
+  const Stencil7* A = &grid.A[0];
+  const double* x = &grid.x[0];
+  const double* b = &grid.b[0];
+  double* r = &grid.r[0];
+  for (int k = 0; k < nz; k++) {
+    for (int j = 0; j < ny; j++) {
+      for (int i = 0; i < nx; i++) {
+        int c = k*sz + j*sy + i;
+        const Stencil7& a = A[c];
+        double sum = b[c] - a.p*x[c];
+        if (i > 0)    sum -= a.w*x[c-1];
+        if (i < nx-1) sum -= a.e*x[c+1];
+        if (j > 0)    sum -= a.s*x[c-sy];
+        if (j < ny-1) sum -= a.n*x[c+sy];
+        if (k > 0)    sum -= a.b*x[c-sz];
+        if (k < nz-1) sum -= a.t*x[c+sz];
+        r[c] = sum;
+      }
+    }
+  }
+  d_flops += CELL_FLOPS*grid.numCells();
+}
+
+void
+BoxMultigrid::vcycle(int level)
+{
+  Grid& grid = d_grids[level];
+  std::fill(grid.x.begin(), grid.x.end(), 0.0);
+
+  // Coarsest grid: symmetric sequence of sweeps
+  if (level == (int) d_grids.size() - 1) {
+    for (int s = 0; s < COARSE_SWEEPS; s++) {
+      smooth(grid, 0);
+      smooth(grid, 1);
+    }
+    smooth(grid, 0);
+    return;
+  }
+
+  for (int s = 0; s < d_numSmooth; s++) {
+    smooth(grid, 0);
+    smooth(grid, 1);
+  }
+
+  // Restriction (sum over the fine cells of a coarse cell)
+  residual(grid);
+  Grid& coarse = d_grids[level+1];
+  int nx = grid.size.x(), ny = grid.size.y(), nz = grid.size.z();
+  int fx = nx > 1 ? 2 : 1, fy = ny > 1 ? 2 : 1, fz = nz > 1 ? 2 : 1;
+  int cx = coarse.size.x(), cy = coarse.size.y();
+  std::fill(coarse.b.begin(), coarse.b.end(), 0.0);
+  for (int k = 0; k < nz; k++) {
+    for (int j = 0; j < ny; j++) {
+      for (int i = 0; i < nx; i++) {
+        coarse.b[((k/fz)*cy + j/fy)*cx + i/fx] += grid.r[(k*ny + j)*nx + i];
+      }
+    }
+  }
+
+  vcycle(level+1);
+
+  // Prolongation (piecewise constant)
+  for (int k = 0; k < nz; k++) {
+    for (int j = 0; j < ny; j++) {
+      for (int i = 0; i < nx; i++) {
+        grid.x[(k*ny + j)*nx + i] += coarse.x[((k/fz)*cy + j/fy)*cx + i/fx];
+      }
+    }
+  }
+  d_flops += 2*grid.numCells();
+
+  for (int s = 0; s < d_numSmooth; s++) {
+    smooth(grid, 1);
+    smooth(grid, 0);
+  }
+}
+
+void
+BoxMultigrid::apply(const double* b, double* x, int numCycles, long64& flops)
+{
+  Grid& fine = d_grids[0];
+  int n = fine.numCells();
+  d_flops = 0;
+
+  std::copy(b, b + n, fine.b.begin());
+  vcycle(0);
+  for (int cycle = 1; cycle < numCycles; cycle++) {
+
+    // Correct the residual of the previous cycles
+    residual(fine);
+    d_sum = fine.x;
+    fine.b = fine.r;
+    vcycle(0);
+    for (int c = 0; c < n; c++) {
+      fine.x[c] += d_sum[c];
+    }
+    std::copy(b, b + n, fine.b.begin());
+    d_flops += n;
+  }
+  std::copy(fine.x.begin(), fine.x.end(), x);
+
+  flops += d_flops;
+}
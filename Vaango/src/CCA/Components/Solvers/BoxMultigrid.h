@@ -0,0 +1,94 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2015-     Parresia Research Limited, New Zealand
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef VAANGO_CCA_COMPONENTS_SOLVERS_BOXMULTIGRID_H
+#define VAANGO_CCA_COMPONENTS_SOLVERS_BOXMULTIGRID_H
+
+#include <Core/Disclosure/TypeUtils.h>
+#include <Core/Geometry/IntVector.h>
+#include <Core/Grid/Variables/Stencil7.h>
+
+#include <vector>
+
+namespace Uintah {
+
+  /**
+   *  @class  BoxMultigrid
+   *  @brief  Geometric multigrid V-cycle for a 7-point stencil on one box
+   *
+   *  The operator of a box of cells (stored x fastest, couplings that
+   *  leave the box are ignored) is coarsened by merging 2x2x2 cells
+   *  (directions with one cell are not coarsened).  The coarse operators
+   *  are the Galerkin products P^T A P with piecewise constant P, which
+   *  are again 7-point stencils.  Cells with a zero diagonal are not part
+   *  of the problem.
+   *
+   *  A V-cycle starts from a zero initial guess and uses red-black
+   *  Gauss-Seidel smoothing (red then black before the coarse grid
+   *  correction, black then red after it), so it is a symmetric linear
+   *  operator.  LevelMultigrid uses it for the coarse grids, which every
+   *  rank gathers and solves on its own.
+   */
+  class BoxMultigrid {
+
+  public:
+
+    BoxMultigrid(int maxLevels, int numSmooth);
+
+    // Builds the grid hierarchy from the operator A of a box of size cells
+    void setup(const std::vector<Stencil7>& A, const IntVector& size);
+
+    // x = M b, where M is numCycles V-cycles (each one corrects the
+    // residual of the previous ones)
+    void apply(const double* b, double* x, int numCycles, long64& flops);
+
+    int numLevels() const { return (int) d_grids.size(); }
+
+  private:
+
+    struct Grid {
+      IntVector size;
+      std::vector<Stencil7> A;
+      std::vector<double> x;
+      std::vector<double> b;
+      std::vector<double> r;
+
+      int numCells() const { return size.x()*size.y()*size.z(); }
+    };
+
+    void coarsen(const Grid& fine, Grid& coarse) const;
+    void smooth(Grid& grid, int color);
+    void residual(Grid& grid);
+    void vcycle(int level);
+
+    int d_maxLevels;
+    int d_numSmooth;
+    std::vector<Grid> d_grids;
+    std::vector<double> d_sum;
+    long64 d_flops;
+  };
+
+} // End namespace Uintah
+
+#endif // VAANGO_CCA_COMPONENTS_SOLVERS_BOXMULTIGRID_H
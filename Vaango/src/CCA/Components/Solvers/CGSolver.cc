@@ -24,6 +24,7 @@
 
 #include <CCA/Components/Solvers/CGSolver.h>
 #include <CCA/Components/Solvers/MatrixUtil.h>
+#include <CCA/Components/Solvers/LevelMultigrid.h>
 #include <Core/Grid/Variables/CCVariable.h>
 #include <Core/Grid/Grid.h>
 #include <Core/Grid/Level.h>
@@ -47,6 +48,7 @@
 #include <Core/Thread/Time.h>
 #include <Core/Util/DebugStream.h>
 #include <iomanip>
+#include <map>
 
 using namespace std;
 using namespace Uintah;
@@ -217,6 +219,38 @@ void ScMult_Add(Array3<double>& r, double s,
   memrefs += diff.x()*diff.y()*diff.z()*3L*8L;
 }
 
+// X = a*D+X, R = -a*Q+R and Q = R*diagonal in one sweep, returning the
+// partial sums of dot(Q,R), L1(Q) and LInf(Q)
+static void CGUpdate(Array3<double>& Xnew, Array3<double>& Rnew,
+                     Array3<double>& Q, double a,
+                     const Array3<double>& D, const Array3<double>& X,
+                     const Array3<double>& R, const Array3<double>& diagonal,
+                     CellIterator iter, long64& flops, long64& memrefs,
+                     double& dot, double& l1, double& linf)
+{
+  if(cout_doing.active())
+    cout_doing << "CGSolver::CGUpdate" << endl;
+
+  double sum=0, asum=0, amax=0;
+  for(; !iter.done(); ++iter){
+    IntVector idx = *iter;
+    Xnew[idx] = a*D[idx]+X[idx];
+    double r = R[idx]-a*Q[idx];
+    double q = r*diagonal[idx];
+    Rnew[idx] = r;
+    Q[idx] = q;
+    sum += q*r;
+    asum += Abs(q);
+    amax = Max(amax, Abs(q));
+  }
+  dot=sum;
+  l1=asum;
+  linf=amax;
+  IntVector diff = iter.end()-iter.begin();
+  flops += 11*diff.x()*diff.y()*diff.z();
+  memrefs += diff.x()*diff.y()*diff.z()*8L*8L;
+}
+
 namespace Uintah {
 
 CGSolver::CGSolver(const ProcessorGroup* myworld)
@@ -252,8 +286,26 @@ public:
     Absolute, Relative
   };
   Criteria criteria;
+  // Classic: step1, step2 and step3, with two reductions per iteration
+  // Pipelined: Ghysels-Vanroose pipelined CG, with one reduction per
+  //   iteration that does not block the matrix-vector product (L1 and L2
+  //   norms only)
+  enum Variant {
+    Classic, Pipelined
+  };
+  Variant variant;
+  // Jacobi: inverse diagonal
+  // Multigrid: a V-cycle of LevelMultigrid over all the patches of the
+  //   level (classic only)
+  enum Preconditioner {
+    Jacobi, Multigrid
+  };
+  Preconditioner preconditioner;
+  int mg_levels;
+  int mg_smooth;
   CGSolverParams()
-    : tolerance(1.e-8), initial_tolerance(1.e-15), norm(L2), criteria(Relative)
+    : tolerance(1.e-8), initial_tolerance(1.e-15), norm(L2), criteria(Relative),
+      variant(Classic), preconditioner(Jacobi), mg_levels(10), mg_smooth(2)
   {
   }
   ~CGSolverParams() {}
@@ -314,6 +366,20 @@ public:
     diag_label = VarLabel::create(A->getName()+" inverse diagonal", sol_type::getTypeDescription());
     
     tolerance_label = VarLabel::create("tolerance", sum_vartype::getTypeDescription());
+
+    // Pipelined CG: u is stored in D, q in Q, and (r,u), (w,u) and the
+    // error term (the L1 norm of u or (r,r)) are reduced together in dots
+    W_label = Z_label = S_label = P_label = M_label = N_label = dots_label = 0;
+    if(params->variant == CGSolverParams::Pipelined){
+      W_label    = VarLabel::create(A->getName()+" W", sol_type::getTypeDescription());
+      Z_label    = VarLabel::create(A->getName()+" Z", sol_type::getTypeDescription());
+      S_label    = VarLabel::create(A->getName()+" S", sol_type::getTypeDescription());
+      P_label    = VarLabel::create(A->getName()+" P", sol_type::getTypeDescription());
+      M_label    = VarLabel::create(A->getName()+" M", sol_type::getTypeDescription());
+      N_label    = VarLabel::create(A->getName()+" N", sol_type::getTypeDescription());
+      dots_label = VarLabel::create(A->getName()+" dots", sumvec_vartype::getTypeDescription());
+    }
+    alpha = beta = 0;
     
     VarLabel* tmp_flop_label = VarLabel::create(A->getName()+" flops", sumlong_vartype::getTypeDescription());
     tmp_flop_label->allowMultipleComputes();
@@ -349,6 +415,20 @@ public:
     if(err_label != d_label)
       VarLabel::destroy(err_label);
     VarLabel::destroy(aden_label);
+
+    for(std::map<int, LevelMultigrid*>::iterator iter = multigrids.begin(); iter != multigrids.end(); iter++){
+      delete iter->second;
+    }
+
+    if(dots_label){
+      VarLabel::destroy(W_label);
+      VarLabel::destroy(Z_label);
+      VarLabel::destroy(S_label);
+      VarLabel::destroy(P_label);
+      VarLabel::destroy(M_label);
+      VarLabel::destroy(N_label);
+      VarLabel::destroy(dots_label);
+    }
   }
 //______________________________________________________________________
 //
@@ -465,37 +545,36 @@ public:
         long64 memrefs = 0;
         double a=d/aden;
 
-        // X = a*D+X
-        ::ScMult_Add(Xnew, a, D, X, iter, flops, memrefs);
-        // R = -a*Q+R
-        ::ScMult_Add(Rnew, -a, Q, R, iter, flops, memrefs);
+        if(params->preconditioner == CGSolverParams::Multigrid){
+          // X = a*D+X
+          ::ScMult_Add(Xnew, a, D, X, iter, flops, memrefs);
+          // R = -a*Q+R
+          ::ScMult_Add(Rnew, -a, Q, R, iter, flops, memrefs);
 
-        // Simple Preconditioning...
-        ::Mult(Q, Rnew, diagonal, iter, flops, memrefs);
-
-        // Calculate coefficient bk and direction vectors p and pp
-        double dnew = ::Dot(Q, Rnew, iter, flops, memrefs);
+          // Q = M R, d and the error term are computed by
+          // multigridPrecondition on all the patches
+        } else {
+          // X = a*D+X, R = -a*Q+R, Q = R/Ap (simple preconditioning)
+          // and the coefficient and error terms, in one sweep
+          double dnew, l1=0, linf=0;
+          ::CGUpdate(Xnew, Rnew, Q, a, D, X, R, diagonal, iter, flops, memrefs,
+                     dnew, l1, linf);
 
-        // Calculate error term
+          // Calculate error term
         
-        switch(params->norm){
-        case CGSolverParams::L1:
-          {
-            double err = ::L1(Q, iter, flops, memrefs);
-            new_dw->put(sum_vartype(err), err_label);
-          }
-          break;
-        case CGSolverParams::L2:
-          // Nothing...
-          break;
-        case CGSolverParams::LInfinity:
-          {
-            double err = ::LInf(Q, iter, flops, memrefs);
-            new_dw->put(max_vartype(err), err_label);
+          switch(params->norm){
+          case CGSolverParams::L1:
+            new_dw->put(sum_vartype(l1), err_label);
+            break;
+          case CGSolverParams::L2:
+            // Nothing...
+            break;
+          case CGSolverParams::LInfinity:
+            new_dw->put(max_vartype(linf), err_label);
+            break;
           }
-          break;
+          new_dw->put(sum_vartype(dnew), d_label);
         }
-        new_dw->put(sum_vartype(dnew), d_label);
         new_dw->put(sumlong_vartype(flops), flop_label);
         new_dw->put(sumlong_vartype(memrefs), memref_label);
       }
@@ -621,15 +700,16 @@ public:
           Xnew.initialize(0);
         }
 
-        // D = R/Ap
-        typename Types::sol_type D;
-        new_dw->allocateAndPut(D, D_label, matl, patch);
-
+        // D = R/Ap (multigridSetup computes D = M R instead)
         ::InverseDiagonal(diagonal, A, iter, flops, memrefs);
-        ::Mult(D, R, diagonal, iter, flops, memrefs);
+        if(params->preconditioner != CGSolverParams::Multigrid){
+          typename Types::sol_type D;
+          new_dw->allocateAndPut(D, D_label, matl, patch);
+          ::Mult(D, R, diagonal, iter, flops, memrefs);
 
-        double dnew = ::Dot(R, D, iter, flops, memrefs);
-        new_dw->put(sum_vartype(dnew), d_label);
+          double dnew = ::Dot(R, D, iter, flops, memrefs);
+          new_dw->put(sum_vartype(dnew), d_label);
+        }
         new_dw->put( sum_vartype(params->tolerance), tolerance_label );
         
         
@@ -662,6 +742,384 @@ public:
     }
   }
 
+  //______________________________________________________________________
+  //  Pipelined CG (Ghysels and Vanroose, Parallel Computing 40, 2014)
+  //  with the inverse diagonal as preconditioner M:
+  //
+  //    u = M r,  w = A u,  m = M w,  n = A m
+  //    gamma = (r,u),  delta = (w,u)
+  //    z = n + beta z,  q = m + beta q,  s = w + beta s,  p = u + beta p
+  //    x = x + alpha p,  r = r - alpha s,  u = u - alpha q,  w = w - alpha z
+  //
+  //  The only reduction of an iteration (gamma, delta and the error, summed
+  //  as one Vector) is computed by pipelinedUpdate, and the matrix-vector
+  //  product of the next iteration (pipelinedMult) does not depend on it.
+  //  alpha and beta are computed by solve() between iterations.
+
+  void getSolveRange(const Patch* patch, IntVector& l, IntVector& h,
+                     IntVector& ll, IntVector& hh)
+  {
+    typedef typename Types::sol_type sol_type;
+    Patch::VariableBasis basis = Patch::translateTypeToBasis(sol_type::getTypeDescription()->getType(), true);
+
+    if(params->getSolveOnExtraCells())
+    {
+      l = patch->getExtraLowIndex(basis, IntVector(0,0,0));
+      h = patch->getExtraHighIndex(basis, IntVector(0,0,0));
+    }
+    else
+    {
+      l = patch->getLowIndex(basis);
+      h = patch->getHighIndex(basis);
+    }
+
+    // the cells of the stencil that are on this or a neighboring patch
+    ll = l - IntVector(patch->getBCType(Patch::xminus) == Patch::Neighbor?1:0,
+                       patch->getBCType(Patch::yminus) == Patch::Neighbor?1:0,
+                       patch->getBCType(Patch::zminus) == Patch::Neighbor?1:0);
+    hh = h + IntVector(patch->getBCType(Patch::xplus) == Patch::Neighbor?1:0,
+                       patch->getBCType(Patch::yplus) == Patch::Neighbor?1:0,
+                       patch->getBCType(Patch::zplus) == Patch::Neighbor?1:0);
+    hh -= IntVector(1,1,1);
+  }
+
+  //______________________________________________________________________
+  //  w = A u, and z = q = s = p = 0 so that the first update sets them
+  //  requires u (D, new, 1 ghost) and r (R, new)
+  void pipelinedSetup(const ProcessorGroup*, const PatchSubset* patches,
+                      const MaterialSubset* matls,
+                      DataWarehouse*, DataWarehouse* new_dw)
+  {
+    DataWarehouse* A_dw = new_dw->getOtherDataWarehouse(parent_which_A_dw);
+    for(int p=0;p<patches->size();p++){
+      const Patch* patch = patches->get(p);
+      if(cout_doing.active())
+        cout_doing << "CGSolver::pipelinedSetup on patch " << patch->getID()<< endl;
+      for(int m = 0;m<matls->size();m++){
+        int matl = matls->get(m);
+        IntVector l, h, ll, hh;
+        getSolveRange(patch, l, h, ll, hh);
+        CellIterator iter(l, h);
+
+        typename Types::matrix_type A;
+        A_dw->get(A, A_label, matl, patch, Ghost::None, 0);
+        typename Types::const_type U, R;
+        new_dw->get(U, D_label, matl, patch, Around, 1);
+        new_dw->get(R, R_label, matl, patch, Ghost::None, 0);
+
+        typename Types::sol_type W, Z, Q, S, P;
+        new_dw->allocateAndPut(W, W_label, matl, patch);
+        new_dw->allocateAndPut(Z, Z_label, matl, patch);
+        new_dw->allocateAndPut(Q, Q_label, matl, patch);
+        new_dw->allocateAndPut(S, S_label, matl, patch);
+        new_dw->allocateAndPut(P, P_label, matl, patch);
+        Z.initialize(0);
+        Q.initialize(0);
+        S.initialize(0);
+        P.initialize(0);
+
+        long64 flops = 0;
+        long64 memrefs = 0;
+        double delta;
+        ::Mult(W, A, U, iter, ll, hh, flops, memrefs, delta);
+        double gamma = ::Dot(R, U, iter, flops, memrefs);
+        double err = (params->norm == CGSolverParams::L2)
+                       ? ::Dot(R, R, iter, flops, memrefs)
+                       : ::L1(U, iter, flops, memrefs);
+
+        new_dw->put(sumvec_vartype(Vector(gamma, delta, err)), dots_label);
+        new_dw->put(sumlong_vartype(flops), flop_label);
+        new_dw->put(sumlong_vartype(memrefs), memref_label);
+      }
+    }
+  }
+
+  //______________________________________________________________________
+  //  m = M w, n = A m
+  //  requires w (W, new, 1 ghost), diagonal (new, 1 ghost)
+  void pipelinedMult(const ProcessorGroup*, const PatchSubset* patches,
+                     const MaterialSubset* matls,
+                     DataWarehouse*, DataWarehouse* new_dw)
+  {
+    DataWarehouse* A_dw = new_dw->getOtherDataWarehouse(parent_which_A_dw);
+    for(int p=0;p<patches->size();p++){
+      const Patch* patch = patches->get(p);
+      if(cout_doing.active())
+        cout_doing << "CGSolver::pipelinedMult on patch " << patch->getID()<< endl;
+      for(int m = 0;m<matls->size();m++){
+        int matl = matls->get(m);
+        IntVector l, h, ll, hh;
+        getSolveRange(patch, l, h, ll, hh);
+        CellIterator iter(l, h);
+
+        typename Types::matrix_type A;
+        A_dw->get(A, A_label, matl, patch, Ghost::None, 0);
+        typename Types::const_type W, diagonal;
+        new_dw->get(W, W_label, matl, patch, Around, 1);
+        new_dw->get(diagonal, diag_label, matl, patch, Around, 1);
+
+        // m is also computed in the ghost cells that the stencil reads, so
+        // that it does not need a second ghost cell exchange
+        typename Types::sol_type M, N;
+        new_dw->allocateAndPut(M, M_label, matl, patch, Around, 1);
+        new_dw->allocateAndPut(N, N_label, matl, patch);
+
+        long64 flops = 0;
+        long64 memrefs = 0;
+        ::Mult(M, W, diagonal, CellIterator(ll, hh+IntVector(1,1,1)), flops, memrefs);
+        ::Mult(N, A, M, iter, ll, hh, flops, memrefs);
+
+        new_dw->put(sumlong_vartype(flops), flop_label);
+        new_dw->put(sumlong_vartype(memrefs), memref_label);
+      }
+    }
+  }
+
+  void schedulePipelinedMult(SchedulerP& subsched)
+  {
+    if(cout_doing.active())
+      cout_doing << "CGSolver::schedule pipelined mult" << endl;
+    Task* task = scinew Task("CGSolver: schedule pipelined mult", this, &CGStencil7<Types>::pipelinedMult);
+    task->requires(parent_which_A_dw, A_label, Ghost::None, 0);
+    task->requires(Task::NewDW, W_label,    Around, 1);
+    task->requires(Task::NewDW, diag_label, Around, 1);
+    task->computes(M_label);
+    task->computes(N_label);
+    task->computes(flop_label);
+    task->modifies(memref_label);
+    subsched->addTask(task, level->eachPatch(), matlset);
+  }
+
+  //______________________________________________________________________
+  //  The vector updates and the partial sums of the next reduction, in one
+  //  sweep.  requires x, r, u, w, z, q, s, p, m, n (old)
+  void pipelinedUpdate(const ProcessorGroup*, const PatchSubset* patches,
+                       const MaterialSubset* matls,
+                       DataWarehouse* old_dw, DataWarehouse* new_dw)
+  {
+    for(int p=0;p<patches->size();p++){
+      const Patch* patch = patches->get(p);
+      if(cout_doing.active())
+        cout_doing << "CGSolver::pipelinedUpdate on patch " << patch->getID()<< endl;
+      for(int m = 0;m<matls->size();m++){
+        int matl = matls->get(m);
+        IntVector l, h, ll, hh;
+        getSolveRange(patch, l, h, ll, hh);
+        CellIterator iter(l, h);
+
+        typename Types::const_type X, R, U, W, Z, Q, S, P, M, N;
+        old_dw->get(X, X_label, matl, patch, Ghost::None, 0);
+        old_dw->get(R, R_label, matl, patch, Ghost::None, 0);
+        old_dw->get(U, D_label, matl, patch, Ghost::None, 0);
+        old_dw->get(W, W_label, matl, patch, Ghost::None, 0);
+        old_dw->get(Z, Z_label, matl, patch, Ghost::None, 0);
+        old_dw->get(Q, Q_label, matl, patch, Ghost::None, 0);
+        old_dw->get(S, S_label, matl, patch, Ghost::None, 0);
+        old_dw->get(P, P_label, matl, patch, Ghost::None, 0);
+        old_dw->get(M, M_label, matl, patch, Ghost::None, 0);
+        old_dw->get(N, N_label, matl, patch, Ghost::None, 0);
+
+        typename Types::sol_type Xnew, Rnew, Unew, Wnew, Znew, Qnew, Snew, Pnew;
+        new_dw->allocateAndPut(Xnew, X_label, matl, patch);
+        new_dw->allocateAndPut(Rnew, R_label, matl, patch);
+        new_dw->allocateAndPut(Unew, D_label, matl, patch);
+        new_dw->allocateAndPut(Wnew, W_label, matl, patch);
+        new_dw->allocateAndPut(Znew, Z_label, matl, patch);
+        new_dw->allocateAndPut(Qnew, Q_label, matl, patch);
+        new_dw->allocateAndPut(Snew, S_label, matl, patch);
+        new_dw->allocateAndPut(Pnew, P_label, matl, patch);
+
+        // the error term is (r,r) for the L2 norm and the L1 norm of u
+        // otherwise, so that it is part of the same reduction
+        bool l2 = (params->norm == CGSolverParams::L2);
+        double gamma=0, delta=0, err=0;
+        for(; !iter.done(); ++iter){
+          IntVector idx = *iter;
+          double z = N[idx] + beta*Z[idx];
+          double q = M[idx] + beta*Q[idx];
+          double s = W[idx] + beta*S[idx];
+          double pp = U[idx] + beta*P[idx];
+          double r = R[idx] - alpha*s;
+          double u = U[idx] - alpha*q;
+          double w = W[idx] - alpha*z;
+          Znew[idx] = z;
+          Qnew[idx] = q;
+          Snew[idx] = s;
+          Pnew[idx] = pp;
+          Xnew[idx] = X[idx] + alpha*pp;
+          Rnew[idx] = r;
+          Unew[idx] = u;
+          Wnew[idx] = w;
+          gamma += r*u;
+          delta += w*u;
+          err += l2 ? r*r : Abs(u);
+        }
+        IntVector diff = iter.end()-iter.begin();
+        long64 flops = 22*diff.x()*diff.y()*diff.z();
+        long64 memrefs = 18L*diff.x()*diff.y()*diff.z()*8L;
+
+        new_dw->put(sumvec_vartype(Vector(gamma, delta, err)), dots_label);
+        new_dw->put(sumlong_vartype(flops), flop_label);
+        new_dw->put(sumlong_vartype(memrefs), memref_label);
+      }
+    }
+    new_dw->transferFrom(old_dw, diag_label, patches, matls);
+  }
+
+  //______________________________________________________________________
+  //  Multigrid preconditioner.  The LevelMultigrid of a material spans all
+  //  the patches of the level, so multigridSetup and multigridPrecondition
+  //  run on the per processor patch set (once per rank, with all its
+  //  patches) and call it with the patches of the rank in level order.
+  //  They require the reductions that are computed before them, so that
+  //  no rank waits in a reduction while the others are in the multigrid.
+
+  LevelMultigrid* getMultigrid(int matl)
+  {
+    LevelMultigrid*& mg = multigrids[matl];
+    if(!mg){
+      mg = scinew LevelMultigrid(world->getComm(), params->mg_levels, params->mg_smooth);
+    }
+    return mg;
+  }
+
+  // The solve ranges of all the patches of the level and the patches of
+  // this rank
+  void getMultigridBlocks(std::vector<LevelMultigrid::Block>& blocks,
+                          std::vector<const Patch*>& myPatches)
+  {
+    LoadBalancer* lb = sched->getLoadBalancer();
+    for(Level::const_patchIterator iter = level->patchesBegin(); iter != level->patchesEnd(); iter++){
+      const Patch* patch = *iter;
+      LevelMultigrid::Block block;
+      IntVector ll, hh;
+      getSolveRange(patch, block.low, block.high, ll, hh);
+      block.rank = lb->getPatchwiseProcessorAssignment(patch);
+      blocks.push_back(block);
+      if(block.rank == world->myrank()){
+        myPatches.push_back(patch);
+      }
+    }
+  }
+
+  //______________________________________________________________________
+  //  Builds the hierarchy from A and computes D = M R, d = (R, D)
+  void multigridSetup(const ProcessorGroup*, const PatchSubset* patches,
+                      const MaterialSubset* matls,
+                      DataWarehouse*, DataWarehouse* new_dw)
+  {
+    // Ranks without patches are not on the multigrid communicator
+    if(patches->empty()){
+      return;
+    }
+    DataWarehouse* A_dw = new_dw->getOtherDataWarehouse(parent_which_A_dw);
+    std::vector<LevelMultigrid::Block> blocks;
+    std::vector<const Patch*> myPatches;
+    getMultigridBlocks(blocks, myPatches);
+    int numPatches = (int) myPatches.size();
+
+    for(int m = 0;m<matls->size();m++){
+      int matl = matls->get(m);
+      std::vector<typename Types::matrix_type> A(numPatches);
+      std::vector<typename Types::const_type> R(numPatches);
+      std::vector<typename Types::sol_type> D(numPatches);
+      std::vector<const Array3<Stencil7>*> As(numPatches);
+      std::vector<const Array3<double>*> Rs(numPatches);
+      std::vector<Array3<double>*> Ds(numPatches);
+      for(int p=0;p<numPatches;p++){
+        const Patch* patch = myPatches[p];
+        A_dw->get(A[p], A_label, matl, patch, Ghost::None, 0);
+        new_dw->get(R[p], R_label, matl, patch, Ghost::None, 0);
+        new_dw->allocateAndPut(D[p], D_label, matl, patch);
+        D[p].initialize(0);
+        const Array3<Stencil7>& a = A[p];
+        const Array3<double>& r = R[p];
+        As[p] = &a;
+        Rs[p] = &r;
+        Ds[p] = &D[p];
+      }
+
+      long64 flops = 0;
+      long64 memrefs = 0;
+      LevelMultigrid* mg = getMultigrid(matl);
+      mg->setup(blocks, As);
+      mg->apply(Rs, Ds, flops, memrefs);
+
+      double dnew = 0;
+      for(int p=0;p<numPatches;p++){
+        IntVector l, h, ll, hh;
+        getSolveRange(myPatches[p], l, h, ll, hh);
+        CellIterator iter(l, h);
+        dnew += ::Dot(R[p], D[p], iter, flops, memrefs);
+      }
+      new_dw->put(sum_vartype(dnew), d_label);
+      new_dw->put(sumlong_vartype(flops), flop_label);
+      new_dw->put(sumlong_vartype(memrefs), memref_label);
+    }
+  }
+
+  //______________________________________________________________________
+  //  Q = M R, d = (R, Q) and the error term
+  void multigridPrecondition(const ProcessorGroup*, const PatchSubset* patches,
+                             const MaterialSubset* matls,
+                             DataWarehouse*, DataWarehouse* new_dw)
+  {
+    if(patches->empty()){
+      return;
+    }
+    std::vector<LevelMultigrid::Block> blocks;
+    std::vector<const Patch*> myPatches;
+    getMultigridBlocks(blocks, myPatches);
+    int numPatches = (int) myPatches.size();
+
+    for(int m = 0;m<matls->size();m++){
+      int matl = matls->get(m);
+      std::vector<typename Types::const_type> R(numPatches);
+      std::vector<typename Types::sol_type> Q(numPatches);
+      std::vector<const Array3<double>*> Rs(numPatches);
+      std::vector<Array3<double>*> Qs(numPatches);
+      for(int p=0;p<numPatches;p++){
+        const Patch* patch = myPatches[p];
+        new_dw->get(R[p], R_label, matl, patch, Ghost::None, 0);
+        new_dw->getModifiable(Q[p], Q_label, matl, patch);
+        const Array3<double>& r = R[p];
+        Rs[p] = &r;
+        Qs[p] = &Q[p];
+      }
+
+      long64 flops = 0;
+      long64 memrefs = 0;
+      getMultigrid(matl)->apply(Rs, Qs, flops, memrefs);
+
+      double dnew = 0, l1 = 0, linf = 0;
+      for(int p=0;p<numPatches;p++){
+        IntVector l, h, ll, hh;
+        getSolveRange(myPatches[p], l, h, ll, hh);
+        CellIterator iter(l, h);
+        dnew += ::Dot(Q[p], R[p], iter, flops, memrefs);
+        if(params->norm == CGSolverParams::L1){
+          l1 += ::L1(Q[p], iter, flops, memrefs);
+        } else if(params->norm == CGSolverParams::LInfinity){
+          linf = Max(linf, ::LInf(Q[p], iter, flops, memrefs));
+        }
+      }
+      switch(params->norm){
+      case CGSolverParams::L1:
+        new_dw->put(sum_vartype(l1), err_label);
+        break;
+      case CGSolverParams::L2:
+        // Nothing...
+        break;
+      case CGSolverParams::LInfinity:
+        new_dw->put(max_vartype(linf), err_label);
+        break;
+      }
+      new_dw->put(sum_vartype(dnew), d_label);
+      new_dw->put(sumlong_vartype(flops), flop_label);
+      new_dw->put(sumlong_vartype(memrefs), memref_label);
+    }
+  }
+
   //______________________________________________________________________
   void solve(const ProcessorGroup* pg, const PatchSubset* patches,
              const MaterialSubset* matls,
@@ -700,11 +1158,14 @@ public:
     if(guess_label)
       task->requires(parent_which_guess_dw, guess_label, Around, 1);
 
+    bool multigrid = (params->preconditioner == CGSolverParams::Multigrid);
     task->computes(memref_label);
     task->computes(R_label);
     task->computes(X_label);
-    task->computes(D_label);
-    task->computes(d_label);
+    if(!multigrid){
+      task->computes(D_label);
+      task->computes(d_label);
+    }
     task->computes(tolerance_label);
     task->computes(diag_label);
     if(params->norm != CGSolverParams::L2){
@@ -713,6 +1174,42 @@ public:
     task->computes(flop_label);
     subsched->addTask(task, level->eachPatch(), matlset);
 
+    LoadBalancer* lb = sched->getLoadBalancer();
+    const PatchSet* perproc_patches = lb->getPerProcessorPatchSet(grid->getLevel(level->getIndex()));
+    if(multigrid){
+      task = scinew Task("CGSolver: schedule multigrid setup", this, &CGStencil7<Types>::multigridSetup);
+      task->requires(parent_which_A_dw, A_label, Ghost::None, 0);
+      task->requires(Task::NewDW, R_label, Ghost::None, 0);
+      task->requires(Task::NewDW, tolerance_label);
+      if(params->norm != CGSolverParams::L2){
+        task->requires(Task::NewDW, err_label);
+      }
+      task->computes(D_label);
+      task->computes(d_label);
+      task->computes(flop_label);
+      task->modifies(memref_label);
+      subsched->addTask(task, perproc_patches, matlset);
+    }
+
+    bool pipelined = (params->variant == CGSolverParams::Pipelined);
+    if(pipelined){
+      task = scinew Task("CGSolver: schedule pipelined setup", this, &CGStencil7<Types>::pipelinedSetup);
+      task->requires(parent_which_A_dw, A_label, Ghost::None, 0);
+      task->requires(Task::NewDW, D_label, Around, 1);
+      task->requires(Task::NewDW, R_label, Ghost::None, 0);
+      task->computes(W_label);
+      task->computes(Z_label);
+      task->computes(Q_label);
+      task->computes(S_label);
+      task->computes(P_label);
+      task->computes(dots_label);
+      task->computes(flop_label);
+      task->modifies(memref_label);
+      subsched->addTask(task, level->eachPatch(), matlset);
+
+      schedulePipelinedMult(subsched);
+    }
+
     subsched->compile();
     subsched->get_dw(3)->setScrubbing(DataWarehouse::ScrubNone);
     subsched->execute();    
@@ -741,15 +1238,99 @@ public:
       }
       break;
     }
-    double err0=e;
     sumlong_vartype f;
     subsched->get_dw(3)->get(f, flop_label);
     long64 flops = f;
     subsched->get_dw(3)->get(f, memref_label);
     long64 memrefs = f;
 
+    // (r,u) and (w,u) of the pipelined iteration; its error term replaces
+    // the one of the setup so that e and err0 measure the same thing
+    double gamma=0, delta=0;
+    if(pipelined){
+      sumvec_vartype dots;
+      subsched->get_dw(3)->get(dots, dots_label);
+      gamma = Vector(dots).x();
+      delta = Vector(dots).y();
+      e = Vector(dots).z();
+    }
+    double err0=e;
+    double titer = Time::currentSeconds();
+
     //__________________________________
-    if(!(e < params->initial_tolerance)) {
+    if(!(e < params->initial_tolerance) && pipelined) {
+      subsched->initialize(3, 1);
+      subsched->setParentDWs(old_dw, new_dw);
+      subsched->clearMappings();
+      subsched->mapDataWarehouse(Task::ParentOldDW, 0);
+      subsched->mapDataWarehouse(Task::ParentNewDW, 1);
+      subsched->mapDataWarehouse(Task::OldDW, 2);
+      subsched->mapDataWarehouse(Task::NewDW, 3);
+
+      //__________________________________
+      // Update - requires x, r, u, w, z, q, s, p, m, n (old)
+      // computes x, r, u, w, z, q, s, p, dots
+      if(cout_doing.active())
+        cout_doing << "CGSolver::schedule pipelined update" << endl;
+      task = scinew Task("CGSolver: schedule pipelined update", this, &CGStencil7<Types>::pipelinedUpdate);
+      const VarLabel* vectors[] = {X_label, R_label, D_label, W_label, Z_label,
+                                   Q_label, S_label, P_label};
+      for(int i=0;i<8;i++){
+        task->requires(Task::OldDW, vectors[i], Ghost::None, 0);
+        task->computes(vectors[i]);
+      }
+      task->requires(Task::OldDW, M_label,    Ghost::None, 0);
+      task->requires(Task::OldDW, N_label,    Ghost::None, 0);
+      task->requires(Task::OldDW, diag_label, Ghost::None, 0);
+      task->computes(diag_label);
+      task->computes(dots_label);
+      task->computes(flop_label);
+      task->computes(memref_label);
+      subsched->addTask(task, level->eachPatch(), matlset);
+
+      //__________________________________
+      // Mult - requires w (new, 1 ghost) computes m, n
+      // (does not depend on the reduction of the update, so it can be
+      // executed while the reduction waits for the other ranks)
+      schedulePipelinedMult(subsched);
+      subsched->compile();
+
+      //__________________________________
+      //  Main iteration
+      double gammaOld = 0, alphaOld = 0;
+      while(niter < params->maxiterations && !(e < tolerance)){
+        niter++;
+        if(niter == 1){
+          beta  = 0;
+          alpha = gamma/delta;
+        } else {
+          beta  = gamma/gammaOld;
+          alpha = gamma/(delta - beta*gamma/alphaOld);
+        }
+        gammaOld = gamma;
+        alphaOld = alpha;
+
+        subsched->advanceDataWarehouse(grid);
+        subsched->get_dw(2)->setScrubbing(DataWarehouse::ScrubComplete);
+        subsched->get_dw(3)->setScrubbing(DataWarehouse::ScrubNonPermanent);
+        subsched->execute();
+
+        //__________________________________
+        sumvec_vartype dots;
+        subsched->get_dw(3)->get(dots, dots_label);
+        gamma = Vector(dots).x();
+        delta = Vector(dots).y();
+        e = Vector(dots).z();
+        if(params->criteria == CGSolverParams::Relative){
+          e/=err0;
+        }
+        sumlong_vartype f;
+        subsched->get_dw(3)->get(f, flop_label);
+        flops += f;
+        subsched->get_dw(3)->get(f, memref_label);
+        memrefs += f;
+      }
+    } else if(!(e < params->initial_tolerance)) {
       subsched->initialize(3, 1);
       subsched->setParentDWs(old_dw, new_dw);
       subsched->clearMappings();
@@ -786,15 +1367,32 @@ public:
       task->computes(X_label);
       task->computes(R_label);
       task->modifies(Q_label);
-      task->computes(d_label);
       task->computes(diag_label);
       task->computes(flop_label);
       task->modifies(memref_label);
-      if(params->norm != CGSolverParams::L1) {
-        task->computes(err_label);
+      if(!multigrid){
+        task->computes(d_label);
+        if(params->norm != CGSolverParams::L1) {
+          task->computes(err_label);
+        }
       }
       subsched->addTask(task, level->eachPatch(), matlset);
 
+      //__________________________________
+      // Multigrid precondition - requires R(new) computes Q, d
+      if(multigrid){
+        task = scinew Task("CGSolver: schedule multigrid precondition", this, &CGStencil7<Types>::multigridPrecondition);
+        task->requires(Task::NewDW, R_label, Ghost::None, 0);
+        task->modifies(Q_label);
+        task->computes(d_label);
+        if(params->norm != CGSolverParams::L2) {
+          task->computes(err_label);
+        }
+        task->computes(flop_label);
+        task->modifies(memref_label);
+        subsched->addTask(task, perproc_patches, matlset);
+      }
+
       
       //__________________________________
       // schedule
@@ -850,6 +1448,8 @@ public:
       }
     }
 
+    double tdone = Time::currentSeconds();
+
     //__________________________________
     //  Pull the solution out of subsched new DW and put it into our X
     if(modifies_x){
@@ -901,6 +1501,9 @@ public:
              << niter << " iterations, "
              << e << " residual, " 
               << mflops<< " MFLOPS, " << memrate << " GB/sec)\n";
+        cout << "    " << (pipelined ? "pipelined" : "classic") << " CG: setup "
+             << titer-tstart << " seconds, "
+             << (niter > 0 ? (tdone-titer)/niter : 0.0) << " seconds/iteration\n";
       }else{
         if(params->getRestartTimestepOnFailure()){
            cout << "CGSolver not converging, requesting smaller timestep\n";
@@ -942,8 +1545,21 @@ private:
   const VarLabel* memref_label;
   const VarLabel* tolerance_label;
 
+  // pipelined CG
+  const VarLabel* W_label;
+  const VarLabel* Z_label;
+  const VarLabel* S_label;
+  const VarLabel* P_label;
+  const VarLabel* M_label;
+  const VarLabel* N_label;
+  const VarLabel* dots_label;
+  double alpha, beta;     // set by solve() before each iteration
+
   const CGSolverParams* params;
   bool modifies_x;
+
+  // multigrid preconditioner, by material
+  std::map<int, LevelMultigrid*> multigrids;
 };
 //______________________________________________________________________
 //
@@ -976,6 +1592,36 @@ SolverParameters* CGSolver::readParameters(ProblemSpecP& params,
           throw ProblemSetupException("Unknown norm type: "+norm, __FILE__, __LINE__);
         }
       }
+      string variant;
+      if(param->get("cg_variant", variant)){
+        if(variant == "classic") {
+          p->variant = CGSolverParams::Classic;
+        } else if(variant == "pipelined") {
+          p->variant = CGSolverParams::Pipelined;
+        } else {
+          throw ProblemSetupException("Unknown cg_variant: "+variant, __FILE__, __LINE__);
+        }
+      }
+      string preconditioner;
+      if(param->get("cg_preconditioner", preconditioner)){
+        if(preconditioner == "jacobi") {
+          p->preconditioner = CGSolverParams::Jacobi;
+        } else if(preconditioner == "multigrid") {
+          p->preconditioner = CGSolverParams::Multigrid;
+        } else {
+          throw ProblemSetupException("Unknown cg_preconditioner: "+preconditioner, __FILE__, __LINE__);
+        }
+      }
+      param->get("mg_levels", p->mg_levels);
+      param->get("mg_smooth", p->mg_smooth);
+      if(p->preconditioner == CGSolverParams::Multigrid &&
+         p->variant == CGSolverParams::Pipelined) {
+        throw ProblemSetupException("The pipelined CG needs the jacobi cg_preconditioner", __FILE__, __LINE__);
+      }
+      if(p->norm == CGSolverParams::LInfinity &&
+         p->variant == CGSolverParams::Pipelined) {
+        throw ProblemSetupException("The pipelined CG does not support the LInfinity norm", __FILE__, __LINE__);
+      }
       string criteria;
       if(param->get("criteria", criteria)){
         if(criteria == "Absolute" || criteria == "absolute") {
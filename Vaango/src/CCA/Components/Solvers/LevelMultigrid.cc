@@ -0,0 +1,890 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2015-     Parresia Research Limited, New Zealand
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <CCA/Components/Solvers/LevelMultigrid.h>
+
+#include <Core/Exceptions/InternalError.h>
+#include <Core/Malloc/Allocator.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+using namespace Uintah;
+
+namespace {
+
+  // The grids with the patch decomposition are coarsened until they have
+  // at most this many cells, then the last one is gathered and solved
+  // with COARSE_CYCLES V-cycles on every rank
+  const long64 GATHER_CELLS = 4096;
+  const int COARSE_CYCLES = 4;
+
+  // Flops and bytes of one cell of a smoothing sweep or residual
+  const long64 CELL_FLOPS = 14;
+  const long64 CELL_BYTES = 16*8;
+
+  const int HALO_TAG = 1;
+
+  // The coarse cell of fine cell i >= origin for the coarsening factor f
+  inline int coarseIndex(int i, int origin, int f)
+  {
+    return (i - origin)/f;
+  }
+
+  inline IntVector coarseIndex(const IntVector& c, const IntVector& origin,
+                               const IntVector& f)
+  {
+    return (c - origin)/f;
+  }
+
+  inline long64 numCells(const IntVector& low, const IntVector& high)
+  {
+    IntVector size = Max(high - low, IntVector(0, 0, 0));
+    return (long64) size.x()*size.y()*size.z();
+  }
+
+  // The layer of cells outside face (-x, +x, -y, +y, -z, +z) of [low, high)
+  void faceLayer(const IntVector& low, const IntVector& high, int face,
+                 IntVector& layerLow, IntVector& layerHigh)
+  {
+    int d = face/2;
+    layerLow = low;
+    layerHigh = high;
+    if (face % 2 == 0) {
+      layerLow[d] = low[d] - 1;
+      layerHigh[d] = low[d];
+    } else {
+      layerLow[d] = high[d];
+      layerHigh[d] = high[d] + 1;
+    }
+  }
+
+}
+
+LevelMultigrid::LevelMultigrid(MPI_Comm comm, int maxLevels, int numSmooth)
+  : d_parentComm(comm),
+    d_comm(MPI_COMM_NULL),
+    d_maxLevels(std::max(maxLevels, 1)),
+    d_numSmooth(std::max(numSmooth, 1)),
+    d_box(0),
+    d_flops(0)
+{
+  MPI_Comm_rank(comm, &d_myrank);
+}
+
+LevelMultigrid::~LevelMultigrid()
+{
+  delete d_box;
+
+  // The hierarchies may outlive MPI when they are deleted with the solver
+  int finalized = 0;
+  MPI_Finalized(&finalized);
+  if (d_comm != MPI_COMM_NULL && !finalized) {
+    MPI_Comm_free(&d_comm);
+  }
+}
+
+int
+LevelMultigrid::numLevels() const
+{
+  return (int) d_grids.size() - 1 + (d_box ? d_box->numLevels() : 1);
+}
+
+//______________________________________________________________________
+//  Setup
+
+void
+LevelMultigrid::createCommunicator(const std::vector<Block>& blocks)
+{
+  std::vector<int> ranks;
+  for (unsigned int i = 0; i < blocks.size(); i++) {
+    ranks.push_back(blocks[i].rank);
+  }
+  std::sort(ranks.begin(), ranks.end());
+  ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+  if (!std::binary_search(ranks.begin(), ranks.end(), d_myrank)) {
+    SCI_THROW(InternalError("LevelMultigrid::setup on a rank without patches", __FILE__, __LINE__));
+  }
+  if (d_comm != MPI_COMM_NULL && ranks == d_ranks) {
+    return;
+  }
+
+  // Only the ranks with patches take part, so the communicator is created
+  // with a collective over them alone
+  if (d_comm != MPI_COMM_NULL) {
+    MPI_Comm_free(&d_comm);
+  }
+  d_ranks = ranks;
+  MPI_Group parentGroup, group;
+  MPI_Comm_group(d_parentComm, &parentGroup);
+  MPI_Group_incl(parentGroup, (int) d_ranks.size(), &d_ranks[0], &group);
+  MPI_Comm_create_group(d_parentComm, group, HALO_TAG, &d_comm);
+  MPI_Group_free(&group);
+  MPI_Group_free(&parentGroup);
+}
+
+void
+LevelMultigrid::allocate(Grid& grid) const
+{
+  grid.localIndex.assign(grid.blocks.size(), -1);
+  grid.local.clear();
+  grid.numCells = 0;
+
+  Stencil7 zero;
+  zero.initialize(0);
+  for (unsigned int ib = 0; ib < grid.blocks.size(); ib++) {
+    const Block& block = grid.blocks[ib];
+    grid.numCells += numCells(block.low, block.high);
+    if (block.rank != d_myrank) {
+      continue;
+    }
+    grid.localIndex[ib] = (int) grid.local.size();
+    grid.local.push_back(LocalBlock());
+    LocalBlock& local = grid.local.back();
+    local.low = block.low;
+    local.high = block.high;
+    IntVector size = block.high - block.low + IntVector(2, 2, 2);
+    local.sy = size.x();
+    local.sz = size.x()*size.y();
+    int n = size.x()*size.y()*size.z();
+    local.A.assign(n, zero);
+    local.x.assign(n, 0.0);
+    local.b.assign(n, 0.0);
+    local.r.assign(n, 0.0);
+  }
+}
+
+void
+LevelMultigrid::buildHalo(Grid& grid) const
+{
+  grid.neighbors.clear();
+  grid.copies.clear();
+  std::map<int, int> neighborIndex;
+  const std::vector<Block>& blocks = grid.blocks;
+  int numBlocks = (int) blocks.size();
+
+  // Both sides list the regions ordered by the receiving block, then the
+  // sending block, then the face, so a message needs no description
+  for (int to = 0; to < numBlocks; to++) {
+    const Block& receiver = blocks[to];
+    bool recvHere = (receiver.rank == d_myrank);
+    for (int from = 0; from < numBlocks; from++) {
+      const Block& sender = blocks[from];
+      bool sendHere = (sender.rank == d_myrank);
+      if (from == to || (!recvHere && !sendHere)) {
+        continue;
+      }
+      for (int face = 0; face < 6; face++) {
+        IntVector layerLow, layerHigh;
+        faceLayer(receiver.low, receiver.high, face, layerLow, layerHigh);
+        IntVector low = Max(layerLow, sender.low);
+        IntVector high = Min(layerHigh, sender.high);
+        if (numCells(low, high) == 0) {
+          continue;
+        }
+        if (recvHere && sendHere) {
+          Copy copy = {grid.localIndex[from], grid.localIndex[to], low, high};
+          grid.copies.push_back(copy);
+          continue;
+        }
+        int rank = recvHere ? sender.rank : receiver.rank;
+        std::map<int, int>::iterator iter = neighborIndex.find(rank);
+        if (iter == neighborIndex.end()) {
+          iter = neighborIndex.insert(std::make_pair(rank, (int) grid.neighbors.size())).first;
+          grid.neighbors.push_back(Neighbor());
+          grid.neighbors.back().rank = (int) (std::lower_bound(d_ranks.begin(), d_ranks.end(), rank)
+                                              - d_ranks.begin());
+        }
+        Neighbor& neighbor = grid.neighbors[iter->second];
+        if (recvHere) {
+          Region region = {grid.localIndex[to], low, high};
+          neighbor.recvs.push_back(region);
+        } else {
+          Region region = {grid.localIndex[from], low, high};
+          neighbor.sends.push_back(region);
+        }
+      }
+    }
+  }
+
+  for (unsigned int in = 0; in < grid.neighbors.size(); in++) {
+    Neighbor& neighbor = grid.neighbors[in];
+    long64 numSend = 0, numRecv = 0;
+    for (unsigned int i = 0; i < neighbor.sends.size(); i++) {
+      numSend += numCells(neighbor.sends[i].low, neighbor.sends[i].high);
+    }
+    for (unsigned int i = 0; i < neighbor.recvs.size(); i++) {
+      numRecv += numCells(neighbor.recvs[i].low, neighbor.recvs[i].high);
+    }
+    neighbor.sendBuffer.resize(numSend);
+    neighbor.recvBuffer.resize(numRecv);
+  }
+}
+
+void
+LevelMultigrid::dropUncoveredCouplings(Grid& grid) const
+{
+  // Mark the ghost cells that are on another block
+  std::vector<std::vector<char> > covered(grid.local.size());
+  for (unsigned int lb = 0; lb < grid.local.size(); lb++) {
+    covered[lb].assign(grid.local[lb].x.size(), 0);
+  }
+  std::vector<Region> regions;
+  for (unsigned int in = 0; in < grid.neighbors.size(); in++) {
+    regions.insert(regions.end(), grid.neighbors[in].recvs.begin(), grid.neighbors[in].recvs.end());
+  }
+  for (unsigned int ic = 0; ic < grid.copies.size(); ic++) {
+    const Copy& copy = grid.copies[ic];
+    Region region = {copy.to, copy.low, copy.high};
+    regions.push_back(region);
+  }
+  for (unsigned int ir = 0; ir < regions.size(); ir++) {
+    const Region& region = regions[ir];
+    const LocalBlock& local = grid.local[region.block];
+    for (int k = region.low.z(); k < region.high.z(); k++) {
+      for (int j = region.low.y(); j < region.high.y(); j++) {
+        for (int i = region.low.x(); i < region.high.x(); i++) {
+          covered[region.block][local.index(i, j, k)] = 1;
+        }
+      }
+    }
+  }
+
+  // and ignore the couplings with the others
+  for (unsigned int lb = 0; lb < grid.local.size(); lb++) {
+    LocalBlock& local = grid.local[lb];
+    int offset[6] = {-1, 1, -local.sy, local.sy, -local.sz, local.sz};
+    for (int k = local.low.z(); k < local.high.z(); k++) {
+      for (int j = local.low.y(); j < local.high.y(); j++) {
+        for (int i = local.low.x(); i < local.high.x(); i++) {
+          int c = local.index(i, j, k);
+          IntVector cell(i, j, k);
+          for (int dir = 0; dir < 6; dir++) {
+            int d = dir/2;
+            int neighbor = cell[d] + (dir % 2 ? 1 : -1);
+            bool inside = (neighbor >= local.low[d] && neighbor < local.high[d]);
+            if (!inside && !covered[lb][c + offset[dir]]) {
+              local.A[c][dir] = 0;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+bool
+LevelMultigrid::chooseFactor(Grid& grid) const
+{
+  // Cells are merged in pairs from the low end of the level.  A direction
+  // is coarsened if no coarse cell would be shared by two blocks (the
+  // block boundaries inside the level are an even number of cells from
+  // its low end) and the level is more than one cell wide.
+  IntVector low = grid.blocks[0].low;
+  IntVector high = grid.blocks[0].high;
+  for (unsigned int ib = 0; ib < grid.blocks.size(); ib++) {
+    low = Min(low, grid.blocks[ib].low);
+    high = Max(high, grid.blocks[ib].high);
+  }
+  grid.origin = low;
+  grid.factor = IntVector(2, 2, 2);
+  for (int d = 0; d < 3; d++) {
+    if (high[d] - low[d] < 2) {
+      grid.factor[d] = 1;
+    }
+  }
+  for (unsigned int ib = 0; ib < grid.blocks.size(); ib++) {
+    const Block& block = grid.blocks[ib];
+    for (int d = 0; d < 3; d++) {
+      if (((block.low[d] - low[d]) & 1) || (block.high[d] != high[d] && ((block.high[d] - low[d]) & 1))) {
+        grid.factor[d] = 1;
+      }
+    }
+  }
+  return grid.factor != IntVector(1, 1, 1);
+}
+
+void
+LevelMultigrid::coarsen(const Grid& fine, Grid& coarse) const
+{
+  const IntVector& origin = fine.origin;
+  const IntVector& f = fine.factor;
+  coarse.blocks = fine.blocks;
+  for (unsigned int ib = 0; ib < coarse.blocks.size(); ib++) {
+    coarse.blocks[ib].low = coarseIndex(fine.blocks[ib].low, origin, f);
+    coarse.blocks[ib].high = coarseIndex(fine.blocks[ib].high + f - IntVector(1, 1, 1), origin, f);
+  }
+  allocate(coarse);
+
+  // Galerkin product with piecewise constant interpolation: the couplings
+  // inside a coarse cell add to its diagonal, the others to the coupling
+  // with the neighboring coarse cell (which may be on another block)
+  for (unsigned int lb = 0; lb < fine.local.size(); lb++) {
+    const LocalBlock& fb = fine.local[lb];
+    LocalBlock& cb = coarse.local[lb];
+    for (int k = fb.low.z(); k < fb.high.z(); k++) {
+      for (int j = fb.low.y(); j < fb.high.y(); j++) {
+        for (int i = fb.low.x(); i < fb.high.x(); i++) {
+          IntVector cell(i, j, k);
+          IntVector cc = coarseIndex(cell, origin, f);
+          const Stencil7& a = fb.A[fb.index(i, j, k)];
+          Stencil7& ac = cb.A[cb.index(cc.x(), cc.y(), cc.z())];
+          ac.p += a.p;
+          for (int dir = 0; dir < 6; dir++) {
+            int d = dir/2;
+            int neighbor = cell[d] + (dir % 2 ? 1 : -1);
+            if (neighbor >= origin[d] && coarseIndex(neighbor, origin[d], f[d]) == cc[d]) {
+              ac.p += a[dir];
+            } else {
+              ac[dir] += a[dir];
+            }
+          }
+        }
+      }
+    }
+  }
+
+  buildHalo(coarse);
+}
+
+void
+LevelMultigrid::setupGather()
+{
+  const Grid& grid = d_grids.back();
+  int numRanks = (int) d_ranks.size();
+  int myIndex = (int) (std::lower_bound(d_ranks.begin(), d_ranks.end(), d_myrank) - d_ranks.begin());
+
+  IntVector low = grid.blocks[0].low;
+  IntVector high = grid.blocks[0].high;
+  for (unsigned int ib = 0; ib < grid.blocks.size(); ib++) {
+    low = Min(low, grid.blocks[ib].low);
+    high = Max(high, grid.blocks[ib].high);
+  }
+  d_boxLow = low;
+  d_boxSize = high - low;
+
+  // Every rank sends the cells of its blocks in block order
+  d_gatherCounts.assign(numRanks, 0);
+  std::vector<int> rankOf(grid.blocks.size());
+  for (unsigned int ib = 0; ib < grid.blocks.size(); ib++) {
+    const Block& block = grid.blocks[ib];
+    rankOf[ib] = (int) (std::lower_bound(d_ranks.begin(), d_ranks.end(), block.rank) - d_ranks.begin());
+    d_gatherCounts[rankOf[ib]] += (int) numCells(block.low, block.high);
+  }
+  d_gatherDispls.assign(numRanks, 0);
+  for (int r = 1; r < numRanks; r++) {
+    d_gatherDispls[r] = d_gatherDispls[r-1] + d_gatherCounts[r-1];
+  }
+  std::vector<int> next(d_gatherDispls);
+  d_boxOffsets.resize(grid.blocks.size());
+  for (unsigned int ib = 0; ib < grid.blocks.size(); ib++) {
+    d_boxOffsets[ib] = next[rankOf[ib]];
+    next[rankOf[ib]] += (int) numCells(grid.blocks[ib].low, grid.blocks[ib].high);
+  }
+  int total = d_gatherDispls[numRanks-1] + d_gatherCounts[numRanks-1];
+  d_gatherSend.resize(d_gatherCounts[myIndex]);
+  d_gatherRecv.resize(total);
+  long64 boxCells = numCells(low, high);
+  d_boxB.assign(boxCells, 0.0);
+  d_boxX.assign(boxCells, 0.0);
+
+  // Gather the operator (once, as 7 doubles per cell)
+  std::vector<int> counts7(numRanks), displs7(numRanks);
+  for (int r = 0; r < numRanks; r++) {
+    counts7[r] = 7*d_gatherCounts[r];
+    displs7[r] = 7*d_gatherDispls[r];
+  }
+  std::vector<double> sendA(7*d_gatherCounts[myIndex]);
+  std::vector<double> recvA(7*total);
+  int pos = 0;
+  for (unsigned int lb = 0; lb < grid.local.size(); lb++) {
+    const LocalBlock& local = grid.local[lb];
+    for (int k = local.low.z(); k < local.high.z(); k++) {
+      for (int j = local.low.y(); j < local.high.y(); j++) {
+        for (int i = local.low.x(); i < local.high.x(); i++) {
+          const Stencil7& a = local.A[local.index(i, j, k)];
+          for (int dir = 0; dir < 7; dir++) {
+            sendA[pos++] = a[dir];
+          }
+        }
+      }
+    }
+  }
+  MPI_Allgatherv(sendA.empty() ? 0 : &sendA[0], counts7[myIndex], MPI_DOUBLE,
+                 &recvA[0], &counts7[0], &displs7[0], MPI_DOUBLE, d_comm);
+
+  Stencil7 zero;
+  zero.initialize(0);
+  std::vector<Stencil7> boxA(boxCells, zero);
+  for (unsigned int ib = 0; ib < grid.blocks.size(); ib++) {
+    const Block& block = grid.blocks[ib];
+    const double* a = &recvA[7*d_boxOffsets[ib]];
+    for (int k = block.low.z(); k < block.high.z(); k++) {
+      for (int j = block.low.y(); j < block.high.y(); j++) {
+        for (int i = block.low.x(); i < block.high.x(); i++) {
+          IntVector c = IntVector(i, j, k) - d_boxLow;
+          Stencil7& s = boxA[(c.z()*d_boxSize.y() + c.y())*d_boxSize.x() + c.x()];
+          for (int dir = 0; dir < 7; dir++) {
+            s[dir] = *a++;
+          }
+        }
+      }
+    }
+  }
+
+  delete d_box;
+  d_box = scinew BoxMultigrid(d_maxLevels - (int) d_grids.size() + 1, d_numSmooth);
+  d_box->setup(boxA, d_boxSize);
+}
+
+void
+LevelMultigrid::setup(const std::vector<Block>& blocks,
+                      const std::vector<const Array3<Stencil7>*>& A)
+{
+  createCommunicator(blocks);
+
+  d_grids.clear();
+  d_grids.push_back(Grid());
+  Grid& fine = d_grids[0];
+  fine.blocks = blocks;
+  allocate(fine);
+  if (fine.local.size() != A.size()) {
+    SCI_THROW(InternalError("LevelMultigrid::setup: wrong number of operators", __FILE__, __LINE__));
+  }
+  for (unsigned int lb = 0; lb < fine.local.size(); lb++) {
+    LocalBlock& local = fine.local[lb];
+    const Array3<Stencil7>& a = *A[lb];
+    for (int k = local.low.z(); k < local.high.z(); k++) {
+      for (int j = local.low.y(); j < local.high.y(); j++) {
+        for (int i = local.low.x(); i < local.high.x(); i++) {
+          local.A[local.index(i, j, k)] = a[IntVector(i, j, k)];
+        }
+      }
+    }
+  }
+  buildHalo(fine);
+  dropUncoveredCouplings(fine);
+
+  // The coarse grids keep the blocks as long as they can be coarsened
+  while ((int) d_grids.size() < d_maxLevels &&
+         d_grids.back().numCells > GATHER_CELLS &&
+         chooseFactor(d_grids.back())) {
+    Grid coarse;
+    coarsen(d_grids.back(), coarse);
+    d_grids.push_back(coarse);
+  }
+
+  setupGather();
+
+  d_rhs.resize(fine.local.size());
+  d_sum.resize(fine.local.size());
+}
+
+//______________________________________________________________________
+//  V-cycle
+
+void
+LevelMultigrid::exchange(Grid& grid)
+{
+  int numNeighbors = (int) grid.neighbors.size();
+  std::vector<MPI_Request> requests(2*numNeighbors);
+
+  for (int in = 0; in < numNeighbors; in++) {
+    Neighbor& neighbor = grid.neighbors[in];
+    MPI_Irecv(&neighbor.recvBuffer[0], (int) neighbor.recvBuffer.size(), MPI_DOUBLE,
+              neighbor.rank, HALO_TAG, d_comm, &requests[in]);
+  }
+  for (int in = 0; in < numNeighbors; in++) {
+    Neighbor& neighbor = grid.neighbors[in];
+    double* buffer = &neighbor.sendBuffer[0];
+    for (unsigned int i = 0; i < neighbor.sends.size(); i++) {
+      const Region& region = neighbor.sends[i];
+      const LocalBlock& local = grid.local[region.block];
+      for (int k = region.low.z(); k < region.high.z(); k++) {
+        for (int j = region.low.y(); j < region.high.y(); j++) {
+          for (int i = region.low.x(); i < region.high.x(); i++) {
+            *buffer++ = local.x[local.index(i, j, k)];
+          }
+        }
+      }
+    }
+    MPI_Isend(&neighbor.sendBuffer[0], (int) neighbor.sendBuffer.size(), MPI_DOUBLE,
+              neighbor.rank, HALO_TAG, d_comm, &requests[numNeighbors + in]);
+  }
+
+  for (unsigned int ic = 0; ic < grid.copies.size(); ic++) {
+    const Copy& copy = grid.copies[ic];
+    const LocalBlock& from = grid.local[copy.from];
+    LocalBlock& to = grid.local[copy.to];
+    for (int k = copy.low.z(); k < copy.high.z(); k++) {
+      for (int j = copy.low.y(); j < copy.high.y(); j++) {
+        for (int i = copy.low.x(); i < copy.high.x(); i++) {
+          to.x[to.index(i, j, k)] = from.x[from.index(i, j, k)];
+        }
+      }
+    }
+  }
+
+  if (numNeighbors == 0) {
+    return;
+  }
+  MPI_Waitall(2*numNeighbors, &requests[0], MPI_STATUSES_IGNORE);
+
+  for (int in = 0; in < numNeighbors; in++) {
+    Neighbor& neighbor = grid.neighbors[in];
+    const double* buffer = &neighbor.recvBuffer[0];
+    for (unsigned int i = 0; i < neighbor.recvs.size(); i++) {
+      const Region& region = neighbor.recvs[i];
+      LocalBlock& local = grid.local[region.block];
+      for (int k = region.low.z(); k < region.high.z(); k++) {
+        for (int j = region.low.y(); j < region.high.y(); j++) {
+          for (int i = region.low.x(); i < region.high.x(); i++) {
+            local.x[local.index(i, j, k)] = *buffer++;
+          }
+        }
+      }
+    }
+  }
+}
+
+void
+LevelMultigrid::smooth(Grid& grid, int color)
+{
+  exchange(grid);
+  long64 cells = 0;
+  for (unsigned int lb = 0; lb < grid.local.size(); lb++) {
+    LocalBlock& local = grid.local[lb];
+    int sy = local.sy, sz = local.sz;
+    const Stencil7* A = &local.A[0];
+    double* x = &local.x[0];
+    const double* b = &local.b[0];
+    for (int k = local.low.z(); k < local.high.z(); k++) {
+      for (int j = local.low.y(); j < local.high.y(); j++) {
+
+        // The color of a cell is the parity of its global index
+        int i = local.low.x() + ((local.low.x() + j + k + color) & 1);
+        int c = local.index(i, j, k);
+        for (; i < local.high.x(); i += 2, c += 2) {
+          const Stencil7& a = A[c];
+          if (a.p == 0) {
+            continue;
+          }
+          double sum = b[c] - a.w*x[c-1] - a.e*x[c+1] - a.s*x[c-sy] - a.n*x[c+sy]
+                            - a.b*x[c-sz] - a.t*x[c+sz];
+          x[c] = sum/a.p;
+        }
+      }
+    }
+    cells += numCells(local.low, local.high);
+  }
+  d_flops += CELL_FLOPS*cells/2;
+}
+
+void
+LevelMultigrid::residual(Grid& grid)
+{
+  exchange(grid);
+  long64 cells = 0;
+  for (unsigned int lb = 0; lb < grid.local.size(); lb++) {
+    LocalBlock& local = grid.local[lb];
+    int sy = local.sy, sz = local.sz;
+    const Stencil7* A = &local.A[0];
+    const double* x = &local.x[0];
+    const double* b = &local.b[0];
+    double* r = &local.r[0];
+    for (int k = local.low.z(); k < local.high.z(); k++) {
+      for (int j = local.low.y(); j < local.high.y(); j++) {
+        int c = local.index(local.low.x(), j, k);
+        for (int i = local.low.x(); i < local.high.x(); i++, c++) {
+          const Stencil7& a = A[c];
+          r[c] = b[c] - a.p*x[c] - a.w*x[c-1] - a.e*x[c+1] - a.s*x[c-sy] - a.n*x[c+sy]
+                      - a.b*x[c-sz] - a.t*x[c+sz];
+        }
+      }
+    }
+    cells += numCells(local.low, local.high);
+  }
+  d_flops += CELL_FLOPS*cells;
+}
+
+double
+LevelMultigrid::norm2(const Grid& grid)
+{
+  double sum = 0;
+  for (unsigned int lb = 0; lb < grid.local.size(); lb++) {
+    const LocalBlock& local = grid.local[lb];
+    for (int k = local.low.z(); k < local.high.z(); k++) {
+      for (int j = local.low.y(); j < local.high.y(); j++) {
+        int c = local.index(local.low.x(), j, k);
+        for (int i = local.low.x(); i < local.high.x(); i++, c++) {
+          sum += local.r[c]*local.r[c];
+        }
+      }
+    }
+  }
+  double total = 0;
+  MPI_Allreduce(&sum, &total, 1, MPI_DOUBLE, MPI_SUM, d_comm);
+  return std::sqrt(total);
+}
+
+void
+LevelMultigrid::coarseSolve(Grid& grid)
+{
+  double* send = d_gatherSend.empty() ? 0 : &d_gatherSend[0];
+  for (unsigned int lb = 0; lb < grid.local.size(); lb++) {
+    const LocalBlock& local = grid.local[lb];
+    for (int k = local.low.z(); k < local.high.z(); k++) {
+      for (int j = local.low.y(); j < local.high.y(); j++) {
+        for (int i = local.low.x(); i < local.high.x(); i++) {
+          *send++ = local.b[local.index(i, j, k)];
+        }
+      }
+    }
+  }
+  int myIndex = (int) (std::lower_bound(d_ranks.begin(), d_ranks.end(), d_myrank) - d_ranks.begin());
+  MPI_Allgatherv(d_gatherSend.empty() ? 0 : &d_gatherSend[0], d_gatherCounts[myIndex], MPI_DOUBLE,
+                 &d_gatherRecv[0], &d_gatherCounts[0], &d_gatherDispls[0], MPI_DOUBLE, d_comm);
+
+  int nx = d_boxSize.x(), ny = d_boxSize.y();
+  for (unsigned int ib = 0; ib < grid.blocks.size(); ib++) {
+    const Block& block = grid.blocks[ib];
+    const double* b = &d_gatherRecv[d_boxOffsets[ib]];
+    for (int k = block.low.z(); k < block.high.z(); k++) {
+      for (int j = block.low.y(); j < block.high.y(); j++) {
+        for (int i = block.low.x(); i < block.high.x(); i++) {
+          IntVector c = IntVector(i, j, k) - d_boxLow;
+          d_boxB[(c.z()*ny + c.y())*nx + c.x()] = *b++;
+        }
+      }
+    }
+  }
+
+  // Every rank solves the whole grid and keeps its blocks
+  d_box->apply(&d_boxB[0], &d_boxX[0], COARSE_CYCLES, d_flops);
+
+  for (unsigned int lb = 0; lb < grid.local.size(); lb++) {
+    LocalBlock& local = grid.local[lb];
+    for (int k = local.low.z(); k < local.high.z(); k++) {
+      for (int j = local.low.y(); j < local.high.y(); j++) {
+        for (int i = local.low.x(); i < local.high.x(); i++) {
+          IntVector c = IntVector(i, j, k) - d_boxLow;
+          local.x[local.index(i, j, k)] = d_boxX[(c.z()*ny + c.y())*nx + c.x()];
+        }
+      }
+    }
+  }
+}
+
+void
+LevelMultigrid::vcycle(int level)
+{
+  Grid& grid = d_grids[level];
+  for (unsigned int lb = 0; lb < grid.local.size(); lb++) {
+    std::fill(grid.local[lb].x.begin(), grid.local[lb].x.end(), 0.0);
+  }
+
+  if (level == (int) d_grids.size() - 1) {
+    coarseSolve(grid);
+    return;
+  }
+
+  for (int s = 0; s < d_numSmooth; s++) {
+    smooth(grid, 0);
+    smooth(grid, 1);
+  }
+
+  // Restriction (sum over the fine cells of a coarse cell, which are all
+  // on the same block)
+  residual(grid);
+  Grid& coarse = d_grids[level+1];
+  const IntVector& origin = grid.origin;
+  const IntVector& f = grid.factor;
+  long64 cells = 0;
+  for (unsigned int lb = 0; lb < grid.local.size(); lb++) {
+    const LocalBlock& fb = grid.local[lb];
+    LocalBlock& cb = coarse.local[lb];
+    std::fill(cb.b.begin(), cb.b.end(), 0.0);
+    for (int k = fb.low.z(); k < fb.high.z(); k++) {
+      for (int j = fb.low.y(); j < fb.high.y(); j++) {
+        for (int i = fb.low.x(); i < fb.high.x(); i++) {
+          cb.b[cb.index(coarseIndex(i, origin.x(), f.x()), coarseIndex(j, origin.y(), f.y()),
+                   coarseIndex(k, origin.z(), f.z()))]
+            += fb.r[fb.index(i, j, k)];
+        }
+      }
+    }
+    cells += numCells(fb.low, fb.high);
+  }
+
+  vcycle(level+1);
+
+  // Prolongation (piecewise constant)
+  for (unsigned int lb = 0; lb < grid.local.size(); lb++) {
+    LocalBlock& fb = grid.local[lb];
+    const LocalBlock& cb = coarse.local[lb];
+    for (int k = fb.low.z(); k < fb.high.z(); k++) {
+      for (int j = fb.low.y(); j < fb.high.y(); j++) {
+        for (int i = fb.low.x(); i < fb.high.x(); i++) {
+          fb.x[fb.index(i, j, k)]
+            += cb.x[cb.index(coarseIndex(i, origin.x(), f.x()), coarseIndex(j, origin.y(), f.y()),
+                   coarseIndex(k, origin.z(), f.z()))];
+        }
+      }
+    }
+  }
+  d_flops += 2*cells;
+
+  for (int s = 0; s < d_numSmooth; s++) {
+    smooth(grid, 1);
+    smooth(grid, 0);
+  }
+}
+
+//______________________________________________________________________
+//  Interface
+
+void
+LevelMultigrid::copyIn(const std::vector<const Array3<double>*>& src,
+                       std::vector<double> LocalBlock::* dst)
+{
+  Grid& fine = d_grids[0];
+  for (unsigned int lb = 0; lb < fine.local.size(); lb++) {
+    LocalBlock& local = fine.local[lb];
+    const Array3<double>& a = *src[lb];
+    std::vector<double>& v = local.*dst;
+    for (int k = local.low.z(); k < local.high.z(); k++) {
+      for (int j = local.low.y(); j < local.high.y(); j++) {
+        for (int i = local.low.x(); i < local.high.x(); i++) {
+          v[local.index(i, j, k)] = a[IntVector(i, j, k)];
+        }
+      }
+    }
+  }
+}
+
+void
+LevelMultigrid::copyOut(std::vector<double> LocalBlock::* src,
+                        const std::vector<Array3<double>*>& dst) const
+{
+  const Grid& fine = d_grids[0];
+  for (unsigned int lb = 0; lb < fine.local.size(); lb++) {
+    const LocalBlock& local = fine.local[lb];
+    Array3<double>& a = *dst[lb];
+    const std::vector<double>& v = local.*src;
+    for (int k = local.low.z(); k < local.high.z(); k++) {
+      for (int j = local.low.y(); j < local.high.y(); j++) {
+        for (int i = local.low.x(); i < local.high.x(); i++) {
+          a[IntVector(i, j, k)] = v[local.index(i, j, k)];
+        }
+      }
+    }
+  }
+}
+
+void
+LevelMultigrid::apply(const std::vector<const Array3<double>*>& b,
+                      const std::vector<Array3<double>*>& x,
+                      long64& flops, long64& memrefs)
+{
+  d_flops = 0;
+  copyIn(b, &LocalBlock::b);
+  vcycle(0);
+  copyOut(&LocalBlock::x, x);
+
+  flops += d_flops;
+  memrefs += (d_flops/CELL_FLOPS)*CELL_BYTES;
+}
+
+void
+LevelMultigrid::multiply(const std::vector<const Array3<double>*>& x,
+                         const std::vector<Array3<double>*>& y,
+                         long64& flops, long64& memrefs)
+{
+  // y = -(0 - A x)
+  Grid& fine = d_grids[0];
+  d_flops = 0;
+  copyIn(x, &LocalBlock::x);
+  for (unsigned int lb = 0; lb < fine.local.size(); lb++) {
+    std::fill(fine.local[lb].b.begin(), fine.local[lb].b.end(), 0.0);
+  }
+  residual(fine);
+  for (unsigned int lb = 0; lb < fine.local.size(); lb++) {
+    std::vector<double>& r = fine.local[lb].r;
+    for (unsigned int c = 0; c < r.size(); c++) {
+      r[c] = -r[c];
+    }
+  }
+  copyOut(&LocalBlock::r, y);
+
+  flops += d_flops;
+  memrefs += (d_flops/CELL_FLOPS)*CELL_BYTES;
+}
+
+int
+LevelMultigrid::solve(const std::vector<const Array3<double>*>& b,
+                      const std::vector<Array3<double>*>& x,
+                      double tolerance, bool relative, int maxIterations,
+                      double& residualNorm, long64& flops, long64& memrefs)
+{
+  Grid& fine = d_grids[0];
+  d_flops = 0;
+  copyIn(b, &LocalBlock::b);
+  copyIn(std::vector<const Array3<double>*>(x.begin(), x.end()), &LocalBlock::x);
+  for (unsigned int lb = 0; lb < fine.local.size(); lb++) {
+    d_rhs[lb] = fine.local[lb].b;
+  }
+
+  residual(fine);
+  double norm = norm2(fine);
+  double target = relative ? tolerance*norm : tolerance;
+  int iterations = 0;
+  while (iterations < maxIterations && !(norm <= target)) {
+    iterations++;
+
+    // x = x + M r
+    for (unsigned int lb = 0; lb < fine.local.size(); lb++) {
+      LocalBlock& local = fine.local[lb];
+      d_sum[lb] = local.x;
+      local.b = local.r;
+    }
+    vcycle(0);
+    for (unsigned int lb = 0; lb < fine.local.size(); lb++) {
+      LocalBlock& local = fine.local[lb];
+      for (unsigned int c = 0; c < local.x.size(); c++) {
+        local.x[c] += d_sum[lb][c];
+      }
+      local.b = d_rhs[lb];
+    }
+
+    residual(fine);
+    norm = norm2(fine);
+  }
+  copyOut(&LocalBlock::x, x);
+  residualNorm = norm;
+
+  flops += d_flops;
+  memrefs += (d_flops/CELL_FLOPS)*CELL_BYTES;
+  return iterations;
+}
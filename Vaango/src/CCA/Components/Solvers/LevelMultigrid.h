@@ -0,0 +1,215 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2015-     Parresia Research Limited, New Zealand
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef VAANGO_CCA_COMPONENTS_SOLVERS_LEVELMULTIGRID_H
+#define VAANGO_CCA_COMPONENTS_SOLVERS_LEVELMULTIGRID_H
+
+#include <CCA/Components/Solvers/BoxMultigrid.h>
+
+#include <Core/Disclosure/TypeUtils.h>
+#include <Core/Geometry/IntVector.h>
+#include <Core/Grid/Variables/Array3.h>
+#include <Core/Grid/Variables/Stencil7.h>
+
+#include <sci_defs/mpi_defs.h> // For MPIPP_H on SGI
+
+#include <vector>
+
+namespace Uintah {
+
+  /**
+   *  @class  LevelMultigrid
+   *  @brief  Geometric multigrid for the 7-point stencil on all the patches
+   *          of a level
+   *
+   *  The grids of the hierarchy keep the patch decomposition of the level:
+   *  every rank coarsens the operator of its own patches (2x2x2 cells with
+   *  the Galerkin product P^T A P for piecewise constant P) and the grids
+   *  exchange one layer of ghost cells between the patches, so smoothing,
+   *  restriction and prolongation span the whole level.  A direction is
+   *  coarsened only while all the patch boundaries inside the level are an
+   *  even number of cells from its low end, so that no coarse cell is
+   *  shared by two patches.
+   *
+   *  When the level grid has at most a few thousand cells, or cannot be
+   *  coarsened further, it is gathered on every rank and solved with
+   *  several V-cycles of BoxMultigrid.  The patch layout decides how small
+   *  that grid is: patches with power of two sizes coarsen down to one
+   *  cell per patch, patches with odd sizes stop the coarsening early.
+   *
+   *  apply() is one V-cycle from a zero initial guess with red-black
+   *  Gauss-Seidel smoothing in a symmetric order, so it can precondition
+   *  CG.  solve() iterates V-cycles on the residual.  Couplings with cells
+   *  that are not on any patch (the boundary conditions) are ignored, as
+   *  in CGSolver.
+   *
+   *  The ranks that own patches of the level communicate on their own
+   *  communicator, so every one of them has to call setup(), apply() and
+   *  solve() (once per call, with all its patches).
+   */
+  class LevelMultigrid {
+
+  public:
+
+    // The cells [low, high) of a patch and the rank that owns it
+    struct Block {
+      IntVector low;
+      IntVector high;
+      int rank;
+    };
+
+    LevelMultigrid(MPI_Comm comm, int maxLevels, int numSmooth);
+    ~LevelMultigrid();
+
+    // Builds the hierarchy.  blocks lists all the patches of the level in
+    // the same order on every rank, and A has the operators of the blocks
+    // of this rank in that order.
+    void setup(const std::vector<Block>& blocks,
+               const std::vector<const Array3<Stencil7>*>& A);
+
+    // x = M b on the blocks of this rank, M is one V-cycle
+    void apply(const std::vector<const Array3<double>*>& b,
+               const std::vector<Array3<double>*>& x,
+               long64& flops, long64& memrefs);
+
+    // y = A x on the blocks of this rank
+    void multiply(const std::vector<const Array3<double>*>& x,
+                  const std::vector<Array3<double>*>& y,
+                  long64& flops, long64& memrefs);
+
+    // V-cycles on the residual until its L2 norm is below tolerance
+    // (times the initial norm if relative) or maxIterations is reached.
+    // x holds the initial guess.  Returns the number of V-cycles.
+    int solve(const std::vector<const Array3<double>*>& b,
+              const std::vector<Array3<double>*>& x,
+              double tolerance, bool relative, int maxIterations,
+              double& residualNorm, long64& flops, long64& memrefs);
+
+    // The number of grids with the patch decomposition and in total
+    int numDistributedLevels() const { return (int) d_grids.size(); }
+    int numLevels() const;
+
+  private:
+
+    // The grid of one patch with a layer of ghost cells
+    struct LocalBlock {
+      IntVector low;
+      IntVector high;
+      int sy, sz;
+      std::vector<Stencil7> A;
+      std::vector<double> x;
+      std::vector<double> b;
+      std::vector<double> r;
+
+      int index(int i, int j, int k) const {
+        return (k - low.z() + 1)*sz + (j - low.y() + 1)*sy + i - low.x() + 1;
+      }
+    };
+
+    // Cells [low, high) of a local block
+    struct Region {
+      int block;
+      IntVector low;
+      IntVector high;
+    };
+
+    // Ghost cells of a local block filled from another local block
+    struct Copy {
+      int from;
+      int to;
+      IntVector low;
+      IntVector high;
+    };
+
+    // The ghost cells exchanged with one rank, in one message each way
+    struct Neighbor {
+      int rank;
+      std::vector<Region> sends;
+      std::vector<Region> recvs;
+      std::vector<double> sendBuffer;
+      std::vector<double> recvBuffer;
+    };
+
+    struct Grid {
+      std::vector<Block> blocks;
+      std::vector<int> localIndex;   // index in local, -1 for other ranks
+      std::vector<LocalBlock> local;
+      std::vector<Neighbor> neighbors;
+      std::vector<Copy> copies;
+      IntVector origin;              // the cell where coarsening starts
+      IntVector factor;              // coarsening factor to the next grid
+      long64 numCells;
+    };
+
+    void createCommunicator(const std::vector<Block>& blocks);
+    void allocate(Grid& grid) const;
+    void buildHalo(Grid& grid) const;
+    void dropUncoveredCouplings(Grid& grid) const;
+    bool chooseFactor(Grid& grid) const;
+    void coarsen(const Grid& fine, Grid& coarse) const;
+    void setupGather();
+
+    void exchange(Grid& grid);
+    void smooth(Grid& grid, int color);
+    void residual(Grid& grid);
+    void vcycle(int level);
+    void coarseSolve(Grid& grid);
+    double norm2(const Grid& grid);
+
+    void copyIn(const std::vector<const Array3<double>*>& src,
+                std::vector<double> LocalBlock::* dst);
+    void copyOut(std::vector<double> LocalBlock::* src,
+                 const std::vector<Array3<double>*>& dst) const;
+
+    MPI_Comm d_parentComm;
+    MPI_Comm d_comm;
+    std::vector<int> d_ranks;        // the ranks of d_comm in d_parentComm
+    int d_myrank;                    // the rank in d_parentComm
+
+    int d_maxLevels;
+    int d_numSmooth;
+    std::vector<Grid> d_grids;
+
+    // The last grid gathered on every rank
+    IntVector d_boxLow;
+    IntVector d_boxSize;
+    std::vector<int> d_gatherCounts;
+    std::vector<int> d_gatherDispls;
+    std::vector<double> d_gatherSend;
+    std::vector<double> d_gatherRecv;
+    std::vector<double> d_boxB;
+    std::vector<double> d_boxX;
+    std::vector<int> d_boxOffsets;   // of the blocks in d_gatherRecv
+    BoxMultigrid* d_box;
+
+    // Copies of the right hand side and solution for solve()
+    std::vector<std::vector<double> > d_rhs;
+    std::vector<std::vector<double> > d_sum;
+
+    long64 d_flops;
+  };
+
+} // End namespace Uintah
+
+#endif // VAANGO_CCA_COMPONENTS_SOLVERS_LEVELMULTIGRID_H
@@ -0,0 +1,373 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2015-     Parresia Research Limited, New Zealand
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <CCA/Components/Solvers/MultigridSolver.h>
+#include <CCA/Components/Solvers/LevelMultigrid.h>
+#include <CCA/Components/Solvers/MatrixUtil.h>
+#include <CCA/Ports/LoadBalancer.h>
+#include <CCA/Ports/Scheduler.h>
+#include <Core/Exceptions/ConvergenceFailure.h>
+#include <Core/Exceptions/InternalError.h>
+#include <Core/Exceptions/ProblemSetupException.h>
+#include <Core/Grid/Level.h>
+#include <Core/Grid/Variables/CCVariable.h>
+#include <Core/Grid/Variables/NCVariable.h>
+#include <Core/Grid/Variables/SFCXVariable.h>
+#include <Core/Grid/Variables/SFCYVariable.h>
+#include <Core/Grid/Variables/SFCZVariable.h>
+#include <Core/Grid/Variables/Stencil7.h>
+#include <Core/Grid/Variables/VarTypes.h>
+#include <Core/Parallel/ProcessorGroup.h>
+#include <Core/ProblemSpec/ProblemSpec.h>
+#include <Core/Thread/Time.h>
+#include <Core/Util/DebugStream.h>
+
+#include <map>
+
+using namespace std;
+using namespace Uintah;
+//__________________________________
+//  To turn on normal output
+//  setenv SCI_DEBUG "MGSOLVER_DOING_COUT:+"
+
+static DebugStream cout_doing("MGSOLVER_DOING_COUT", false);
+
+namespace Uintah {
+
+MultigridSolver::MultigridSolver(const ProcessorGroup* myworld)
+  : UintahParallelComponent(myworld)
+{
+}
+
+MultigridSolver::~MultigridSolver()
+{
+}
+
+class MultigridSolverParams : public SolverParameters {
+public:
+  double tolerance;
+  int maxiterations;
+  enum Criteria {
+    Absolute, Relative
+  };
+  Criteria criteria;
+  int mg_levels;
+  int mg_smooth;
+  MultigridSolverParams()
+    : tolerance(1.e-8), maxiterations(75), criteria(Relative),
+      mg_levels(10), mg_smooth(2)
+  {
+  }
+  ~MultigridSolverParams() {}
+};
+
+template<class Types>
+class MultigridStencil7 : public RefCounted {
+public:
+  MultigridStencil7(Scheduler* sched, const ProcessorGroup* world,
+                    const Level* level,
+                    const VarLabel* A, Task::WhichDW which_A_dw,
+                    const VarLabel* x, bool modifies_x,
+                    const VarLabel* b, Task::WhichDW which_b_dw,
+                    const VarLabel* guess, Task::WhichDW which_guess_dw,
+                    const MultigridSolverParams* params)
+    : sched(sched), world(world), level(level),
+      A_label(A), which_A_dw(which_A_dw),
+      X_label(x), modifies_x(modifies_x),
+      B_label(b), which_b_dw(which_b_dw),
+      guess_label(guess), which_guess_dw(which_guess_dw),
+      params(params)
+  {
+  }
+
+  virtual ~MultigridStencil7() {
+    for(std::map<int, LevelMultigrid*>::iterator iter = multigrids.begin(); iter != multigrids.end(); iter++){
+      delete iter->second;
+    }
+  }
+
+  //______________________________________________________________________
+  //  Runs on the per processor patch set: LevelMultigrid is called once
+  //  per rank with all its patches, in level order
+  void solve(const ProcessorGroup* pg, const PatchSubset* patches,
+             const MaterialSubset* matls,
+             DataWarehouse* old_dw, DataWarehouse* new_dw,
+             Handle<MultigridStencil7<Types> >)
+  {
+    if(cout_doing.active())
+      cout_doing << "MultigridSolver::solve" << endl;
+
+    // Ranks without patches are not on the multigrid communicator
+    if(patches->empty()){
+      return;
+    }
+    DataWarehouse* A_dw = new_dw->getOtherDataWarehouse(which_A_dw);
+    DataWarehouse* b_dw = new_dw->getOtherDataWarehouse(which_b_dw);
+    DataWarehouse* guess_dw = new_dw->getOtherDataWarehouse(which_guess_dw);
+
+    double tstart = Time::currentSeconds();
+    std::vector<LevelMultigrid::Block> blocks;
+    std::vector<const Patch*> myPatches;
+    LoadBalancer* lb = sched->getLoadBalancer();
+    for(Level::const_patchIterator iter = level->patchesBegin(); iter != level->patchesEnd(); iter++){
+      const Patch* patch = *iter;
+      LevelMultigrid::Block block;
+      getSolveRange(patch, block.low, block.high);
+      block.rank = lb->getPatchwiseProcessorAssignment(patch);
+      blocks.push_back(block);
+      if(block.rank == world->myrank()){
+        myPatches.push_back(patch);
+      }
+    }
+    int numPatches = (int) myPatches.size();
+
+    long64 flops = 0, memrefs = 0;
+    int niter = 0;
+    double e = 0;
+    for(int m = 0;m<matls->size();m++){
+      int matl = matls->get(m);
+      std::vector<typename Types::matrix_type> A(numPatches);
+      std::vector<typename Types::const_type> B(numPatches);
+      std::vector<typename Types::sol_type> X(numPatches);
+      std::vector<const Array3<Stencil7>*> As(numPatches);
+      std::vector<const Array3<double>*> Bs(numPatches);
+      std::vector<Array3<double>*> Xs(numPatches);
+      for(int p=0;p<numPatches;p++){
+        const Patch* patch = myPatches[p];
+        A_dw->get(A[p], A_label, matl, patch, Ghost::None, 0);
+        b_dw->get(B[p], B_label, matl, patch, Ghost::None, 0);
+        if(modifies_x){
+          new_dw->getModifiable(X[p], X_label, matl, patch);
+        } else {
+          new_dw->allocateAndPut(X[p], X_label, matl, patch);
+        }
+        if(guess_label){
+          typename Types::const_type guess;
+          guess_dw->get(guess, guess_label, matl, patch, Ghost::None, 0);
+          X[p].copyData(guess);
+        } else {
+          X[p].initialize(0);
+        }
+        const Array3<Stencil7>& a = A[p];
+        const Array3<double>& b = B[p];
+        As[p] = &a;
+        Bs[p] = &b;
+        Xs[p] = &X[p];
+      }
+
+      LevelMultigrid*& mg = multigrids[matl];
+      if(!mg){
+        mg = scinew LevelMultigrid(world->getComm(), params->mg_levels, params->mg_smooth);
+      }
+      mg->setup(blocks, As);
+      bool relative = (params->criteria == MultigridSolverParams::Relative);
+      niter = Max(niter, mg->solve(Bs, Xs, params->tolerance, relative,
+                                   params->maxiterations, e, flops, memrefs));
+    }
+
+    double dt=Time::currentSeconds()-tstart;
+    double mflops = (double(flops)*1.e-6)/dt;
+    double memrate = (double(memrefs)*1.e-9)/dt;
+    if(pg->myrank() == 0){
+      if(niter < params->maxiterations) {
+        cout << "Solve of " << X_label->getName() 
+             << " on level " << level->getIndex()
+             << " completed in "
+             << dt << " seconds ("
+             << niter << " V-cycles, "
+             << e << " residual, " 
+             << mflops<< " MFLOPS, " << memrate << " GB/sec)\n";
+      }else{
+        if(params->getRestartTimestepOnFailure()){
+          cout << "MultigridSolver not converging, requesting smaller timestep\n";
+          cout << "    niters:   " << niter << "\n"
+               << "    residual: " << e << endl;
+          new_dw->abortTimestep();
+          new_dw->restartTimestep();
+        }else {
+          throw ConvergenceFailure("MultigridSolve variable: "+X_label->getName(), 
+                                   niter, e, params->tolerance,__FILE__,__LINE__);
+        }
+      }
+    }
+  }
+
+private:
+  void getSolveRange(const Patch* patch, IntVector& l, IntVector& h)
+  {
+    typedef typename Types::sol_type sol_type;
+    Patch::VariableBasis basis = Patch::translateTypeToBasis(sol_type::getTypeDescription()->getType(), true);
+
+    if(params->getSolveOnExtraCells())
+    {
+      l = patch->getExtraLowIndex(basis, IntVector(0,0,0));
+      h = patch->getExtraHighIndex(basis, IntVector(0,0,0));
+    }
+    else
+    {
+      l = patch->getLowIndex(basis);
+      h = patch->getHighIndex(basis);
+    }
+  }
+
+  Scheduler* sched;
+  const ProcessorGroup* world;
+  const Level* level;
+  const VarLabel* A_label;
+  Task::WhichDW which_A_dw;
+  const VarLabel* X_label;
+  bool modifies_x;
+  const VarLabel* B_label;
+  Task::WhichDW which_b_dw;
+  const VarLabel* guess_label;
+  Task::WhichDW which_guess_dw;
+  const MultigridSolverParams* params;
+
+  // by material
+  std::map<int, LevelMultigrid*> multigrids;
+};
+
+//______________________________________________________________________
+//
+SolverParameters*
+MultigridSolver::readParameters(       ProblemSpecP     & params,
+                                 const string           & varname,
+                                       SimulationStateP & state )
+{
+  MultigridSolverParams* p = scinew MultigridSolverParams();
+  if(params){
+    for(ProblemSpecP param = params->findBlock("Parameters"); param != 0;
+        param = param->findNextBlock("Parameters")) {
+      string variable;
+      if(param->getAttribute("variable", variable) && variable != varname)
+        continue;
+
+      param->get("tolerance", p->tolerance);
+      param->get("maxiterations", p->maxiterations);
+      param->get("mg_levels", p->mg_levels);
+      param->get("mg_smooth", p->mg_smooth);
+      string criteria;
+      if(param->get("criteria", criteria)){
+        if(criteria == "Absolute" || criteria == "absolute") {
+          p->criteria = MultigridSolverParams::Absolute;
+        } else if(criteria == "Relative" || criteria == "relative") {
+          p->criteria = MultigridSolverParams::Relative;
+        } else {
+          throw ProblemSetupException("Unknown criteria: "+criteria, __FILE__, __LINE__);
+        }
+      }
+    }
+  }
+  return p;
+}
+
+//______________________________________________________________________
+//
+void
+MultigridSolver::scheduleSolve( const LevelP           & level,
+                                      SchedulerP       & sched,
+                                const MaterialSet      * matls,
+                                const VarLabel         * A,    
+                                      Task::WhichDW      which_A_dw,  
+                                const VarLabel         * x,
+                                      bool               modifies_x,
+                                const VarLabel         * b,    
+                                      Task::WhichDW      which_b_dw,  
+                                const VarLabel         * guess,
+                                      Task::WhichDW      which_guess_dw,
+                                const SolverParameters * params,
+                                      bool               /* modifies_hypre = false */ )
+{
+  Task* task;
+  // The extra handle arg ensures that the stencil7 object will get freed
+  // when the task gets freed.  The downside is that the refcount gets
+  // tweaked everytime solve is called.
+
+  TypeDescription::Type domtype = A->typeDescription()->getType();
+  ASSERTEQ(domtype, x->typeDescription()->getType());
+  ASSERTEQ(domtype, b->typeDescription()->getType());
+  const MultigridSolverParams* mgparams = dynamic_cast<const MultigridSolverParams*>(params);
+  if(!mgparams)
+    throw InternalError("Wrong type of params passed to multigrid solver!", __FILE__, __LINE__);
+
+  switch(domtype){
+  case TypeDescription::SFCXVariable:
+    {
+      MultigridStencil7<SFCXTypes>* that = scinew MultigridStencil7<SFCXTypes>(sched.get_rep(), d_myworld, level.get_rep(), A, which_A_dw, x, modifies_x, b, which_b_dw, guess, which_guess_dw, mgparams);
+      Handle<MultigridStencil7<SFCXTypes> > handle = that;
+      task = scinew Task("MultigridSolver::Matrix solve(SFCX)", that, &MultigridStencil7<SFCXTypes>::solve, handle);
+    }
+    break;
+  case TypeDescription::SFCYVariable:
+    {
+      MultigridStencil7<SFCYTypes>* that = scinew MultigridStencil7<SFCYTypes>(sched.get_rep(), d_myworld, level.get_rep(), A, which_A_dw, x, modifies_x, b, which_b_dw, guess, which_guess_dw, mgparams);
+      Handle<MultigridStencil7<SFCYTypes> > handle = that;
+      task = scinew Task("MultigridSolver::Matrix solve(SFCY)", that, &MultigridStencil7<SFCYTypes>::solve, handle);
+    }
+    break;
+  case TypeDescription::SFCZVariable:
+    {
+      MultigridStencil7<SFCZTypes>* that = scinew MultigridStencil7<SFCZTypes>(sched.get_rep(), d_myworld, level.get_rep(), A, which_A_dw, x, modifies_x, b, which_b_dw, guess, which_guess_dw, mgparams);
+      Handle<MultigridStencil7<SFCZTypes> > handle = that;
+      task = scinew Task("MultigridSolver::Matrix solve(SFCZ)", that, &MultigridStencil7<SFCZTypes>::solve, handle);
+    }
+    break;
+  case TypeDescription::CCVariable:
+    {
+      MultigridStencil7<CCTypes>* that = scinew MultigridStencil7<CCTypes>(sched.get_rep(), d_myworld, level.get_rep(), A, which_A_dw, x, modifies_x, b, which_b_dw, guess, which_guess_dw, mgparams);
+      Handle<MultigridStencil7<CCTypes> > handle = that;
+      task = scinew Task("MultigridSolver::Matrix solve(CC)", that, &MultigridStencil7<CCTypes>::solve, handle);
+    }
+    break;
+  case TypeDescription::NCVariable:
+    {
+      MultigridStencil7<NCTypes>* that = scinew MultigridStencil7<NCTypes>(sched.get_rep(), d_myworld, level.get_rep(), A, which_A_dw, x, modifies_x, b, which_b_dw, guess, which_guess_dw, mgparams);
+      Handle<MultigridStencil7<NCTypes> > handle = that;
+      task = scinew Task("MultigridSolver::Matrix solve(NC)", that, &MultigridStencil7<NCTypes>::solve, handle);
+    }
+    break;
+  default:
+    throw InternalError("Unknown variable type in scheduleSolve", __FILE__, __LINE__);
+  }
+
+  task->requires(which_A_dw, A, Ghost::None, 0);
+  if(guess)
+    task->requires(which_guess_dw, guess, Ghost::None, 0);
+  if(modifies_x)
+    task->modifies(x);
+  else
+    task->computes(x);
+
+  task->requires(which_b_dw, b, Ghost::None, 0);
+  LoadBalancer* lb = sched->getLoadBalancer();
+  const PatchSet* perproc_patches = lb->getPerProcessorPatchSet(level);
+  sched->addTask(task, perproc_patches, matls);
+}
+
+string
+MultigridSolver::getName() {
+  return "MultigridSolver";
+}
+
+} // end namespace Uintah
@@ -0,0 +1,81 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2015-     Parresia Research Limited, New Zealand
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef Packages_Uintah_CCA_Components_Solvers_MultigridSolver_h
+#define Packages_Uintah_CCA_Components_Solvers_MultigridSolver_h
+
+#include <CCA/Ports/SolverInterface.h>
+#include <Core/Parallel/UintahParallelComponent.h>
+
+namespace Uintah {
+
+  /**
+   *  @class  MultigridSolver
+   *  @brief  Solves the 7-point stencil systems of a level with V-cycles of
+   *          LevelMultigrid
+   *
+   *  <Solver type="multigrid"/> with the parameters
+   *    tolerance, maxiterations, criteria (relative or absolute, of the L2
+   *    norm of the residual), mg_levels and mg_smooth.
+   *  The same hierarchy preconditions CGSolver with
+   *  <cg_preconditioner>multigrid</cg_preconditioner>.
+   */
+  class MultigridSolver : public SolverInterface, public UintahParallelComponent { 
+
+  public:
+
+    MultigridSolver( const ProcessorGroup * myworld );
+    virtual ~MultigridSolver();
+
+    virtual SolverParameters* readParameters(       ProblemSpecP     & params,
+                                              const std::string      & name,
+                                                    SimulationStateP & state );
+
+    virtual void scheduleSolve( const LevelP           & level,
+                                      SchedulerP       & sched,
+                                const MaterialSet      * matls,
+                                const VarLabel         * A,    
+                                      Task::WhichDW      which_A_dw,  
+                                const VarLabel         * x,
+                                      bool               modifies_x,
+                                const VarLabel         * b,    
+                                      Task::WhichDW      which_b_dw,  
+                                const VarLabel         * guess,
+                                      Task::WhichDW      which_guess_dw,
+                                const SolverParameters * params,
+                                      bool               modifies_hypre = false );
+
+    virtual std::string getName();
+
+    // MultigridSolver does not require initialization... but we need an
+    // empty routine to satisfy inheritance.
+    virtual void scheduleInitialize( const LevelP      & level,
+                                           SchedulerP  & sched,
+                                     const MaterialSet * matls ) {}
+
+  };
+
+} // end namespace Uintah
+
+#endif // Packages_Uintah_CCA_Components_Solvers_MultigridSolver_h
@@ -26,6 +26,7 @@
 #include <CCA/Components/Solvers/SolverFactory.h>
 #include <CCA/Components/Solvers/CGSolver.h>
 #include <CCA/Components/Solvers/DirectSolve.h>
+#include <CCA/Components/Solvers/MultigridSolver.h>
 
 #ifdef HAVE_HYPRE
 #  include <CCA/Components/Solvers/HypreSolver.h>
@@ -63,6 +64,9 @@ SolverInterface* SolverFactory::create(       ProblemSpecP   & ps,
   else if (solver == "direct" || solver == "DirectSolver") {
     solve = scinew DirectSolve(world);
   }
+  else if (solver == "MultigridSolver" || solver == "multigrid") {
+    solve = scinew MultigridSolver(world);
+  }
   else if (solver == "HypreSolver" || solver == "hypre") {
 #if HAVE_HYPRE
     solve = scinew HypreSolver2(world);
@@ -84,7 +88,7 @@ SolverInterface* SolverFactory::create(       ProblemSpecP   & ps,
   else {
     ostringstream msg;
     msg << "\nERROR: Unknown solver (" << solver
-        << ") Valid Solvers: CGSolver, DirectSolver, HypreSolver, AMRSolver, hypreamr \n";
+        << ") Valid Solvers: CGSolver, DirectSolver, MultigridSolver, HypreSolver, AMRSolver, hypreamr \n";
     throw ProblemSetupException( msg.str(), __FILE__, __LINE__ );
   }
 
@@ -33,6 +33,7 @@
 #include <Core/Grid/Ghost.h>
 #include <Core/Util/RefCounted.h>
 #include <Core/Grid/Variables/ParticleVariableBase.h>
+#include <Core/Grid/Variables/ParticleIDMap.h>
 #include <Core/Grid/Variables/ReductionVariableBase.h>
 #include <Core/Grid/Variables/PerPatchBase.h>
 #include <Core/Grid/Variables/ComputeSet.h>
@@ -85,7 +86,6 @@ WARNING
       
   typedef std::map<const VarLabel*, ParticleVariableBase*> ParticleLabelVariableMap;
   typedef std::map<const VarLabel*, constParticleVariableBase*> constParticleLabelVariableMap;
-  typedef std::map<long64, int> ParticleIDMap;
 
   class DataWarehouse : public RefCounted {
 
@@ -368,6 +368,14 @@ WARNING
                       int matlIndex, 
                       const Patch* patch) = 0;
 
+    // A copy of a variable, with the extents emit() would write, that
+    // can be emitted after this DataWarehouse is gone.  Delete it.
+    virtual Variable* snapshot(const VarLabel* label,
+                               int matlIndex,
+                               const Patch* patch,
+                               IntVector& low,
+                               IntVector& high) = 0;
+
     // Scrubbing
     enum ScrubMode {
       ScrubNone,
@@ -141,6 +141,10 @@ WARNING
     //! Returns the value of n (every n procs it performs output tasks).
     virtual int getNthProc() { return 1; }
 
+    //! The worker thread preferred for the tasks on this patch, -1 for
+    //! none.  Used by the threaded schedulers to keep a patch in one cache.
+    virtual int getPatchThreadGroup(const Patch* /*patch*/) { return -1; }
+
     //! Returns the processor the patch will be output on (not patchwiseProcessor
     //! if outputNthProc is set)
     virtual int getOutputProc(const Patch* patch) = 0;
@@ -157,6 +161,9 @@ WARNING
     //cost profiling functions
     //update the contribution for this patch
     virtual void addContribution(DetailedTask *task, double cost)  = 0;
+    //update the task time of a worker thread (the index used by
+    //getPatchThreadGroup); called by the scheduler under its load balancer lock
+    virtual void addThreadContribution(int /*thread*/, double /*cost*/) {}
     //finalize the contributions (updates the weight, should be called once per timestep)
     virtual void finalizeContributions(const GridP& currentgrid)  = 0;
     //initializes the weights in regions in the new grid that are not in the old level
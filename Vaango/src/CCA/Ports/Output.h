@@ -164,6 +164,11 @@ WARNING
     //get checkpoint interval
     virtual double getCheckpointInterval() const = 0;
 
+    //////////
+    // Wait for the output that is still being written.  Call at the
+    // end of the simulation.
+    virtual void flushOutput() = 0;
+
     //////////
     // Get the directory of the current time step for outputting info.
     virtual const std::string& getLastTimestepOutputLocation() const = 0;
@@ -27,6 +27,8 @@
 
 #include <Core/ProblemSpec/ProblemSpec.h>
 
+#include <string>
+
 namespace Uintah {
    /**************************************
      
@@ -59,12 +61,18 @@ namespace Uintah {
    class OutputContext {
    public:
       OutputContext(int fd, const char* filename, long cur, ProblemSpecP varnode, bool outputDoubleAsFloat = false)
-	: fd(fd), filename(filename), cur(cur), varnode(varnode), outputDoubleAsFloat(outputDoubleAsFloat)
+	: fd(fd), buffer(0), filename(filename), cur(cur), varnode(varnode), outputDoubleAsFloat(outputDoubleAsFloat)
+      {
+      }
+      // Appends the data to buffer instead of writing it to a file
+      OutputContext(std::string* buffer, const char* filename, long cur, ProblemSpecP varnode, bool outputDoubleAsFloat = false)
+	: fd(-1), buffer(buffer), filename(filename), cur(cur), varnode(varnode), outputDoubleAsFloat(outputDoubleAsFloat)
       {
       }
       ~OutputContext() {}
 
       int fd;
+      std::string* buffer;
       const char* filename;
       long cur;
       ProblemSpecP varnode;
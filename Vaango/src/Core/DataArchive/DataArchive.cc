@@ -1254,6 +1254,7 @@ DataArchive::TimeData::parsePatch(const Patch* patch)
     return;
 
   //If this is a newer uda, the patch info in the grid will store the processor where the data is
+  //(the processor that wrote it with outputNthProc or outputAggregators)
   if (patchinfo.proc != -1) {
     ostringstream file;
     file << d_ts_directory << "l" << (int) real_patch->getLevel()->getIndex() << "/p" << setw(5) << setfill('0') << (int) patchinfo.proc << ".xml";
@@ -215,10 +215,19 @@ double BSplineInterpolator::evalType3BSplineGrad(const double& dx)
 
 
 void BSplineInterpolator::findCellAndWeights(const Point& pos,
-                                            vector<IntVector>& ni, 
-                                            vector<double>& S,
-                                            const Matrix3& size,
-                                            const Matrix3& defgrad)
+                                             vector<IntVector>& ni, 
+                                             vector<double>& S,
+                                             const Matrix3& size,
+                                             const Matrix3& defgrad)
+{
+  findCellAndWeights(pos, &ni[0], &S[0], size, defgrad);
+}
+
+void BSplineInterpolator::findCellAndWeights(const Point& pos,
+                                             IntVector* ni, 
+                                             double* S,
+                                             const Matrix3& size,
+                                             const Matrix3& defgrad)
 {
   IntVector low,hi;
   Point cellpos = d_patch->getLevel()->positionToIndex(pos);
@@ -312,11 +321,23 @@ void BSplineInterpolator::findCellAndShapeDerivatives(const Point& pos,
 
 void 
 BSplineInterpolator::findCellAndWeightsAndShapeDerivatives(const Point& pos,
-                                                          vector<IntVector>& ni,
-                                                          vector<double>& S,
-                                                          vector<Vector>& d_S,
-                                                          const Matrix3& size,
-                                                          const Matrix3& defgrad)
+                                                           vector<IntVector>& ni,
+                                                           vector<double>& S,
+                                                           vector<Vector>& d_S,
+                                                           const Matrix3& size,
+                                                           const Matrix3& defgrad)
+{
+  findCellAndWeightsAndShapeDerivatives(pos, &ni[0], &S[0], &d_S[0],
+                                        size, defgrad);
+}
+
+void 
+BSplineInterpolator::findCellAndWeightsAndShapeDerivatives(const Point& pos,
+                                                           IntVector* ni,
+                                                           double* S,
+                                                           Vector* d_S,
+                                                           const Matrix3& size,
+                                                           const Matrix3& defgrad)
 {
   IntVector low,hi;
   Point cellpos = d_patch->getLevel()->positionToIndex(pos);
@@ -370,3 +391,7 @@ int BSplineInterpolator::size()
 {
   return d_size;
 }
+
+//______________________________________________________________________
+//  Allocation-free batch interface (see ParticleInterpolatorBatch.h)
+UINTAH_INSTANTIATE_INTERPOLATOR_BATCH(BSplineInterpolator)
@@ -50,6 +50,7 @@
 #define BSPLINE_INTERPOLATOR_H
 
 #include <Core/Grid/ParticleInterpolator.h>
+#include <Core/Grid/ParticleInterpolatorBatch.h>
 
 namespace Uintah {
 
@@ -82,6 +83,24 @@ namespace Uintah {
                                                        const Matrix3& defgrad);
     virtual int size();
 
+    //__________________________________
+    //  Allocation-free kernels used by the batch interface in
+    //  ParticleInterpolatorBatch.h.  ni, S and d_S must hold NUM_NODES entries.
+    static const int NUM_NODES = 64;   // 4x4x4 node stencil
+
+    void findCellAndWeights(const Point& pos,
+                            IntVector* ni,
+                            double* S,
+                            const Matrix3& size,
+                            const Matrix3& defgrad);
+
+    void findCellAndWeightsAndShapeDerivatives(const Point& pos,
+                                               IntVector* ni,
+                                               double* S,
+                                               Vector* d_S,
+                                               const Matrix3& size,
+                                               const Matrix3& defgrad);
+
     void findNodeComponents(const int& idx, int* xn, int& count,
                             const int& low, const int& hi);
 
@@ -129,4 +148,6 @@ namespace Uintah {
   };
 }
 
+UINTAH_EXTERN_INTERPOLATOR_BATCH(BSplineInterpolator)
+
 #endif
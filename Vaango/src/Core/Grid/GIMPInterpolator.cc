@@ -54,10 +54,19 @@ GIMPInterpolator* GIMPInterpolator::clone(const Patch* patch)
 }
     
 void GIMPInterpolator::findCellAndWeights(const Point& pos,
-                                            vector<IntVector>& ni, 
-                                            vector<double>& S,
-                                            const Matrix3& size,
-                                            const Matrix3& defgrad)
+                                          vector<IntVector>& ni, 
+                                          vector<double>& S,
+                                          const Matrix3& size,
+                                          const Matrix3& defgrad)
+{
+  findCellAndWeights(pos, &ni[0], &S[0], size, defgrad);
+}
+
+void GIMPInterpolator::findCellAndWeights(const Point& pos,
+                                          IntVector* ni, 
+                                          double* S,
+                                          const Matrix3& size,
+                                          const Matrix3& defgrad)
 {
   Point cellpos = d_patch->getLevel()->positionToIndex(pos);
   int ix = Floor(cellpos.x());
@@ -365,11 +374,23 @@ void GIMPInterpolator::findCellAndShapeDerivatives(const Point& pos,
 
 void 
 GIMPInterpolator::findCellAndWeightsAndShapeDerivatives(const Point& pos,
-                                                          vector<IntVector>& ni,
-                                                          vector<double>& S,
-                                                          vector<Vector>& d_S,
-                                                          const Matrix3& size,
-                                                          const Matrix3& defgrad)
+                                                        vector<IntVector>& ni,
+                                                        vector<double>& S,
+                                                        vector<Vector>& d_S,
+                                                        const Matrix3& size,
+                                                        const Matrix3& defgrad)
+{
+  findCellAndWeightsAndShapeDerivatives(pos, &ni[0], &S[0], &d_S[0],
+                                        size, defgrad);
+}
+
+void 
+GIMPInterpolator::findCellAndWeightsAndShapeDerivatives(const Point& pos,
+                                                        IntVector* ni,
+                                                        double* S,
+                                                        Vector* d_S,
+                                                        const Matrix3& size,
+                                                        const Matrix3& defgrad)
 {
   Point cellpos = d_patch->getLevel()->positionToIndex(pos);
   int ix = Floor(cellpos.x());
@@ -568,3 +589,7 @@ int GIMPInterpolator::size()
 {
   return d_size;
 }
+
+//______________________________________________________________________
+//  Allocation-free batch interface (see ParticleInterpolatorBatch.h)
+UINTAH_INSTANTIATE_INTERPOLATOR_BATCH(GIMPInterpolator)
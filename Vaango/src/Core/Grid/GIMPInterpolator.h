@@ -50,6 +50,7 @@
 #define GIMP_INTERPOLATOR_H
 
 #include <Core/Grid/ParticleInterpolator.h>
+#include <Core/Grid/ParticleInterpolatorBatch.h>
 
 namespace Uintah {
 
@@ -79,6 +80,24 @@ namespace Uintah {
                                                        const Matrix3& size,
                                                        const Matrix3& defgrad);
     virtual int size();
+
+    //__________________________________
+    //  Allocation-free kernels used by the batch interface in
+    //  ParticleInterpolatorBatch.h.  ni, S and d_S must hold NUM_NODES entries.
+    static const int NUM_NODES = 27;   // 3x3x3 node stencil
+
+    void findCellAndWeights(const Point& pos,
+                            IntVector* ni,
+                            double* S,
+                            const Matrix3& size,
+                            const Matrix3& defgrad);
+
+    void findCellAndWeightsAndShapeDerivatives(const Point& pos,
+                                               IntVector* ni,
+                                               double* S,
+                                               Vector* d_S,
+                                               const Matrix3& size,
+                                               const Matrix3& defgrad);
     
     void findCellAndWeights(const Point& pos,
                                     vector<IntVector>& ni,
@@ -108,5 +127,7 @@ namespace Uintah {
   };
 }
 
+UINTAH_EXTERN_INTERPOLATOR_BATCH(GIMPInterpolator)
+
 #endif
 
@@ -51,10 +51,19 @@ LinearInterpolator* LinearInterpolator::clone(const Patch* patch)
     
 //__________________________________
 void LinearInterpolator::findCellAndWeights(const Point& pos,
-                                           vector<IntVector>& ni, 
-                                           vector<double>& S,
-                                           const Matrix3& size,
-                                           const Matrix3& defgrad)
+                                            vector<IntVector>& ni, 
+                                            vector<double>& S,
+                                            const Matrix3& size,
+                                            const Matrix3& defgrad)
+{
+  findCellAndWeights(pos, &ni[0], &S[0], size, defgrad);
+}
+
+void LinearInterpolator::findCellAndWeights(const Point& pos,
+                                            IntVector* ni, 
+                                            double* S,
+                                            const Matrix3& size,
+                                            const Matrix3& defgrad)
 {
   Point cellpos = d_patch->getLevel()->positionToIndex(pos );
   int ix = Floor(cellpos.x());
@@ -455,7 +464,19 @@ LinearInterpolator::findCellAndWeightsAndShapeDerivatives(const Point& pos,
                                                           vector<double>& S,
                                                           vector<Vector>& d_S,
                                                           const Matrix3& size,
-                                                   const Matrix3& defgrad)
+                                                          const Matrix3& defgrad)
+{
+  findCellAndWeightsAndShapeDerivatives(pos, &ni[0], &S[0], &d_S[0],
+                                        size, defgrad);
+}
+
+void 
+LinearInterpolator::findCellAndWeightsAndShapeDerivatives(const Point& pos,
+                                                          IntVector* ni,
+                                                          double* S,
+                                                          Vector* d_S,
+                                                          const Matrix3& size,
+                                                          const Matrix3& defgrad)
 {
   Point cellpos = d_patch->getLevel()->positionToIndex(pos);
   int ix = Floor(cellpos.x());
@@ -497,3 +518,7 @@ int LinearInterpolator::size()
 {
   return d_size;
 }
+
+//______________________________________________________________________
+//  Allocation-free batch interface (see ParticleInterpolatorBatch.h)
+UINTAH_INSTANTIATE_INTERPOLATOR_BATCH(LinearInterpolator)
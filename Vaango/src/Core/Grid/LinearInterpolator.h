@@ -51,6 +51,7 @@
 
 #include <Core/Math/MiscMath.h>
 #include <Core/Grid/ParticleInterpolator.h>
+#include <Core/Grid/ParticleInterpolatorBatch.h>
 #include <Core/Grid/Patch.h>
 #include <Core/Grid/Level.h>
 #include <Core/Grid/Variables/Stencil7.h>
@@ -238,6 +239,24 @@ namespace Uintah {
                                                        const Matrix3& defgrad);
     virtual int size();
 
+    //__________________________________
+    //  Allocation-free kernels used by the batch interface in
+    //  ParticleInterpolatorBatch.h.  ni, S and d_S must hold NUM_NODES entries.
+    static const int NUM_NODES = 8;   // 2x2x2 node stencil
+
+    void findCellAndWeights(const Point& pos,
+                            IntVector* ni,
+                            double* S,
+                            const Matrix3& size,
+                            const Matrix3& defgrad);
+
+    void findCellAndWeightsAndShapeDerivatives(const Point& pos,
+                                               IntVector* ni,
+                                               double* S,
+                                               Vector* d_S,
+                                               const Matrix3& size,
+                                               const Matrix3& defgrad);
+
     void findCellAndWeights(const Point& pos,
                                     vector<IntVector>& ni,
                                     vector<double>& S,
@@ -254,5 +273,7 @@ namespace Uintah {
   };
 }
 
+UINTAH_EXTERN_INTERPOLATOR_BATCH(LinearInterpolator)
+
 #endif
 
@@ -0,0 +1,115 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2015-     Parresia Research Limited, New Zealand
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <Core/Grid/ParticleInterpolationCache.h>
+#include <Core/Grid/BSplineInterpolator.h>
+#include <Core/Grid/GIMPInterpolator.h>
+#include <Core/Grid/LinearInterpolator.h>
+#include <Core/Grid/ParticleInterpolatorBatch.h>
+#include <Core/Grid/cpdiInterpolator.h>
+
+#include <typeinfo>
+
+using namespace Uintah;
+
+//______________________________________________________________________
+//  Fill rows through the batch kernels when the run-time interpolator is
+//  exactly InterpolatorT.  Derived interpolators (e.g., axiCpdi) override
+//  the kernels and are not matched.
+template<class InterpolatorT>
+static bool fillBatch(ParticleInterpolator* interpolator,
+                      ParticleSubset::iterator begin,
+                      ParticleSubset::iterator end,
+                      const constParticleVariable<Point>& px,
+                      const constParticleVariable<Matrix3>& psize,
+                      const constParticleVariable<Matrix3>& pDefGrad,
+                      bool withDerivatives,
+                      ParticleInterpolationCache* cache)
+{
+  const int N = InterpolatorT::NUM_NODES;
+  if (typeid(*interpolator) != typeid(InterpolatorT) || cache->numNodes != N) {
+    return false;
+  }
+  if (cache->numParticles == 0) {
+    return true;
+  }
+  InterpolatorT* interp = static_cast<InterpolatorT*>(interpolator);
+  IntVector (*ni)[N] = reinterpret_cast<IntVector (*)[N]>(&cache->ni[0]);
+  double    (*S)[N]  = reinterpret_cast<double (*)[N]>(&cache->S[0]);
+  if (withDerivatives) {
+    Vector (*d_S)[N] = reinterpret_cast<Vector (*)[N]>(&cache->d_S[0]);
+    findCellsAndWeightsAndShapeDerivatives(interp, begin, end, px, psize,
+                                           pDefGrad, ni, S, d_S);
+  } else {
+    findCellsAndWeights(interp, begin, end, px, psize, pDefGrad, ni, S);
+  }
+  return true;
+}
+
+bool
+ParticleInterpolationCache::fill(ParticleInterpolator* interpolator,
+                                 ParticleSubset::iterator begin,
+                                 ParticleSubset::iterator end,
+                                 const constParticleVariable<Point>& px,
+                                 const constParticleVariable<Matrix3>& psize,
+                                 const constParticleVariable<Matrix3>& pDefGrad,
+                                 bool withDerivatives)
+{
+  resize(static_cast<int>(end - begin), interpolator->size(), withDerivatives);
+
+  if (fillBatch<LinearInterpolator>(interpolator, begin, end, px, psize,
+                                    pDefGrad, withDerivatives, this) ||
+      fillBatch<GIMPInterpolator>(interpolator, begin, end, px, psize,
+                                  pDefGrad, withDerivatives, this) ||
+      fillBatch<cpdiInterpolator>(interpolator, begin, end, px, psize,
+                                  pDefGrad, withDerivatives, this) ||
+      fillBatch<BSplineInterpolator>(interpolator, begin, end, px, psize,
+                                     pDefGrad, withDerivatives, this)) {
+    return true;
+  }
+
+  std::vector<IntVector> pni(numNodes);
+  std::vector<double>    pS(numNodes);
+  std::vector<Vector>    pdS(numNodes);
+  int offset = 0;
+  for (auto iter = begin; iter != end; iter++, offset += numNodes) {
+    particleIndex idx = *iter;
+    if (withDerivatives) {
+      interpolator->findCellAndWeightsAndShapeDerivatives(px[idx], pni, pS, pdS,
+                                                          psize[idx],
+                                                          pDefGrad[idx]);
+    } else {
+      interpolator->findCellAndWeights(px[idx], pni, pS, psize[idx],
+                                       pDefGrad[idx]);
+    }
+    for (int k = 0; k < numNodes; k++) {
+      ni[offset+k] = pni[k];
+      S[offset+k]  = pS[k];
+      if (withDerivatives) {
+        d_S[offset+k] = pdS[k];
+      }
+    }
+  }
+  return false;
+}
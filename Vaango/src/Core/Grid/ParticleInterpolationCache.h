@@ -0,0 +1,142 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2015-     Parresia Research Limited, New Zealand
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef UINTAH_CORE_GRID_PARTICLE_INTERPOLATION_CACHE_H
+#define UINTAH_CORE_GRID_PARTICLE_INTERPOLATION_CACHE_H
+
+#include <Core/Geometry/IntVector.h>
+#include <Core/Geometry/Point.h>
+#include <Core/Geometry/Vector.h>
+#include <Core/Grid/Variables/ParticleSubset.h>
+#include <Core/Grid/Variables/ParticleVariable.h>
+#include <Core/Math/Matrix3.h>
+#include <Core/Util/RefCounted.h>
+#include <Core/Util/Handle.h>
+#include <vector>
+
+namespace Uintah {
+
+  class ParticleInterpolator;
+
+  /**
+   *  @struct  ParticleInterpolationCache
+   *  @brief   A reference counted per-patch, per-material store of the node
+   *           indices, shape function weights and shape function gradients
+   *           of every particle in a (ghosted) particle subset.
+   *
+   *  The data are kept in structure-of-arrays form with a fixed stride equal
+   *  to the interpolator size so that particle p, node k lives at
+   *  p*numNodes + k in each array.  Entries are stored in the iteration
+   *  order of the particle subset they were computed from, so consumers
+   *  must iterate an identical subset (same DW, ghost type and count).
+   *
+   *  When the per-timestep cache is disabled, tasks keep a local cache of
+   *  BLOCK_SIZE particles and refill it through fillBlock() while walking
+   *  the subset, so that the batch kernels are used without holding the
+   *  weights of the whole patch.
+   */
+  struct ParticleInterpolationCache : public RefCounted {
+
+    ParticleInterpolationCache()
+      : numParticles(0), numNodes(0), computeTime(0.0)
+    {
+    }
+
+    static const int BLOCK_SIZE = 256;
+
+    void resize(int numPart, int numNode, bool withDerivatives = true)
+    {
+      numParticles = numPart;
+      numNodes     = numNode;
+      ni.resize(numPart*numNode);
+      S.resize(numPart*numNode);
+      if (withDerivatives) {
+        d_S.resize(numPart*numNode);
+      }
+    }
+
+    // Compute the rows of the particles [begin, end) of a subset.  The
+    // allocation-free batch kernels (ParticleInterpolatorBatch.h) are used
+    // when the run-time interpolator is exactly one of the common types;
+    // other interpolators go through the virtual per-particle interface.
+    // Returns true if the batch kernels were used.
+    bool fill(ParticleInterpolator* interpolator,
+              ParticleSubset::iterator begin,
+              ParticleSubset::iterator end,
+              const constParticleVariable<Point>& px,
+              const constParticleVariable<Matrix3>& psize,
+              const constParticleVariable<Matrix3>& pDefGrad,
+              bool withDerivatives);
+
+    // Row of the ip-th particle of pset in a block cache, refilling the
+    // block with the next BLOCK_SIZE particles whenever ip starts one.
+    // The subset must be walked in order from its first particle.
+    int fillBlock(ParticleInterpolator* interpolator,
+                  ParticleSubset* pset, int ip,
+                  const constParticleVariable<Point>& px,
+                  const constParticleVariable<Matrix3>& psize,
+                  const constParticleVariable<Matrix3>& pDefGrad,
+                  bool withDerivatives)
+    {
+      int row = ip % BLOCK_SIZE;
+      if (row == 0) {
+        ParticleSubset::iterator begin = pset->begin() + ip;
+        ParticleSubset::iterator end   = pset->end();
+        if (end - begin > BLOCK_SIZE) {
+          end = begin + BLOCK_SIZE;
+        }
+        fill(interpolator, begin, end, px, psize, pDefGrad, withDerivatives);
+      }
+      return row;
+    }
+
+    inline const IntVector* nodes(int part) const
+    {
+      return &ni[part*numNodes];
+    }
+
+    inline const double* weights(int part) const
+    {
+      return &S[part*numNodes];
+    }
+
+    inline const Vector* gradients(int part) const
+    {
+      return &d_S[part*numNodes];
+    }
+
+    int numParticles;
+    int numNodes;
+    double computeTime;   ///< Wall time spent filling the cache (s)
+
+    std::vector<IntVector> ni;
+    std::vector<double>    S;
+    std::vector<Vector>    d_S;
+  };
+
+  typedef Handle<ParticleInterpolationCache> ParticleInterpolationCacheP;
+
+} // End namespace Uintah
+
+#endif // UINTAH_CORE_GRID_PARTICLE_INTERPOLATION_CACHE_H
@@ -0,0 +1,138 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2015-     Parresia Research Limited, New Zealand
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef UINTAH_CORE_GRID_PARTICLE_INTERPOLATOR_BATCH_H
+#define UINTAH_CORE_GRID_PARTICLE_INTERPOLATOR_BATCH_H
+
+#include <Core/Geometry/IntVector.h>
+#include <Core/Geometry/Point.h>
+#include <Core/Geometry/Vector.h>
+#include <Core/Math/Matrix3.h>
+#include <Core/Grid/Variables/ParticleSubset.h>
+#include <Core/Grid/Variables/ParticleVariable.h>
+
+namespace Uintah {
+
+  /*!
+   *  Allocation-free batch interface to the particle interpolators.
+   *
+   *  InterpolatorT must provide a compile time stencil size NUM_NODES and
+   *  non-virtual findCellAndWeights / findCellAndWeightsAndShapeDerivatives
+   *  overloads that write into raw arrays of that size.  The outputs are
+   *  caller-provided arrays with one fixed-size row per particle of the
+   *  subset range [begin, end), i.e., row ip belongs to the particle at
+   *  begin + ip.  Long subsets can therefore be processed in blocks.
+   *
+   *  The functions are explicitly instantiated next to the kernels
+   *  (LinearInterpolator.cc, GIMPInterpolator.cc, cpdiInterpolator.cc,
+   *  BSplineInterpolator.cc) so that the per-particle kernel is inlined
+   *  into the particle loop.
+   */
+  template<class InterpolatorT>
+  void findCellsAndWeights(InterpolatorT* interpolator,
+                           ParticleSubset::iterator begin,
+                           ParticleSubset::iterator end,
+                           const constParticleVariable<Point>& px,
+                           const constParticleVariable<Matrix3>& psize,
+                           const constParticleVariable<Matrix3>& pDefGrad,
+                           IntVector (*ni)[InterpolatorT::NUM_NODES],
+                           double    (*S)[InterpolatorT::NUM_NODES])
+  {
+    int ip = 0;
+    for (auto iter = begin; iter != end; iter++, ip++) {
+      particleIndex idx = *iter;
+      interpolator->InterpolatorT::findCellAndWeights(px[idx], ni[ip], S[ip],
+                                                      psize[idx], pDefGrad[idx]);
+    }
+  }
+
+  template<class InterpolatorT>
+  void findCellsAndWeightsAndShapeDerivatives(InterpolatorT* interpolator,
+                                              ParticleSubset::iterator begin,
+                                              ParticleSubset::iterator end,
+                                              const constParticleVariable<Point>& px,
+                                              const constParticleVariable<Matrix3>& psize,
+                                              const constParticleVariable<Matrix3>& pDefGrad,
+                                              IntVector (*ni)[InterpolatorT::NUM_NODES],
+                                              double    (*S)[InterpolatorT::NUM_NODES],
+                                              Vector    (*d_S)[InterpolatorT::NUM_NODES])
+  {
+    int ip = 0;
+    for (auto iter = begin; iter != end; iter++, ip++) {
+      particleIndex idx = *iter;
+      interpolator->InterpolatorT::findCellAndWeightsAndShapeDerivatives(px[idx],
+                                                      ni[ip], S[ip], d_S[ip],
+                                                      psize[idx], pDefGrad[idx]);
+    }
+  }
+
+} // End namespace Uintah
+
+/*!
+ *  Declares the explicit instantiations of the batch interface for an
+ *  interpolator.  Used at the end of the interpolator header.
+ */
+#define UINTAH_EXTERN_INTERPOLATOR_BATCH(InterpolatorT)                       \
+  namespace Uintah {                                                          \
+  extern template void findCellsAndWeights<InterpolatorT>(                    \
+      InterpolatorT*, ParticleSubset::iterator, ParticleSubset::iterator,     \
+      const constParticleVariable<Point>&,                                    \
+      const constParticleVariable<Matrix3>&,                                  \
+      const constParticleVariable<Matrix3>&,                                  \
+      IntVector (*)[InterpolatorT::NUM_NODES],                                \
+      double    (*)[InterpolatorT::NUM_NODES]);                               \
+  extern template void findCellsAndWeightsAndShapeDerivatives<InterpolatorT>( \
+      InterpolatorT*, ParticleSubset::iterator, ParticleSubset::iterator,     \
+      const constParticleVariable<Point>&,                                    \
+      const constParticleVariable<Matrix3>&,                                  \
+      const constParticleVariable<Matrix3>&,                                  \
+      IntVector (*)[InterpolatorT::NUM_NODES],                                \
+      double    (*)[InterpolatorT::NUM_NODES],                                \
+      Vector    (*)[InterpolatorT::NUM_NODES]);                               \
+  }
+
+/*!
+ *  Defines the explicit instantiations of the batch interface.  Used in
+ *  the interpolator source file after the kernels have been defined.
+ */
+#define UINTAH_INSTANTIATE_INTERPOLATOR_BATCH(InterpolatorT)                  \
+  namespace Uintah {                                                          \
+  template void findCellsAndWeights<InterpolatorT>(                           \
+      InterpolatorT*, ParticleSubset::iterator, ParticleSubset::iterator,     \
+      const constParticleVariable<Point>&,                                    \
+      const constParticleVariable<Matrix3>&,                                  \
+      const constParticleVariable<Matrix3>&,                                  \
+      IntVector (*)[InterpolatorT::NUM_NODES],                                \
+      double    (*)[InterpolatorT::NUM_NODES]);                               \
+  template void findCellsAndWeightsAndShapeDerivatives<InterpolatorT>(        \
+      InterpolatorT*, ParticleSubset::iterator, ParticleSubset::iterator,     \
+      const constParticleVariable<Point>&,                                    \
+      const constParticleVariable<Matrix3>&,                                  \
+      const constParticleVariable<Matrix3>&,                                  \
+      IntVector (*)[InterpolatorT::NUM_NODES],                                \
+      double    (*)[InterpolatorT::NUM_NODES],                                \
+      Vector    (*)[InterpolatorT::NUM_NODES]);                               \
+  }
+
+#endif // UINTAH_CORE_GRID_PARTICLE_INTERPOLATOR_BATCH_H
@@ -31,6 +31,9 @@
 #include <Core/Util/Assert.h>
 #include <Core/Util/FancyAssert.h>
 #include <Core/Malloc/Allocator.h>
+#include <Core/Grid/Variables/Array3DataPool.h>
+
+#include <new>
 
 namespace Uintah {
 
@@ -104,9 +107,15 @@ namespace Uintah {
       }
 
     private:
+      // Bytes of the data (padded for the pointer tables that follow it)
+      // and of the whole block
+      std::size_t dataBytes() const;
+      std::size_t blockSize() const;
+
       T*    d_data;
       T***  d_data3;
       IntVector d_size;
+      bool  d_pooled;   // the block came from Array3DataPool
 
       Array3Data& operator=(const Array3Data&);
       Array3Data(const Array3Data&);
@@ -184,15 +193,38 @@ namespace Uintah {
       }
     }
 
+  template<class T>
+    std::size_t Array3Data<T>::dataBytes() const
+    {
+      std::size_t s=(std::size_t)d_size.x()*d_size.y()*d_size.z();
+      return ((s*sizeof(T)+sizeof(void*)-1)/sizeof(void*))*sizeof(void*);
+    }
+
+  template<class T>
+    std::size_t Array3Data<T>::blockSize() const
+    {
+      return dataBytes()+(d_size.z()+(std::size_t)d_size.z()*d_size.y())*sizeof(void*);
+    }
+
+  // The data and the pointer tables share one block.  When Array3DataPool
+  // is enabled it provides the block and recycles it after the variable is
+  // deleted; otherwise the block comes straight from new.
+  // The elements are default-initialized like with new T[s].
   template<class T>
     Array3Data<T>::Array3Data(const IntVector& size)
-    : d_size(size)
+    : d_size(size), d_pooled(Array3DataPool::isEnabled())
     {
       long s=d_size.x()*d_size.y()*d_size.z();
       if(s){
-        d_data=new T[s];
-        d_data3=new T**[d_size.z()];
-        d_data3[0]=new T*[d_size.z()*d_size.y()];
+        char* block=static_cast<char*>(d_pooled ?
+                                       Array3DataPool::allocate(blockSize()) :
+                                       ::operator new(blockSize()));
+        d_data=reinterpret_cast<T*>(block);
+        for(long i=0;i<s;i++){
+          new (d_data+i) T;
+        }
+        d_data3=reinterpret_cast<T***>(block+dataBytes());
+        d_data3[0]=reinterpret_cast<T**>(d_data3+d_size.z());
         d_data3[0][0]=d_data;
         for(int i=1;i<d_size.z();i++){
           d_data3[i]=d_data3[i-1]+d_size.y();
@@ -210,11 +242,16 @@ namespace Uintah {
     Array3Data<T>::~Array3Data()
     {
       if(d_data){
-        delete[] d_data;
+        long s=d_size.x()*d_size.y()*d_size.z();
+        for(long i=0;i<s;i++){
+          d_data[i].~T();
+        }
+        if(d_pooled){
+          Array3DataPool::release(d_data, blockSize());
+        } else {
+          ::operator delete(d_data);
+        }
         d_data=0;
-        delete[] d_data3[0];
-        d_data3[0]=0;
-        delete[] d_data3;
         d_data3=0;
       }
     }
@@ -0,0 +1,230 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2015-     Parresia Research Limited, New Zealand
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <Core/Grid/Variables/Array3DataPool.h>
+#include <Core/Thread/Mutex.h>
+#include <Core/Thread/Thread.h>
+
+#include <atomic>
+#include <map>
+#include <new>
+#include <vector>
+
+using namespace Uintah;
+
+bool Array3DataPool::s_enabled = false;
+
+namespace {
+
+  // Every block starts with a header holding the id of its owner thread.
+  // Its size keeps the data aligned like the memory returned by new.
+  const std::size_t HEADER_SIZE = 64;
+  const std::size_t PAGE_SIZE = 4096;
+  const int NUM_FREE_LISTS = 64;
+
+  struct FreeList {
+    FreeList() : lock("Array3DataPool free list") {}
+    Mutex lock;
+    std::map<std::size_t, std::vector<char*> > blocks;  // size class -> blocks
+  };
+
+  struct PoolData {
+    PoolData()
+      : hits(0),
+        misses(0),
+        numCached(0),
+        cachedBytes(0),
+        maxCachedBytes(0),
+        totalBytes(0),
+        peakBytes(0)
+    {
+    }
+
+    FreeList lists[NUM_FREE_LISTS];
+    std::atomic<long long> hits;
+    std::atomic<long long> misses;
+    std::atomic<long long> numCached;
+    std::atomic<std::size_t> cachedBytes;
+    std::size_t maxCachedBytes;
+    std::atomic<std::size_t> totalBytes;
+    std::atomic<std::size_t> peakBytes;
+  };
+
+  PoolData& poolData()
+  {
+    static PoolData* data = new PoolData();
+    return *data;
+  }
+
+  int currentThread()
+  {
+    Thread* self = Thread::self();
+    return self ? self->myid() : 0;
+  }
+
+  // Round up to the next size class (8 classes per power of two)
+  std::size_t sizeClass(std::size_t numBytes)
+  {
+    std::size_t bytes = numBytes + HEADER_SIZE;
+    std::size_t top = 64;
+    while (top < bytes) {
+      top <<= 1;
+    }
+    std::size_t step = (top >= 512) ? top / 16 : 32;
+    return ((bytes + step - 1) / step) * step;
+  }
+
+  char* popBlock(FreeList& list, std::size_t blockSize)
+  {
+    char* block = 0;
+    list.lock.lock();
+    std::map<std::size_t, std::vector<char*> >::iterator iter = list.blocks.find(blockSize);
+    if (iter != list.blocks.end() && !iter->second.empty()) {
+      block = iter->second.back();
+      iter->second.pop_back();
+    }
+    list.lock.unlock();
+    return block;
+  }
+
+  void freeBlock(PoolData& pool, char* block, std::size_t blockSize)
+  {
+    ::operator delete(block);
+    pool.totalBytes -= blockSize;
+  }
+
+} // end anonymous namespace
+
+void
+Array3DataPool::setEnabled(bool enabled)
+{
+  s_enabled = enabled;
+  if (!enabled) {
+    trim();
+  }
+}
+
+void
+Array3DataPool::setMaxCachedBytes(std::size_t maxBytes)
+{
+  poolData().maxCachedBytes = maxBytes;
+}
+
+void*
+Array3DataPool::allocate(std::size_t numBytes)
+{
+  PoolData& pool = poolData();
+  std::size_t blockSize = sizeClass(numBytes);
+  int me = currentThread();
+
+  // own free list first, then the others
+  char* block = 0;
+  for (int k = 0; k < NUM_FREE_LISTS && block == 0; k++) {
+    block = popBlock(pool.lists[(me + k) % NUM_FREE_LISTS], blockSize);
+  }
+
+  if (block) {
+    pool.hits++;
+    pool.numCached--;
+    pool.cachedBytes -= blockSize;
+    return block + HEADER_SIZE;
+  }
+
+  block = static_cast<char*>(::operator new(blockSize));
+  *reinterpret_cast<int*>(block) = me;
+  pool.misses++;
+
+  // First touch by this thread places the pages on its NUMA node
+  for (std::size_t i = HEADER_SIZE; i < blockSize; i += PAGE_SIZE) {
+    block[i] = 0;
+  }
+
+  std::size_t total = (pool.totalBytes += blockSize);
+  std::size_t peak = pool.peakBytes;
+  while (total > peak && !pool.peakBytes.compare_exchange_weak(peak, total)) {
+  }
+
+  return block + HEADER_SIZE;
+}
+
+void
+Array3DataPool::release(void* ptr, std::size_t numBytes)
+{
+  if (ptr == 0) {
+    return;
+  }
+  PoolData& pool = poolData();
+  char* block = static_cast<char*>(ptr) - HEADER_SIZE;
+  std::size_t blockSize = sizeClass(numBytes);
+
+  if (!s_enabled ||
+      (pool.maxCachedBytes > 0 && pool.cachedBytes + blockSize > pool.maxCachedBytes)) {
+    freeBlock(pool, block, blockSize);
+    return;
+  }
+
+  int owner = *reinterpret_cast<int*>(block);
+  FreeList& list = pool.lists[owner % NUM_FREE_LISTS];
+  list.lock.lock();
+  list.blocks[blockSize].push_back(block);
+  list.lock.unlock();
+  pool.numCached++;
+  pool.cachedBytes += blockSize;
+}
+
+void
+Array3DataPool::trim()
+{
+  PoolData& pool = poolData();
+  for (int l = 0; l < NUM_FREE_LISTS; l++) {
+    FreeList& list = pool.lists[l];
+    list.lock.lock();
+    std::map<std::size_t, std::vector<char*> > blocks;
+    blocks.swap(list.blocks);
+    list.lock.unlock();
+
+    std::map<std::size_t, std::vector<char*> >::iterator iter;
+    for (iter = blocks.begin(); iter != blocks.end(); iter++) {
+      for (unsigned int b = 0; b < iter->second.size(); b++) {
+        freeBlock(pool, iter->second[b], iter->first);
+        pool.numCached--;
+        pool.cachedBytes -= iter->first;
+      }
+    }
+  }
+}
+
+Array3DataPool::Stats
+Array3DataPool::getStats()
+{
+  PoolData& pool = poolData();
+  Stats stats;
+  stats.hits = pool.hits;
+  stats.misses = pool.misses;
+  stats.numCached = pool.numCached;
+  stats.totalBytes = pool.totalBytes;
+  stats.peakBytes = pool.peakBytes;
+  stats.cachedBytes = pool.cachedBytes;
+  return stats;
+}
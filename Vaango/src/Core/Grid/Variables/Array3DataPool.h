@@ -0,0 +1,94 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2015-     Parresia Research Limited, New Zealand
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef __VAANGO_ARRAY3_DATA_POOL_H__
+#define __VAANGO_ARRAY3_DATA_POOL_H__
+
+#include <cstddef>
+
+namespace Uintah {
+
+  /**
+   *  @class  Array3DataPool
+   *  @brief  Recycles the memory blocks of Array3Data (grid variables)
+   *
+   *  A grid variable of the new DataWarehouse usually has the same type and
+   *  extent as the one it replaces in the old DataWarehouse.  When the pool
+   *  is enabled, the block of a deleted Array3Data (data plus pointer
+   *  tables) is kept in a free list and handed to the next Array3Data of the
+   *  same size class instead of going back to malloc.  Size classes are
+   *  1/8 of a power of two apart, so a block is at most 12.5% larger than
+   *  requested.
+   *
+   *  Blocks are owned by the thread that allocated them, which is also the
+   *  thread that first touches the pages (NUMA placement).  A freed block
+   *  goes back to the free list of its owner, and a thread looks in its own
+   *  free list before taking a block owned by another thread.
+   *
+   *  The pool is disabled by default (<Scheduler><gridVariablePool>).  While
+   *  it is disabled, Array3Data does not call it at all.
+   */
+  class Array3DataPool {
+
+  public:
+
+    struct Stats {
+      long long hits;            // allocations served from a free list
+      long long misses;          // allocations that needed a new block
+      long long numCached;       // blocks in the free lists
+      std::size_t cachedBytes;   // bytes in the free lists
+      std::size_t totalBytes;    // bytes of all the pool's blocks (in use and cached)
+      std::size_t peakBytes;     // peak of totalBytes
+    };
+
+    static void setEnabled(bool enabled);
+    static bool isEnabled() { return s_enabled; }
+
+    // Blocks freed while more than maxBytes are cached go back to the system
+    // (0 = no limit)
+    static void setMaxCachedBytes(std::size_t maxBytes);
+
+    // Returns a block of at least numBytes bytes, aligned for any type.
+    // Only called while the pool is enabled.
+    static void* allocate(std::size_t numBytes);
+
+    // Gives back a block returned by allocate(numBytes)
+    static void release(void* block, std::size_t numBytes);
+
+    // Frees all the cached blocks (e.g. after a regrid, when the old
+    // extents will not be used again)
+    static void trim();
+
+    static Stats getStats();
+
+  private:
+
+    static bool s_enabled;
+
+    Array3DataPool();
+  };
+
+} // End namespace Uintah
+
+#endif // __VAANGO_ARRAY3_DATA_POOL_H__
@@ -0,0 +1,625 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2015-     Parresia Research Limited, New Zealand
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef __VAANGO_PARTICLE_FAMILY_VARIABLE_H__
+#define __VAANGO_PARTICLE_FAMILY_VARIABLE_H__
+
+#include <Core/Util/FancyAssert.h>
+#include <Core/Exceptions/InternalError.h>
+#include <Core/Exceptions/TypeMismatchException.h>
+#include <Core/Util/Assert.h>
+#include <Core/Util/Endian.h>
+#include <Core/Util/RefCounted.h>
+#include <Core/Malloc/Allocator.h>
+#include <Core/Grid/Variables/ParticleVariableBase.h>
+#include <Core/Grid/Variables/ParticleSubset.h>
+#include <Core/Grid/Variables/constVariable.h>
+#include <Core/Parallel/ProcessorGroup.h>
+#include <Core/Disclosure/TypeDescription.h>
+#include <Core/Disclosure/TypeUtils.h>
+#include <Core/ProblemSpec/ProblemSpec.h>
+
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace Uintah {
+
+  /**
+   *  @class  ParticleFamilyData
+   *  @brief  Compressed row storage of a variable length list of values
+   *          per particle.
+   *
+   *  The values of particle idx are data[offsets[idx]] ... data[offsets[idx+1]-1].
+   */
+  template<class T>
+  class ParticleFamilyData : public RefCounted {
+  public:
+    ParticleFamilyData(int numParticles = 0)
+      : offsets(numParticles+1, 0)
+    {
+    }
+
+    int numRows() const { return (int) offsets.size() - 1; }
+
+    std::vector<int> offsets;
+    std::vector<T>   data;
+  };
+
+  /**
+   *  @class  ParticleFamilyVariable
+   *  @brief  A particle variable that stores a variable length family of
+   *          values (e.g., peridynamic bonds) per particle in CSR form.
+   *
+   *  Storage is proportional to the actual number of family members instead
+   *  of a fixed maximum.  The variable is relocated with the other particle
+   *  state: gather() merges the rows of the source patches and
+   *  packMPI()/unpackMPI() send the row lengths followed by the packed rows.
+   *
+   *  Family variables are not exchanged as ghosts; tasks must require them
+   *  with Ghost::None.
+   */
+  template<class T>
+  class ParticleFamilyVariable : public ParticleVariableBase {
+    friend class constVariable<ParticleVariableBase, ParticleFamilyVariable<T>, T, particleIndex>;
+
+  public:
+    ParticleFamilyVariable();
+    ParticleFamilyVariable(ParticleSubset* pset);
+    ParticleFamilyVariable(ParticleFamilyData<T>*, ParticleSubset* pset);
+    virtual ~ParticleFamilyVariable();
+
+    static const TypeDescription* getTypeDescription();
+
+    virtual ParticleVariableBase* clone();
+    virtual const ParticleVariableBase* clone() const;
+    virtual ParticleVariableBase* cloneSubset(ParticleSubset*);
+    virtual const ParticleVariableBase* cloneSubset(ParticleSubset*) const;
+
+    virtual ParticleVariableBase* cloneType() const
+    { return scinew ParticleFamilyVariable<T>(); }
+    virtual constParticleVariableBase* cloneConstType() const
+    { return scinew constVariable<ParticleVariableBase, ParticleFamilyVariable<T>, T, particleIndex>(); }
+
+    void copyData(const ParticleFamilyVariable<T>& src);
+    virtual void copyData(const ParticleVariableBase* src)
+    { copyData(castFromBase(src)); }
+
+    /** Number of family members of particle idx */
+    inline int familySize(particleIndex idx) const {
+      ASSERTRANGE(idx, 0, d_fdata->numRows());
+      return d_fdata->offsets[idx+1] - d_fdata->offsets[idx];
+    }
+
+    /** Pointer to the first family member of particle idx */
+    inline T* family(particleIndex idx) {
+      ASSERTRANGE(idx, 0, d_fdata->numRows());
+      return d_fdata->data.data() + d_fdata->offsets[idx];
+    }
+    inline const T* family(particleIndex idx) const {
+      ASSERTRANGE(idx, 0, d_fdata->numRows());
+      return d_fdata->data.data() + d_fdata->offsets[idx];
+    }
+
+    inline T& operator()(particleIndex idx, int member) {
+      ASSERTRANGE(member, 0, familySize(idx));
+      return d_fdata->data[d_fdata->offsets[idx] + member];
+    }
+    inline const T& operator()(particleIndex idx, int member) const {
+      ASSERTRANGE(member, 0, familySize(idx));
+      return d_fdata->data[d_fdata->offsets[idx] + member];
+    }
+
+    /** Row offsets (numParticles+1 entries) */
+    const std::vector<int>& getOffsets() const { return d_fdata->offsets; }
+
+    /** Total number of family members of all particles */
+    int totalFamilySize() const { return d_fdata->offsets.back(); }
+
+    /**
+     *  Set the family sizes of all the particles and initialize every
+     *  member to value.  sizes is indexed by particle index.  The storage is
+     *  changed in place so this may be called after allocateAndPut.
+     */
+    void setFamilySizes(const std::vector<int>& sizes, const T& value);
+
+    /**
+     *  Use the row structure of another family variable (given by its
+     *  offsets) and initialize every member to value.
+     */
+    void copyStructure(const std::vector<int>& offsets, const T& value);
+
+    virtual void copyPointer(ParticleFamilyVariable<T>&);
+    virtual void copyPointer(Variable&);
+    virtual void allocate(ParticleSubset*);
+    virtual void allocate(int totalParticles);
+    virtual void allocate(const Patch*, const IntVector& /*boundary*/)
+    { SCI_THROW(InternalError("Should not call ParticleFamilyVariable<T>::allocate(const Patch*), use allocate(ParticleSubset*) instead.", __FILE__, __LINE__)); }
+
+    virtual int size() { return d_fdata->numRows(); }
+
+    virtual void gather(ParticleSubset* dest,
+                        const std::vector<ParticleSubset*> &subsets,
+                        const std::vector<ParticleVariableBase*> &srcs,
+                        particleIndex extra = 0);
+    virtual void gather(ParticleSubset* dest,
+                        const std::vector<ParticleSubset*> &subsets,
+                        const std::vector<ParticleVariableBase*> &srcs,
+                        const std::vector<const Patch*>& /*srcPatches*/,
+                        particleIndex extra = 0)
+    { gather(dest, subsets, srcs, extra); }
+
+    virtual void unpackMPI(void* buf, int bufsize, int* bufpos,
+                           const ProcessorGroup* pg,
+                           ParticleSubset* pset);
+    virtual void packMPI(void* buf, int bufsize, int* bufpos,
+                         const ProcessorGroup* pg,
+                         ParticleSubset* pset);
+    virtual void packMPI(void* buf, int bufsize, int* bufpos,
+                         const ProcessorGroup* pg,
+                         ParticleSubset* pset, const Patch* /*forPatch*/)
+    { packMPI(buf, bufsize, bufpos, pg, pset); }
+    virtual void packsizeMPI(int* bufpos,
+                             const ProcessorGroup* pg,
+                             ParticleSubset* pset);
+
+    virtual void getMPIBuffer(BufferInfo& buffer, ParticleSubset* sendset)
+    { SCI_THROW(InternalError("Particle family variables cannot be exchanged as ghosts; require them with Ghost::None.", __FILE__, __LINE__)); }
+
+    virtual void emitNormal(std::ostream& out, const IntVector& l,
+                            const IntVector& h, ProblemSpecP varnode, bool outputDoubleAsFloat);
+    virtual void readNormal(std::istream& in, bool swapBytes);
+
+    virtual void* getBasePointer() const
+    { return (void*) d_fdata->data.data(); }
+    virtual const TypeDescription* virtualGetTypeDescription() const
+    { return getTypeDescription(); }
+    virtual RefCounted* getRefCounted()
+    { return d_fdata; }
+    virtual void getSizeInfo(std::string& elems, unsigned long& totsize,
+                             void*& ptr) const {
+      std::ostringstream str;
+      str << getParticleSubset()->numParticles();
+      elems = str.str();
+      totsize = getDataSize();
+      ptr = getBasePointer();
+    }
+
+    virtual size_t getDataSize() const {
+      return d_fdata->offsets.size()*sizeof(int) + d_fdata->data.size()*sizeof(T);
+    }
+
+    virtual bool copyOut(void* dst) const {
+      size_t offsetBytes = d_fdata->offsets.size()*sizeof(int);
+      std::memcpy(dst, d_fdata->offsets.data(), offsetBytes);
+      std::memcpy((char*) dst + offsetBytes, d_fdata->data.data(),
+                  d_fdata->data.size()*sizeof(T));
+      return true;
+    }
+
+  protected:
+    static TypeDescription* td;
+    ParticleFamilyVariable(const ParticleFamilyVariable<T>&);
+    ParticleFamilyVariable<T>& operator=(const ParticleFamilyVariable<T>&);
+
+  private:
+    ParticleFamilyData<T>* d_fdata;
+
+    static const ParticleFamilyVariable<T>& castFromBase(const ParticleVariableBase* srcptr);
+    static TypeDescription::Register registerMe;
+    static Variable* maker();
+  };
+
+  template<class T>
+  TypeDescription* ParticleFamilyVariable<T>::td = 0;
+
+  template<class T>
+  TypeDescription::Register ParticleFamilyVariable<T>::registerMe(getTypeDescription());
+
+  template<class T>
+  const TypeDescription*
+  ParticleFamilyVariable<T>::getTypeDescription()
+  {
+    if (!td) {
+      td = scinew TypeDescription(TypeDescription::ParticleVariable,
+                                  "ParticleFamilyVariable", &maker,
+                                  fun_getTypeDescription((T*)0));
+    }
+    return td;
+  }
+
+  template<class T>
+  Variable*
+  ParticleFamilyVariable<T>::maker()
+  {
+    return scinew ParticleFamilyVariable<T>();
+  }
+
+  template<class T>
+  ParticleFamilyVariable<T>::ParticleFamilyVariable()
+    : ParticleVariableBase(0), d_fdata(0)
+  {
+  }
+
+  template<class T>
+  ParticleFamilyVariable<T>::ParticleFamilyVariable(ParticleSubset* pset)
+    : ParticleVariableBase(pset)
+  {
+    d_fdata = scinew ParticleFamilyData<T>(pset->numParticles());
+    d_fdata->addReference();
+  }
+
+  template<class T>
+  ParticleFamilyVariable<T>::ParticleFamilyVariable(ParticleFamilyData<T>* fdata,
+                                                    ParticleSubset* pset)
+    : ParticleVariableBase(pset), d_fdata(fdata)
+  {
+    if (d_fdata) {
+      d_fdata->addReference();
+    }
+  }
+
+  template<class T>
+  ParticleFamilyVariable<T>::ParticleFamilyVariable(const ParticleFamilyVariable<T>& copy)
+    : ParticleVariableBase(copy), d_fdata(copy.d_fdata)
+  {
+    if (d_fdata) {
+      d_fdata->addReference();
+    }
+  }
+
+  template<class T>
+  ParticleFamilyVariable<T>::~ParticleFamilyVariable()
+  {
+    if (d_fdata && d_fdata->removeReference()) {
+      delete d_fdata;
+    }
+  }
+
+  template<class T>
+  ParticleVariableBase*
+  ParticleFamilyVariable<T>::clone()
+  { return scinew ParticleFamilyVariable<T>(*this); }
+
+  template<class T>
+  const ParticleVariableBase*
+  ParticleFamilyVariable<T>::clone() const
+  { return scinew ParticleFamilyVariable<T>(*this); }
+
+  template<class T>
+  ParticleVariableBase*
+  ParticleFamilyVariable<T>::cloneSubset(ParticleSubset* pset)
+  { return scinew ParticleFamilyVariable<T>(d_fdata, pset); }
+
+  template<class T>
+  const ParticleVariableBase*
+  ParticleFamilyVariable<T>::cloneSubset(ParticleSubset* pset) const
+  { return scinew ParticleFamilyVariable<T>(d_fdata, pset); }
+
+  template<class T>
+  const ParticleFamilyVariable<T>&
+  ParticleFamilyVariable<T>::castFromBase(const ParticleVariableBase* srcptr)
+  {
+    const ParticleFamilyVariable<T>* c = dynamic_cast<const ParticleFamilyVariable<T>* >(srcptr);
+    if (!c) {
+      SCI_THROW(TypeMismatchException("Type mismatch in particle family variable", __FILE__, __LINE__));
+    }
+    return *c;
+  }
+
+  template<class T>
+  void
+  ParticleFamilyVariable<T>::copyData(const ParticleFamilyVariable<T>& src)
+  {
+    ASSERT(*d_pset == *src.d_pset);
+    d_fdata->offsets = src.d_fdata->offsets;
+    d_fdata->data = src.d_fdata->data;
+  }
+
+  template<class T>
+  void
+  ParticleFamilyVariable<T>::setFamilySizes(const std::vector<int>& sizes,
+                                            const T& value)
+  {
+    int numRows = d_fdata->numRows();
+    ASSERTEQ((int) sizes.size(), numRows);
+    for (int ii = 0; ii < numRows; ii++) {
+      d_fdata->offsets[ii+1] = d_fdata->offsets[ii] + sizes[ii];
+    }
+    d_fdata->data.assign(d_fdata->offsets[numRows], value);
+  }
+
+  template<class T>
+  void
+  ParticleFamilyVariable<T>::copyStructure(const std::vector<int>& offsets,
+                                           const T& value)
+  {
+    ASSERTEQ((int) offsets.size(), d_fdata->numRows() + 1);
+    d_fdata->offsets = offsets;
+    d_fdata->data.assign(offsets.back(), value);
+  }
+
+  template<class T>
+  void
+  ParticleFamilyVariable<T>::copyPointer(ParticleFamilyVariable<T>& copy)
+  {
+    if (this != &copy) {
+      ParticleVariableBase::operator=(copy);
+      if (d_fdata && d_fdata->removeReference()) {
+        delete d_fdata;
+      }
+      d_fdata = copy.d_fdata;
+      if (d_fdata) {
+        d_fdata->addReference();
+      }
+    }
+  }
+
+  template<class T>
+  void
+  ParticleFamilyVariable<T>::copyPointer(Variable& copy)
+  {
+    ParticleFamilyVariable<T>* c = dynamic_cast<ParticleFamilyVariable<T>* >(&copy);
+    if (!c) {
+      SCI_THROW(TypeMismatchException("Type mismatch in particle family variable", __FILE__, __LINE__));
+    }
+    copyPointer(*c);
+  }
+
+  template<class T>
+  void
+  ParticleFamilyVariable<T>::allocate(int totalParticles)
+  {
+    ASSERT(isForeign());
+    ASSERT(d_pset == 0);
+    d_fdata = scinew ParticleFamilyData<T>(totalParticles);
+    d_fdata->addReference();
+  }
+
+  template<class T>
+  void
+  ParticleFamilyVariable<T>::allocate(ParticleSubset* pset)
+  {
+    if (d_fdata && d_fdata->removeReference()) {
+      delete d_fdata;
+    }
+    if (d_pset && d_pset->removeReference()) {
+      delete d_pset;
+    }
+
+    d_pset = pset;
+    d_pset->addReference();
+    d_fdata = scinew ParticleFamilyData<T>(pset->numParticles());
+    d_fdata->addReference();
+  }
+
+  //  The gathered particles fill the leading rows of the destination.  The
+  //  remaining "extra" rows (particles received from other processors
+  //  during relocation) are appended in order by unpackMPI.
+  template<class T>
+  void
+  ParticleFamilyVariable<T>::gather(ParticleSubset* pset,
+                                    const std::vector<ParticleSubset*> &subsets,
+                                    const std::vector<ParticleVariableBase*> &srcs,
+                                    particleIndex extra)
+  {
+    if (d_fdata && d_fdata->removeReference()) {
+      delete d_fdata;
+    }
+    if (d_pset && d_pset->removeReference()) {
+      delete d_pset;
+    }
+    d_pset = pset;
+    pset->addReference();
+    d_fdata = scinew ParticleFamilyData<T>(0);
+    d_fdata->addReference();
+    ASSERTEQ(subsets.size(), srcs.size());
+
+    // Count first so that the data are allocated only once
+    int numGathered = 0;
+    int numMembers = 0;
+    for (int i = 0; i < (int) subsets.size(); i++) {
+      const ParticleFamilyVariable<T>& src = castFromBase(srcs[i]);
+      ParticleSubset* subset = subsets[i];
+      for (ParticleSubset::iterator iter = subset->begin(); iter != subset->end(); iter++) {
+        numMembers += src.familySize(*iter);
+      }
+      numGathered += subset->numParticles();
+    }
+    ASSERTEQ(numGathered + extra, pset->numParticles());
+
+    d_fdata->offsets.reserve(pset->numParticles() + 1);
+    d_fdata->data.reserve(numMembers);
+    for (int i = 0; i < (int) subsets.size(); i++) {
+      const ParticleFamilyVariable<T>& src = castFromBase(srcs[i]);
+      ParticleSubset* subset = subsets[i];
+      for (ParticleSubset::iterator iter = subset->begin(); iter != subset->end(); iter++) {
+        const T* row = src.family(*iter);
+        d_fdata->data.insert(d_fdata->data.end(), row, row + src.familySize(*iter));
+        d_fdata->offsets.push_back((int) d_fdata->data.size());
+      }
+    }
+  }
+
+  template<class T>
+  void
+  ParticleFamilyVariable<T>::packsizeMPI(int* bufpos,
+                                         const ProcessorGroup* pg,
+                                         ParticleSubset* pset)
+  {
+    const TypeDescription* td = fun_getTypeDescription((T*)0);
+    int numMembers = 0;
+    for (ParticleSubset::iterator iter = pset->begin(); iter != pset->end(); iter++) {
+      numMembers += familySize(*iter);
+    }
+    int size;
+    MPI_Pack_size(pset->numParticles(), MPI_INT, pg->getComm(), &size);
+    (*bufpos) += size;
+    MPI_Pack_size(numMembers, td->getMPIType(), pg->getComm(), &size);
+    (*bufpos) += size;
+  }
+
+  template<class T>
+  void
+  ParticleFamilyVariable<T>::packMPI(void* buf, int bufsize, int* bufpos,
+                                     const ProcessorGroup* pg,
+                                     ParticleSubset* pset)
+  {
+    const TypeDescription* td = fun_getTypeDescription((T*)0);
+
+    // Family sizes first, then the packed rows
+    std::vector<int> sizes;
+    sizes.reserve(pset->numParticles());
+    std::vector<T> members;
+    for (ParticleSubset::iterator iter = pset->begin(); iter != pset->end(); iter++) {
+      int count = familySize(*iter);
+      sizes.push_back(count);
+      const T* row = family(*iter);
+      members.insert(members.end(), row, row + count);
+    }
+    if (!sizes.empty()) {
+      MPI_Pack(&sizes[0], (int) sizes.size(), MPI_INT, buf, bufsize, bufpos, pg->getComm());
+    }
+    if (!members.empty()) {
+      MPI_Pack(&members[0], (int) members.size(), td->getMPIType(),
+               buf, bufsize, bufpos, pg->getComm());
+    }
+  }
+
+  template<class T>
+  void
+  ParticleFamilyVariable<T>::unpackMPI(void* buf, int bufsize, int* bufpos,
+                                       const ProcessorGroup* pg,
+                                       ParticleSubset* pset)
+  {
+    const TypeDescription* td = fun_getTypeDescription((T*)0);
+
+    int numParticles = pset->numParticles();
+    if (numParticles == 0) {
+      return;
+    }
+    std::vector<int> sizes(numParticles);
+    MPI_Unpack(buf, bufsize, bufpos, &sizes[0], numParticles, MPI_INT, pg->getComm());
+
+    // The received particles are appended after the rows already present
+    int numMembers = 0;
+    int ii = 0;
+    for (ParticleSubset::iterator iter = pset->begin(); iter != pset->end(); iter++, ii++) {
+      if (*iter != d_fdata->numRows()) {
+        SCI_THROW(InternalError("ParticleFamilyVariable::unpackMPI can only append particles", __FILE__, __LINE__));
+      }
+      numMembers += sizes[ii];
+      d_fdata->offsets.push_back(d_fdata->offsets.back() + sizes[ii]);
+    }
+
+    int start = (int) d_fdata->data.size();
+    d_fdata->data.resize(start + numMembers);
+    if (numMembers > 0) {
+      MPI_Unpack(buf, bufsize, bufpos, &d_fdata->data[start], numMembers,
+                 td->getMPIType(), pg->getComm());
+    }
+  }
+
+  //  Written as the family sizes of the particles in the subset followed by
+  //  the packed family members.
+  template<class T>
+  void
+  ParticleFamilyVariable<T>::emitNormal(std::ostream& out, const IntVector&,
+                                        const IntVector&, ProblemSpecP varnode,
+                                        bool /*outputDoubleAsFloat*/)
+  {
+    if (varnode->findBlock("numParticles") == 0) {
+      varnode->appendElement("numParticles", d_pset->numParticles());
+    }
+    for (ParticleSubset::iterator iter = d_pset->begin(); iter != d_pset->end(); iter++) {
+      int count = familySize(*iter);
+      out.write((char*) &count, sizeof(int));
+    }
+    for (ParticleSubset::iterator iter = d_pset->begin(); iter != d_pset->end(); iter++) {
+      out.write((char*) family(*iter), (ssize_t) (sizeof(T)*familySize(*iter)));
+    }
+  }
+
+  template<class T>
+  void
+  ParticleFamilyVariable<T>::readNormal(std::istream& in, bool swapBytes)
+  {
+    int numParticles = d_pset->numParticles();
+    std::vector<int> sizes(d_fdata->numRows(), 0);
+    for (ParticleSubset::iterator iter = d_pset->begin(); iter != d_pset->end(); iter++) {
+      int count;
+      in.read((char*) &count, sizeof(int));
+      if (swapBytes) {
+        Uintah::swapbytes(count);
+      }
+      sizes[*iter] = count;
+    }
+    setFamilySizes(sizes, T());
+    if (numParticles == 0) {
+      return;
+    }
+    for (ParticleSubset::iterator iter = d_pset->begin(); iter != d_pset->end(); iter++) {
+      T* row = family(*iter);
+      int count = familySize(*iter);
+      in.read((char*) row, (ssize_t) (sizeof(T)*count));
+      if (swapBytes) {
+        for (int ii = 0; ii < count; ii++) {
+          Uintah::swapbytes(row[ii]);
+        }
+      }
+    }
+  }
+
+  template <class T>
+  class constParticleFamilyVariable
+    : public constVariable<ParticleVariableBase, ParticleFamilyVariable<T>, T, particleIndex>
+  {
+  public:
+    constParticleFamilyVariable()
+      : constVariable<ParticleVariableBase, ParticleFamilyVariable<T>, T, particleIndex>() {}
+
+    constParticleFamilyVariable(const ParticleFamilyVariable<T>& copy)
+      : constVariable<ParticleVariableBase, ParticleFamilyVariable<T>, T, particleIndex>(copy) {}
+
+    ParticleSubset* getParticleSubset() const {
+      return this->rep_.getParticleSubset();
+    }
+
+    inline int familySize(particleIndex idx) const
+    { return this->rep_.familySize(idx); }
+
+    inline const T* family(particleIndex idx) const
+    { return this->rep_.family(idx); }
+
+    inline const T& operator()(particleIndex idx, int member) const
+    { return this->rep_(idx, member); }
+
+    const std::vector<int>& getOffsets() const
+    { return this->rep_.getOffsets(); }
+  };
+
+} // End namespace Uintah
+
+#endif // __VAANGO_PARTICLE_FAMILY_VARIABLE_H__
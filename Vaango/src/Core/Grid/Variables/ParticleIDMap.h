@@ -0,0 +1,153 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2015-     Parresia Research Limited, New Zealand
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef __VAANGO_PARTICLE_ID_MAP_H__
+#define __VAANGO_PARTICLE_ID_MAP_H__
+
+#include <Core/Disclosure/TypeUtils.h>  // Contains long64
+#include <Core/Grid/Variables/ParticleSubset.h>  // Contains particleIndex
+
+#include <vector>
+
+namespace Uintah {
+
+  /**
+   *  @class  ParticleIDMap
+   *  @brief  Map from long64 particle IDs to the index of the particle
+   *          in a ParticleSubset.
+   *
+   *  Open addressing hash table with linear probing.  Keys and values are
+   *  stored in two contiguous arrays whose size is a power of two at least
+   *  twice the number of particles, so that a lookup is usually a single
+   *  probe.  An empty slot is marked by a negative particle index.
+   *
+   *  The map is filled once per subset (see DataWarehouse::createParticleIDMap)
+   *  and is only valid until the particles are relocated.
+   */
+  class ParticleIDMap
+  {
+  public:
+
+    ParticleIDMap()
+      : d_size(0), d_mask(0)
+    {
+    }
+
+    /** Remove all entries and make room for numParticles entries */
+    void reserve(int numParticles)
+    {
+      unsigned int capacity = 16;
+      while (capacity < 2*(unsigned int) numParticles) {
+        capacity <<= 1;
+      }
+      d_keys.assign(capacity, 0);
+      d_values.assign(capacity, -1);
+      d_mask = capacity - 1;
+      d_size = 0;
+    }
+
+    void clear()
+    {
+      d_keys.clear();
+      d_values.clear();
+      d_mask = 0;
+      d_size = 0;
+    }
+
+    bool empty() const { return d_size == 0; }
+    int size() const { return d_size; }
+
+    /** Insert a (particle ID, index) pair.  An existing ID is not replaced. */
+    void insert(long64 pParticleID, particleIndex pParticleIndex)
+    {
+      if (2*(d_size + 1) > (int) d_values.size()) {
+        rehash(d_size + 1);
+      }
+      unsigned int slot = hash(pParticleID) & d_mask;
+      while (d_values[slot] >= 0) {
+        if (d_keys[slot] == pParticleID) {
+          return;
+        }
+        slot = (slot + 1) & d_mask;
+      }
+      d_keys[slot] = pParticleID;
+      d_values[slot] = pParticleIndex;
+      ++d_size;
+    }
+
+    /** Find the index of a particle ID.  Returns false if it is not present. */
+    inline bool find(long64 pParticleID, particleIndex& pParticleIndex) const
+    {
+      if (d_size == 0) {
+        return false;
+      }
+      unsigned int slot = hash(pParticleID) & d_mask;
+      while (d_values[slot] >= 0) {
+        if (d_keys[slot] == pParticleID) {
+          pParticleIndex = d_values[slot];
+          return true;
+        }
+        slot = (slot + 1) & d_mask;
+      }
+      return false;
+    }
+
+  private:
+
+    // Particle IDs are built from the patch ID and a per-patch counter, so
+    // mix all the bits before masking (64-bit finalizer of MurmurHash3)
+    static inline unsigned int hash(long64 key)
+    {
+      unsigned long long k = (unsigned long long) key;
+      k ^= k >> 33;
+      k *= 0xff51afd7ed558ccdULL;
+      k ^= k >> 33;
+      k *= 0xc4ceb9fe1a85ec53ULL;
+      k ^= k >> 33;
+      return (unsigned int) k;
+    }
+
+    void rehash(int numParticles)
+    {
+      std::vector<long64> keys;
+      std::vector<particleIndex> values;
+      keys.swap(d_keys);
+      values.swap(d_values);
+      reserve(numParticles);
+      for (unsigned int ii = 0; ii < values.size(); ii++) {
+        if (values[ii] >= 0) {
+          insert(keys[ii], values[ii]);
+        }
+      }
+    }
+
+    int d_size;
+    unsigned int d_mask;
+    std::vector<long64> d_keys;
+    std::vector<particleIndex> d_values;
+  };
+
+} // End namespace Uintah
+
+#endif // __VAANGO_PARTICLE_ID_MAP_H__
@@ -136,7 +136,7 @@ WARNING
       }
 
       virtual void* getBasePointer() const = 0;
-      void getMPIBuffer(BufferInfo& buffer, ParticleSubset* sendset);
+      virtual void getMPIBuffer(BufferInfo& buffer, ParticleSubset* sendset);
       virtual const TypeDescription* virtualGetTypeDescription() const = 0;
      virtual RefCounted* getRefCounted() = 0;
      virtual void getSizeInfo(std::string& elems, unsigned long& totsize,
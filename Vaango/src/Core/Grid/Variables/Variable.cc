@@ -154,7 +154,12 @@ Variable::emit( OutputContext& oc, const IntVector& l,
 
   const char* writebuffer = (*writeoutString).c_str();
   unsigned long writebufferSize = (*writeoutString).size();
-  if(writebufferSize>0)
+  if(writebufferSize>0 && oc.buffer)
+  {
+    oc.buffer->append(writebuffer, writebufferSize);
+    oc.cur += writebufferSize;
+  }
+  else if(writebufferSize>0)
   {
   #ifdef _WIN32
     ssize_t s = ::_write(oc.fd, writebuffer, writebufferSize);
@@ -38,6 +38,7 @@
 #include <Core/Grid/Variables/NeighborConnectivity.h>
 #include <Core/Grid/Variables/NeighborBondEnergy.h>
 #include <Core/Grid/Variables/NeighborBondInternalForce.h>
+#include <Core/Grid/Variables/ParticleFamilyVariable.h>
 #include <Core/Math/Matrix3.h>
 #include <Core/Disclosure/TypeUtils.h>
 
@@ -54,6 +55,11 @@ template class Uintah::ParticleVariable<Uintah::NeighborConnectivity>;
 template class Uintah::ParticleVariable<Uintah::NeighborBondEnergy>;
 template class Uintah::ParticleVariable<Uintah::NeighborBondInternalForce>;
 
+template class Uintah::ParticleFamilyVariable<Uintah::long64>;
+template class Uintah::ParticleFamilyVariable<int>;
+template class Uintah::ParticleFamilyVariable<double>;
+template class Uintah::ParticleFamilyVariable<Uintah::Vector>;
+
 template class Uintah::ParticleVariable<double>;
 template class Uintah::ParticleVariable<float>;
 template class Uintah::ParticleVariable<int>;
@@ -66,10 +66,19 @@ cpdiInterpolator* cpdiInterpolator::clone(const Patch* patch)
 }
     
 void cpdiInterpolator::findCellAndWeights(const Point& pos,
-                                            vector<IntVector>& ni, 
-                                            vector<double>& S,
-                                            const Matrix3& size,
-                                            const Matrix3& defgrad)
+                                          vector<IntVector>& ni, 
+                                          vector<double>& S,
+                                          const Matrix3& size,
+                                          const Matrix3& defgrad)
+{
+  findCellAndWeights(pos, &ni[0], &S[0], size, defgrad);
+}
+
+void cpdiInterpolator::findCellAndWeights(const Point& pos,
+                                          IntVector* ni, 
+                                          double* S,
+                                          const Matrix3& size,
+                                          const Matrix3& defgrad)
 {
   Point cellpos = d_patch->getLevel()->positionToIndex(Point(pos));
 
@@ -460,12 +469,25 @@ void cpdiInterpolator::findCellAndShapeDerivatives(const Point& pos,
   }
 }
 
-void cpdiInterpolator::findCellAndWeightsAndShapeDerivatives(const Point& pos,
-                                                          vector<IntVector>& ni,
-                                                          vector<double>& S,
-                                                          vector<Vector>& d_S,
-                                                          const Matrix3& size,
-                                                          const Matrix3& defgrad)
+void 
+cpdiInterpolator::findCellAndWeightsAndShapeDerivatives(const Point& pos,
+                                                        vector<IntVector>& ni,
+                                                        vector<double>& S,
+                                                        vector<Vector>& d_S,
+                                                        const Matrix3& size,
+                                                        const Matrix3& defgrad)
+{
+  findCellAndWeightsAndShapeDerivatives(pos, &ni[0], &S[0], &d_S[0],
+                                        size, defgrad);
+}
+
+void 
+cpdiInterpolator::findCellAndWeightsAndShapeDerivatives(const Point& pos,
+                                                        IntVector* ni,
+                                                        double* S,
+                                                        Vector* d_S,
+                                                        const Matrix3& size,
+                                                        const Matrix3& defgrad)
 {
   Point cellpos = d_patch->getLevel()->positionToIndex(Point(pos));
 
@@ -701,3 +723,7 @@ int cpdiInterpolator::size()
 {
   return d_size;
 }
+
+//______________________________________________________________________
+//  Allocation-free batch interface (see ParticleInterpolatorBatch.h)
+UINTAH_INSTANTIATE_INTERPOLATOR_BATCH(cpdiInterpolator)
@@ -35,6 +35,7 @@
 #define CPDI_INTERPOLATOR_H
 
 #include <Core/Grid/ParticleInterpolator.h>
+#include <Core/Grid/ParticleInterpolatorBatch.h>
 
 namespace Uintah {
 
@@ -70,6 +71,24 @@ namespace Uintah {
                                                        const Matrix3& size,
                                                        const Matrix3& defgrad);
     virtual int size();
+
+    //__________________________________
+    //  Allocation-free kernels used by the batch interface in
+    //  ParticleInterpolatorBatch.h.  ni, S and d_S must hold NUM_NODES entries.
+    static const int NUM_NODES = 64;   // 4x4x4 node stencil
+
+    void findCellAndWeights(const Point& pos,
+                            IntVector* ni,
+                            double* S,
+                            const Matrix3& size,
+                            const Matrix3& defgrad);
+
+    void findCellAndWeightsAndShapeDerivatives(const Point& pos,
+                                               IntVector* ni,
+                                               double* S,
+                                               Vector* d_S,
+                                               const Matrix3& size,
+                                               const Matrix3& defgrad);
     
     /*! 
      *  Set the critial length of a particle. 
@@ -118,5 +137,7 @@ namespace Uintah {
   };
 }
 
+UINTAH_EXTERN_INTERPOLATOR_BATCH(cpdiInterpolator)
+
 #endif
 
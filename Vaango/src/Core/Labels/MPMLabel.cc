@@ -32,6 +32,7 @@
 #include <Core/Grid/Variables/VarTypes.h>
 #include <Core/Grid/Variables/PerPatch.h>
 #include <Core/Grid/Variables/SoleVariable.h>
+#include <Core/Grid/ParticleInterpolationCache.h>
 #include <Core/Malloc/Allocator.h>
 #include <iostream>
 using namespace Uintah;
@@ -95,6 +96,10 @@ MPMLabel::MPMLabel()
                      
   pPartitionUnityLabel   = VarLabel::create( "p.partitionUnity",
 			ParticleVariable<double>::getTypeDescription() );
+
+  // Per-patch cache of shape function weights and gradients
+  pInterpolationCacheLabel = VarLabel::create( "p.interpolationCache",
+			PerPatch<ParticleInterpolationCacheP>::getTypeDescription() );
   
   // Extra labels for the velocity gradient and the deformation gradient
   // (named such that there is minimal disruption of existing code)
@@ -807,6 +812,7 @@ MPMLabel::~MPMLabel()
   VarLabel::destroy(p_qLabel);
   VarLabel::destroy(p_qLabel_preReloc);
   VarLabel::destroy(pPartitionUnityLabel);
+  VarLabel::destroy(pInterpolationCacheLabel);
 
   VarLabel::destroy(gAccelerationLabel);
   VarLabel::destroy(gMassLabel);
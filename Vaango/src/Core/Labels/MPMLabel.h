@@ -59,6 +59,7 @@ using std::vector;
       const VarLabel* TotalVolumeDeformedLabel;
       const VarLabel* pXXLabel;
       const VarLabel* pPartitionUnityLabel;
+      const VarLabel* pInterpolationCacheLabel;
 
       // Two more labels for velGrad and defGrad (with least disruption
       // of existing code in mind).  These labels are used in the MPM
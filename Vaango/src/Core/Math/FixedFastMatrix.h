@@ -0,0 +1,125 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2015-     Parresia Research Limited, New Zealand
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+#ifndef VAANGO_CORE_MATH_FIXEDFASTMATRIX_H
+#define VAANGO_CORE_MATH_FIXEDFASTMATRIX_H
+
+#include <Core/Geometry/Vector.h>
+
+namespace Uintah {
+
+  /**
+   *  @class  FixedFastMatrix
+   *  @brief  Square FastMatrix with the size fixed at compile time
+   *
+   *  All the loops have constant trip counts, so the compiler unrolls them
+   *  and the matrix stays on the stack.  Used for the multi-material exchange
+   *  solves of ICE, where the number of materials is known once per patch.
+   *
+   *  The solves are Gaussian elimination without pivoting, which is stable
+   *  for the diagonally dominant exchange matrices (1 plus the sum of the
+   *  off diagonal magnitudes on the diagonal).  Use FastMatrix for general
+   *  systems.
+   */
+  template<int N>
+  class FixedFastMatrix {
+  public:
+
+    static int numRows() { return N; }
+    static int numCols() { return N; }
+
+    double& operator()(int r, int c) { return mat[r][c]; }
+    double operator()(int r, int c) const { return mat[r][c]; }
+
+    void zero()
+    {
+      for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+          mat[i][j] = 0.0;
+        }
+      }
+    }
+
+    // Warning - these do not do any pivoting...
+    void destructiveSolve(double* b)
+    {
+      factor();
+      substitute(b);
+    }
+
+    void destructiveSolve(double* b1, double* b2)
+    {
+      factor();
+      substitute(b1);
+      substitute(b2);
+    }
+
+    void destructiveSolve(Vector* b)
+    {
+      factor();
+      substitute(b);
+    }
+
+  private:
+
+    // LU factorization in place: the multipliers below the diagonal,
+    // the reciprocals of the pivots on it
+    void factor()
+    {
+      for (int i = 0; i < N; i++) {
+        double inv_pivot = 1.0/mat[i][i];
+        mat[i][i] = inv_pivot;
+        for (int j = i + 1; j < N; j++) {
+          double factor = mat[j][i]*inv_pivot;
+          mat[j][i] = factor;
+          for (int k = i + 1; k < N; k++) {
+            mat[j][k] -= factor*mat[i][k];
+          }
+        }
+      }
+    }
+
+    template<class T>
+    void substitute(T* b) const
+    {
+      for (int i = 1; i < N; i++) {
+        for (int j = 0; j < i; j++) {
+          b[i] -= mat[i][j]*b[j];
+        }
+      }
+      for (int i = N - 1; i >= 0; i--) {
+        for (int j = i + 1; j < N; j++) {
+          b[i] -= mat[i][j]*b[j];
+        }
+        b[i] *= mat[i][i];
+      }
+    }
+
+    double mat[N][N];
+  };
+
+} // End namespace Uintah
+
+#endif // VAANGO_CORE_MATH_FIXEDFASTMATRIX_H
@@ -81,18 +81,13 @@ PackBufferInfo::get_type(void*& out_buf, int& out_count,
   MALLOC_TRACE_TAG_SCOPE("PackBufferInfo::get_type");
   ASSERT(count() > 0);
   if(!have_datatype){
-    int packed_size;
-    int total_packed_size=0;
-    for (int i = 0; i < (int)startbufs.size(); i++) {
-      if(counts[i]>0)
-      {
-        MPI_Pack_size(counts[i], datatypes[i], comm, &packed_size);
-        total_packed_size += packed_size;
-      }
-    }
+    int total_packed_size = packedSize(comm);
 
-    packedBuffer = scinew PackedBuffer(total_packed_size);
-    packedBuffer->addReference();
+    if (!packedBuffer) {
+      packedBuffer = scinew PackedBuffer(total_packed_size);
+      packedBuffer->addReference();
+    }
+    ASSERT(packedBuffer->getBufSize() >= total_packed_size);
 
     datatype = MPI_PACKED;
     cnt=total_packed_size;
@@ -104,6 +99,33 @@ PackBufferInfo::get_type(void*& out_buf, int& out_count,
   out_datatype=datatype;
 }
 
+int
+PackBufferInfo::packedSize(MPI_Comm comm) const
+{
+  int packed_size;
+  int total_packed_size=0;
+  for (int i = 0; i < (int)startbufs.size(); i++) {
+    if(counts[i]>0)
+    {
+      MPI_Pack_size(counts[i], datatypes[i], comm, &packed_size);
+      total_packed_size += packed_size;
+    }
+  }
+  return total_packed_size;
+}
+
+void
+PackBufferInfo::setPackedBuffer(PackedBuffer* buffer)
+{
+  ASSERT(!have_datatype);
+  buffer->addReference();
+  if (packedBuffer && packedBuffer->removeReference())
+  {
+    delete packedBuffer;
+  }
+  packedBuffer = buffer;
+}
+
 void PackBufferInfo::get_type(void*&, int&, MPI_Datatype&)
 {
   // Should use other overload for a PackBufferInfo
@@ -79,6 +79,14 @@ namespace Uintah {
 
     void get_type(void*&, int&, MPI_Datatype&, MPI_Comm comm);
     void get_type(void*&, int&, MPI_Datatype&);
+
+    // Number of bytes needed to pack the added buffers
+    int packedSize(MPI_Comm comm) const;
+
+    // Use an existing buffer (of at least packedSize() bytes) instead of
+    // allocating a new one in get_type.  Used for persistent requests.
+    void setPackedBuffer(PackedBuffer* buffer);
+
     void pack(MPI_Comm comm, int& out_count);
     void unpack(MPI_Comm comm, MPI_Status &status); 
     // PackBufferInfo is to be an AfterCommuncationHandler object for the
@@ -52,6 +52,8 @@ from helpers.runSusTests import runSusTests
 #  3) Performance_tests are not run on a debug build.
 #______________________________________________________________________
 NIGHTLYTESTS = [   ("poisson1",         "poisson1.ups",         1, "ALL"),
+                   # regrids with incremental recompiles, each checked against a full compile
+                   ("wave_incremental", "wave_incremental.ups", 4, "Linux", ["exactComparison"]),
                ]
 
 LOCALTESTS = NIGHTLYTESTS
@@ -0,0 +1,325 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2015-     Parresia Research Limited, New Zealand
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/*
+ *  AdvectConvert.cc: Benchmark of the cell sweeps of ICE after the advection
+ *  operators, advectAndAdvanceInTime followed by conservedtoPrimitive_Vars
+ *  against the fused advectAndConvertToPrimitive (<fused_advection>).
+ *
+ *  The advected increments are computed once and shared by both versions;
+ *  the advection operators themselves are the same in both tasks.
+ */
+
+#include <Core/Geometry/IntVector.h>
+#include <Core/Geometry/Vector.h>
+#include <Core/Thread/Time.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace Uintah;
+using namespace std;
+
+const int SIZE_DEFAULT = 64;
+const int LOOP_DEFAULT = 20;
+
+void usage ( void )
+{
+  cerr << "Usage: AdvectConvert [<size> [<loop>]]" << endl;
+  cerr << endl;
+  cerr << "  <size>   The patch has <size>^3 cells (default " << SIZE_DEFAULT << ")." << endl;
+  cerr << endl;
+  cerr << "  <loop>   The sweeps are repeated <loop> times (default " << LOOP_DEFAULT << ")." << endl;
+}
+
+// Cells of a size^3 patch in the order of CellIterator
+class CellLoop {
+
+public:
+
+  CellLoop(int size) : d_size(size), d_c(0, 0, 0) {}
+
+  bool done() const { return d_c.z() >= d_size; }
+  IntVector operator*() const { return d_c; }
+
+  void operator++(int)
+  {
+    d_c[0]++;
+    if (d_c.x() >= d_size) {
+      d_c[0] = 0;
+      d_c[1]++;
+      if (d_c.y() >= d_size) {
+        d_c[1] = 0;
+        d_c[2]++;
+      }
+    }
+  }
+
+private:
+
+  int d_size;
+  IntVector d_c;
+};
+
+// A cell-centered field addressed like Array3Data, through row pointers
+template<class T>
+class CellField {
+
+public:
+
+  CellField(int size) : d_size(size), d_data(size*size*size)
+  {
+    setRows();
+  }
+
+  CellField(const CellField<T>& from) : d_size(from.d_size), d_data(from.d_data)
+  {
+    setRows();
+  }
+
+  T& operator[](const IntVector& c) { return d_data3[c.z()][c.y()][c.x()]; }
+  const T& operator[](const IntVector& c) const { return d_data3[c.z()][c.y()][c.x()]; }
+
+  void initialize(const T& value) { fill(d_data.begin(), d_data.end(), value); }
+  void copyData(const CellField<T>& from) { d_data = from.d_data; }
+
+private:
+
+  void setRows()
+  {
+    d_data3.assign(d_size, vector<T*>(d_size));
+    for (int k = 0; k < d_size; k++) {
+      for (int j = 0; j < d_size; j++) {
+        d_data3[k][j] = &d_data[(k*d_size + j)*d_size];
+      }
+    }
+  }
+
+  int d_size;
+  vector<T> d_data;
+  vector<vector<T*> > d_data3;
+
+  CellField<T>& operator=(const CellField<T>&);
+};
+
+struct Fields {
+  // Lagrangian values and advected increments
+  CellField<double> mass_L, eng_L, sp_vol_L, dmass, deng, dsp_vol, cv;
+  CellField<Vector> mom_L, dmom;
+  // time n+1 conserved and primitive values
+  CellField<double> mass_adv, eng_adv, sp_vol_adv, rho, temp, sp_vol, cv_new;
+  CellField<Vector> mom_adv, vel;
+  int size;
+
+  Fields(int n) : mass_L(n), eng_L(n), sp_vol_L(n), dmass(n), deng(n),
+                  dsp_vol(n), cv(n), mom_L(n), dmom(n), mass_adv(n),
+                  eng_adv(n), sp_vol_adv(n), rho(n), temp(n), sp_vol(n),
+                  cv_new(n), mom_adv(n), vel(n), size(n)
+  {
+    for (CellLoop c(size); !c.done(); c++) {
+      mass_L[*c]   = 1.0 + drand48();
+      eng_L[*c]    = 1.0e5*(1.0 + drand48());
+      sp_vol_L[*c] = 1.0 + drand48();
+      dmass[*c]    = 0.1*(drand48() - 0.5);
+      deng[*c]     = 1.0e3*(drand48() - 0.5);
+      dsp_vol[*c]  = 0.1*(drand48() - 0.5);
+      cv[*c]       = 716.0;
+      mom_L[*c]    = Vector(drand48(), drand48(), drand48());
+      dmom[*c]     = Vector(0.1*(drand48() - 0.5));
+    }
+  }
+};
+
+// The cell loops of advectAndAdvanceInTime and conservedtoPrimitive_Vars
+void separate(Fields& f, double invvol)
+{
+  // advectAndAdvanceInTime
+  f.mass_adv.initialize(0.0);
+  f.mom_adv.initialize(Vector(0.0));
+  f.eng_adv.initialize(0.0);
+  f.sp_vol_adv.initialize(0.0);
+  for (CellLoop iter(f.size); !iter.done(); iter++) {
+    IntVector c = *iter;
+    f.mass_adv[c] = f.mass_L[c] + f.dmass[c];
+  }
+  for (CellLoop iter(f.size); !iter.done(); iter++) {
+    IntVector c = *iter;
+    f.mom_adv[c] = f.mom_L[c] + f.dmom[c];
+  }
+  for (CellLoop iter(f.size); !iter.done(); iter++) {
+    IntVector c = *iter;
+    f.eng_adv[c] = f.eng_L[c] + f.deng[c];
+  }
+  for (CellLoop iter(f.size); !iter.done(); iter++) {
+    IntVector c = *iter;
+    f.sp_vol_adv[c] = f.sp_vol_L[c] + f.dsp_vol[c];
+  }
+
+  // conservedtoPrimitive_Vars
+  f.rho.initialize(-1.0e100);
+  f.temp.initialize(-1.0e100);
+  f.vel.initialize(Vector(0.0));
+  for (CellLoop iter(f.size); !iter.done(); iter++) {
+    IntVector c = *iter;
+    double inv_mass_adv = 1.0/f.mass_adv[c];
+    f.rho[c]    = f.mass_adv[c] * invvol;
+    f.vel[c]    = f.mom_adv[c]    * inv_mass_adv;
+    f.sp_vol[c] = f.sp_vol_adv[c] * inv_mass_adv;
+  }
+  f.cv_new.copyData(f.cv);
+  for (CellLoop iter(f.size); !iter.done(); iter++) {
+    IntVector c = *iter;
+    f.temp[c] = f.eng_adv[c]/(f.mass_adv[c]*f.cv_new[c]);
+  }
+}
+
+// The cell loop of advectAndConvertToPrimitive
+void fused(Fields& f, double invvol)
+{
+  f.mass_adv.initialize(0.0);
+  f.mom_adv.initialize(Vector(0.0));
+  f.eng_adv.initialize(0.0);
+  f.sp_vol_adv.initialize(0.0);
+  f.rho.initialize(-1.0e100);
+  f.temp.initialize(-1.0e100);
+  f.vel.initialize(Vector(0.0));
+  f.cv_new.copyData(f.cv);
+  for (int z = 0; z < f.size; z++) {
+    for (int y = 0; y < f.size; y++) {
+      IntVector row(0, y, z);
+      const double* mass_L_row = &f.mass_L[row];
+      const Vector* mom_L_row  = &f.mom_L[row];
+      const double* eng_L_row  = &f.eng_L[row];
+      const double* spv_L_row  = &f.sp_vol_L[row];
+      const double* dmass_row  = &f.dmass[row];
+      const Vector* dmom_row   = &f.dmom[row];
+      const double* deng_row   = &f.deng[row];
+      const double* dspv_row   = &f.dsp_vol[row];
+      const double* cv_row     = &f.cv_new[row];
+      double* mass_adv_row     = &f.mass_adv[row];
+      Vector* mom_adv_row      = &f.mom_adv[row];
+      double* eng_adv_row      = &f.eng_adv[row];
+      double* spv_adv_row      = &f.sp_vol_adv[row];
+      double* rho_row          = &f.rho[row];
+      Vector* vel_row          = &f.vel[row];
+      double* spv_row          = &f.sp_vol[row];
+      double* temp_row         = &f.temp[row];
+
+      for (int i = 0; i < f.size; i++) {
+        double mass    = mass_L_row[i] + dmass_row[i];
+        Vector mom     = mom_L_row[i]  + dmom_row[i];
+        double int_eng = eng_L_row[i]  + deng_row[i];
+        double sp_vol  = spv_L_row[i]  + dspv_row[i];
+
+        mass_adv_row[i] = mass;
+        mom_adv_row[i]  = mom;
+        eng_adv_row[i]  = int_eng;
+        spv_adv_row[i]  = sp_vol;
+
+        double inv_mass = 1.0/mass;
+        rho_row[i]  = mass * invvol;
+        vel_row[i]  = mom    * inv_mass;
+        spv_row[i]  = sp_vol * inv_mass;
+        temp_row[i] = int_eng/(mass*cv_row[i]);
+      }
+    }
+  }
+}
+
+template<class Sweep>
+double time(Sweep sweep, Fields& f, int loop, double invvol)
+{
+  sweep(f, invvol);
+  double start = Time::currentSeconds();
+  for (int l = 0; l < loop; l++) {
+    sweep(f, invvol);
+  }
+  return (Time::currentSeconds() - start)/loop;
+}
+
+int main ( int argc, char** argv )
+{
+  int size = SIZE_DEFAULT;
+  int loop = LOOP_DEFAULT;
+
+  if ( argc > 1 ) {
+    size = atoi( argv[1] );
+    if ( argc > 2 ) {
+      loop = atoi( argv[2] );
+    }
+  }
+  if ( size <= 0 || loop <= 0 ) {
+    usage();
+    return EXIT_FAILURE;
+  }
+
+  srand48(1);
+
+  int cells = size*size*size;
+  double invvol = 1.0e6;
+  Fields f(size);
+
+  double t_separate = time(separate, f, loop, invvol);
+  CellField<double> temp(f.temp);
+  CellField<Vector> vel(f.vel);
+  double t_fused = time(fused, f, loop, invvol);
+
+  double diff = 0;
+  for (CellLoop iter(size); !iter.done(); iter++) {
+    IntVector c = *iter;
+    diff = max(diff, fabs(temp[c] - f.temp[c])/fabs(temp[c]));
+    diff = max(diff, (vel[c] - f.vel[c]).length()/vel[c].length());
+  }
+
+  // Bytes per cell moved by the loops, counting the initializations and
+  // the copy of the specific heat, each read and each write once
+  const double bytes_separate = 8*45;
+  const double bytes_fused    = 8*38;
+
+  cout << "Advect and Convert Benchmark: " << endl;
+  cout << size << "^3 cells, repeating " << loop << " time(s)." << endl;
+  cout << endl;
+  cout << setw(10) << "version"
+       << setw(12) << "ns/cell"
+       << setw(12) << "bytes/cell"
+       << setw(12) << "GB/s" << endl;
+  cout << setw(10) << "separate"
+       << setw(12) << fixed << setprecision(2) << 1.0e9*t_separate/cells
+       << setw(12) << setprecision(0) << bytes_separate
+       << setw(12) << setprecision(1) << 1.0e-9*bytes_separate*cells/t_separate << endl;
+  cout << setw(10) << "fused"
+       << setw(12) << setprecision(2) << 1.0e9*t_fused/cells
+       << setw(12) << setprecision(0) << bytes_fused
+       << setw(12) << setprecision(1) << 1.0e-9*bytes_fused*cells/t_fused << endl;
+  cout << endl;
+  cout << "speedup " << setprecision(2) << t_separate/t_fused
+       << ", max relative diff " << scientific << setprecision(1) << diff
+       << defaultfloat << endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,183 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2015-     Parresia Research Limited, New Zealand
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/*
+ *  ExchangeSolve.cc: Benchmark of the multi-material exchange solves of ICE,
+ *  FastMatrix against FixedFastMatrix<N>.
+ */
+
+#include <Core/Geometry/Vector.h>
+#include <Core/Math/FastMatrix.h>
+#include <Core/Math/FixedFastMatrix.h>
+#include <Core/Thread/Time.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace Uintah;
+using namespace std;
+
+const int CELLS_DEFAULT = 100000;
+const int LOOP_DEFAULT  = 10;
+
+void usage ( void )
+{
+  cerr << "Usage: ExchangeSolve [<cells> [<loop>]]" << endl;
+  cerr << endl;
+  cerr << "  <cells>  Number of cells, each with its own exchange matrix, for" << endl;
+  cerr << "           2 to 8 materials (default " << CELLS_DEFAULT << ")." << endl;
+  cerr << "           Every cell does a momentum (Vector) and an energy solve," << endl;
+  cerr << "           as in ICE::addExchangeToMomentumAndEnergy." << endl;
+  cerr << endl;
+  cerr << "  <loop>   The solves are repeated <loop> times (default " << LOOP_DEFAULT << ")." << endl;
+}
+
+// Exchange matrices like those of ICE: -beta off the diagonal,
+// 1 + sum(beta) on it
+void makeSystems(int numMatls, int cells, vector<double>& matrices,
+                 vector<double>& rhs)
+{
+  matrices.resize(cells*numMatls*numMatls);
+  rhs.resize(cells*numMatls);
+  for (int c = 0; c < cells; c++) {
+    double* a = &matrices[c*numMatls*numMatls];
+    for (int m = 0; m < numMatls; m++) {
+      double diag = 1.0;
+      for (int n = 0; n < numMatls; n++) {
+        double beta = (m == n) ? 0.0 : 10.0*drand48();
+        a[m*numMatls + n] = -beta;
+        diag += beta;
+      }
+      a[m*numMatls + m] = diag;
+      rhs[c*numMatls + m] = drand48() - 0.5;
+    }
+  }
+}
+
+template<class M>
+double solve(M& a, int numMatls, int cells, int loop,
+             const vector<double>& matrices, const vector<double>& rhs,
+             vector<double>& x)
+{
+  x.resize(cells*numMatls);
+  double b[FastMatrix::MaxSize];
+  Vector bb[FastMatrix::MaxSize];
+
+  double start = Time::currentSeconds();
+  for (int l = 0; l < loop; l++) {
+    for (int c = 0; c < cells; c++) {
+      const double* mat = &matrices[c*numMatls*numMatls];
+
+      // momentum
+      for (int m = 0; m < numMatls; m++) {
+        for (int n = 0; n < numMatls; n++) {
+          a(m, n) = mat[m*numMatls + n];
+        }
+        bb[m] = Vector(rhs[c*numMatls + m]);
+      }
+      a.destructiveSolve(bb);
+
+      // energy
+      for (int m = 0; m < numMatls; m++) {
+        for (int n = 0; n < numMatls; n++) {
+          a(m, n) = mat[m*numMatls + n];
+        }
+        b[m] = rhs[c*numMatls + m];
+      }
+      a.destructiveSolve(b);
+
+      for (int m = 0; m < numMatls; m++) {
+        x[c*numMatls + m] = b[m] + bb[m].x();
+      }
+    }
+  }
+  return Time::currentSeconds() - start;
+}
+
+template<int N>
+void compare(int cells, int loop)
+{
+  vector<double> matrices, rhs, x_fast, x_fixed;
+  makeSystems(N, cells, matrices, rhs);
+
+  FastMatrix fast_matrix(N, N);
+  FixedFastMatrix<N> fixed_matrix;
+  double t_fast  = solve(fast_matrix,  N, cells, loop, matrices, rhs, x_fast);
+  double t_fixed = solve(fixed_matrix, N, cells, loop, matrices, rhs, x_fixed);
+
+  double diff = 0;
+  for (size_t i = 0; i < x_fast.size(); i++) {
+    diff = max(diff, fabs(x_fast[i] - x_fixed[i]));
+  }
+
+  double solves = 1.0e-9*cells*loop;
+  cout << setw(6) << N
+       << setw(16) << fixed << setprecision(1) << t_fast/solves
+       << setw(16) << t_fixed/solves
+       << setw(10) << setprecision(2) << t_fast/t_fixed
+       << setw(14) << scientific << setprecision(1) << diff << defaultfloat << endl;
+}
+
+int main ( int argc, char** argv )
+{
+  int cells = CELLS_DEFAULT;
+  int loop  = LOOP_DEFAULT;
+
+  if ( argc > 1 ) {
+    cells = atoi( argv[1] );
+    if ( argc > 2 ) {
+      loop = atoi( argv[2] );
+    }
+  }
+  if ( cells <= 0 || loop <= 0 ) {
+    usage();
+    return EXIT_FAILURE;
+  }
+
+  srand48(1);
+
+  cout << "Exchange Solve Benchmark: " << endl;
+  cout << cells << " cells, repeating " << loop << " time(s)." << endl;
+  cout << endl;
+  cout << setw(6)  << "matls"
+       << setw(16) << "FastMatrix ns"
+       << setw(16) << "Fixed ns"
+       << setw(10) << "speedup"
+       << setw(14) << "max diff" << endl;
+
+  compare<2>(cells, loop);
+  compare<3>(cells, loop);
+  compare<4>(cells, loop);
+  compare<5>(cells, loop);
+  compare<6>(cells, loop);
+  compare<7>(cells, loop);
+  compare<8>(cells, loop);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,360 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2015-     Parresia Research Limited, New Zealand
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/*
+ *  ParticleIDLookup.cc: Benchmark of the peridynamics bond loops of one
+ *  timestep (deformation gradient, bond force, particle force and damage)
+ *  with the family members found through a std::map per bond, through a
+ *  ParticleIDMap per bond, and through indices resolved once per timestep
+ *  (FamilyComputer::resolveFamilyIndices).
+ */
+
+#include <Core/Geometry/Point.h>
+#include <Core/Geometry/Vector.h>
+#include <Core/Grid/Variables/ParticleIDMap.h>
+#include <Core/Math/Matrix3.h>
+#include <Core/Thread/Time.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <vector>
+
+using namespace Uintah;
+using namespace std;
+
+const int PARTICLES_DEFAULT = 100000;
+const int FAMILY_DEFAULT    = 40;
+const int LOOP_DEFAULT      = 10;
+const int PATCHES           = 8;
+
+void usage ( void )
+{
+  cerr << "Usage: ParticleIDLookup [<particles> [<family> [<loop>]]]" << endl;
+  cerr << endl;
+  cerr << "  <particles>  Number of particles in the family (ghosted) subset" << endl;
+  cerr << "               (default " << PARTICLES_DEFAULT << "), with IDs spread over "
+       << PATCHES << " patches." << endl;
+  cerr << endl;
+  cerr << "  <family>     Number of bonds of each particle (default " << FAMILY_DEFAULT << ")." << endl;
+  cerr << "               One bond in ten is broken." << endl;
+  cerr << endl;
+  cerr << "  <loop>       Number of timesteps (default " << LOOP_DEFAULT << ")." << endl;
+  cerr << "               Every timestep runs the four bond loops of Peridynamics." << endl;
+}
+
+// The particle data of the family subset
+struct Particles {
+  vector<long64>  pID;
+  vector<Point>   pPos;
+  vector<Vector>  pDisp;
+  vector<double>  pVol;
+  vector<Matrix3> pForceState;
+};
+
+// The family of the particles: IDs and connectivity in compressed rows of
+// constant length
+struct Families {
+  int             size;
+  vector<long64>  familyID;
+  vector<int>     connected;
+};
+
+// Particle IDs like those of the particle creator: the patch ID in the
+// high word and a counter in the low word.  The subset order is shuffled,
+// as the ghost particles of a family subset are not sorted by ID.
+void makeParticles(int particles, Particles& p)
+{
+  vector<int> order(particles);
+  for (int ii = 0; ii < particles; ii++) {
+    order[ii] = ii;
+  }
+  for (int ii = particles - 1; ii > 0; ii--) {
+    swap(order[ii], order[(int) (drand48()*(ii + 1))]);
+  }
+
+  p.pID.resize(particles);
+  p.pPos.resize(particles);
+  p.pDisp.resize(particles);
+  p.pVol.resize(particles);
+  p.pForceState.resize(particles);
+  for (int ii = 0; ii < particles; ii++) {
+    long64 patch = order[ii] % PATCHES;
+    p.pID[ii] = (patch << 32) | (long64) (order[ii] / PATCHES);
+    p.pPos[ii] = Point(drand48(), drand48(), drand48());
+    p.pDisp[ii] = Vector(drand48(), drand48(), drand48())*1.0e-3;
+    p.pVol[ii] = 1.0e-6*(1.0 + drand48());
+    p.pForceState[ii] = Matrix3(drand48(), drand48(), drand48(),
+                                drand48(), drand48(), drand48(),
+                                drand48(), drand48(), drand48());
+  }
+}
+
+// Family members are drawn from a window around each particle, which is
+// what a horizon does to the subset indices.
+void makeFamilies(int particles, int family, const Particles& p, Families& f)
+{
+  f.size = family;
+  f.familyID.resize(particles*family);
+  f.connected.resize(particles*family);
+  int window = 8*family;
+  for (int ip = 0; ip < particles; ip++) {
+    for (int ii = 0; ii < family; ii++) {
+      int q = ip + (int) (drand48()*window) - window/2;
+      q = min(max(q, 0), particles - 1);
+      f.familyID[ip*family + ii] = p.pID[q];
+      f.connected[ip*family + ii] = (drand48() >= 0.1);
+    }
+  }
+}
+
+// Family member lookups, as in the bond loops before and after the indices
+// were resolved.  index() returns -1 for a broken bond.
+class StdMapLookup {
+public:
+  StdMapLookup(const Particles& p, const Families& f) : d_f(f) {
+    for (size_t ii = 0; ii < p.pID.size(); ii++) {
+      d_map.insert(pair<long64, int>(p.pID[ii], (int) ii));
+    }
+  }
+  void newTimestep() {}
+  inline int index(int bond) const {
+    if (!d_f.connected[bond]) {
+      return -1;
+    }
+    return d_map.find(d_f.familyID[bond])->second;
+  }
+private:
+  const Families& d_f;
+  map<long64, int> d_map;
+};
+
+class FlatMapLookup {
+public:
+  FlatMapLookup(const Particles& p, const Families& f) : d_f(f) {
+    d_map.reserve((int) p.pID.size());
+    for (size_t ii = 0; ii < p.pID.size(); ii++) {
+      d_map.insert(p.pID[ii], (int) ii);
+    }
+  }
+  void newTimestep() {}
+  inline int index(int bond) const {
+    particleIndex idx = -1;
+    if (d_f.connected[bond]) {
+      d_map.find(d_f.familyID[bond], idx);
+    }
+    return idx;
+  }
+private:
+  const Families& d_f;
+  ParticleIDMap d_map;
+};
+
+class ResolvedLookup {
+public:
+  ResolvedLookup(const Particles& p, const Families& f)
+    : d_p(p), d_f(f), d_index(f.familyID.size(), -1) {}
+  // The map is built and the families resolved once per timestep, after
+  // relocation
+  void newTimestep() {
+    ParticleIDMap idMap;
+    idMap.reserve((int) d_p.pID.size());
+    for (size_t ii = 0; ii < d_p.pID.size(); ii++) {
+      idMap.insert(d_p.pID[ii], (int) ii);
+    }
+    for (size_t bond = 0; bond < d_index.size(); bond++) {
+      d_index[bond] = -1;
+      if (d_f.connected[bond]) {
+        idMap.find(d_f.familyID[bond], d_index[bond]);
+      }
+    }
+  }
+  inline int index(int bond) const { return d_index[bond]; }
+private:
+  const Particles& d_p;
+  const Families& d_f;
+  vector<particleIndex> d_index;
+};
+
+// The four bond loops of a timestep, with the arithmetic of
+// PeridynamicsDefGradComputer, BondInternalForceComputer,
+// ParticleInternalForceComputer and SphericalStrainEnergyDamageModel
+template<class Lookup>
+double timestep(const Lookup& lookup, const Particles& p, const Families& f,
+                int particles, vector<Matrix3>& defGrad,
+                vector<Vector>& bondForce, vector<Vector>& intForce,
+                vector<double>& bondEnergy)
+{
+  int family = f.size;
+  double check = 0.0;
+
+  // Deformation gradient
+  for (int ip = 0; ip < particles; ip++) {
+    Matrix3 F(0.0), K(0.0);
+    for (int ii = 0; ii < family; ii++) {
+      int family_idx = lookup.index(ip*family + ii);
+      if (family_idx >= 0) {
+        Vector x  = p.pPos[family_idx] - p.pPos[ip];
+        Vector xi = x - (p.pDisp[family_idx] - p.pDisp[ip]);
+        K += Matrix3(xi, xi)*p.pVol[family_idx];
+        F += Matrix3(x, xi)*p.pVol[family_idx];
+      }
+    }
+    defGrad[ip] = F + K;
+  }
+
+  // Bond internal force
+  for (int ip = 0; ip < particles; ip++) {
+    Point cur_ref_pos = p.pPos[ip] - p.pDisp[ip];
+    for (int ii = 0; ii < family; ii++) {
+      int family_idx = lookup.index(ip*family + ii);
+      if (family_idx >= 0) {
+        Vector xi = (p.pPos[family_idx] - p.pDisp[family_idx]) - cur_ref_pos;
+        bondForce[ip*family + ii] = p.pForceState[ip]*xi;
+      }
+    }
+  }
+
+  // Particle internal force
+  for (int ip = 0; ip < particles; ip++) {
+    Vector force(0.0);
+    for (int ii = 0; ii < family; ii++) {
+      int family_idx = lookup.index(ip*family + ii);
+      if (family_idx >= 0) {
+        force += bondForce[ip*family + ii]*p.pVol[family_idx];
+      }
+    }
+    intForce[ip] = force;
+  }
+
+  // Bond energy for the damage model
+  for (int ip = 0; ip < particles; ip++) {
+    Point cur_ref_pos = p.pPos[ip] - p.pDisp[ip];
+    for (int ii = 0; ii < family; ii++) {
+      int family_idx = lookup.index(ip*family + ii);
+      if (family_idx >= 0) {
+        Vector xi = (p.pPos[family_idx] - p.pDisp[family_idx]) - cur_ref_pos;
+        Vector force_diff = p.pForceState[ip]*xi + p.pForceState[family_idx]*xi;
+        Vector eta = p.pDisp[family_idx] - p.pDisp[ip];
+        bondEnergy[ip*family + ii] = Dot(force_diff, eta);
+      }
+    }
+    check += intForce[ip].length() + defGrad[ip].Trace();
+  }
+  return check;
+}
+
+template<class Lookup>
+void run(const char* name, const Particles& p, const Families& f,
+         int particles, int loop, double& t_ref, double& check_ref)
+{
+  int family = f.size;
+  vector<Matrix3> defGrad(particles);
+  vector<Vector> bondForce(particles*family), intForce(particles);
+  vector<double> bondEnergy(particles*family);
+
+  double start = Time::currentSeconds();
+  Lookup lookup(p, f);
+  double t_build = Time::currentSeconds() - start;
+
+  double t_resolve = 0.0;
+  double t_loops = 0.0;
+  double check = 0.0;
+  for (int l = 0; l < loop; l++) {
+    start = Time::currentSeconds();
+    lookup.newTimestep();
+    double mid = Time::currentSeconds();
+    check = timestep(lookup, p, f, particles, defGrad, bondForce, intForce,
+                     bondEnergy);
+    t_resolve += mid - start;
+    t_loops += Time::currentSeconds() - mid;
+  }
+
+  double t_total = t_build*loop + t_resolve + t_loops;
+  if (t_ref == 0.0) {
+    t_ref = t_total;
+    check_ref = check;
+  }
+
+  double bonds = 1.0e-9*particles*family*loop;
+  cout << setw(18) << name
+       << fixed << setprecision(1)
+       << setw(14) << (t_build*loop + t_resolve)/bonds
+       << setw(14) << t_loops/bonds/4
+       << setw(14) << t_total/bonds
+       << setw(10) << setprecision(2) << t_ref/t_total
+       << setw(14) << scientific << setprecision(1) << fabs(check - check_ref)/fabs(check_ref)
+       << defaultfloat << endl;
+}
+
+int main ( int argc, char** argv )
+{
+  int particles = PARTICLES_DEFAULT;
+  int family    = FAMILY_DEFAULT;
+  int loop      = LOOP_DEFAULT;
+
+  if ( argc > 1 ) {
+    particles = atoi( argv[1] );
+    if ( argc > 2 ) {
+      family = atoi( argv[2] );
+      if ( argc > 3 ) {
+        loop = atoi( argv[3] );
+      }
+    }
+  }
+  if ( particles <= 0 || family <= 0 || loop <= 0 ) {
+    usage();
+    return EXIT_FAILURE;
+  }
+
+  srand48(1);
+
+  Particles p;
+  Families f;
+  makeParticles(particles, p);
+  makeFamilies(particles, family, p, f);
+
+  cout << "Peridynamics Bond Loop Benchmark: " << endl;
+  cout << particles << " particles, " << family << " bonds each, "
+       << loop << " timestep(s) of four bond loops." << endl;
+  cout << "Times in ns per bond per timestep; the map is built every timestep." << endl;
+  cout << endl;
+  cout << setw(18) << "lookup"
+       << setw(14) << "map+resolve"
+       << setw(14) << "per loop"
+       << setw(14) << "timestep"
+       << setw(10) << "speedup"
+       << setw(14) << "rel diff" << endl;
+
+  double t_ref = 0.0, check_ref = 0.0;
+  run<StdMapLookup>  ("std::map",      p, f, particles, loop, t_ref, check_ref);
+  run<FlatMapLookup> ("ParticleIDMap", p, f, particles, loop, t_ref, check_ref);
+  run<ResolvedLookup>("resolved",      p, f, particles, loop, t_ref, check_ref);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,354 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2015-     Parresia Research Limited, New Zealand
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/*
+ *  ParticleSort.cc: Benchmark of the particle sort of Relocate
+ *  (<particleSortInterval>) on one patch.  The cost of the sort (cell keys,
+ *  permutation and gather of the particle variables) is compared with the
+ *  particle loops of an MPM timestep (particle to grid and grid to particle
+ *  with linear weights) before and after the particles are sorted.
+ */
+
+#include <Core/Geometry/IntVector.h>
+#include <Core/Geometry/Point.h>
+#include <Core/Geometry/Vector.h>
+#include <Core/Math/Matrix3.h>
+#include <Core/Thread/Time.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+using namespace Uintah;
+using namespace std;
+
+const int CELLS_DEFAULT = 32;
+const int PPC_DEFAULT   = 8;
+const int LOOP_DEFAULT  = 10;
+
+void usage ( void )
+{
+  cerr << "Usage: ParticleSort [<cells> [<ppc> [<loop>]]]" << endl;
+  cerr << endl;
+  cerr << "  <cells>  Number of cells of the patch in each direction (default "
+       << CELLS_DEFAULT << ")." << endl;
+  cerr << endl;
+  cerr << "  <ppc>    Number of particles per cell (default " << PPC_DEFAULT << ")." << endl;
+  cerr << endl;
+  cerr << "  <loop>   Number of timesteps between sorts (default " << LOOP_DEFAULT << ")." << endl;
+}
+
+// The particle variables that are relocated (and so permuted by the sort)
+struct Particles {
+  vector<Point>   pX;
+  vector<Vector>  pVelocity;
+  vector<double>  pMass;
+  vector<double>  pVolume;
+  vector<Matrix3> pStress;
+  vector<Matrix3> pDefGrad;
+
+  int size() const { return (int) pX.size(); }
+};
+
+// The grid variables of the patch, on the nodes
+struct Grid {
+  int              cells;
+  vector<double>   gMass;
+  vector<Vector>   gMomentum;
+  vector<Vector>   gIntForce;
+  vector<Vector>   gVelocity;
+
+  int node(int i, int j, int k) const { return (k*(cells + 1) + j)*(cells + 1) + i; }
+};
+
+// Same as the keys of Relocate::sortedParticleOrder
+static long64 mortonCode(const IntVector& c)
+{
+  long64 code = 0;
+  for (int b = 0; b < 21; b++) {
+    for (int d = 0; d < 3; d++) {
+      code |= (long64)((c[d] >> b) & 1) << (3*b + d);
+    }
+  }
+  return code;
+}
+
+static IntVector cellIndex(const Point& x, int cells)
+{
+  IntVector c((int) floor(x.x()), (int) floor(x.y()), (int) floor(x.z()));
+  return Max(IntVector(0,0,0), Min(IntVector(cells-1,cells-1,cells-1), c));
+}
+
+// Particles created cell by cell (the order of the particle creator), then
+// moved by up to drift cells in each direction without being reordered,
+// as between two sorts.  drift < 0 shuffles the particles instead.
+void makeParticles(int cells, int ppc, double drift, Particles& p)
+{
+  int particles = cells*cells*cells*ppc;
+  p.pX.resize(particles);
+  p.pVelocity.resize(particles);
+  p.pMass.resize(particles);
+  p.pVolume.resize(particles);
+  p.pStress.resize(particles);
+  p.pDefGrad.resize(particles);
+
+  int ip = 0;
+  for (int k = 0; k < cells; k++) {
+    for (int j = 0; j < cells; j++) {
+      for (int i = 0; i < cells; i++) {
+        for (int pc = 0; pc < ppc; pc++, ip++) {
+          Point x(i + drand48(), j + drand48(), k + drand48());
+          if (drift > 0.0) {
+            x += Vector(2.0*drand48() - 1.0, 2.0*drand48() - 1.0,
+                        2.0*drand48() - 1.0)*drift;
+            x = Point(min(max(x.x(), 0.0), cells - 1.0e-6),
+                      min(max(x.y(), 0.0), cells - 1.0e-6),
+                      min(max(x.z(), 0.0), cells - 1.0e-6));
+          }
+          p.pX[ip] = x;
+          p.pVelocity[ip] = Vector(drand48(), drand48(), drand48());
+          p.pMass[ip] = 1.0 + drand48();
+          p.pVolume[ip] = 1.0/ppc;
+          p.pStress[ip] = Matrix3(drand48(), drand48(), drand48(),
+                                  drand48(), drand48(), drand48(),
+                                  drand48(), drand48(), drand48());
+          p.pDefGrad[ip] = Matrix3(1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0);
+        }
+      }
+    }
+  }
+
+  if (drift < 0.0) {
+    vector<int> order(particles);
+    for (int ii = 0; ii < particles; ii++) {
+      order[ii] = ii;
+    }
+    for (int ii = particles - 1; ii > 0; ii--) {
+      swap(order[ii], order[(int) (drand48()*(ii + 1))]);
+    }
+    Particles q = p;
+    for (int ii = 0; ii < particles; ii++) {
+      p.pX[ii] = q.pX[order[ii]];
+      p.pVelocity[ii] = q.pVelocity[order[ii]];
+      p.pMass[ii] = q.pMass[order[ii]];
+      p.pVolume[ii] = q.pVolume[order[ii]];
+      p.pStress[ii] = q.pStress[order[ii]];
+      p.pDefGrad[ii] = q.pDefGrad[order[ii]];
+    }
+  }
+}
+
+template<class T>
+void gather(vector<T>& var, const vector<pair<long64, int> >& keys)
+{
+  vector<T> sorted(var.size());
+  for (size_t ii = 0; ii < keys.size(); ii++) {
+    sorted[ii] = var[keys[ii].second];
+  }
+  var.swap(sorted);
+}
+
+// The sort of Relocate: the cell key of every particle, a stable order of
+// the keys, and the gather of every relocated variable
+void sortParticles(Particles& p, int cells, bool morton)
+{
+  vector<pair<long64, int> > keys;
+  keys.reserve(p.size());
+  for (int ip = 0; ip < p.size(); ip++) {
+    IntVector c = cellIndex(p.pX[ip], cells);
+    long64 key = morton ? mortonCode(c)
+                        : ((long64)c.z()*cells + c.y())*cells + c.x();
+    keys.push_back(make_pair(key, ip));
+  }
+  sort(keys.begin(), keys.end());
+
+  gather(p.pX, keys);
+  gather(p.pVelocity, keys);
+  gather(p.pMass, keys);
+  gather(p.pVolume, keys);
+  gather(p.pStress, keys);
+  gather(p.pDefGrad, keys);
+}
+
+// Node indices and linear weights and gradients of the 8 nodes of the
+// cell of x
+static void findCellAndWeights(const Grid& g, const Point& x, int ni[8],
+                               double S[8], Vector d_S[8])
+{
+  IntVector c = cellIndex(x, g.cells);
+  double fx = x.x() - c.x(), fy = x.y() - c.y(), fz = x.z() - c.z();
+  int n = 0;
+  for (int k = 0; k < 2; k++) {
+    double wz = k ? fz : 1.0 - fz, dz = k ? 1.0 : -1.0;
+    for (int j = 0; j < 2; j++) {
+      double wy = j ? fy : 1.0 - fy, dy = j ? 1.0 : -1.0;
+      for (int i = 0; i < 2; i++, n++) {
+        double wx = i ? fx : 1.0 - fx, dx = i ? 1.0 : -1.0;
+        ni[n] = g.node(c.x() + i, c.y() + j, c.z() + k);
+        S[n] = wx*wy*wz;
+        d_S[n] = Vector(dx*wy*wz, wx*dy*wz, wx*wy*dz);
+      }
+    }
+  }
+}
+
+// The particle loops of a timestep: mass, momentum and internal force to
+// the grid, then velocity and position back to the particles
+double timestep(Particles& p, Grid& g, double delT)
+{
+  fill(g.gMass.begin(), g.gMass.end(), 0.0);
+  fill(g.gMomentum.begin(), g.gMomentum.end(), Vector(0.0));
+  fill(g.gIntForce.begin(), g.gIntForce.end(), Vector(0.0));
+
+  int ni[8];
+  double S[8];
+  Vector d_S[8];
+  for (int ip = 0; ip < p.size(); ip++) {
+    findCellAndWeights(g, p.pX[ip], ni, S, d_S);
+    Vector pMom = p.pVelocity[ip]*p.pMass[ip];
+    for (int n = 0; n < 8; n++) {
+      g.gMass[ni[n]] += p.pMass[ip]*S[n];
+      g.gMomentum[ni[n]] += pMom*S[n];
+      g.gIntForce[ni[n]] -= (p.pStress[ip]*d_S[n])*p.pVolume[ip];
+    }
+  }
+
+  for (size_t n = 0; n < g.gMass.size(); n++) {
+    g.gVelocity[n] = g.gMass[n] > 0.0
+      ? (g.gMomentum[n] + g.gIntForce[n]*delT)/g.gMass[n] : Vector(0.0);
+  }
+
+  double check = 0.0;
+  for (int ip = 0; ip < p.size(); ip++) {
+    findCellAndWeights(g, p.pX[ip], ni, S, d_S);
+    Vector vel(0.0);
+    Matrix3 velGrad(0.0);
+    for (int n = 0; n < 8; n++) {
+      vel += g.gVelocity[ni[n]]*S[n];
+      velGrad += Matrix3(g.gVelocity[ni[n]], d_S[n]);
+    }
+    p.pDefGrad[ip] = p.pDefGrad[ip] + velGrad*p.pDefGrad[ip]*delT;
+    check += vel.length2() + p.pDefGrad[ip].Trace();
+  }
+  return check;
+}
+
+void run(const char* name, int cells, int ppc, double drift, int loop)
+{
+  Grid g;
+  g.cells = cells;
+  int nodes = (cells + 1)*(cells + 1)*(cells + 1);
+  g.gMass.resize(nodes);
+  g.gMomentum.resize(nodes);
+  g.gIntForce.resize(nodes);
+  g.gVelocity.resize(nodes);
+
+  const char* orders[] = {"unsorted", "row-major", "morton"};
+  double t_ref = 0.0, check_ref = 0.0;
+  for (int o = 0; o < 3; o++) {
+    srand48(1);
+    Particles p;
+    makeParticles(cells, ppc, drift, p);
+
+    double start = Time::currentSeconds();
+    if (o > 0) {
+      sortParticles(p, cells, o == 2);
+    }
+    double t_sort = Time::currentSeconds() - start;
+
+    // the positions are not moved, so that every order does the same work
+    start = Time::currentSeconds();
+    double check = 0.0;
+    for (int l = 0; l < loop; l++) {
+      check = timestep(p, g, 1.0e-9);
+    }
+    double t_loops = Time::currentSeconds() - start;
+    if (o == 0) {
+      t_ref = t_loops;
+      check_ref = check;
+    }
+
+    // timesteps after which the sort has paid for itself
+    double saved = (t_ref - t_loops)/loop;
+    double ns = 1.0e9/p.size();
+    cout << setw(12) << name << setw(12) << orders[o]
+         << fixed << setprecision(1)
+         << setw(12) << t_sort*ns
+         << setw(14) << t_loops*ns/loop
+         << setw(10) << setprecision(2) << t_ref/t_loops;
+    if (o > 0 && saved > 0.0) {
+      cout << setw(12) << setprecision(1) << t_sort/saved;
+    } else {
+      cout << setw(12) << "-";
+    }
+    cout << setw(14) << scientific << setprecision(1)
+         << fabs(check - check_ref)/fabs(check_ref) << defaultfloat << endl;
+  }
+}
+
+int main ( int argc, char** argv )
+{
+  int cells = CELLS_DEFAULT;
+  int ppc   = PPC_DEFAULT;
+  int loop  = LOOP_DEFAULT;
+
+  if ( argc > 1 ) {
+    cells = atoi( argv[1] );
+    if ( argc > 2 ) {
+      ppc = atoi( argv[2] );
+      if ( argc > 3 ) {
+        loop = atoi( argv[3] );
+      }
+    }
+  }
+  if ( cells <= 0 || ppc <= 0 || loop <= 0 ) {
+    usage();
+    return EXIT_FAILURE;
+  }
+
+  cout << "Particle Sort Benchmark: " << endl;
+  cout << cells << "^3 cells, " << ppc << " particles per cell, "
+       << loop << " timestep(s) between sorts." << endl;
+  cout << "Times in ns per particle; the sort is done once, the loops every timestep." << endl;
+  cout << "break-even: timesteps after which the sort has paid for itself." << endl;
+  cout << endl;
+  cout << setw(12) << "particles"
+       << setw(12) << "order"
+       << setw(12) << "sort"
+       << setw(14) << "loops/step"
+       << setw(10) << "speedup"
+       << setw(12) << "break-even"
+       << setw(14) << "rel diff" << endl;
+
+  run("drift 1",  cells, ppc, 1.0, loop);
+  run("drift 4",  cells, ppc, 4.0, loop);
+  run("shuffled", cells, ppc, -1.0, loop);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,375 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2015-     Parresia Research Limited, New Zealand
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/*
+ *  PoissonMultigrid.cc: Benchmark of the solvers of CGSolver on the Laplace
+ *  problems of the poisson1-4 examples (phi = 1 on the x- face, 0 on the
+ *  others, 7-point stencil on the unknown nodes or cells) with their patch
+ *  layouts, and on larger power of two layouts.  Compares CG with the
+ *  Jacobi preconditioner, CG with the LevelMultigrid preconditioner and
+ *  LevelMultigrid V-cycles as a solver.  The patches are distributed over
+ *  the MPI ranks in contiguous groups.
+ */
+
+#include <CCA/Components/Solvers/LevelMultigrid.h>
+#include <Core/Thread/Time.h>
+
+#include <sci_defs/mpi_defs.h> // For MPIPP_H on SGI
+
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Uintah;
+using namespace std;
+
+const double TOLERANCE = 1.0e-8;
+const int MAX_ITERATIONS = 2000;
+
+struct Problem {
+  string name;
+  int resolution;       // cells in every direction
+  bool nodes;           // unknowns on the interior nodes (NC) or the cells
+  int patches;          // patches in every direction ...
+  int patchesX;         // ... but x
+};
+
+// The LevelMultigrid blocks of the unknowns of a layout (the patches
+// split the cells evenly, like the Grid does)
+void makeBlocks(const Problem& problem, int numRanks,
+                vector<LevelMultigrid::Block>& blocks)
+{
+  int n = problem.resolution;
+  int first = problem.nodes ? 1 : 0;
+  int last = problem.nodes ? n - 1 : n;
+  int numPatches[3] = {problem.patchesX, problem.patches, problem.patches};
+  int total = numPatches[0]*numPatches[1]*numPatches[2];
+
+  blocks.clear();
+  for (int pk = 0; pk < numPatches[2]; pk++) {
+    for (int pj = 0; pj < numPatches[1]; pj++) {
+      for (int pi = 0; pi < numPatches[0]; pi++) {
+        int p[3] = {pi, pj, pk};
+        int low[3], high[3];
+        for (int d = 0; d < 3; d++) {
+          low[d] = max(p[d]*n/numPatches[d], first);
+          high[d] = min((p[d] + 1)*n/numPatches[d], last);
+        }
+        LevelMultigrid::Block block;
+        block.low = IntVector(low[0], low[1], low[2]);
+        block.high = IntVector(high[0], high[1], high[2]);
+        block.rank = (int) blocks.size()*numRanks/total;
+        blocks.push_back(block);
+      }
+    }
+  }
+}
+
+class Fields {
+public:
+  Fields(const vector<LevelMultigrid::Block>& blocks, int rank)
+  {
+    for (unsigned int ib = 0; ib < blocks.size(); ib++) {
+      if (blocks[ib].rank == rank) {
+        d_fields.push_back(new Array3<double>(blocks[ib].low, blocks[ib].high));
+        d_fields.back()->initialize(0);
+      }
+    }
+  }
+  ~Fields()
+  {
+    for (unsigned int i = 0; i < d_fields.size(); i++) {
+      delete d_fields[i];
+    }
+  }
+
+  const vector<Array3<double>*>& out() const { return d_fields; }
+  vector<const Array3<double>*> in() const
+  {
+    return vector<const Array3<double>*>(d_fields.begin(), d_fields.end());
+  }
+  Array3<double>& operator[](int i) { return *d_fields[i]; }
+  int size() const { return (int) d_fields.size(); }
+
+private:
+  vector<Array3<double>*> d_fields;
+};
+
+double dot(Fields& a, Fields& b)
+{
+  double sum = 0;
+  for (int i = 0; i < a.size(); i++) {
+    Array3<double>& aa = a[i];
+    Array3<double>& bb = b[i];
+    IntVector l = aa.getLowIndex(), h = aa.getHighIndex();
+    for (int z = l.z(); z < h.z(); z++) {
+      for (int y = l.y(); y < h.y(); y++) {
+        for (int x = l.x(); x < h.x(); x++) {
+          IntVector c(x, y, z);
+          sum += aa[c]*bb[c];
+        }
+      }
+    }
+  }
+  double total;
+  MPI_Allreduce(&sum, &total, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  return total;
+}
+
+// y = a*x + y
+void axpy(double a, Fields& x, Fields& y)
+{
+  for (int i = 0; i < x.size(); i++) {
+    Array3<double>& xx = x[i];
+    Array3<double>& yy = y[i];
+    IntVector l = xx.getLowIndex(), h = xx.getHighIndex();
+    for (int z = l.z(); z < h.z(); z++) {
+      for (int y = l.y(); y < h.y(); y++) {
+        for (int x = l.x(); x < h.x(); x++) {
+          IntVector c(x, y, z);
+          yy[c] += a*xx[c];
+        }
+      }
+    }
+  }
+}
+
+// y = x + b*y
+void xpby(Fields& x, double b, Fields& y)
+{
+  for (int i = 0; i < x.size(); i++) {
+    Array3<double>& xx = x[i];
+    Array3<double>& yy = y[i];
+    IntVector l = xx.getLowIndex(), h = xx.getHighIndex();
+    for (int z = l.z(); z < h.z(); z++) {
+      for (int y = l.y(); y < h.y(); y++) {
+        for (int x = l.x(); x < h.x(); x++) {
+          IntVector c(x, y, z);
+          yy[c] = xx[c] + b*yy[c];
+        }
+      }
+    }
+  }
+}
+
+// Preconditioned CG from x = 0, with M = multigrid or 1/6 (Jacobi, the
+// diagonal is 6 everywhere).  Ranks without patches have no mg and only
+// take part in the dot products.
+int cg(LevelMultigrid* mg, bool multigrid, Fields& b, Fields& x,
+       const vector<LevelMultigrid::Block>& blocks, int rank)
+{
+  Fields r(blocks, rank), z(blocks, rank), d(blocks, rank), q(blocks, rank);
+  long64 flops = 0, memrefs = 0;
+
+  axpy(1, b, r);
+  double norm0 = sqrt(dot(r, r));
+  if (multigrid && mg) {
+    mg->apply(r.in(), z.out(), flops, memrefs);
+  } else {
+    axpy(1.0/6.0, r, z);
+  }
+  axpy(1, z, d);
+  double gamma = dot(r, z);
+
+  int iterations = 0;
+  while (iterations < MAX_ITERATIONS) {
+    if (mg) {
+      mg->multiply(d.in(), q.out(), flops, memrefs);
+    }
+    double alpha = gamma/dot(d, q);
+    axpy(alpha, d, x);
+    axpy(-alpha, q, r);
+    iterations++;
+    if (sqrt(dot(r, r)) <= TOLERANCE*norm0) {
+      break;
+    }
+    if (multigrid && mg) {
+      mg->apply(r.in(), z.out(), flops, memrefs);
+    } else {
+      for (int i = 0; i < z.size(); i++) {
+        z[i].initialize(0);
+      }
+      axpy(1.0/6.0, r, z);
+    }
+    double gammaNew = dot(r, z);
+    xpby(z, gammaNew/gamma, d);
+    gamma = gammaNew;
+  }
+  return iterations;
+}
+
+void run(const Problem& problem, int numRanks, int rank, int maxLevels,
+         int numSmooth)
+{
+  vector<LevelMultigrid::Block> blocks;
+  makeBlocks(problem, numRanks, blocks);
+
+  // phi = 1 on the x- face: b = 1 next to it
+  Fields b(blocks, rank);
+  vector<const Array3<Stencil7>*> A;
+  int first = problem.nodes ? 1 : 0;
+  int ib = 0;
+  for (unsigned int i = 0; i < blocks.size(); i++) {
+    if (blocks[i].rank != rank) {
+      continue;
+    }
+    Array3<Stencil7>* a = new Array3<Stencil7>(blocks[i].low, blocks[i].high);
+    Stencil7 laplace;
+    laplace.initialize(-1);
+    laplace.p = 6;
+    a->initialize(laplace);
+    A.push_back(a);
+    IntVector l = blocks[i].low, h = blocks[i].high;
+    if (l.x() == first) {
+      for (int z = l.z(); z < h.z(); z++) {
+        for (int y = l.y(); y < h.y(); y++) {
+          b[ib][IntVector(first, y, z)] = 1;
+        }
+      }
+    }
+    ib++;
+  }
+
+  MPI_Barrier(MPI_COMM_WORLD);
+  double start = Time::currentSeconds();
+  LevelMultigrid* mg = 0;
+  if (!A.empty()) {
+    mg = new LevelMultigrid(MPI_COMM_WORLD, maxLevels, numSmooth);
+    mg->setup(blocks, A);
+  }
+  double t_setup = Time::currentSeconds() - start;
+
+  Fields x_jacobi(blocks, rank), x_cg(blocks, rank), x_mg(blocks, rank);
+  MPI_Barrier(MPI_COMM_WORLD);
+  start = Time::currentSeconds();
+  int it_jacobi = cg(mg, false, b, x_jacobi, blocks, rank);
+  double t_jacobi = Time::currentSeconds() - start;
+
+  MPI_Barrier(MPI_COMM_WORLD);
+  start = Time::currentSeconds();
+  int it_cg = cg(mg, true, b, x_cg, blocks, rank);
+  double t_cg = Time::currentSeconds() - start;
+
+  MPI_Barrier(MPI_COMM_WORLD);
+  start = Time::currentSeconds();
+  double norm = 0;
+  long64 flops = 0, memrefs = 0;
+  int it_mg = 0;
+  if (mg) {
+    it_mg = mg->solve(b.in(), x_mg.out(), TOLERANCE, true, MAX_ITERATIONS,
+                      norm, flops, memrefs);
+  }
+  double t_mg = Time::currentSeconds() - start;
+
+  // The three solutions should agree to about the tolerance
+  double diff = 0;
+  for (int i = 0; i < x_mg.size(); i++) {
+    IntVector l = x_mg[i].getLowIndex(), h = x_mg[i].getHighIndex();
+    for (int z = l.z(); z < h.z(); z++) {
+      for (int y = l.y(); y < h.y(); y++) {
+        for (int x = l.x(); x < h.x(); x++) {
+          IntVector c(x, y, z);
+          diff = max(diff, max(fabs(x_mg[i][c] - x_jacobi[i][c]), fabs(x_cg[i][c] - x_jacobi[i][c])));
+        }
+      }
+    }
+  }
+  double maxDiff;
+  MPI_Reduce(&diff, &maxDiff, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+  for (unsigned int i = 0; i < A.size(); i++) {
+    delete A[i];
+  }
+  if (rank == 0) {
+    int patches = problem.patchesX*problem.patches*problem.patches;
+    ostringstream levels;
+    levels << mg->numDistributedLevels() << "/" << mg->numLevels();
+    cout << setw(10) << problem.name
+         << setw(6) << (problem.nodes ? problem.resolution - 1 : problem.resolution)
+         << setw(8) << patches
+         << setw(7) << levels.str()
+         << fixed << setprecision(3)
+         << setw(8) << t_setup
+         << setw(6) << it_jacobi << setw(8) << t_jacobi
+         << setw(6) << it_cg << setw(8) << t_cg
+         << setw(6) << it_mg << setw(8) << t_mg
+         << setw(10) << scientific << setprecision(1) << maxDiff << defaultfloat << endl;
+  }
+  delete mg;
+}
+
+int main ( int argc, char** argv )
+{
+  MPI_Init(&argc, &argv);
+  int rank, numRanks;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &numRanks);
+
+  int maxLevels = 10;
+  int numSmooth = 2;
+  if ( argc > 1 ) {
+    maxLevels = atoi( argv[1] );
+    if ( argc > 2 ) {
+      numSmooth = atoi( argv[2] );
+    }
+  }
+  if ( maxLevels <= 0 || numSmooth <= 0 ) {
+    if (rank == 0) {
+      cerr << "Usage: PoissonMultigrid [<mg_levels> [<mg_smooth>]]" << endl;
+    }
+    MPI_Finalize();
+    return EXIT_FAILURE;
+  }
+
+  const Problem problems[] = {
+    {"poisson1",   50, true,  1, 2},    // also poisson2
+    {"poisson3",   50, true,  1, 1},
+    {"poisson3-8", 50, true,  2, 2},
+    {"poisson3-27", 50, true, 3, 3},
+    {"poisson4",   40, false, 1, 1},
+    {"64^3",       64, false, 2, 2},
+    {"128^3",     128, false, 4, 4}
+  };
+
+  if (rank == 0) {
+    cout << "Poisson Multigrid Benchmark: " << numRanks << " rank(s), mg_levels "
+         << maxLevels << ", mg_smooth " << numSmooth << ", tolerance " << TOLERANCE << endl;
+    cout << endl;
+    cout << setw(10) << "problem" << setw(6) << "n" << setw(8) << "patches"
+         << setw(7) << "levels" << setw(8) << "setup"
+         << setw(14) << "Jacobi-CG" << setw(14) << "MG-CG" << setw(14) << "MG"
+         << setw(10) << "max diff" << endl;
+  }
+  for (unsigned int i = 0; i < sizeof(problems)/sizeof(problems[0]); i++) {
+    run(problems[i], numRanks, rank, maxLevels, numSmooth);
+  }
+
+  MPI_Finalize();
+  return EXIT_SUCCESS;
+}